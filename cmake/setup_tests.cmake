@@ -27,6 +27,8 @@ target_link_libraries(${TEST_PROGRAM_NAME} PRIVATE
     my_mqtt
     my_edge
     my_control
+    my_executor
+    my_api
     my_device
     my_data
     my_db
@@ -42,6 +44,7 @@ target_link_libraries(${TEST_PROGRAM_NAME} PRIVATE
     my_audio
     my_light
     my_tools
+    my_comm
     my_mavsdk
     opencv_core            # 修复 opencv2/opencv.hpp 找不到
     opencv_imgproc
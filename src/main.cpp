@@ -12,6 +12,7 @@
 #include "FreeFunc.h"
 #include "InitTools.h"
 #include "MyDoctor.h"
+#include "MyExecutor.h"
 #include "MyINIConfig.h"
 #include "MyJSONConfig.h"
 #include "MyLog.h"
@@ -350,6 +351,24 @@ json LoadPipelineConfigFromJson() {
     return pipeline_config;
 }
 
+// 共享执行器需在各模块启动前就绪，模块的周期任务都挂在它上面。
+void StartExecutor() {
+    json executor_config = json::object();
+    MyJSONConfig::GetInstance().Get("executor", json::object(), executor_config);
+    std::string err;
+    if (!my_executor::MyExecutor::GetInstance().Init(executor_config, &err)) {
+        MYLOG_ERROR("[执行器] 配置无效：{}，改用默认配置启动。", err);
+        my_executor::MyExecutor::GetInstance().Init(json::object(), nullptr);
+    }
+    MYLOG_INFO("[执行器] 共享执行器已启动，工作线程数：{}", my_executor::MyExecutor::GetInstance().WorkerCount());
+}
+
+void StopExecutor() {
+    MYLOG_INFO("[退出] 开始停止共享执行器。");
+    my_executor::MyExecutor::GetInstance().Shutdown();
+    MYLOG_INFO("[退出] 共享执行器停止完成。");
+}
+
 void StartPipeline(const json& pipeline_config) {
     MYLOG_INFO("[Pipeline] 读取到的 pipeline 配置如下：\n{}", pipeline_config.dump(2));
     auto& pipeline = tools::pipeline::Pipeline::GetInstance();
@@ -420,12 +439,14 @@ int RunApplication(int argc, char* argv[], bool& logger_initialized) {
     ShowLoadedConfigs();
 
     // 第七阶段：启动核心业务，并进入等待退出信号的常驻状态。
+    StartExecutor();
     const json pipeline_config = LoadPipelineConfigFromJson();
     StartPipeline(pipeline_config);
     WaitForExitRequest();
 
     // 第八阶段：执行优雅收尾，确保各模块有机会正常停止。
     StopPipeline();
+    StopExecutor();
     MYLOG_INFO("[退出] 程序已完成全部收尾流程，即将退出。");
     MyLog::Flush();
     return 0;
@@ -7,6 +7,7 @@
 #include "MqttService.hpp"
 #include "SoftHealthMonitorManager.h"
 #include "SoftHealthMonitorConfig.h"
+#include "MySystemHealthyManager.h"
 #include "MyAPI.h"
 #include "MyFlyControlManager.h"
 #include "pod_manager.h"
@@ -299,6 +300,10 @@ void Pipeline::LaunchRestAPI(const nlohmann::json& args) {
     try {
         // 1. 提取参数
         int port = args.value("port", 8000); // 默认 8000 端口
+        if (args.contains("server")) {
+            // 连接处理模式 / 线程池 / 阻塞调用超时，非法时保持默认配置
+            my_api::MyAPI::GetInstance().ConfigureServer(args["server"]);
+        }
         
         // 2. 等待端口可用（检查 + 重试）
         const std::chrono::seconds retry_interval(5);
@@ -406,13 +411,18 @@ void Pipeline::LaunchSystemHealthy(const nlohmann::json& args) {
         MYLOG_INFO("* Arg: {}, Value: {}", "SystemHealthy", "Found Edges, processing connections...");
     }
 
-    workers_.emplace_back([this, interval, args]() {
-        MYLOG_INFO("* Arg: {}, Value: {}", "SystemHealthy", "Thread Running");
-        while (is_running_) {
-            // TODO: 健康检查逻辑
-            std::this_thread::sleep_for(std::chrono::seconds(interval));
+    MySystemHealthy::MetricsStoreOptions store_options;
+    if (args.contains("metrics_store")) {
+        std::string err;
+        if (!MySystemHealthy::MetricsStoreOptions::FromJson(args["metrics_store"], store_options, &err)) {
+            MYLOG_WARN("SystemHealthy metrics_store 配置无效，使用默认值: {}", err);
         }
-    });
+    }
+    MYLOG_INFO("SystemHealthy metrics_store: {}", store_options.ToJson().dump());
+
+    // 采集线程由 MySystemHealthyManager 自行管理，Stop 时显式关闭
+    MySystemHealthy::MySystemHealthyManager::GetInstance().Init(interval, store_options);
+    MYLOG_INFO("* Arg: {}, Value: {}", "SystemHealthy", "Thread Running");
 }
 
 void Pipeline::LaunchEdge(const nlohmann::json& args) {
@@ -688,6 +698,8 @@ void Pipeline::Stop() {
     my_api::MyAPI::GetInstance().Stop();
     // 停止音频服务
     my_audio::MyAudios::GetInstance().Stop();
+    // 停止系统健康采集
+    MySystemHealthy::MySystemHealthyManager::GetInstance().Shutdown();
     for (auto& t : workers_) {
         if (t.joinable()) t.join();
     }
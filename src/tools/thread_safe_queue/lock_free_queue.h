@@ -0,0 +1,512 @@
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// =============================================================================
+// 有界无锁队列
+//
+// 与 ThreadSafeQueue 保持相同的 push / pop / shutdown / 超时语义，替换其中的
+// 互斥锁 + 条件变量 + std::deque：
+//   - SpscQueue：单生产者单消费者环形缓冲，头尾索引分属不同缓存行，各自缓存对端索引
+//   - MpmcQueue：多生产者多消费者，Vyukov 有界队列（每个槽位带序号）
+//   - 阻塞等待先自旋（自旋次数按最近是否自旋成功自适应），再让出几次 CPU，最后落到 futex 睡眠
+//   - 没有线程在等待时，唤醒只有一次内存屏障 + 一次读，不进内核
+//
+// 与 ThreadSafeQueue 的差异：
+//   - 容量在构造时确定，向上取整为 2 的幂，不支持运行期 setMaxSize
+//   - 热路径不打日志
+//   - SpscQueue 只允许一个线程 push、一个线程 pop（clear 视为 pop 侧操作）
+// =============================================================================
+
+namespace tools {
+
+namespace thread_safe_queue {
+
+namespace detail {
+
+constexpr size_t kCacheLine = 64;
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+inline size_t RoundUpPow2(size_t v) {
+    size_t p = 2;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+/// @brief 自旋 + futex 的等待点（eventcount）
+///
+/// 等待方：登记为等待者并取版本号 → 复查条件 → 条件仍不满足才 futex 睡眠；
+/// 通知方：发布数据后先屏障再看有无等待者，有才递增版本号并 futex 唤醒。
+/// 两侧各有一次 seq_cst 屏障，保证"通知方看不到等待者"时等待方的复查一定能看到数据。
+class AdaptiveWaiter {
+public:
+    static constexpr uint32_t kMinSpin = 16;
+    static constexpr uint32_t kMaxSpin = 4096;
+    static constexpr uint32_t kYieldRounds = 4;
+
+    /// @brief 等待 try_fn 成功
+    /// @param try_fn 尝试操作，成功返回 true（失败时不得消耗参数）
+    /// @param stopped 返回 true 表示不再等待（例如队列已关闭）
+    /// @param timeout_ms 超时时间（毫秒），< 0 表示无限等待
+    /// @return try_fn 是否成功
+    template <typename TryFn, typename StopFn>
+    bool Await(TryFn&& try_fn, StopFn&& stopped, int timeout_ms) {
+        const bool has_deadline = timeout_ms >= 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+
+        // 1. 自旋阶段（单核上自旋只会占住对端需要的时间片，改为让出 CPU）
+        const uint32_t spin = SingleCore() ? 0 : spin_limit_.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < spin; ++i) {
+            if (try_fn()) {
+                spin_limit_.store(spin < kMaxSpin ? spin * 2 : kMaxSpin, std::memory_order_relaxed);
+                return true;
+            }
+            if (stopped()) {
+                return false;
+            }
+            CpuRelax();
+        }
+        if (spin > 0) {
+            spin_limit_.store(spin > kMinSpin ? spin / 2 : kMinSpin, std::memory_order_relaxed);
+        }
+        for (uint32_t i = 0; i < kYieldRounds; ++i) {
+            std::this_thread::yield();
+            if (try_fn()) {
+                return true;
+            }
+            if (stopped()) {
+                return false;
+            }
+        }
+
+        // 2. 睡眠阶段
+        for (;;) {
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+
+            if (try_fn()) {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (stopped()) {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            timespec ts{};
+            timespec* ts_ptr = nullptr;
+            if (has_deadline) {
+                const auto now = std::chrono::steady_clock::now();
+                if (now >= deadline) {
+                    waiters_.fetch_sub(1, std::memory_order_relaxed);
+                    return try_fn();
+                }
+                const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+                ts.tv_sec  = static_cast<time_t>(left / 1000000000LL);
+                ts.tv_nsec = static_cast<long>(left % 1000000000LL);
+                ts_ptr = &ts;
+            }
+            FutexWait(epoch, ts_ptr);
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// 唤醒一个等待者（调用前数据必须已发布）
+    void NotifyOne() { Notify(1); }
+
+    /// 唤醒全部等待者
+    void NotifyAll() { Notify(INT_MAX); }
+
+private:
+    static bool SingleCore() {
+        static const bool single = std::thread::hardware_concurrency() <= 1;
+        return single;
+    }
+
+    void Notify(int count) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        epoch_.fetch_add(1, std::memory_order_release);
+        syscall(SYS_futex, FutexWord(), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    }
+
+    void FutexWait(uint32_t expected, const timespec* timeout) {
+        syscall(SYS_futex, FutexWord(), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+    }
+
+    uint32_t* FutexWord() { return reinterpret_cast<uint32_t*>(&epoch_); }
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex 需要 32 位原子字");
+
+    std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> waiters_{0};
+    std::atomic<uint32_t> spin_limit_{256};
+};
+
+/// @brief 阻塞语义公共部分（CRTP）
+///
+/// Derived 需提供：
+///   template <typename... Args> bool try_emplace(Args&&...)   // 失败时不得消耗参数
+///   bool try_pop(T&)
+///   size_t try_pop_n(std::vector<T>&, size_t)
+///   size_t size() const / size_t capacity() const
+template <typename Derived, typename T>
+class BlockingQueueOps {
+public:
+    /// @brief 向队列中插入元素（拷贝）
+    /// @param item 要插入的元素
+    /// @param block 是否阻塞等待（默认阻塞）
+    /// @return 插入是否成功（在关闭状态或非阻塞满队列时返回 false）
+    bool push(const T& item, bool block = true) {
+        return emplaceImpl(block, -1, item);
+    }
+
+    /// @brief 向队列中插入元素（移动），参数语义同上
+    bool push(T&& item, bool block = true) {
+        return emplaceImpl(block, -1, std::move(item));
+    }
+
+    /// @brief 带超时的阻塞插入，timeout_ms < 0 表示无限等待
+    bool push_for(T&& item, int timeout_ms) {
+        return emplaceImpl(true, timeout_ms, std::move(item));
+    }
+
+    /// @brief 原地构造元素，阻塞直到有空间或队列关闭
+    template <typename... Args>
+    bool emplace(Args&&... args) {
+        return emplaceImpl(true, -1, std::forward<Args>(args)...);
+    }
+
+    /// @brief 弹出元素（可阻塞、可指定超时时间）
+    /// @param result 返回的结果引用
+    /// @param block 是否阻塞等待
+    /// @param timeout_ms 超时时间（毫秒），默认无限等待
+    /// @return 是否成功获取元素；关闭后仍会先取完剩余元素
+    bool pop(T& result, bool block = true, int timeout_ms = -1) {
+        bool ok = self().try_pop(result);
+        if (!ok && block) {
+            ok = not_empty_.Await([&] { return self().try_pop(result); },
+                                  [&] { return shutdown_.load(std::memory_order_acquire); },
+                                  timeout_ms);
+            if (!ok && is_shutdown()) {
+                // 关闭前发布的元素对看到关闭标志的线程可见，最后再取一次
+                ok = self().try_pop(result);
+            }
+        }
+        if (ok) {
+            not_full_.NotifyOne();
+        }
+        return ok;
+    }
+
+    /// @brief 批量弹出，至多 max_items 个追加到 out 尾部
+    ///
+    /// 阻塞模式下只等待第一个元素，之后把当前已有的元素一次取走，不再等待。
+    /// @return 实际弹出的个数
+    size_t pop_n(std::vector<T>& out, size_t max_items, bool block = true, int timeout_ms = -1) {
+        if (max_items == 0) {
+            return 0;
+        }
+        size_t n = self().try_pop_n(out, max_items);
+        if (n == 0 && block) {
+            not_empty_.Await([&] { return (n = self().try_pop_n(out, max_items)) > 0; },
+                             [&] { return shutdown_.load(std::memory_order_acquire); },
+                             timeout_ms);
+            if (n == 0 && is_shutdown()) {
+                n = self().try_pop_n(out, max_items);
+            }
+        }
+        if (n > 0) {
+            not_full_.NotifyAll();
+        }
+        return n;
+    }
+
+    /// 清空队列（SpscQueue 中只能由消费者线程调用）
+    void clear() {
+        T tmp;
+        while (self().try_pop(tmp)) {
+        }
+        not_full_.NotifyAll();
+    }
+
+    /// 队列是否为空（并发下为近似值）
+    bool empty() const {
+        return static_cast<const Derived*>(this)->size() == 0;
+    }
+
+    /// 关闭队列，唤醒所有阻塞线程
+    void shutdown() {
+        shutdown_.store(true, std::memory_order_release);
+        not_full_.NotifyAll();
+        not_empty_.NotifyAll();
+    }
+
+    bool is_shutdown() const {
+        return shutdown_.load(std::memory_order_acquire);
+    }
+
+protected:
+    BlockingQueueOps() = default;
+
+private:
+    template <typename... Args>
+    bool emplaceImpl(bool block, int timeout_ms, Args&&... args) {
+        if (shutdown_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        bool ok = self().try_emplace(std::forward<Args>(args)...);
+        if (!ok && block) {
+            ok = not_full_.Await([&] { return self().try_emplace(std::forward<Args>(args)...); },
+                                 [&] { return shutdown_.load(std::memory_order_acquire); },
+                                 timeout_ms);
+        }
+        if (ok) {
+            not_empty_.NotifyOne();
+        }
+        return ok;
+    }
+
+    Derived& self() { return *static_cast<Derived*>(this); }
+
+    std::atomic<bool> shutdown_{false};
+    AdaptiveWaiter    not_empty_;   ///< pop 侧等待点
+    AdaptiveWaiter    not_full_;    ///< push 侧等待点
+};
+
+template <typename T>
+struct alignas(T) RawSlot {
+    unsigned char bytes[sizeof(T)];
+
+    T* ptr() { return std::launder(reinterpret_cast<T*>(bytes)); }
+};
+
+} // namespace detail
+
+/// @brief 单生产者单消费者有界无锁队列
+/// @tparam T 数据类型（需支持移动）
+template <typename T>
+class SpscQueue : public detail::BlockingQueueOps<SpscQueue<T>, T> {
+public:
+    /// @param capacity 容量，向上取整为 2 的幂
+    explicit SpscQueue(size_t capacity = 1024)
+        : capacity_(detail::RoundUpPow2(capacity)),
+          mask_(capacity_ - 1),
+          slots_(new detail::RawSlot<T>[capacity_]) {}
+
+    ~SpscQueue() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        for (size_t h = head_.load(std::memory_order_relaxed); h != tail; ++h) {
+            slots_[h & mask_].ptr()->~T();
+        }
+        delete[] slots_;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ >= capacity_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ >= capacity_) {
+                return false;
+            }
+        }
+        new (slots_[tail & mask_].bytes) T(std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+        T* item = slots_[head & mask_].ptr();
+        out = std::move(*item);
+        item->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// 一次取走至多 max_items 个，只发布一次 head
+    size_t try_pop_n(std::vector<T>& out, size_t max_items) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_cache_ - head < max_items) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+        }
+        size_t n = tail_cache_ - head;
+        if (n > max_items) {
+            n = max_items;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            T* item = slots_[(head + i) & mask_].ptr();
+            out.push_back(std::move(*item));
+            item->~T();
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    size_t size() const {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    const size_t            capacity_;
+    const size_t            mask_;
+    detail::RawSlot<T>*     slots_;
+
+    alignas(detail::kCacheLine) std::atomic<size_t> head_{0};   ///< 消费者写
+    size_t                  tail_cache_ = 0;                     ///< 消费者缓存的 tail
+    alignas(detail::kCacheLine) std::atomic<size_t> tail_{0};   ///< 生产者写
+    size_t                  head_cache_ = 0;                     ///< 生产者缓存的 head
+};
+
+/// @brief 多生产者多消费者有界无锁队列（Vyukov）
+/// @tparam T 数据类型（需支持移动）
+template <typename T>
+class MpmcQueue : public detail::BlockingQueueOps<MpmcQueue<T>, T> {
+public:
+    /// @param capacity 容量，向上取整为 2 的幂
+    explicit MpmcQueue(size_t capacity = 1024)
+        : capacity_(detail::RoundUpPow2(capacity)),
+          mask_(capacity_ - 1),
+          cells_(new Cell[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpmcQueue() {
+        const size_t enq = enqueue_pos_.load(std::memory_order_relaxed);
+        for (size_t pos = dequeue_pos_.load(std::memory_order_relaxed); pos != enq; ++pos) {
+            cells_[pos & mask_].slot.ptr()->~T();
+        }
+        delete[] cells_;
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->seq.load(std::memory_order_acquire);
+            const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;   // 已满
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->slot.bytes) T(std::forward<Args>(args)...);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->seq.load(std::memory_order_acquire);
+            const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;   // 为空
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        T* item = cell->slot.ptr();
+        out = std::move(*item);
+        item->~T();
+        cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t try_pop_n(std::vector<T>& out, size_t max_items) {
+        size_t n = 0;
+        T tmp;
+        while (n < max_items && try_pop(tmp)) {
+            out.push_back(std::move(tmp));
+            ++n;
+        }
+        return n;
+    }
+
+    size_t size() const {
+        const size_t deq = dequeue_pos_.load(std::memory_order_acquire);
+        const size_t enq = enqueue_pos_.load(std::memory_order_acquire);
+        return enq >= deq ? enq - deq : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        detail::RawSlot<T>  slot;
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    Cell*        cells_;
+
+    alignas(detail::kCacheLine) std::atomic<size_t> enqueue_pos_{0};
+    alignas(detail::kCacheLine) std::atomic<size_t> dequeue_pos_{0};
+};
+
+} // namespace thread_safe_queue
+} // namespace tools
+
+#endif // LOCK_FREE_QUEUE_H
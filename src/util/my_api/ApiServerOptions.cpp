@@ -0,0 +1,126 @@
+#include "ApiServerOptions.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace my_api {
+
+namespace {
+
+bool ReadInt(const nlohmann::json& j, const char* key, int min_value, int max_value,
+             int& value, std::string* err) {
+    auto it = j.find(key);
+    if (it == j.end()) {
+        return true;
+    }
+    if (!it->is_number_integer()) {
+        if (err) *err = std::string(key) + " 必须是整数";
+        return false;
+    }
+    const auto v = it->get<long long>();
+    if (v < min_value || v > max_value) {
+        if (err) *err = std::string(key) + " 必须在 " + std::to_string(min_value) + "-" +
+                        std::to_string(max_value) + " 范围内";
+        return false;
+    }
+    value = static_cast<int>(v);
+    return true;
+}
+
+} // namespace
+
+const char* ServerModeToString(ServerMode mode) {
+    switch (mode) {
+        case ServerMode::Threaded: return "threaded";
+        case ServerMode::Pooled:   return "pooled";
+    }
+    return "unknown";
+}
+
+int ApiServerOptions::TimeoutFor(const std::string& route) const {
+    auto it = route_timeouts_ms.find(route);
+    return it != route_timeouts_ms.end() ? it->second : blocking_timeout_ms;
+}
+
+int ApiServerOptions::EffectiveWorkerThreads() const {
+    if (worker_threads > 0) {
+        return worker_threads;
+    }
+    const int hw = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(4, hw * 2);
+}
+
+bool ApiServerOptions::FromJson(const nlohmann::json& j, ApiServerOptions& out, std::string* err) {
+    if (!j.is_object()) {
+        if (err) *err = "server 配置必须是对象";
+        return false;
+    }
+
+    ApiServerOptions next = out;
+
+    if (auto it = j.find("mode"); it != j.end()) {
+        const std::string mode = it->is_string() ? it->get<std::string>() : std::string();
+        if (mode == "threaded") {
+            next.mode = ServerMode::Threaded;
+        } else if (mode == "pooled") {
+            next.mode = ServerMode::Pooled;
+        } else {
+            if (err) *err = "mode 只能是 threaded 或 pooled";
+            return false;
+        }
+    }
+
+    if (!ReadInt(j, "worker_threads", 0, 1024, next.worker_threads, err) ||
+        !ReadInt(j, "max_pending_connections", 0, 65536, next.max_pending_connections, err) ||
+        !ReadInt(j, "keep_alive_timeout_ms", 0, 3600 * 1000, next.keep_alive_timeout_ms, err) ||
+        !ReadInt(j, "blocking_budget", 0, 1024, next.blocking_budget, err) ||
+        !ReadInt(j, "blocking_timeout_ms", 1, 24 * 3600 * 1000, next.blocking_timeout_ms, err)) {
+        return false;
+    }
+
+    if (auto it = j.find("blocking_subsystem"); it != j.end()) {
+        if (!it->is_string() || it->get<std::string>().empty()) {
+            if (err) *err = "blocking_subsystem 必须是非空字符串";
+            return false;
+        }
+        next.blocking_subsystem = it->get<std::string>();
+    }
+
+    if (auto it = j.find("route_timeouts_ms"); it != j.end()) {
+        if (!it->is_object()) {
+            if (err) *err = "route_timeouts_ms 必须是对象";
+            return false;
+        }
+        std::unordered_map<std::string, int> routes;
+        for (const auto& [route, value] : it->items()) {
+            if (!value.is_number_integer() || value.get<long long>() <= 0 ||
+                value.get<long long>() > 24LL * 3600 * 1000) {
+                if (err) *err = "route_timeouts_ms." + route + " 必须是正整数（毫秒）";
+                return false;
+            }
+            routes[route] = value.get<int>();
+        }
+        next.route_timeouts_ms = std::move(routes);
+    }
+
+    out = std::move(next);
+    return true;
+}
+
+nlohmann::json ApiServerOptions::ToJson() const {
+    nlohmann::json j;
+    j["mode"] = ServerModeToString(mode);
+    j["worker_threads"] = EffectiveWorkerThreads();
+    j["max_pending_connections"] = max_pending_connections;
+    j["keep_alive_timeout_ms"] = keep_alive_timeout_ms;
+    j["blocking_subsystem"] = blocking_subsystem;
+    j["blocking_budget"] = blocking_budget;
+    j["blocking_timeout_ms"] = blocking_timeout_ms;
+    j["route_timeouts_ms"] = nlohmann::json::object();
+    for (const auto& [route, timeout] : route_timeouts_ms) {
+        j["route_timeouts_ms"][route] = timeout;
+    }
+    return j;
+}
+
+} // namespace my_api
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file ApiServerOptions.h
+ * @brief REST 服务运行参数：连接处理模式、工作线程池、阻塞调用卸载与超时
+ *
+ * 由 pipeline 中 rest_api 节点的 model_args.server 提供，示例：
+ * {
+ *   "mode": "pooled",                 // "threaded"：每连接一线程（默认）；"pooled"：固定线程池
+ *   "worker_threads": 8,              // pooled：连接处理线程数，<=0 表示 CPU 核数 * 2
+ *   "max_pending_connections": 64,    // pooled：等待空闲线程的连接上限，超出直接返回 503
+ *   "keep_alive_timeout_ms": 5000,    // pooled：长连接空闲超时，0 表示不限制
+ *   "blocking_subsystem": "api_blocking",
+ *   "blocking_budget": 2,             // 卸载到共享执行器的阻塞调用并发上限，0 表示不限制
+ *   "blocking_timeout_ms": 30000,     // 阻塞调用默认超时
+ *   "route_timeouts_ms": {"ip.scan": 60000, "pod.ptz": 3000}
+ * }
+ */
+
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+namespace my_api {
+
+enum class ServerMode {
+    Threaded,   // oatpp HttpConnectionHandler：每个连接一个线程
+    Pooled,     // PooledHttpConnectionHandler：固定数量的连接处理线程 + 有界等待队列
+};
+
+const char* ServerModeToString(ServerMode mode);
+
+struct ApiServerOptions {
+    ServerMode mode = ServerMode::Threaded;
+    int worker_threads = 0;
+    int max_pending_connections = 64;
+    int keep_alive_timeout_ms = 5000;
+
+    std::string blocking_subsystem = "api_blocking";
+    int blocking_budget = 2;
+    int blocking_timeout_ms = 30000;
+    std::unordered_map<std::string, int> route_timeouts_ms;   // 路由名 -> 超时（毫秒）
+
+    /// 路由的阻塞调用超时：未单独配置时取 blocking_timeout_ms
+    int TimeoutFor(const std::string& route) const;
+
+    /// 实际使用的连接处理线程数
+    int EffectiveWorkerThreads() const;
+
+    /**
+     * @brief 从 JSON 解析，未出现的字段保持默认值
+     * @return 字段类型或取值非法时返回 false，并在 err 中写入原因；out 不被修改
+     */
+    static bool FromJson(const nlohmann::json& j, ApiServerOptions& out, std::string* err = nullptr);
+
+    nlohmann::json ToJson() const;
+};
+
+} // namespace my_api
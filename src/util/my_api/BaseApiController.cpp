@@ -1,7 +1,69 @@
 #include "BaseApiController.hpp"
 
+#include "ContentHash.h"
+#include "MyExecutor.h"
+#include "MyLog.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 namespace my_api::base {
 
+namespace {
+
+std::mutex g_blocking_mu;
+ApiServerOptions g_blocking_options;
+
+// 一次阻塞调用的共享状态：等待方超时返回后任务仍可能持有它
+struct BlockingCallState {
+    std::mutex mu;
+    std::condition_variable cv;
+    bool started = false;
+    bool done = false;
+    bool abandoned = false;      // 等待方已超时返回
+    OutgoingResponsePtr response;
+    std::string error;
+};
+
+// 已序列化的响应，同一 key 的请求共享同一份响应体
+struct CachedResponse {
+    std::uint64_t generation = 0;
+    std::string etag;
+    oatpp::String body;
+};
+
+std::mutex g_response_cache_mu;
+std::unordered_map<std::string, std::shared_ptr<const CachedResponse>> g_response_cache;
+
+// If-None-Match 是否命中：逗号分隔的 ETag 列表或 "*"，按弱比较忽略 W/ 前缀
+bool MatchesIfNoneMatch(const std::string& header, const std::string& etag) {
+    std::size_t pos = 0;
+    while (pos < header.size()) {
+        std::size_t end = header.find(',', pos);
+        if (end == std::string::npos) {
+            end = header.size();
+        }
+        std::size_t b = header.find_first_not_of(" \t", pos);
+        std::size_t e = header.find_last_not_of(" \t", end - 1);
+        if (b != std::string::npos && b < end && e >= b) {
+            std::string tag = header.substr(b, e - b + 1);
+            if (tag.rfind("W/", 0) == 0) {
+                tag.erase(0, 2);
+            }
+            if (tag == "*" || tag == etag) {
+                return true;
+            }
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
+} // namespace
+
 BaseApiController::BaseApiController(
     const std::shared_ptr<ObjectMapper>& objectMapper
 )
@@ -15,4 +77,135 @@ OutgoingResponsePtr BaseApiController::badRequest(const oatpp::String& message)
     return createResponse(Status::CODE_400, message);
 }
 
+void BaseApiController::SetBlockingCallOptions(const ApiServerOptions& options) {
+    std::lock_guard<std::mutex> lock(g_blocking_mu);
+    g_blocking_options = options;
+}
+
+int BaseApiController::blockingTimeoutMs(const std::string& route) {
+    std::lock_guard<std::mutex> lock(g_blocking_mu);
+    return g_blocking_options.TimeoutFor(route);
+}
+
+OutgoingResponsePtr BaseApiController::runBlocking(const std::string& route,
+                                                   std::function<OutgoingResponsePtr()> fn,
+                                                   int timeout_ms) {
+    std::string subsystem;
+    {
+        std::lock_guard<std::mutex> lock(g_blocking_mu);
+        subsystem = g_blocking_options.blocking_subsystem;
+        if (timeout_ms <= 0) {
+            timeout_ms = g_blocking_options.TimeoutFor(route);
+        }
+    }
+
+    auto state = std::make_shared<BlockingCallState>();
+    const bool submitted = my_executor::MyExecutor::GetInstance().Submit(subsystem, [state, fn = std::move(fn)] {
+        {
+            std::lock_guard<std::mutex> lock(state->mu);
+            if (state->abandoned) {
+                return;   // 排队期间已超时，不再执行
+            }
+            state->started = true;
+        }
+
+        OutgoingResponsePtr response;
+        std::string error;
+        try {
+            response = fn();
+        } catch (const std::exception& e) {
+            error = e.what();
+        } catch (...) {
+            error = "unknown exception";
+        }
+
+        std::lock_guard<std::mutex> lock(state->mu);
+        state->response = std::move(response);
+        state->error = std::move(error);
+        state->done = true;
+        state->cv.notify_all();
+    });
+
+    if (!submitted) {
+        MYLOG_WARN("[API] 阻塞调用 {} 提交失败：共享执行器已停止", route);
+        return jsonError(503, "服务正在停止，请稍后重试", {{"route", route}});
+    }
+
+    std::unique_lock<std::mutex> lock(state->mu);
+    if (!state->cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] { return state->done; })) {
+        state->abandoned = true;
+        const bool started = state->started;
+        lock.unlock();
+        MYLOG_WARN("[API] 阻塞调用 {} 超时：timeout_ms={}, started={}", route, timeout_ms, started);
+        return jsonError(504, "请求处理超时", {{"route", route}, {"timeout_ms", timeout_ms}, {"started", started}});
+    }
+
+    if (!state->error.empty()) {
+        MYLOG_ERROR("[API] 阻塞调用 {} 异常：{}", route, state->error);
+        return jsonError(500, "内部错误", {{"route", route}, {"error", state->error}});
+    }
+    if (!state->response) {
+        return jsonError(500, "内部错误：处理结果为空", {{"route", route}});
+    }
+    return state->response;
+}
+
+OutgoingResponsePtr BaseApiController::cachedJsonResponse(const std::shared_ptr<IncomingRequest>& request,
+                                                           const std::string& key,
+                                                           std::uint64_t generation,
+                                                           const std::function<std::string()>& build) {
+    std::shared_ptr<const CachedResponse> entry;
+    {
+        std::lock_guard<std::mutex> lock(g_response_cache_mu);
+        auto it = g_response_cache.find(key);
+        if (it != g_response_cache.end() && it->second->generation == generation) {
+            entry = it->second;
+        }
+    }
+
+    if (!entry) {
+        // 构建在锁外进行；并发的首个请求可能各自构建一次，结果相同
+        std::string body = build();
+        auto fresh = std::make_shared<CachedResponse>();
+        fresh->generation = generation;
+        fresh->etag = "\"" + my_cache::HashBytes(body.data(), body.size()) + "\"";
+        fresh->body = oatpp::String(std::move(body));
+        {
+            std::lock_guard<std::mutex> lock(g_response_cache_mu);
+            auto& slot = g_response_cache[key];
+            if (!slot || slot->generation <= generation) {
+                slot = fresh;
+            }
+        }
+        MYLOG_DEBUG("[API] 响应缓存更新: key={}, generation={}, etag={}", key, generation, fresh->etag);
+        entry = std::move(fresh);
+    }
+
+    return respondWithEtag(request, entry->etag, entry->body);
+}
+
+OutgoingResponsePtr BaseApiController::etagJsonResponse(const std::shared_ptr<IncomingRequest>& request,
+                                                         std::string body) {
+    const std::string etag = "\"" + my_cache::HashBytes(body.data(), body.size()) + "\"";
+    return respondWithEtag(request, etag, oatpp::String(std::move(body)));
+}
+
+OutgoingResponsePtr BaseApiController::respondWithEtag(const std::shared_ptr<IncomingRequest>& request,
+                                                        const std::string& etag,
+                                                        const oatpp::String& body) {
+    auto if_none_match = request ? request->getHeader("If-None-Match") : nullptr;
+    if (if_none_match && MatchesIfNoneMatch(*if_none_match, etag)) {
+        auto res = OutgoingResponse::createShared(Status::CODE_304, nullptr);
+        res->putHeader("ETag", etag);
+        res->putHeader("Cache-Control", "no-cache");
+        return res;
+    }
+
+    auto res = createResponse(Status::CODE_200, body);
+    res->putHeader("Content-Type", "application/json");
+    res->putHeader("ETag", etag);
+    res->putHeader("Cache-Control", "no-cache");
+    return res;
+}
+
 } // namespace my_api::base
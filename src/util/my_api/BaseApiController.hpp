@@ -2,6 +2,10 @@
 
 #include "oatpp/web/server/api/ApiController.hpp"
 #include "oatpp/core/Types.hpp"
+#include "ApiServerOptions.h"
+#include <cstdint>
+#include <functional>
+#include <string>
 #include <nlohmann/json.hpp>
 
 namespace my_api::base {
@@ -16,6 +20,9 @@ public:
         const std::shared_ptr<ObjectMapper>& objectMapper
     );
 
+    // 设置 runBlocking 使用的执行器子系统与各路由超时（MyAPI 启动服务前调用）
+    static void SetBlockingCallOptions(const ApiServerOptions& options);
+
 protected:
     // ====== 旧有方法 ======
     OutgoingResponsePtr ok(const oatpp::String& message);
@@ -43,13 +50,17 @@ protected:
         return res;
     }
 
-    inline OutgoingResponsePtr jsonOk(const nlohmann::json& data = nlohmann::json::object(), const std::string& message = "OK") {
+    static inline nlohmann::json okBody(const nlohmann::json& data = nlohmann::json::object(), const std::string& message = "OK") {
         nlohmann::json j;
         j["success"] = true;
         j["code"] = 200;
         j["message"] = message;
         if (!data.is_null()) j["data"] = data;
-        return jsonResponse(Status::CODE_200, j);
+        return j;
+    }
+
+    inline OutgoingResponsePtr jsonOk(const nlohmann::json& data = nlohmann::json::object(), const std::string& message = "OK") {
+        return jsonResponse(Status::CODE_200, okBody(data, message));
     }
 
     inline OutgoingResponsePtr jsonError(int code,
@@ -65,7 +76,41 @@ protected:
         return jsonResponse(status, j);
     }
 
+    // ====== 阻塞调用卸载 ======
+    // 把耗时的阻塞调用（网段扫描、吊舱云台、脚本执行等）投递到共享执行器的阻塞子系统执行，
+    // 当前连接线程限时等待结果：
+    //   - 超时返回 504，任务若尚未开始则不再执行，已开始的继续在后台执行完毕
+    //   - 执行器已停止返回 503，fn 抛出的异常转为 500
+    // route 用于查找超时配置（route_timeouts_ms），timeout_ms > 0 时直接使用该值。
+    // fn 可能在请求返回后才执行，捕获的参数必须按值捕获。
+    OutgoingResponsePtr runBlocking(const std::string& route,
+                                    std::function<OutgoingResponsePtr()> fn,
+                                    int timeout_ms = 0);
+
+    // 路由的阻塞调用超时（毫秒）
+    static int blockingTimeoutMs(const std::string& route);
+
+    // ====== 响应缓存（ETag） ======
+    // 用于读多写少的状态接口：数据所属模块在数据变化时递增代号（generation），
+    // 代号不变时直接复用上次序列化好的响应体，不再重新构建 JSON。
+    // 响应带 ETag（响应体哈希），请求的 If-None-Match 命中时返回 304 且不带响应体。
+    //   - key 区分不同接口，建议使用路由路径
+    //   - build 仅在首次或代号变化时调用，返回完整的 JSON 响应体
+    OutgoingResponsePtr cachedJsonResponse(const std::shared_ptr<IncomingRequest>& request,
+                                           const std::string& key,
+                                           std::uint64_t generation,
+                                           const std::function<std::string()>& build);
+
+    // 不缓存响应体的 ETag 响应：每次都重新构建 body，只按哈希支持 If-None-Match 返回 304。
+    // 用于无法用代号完整追踪变化的接口（如含运行时状态的列表），只省传输，不会返回过期数据。
+    OutgoingResponsePtr etagJsonResponse(const std::shared_ptr<IncomingRequest>& request,
+                                         std::string body);
+
 private:
+    OutgoingResponsePtr respondWithEtag(const std::shared_ptr<IncomingRequest>& request,
+                                        const std::string& etag,
+                                        const oatpp::String& body);
+
     // 把常用 http code 映射到 oatpp::Status（便于 createResponse）
     inline oatpp::web::protocol::http::Status mapStatusCode(int code) const {
         using Status = oatpp::web::protocol::http::Status;
@@ -74,14 +119,18 @@ private:
             case 201: return Status::CODE_201;
             case 202: return Status::CODE_202;
             case 204: return Status::CODE_204;
+            case 206: return Status::CODE_206;
             case 400: return Status::CODE_400;
             case 401: return Status::CODE_401;
             case 403: return Status::CODE_403;
             case 404: return Status::CODE_404;
             case 409: return Status::CODE_409;
             case 413: return Status::CODE_413;
+            case 416: return Status::CODE_416;
             case 422: return Status::CODE_422;
             case 500: return Status::CODE_500;
+            case 503: return Status::CODE_503;
+            case 504: return Status::CODE_504;
             default:  return Status::CODE_500;
         }
     }
@@ -15,6 +15,11 @@
 #include "controller/demo/edges/EdgesController.hpp"
 #include "controller/demo/tuna/TunaController.h"
 #include "controller/context/ContextController.h"
+#include "controller/executor/ExecutorController.h"
+#include "controller/telemetry/TelemetryController.h"
+#include "controller/metrics/MetricsController.h"
+#include "controller/mqtt/MqttController.h"
+#include "telemetry/TelemetryHub.h"
 
 // #include "oatpp/json/ObjectMapper.hpp" 
 #include "oatpp/parser/json/mapping/ObjectMapper.hpp" 
@@ -28,8 +33,10 @@
 #include "oatpp/web/server/interceptor/RequestInterceptor.hpp"
 
 #include "BaseApiController.hpp"
+#include "PooledHttpConnectionHandler.h"
 #include "oatpp/core/macro/codegen.hpp"
 
+#include "MyExecutor.h"
 #include "MyINIConfig.h"
 #include "MyLog.h"
 #include <sys/stat.h>
@@ -151,6 +158,14 @@ public:
     }
 };
 
+template <typename Handler>
+void AddCorsInterceptors(const std::shared_ptr<Handler>& handler) {
+    // 添加请求拦截器 (处理 OPTIONS)
+    handler->addRequestInterceptor(std::make_shared<CorsInterceptor>());
+    // 添加响应拦截器 (处理所有请求的 Header)
+    handler->addResponseInterceptor(std::make_shared<CorsResponseInterceptor>());
+}
+
 /**
  * @brief 从传入的 JSON 配置中生成启动参数配置文件, 并保存到 api_enable_mapping_ 成员变量中, 主要是解析 "executes" 字段下的每个节点，提取 "model_name" 和 "enable" 字段。
  * 
@@ -245,6 +260,17 @@ void MyAPI::GenerateStartSettingByPipelineConfig(const nlohmann::json& pipeline_
     }
 }
 
+bool MyAPI::ConfigureServer(const nlohmann::json& server_config, std::string* err) {
+    std::string reason;
+    if (!ApiServerOptions::FromJson(server_config, server_options_, &reason)) {
+        MYLOG_ERROR("MyAPI: server 配置非法，保持原配置, error={}", reason);
+        if (err) *err = reason;
+        return false;
+    }
+    MYLOG_INFO("MyAPI: 服务运行参数: {}", server_options_.ToJson().dump());
+    return true;
+}
+
 bool MyAPI::getJsonBool(const nlohmann::json& j, const std::string& key, bool defaultValue) {
     try {
         if (!j.is_object())
@@ -345,6 +371,22 @@ bool MyAPI::LoadAPIModel(
         MYLOG_INFO("MyAPI: 加载运行时上下文 API 模型");
         controller = my_api::context_api::ContextController::createShared(std::static_pointer_cast<oatpp::data::mapping::ObjectMapper>(objectMapper));
         has_model = true;
+    } else if ("executor" == model_name) {
+        MYLOG_INFO("MyAPI: 加载共享执行器 API 模型");
+        controller = my_api::executor_api::ExecutorController::createShared(std::static_pointer_cast<oatpp::data::mapping::ObjectMapper>(objectMapper));
+        has_model = true;
+    } else if ("telemetry" == model_name) {
+        MYLOG_INFO("MyAPI: 加载遥测推送 API 模型");
+        controller = my_api::telemetry_api::TelemetryController::createShared(std::static_pointer_cast<oatpp::data::mapping::ObjectMapper>(objectMapper));
+        has_model = true;
+    } else if ("metrics" == model_name) {
+        MYLOG_INFO("MyAPI: 加载时序指标查询 API 模型");
+        controller = my_api::metrics_api::MetricsController::createShared(std::static_pointer_cast<oatpp::data::mapping::ObjectMapper>(objectMapper));
+        has_model = true;
+    } else if ("mqtt_comm" == model_name) {
+        MYLOG_INFO("MyAPI: 加载 MQTT 通信 API 模型");
+        controller = my_api::mqtt_api::MqttController::createShared(std::static_pointer_cast<oatpp::data::mapping::ObjectMapper>(objectMapper));
+        has_model = true;
     } else {
         MYLOG_WARN("MyAPI: 未知的 API 模型名称: {}", model_name);
     }
@@ -391,7 +433,10 @@ void MyAPI::ServerThread(int port) {
             "soft_healthy",
             "file_cache",
             "ip",
-            "context"
+            "context",
+            "executor",
+            "telemetry",
+            "metrics"
         };
         for (const auto& model_name : default_models) {
             if (LoadAPIModel(router, docEndpoints, objectMapper, model_name)) {
@@ -419,13 +464,27 @@ void MyAPI::ServerThread(int port) {
             MYLOG_WARN("MyAPI: Swagger 资源不可用，跳过 Swagger Controller 注册");
         }
 
+        // 阻塞调用卸载到共享执行器的独立子系统，预算限制同时执行的阻塞调用数
+        base::BaseApiController::SetBlockingCallOptions(server_options_);
+        my_executor::MyExecutor::GetInstance().SetSubsystemBudget(
+            server_options_.blocking_subsystem, server_options_.blocking_budget);
+
         // --- 修正点：ConnectionHandler 只声明一次 ---
-        auto connectionHandler = oatpp::web::server::HttpConnectionHandler::createShared(router);
-        
-        // 添加请求拦截器 (处理 OPTIONS)
-        connectionHandler->addRequestInterceptor(std::make_shared<CorsInterceptor>());
-        // 添加响应拦截器 (处理所有请求的 Header)
-        connectionHandler->addResponseInterceptor(std::make_shared<CorsResponseInterceptor>());
+        std::shared_ptr<oatpp::network::ConnectionHandler> connectionHandler;
+        if (server_options_.mode == ServerMode::Pooled) {
+            PooledHttpConnectionHandler::Options pool_options;
+            pool_options.worker_threads = server_options_.EffectiveWorkerThreads();
+            pool_options.max_pending_connections = server_options_.max_pending_connections;
+            pool_options.keep_alive_timeout_ms = server_options_.keep_alive_timeout_ms;
+            auto pooled = PooledHttpConnectionHandler::createShared(router, pool_options);
+            AddCorsInterceptors(pooled);
+            connectionHandler = pooled;
+        } else {
+            auto threaded = oatpp::web::server::HttpConnectionHandler::createShared(router);
+            AddCorsInterceptors(threaded);
+            connectionHandler = threaded;
+        }
+        MYLOG_INFO("MyAPI: 连接处理模式: {}", ServerModeToString(server_options_.mode));
 
         auto connectionProvider = oatpp::network::tcp::server::ConnectionProvider::createShared(
             {"0.0.0.0", (v_uint16)port, oatpp::network::Address::IP_4});
@@ -434,6 +493,9 @@ void MyAPI::ServerThread(int port) {
 
         MYLOG_INFO("MyAPI: REST Server 已就绪: http://127.0.0.1:{}/swagger/ui", port);
         server.run([this](){ return is_running_.load(); }); 
+        // 推送连接阻塞在等待事件上，先关闭订阅让其响应体结束，连接处理器才能停下
+        telemetry::TelemetryHub::GetInstance().Shutdown();
+        connectionHandler->stop();
     } catch (const std::exception& e) {
         MYLOG_ERROR("MyAPI: REST 线程启动失败: {}", e.what());
     } catch (...) {
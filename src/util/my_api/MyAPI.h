@@ -10,6 +10,7 @@
 #include <csignal>
 #include <nlohmann/json.hpp>
 
+#include "ApiServerOptions.h"
 #include "oatpp/core/base/Environment.hpp"
 #include "oatpp/web/server/interceptor/RequestInterceptor.hpp"
 #include "oatpp/parser/json/mapping/ObjectMapper.hpp" 
@@ -35,6 +36,9 @@ public:
 
     // 生成启动参数配置文件
     void GenerateStartSettingByPipelineConfig(const nlohmann::json& pipeline_config);
+    // 设置服务运行参数（连接处理模式、线程池、阻塞调用超时），需在 Start 之前调用
+    bool ConfigureServer(const nlohmann::json& server_config, std::string* err = nullptr);
+    const ApiServerOptions& GetServerOptions() const { return server_options_; }
     // 在独立线程中启动 API 服务
     void Start(int port = 8000);
     
@@ -66,6 +70,7 @@ private:
 
     nlohmann::json api_enable_mapping_;
     std::vector<std::string> loaded_models_;
+    ApiServerOptions server_options_;
 };
 
 void RunRestServer(int port);
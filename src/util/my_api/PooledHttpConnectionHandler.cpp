@@ -0,0 +1,227 @@
+#include "PooledHttpConnectionHandler.h"
+
+#include "MyLog.h"
+
+#include "oatpp/network/tcp/Connection.hpp"
+
+#include <chrono>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+
+namespace my_api {
+
+namespace {
+
+const std::string& BusyResponse() {
+    static const std::string response = [] {
+        const std::string body = R"({"success":false,"code":503,"message":"服务繁忙，请稍后重试"})";
+        return "HTTP/1.1 503 Service Unavailable\r\n"
+               "Content-Type: application/json\r\n"
+               "Content-Length: " + std::to_string(body.size()) + "\r\n"
+               "Connection: close\r\n"
+               "Access-Control-Allow-Origin: *\r\n"
+               "\r\n" + body;
+    }();
+    return response;
+}
+
+} // namespace
+
+// ============================================================================
+// ConnectionTracker
+// ============================================================================
+
+void PooledHttpConnectionHandler::ConnectionTracker::onTaskStart(const IOStreamHandle& connection) {
+    std::lock_guard<std::mutex> lock(mu_);
+    connections_[connection.object.get()] = connection;
+}
+
+void PooledHttpConnectionHandler::ConnectionTracker::onTaskEnd(const IOStreamHandle& connection) {
+    std::lock_guard<std::mutex> lock(mu_);
+    connections_.erase(connection.object.get());
+}
+
+void PooledHttpConnectionHandler::ConnectionTracker::InvalidateAll() {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (auto& [key, connection] : connections_) {
+        (void)key;
+        connection.invalidator->invalidate(connection.object);
+    }
+}
+
+std::size_t PooledHttpConnectionHandler::ConnectionTracker::Size() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return connections_.size();
+}
+
+// ============================================================================
+// PooledHttpConnectionHandler
+// ============================================================================
+
+PooledHttpConnectionHandler::PooledHttpConnectionHandler(
+    const std::shared_ptr<oatpp::web::server::HttpRouter>& router,
+    const Options& options)
+    : components_(std::make_shared<oatpp::web::server::HttpProcessor::Components>(router)),
+      options_(options) {
+    const int threads = options_.worker_threads > 0 ? options_.worker_threads : 1;
+    workers_.reserve(static_cast<std::size_t>(threads));
+    for (int i = 0; i < threads; ++i) {
+        workers_.emplace_back(&PooledHttpConnectionHandler::WorkerLoop, this);
+    }
+    MYLOG_INFO("[PooledHttpConnectionHandler] 启动: worker_threads={}, max_pending_connections={}, keep_alive_timeout_ms={}",
+               threads, options_.max_pending_connections, options_.keep_alive_timeout_ms);
+}
+
+PooledHttpConnectionHandler::~PooledHttpConnectionHandler() {
+    stop();
+}
+
+std::shared_ptr<PooledHttpConnectionHandler> PooledHttpConnectionHandler::createShared(
+    const std::shared_ptr<oatpp::web::server::HttpRouter>& router,
+    const Options& options) {
+    return std::make_shared<PooledHttpConnectionHandler>(router, options);
+}
+
+void PooledHttpConnectionHandler::addRequestInterceptor(
+    const std::shared_ptr<oatpp::web::server::interceptor::RequestInterceptor>& interceptor) {
+    components_->requestInterceptors.push_back(interceptor);
+}
+
+void PooledHttpConnectionHandler::addResponseInterceptor(
+    const std::shared_ptr<oatpp::web::server::interceptor::ResponseInterceptor>& interceptor) {
+    components_->responseInterceptors.push_back(interceptor);
+}
+
+void PooledHttpConnectionHandler::handleConnection(const IOStreamHandle& connection,
+                                                   const std::shared_ptr<const ParameterMap>& params) {
+    (void)params;
+    connection.object->setOutputStreamIOMode(oatpp::data::stream::IOMode::BLOCKING);
+    connection.object->setInputStreamIOMode(oatpp::data::stream::IOMode::BLOCKING);
+    ApplyKeepAliveTimeout(connection);
+
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (stopping_) {
+            connection.invalidator->invalidate(connection.object);
+            return;
+        }
+        // 空闲线程可以立即取走的连接不计入等待队列
+        const std::size_t capacity = static_cast<std::size_t>(idle_) +
+                                     static_cast<std::size_t>(options_.max_pending_connections);
+        if (pending_.size() < capacity) {
+            pending_.push_back(connection);
+            accepted_.fetch_add(1, std::memory_order_relaxed);
+            cv_.notify_one();
+            return;
+        }
+    }
+
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    MYLOG_WARN("[PooledHttpConnectionHandler] 工作线程与等待队列已满，拒绝连接");
+    Reject(connection);
+}
+
+void PooledHttpConnectionHandler::stop() {
+    std::vector<std::thread> workers;
+    std::deque<IOStreamHandle> pending;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        workers.swap(workers_);
+        pending.swap(pending_);
+    }
+    cv_.notify_all();
+
+    for (auto& connection : pending) {
+        connection.invalidator->invalidate(connection.object);
+    }
+
+    // 正在处理的连接可能阻塞在读请求上，关闭连接后工作线程才能退出；
+    // 线程取出连接到登记到 tracker 之间有短暂窗口，因此循环关闭直到全部线程退出
+    while (live_workers_.load() > 0) {
+        tracker_.InvalidateAll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    MYLOG_INFO("[PooledHttpConnectionHandler] 已停止: accepted={}, rejected={}",
+               accepted_.load(), rejected_.load());
+}
+
+nlohmann::json PooledHttpConnectionHandler::GetStatsJson() const {
+    nlohmann::json j;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        j["worker_threads"] = options_.worker_threads;
+        j["idle_workers"] = idle_;
+        j["pending_connections"] = pending_.size();
+        j["stopping"] = stopping_;
+    }
+    j["max_pending_connections"] = options_.max_pending_connections;
+    j["active_connections"] = tracker_.Size();
+    j["accepted"] = accepted_.load();
+    j["rejected"] = rejected_.load();
+    return j;
+}
+
+void PooledHttpConnectionHandler::WorkerLoop() {
+    live_workers_.fetch_add(1);
+    for (;;) {
+        IOStreamHandle connection;
+        {
+            std::unique_lock<std::mutex> lock(mu_);
+            ++idle_;
+            cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            --idle_;
+            if (stopping_) {
+                break;
+            }
+            connection = std::move(pending_.front());
+            pending_.pop_front();
+        }
+
+        try {
+            oatpp::web::server::HttpProcessor::Task task(components_, connection, &tracker_);
+            task.run();
+        } catch (const std::exception& e) {
+            MYLOG_ERROR("[PooledHttpConnectionHandler] 连接处理异常: {}", e.what());
+        } catch (...) {
+            MYLOG_ERROR("[PooledHttpConnectionHandler] 连接处理异常: unknown");
+        }
+    }
+    live_workers_.fetch_sub(1);
+}
+
+void PooledHttpConnectionHandler::ApplyKeepAliveTimeout(const IOStreamHandle& connection) const {
+    if (options_.keep_alive_timeout_ms <= 0) {
+        return;
+    }
+    // 仅 TCP 连接可设置读超时（进程内虚拟连接等直接跳过）；
+    // 超时后读请求失败，HttpProcessor 随即关闭连接并释放工作线程
+    auto* tcp = dynamic_cast<oatpp::network::tcp::Connection*>(connection.object.get());
+    if (tcp == nullptr) {
+        return;
+    }
+    timeval tv{};
+    tv.tv_sec = options_.keep_alive_timeout_ms / 1000;
+    tv.tv_usec = (options_.keep_alive_timeout_ms % 1000) * 1000;
+    if (::setsockopt(tcp->getHandle(), SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) != 0) {
+        MYLOG_WARN("[PooledHttpConnectionHandler] 设置连接读超时失败");
+    }
+}
+
+void PooledHttpConnectionHandler::Reject(const IOStreamHandle& connection) {
+    const auto& response = BusyResponse();
+    connection.object->writeExactSizeDataSimple(response.data(), static_cast<v_buff_size>(response.size()));
+    connection.invalidator->invalidate(connection.object);
+}
+
+} // namespace my_api
@@ -0,0 +1,98 @@
+#pragma once
+
+/**
+ * @file PooledHttpConnectionHandler.h
+ * @brief 固定线程池的 HTTP 连接处理器
+ *
+ * oatpp 自带的 HttpConnectionHandler 为每个连接创建一个线程，连接数不受限制；
+ * 本处理器使用固定数量的工作线程处理连接（同一连接上的 keep-alive 请求由同一线程依次处理），
+ * 所有线程忙时连接进入有界等待队列，队列满时直接回复 503 并关闭连接。
+ * TCP 连接设置 keep_alive_timeout_ms 读超时：空闲的长连接（以及长时间无数据的请求体）超时后关闭，
+ * 避免空闲连接长期占用工作线程。
+ *
+ * 控制器仍是同步 ENDPOINT，请求处理流程（路由、拦截器、错误处理）与 HttpConnectionHandler 相同。
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "oatpp/network/ConnectionHandler.hpp"
+#include "oatpp/web/server/HttpProcessor.hpp"
+#include "oatpp/web/server/HttpRouter.hpp"
+
+namespace my_api {
+
+class PooledHttpConnectionHandler : public oatpp::network::ConnectionHandler {
+public:
+    using IOStreamHandle = oatpp::provider::ResourceHandle<oatpp::data::stream::IOStream>;
+
+    struct Options {
+        int worker_threads = 8;
+        int max_pending_connections = 64;
+        int keep_alive_timeout_ms = 5000;
+    };
+
+    PooledHttpConnectionHandler(const std::shared_ptr<oatpp::web::server::HttpRouter>& router,
+                                const Options& options);
+    ~PooledHttpConnectionHandler() override;
+
+    static std::shared_ptr<PooledHttpConnectionHandler> createShared(
+        const std::shared_ptr<oatpp::web::server::HttpRouter>& router,
+        const Options& options);
+
+    void addRequestInterceptor(const std::shared_ptr<oatpp::web::server::interceptor::RequestInterceptor>& interceptor);
+    void addResponseInterceptor(const std::shared_ptr<oatpp::web::server::interceptor::ResponseInterceptor>& interceptor);
+
+    void handleConnection(const IOStreamHandle& connection,
+                          const std::shared_ptr<const ParameterMap>& params) override;
+
+    /// 停止接收新连接，关闭所有活动 / 排队中的连接并回收工作线程（可重复调用）
+    void stop() override;
+
+    /// 工作线程数、活动连接数、排队数、累计接收 / 拒绝数
+    nlohmann::json GetStatsJson() const;
+
+private:
+    // 记录活动连接，stop() 时逐个关闭
+    class ConnectionTracker : public oatpp::web::server::HttpProcessor::TaskProcessingListener {
+    public:
+        void onTaskStart(const IOStreamHandle& connection) override;
+        void onTaskEnd(const IOStreamHandle& connection) override;
+        void InvalidateAll();
+        std::size_t Size() const;
+
+    private:
+        mutable std::mutex mu_;
+        std::unordered_map<const void*, IOStreamHandle> connections_;
+    };
+
+    void WorkerLoop();
+    void ApplyKeepAliveTimeout(const IOStreamHandle& connection) const;
+    static void Reject(const IOStreamHandle& connection);
+
+    std::shared_ptr<oatpp::web::server::HttpProcessor::Components> components_;
+    const Options options_;
+
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<IOStreamHandle> pending_;
+    std::vector<std::thread> workers_;
+    int idle_ = 0;                            // 正在等待连接的工作线程数
+    bool stopping_ = false;
+    std::atomic<int> live_workers_{0};
+
+    ConnectionTracker tracker_;
+    std::atomic<std::uint64_t> accepted_{0};
+    std::atomic<std::uint64_t> rejected_{0};
+};
+
+} // namespace my_api
@@ -27,9 +27,12 @@ EdgesController::createShared(
     return std::make_shared<EdgesController>(objectMapper);
 }
 
-MyAPIResponsePtr EdgesController::getEdgesStatus() {
+MyAPIResponsePtr EdgesController::getEdgesStatus(const std::shared_ptr<IncomingRequest>& request) {
     MYLOG_INFO("[API] 收到请求: GET /v1/edges/status");
 
+    // 不按 Edge 集合代号缓存响应体：online / biz_status 等字段来自 EdgeStatus 运行时快照，
+    // 随心跳与运行状态变化，而集合代号只在添加 / 删除 Edge 时递增，缓存会在 ETag 匹配的情况下返回过期状态。
+    // 每次重新构建，仍带 ETag 以便客户端用 If-None-Match 省去未变化时的传输。
     auto status_map = ::my_edge::MyEdgeManager::GetInstance().GetHeartbeatInfo();
 
     auto result =
@@ -45,7 +48,7 @@ MyAPIResponsePtr EdgesController::getEdgesStatus() {
         result->push_back(dto);
     }
 
-    return createDtoResponse(Status::CODE_200, result);
+    return etagJsonResponse(request, std::string(*getDefaultObjectMapper()->writeToString(result)));
 }
 
 MyAPIResponsePtr EdgesController::startAllEdges() {
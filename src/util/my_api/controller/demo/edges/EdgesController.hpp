@@ -21,7 +21,8 @@ public:
 
     static std::shared_ptr<EdgesController> createShared(const std::shared_ptr<ObjectMapper>& objectMapper);
 
-    ENDPOINT("GET", "/v1/edges/status", getEdgesStatus);
+    ENDPOINT("GET", "/v1/edges/status", getEdgesStatus,
+             REQUEST(std::shared_ptr<IncomingRequest>, request));
 
     ENDPOINT("POST", "/v1/edges/startAllEdges", startAllEdges);
 
@@ -0,0 +1,27 @@
+#include "ExecutorController.h"
+
+#include "MyExecutor.h"
+#include "MyLog.h"
+
+namespace my_api::executor_api {
+
+using namespace my_api::base;
+
+ExecutorController::ExecutorController(const std::shared_ptr<ObjectMapper>& objectMapper)
+	: BaseApiController(objectMapper) {}
+
+std::shared_ptr<ExecutorController> ExecutorController::createShared(
+	const std::shared_ptr<ObjectMapper>& objectMapper) {
+	return std::make_shared<ExecutorController>(objectMapper);
+}
+
+// ============================================================
+//  GET /v1/executor/stats
+// ============================================================
+
+ExecutorController::MyAPIResponsePtr ExecutorController::getExecutorStats() {
+	MYLOG_DEBUG("[Executor API] 收到获取执行器统计请求");
+	return jsonOk(my_executor::MyExecutor::GetInstance().GetStatsJson(), "获取执行器统计成功");
+}
+
+} // namespace my_api::executor_api
@@ -0,0 +1,40 @@
+#pragma once
+
+/**
+ * @file ExecutorController.h
+ * @brief 共享执行器（MyExecutor）REST API 控制器
+ *
+ * 对外暴露以下接口：
+ * - GET /v1/executor/stats : 获取线程池 / 定时器 / 子系统运行统计
+ */
+
+#include "BaseApiController.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/web/server/api/ApiController.hpp"
+
+namespace my_api::executor_api {
+
+#include OATPP_CODEGEN_BEGIN(ApiController)
+
+class ExecutorController : public base::BaseApiController {
+public:
+	using MyAPIResponsePtr = my_api::base::MyAPIResponsePtr;
+	static constexpr const char* SWAGGER_TAG = "ExecutorController";
+	explicit ExecutorController(const std::shared_ptr<ObjectMapper>& objectMapper);
+
+	static std::shared_ptr<ExecutorController> createShared(
+		const std::shared_ptr<ObjectMapper>& objectMapper);
+
+	ENDPOINT_INFO(getExecutorStats) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "获取共享执行器运行统计";
+		info->description = "返回各 worker 队列深度、执行数、窃取数，注入队列深度，\n"
+		                    "定时器数量，以及各子系统的并发上限、运行数与排队数。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+	}
+	ENDPOINT("GET", "/v1/executor/stats", getExecutorStats);
+};
+
+#include OATPP_CODEGEN_END(ApiController)
+
+} // namespace my_api::executor_api
@@ -18,6 +18,15 @@
 #include "oatpp/web/mime/multipart/PartList.hpp"
 #include "oatpp/web/mime/multipart/Reader.hpp"
 #include "oatpp/web/protocol/http/Http.hpp"
+#include "oatpp/web/protocol/http/outgoing/Body.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace my_api::file_cache_api;
 using namespace my_api::base;
@@ -39,23 +48,136 @@ std::string PartToString(const std::shared_ptr<oatpp::web::mime::multipart::Part
     return std::string(data->c_str(), data->size());
 }
 
-std::vector<uint8_t> PartToBytes(const std::shared_ptr<oatpp::web::mime::multipart::Part>& part) {
-    if (!part || !part->getPayload()) {
-        return {};
+bool IsMultipartFormData(const oatpp::String& content_type) {
+    return content_type && std::string(content_type->c_str()).find("multipart/form-data") != std::string::npos;
+}
+
+/// 请求体未读完就返回错误时关闭连接，避免残留数据被当作下一个请求解析
+MyAPIResponsePtr CloseAfter(MyAPIResponsePtr response) {
+    response->putHeader("Connection", "close");
+    return response;
+}
+
+/**
+ * @brief 将请求体直接写入 CacheFileWriter，写入失败时中止传输
+ */
+class CacheWriterCallback : public oatpp::data::stream::WriteCallback {
+public:
+    explicit CacheWriterCallback(CacheFileWriter* writer) : writer_(writer) {}
+
+    oatpp::v_io_size write(const void* data, oatpp::v_buff_size count, oatpp::async::Action& action) override {
+        (void)action;
+        if (writer_->Write(data, static_cast<size_t>(count)) != CacheErrorCode::Ok) {
+            return oatpp::IOError::BROKEN_PIPE;
+        }
+        return count;
     }
 
-    auto data = part->getPayload()->getInMemoryData();
-    if (!data) {
-        return {};
+private:
+    CacheFileWriter* writer_;
+};
+
+/**
+ * @brief multipart 中 file 字段的读取器：边解析边写入暂存文件，不在内存中缓存文件内容
+ *
+ * 写入失败后继续读完该字段（丢弃数据），保证 multipart 解析完整，错误由 Error() 返回。
+ */
+class CacheWriterPartReader : public oatpp::web::mime::multipart::PartReader {
+public:
+    explicit CacheWriterPartReader(MyCache* cache) : cache_(cache) {}
+
+    void onNewPart(const std::shared_ptr<oatpp::web::mime::multipart::Part>& part) override {
+        (void)part;
+        if (writer_ || error_ != CacheErrorCode::Ok) {
+            error_ = CacheErrorCode::InvalidArgument;   // 重复的 file 字段
+            return;
+        }
+        auto writer_result = cache_->OpenWriter();
+        if (!writer_result.Ok()) {
+            error_ = writer_result.code;
+            return;
+        }
+        writer_ = std::move(writer_result.value);
     }
 
-    const auto* begin = reinterpret_cast<const uint8_t*>(data->data());
-    return std::vector<uint8_t>(begin, begin + data->size());
-}
+    void onPartData(const std::shared_ptr<oatpp::web::mime::multipart::Part>& part,
+                    const char* data, oatpp::v_io_size size) override {
+        (void)part;
+        if (size > 0 && writer_ && error_ == CacheErrorCode::Ok) {
+            writer_->Write(data, static_cast<size_t>(size));
+        }
+    }
 
-bool IsMultipartFormData(const oatpp::String& content_type) {
-    return content_type && std::string(content_type->c_str()).find("multipart/form-data") != std::string::npos;
-}
+    CacheErrorCode Error() const {
+        if (error_ != CacheErrorCode::Ok) {
+            return error_;
+        }
+        return writer_ ? writer_->Error() : CacheErrorCode::Ok;
+    }
+
+    CacheFileWriter* Writer() const { return writer_.get(); }
+
+private:
+    MyCache* cache_;
+    std::unique_ptr<CacheFileWriter> writer_;
+    CacheErrorCode error_ = CacheErrorCode::Ok;
+};
+
+/**
+ * @brief 文件区间响应体：按 oatpp 输出缓冲区大小 pread 文件，内存占用与文件大小无关
+ *
+ * 持有文件描述符直到响应发送完毕（析构时关闭）。
+ */
+class FileRangeBody : public oatpp::web::protocol::http::outgoing::Body {
+public:
+    FileRangeBody(int fd, uint64_t start, uint64_t length)
+        : fd_(fd), offset_(start), remaining_(length), length_(length) {
+        ::posix_fadvise(fd_, static_cast<off_t>(start), static_cast<off_t>(length), POSIX_FADV_SEQUENTIAL);
+    }
+
+    ~FileRangeBody() override {
+        ::close(fd_);
+    }
+
+    oatpp::v_io_size read(void* buffer, oatpp::v_buff_size count, oatpp::async::Action& action) override {
+        (void)action;
+        if (remaining_ == 0) {
+            return 0;
+        }
+        const size_t want = static_cast<size_t>(std::min<uint64_t>(static_cast<uint64_t>(count), remaining_));
+        ssize_t n;
+        do {
+            n = ::pread(fd_, buffer, want, static_cast<off_t>(offset_));
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) {
+            // 文件在发送过程中被截断或读取出错，已声明的 Content-Length 无法满足，只能断开连接
+            MYLOG_ERROR("[FileApiController] 下载读取文件失败：offset={}, 错误：{}",
+                        offset_, n < 0 ? std::strerror(errno) : "文件被截断");
+            return oatpp::IOError::BROKEN_PIPE;
+        }
+        offset_ += static_cast<uint64_t>(n);
+        remaining_ -= static_cast<uint64_t>(n);
+        return n;
+    }
+
+    void declareHeaders(oatpp::web::protocol::http::Headers& headers) override {
+        (void)headers;
+    }
+
+    oatpp::p_char8 getKnownData() override {
+        return nullptr;
+    }
+
+    oatpp::v_int64 getKnownSize() override {
+        return static_cast<oatpp::v_int64>(length_);
+    }
+
+private:
+    int fd_;
+    uint64_t offset_;
+    uint64_t remaining_;
+    uint64_t length_;
+};
 
 }  // namespace
 
@@ -116,9 +238,6 @@ MyAPIResponsePtr FileApiController::uploadFile(
         return jsonError(400, "data 字段 Base64 解码后为空");
     }
 
-    // 转换为 vector<uint8_t>
-    std::vector<uint8_t> file_data(decoded->begin(), decoded->end());
-
     auto cache_result = MyCacheProvider::Get();
     if (!cache_result.Ok()) {
         MYLOG_ERROR("[FileApiController] MyCache 未初始化");
@@ -127,7 +246,18 @@ MyAPIResponsePtr FileApiController::uploadFile(
                          {{"error_code", CacheErrorCodeToString(cache_result.code)}});
     }
 
-    auto save_result = cache_result.value->SaveFile(filename, file_data);
+    // 解码结果直接写入暂存文件，不再复制为 vector
+    const size_t file_size = decoded->size();
+    CacheResult<void> save_result = CacheResult<void>::Success();
+    auto writer_result = cache_result.value->OpenWriter();
+    if (!writer_result.Ok()) {
+        save_result = CacheResult<void>::Fail(writer_result.code);
+    } else {
+        auto write_code = writer_result.value->Write(decoded->data(), file_size);
+        save_result = write_code == CacheErrorCode::Ok
+            ? writer_result.value->Commit(filename)
+            : CacheResult<void>::Fail(write_code);
+    }
     if (!save_result.Ok()) {
         int http_code = CacheErrorToHttpCode(save_result.code);
         MYLOG_WARN("[FileApiController] 文件保存失败：filename={}, 错误={}", filename, CacheErrorCodeToString(save_result.code));
@@ -137,8 +267,8 @@ MyAPIResponsePtr FileApiController::uploadFile(
                           {"filename", filename}});
     }
 
-    MYLOG_INFO("[FileApiController] 文件上传成功：filename={}, 大小={} 字节", filename, file_data.size());
-    return jsonOk({{"filename", filename}, {"size", file_data.size()}}, "文件上传成功");
+    MYLOG_INFO("[FileApiController] 文件上传成功：filename={}, 大小={} 字节", filename, file_size);
+    return jsonOk({{"filename", filename}, {"size", file_size}}, "文件上传成功");
 }
 
 // ============================================================================
@@ -166,10 +296,13 @@ MyAPIResponsePtr FileApiController::uploadLocalFile(
                          {{"error_code", CacheErrorCodeToString(cache_result.code)}});
     }
 
+    // file 字段流式写入暂存文件；其余文本字段（file_name）较小，读入内存
+    auto file_reader = std::make_shared<CacheWriterPartReader>(cache_result.value);
     auto multipart = std::make_shared<oatpp::web::mime::multipart::PartList>(request->getHeaders());
     oatpp::web::mime::multipart::Reader multipart_reader(multipart.get());
+    multipart_reader.setPartReader("file", file_reader);
     multipart_reader.setDefaultPartReader(
-        oatpp::web::mime::multipart::createInMemoryPartReader(-1));
+        oatpp::web::mime::multipart::createInMemoryPartReader(64 * 1024));
 
     try {
         request->transferBody(&multipart_reader);
@@ -201,12 +334,22 @@ MyAPIResponsePtr FileApiController::uploadLocalFile(
         return jsonError(400, "file_name 校验失败", {{"detail", filename_err}});
     }
 
-    if (!file_part->getPayload()) {
+    CacheFileWriter* writer = file_reader->Writer();
+    const auto write_code = file_reader->Error();
+    if (write_code != CacheErrorCode::Ok) {
+        MYLOG_WARN("[FileApiController] 客户端文件写入失败：file_name={}, 错误={}",
+                   file_name, CacheErrorCodeToString(write_code));
+        return jsonError(CacheErrorToHttpCode(write_code),
+                         "文件导入失败",
+                         {{"error_code", CacheErrorCodeToString(write_code)},
+                          {"file_name", file_name}});
+    }
+    if (!writer || writer->Size() == 0) {
         return jsonError(400, "上传文件内容为空");
     }
 
-    auto file_data = PartToBytes(file_part);
-    auto save_result = cache_result.value->SaveFile(file_name, file_data);
+    const uint64_t file_size = writer->Size();
+    auto save_result = writer->Commit(file_name);
     if (!save_result.Ok()) {
         const int http_code = CacheErrorToHttpCode(save_result.code);
         MYLOG_WARN("[FileApiController] 客户端文件导入失败：file_name={}, 错误={}",
@@ -218,12 +361,372 @@ MyAPIResponsePtr FileApiController::uploadLocalFile(
     }
 
     MYLOG_INFO("[FileApiController] 客户端本地文件导入成功：file_name={}, 大小={} 字节",
-               file_name, file_data.size());
+               file_name, file_size);
     return jsonOk({{"file_name", file_name},
-                   {"size", file_data.size()}},
+                   {"size", file_size}},
                   "文件导入成功");
 }
 
+// ============================================================================
+// PUT /v1/cache/upload-stream
+// ============================================================================
+
+MyAPIResponsePtr FileApiController::uploadStream(
+    const oatpp::String& filename_param,
+    const std::shared_ptr<IncomingRequest>& request) {
+    MYLOG_INFO("[FileApiController] uploadStream 请求收到");
+
+    if (!request) {
+        return jsonError(400, "请求对象无效");
+    }
+    const std::string filename = filename_param ? filename_param->c_str() : std::string();
+
+    // 先校验文件名再读取请求体，非法请求不落盘
+    std::string filename_err;
+    if (!ValidateFilename(filename, filename_err)) {
+        MYLOG_WARN("[FileApiController] filename 校验失败：{}", filename_err);
+        return CloseAfter(jsonError(400, "filename 校验失败", {{"detail", filename_err}}));
+    }
+
+    auto cache_result = MyCacheProvider::Get();
+    if (!cache_result.Ok()) {
+        MYLOG_ERROR("[FileApiController] MyCache 未初始化");
+        return CloseAfter(jsonError(CacheErrorToHttpCode(cache_result.code),
+                                    "文件缓存服务未初始化",
+                                    {{"error_code", CacheErrorCodeToString(cache_result.code)}}));
+    }
+
+    auto writer_result = cache_result.value->OpenWriter();
+    if (!writer_result.Ok()) {
+        return CloseAfter(jsonError(CacheErrorToHttpCode(writer_result.code),
+                                    "文件上传失败",
+                                    {{"error_code", CacheErrorCodeToString(writer_result.code)},
+                                     {"filename", filename}}));
+    }
+    auto& writer = writer_result.value;
+
+    CacheWriterCallback callback(writer.get());
+    try {
+        request->transferBody(&callback);
+    } catch (const std::exception& e) {
+        MYLOG_WARN("[FileApiController] 接收请求体失败：filename={}, 错误={}", filename, e.what());
+        return CloseAfter(jsonError(400, "接收请求体失败", {{"detail", e.what()}}));
+    }
+
+    CacheResult<void> save_result = writer->Error() == CacheErrorCode::Ok
+        ? writer->Commit(filename)
+        : CacheResult<void>::Fail(writer->Error());
+    if (!save_result.Ok()) {
+        MYLOG_WARN("[FileApiController] 流式上传失败：filename={}, 错误={}",
+                   filename, CacheErrorCodeToString(save_result.code));
+        auto response = jsonError(CacheErrorToHttpCode(save_result.code),
+                                  "文件上传失败",
+                                  {{"error_code", CacheErrorCodeToString(save_result.code)},
+                                   {"filename", filename}});
+        return writer->Error() != CacheErrorCode::Ok ? CloseAfter(response) : response;
+    }
+
+    MYLOG_INFO("[FileApiController] 流式上传成功：filename={}, 大小={} 字节", filename, writer->Size());
+    return jsonOk({{"filename", filename}, {"size", writer->Size()}}, "文件上传成功");
+}
+
+// ============================================================================
+// POST /v1/cache/upload-session
+// ============================================================================
+
+MyAPIResponsePtr FileApiController::beginUploadSession(
+    const oatpp::Object<my_api::dto::CacheUploadSessionRequestDto>& requestDto) {
+    MYLOG_INFO("[FileApiController] beginUploadSession 请求收到");
+
+    if (!requestDto || !requestDto->filename || !requestDto->total_size) {
+        return jsonError(400, "缺少必需字段 filename / total_size 或类型错误");
+    }
+    const std::string filename = requestDto->filename->c_str();
+    const uint64_t total_size = *requestDto->total_size;
+
+    std::string filename_err;
+    if (!ValidateFilename(filename, filename_err)) {
+        MYLOG_WARN("[FileApiController] filename 校验失败：{}", filename_err);
+        return jsonError(400, "filename 校验失败", {{"detail", filename_err}});
+    }
+
+    auto cache_result = MyCacheProvider::Get();
+    if (!cache_result.Ok()) {
+        MYLOG_ERROR("[FileApiController] MyCache 未初始化");
+        return jsonError(CacheErrorToHttpCode(cache_result.code),
+                         "文件缓存服务未初始化",
+                         {{"error_code", CacheErrorCodeToString(cache_result.code)}});
+    }
+
+    auto begin_result = cache_result.value->BeginUpload(filename, total_size);
+    if (!begin_result.Ok()) {
+        MYLOG_WARN("[FileApiController] 创建上传会话失败：filename={}, 错误={}",
+                   filename, CacheErrorCodeToString(begin_result.code));
+        return jsonError(CacheErrorToHttpCode(begin_result.code),
+                         "创建上传会话失败",
+                         {{"error_code", CacheErrorCodeToString(begin_result.code)},
+                          {"filename", filename}});
+    }
+
+    const auto& session = begin_result.value;
+    return jsonOk({{"upload_id", session.upload_id},
+                   {"filename", session.name},
+                   {"total_size", session.total_size},
+                   {"received", session.received}},
+                  "上传会话已创建");
+}
+
+// ============================================================================
+// PUT /v1/cache/upload-session/chunk
+// ============================================================================
+
+MyAPIResponsePtr FileApiController::uploadSessionChunk(
+    const oatpp::String& upload_id_param,
+    const oatpp::String& offset_param,
+    const std::shared_ptr<IncomingRequest>& request) {
+    if (!request) {
+        return jsonError(400, "请求对象无效");
+    }
+    const std::string upload_id = upload_id_param ? upload_id_param->c_str() : std::string();
+    uint64_t offset = 0;
+    if (upload_id.empty() || !offset_param || !ParseUint64(offset_param->c_str(), offset)) {
+        return CloseAfter(jsonError(400, "缺少必需参数 upload_id / offset 或格式错误"));
+    }
+
+    auto cache_result = MyCacheProvider::Get();
+    if (!cache_result.Ok()) {
+        MYLOG_ERROR("[FileApiController] MyCache 未初始化");
+        return CloseAfter(jsonError(CacheErrorToHttpCode(cache_result.code),
+                                    "文件缓存服务未初始化",
+                                    {{"error_code", CacheErrorCodeToString(cache_result.code)}}));
+    }
+
+    auto writer_result = cache_result.value->OpenUploadChunk(upload_id, offset);
+    if (!writer_result.Ok()) {
+        // 偏移不一致时返回服务端记录的已接收字节数，便于客户端续传
+        json details = {{"error_code", CacheErrorCodeToString(writer_result.code)}, {"upload_id", upload_id}};
+        auto session_result = cache_result.value->GetUpload(upload_id);
+        if (session_result.Ok()) {
+            details["received"] = session_result.value.received;
+        }
+        return CloseAfter(jsonError(CacheErrorToHttpCode(writer_result.code), "分片上传失败", details));
+    }
+    auto& writer = writer_result.value;
+
+    CacheWriterCallback callback(writer.get());
+    std::string transfer_error;
+    try {
+        request->transferBody(&callback);
+    } catch (const std::exception& e) {
+        transfer_error = e.what();
+    }
+
+    // 无论传输是否完整都记录已写入的数据，客户端从 received 处续传
+    auto close_result = writer->Close();
+    const uint64_t received = writer->Size();
+    if (!transfer_error.empty() || !close_result.Ok()) {
+        const auto code = close_result.Ok() ? CacheErrorCode::IoError : close_result.code;
+        MYLOG_WARN("[FileApiController] 分片接收中断：upload_id={}, received={}, 错误={}",
+                   upload_id, received, transfer_error.empty() ? CacheErrorCodeToString(code) : transfer_error);
+        return CloseAfter(jsonError(transfer_error.empty() ? CacheErrorToHttpCode(code) : 400,
+                                    "分片上传失败",
+                                    {{"error_code", CacheErrorCodeToString(code)},
+                                     {"upload_id", upload_id},
+                                     {"received", received}}));
+    }
+
+    MYLOG_DEBUG("[FileApiController] 分片上传成功：upload_id={}, 本次={} 字节, received={}",
+                upload_id, writer->Written(), received);
+    return jsonOk({{"upload_id", upload_id},
+                   {"written", writer->Written()},
+                   {"received", received}},
+                  "分片上传成功");
+}
+
+// ============================================================================
+// POST /v1/cache/upload-session/status
+// ============================================================================
+
+MyAPIResponsePtr FileApiController::uploadSessionStatus(
+    const oatpp::Object<my_api::dto::CacheUploadIdRequestDto>& requestDto) {
+    if (!requestDto || !requestDto->upload_id || requestDto->upload_id->empty()) {
+        return jsonError(400, "缺少必需字段 upload_id 或类型错误");
+    }
+    const std::string upload_id = requestDto->upload_id->c_str();
+
+    auto cache_result = MyCacheProvider::Get();
+    if (!cache_result.Ok()) {
+        MYLOG_ERROR("[FileApiController] MyCache 未初始化");
+        return jsonError(CacheErrorToHttpCode(cache_result.code),
+                         "文件缓存服务未初始化",
+                         {{"error_code", CacheErrorCodeToString(cache_result.code)}});
+    }
+
+    auto session_result = cache_result.value->GetUpload(upload_id);
+    if (!session_result.Ok()) {
+        return jsonError(CacheErrorToHttpCode(session_result.code),
+                         "上传会话不存在",
+                         {{"error_code", CacheErrorCodeToString(session_result.code)},
+                          {"upload_id", upload_id}});
+    }
+
+    const auto& session = session_result.value;
+    return jsonOk({{"upload_id", session.upload_id},
+                   {"filename", session.name},
+                   {"total_size", session.total_size},
+                   {"received", session.received}},
+                  "查询成功");
+}
+
+// ============================================================================
+// POST /v1/cache/upload-session/commit
+// ============================================================================
+
+MyAPIResponsePtr FileApiController::commitUploadSession(
+    const oatpp::Object<my_api::dto::CacheUploadIdRequestDto>& requestDto) {
+    MYLOG_INFO("[FileApiController] commitUploadSession 请求收到");
+
+    if (!requestDto || !requestDto->upload_id || requestDto->upload_id->empty()) {
+        return jsonError(400, "缺少必需字段 upload_id 或类型错误");
+    }
+    const std::string upload_id = requestDto->upload_id->c_str();
+
+    auto cache_result = MyCacheProvider::Get();
+    if (!cache_result.Ok()) {
+        MYLOG_ERROR("[FileApiController] MyCache 未初始化");
+        return jsonError(CacheErrorToHttpCode(cache_result.code),
+                         "文件缓存服务未初始化",
+                         {{"error_code", CacheErrorCodeToString(cache_result.code)}});
+    }
+
+    auto session_result = cache_result.value->GetUpload(upload_id);
+    auto commit_result = cache_result.value->CommitUpload(upload_id);
+    if (!commit_result.Ok()) {
+        MYLOG_WARN("[FileApiController] 提交上传会话失败：upload_id={}, 错误={}",
+                   upload_id, CacheErrorCodeToString(commit_result.code));
+        return jsonError(CacheErrorToHttpCode(commit_result.code),
+                         "提交上传会话失败",
+                         {{"error_code", CacheErrorCodeToString(commit_result.code)},
+                          {"upload_id", upload_id}});
+    }
+
+    const auto& session = session_result.value;
+    return jsonOk({{"upload_id", upload_id},
+                   {"filename", session.name},
+                   {"size", session.total_size}},
+                  "文件上传成功");
+}
+
+// ============================================================================
+// POST /v1/cache/upload-session/abort
+// ============================================================================
+
+MyAPIResponsePtr FileApiController::abortUploadSession(
+    const oatpp::Object<my_api::dto::CacheUploadIdRequestDto>& requestDto) {
+    MYLOG_INFO("[FileApiController] abortUploadSession 请求收到");
+
+    if (!requestDto || !requestDto->upload_id || requestDto->upload_id->empty()) {
+        return jsonError(400, "缺少必需字段 upload_id 或类型错误");
+    }
+    const std::string upload_id = requestDto->upload_id->c_str();
+
+    auto cache_result = MyCacheProvider::Get();
+    if (!cache_result.Ok()) {
+        MYLOG_ERROR("[FileApiController] MyCache 未初始化");
+        return jsonError(CacheErrorToHttpCode(cache_result.code),
+                         "文件缓存服务未初始化",
+                         {{"error_code", CacheErrorCodeToString(cache_result.code)}});
+    }
+
+    auto abort_result = cache_result.value->AbortUpload(upload_id);
+    if (!abort_result.Ok()) {
+        return jsonError(CacheErrorToHttpCode(abort_result.code),
+                         "取消上传会话失败",
+                         {{"error_code", CacheErrorCodeToString(abort_result.code)},
+                          {"upload_id", upload_id}});
+    }
+
+    return jsonOk({{"upload_id", upload_id}}, "上传会话已取消");
+}
+
+// ============================================================================
+// GET /v1/cache/download
+// ============================================================================
+
+MyAPIResponsePtr FileApiController::downloadFile(
+    const oatpp::String& filename_param,
+    const std::shared_ptr<IncomingRequest>& request) {
+    MYLOG_INFO("[FileApiController] downloadFile 请求收到");
+
+    const std::string filename = filename_param ? filename_param->c_str() : std::string();
+    std::string filename_err;
+    if (!ValidateFilename(filename, filename_err)) {
+        MYLOG_WARN("[FileApiController] filename 校验失败：{}", filename_err);
+        return jsonError(400, "filename 校验失败", {{"detail", filename_err}});
+    }
+
+    auto cache_result = MyCacheProvider::Get();
+    if (!cache_result.Ok()) {
+        MYLOG_ERROR("[FileApiController] MyCache 未初始化");
+        return jsonError(CacheErrorToHttpCode(cache_result.code),
+                         "文件缓存服务未初始化",
+                         {{"error_code", CacheErrorCodeToString(cache_result.code)}});
+    }
+
+    // GetFullPath 同时记录访问时间与次数，供容量淘汰使用
+    auto path_result = cache_result.value->GetFullPath(filename);
+    if (!path_result.Ok()) {
+        return jsonError(CacheErrorToHttpCode(path_result.code),
+                         "文件下载失败",
+                         {{"error_code", CacheErrorCodeToString(path_result.code)},
+                          {"filename", filename}});
+    }
+
+    int fd = ::open(path_result.value.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st {};
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+        const int err = errno;
+        MYLOG_ERROR("[FileApiController] 打开文件失败：{}, 错误：{}", path_result.value, std::strerror(err));
+        if (fd >= 0) ::close(fd);
+        return jsonError(err == ENOENT ? 404 : 500, "文件下载失败", {{"filename", filename}});
+    }
+    const uint64_t file_size = static_cast<uint64_t>(st.st_size);
+
+    ByteRange range{0, file_size};
+    oatpp::String range_header;
+    if (request) {
+        range_header = request->getHeader("Range");
+    }
+    auto range_result = range_header
+        ? ParseRangeHeader(range_header->c_str(), file_size, range)
+        : RangeParseResult::None;
+    if (range_result == RangeParseResult::Unsatisfiable) {
+        ::close(fd);
+        auto response = jsonError(416, "请求的区间超出文件范围",
+                                  {{"filename", filename}, {"size", file_size}});
+        response->putHeader("Content-Range", ("bytes */" + std::to_string(file_size)).c_str());
+        return response;
+    }
+    if (range_result == RangeParseResult::None) {
+        range = ByteRange{0, file_size};
+    }
+
+    const bool partial = range_result == RangeParseResult::Partial;
+    auto body = std::make_shared<FileRangeBody>(fd, range.start, range.length);
+    auto response = OutgoingResponse::createShared(partial ? Status::CODE_206 : Status::CODE_200, body);
+    response->putHeader("Content-Type", "application/octet-stream");
+    response->putHeader("Accept-Ranges", "bytes");
+    if (partial) {
+        const std::string content_range = "bytes " + std::to_string(range.start) + "-" +
+            std::to_string(range.start + range.length - 1) + "/" + std::to_string(file_size);
+        response->putHeader("Content-Range", content_range.c_str());
+    }
+
+    MYLOG_INFO("[FileApiController] 文件下载：filename={}, 区间={}+{}, 文件大小={} 字节",
+               filename, range.start, range.length, file_size);
+    return response;
+}
+
 // ============================================================================
 // POST /v1/cache/query
 // ============================================================================
@@ -358,7 +861,8 @@ MyAPIResponsePtr FileApiController::listFiles(const oatpp::Object<my_api::dto::C
             {"name", fi.name},
             {"size", fi.size},
             {"type", fi.type},
-            {"modified_at", fi.modified_at}
+            {"modified_at", FormatModifiedAt(fi.modified_at_ms)},
+            {"hash", fi.hash}
         });
     }
 
@@ -418,7 +922,7 @@ MyAPIResponsePtr FileApiController::createFolder(
 // GET /v1/cache/info
 // ============================================================================
 
-MyAPIResponsePtr FileApiController::cacheInfo() {
+MyAPIResponsePtr FileApiController::cacheInfo(const std::shared_ptr<IncomingRequest>& request) {
     MYLOG_INFO("[FileApiController] cacheInfo 请求收到");
 
     // 获取 MyCache 实例
@@ -430,14 +934,23 @@ MyAPIResponsePtr FileApiController::cacheInfo() {
                          {{"error_code", CacheErrorCodeToString(cache_result.code)}});
     }
 
-    const auto& config = cache_result.value->GetConfig();
-    json data;
-    data["root_path"] = config.root_path;
-    data["max_file_size"] = config.max_file_size;
-    data["max_retention_seconds"] = config.max_retention_seconds;
-
-    MYLOG_INFO("[FileApiController] 缓存配置查询成功");
-    return jsonOk(data, "查询成功");
+    // 配置在 Init 后不变，按实例代号缓存
+    auto* cache = cache_result.value;
+    return cachedJsonResponse(request, "/v1/cache/info", MyCacheProvider::Generation(), [cache] {
+        const auto& config = cache->GetConfig();
+        json data;
+        data["root_path"] = config.root_path;
+        data["max_file_size"] = config.max_file_size;
+        data["max_retention_seconds"] = config.max_retention_seconds;
+        data["max_total_size"] = config.max_total_size;
+        data["eviction_policy"] = EvictionPolicyToString(config.eviction_policy);
+        data["high_watermark"] = config.high_watermark;
+        data["low_watermark"] = config.low_watermark;
+        data["dedup"] = config.dedup;
+
+        MYLOG_INFO("[FileApiController] 缓存配置查询成功");
+        return okBody(data, "查询成功").dump();
+    });
 }
 
 // ============================================================================
@@ -462,6 +975,15 @@ MyAPIResponsePtr FileApiController::cacheStatus() {
     data["status"] = CacheStatusToString(status);
     data["status_code"] = static_cast<int>(status);
 
+    auto usage = cache_result.value->GetUsage();
+    data["total_bytes"] = usage.total_bytes;
+    data["file_count"] = usage.file_count;
+    data["evicted_files"] = usage.evicted_files;
+    data["evicted_bytes"] = usage.evicted_bytes;
+    data["expired_files"] = usage.expired_files;
+    data["dedup_hits"] = usage.dedup_hits;
+    data["dedup_saved_bytes"] = usage.dedup_saved_bytes;
+
     MYLOG_INFO("[FileApiController] 缓存状态查询成功：{}", CacheStatusToString(status));
     return jsonOk(data, "查询成功");
 }
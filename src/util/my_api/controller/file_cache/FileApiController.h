@@ -7,6 +7,13 @@
  * 提供以下接口：
  *   - POST /v1/cache/upload  —— 上传文件到缓存目录
  *   - POST /v1/cache/upload-local —— 将客户端本地文件导入缓存目录
+ *   - PUT  /v1/cache/upload-stream —— 以原始请求体流式上传文件
+ *   - POST /v1/cache/upload-session        —— 创建断点续传上传会话
+ *   - PUT  /v1/cache/upload-session/chunk  —— 上传一个分片
+ *   - POST /v1/cache/upload-session/status —— 查询会话已接收字节数
+ *   - POST /v1/cache/upload-session/commit —— 提交会话，文件写入缓存
+ *   - POST /v1/cache/upload-session/abort  —— 取消会话
+ *   - GET  /v1/cache/download —— 下载文件，支持 Range 断点续传
  *   - POST /v1/cache/query   —— 查询文件是否存在及完整路径
  *   - POST /v1/cache/delete  —— 删除缓存中的文件
  *   - POST /v1/cache/list    —— 获取所有文件列表
@@ -14,7 +21,9 @@
   *   - POST /v1/cache/create-folder —— 创建子目录
  *   - GET  /v1/cache/status  —— 获取缓存运行状态
  *
- * 除 upload-local 使用 multipart/form-data 外，其余写接口使用 JSON Body，禁止路径变量。
+ * 除 upload-local 使用 multipart/form-data、upload-stream 与分片上传使用原始请求体（参数通过查询串传递）外，
+ * 其余写接口使用 JSON Body，禁止路径变量。
+ * 上传与下载均边收边写 / 边读边发，内存占用与文件大小无关。
  * 底层调用 MyCacheProvider::Get() 获取 MyCache 实例。
  */
 
@@ -78,6 +87,147 @@ public:
     ENDPOINT("POST", "/v1/cache/upload-local", uploadLocalFile,
              REQUEST(std::shared_ptr<IncomingRequest>, request));
 
+    // ====================================================================
+    // PUT /v1/cache/upload-stream —— 流式上传
+    // ====================================================================
+    ENDPOINT_INFO(uploadStream) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "以原始请求体流式上传文件";
+        info->description =
+            "请求体即文件的二进制内容（application/octet-stream），边接收边写入暂存文件，\n"
+            "接收完成后原子重命名到缓存目录；超过大小限制时立即中止并返回 413。\n"
+            "filename 通过查询参数传递，支持子目录路径。";
+        info->queryParams["filename"].description = "缓存中的目标文件名";
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_403, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_413, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("PUT", "/v1/cache/upload-stream", uploadStream,
+             QUERY(String, filename),
+             REQUEST(std::shared_ptr<IncomingRequest>, request));
+
+    // ====================================================================
+    // POST /v1/cache/upload-session —— 创建上传会话
+    // ====================================================================
+    ENDPOINT_INFO(beginUploadSession) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "创建断点续传上传会话";
+        info->description =
+            "接收 JSON Body，声明文件名与总大小，返回 upload_id。\n"
+            "之后通过 upload-session/chunk 按偏移依次上传分片，全部接收后调用 upload-session/commit。\n"
+            "会话超过 1 小时无活动会被自动清理。";
+        info->addConsumes<oatpp::Object<my_api::dto::CacheUploadSessionRequestDto>>("application/json");
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_403, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_413, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("POST", "/v1/cache/upload-session", beginUploadSession,
+             BODY_DTO(oatpp::Object<my_api::dto::CacheUploadSessionRequestDto>, requestDto));
+
+    // ====================================================================
+    // PUT /v1/cache/upload-session/chunk —— 上传分片
+    // ====================================================================
+    ENDPOINT_INFO(uploadSessionChunk) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "上传一个分片";
+        info->description =
+            "请求体为分片的二进制内容，offset 必须等于会话当前已接收字节数，否则返回 409。\n"
+            "连接中断时已写入的数据会保留，通过 upload-session/status 查询后从 received 处续传。";
+        info->queryParams["upload_id"].description = "上传会话 ID";
+        info->queryParams["offset"].description = "本分片在文件中的起始偏移";
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_404, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_409, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_413, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("PUT", "/v1/cache/upload-session/chunk", uploadSessionChunk,
+             QUERY(String, upload_id),
+             QUERY(String, offset),
+             REQUEST(std::shared_ptr<IncomingRequest>, request));
+
+    // ====================================================================
+    // POST /v1/cache/upload-session/status —— 查询上传会话
+    // ====================================================================
+    ENDPOINT_INFO(uploadSessionStatus) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "查询上传会话进度";
+        info->description =
+            "接收 JSON Body，返回会话的文件名、总大小与已接收字节数。";
+        info->addConsumes<oatpp::Object<my_api::dto::CacheUploadIdRequestDto>>("application/json");
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_404, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("POST", "/v1/cache/upload-session/status", uploadSessionStatus,
+             BODY_DTO(oatpp::Object<my_api::dto::CacheUploadIdRequestDto>, requestDto));
+
+    // ====================================================================
+    // POST /v1/cache/upload-session/commit —— 提交上传会话
+    // ====================================================================
+    ENDPOINT_INFO(commitUploadSession) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "提交上传会话";
+        info->description =
+            "接收 JSON Body，全部分片接收完成后将文件原子移动到缓存目录，\n"
+            "尚未接收完整时返回 409。";
+        info->addConsumes<oatpp::Object<my_api::dto::CacheUploadIdRequestDto>>("application/json");
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_403, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_404, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_409, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("POST", "/v1/cache/upload-session/commit", commitUploadSession,
+             BODY_DTO(oatpp::Object<my_api::dto::CacheUploadIdRequestDto>, requestDto));
+
+    // ====================================================================
+    // POST /v1/cache/upload-session/abort —— 取消上传会话
+    // ====================================================================
+    ENDPOINT_INFO(abortUploadSession) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "取消上传会话";
+        info->description =
+            "接收 JSON Body，删除会话及已接收的分片数据。";
+        info->addConsumes<oatpp::Object<my_api::dto::CacheUploadIdRequestDto>>("application/json");
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_404, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_409, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("POST", "/v1/cache/upload-session/abort", abortUploadSession,
+             BODY_DTO(oatpp::Object<my_api::dto::CacheUploadIdRequestDto>, requestDto));
+
+    // ====================================================================
+    // GET /v1/cache/download —— 下载文件
+    // ====================================================================
+    ENDPOINT_INFO(downloadFile) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "下载缓存中的文件";
+        info->description =
+            "以 application/octet-stream 返回文件内容，按固定大小的块从磁盘读取后发送。\n"
+            "支持单区间 Range 请求头（bytes=a-b / bytes=a- / bytes=-n），返回 206；\n"
+            "区间无法满足时返回 416，无法识别的 Range 按整个文件返回 200。";
+        info->queryParams["filename"].description = "缓存中的文件名";
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/octet-stream");
+        info->addResponse<oatpp::String>(Status::CODE_206, "application/octet-stream");
+        info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_404, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_416, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
+    }
+    ENDPOINT("GET", "/v1/cache/download", downloadFile,
+             QUERY(String, filename),
+             REQUEST(std::shared_ptr<IncomingRequest>, request));
+
     // ====================================================================
     // POST /v1/cache/query —— 查询文件
     // ====================================================================
@@ -122,7 +272,7 @@ public:
         info->description =
             "接收 JSON 请求体，可默认查询缓存根目录，\n"
             "也可指定缓存根目录内的子目录或绝对路径（仍需位于缓存根目录内）。\n"
-            "返回目录下所有文件的元信息，包括文件名、大小、类型、最后修改时间。";
+            "返回目录下所有文件的元信息，包括文件名、大小、类型、最后修改时间与内容哈希（经缓存写入的文件）。";
         info->addConsumes<oatpp::Object<my_api::dto::CacheListRequestDto>>("application/json");
         info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
         info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
@@ -162,11 +312,14 @@ public:
         info->summary = "获取缓存配置信息";
         info->description =
             "返回当前文件缓存模块的配置信息，\n"
-            "包括根目录路径、最大文件大小、最长保留时间等。";
+            "包括根目录路径、最大文件大小、最长保留时间等。\n"
+            "响应带 ETag，If-None-Match 命中时返回 304。";
         info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_304, "application/json");
         info->addResponse<oatpp::String>(Status::CODE_500, "application/json");
     }
-    ENDPOINT("GET", "/v1/cache/info", cacheInfo);
+    ENDPOINT("GET", "/v1/cache/info", cacheInfo,
+             REQUEST(std::shared_ptr<IncomingRequest>, request));
 
     // ====================================================================
     // GET /v1/cache/status —— 获取缓存运行状态
@@ -2,13 +2,14 @@
 
 /**
  * @file FileApiHelpers.h
- * @brief FileApiController 辅助函数（参数校验、错误码映射）
+ * @brief FileApiController 辅助函数（参数校验、错误码映射、Range 请求头解析）
  *
  * 将业务逻辑与网络传输层解耦，便于独立单元测试。
  */
 
 #include "CacheTypes.h"
 
+#include <cstdint>
 #include <string>
 #include <sstream>
 
@@ -84,8 +85,112 @@ inline int CacheErrorToHttpCode(my_cache::CacheErrorCode code) {
         case my_cache::CacheErrorCode::InvalidArgument:  return 400;
         case my_cache::CacheErrorCode::CreateDirFailed:  return 500;
         case my_cache::CacheErrorCode::FileTooLarge:     return 413;
+        case my_cache::CacheErrorCode::OffsetMismatch:   return 409;
+        case my_cache::CacheErrorCode::UploadIncomplete: return 409;
         default:                                         return 500;
     }
 }
 
+/**
+ * @brief 解析无符号十进制整数（不允许空串、符号与溢出）
+ */
+inline bool ParseUint64(const std::string& text, uint64_t& out) {
+    if (text.empty() || text.size() > 20) {
+        return false;
+    }
+    uint64_t value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        const uint64_t digit = static_cast<uint64_t>(c - '0');
+        if (value > (UINT64_MAX - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    out = value;
+    return true;
+}
+
+/**
+ * @brief 下载区间（闭区间 [start, start + length - 1]）
+ */
+struct ByteRange {
+    uint64_t start = 0;
+    uint64_t length = 0;
+};
+
+/**
+ * @brief Range 请求头解析结果
+ */
+enum class RangeParseResult {
+    None,            // 无 Range 或无法识别（多区间、非 bytes 单位、语法错误），按整个文件返回 200
+    Partial,         // 单个可满足的区间，返回 206
+    Unsatisfiable,   // 区间起点超出文件大小，返回 416
+};
+
+/**
+ * @brief 解析 HTTP Range 请求头（仅支持单个 bytes 区间）
+ *
+ * 支持的形式：
+ *   - "bytes=a-b"：第 a 到第 b 字节（b 超出文件末尾时截断）
+ *   - "bytes=a-" ：从第 a 字节到文件末尾
+ *   - "bytes=-n" ：最后 n 个字节
+ *
+ * @param header Range 请求头的值
+ * @param file_size 文件大小
+ * @param[out] range Partial 时输出区间
+ */
+inline RangeParseResult ParseRangeHeader(const std::string& header, uint64_t file_size, ByteRange& range) {
+    static const std::string kPrefix = "bytes=";
+    if (header.compare(0, kPrefix.size(), kPrefix) != 0 || header.find(',') != std::string::npos) {
+        return RangeParseResult::None;
+    }
+
+    const std::string spec = header.substr(kPrefix.size());
+    const auto dash = spec.find('-');
+    if (dash == std::string::npos) {
+        return RangeParseResult::None;
+    }
+    const std::string first = spec.substr(0, dash);
+    const std::string last = spec.substr(dash + 1);
+
+    if (first.empty()) {
+        // 后缀区间：最后 n 个字节
+        uint64_t suffix = 0;
+        if (!ParseUint64(last, suffix)) {
+            return RangeParseResult::None;
+        }
+        if (suffix == 0 || file_size == 0) {
+            return RangeParseResult::Unsatisfiable;
+        }
+        range.length = suffix < file_size ? suffix : file_size;
+        range.start = file_size - range.length;
+        return RangeParseResult::Partial;
+    }
+
+    uint64_t start = 0;
+    if (!ParseUint64(first, start)) {
+        return RangeParseResult::None;
+    }
+    uint64_t end = file_size == 0 ? 0 : file_size - 1;
+    if (!last.empty()) {
+        uint64_t parsed_end = 0;
+        if (!ParseUint64(last, parsed_end) || parsed_end < start) {
+            return RangeParseResult::None;
+        }
+        if (parsed_end < end) {
+            end = parsed_end;
+        }
+    }
+    if (start >= file_size) {
+        return RangeParseResult::Unsatisfiable;
+    }
+
+    range.start = start;
+    range.length = end - start + 1;
+    return RangeParseResult::Partial;
+}
+
 }  // namespace my_api::file_cache_api
@@ -77,4 +77,15 @@ MyAPIResponsePtr FlyControlController::getFlyControlHeartbeatData() {
                                       : "fly control heartbeat not received yet");
 }
 
+MyAPIResponsePtr FlyControlController::getFlyControlCommandStats() {
+    MYLOG_INFO("[API] FlyControl GET command stats");
+
+    auto& manager = ::fly_control::MyFlyControlManager::GetInstance();
+    nlohmann::json data;
+    data["initialized"] = manager.IsInitialized();
+    data["running"] = manager.IsRunning();
+    data["command_stats"] = manager.GetCommandStatsJson();
+    return jsonOk(data, "fly control command stats retrieved");
+}
+
 } // namespace my_api::fly_control_api
\ No newline at end of file
@@ -38,6 +38,14 @@ public:
         info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
     }
     ENDPOINT("GET", "/v1/flycontrol/getHeartbeatJsonData", getFlyControlHeartbeatData);
+
+    ENDPOINT_INFO(getFlyControlCommandStats) {
+        info->addTag(SWAGGER_TAG);
+        info->summary = "获取飞控指令应答统计";
+        info->description = "按指令类型返回发送、成功、失败、超时、重试次数，以及指令往返耗时（RTT）直方图和当前在途指令数。";
+        info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+    }
+    ENDPOINT("GET", "/v1/flycontrol/commandStats", getFlyControlCommandStats);
 };
 
 #include OATPP_CODEGEN_END(ApiController)
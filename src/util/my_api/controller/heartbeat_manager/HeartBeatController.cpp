@@ -48,18 +48,21 @@ MyAPIResponsePtr HeartBeatController::getHeartbeatData() {
 }
 
 
-MyAPIResponsePtr HeartBeatController::getHeartbeatConfig() {
+MyAPIResponsePtr HeartBeatController::getHeartbeatConfig(const std::shared_ptr<IncomingRequest>& request) {
     MYLOG_INFO("[API] Heartbeat GET Config");
 
-    nlohmann::json config = HeartbeatManager::GetInstance().GetInitConfig();
+    auto& manager = HeartbeatManager::GetInstance();
+    return cachedJsonResponse(request, "/v1/heartbeat/config", manager.GetConfigGeneration(), [this, &manager] {
+        nlohmann::json config = manager.GetInitConfig();
 
-    auto dto = my_api::dto::HeartbeatDto::createShared();
-    dto->from = "HeartbeatManager";
-    dto->timestamp = static_cast<v_int64>(std::time(nullptr));
-    dto->status = "config";
-    dto->heartbeat = config.dump();
+        auto dto = my_api::dto::HeartbeatDto::createShared();
+        dto->from = "HeartbeatManager";
+        dto->timestamp = static_cast<v_int64>(std::time(nullptr));
+        dto->status = "config";
+        dto->heartbeat = config.dump();
 
-    return createDtoResponse(Status::CODE_200, dto);
+        return std::string(*getDefaultObjectMapper()->writeToString(dto));
+    });
 }
 
 
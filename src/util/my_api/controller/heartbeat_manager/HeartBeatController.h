@@ -41,8 +41,9 @@ public:
         getHeartbeatData
     );
 
-    // 获取心跳启动参数
-    ENDPOINT("GET", "/v1/heartbeat/config", getHeartbeatConfig);
+    // 获取心跳启动参数（响应带 ETag，配置未变化时复用缓存，timestamp 为配置快照生成时间）
+    ENDPOINT("GET", "/v1/heartbeat/config", getHeartbeatConfig,
+             REQUEST(std::shared_ptr<IncomingRequest>, request));
              
 };
 
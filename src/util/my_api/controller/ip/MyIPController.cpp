@@ -139,25 +139,28 @@ MyIPController::MyAPIResponsePtr MyIPController::deleteIP(
 MyIPController::MyAPIResponsePtr MyIPController::scanDevices() {
 	MYLOG_INFO("[IP API] 收到局域网扫描请求");
 
-	auto scan_result = my_tools::MyIPTools::ScanActiveDevices();
-
-	if (!scan_result.error.empty()) {
-		MYLOG_WARN("[IP API] 扫描失败: {}", scan_result.error);
-		return jsonError(403, scan_result.error);
-	}
-
-	nlohmann::json data;
-	data["total_scanned"]    = scan_result.total_scanned;
-	data["active_count"]     = scan_result.active_count;
-	data["scan_duration_ms"] = scan_result.scan_duration_ms;
-
-	nlohmann::json ips = nlohmann::json::array();
-	for (const auto& ip : scan_result.active_ips) {
-		ips.push_back(ip);
-	}
-	data["active_ips"] = ips;
-
-	return jsonOk(data, "局域网扫描完成");
+	// 整网段扫描耗时较长，卸载到共享执行器并限时等待
+	return runBlocking("ip.scan", [this]() -> MyAPIResponsePtr {
+		auto scan_result = my_tools::MyIPTools::ScanActiveDevices();
+
+		if (!scan_result.error.empty()) {
+			MYLOG_WARN("[IP API] 扫描失败: {}", scan_result.error);
+			return jsonError(403, scan_result.error);
+		}
+
+		nlohmann::json data;
+		data["total_scanned"]    = scan_result.total_scanned;
+		data["active_count"]     = scan_result.active_count;
+		data["scan_duration_ms"] = scan_result.scan_duration_ms;
+
+		nlohmann::json ips = nlohmann::json::array();
+		for (const auto& ip : scan_result.active_ips) {
+			ips.push_back(ip);
+		}
+		data["active_ips"] = ips;
+
+		return jsonOk(data, "局域网扫描完成");
+	});
 }
 
 // ============================================================
@@ -179,26 +182,50 @@ MyIPController::MyAPIResponsePtr MyIPController::scanTargetIP(
 		return jsonError(400, "CIDR 格式非法: " + cidr + "，示例: 192.168.2.0/24");
 	}
 
-	auto scan_result = my_tools::MyIPTools::ScanTargetSubnet(cidr);
+	return runBlocking("ip.scan", [this, cidr]() -> MyAPIResponsePtr {
+		auto scan_result = my_tools::MyIPTools::ScanTargetSubnet(cidr);
 
-	if (!scan_result.error.empty()) {
-		MYLOG_WARN("[IP API] 指定网段扫描失败: {}", scan_result.error);
-		return jsonError(403, scan_result.error);
-	}
+		if (!scan_result.error.empty()) {
+			MYLOG_WARN("[IP API] 指定网段扫描失败: {}", scan_result.error);
+			return jsonError(403, scan_result.error);
+		}
 
-	nlohmann::json data;
-	data["cidr"]             = cidr;
-	data["total_scanned"]    = scan_result.total_scanned;
-	data["active_count"]     = scan_result.active_count;
-	data["scan_duration_ms"] = scan_result.scan_duration_ms;
+		nlohmann::json data;
+		data["cidr"]             = cidr;
+		data["total_scanned"]    = scan_result.total_scanned;
+		data["active_count"]     = scan_result.active_count;
+		data["scan_duration_ms"] = scan_result.scan_duration_ms;
 
-	nlohmann::json ips = nlohmann::json::array();
-	for (const auto& ip : scan_result.active_ips) {
-		ips.push_back(ip);
-	}
-	data["active_ips"] = ips;
+		nlohmann::json ips = nlohmann::json::array();
+		for (const auto& ip : scan_result.active_ips) {
+			ips.push_back(ip);
+		}
+		data["active_ips"] = ips;
 
-	return jsonOk(data, "指定网段扫描完成");
+		return jsonOk(data, "指定网段扫描完成");
+	});
+}
+
+// ============================================================
+//  GET /v1/ip/scan/progress
+// ============================================================
+
+MyIPController::MyAPIResponsePtr MyIPController::getScanProgress() {
+	auto progress = my_tools::MyIPTools::GetScanProgress();
+
+	nlohmann::json data;
+	data["running"]          = progress.running;
+	data["target"]           = progress.target;
+	data["total"]            = progress.detail.total;
+	data["probed"]           = progress.detail.probed;
+	data["replied"]          = progress.detail.replied;
+	data["pass"]             = progress.detail.pass;
+	data["packets_sent"]     = progress.detail.packets_sent;
+	data["packets_received"] = progress.detail.packets_received;
+	data["elapsed_ms"]       = progress.detail.elapsed_ms;
+	data["error"]            = progress.error;
+
+	return jsonOk(data, progress.running ? "扫描进行中" : "获取扫描进度成功");
 }
 
 // ============================================================
@@ -210,6 +237,8 @@ MyIPController::MyAPIResponsePtr MyIPController::configureScan(
 
 	int max_threads = 64;
 	int timeout_ms  = 800;
+	int rate_pps    = 10000;
+	int retries     = 1;
 
 	if (configDto->max_threads) {
 		max_threads = *configDto->max_threads;
@@ -217,6 +246,12 @@ MyIPController::MyAPIResponsePtr MyIPController::configureScan(
 	if (configDto->timeout_ms) {
 		timeout_ms = *configDto->timeout_ms;
 	}
+	if (configDto->rate_pps) {
+		rate_pps = *configDto->rate_pps;
+	}
+	if (configDto->retries) {
+		retries = *configDto->retries;
+	}
 
 	if (max_threads < 1 || max_threads > 1024) {
 		return jsonError(400, "max_threads 必须在 1-1024 范围内");
@@ -224,13 +259,21 @@ MyIPController::MyAPIResponsePtr MyIPController::configureScan(
 	if (timeout_ms < 100 || timeout_ms > 5000) {
 		return jsonError(400, "timeout_ms 必须在 100-5000 范围内");
 	}
+	if (rate_pps < 100 || rate_pps > 100000) {
+		return jsonError(400, "rate_pps 必须在 100-100000 范围内");
+	}
+	if (retries < 0 || retries > 5) {
+		return jsonError(400, "retries 必须在 0-5 范围内");
+	}
 
-	MYLOG_INFO("[IP API] 配置扫描参数: max_threads={}, timeout_ms={}", max_threads, timeout_ms);
-	my_tools::MyIPTools::InitScanner(max_threads, timeout_ms);
+	MYLOG_INFO("[IP API] 配置扫描参数: timeout_ms={}, rate_pps={}, retries={}", timeout_ms, rate_pps, retries);
+	my_tools::MyIPTools::InitScanner(max_threads, timeout_ms, rate_pps, retries);
 
 	nlohmann::json data;
 	data["max_threads"] = max_threads;
 	data["timeout_ms"]  = timeout_ms;
+	data["rate_pps"]    = rate_pps;
+	data["retries"]     = retries;
 
 	return jsonOk(data, "扫描参数配置成功");
 }
@@ -9,8 +9,9 @@
  * - GET  /v1/ip/addresses    : 获取所有 IP 地址信息
  * - POST /v1/ip/add          : 向指定网卡添加 IP（需 Root）
  * - POST /v1/ip/delete       : 从指定网卡删除 IP（需 Root）
- * - POST /v1/ip/scan         : 扫描局域网活跃设备（需 CAP_NET_RAW / Root）
+ * - GET  /v1/ip/scan         : 扫描局域网活跃设备（需 CAP_NET_RAW / Root）
  * - POST /v1/ip/scan_target_ip : 扫描指定网段活跃设备（需 CAP_NET_RAW / Root）
+ * - GET  /v1/ip/scan/progress : 查询正在进行或最近一次扫描的进度
  * - POST /v1/ip/scan/config  : 配置扫描参数
  */
 
@@ -91,6 +92,7 @@ public:
 		info->addTag(SWAGGER_TAG);
 		info->summary = "扫描局域网活跃设备";
 		info->description = "使用原生 ICMP Echo Request 扫描所有本机网段内的活跃设备。\n"
+		                    "单个 socket 按 rate_pps 发出全部请求并异步匹配应答，扫描期间可通过 /v1/ip/scan/progress 查询进度。\n"
 		                    "需要 CAP_NET_RAW 权限或 Root 权限。\n"
 		                    "返回字段：total_scanned（扫描总数）、active_count（活跃数）、\n"
 		                    "active_ips（活跃 IP 列表）、scan_duration_ms（耗时毫秒）。\n"
@@ -115,11 +117,21 @@ public:
 	ENDPOINT("POST", "/v1/ip/scan_target_ip", scanTargetIP,
 	         BODY_DTO(oatpp::Object<my_api::dto::ScanTargetRequestDto>, requestDto));
 
+	ENDPOINT_INFO(getScanProgress) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "查询扫描进度";
+		info->description = "返回正在进行或最近一次扫描的进度：running（是否进行中）、target（local 或 CIDR）、\n"
+		                    "total / probed / replied（目标数 / 已探测 / 已应答）、pass（当前重发轮次）、\n"
+		                    "packets_sent / packets_received、elapsed_ms、error。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+	}
+	ENDPOINT("GET", "/v1/ip/scan/progress", getScanProgress);
+
 	ENDPOINT_INFO(configureScan) {
 		info->addTag(SWAGGER_TAG);
 		info->summary = "配置局域网扫描参数";
-		info->description = "设置扫描器的最大并发线程数和单次 Ping 超时时间。\n"
-		                    "请求体示例：{\"max_threads\":64, \"timeout_ms\":800}";
+		info->description = "设置扫描器的应答超时、发送速率和重发轮数（max_threads 为保留字段）。\n"
+		                    "请求体示例：{\"timeout_ms\":800, \"rate_pps\":10000, \"retries\":1}";
 		info->addConsumes<oatpp::Object<my_api::dto::ScanConfigRequestDto>>("application/json");
 		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
 		info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
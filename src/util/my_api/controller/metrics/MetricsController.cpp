@@ -0,0 +1,105 @@
+#include "MetricsController.h"
+
+#include "MyLog.h"
+#include "MySystemHealthyManager.h"
+
+#include <string>
+
+namespace my_api::metrics_api {
+
+using namespace my_api::base;
+using MySystemHealthy::MySystemHealthyManager;
+
+namespace {
+
+/**
+ * @brief 读取整数查询参数，缺省时保持 out 不变
+ * @return 参数存在但不是整数时返回 false
+ */
+bool ReadInt64Param(const std::shared_ptr<oatpp::web::protocol::http::incoming::Request>& request,
+                    const char* key, int64_t& out) {
+	auto value = request->getQueryParameter(key);
+	if (!value || value->empty()) return true;
+	try {
+		size_t pos = 0;
+		int64_t v = std::stoll(*value, &pos);
+		if (pos != value->size()) return false;
+		out = v;
+	} catch (...) {
+		return false;
+	}
+	return true;
+}
+
+} // namespace
+
+MetricsController::MetricsController(const std::shared_ptr<ObjectMapper>& objectMapper)
+	: BaseApiController(objectMapper) {}
+
+std::shared_ptr<MetricsController> MetricsController::createShared(
+	const std::shared_ptr<ObjectMapper>& objectMapper) {
+	return std::make_shared<MetricsController>(objectMapper);
+}
+
+// ============================================================
+//  GET /v1/metrics/series
+// ============================================================
+
+MetricsController::MyAPIResponsePtr MetricsController::getMetricsSeries(
+	const std::shared_ptr<IncomingRequest>& request) {
+	std::string pattern = "*";
+	auto name_param = request->getQueryParameter("name");
+	if (name_param && !name_param->empty()) pattern = *name_param;
+
+	nlohmann::json data;
+	data["series"] = MySystemHealthyManager::GetInstance().Metrics().ListSeries(pattern);
+	data["count"] = data["series"].size();
+	return jsonOk(data, "获取时序序列列表成功");
+}
+
+// ============================================================
+//  GET /v1/metrics/query
+// ============================================================
+
+MetricsController::MyAPIResponsePtr MetricsController::queryMetrics(
+	const std::shared_ptr<IncomingRequest>& request) {
+	MySystemHealthy::MetricsQuery query;
+	auto name_param = request->getQueryParameter("name");
+	if (!name_param || name_param->empty()) {
+		return jsonError(400, "缺少参数 name");
+	}
+	query.pattern = *name_param;
+
+	int64_t step = query.step_seconds;
+	int64_t max_points = query.max_points;
+	int64_t max_series = query.max_series;
+	if (!ReadInt64Param(request, "from", query.from)) return jsonError(400, "from 必须是整数");
+	if (!ReadInt64Param(request, "to", query.to)) return jsonError(400, "to 必须是整数");
+	if (!ReadInt64Param(request, "step", step)) return jsonError(400, "step 必须是整数");
+	if (!ReadInt64Param(request, "max_points", max_points)) return jsonError(400, "max_points 必须是整数");
+	if (!ReadInt64Param(request, "max_series", max_series)) return jsonError(400, "max_series 必须是整数");
+	if (step < 0 || step > 3600) return jsonError(400, "step 只支持 1 / 10 / 60 秒");
+	if (max_points < 1 || max_points > 100000) return jsonError(400, "max_points 必须在 1-100000 范围内");
+	if (max_series < 1 || max_series > 10000) return jsonError(400, "max_series 必须在 1-10000 范围内");
+	query.step_seconds = static_cast<int>(step);
+	query.max_points = static_cast<int>(max_points);
+	query.max_series = static_cast<int>(max_series);
+
+	nlohmann::json data;
+	std::string err;
+	if (!MySystemHealthyManager::GetInstance().Metrics().Query(query, data, &err)) {
+		MYLOG_DEBUG("[Metrics API] 查询失败: {}", err);
+		return jsonError(400, err);
+	}
+	return jsonOk(data, "查询时序数据成功");
+}
+
+// ============================================================
+//  GET /v1/metrics/stats
+// ============================================================
+
+MetricsController::MyAPIResponsePtr MetricsController::getMetricsStats() {
+	return jsonOk(MySystemHealthyManager::GetInstance().Metrics().GetStatsJson(), "获取时序存储统计成功");
+}
+
+} // namespace my_api::metrics_api
@@ -0,0 +1,80 @@
+#pragma once
+
+/**
+ * @file MetricsController.h
+ * @brief 时序指标查询 REST API 控制器
+ *
+ * 数据来自 MySystemHealthyManager 内的 MetricsRingStore（1s / 10s / 1m 三档环形存储），
+ * 对外暴露以下接口：
+ * - GET /v1/metrics/series : 序列列表（名称、展示名、最新值）
+ * - GET /v1/metrics/query  : 按时间范围查询一条或一组序列的降采样结果
+ * - GET /v1/metrics/stats  : 存储配置、容量与写入统计
+ *
+ * 序列命名：
+ * - host.cpu.usage_pct / host.cpu.core.<n>.usage_pct
+ * - host.mem.used_pct / host.mem.available_bytes
+ * - host.disk.read_bytes_per_sec / host.disk.write_bytes_per_sec
+ * - host.net.recv_bytes_per_sec / host.net.transmit_bytes_per_sec
+ * - proc.<pid>.cpu_pct_core / proc.<pid>.rss_bytes / proc.<pid>.threads
+ * - thread.<tid>.cpu_pct_core
+ */
+
+#include "BaseApiController.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/web/server/api/ApiController.hpp"
+
+namespace my_api::metrics_api {
+
+#include OATPP_CODEGEN_BEGIN(ApiController)
+
+class MetricsController : public base::BaseApiController {
+public:
+	using MyAPIResponsePtr = my_api::base::MyAPIResponsePtr;
+	static constexpr const char* SWAGGER_TAG = "MetricsController";
+	explicit MetricsController(const std::shared_ptr<ObjectMapper>& objectMapper);
+
+	static std::shared_ptr<MetricsController> createShared(
+		const std::shared_ptr<ObjectMapper>& objectMapper);
+
+	ENDPOINT_INFO(getMetricsSeries) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "获取时序序列列表";
+		info->description =
+			"查询参数：\n"
+			"  name 完整序列名或以 * 结尾的前缀（如 host.cpu.*），缺省返回全部序列\n"
+			"返回每条序列的 name、label、last_ts、last_value。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+	}
+	ENDPOINT("GET", "/v1/metrics/series", getMetricsSeries,
+	         REQUEST(std::shared_ptr<IncomingRequest>, request));
+
+	ENDPOINT_INFO(queryMetrics) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "按时间范围查询时序数据";
+		info->description =
+			"查询参数：\n"
+			"  name       完整序列名或以 * 结尾的前缀（必填）\n"
+			"  from / to  unix 秒，缺省为最近 10 分钟\n"
+			"  step       1 / 10 / 60 秒，缺省按范围与 max_points 自动选择最细的可用分辨率\n"
+			"  max_points 每条序列最多返回的点数（默认 600）\n"
+			"  max_series 最多返回的序列数（默认 50）\n"
+			"返回 { from, to, step_seconds, truncated, columns, series: [ {name, label, points} ] }，"
+			"points 为按 columns（ts, avg, min, max, count）排列的数组。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+		info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+	}
+	ENDPOINT("GET", "/v1/metrics/query", queryMetrics,
+	         REQUEST(std::shared_ptr<IncomingRequest>, request));
+
+	ENDPOINT_INFO(getMetricsStats) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "获取时序存储统计";
+		info->description = "返回存储配置、序列容量与数量、写入点数、过旧丢弃点数、淘汰与拒绝的序列数。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+	}
+	ENDPOINT("GET", "/v1/metrics/stats", getMetricsStats);
+};
+
+#include OATPP_CODEGEN_END(ApiController)
+
+} // namespace my_api::metrics_api
@@ -0,0 +1,49 @@
+#include "MqttController.h"
+
+#include "MqttService.hpp"
+#include "MyLog.h"
+
+namespace my_api::mqtt_api {
+
+using namespace my_api::base;
+
+MqttController::MqttController(const std::shared_ptr<ObjectMapper>& objectMapper)
+	: BaseApiController(objectMapper) {}
+
+std::shared_ptr<MqttController> MqttController::createShared(
+	const std::shared_ptr<ObjectMapper>& objectMapper) {
+	return std::make_shared<MqttController>(objectMapper);
+}
+
+// ============================================================
+//  GET /v1/mqtt/routes
+// ============================================================
+
+MqttController::MyAPIResponsePtr MqttController::getMqttRoutes() {
+	MYLOG_DEBUG("[MQTT API] 收到获取路由统计请求");
+	auto& service = ::my_mqtt::MqttService::GetInstance();
+	nlohmann::json data;
+	data["running"] = service.IsRunning();
+	data["routes"] = service.GetRoutes();
+	return jsonOk(data, "获取 MQTT 路由成功");
+}
+
+// ============================================================
+//  GET /v1/mqtt/dispatch
+// ============================================================
+
+MqttController::MyAPIResponsePtr MqttController::getMqttDispatch() {
+	MYLOG_DEBUG("[MQTT API] 收到获取分发统计请求");
+	return jsonOk(::my_mqtt::MqttService::GetInstance().GetDispatchStats(), "获取 MQTT 分发统计成功");
+}
+
+// ============================================================
+//  GET /v1/mqtt/outbox
+// ============================================================
+
+MqttController::MyAPIResponsePtr MqttController::getMqttOutbox() {
+	MYLOG_DEBUG("[MQTT API] 收到获取出站队列统计请求");
+	return jsonOk(::my_mqtt::MqttService::GetInstance().GetOutboxStats(), "获取 MQTT 出站队列统计成功");
+}
+
+} // namespace my_api::mqtt_api
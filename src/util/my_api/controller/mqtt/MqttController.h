@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file MqttController.h
+ * @brief MQTT 通信（MqttService）REST API 控制器
+ *
+ * 对外暴露以下接口：
+ * - GET /v1/mqtt/routes   : 获取已注册路由及每条路由的处理 / 丢弃 / 耗时统计
+ * - GET /v1/mqtt/dispatch : 获取消息分发模式与各工作通道的排队统计
+ * - GET /v1/mqtt/outbox   : 获取发布出站队列的深度、合并、批量发送与离线持久化统计
+ */
+
+#include "BaseApiController.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/web/server/api/ApiController.hpp"
+
+namespace my_api::mqtt_api {
+
+#include OATPP_CODEGEN_BEGIN(ApiController)
+
+class MqttController : public base::BaseApiController {
+public:
+	using MyAPIResponsePtr = my_api::base::MyAPIResponsePtr;
+	static constexpr const char* SWAGGER_TAG = "MqttController";
+	explicit MqttController(const std::shared_ptr<ObjectMapper>& objectMapper);
+
+	static std::shared_ptr<MqttController> createShared(
+		const std::shared_ptr<ObjectMapper>& objectMapper);
+
+	ENDPOINT_INFO(getMqttRoutes) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "获取 MQTT 路由及统计";
+		info->description = "返回已注册的主题过滤器、QoS，以及每条路由的处理次数、异常数、\n"
+		                    "丢弃数、平均 / 最大排队时间和回调耗时（微秒）。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+	}
+	ENDPOINT("GET", "/v1/mqtt/routes", getMqttRoutes);
+
+	ENDPOINT_INFO(getMqttDispatch) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "获取 MQTT 消息分发统计";
+		info->description = "返回分发模式（inline / lanes）、通道数、队列容量、溢出策略，\n"
+		                    "以及各工作通道的当前深度、最大深度、处理数与丢弃数。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+	}
+	ENDPOINT("GET", "/v1/mqtt/dispatch", getMqttDispatch);
+
+	ENDPOINT_INFO(getMqttOutbox) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "获取 MQTT 发布出站队列统计";
+		info->description = "返回出站队列配置、连接状态、当前 / 最大深度、合并数、发送数与批次数，\n"
+		                    "以及溢出丢弃、离线落盘、重连回放计数和待回放字节数。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+	}
+	ENDPOINT("GET", "/v1/mqtt/outbox", getMqttOutbox);
+};
+
+#include OATPP_CODEGEN_END(ApiController)
+
+} // namespace my_api::mqtt_api
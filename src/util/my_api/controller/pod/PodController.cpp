@@ -195,10 +195,12 @@ MyAPIResponsePtr PodController::getPodDetail(const oatpp::Object<my_api::dto::Po
     return jsonOk(data, "pod detail retrieved");
 }
 
-MyAPIResponsePtr PodController::getPodConfig() {
+MyAPIResponsePtr PodController::getPodConfig(const std::shared_ptr<IncomingRequest>& request) {
     MYLOG_INFO("[API] Pod GET config");
     auto& manager = PodModule::PodManager::GetInstance();
-    return jsonOk(manager.GetInitConfig(), "pod config retrieved");
+    return cachedJsonResponse(request, "/v1/pod/config", manager.GetConfigGeneration(), [&manager] {
+        return okBody(manager.GetInitConfig(), "pod config retrieved").dump();
+    });
 }
 
 MyAPIResponsePtr PodController::getPodPtzPose(
@@ -224,24 +226,27 @@ MyAPIResponsePtr PodController::getPodPtzPose(
         return jsonError(404, error);
     }
 
-    auto result = pod->getPose();
-    if (!result.isSuccess() || !result.data.has_value()) {
-        return jsonError(
-            mapPodErrorToHttpStatus(result.code),
-            result.message.empty() ? "获取吊舱云台姿态失败" : result.message,
-            buildPodErrorDetails(result.code, pod_id));
-    }
-
-    const auto& pose = result.data.value();
-    nlohmann::json data;
-    data["pod_id"] = pod_id;
-    data["connected"] = pod->isConnected();
-    data["state"] = PodModule::podStateToString(pod->getState());
-    data["yaw"] = pose.yaw;
-    data["pitch"] = pose.pitch;
-    data["roll"] = pose.roll;
-    data["zoom"] = pose.zoom;
-    return jsonOk(data, "吊舱云台姿态获取成功");
+    // 云台查询需与设备往返通信，卸载到共享执行器并限时等待
+    return runBlocking("pod.ptz", [this, pod, pod_id]() -> MyAPIResponsePtr {
+        auto result = pod->getPose();
+        if (!result.isSuccess() || !result.data.has_value()) {
+            return jsonError(
+                mapPodErrorToHttpStatus(result.code),
+                result.message.empty() ? "获取吊舱云台姿态失败" : result.message,
+                buildPodErrorDetails(result.code, pod_id));
+        }
+
+        const auto& pose = result.data.value();
+        nlohmann::json data;
+        data["pod_id"] = pod_id;
+        data["connected"] = pod->isConnected();
+        data["state"] = PodModule::podStateToString(pod->getState());
+        data["yaw"] = pose.yaw;
+        data["pitch"] = pose.pitch;
+        data["roll"] = pose.roll;
+        data["zoom"] = pose.zoom;
+        return jsonOk(data, "吊舱云台姿态获取成功");
+    });
 }
 
 MyAPIResponsePtr PodController::connectPod(const oatpp::Object<my_api::dto::PodIdDto>& podDto) {
@@ -315,29 +320,31 @@ MyAPIResponsePtr PodController::controlPodPtz(
 
     MYLOG_INFO("[API] Pod POST ptz control: pod_id={}, action={}, step={}", pod_id, action, step);
 
-    auto result = go_home ? pod->goHome() : pod->controlSpeed(command);
-    if (!result.isSuccess()) {
-        return jsonError(
-            mapPodErrorToHttpStatus(result.code),
-            result.message.empty() ? "吊舱 PTZ 控制失败" : result.message,
-            buildPodErrorDetails(result.code, pod_id));
-    }
-
-    nlohmann::json data;
-    data["pod_id"] = pod_id;
-    data["action"] = std::string(1, action);
-    data["step"] = step;
-    data["mode"] = go_home ? "home" : "speed";
-    if (!go_home) {
-        data["command"] = {
-            {"yaw_speed", command.yaw_speed},
-            {"pitch_speed", command.pitch_speed},
-            {"zoom_speed", command.zoom_speed}
-        };
-    }
-    data["connected"] = pod->isConnected();
-    data["state"] = PodModule::podStateToString(pod->getState());
-    return jsonOk(data, go_home ? "吊舱回中指令下发成功" : "吊舱 PTZ 控制指令下发成功");
+    return runBlocking("pod.ptz", [this, pod, pod_id, step, action, command, go_home]() -> MyAPIResponsePtr {
+        auto result = go_home ? pod->goHome() : pod->controlSpeed(command);
+        if (!result.isSuccess()) {
+            return jsonError(
+                mapPodErrorToHttpStatus(result.code),
+                result.message.empty() ? "吊舱 PTZ 控制失败" : result.message,
+                buildPodErrorDetails(result.code, pod_id));
+        }
+
+        nlohmann::json data;
+        data["pod_id"] = pod_id;
+        data["action"] = std::string(1, action);
+        data["step"] = step;
+        data["mode"] = go_home ? "home" : "speed";
+        if (!go_home) {
+            data["command"] = {
+                {"yaw_speed", command.yaw_speed},
+                {"pitch_speed", command.pitch_speed},
+                {"zoom_speed", command.zoom_speed}
+            };
+        }
+        data["connected"] = pod->isConnected();
+        data["state"] = PodModule::podStateToString(pod->getState());
+        return jsonOk(data, go_home ? "吊舱回中指令下发成功" : "吊舱 PTZ 控制指令下发成功");
+    });
 }
 
 MyAPIResponsePtr PodController::listPodIds() {
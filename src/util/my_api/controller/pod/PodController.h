@@ -47,10 +47,12 @@ public:
     ENDPOINT_INFO(getPodConfig) {
         info->addTag(SWAGGER_TAG);
         info->summary = "获取吊舱模块初始化配置";
-        info->description = "返回吊舱管理器初始化时使用的 JSON 配置。";
+        info->description = "返回吊舱管理器初始化时使用的 JSON 配置。响应带 ETag，If-None-Match 命中时返回 304。";
         info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+        info->addResponse<oatpp::String>(Status::CODE_304, "application/json");
     }
-    ENDPOINT("GET", "/v1/pod/config", getPodConfig);
+    ENDPOINT("GET", "/v1/pod/config", getPodConfig,
+             REQUEST(std::shared_ptr<IncomingRequest>, request));
 
     ENDPOINT_INFO(getPodPtzPose) {
         info->addTag(SWAGGER_TAG);
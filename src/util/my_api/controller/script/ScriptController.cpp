@@ -9,6 +9,8 @@
 #include "py3/MyPyEnvBot.h"
 #include "MyLog.h"
 
+#include <algorithm>
+
 using namespace my_api::my_script_api;
 using namespace my_api::base;
 using json = nlohmann::json;
@@ -26,18 +28,21 @@ std::shared_ptr<MyScriptController> MyScriptController::createShared(const std::
 MyAPIResponsePtr MyScriptController::getCurrentPythonInfo(const std::shared_ptr<IncomingRequest>& /*request*/) {
         MYLOG_INFO("[MyScriptController] getCurrentPythonInfo called");
 
-        try {
-                json info = py3::MyPyEnvBot::getCurrentPythonInfo(5);
-                std::string body = info.dump();
-                auto resp = createResponse(Status::CODE_200, body);
-                resp->putHeader("Content-Type", "application/json");
-                return resp;
-        } catch (const std::exception& e) {
-                MYLOG_ERROR("[MyScriptController] exception: {}", e.what());
-                auto resp = createResponse(Status::CODE_500, std::string("{\"error\":\"internal\"}"));
-                resp->putHeader("Content-Type", "application/json");
-                return resp;
-        }
+        // 需要启动 python 子进程，卸载到共享执行器并限时等待
+        return runBlocking("script.info", [this]() -> MyAPIResponsePtr {
+                try {
+                        json info = py3::MyPyEnvBot::getCurrentPythonInfo(5);
+                        std::string body = info.dump();
+                        auto resp = createResponse(Status::CODE_200, body);
+                        resp->putHeader("Content-Type", "application/json");
+                        return resp;
+                } catch (const std::exception& e) {
+                        MYLOG_ERROR("[MyScriptController] exception: {}", e.what());
+                        auto resp = createResponse(Status::CODE_500, std::string("{\"error\":\"internal\"}"));
+                        resp->putHeader("Content-Type", "application/json");
+                        return resp;
+                }
+        });
 }
 
 MyAPIResponsePtr MyScriptController::runPythonScript(const oatpp::String& body) {
@@ -64,24 +69,29 @@ MyAPIResponsePtr MyScriptController::runPythonScript(const oatpp::String& body)
         //     cpu_time_limit_seconds
         // );
 
-        auto result = py3::MyPyEnvBot::runInCurrentEnv(
-            script_path,
-            args,
-            timeout_seconds,
-            memory_limit_bytes,
-            cpu_time_limit_seconds
-        );
+        // 脚本自身有 timeout_seconds 限制，等待时间至少覆盖脚本超时再留出回收子进程的余量
+        const int timeout_ms = std::max(blockingTimeoutMs("script.run"), timeout_seconds * 1000 + 5000);
+        return runBlocking("script.run", [this, script_path, args, timeout_seconds,
+                                          memory_limit_bytes, cpu_time_limit_seconds]() -> MyAPIResponsePtr {
+            auto result = py3::MyPyEnvBot::runInCurrentEnv(
+                script_path,
+                args,
+                timeout_seconds,
+                memory_limit_bytes,
+                cpu_time_limit_seconds
+            );
 
-        // 构造响应 JSON
-        json resp_json;
-        resp_json["exit_code"] = result.exit_code;
-        resp_json["timed_out"] = result.timed_out;
-        resp_json["stdout"] = result.stdout_str;
-        resp_json["stderr"] = result.stderr_str;
-        std::string resp_body = resp_json.dump();
-        auto resp = createResponse(Status::CODE_200, resp_body);
-        resp->putHeader("Content-Type", "application/json");
-        return resp;
+            // 构造响应 JSON
+            json resp_json;
+            resp_json["exit_code"] = result.exit_code;
+            resp_json["timed_out"] = result.timed_out;
+            resp_json["stdout"] = result.stdout_str;
+            resp_json["stderr"] = result.stderr_str;
+            std::string resp_body = resp_json.dump();
+            auto resp = createResponse(Status::CODE_200, resp_body);
+            resp->putHeader("Content-Type", "application/json");
+            return resp;
+        }, timeout_ms);
     } catch (const std::exception& e) {
         MYLOG_ERROR("[MyScriptController] exception: {}", e.what());
         auto resp = createResponse(Status::CODE_500, std::string("{\"error\":\"internal\"}"));
@@ -9,41 +9,19 @@ namespace my_api::soft_healthy {
 using namespace my_api::base;
 using namespace MySoftHealthy;
 
-SoftHealthyController::SoftHealthyController(const std::shared_ptr<ObjectMapper>& objectMapper)
-    : BaseApiController(objectMapper) {}
-
-std::shared_ptr<SoftHealthyController> SoftHealthyController::createShared(const std::shared_ptr<ObjectMapper>& objectMapper) {
-    return std::make_shared<SoftHealthyController>(objectMapper);
-}
-
-MyAPIResponsePtr SoftHealthyController::getSoftHealthyOnline() {
-    MYLOG_INFO("[API] SoftHealthy GET online");
-    std::string status = "{\"status\": \"alive\"}";
-    auto resp = createResponse(Status::CODE_200, status);
-    resp->putHeader("Content-Type", "application/json");
-    return resp;
-}
-
-MyAPIResponsePtr SoftHealthyController::getSoftHealthyData() {
-    MYLOG_INFO("[API] SoftHealthy GET Data");
-    auto& monitor = SoftHealthMonitorManager::getInstance();
-    auto snap = monitor.getData();
-    if (!snap) {
-        return createResponse(Status::CODE_204, "{}");
-    }
-
+nlohmann::json BuildSoftHealthDataJson(const SoftHealthSnapshot& snapshot) {
     nlohmann::json j;
     using namespace std::chrono;
-    auto uptime = duration_cast<seconds>(snap->ts.time_since_epoch()).count();
+    auto uptime = duration_cast<seconds>(snapshot.ts.time_since_epoch()).count();
     j["timestamp"] = uptime;
-    j["host"] = { {"num_cpus", snap->host.num_cpus}, {"clk_tck", snap->host.clk_tck}, {"total_cpu_jiffies", snap->host.total_cpu_jiffies} };
-    j["processes_count"] = snap->processes.size();
-    j["roots"] = snap->roots;
+    j["host"] = { {"num_cpus", snapshot.host.num_cpus}, {"clk_tck", snapshot.host.clk_tck}, {"total_cpu_jiffies", snapshot.host.total_cpu_jiffies} };
+    j["processes_count"] = snapshot.processes.size();
+    j["roots"] = snapshot.roots;
 
     // 简要返回每个进程的 pid/name/cpu，并包含 Top 线程列表（线程级别粒度）
     nlohmann::json procs = nlohmann::json::array();
     int cnt = 0;
-    for (const auto &kv : snap->processes) {
+    for (const auto &kv : snapshot.processes) {
         if (cnt++ >= 50) break; // 限制返回进程数量
         const auto &p = kv.second;
         nlohmann::json proc_j = {
@@ -73,6 +51,33 @@ MyAPIResponsePtr SoftHealthyController::getSoftHealthyData() {
         procs.push_back(proc_j);
     }
     j["processes"] = procs;
+    return j;
+}
+
+SoftHealthyController::SoftHealthyController(const std::shared_ptr<ObjectMapper>& objectMapper)
+    : BaseApiController(objectMapper) {}
+
+std::shared_ptr<SoftHealthyController> SoftHealthyController::createShared(const std::shared_ptr<ObjectMapper>& objectMapper) {
+    return std::make_shared<SoftHealthyController>(objectMapper);
+}
+
+MyAPIResponsePtr SoftHealthyController::getSoftHealthyOnline() {
+    MYLOG_INFO("[API] SoftHealthy GET online");
+    std::string status = "{\"status\": \"alive\"}";
+    auto resp = createResponse(Status::CODE_200, status);
+    resp->putHeader("Content-Type", "application/json");
+    return resp;
+}
+
+MyAPIResponsePtr SoftHealthyController::getSoftHealthyData() {
+    MYLOG_INFO("[API] SoftHealthy GET Data");
+    auto& monitor = SoftHealthMonitorManager::getInstance();
+    auto snap = monitor.getData();
+    if (!snap) {
+        return createResponse(Status::CODE_204, "{}");
+    }
+
+    nlohmann::json j = BuildSoftHealthDataJson(*snap);
 
     auto resp = createResponse(Status::CODE_200, j.dump());
     resp->putHeader("Content-Type", "application/json");
@@ -5,8 +5,17 @@
 #include "oatpp/core/macro/codegen.hpp"
 #include "oatpp/core/macro/component.hpp"
 
+#include <nlohmann/json.hpp>
+
+namespace MySoftHealthy {
+struct SoftHealthSnapshot;
+}
+
 namespace my_api::soft_healthy {
 
+// 软件健康快照转 JSON（/v1/softhealthy/getSoftHealthJsonData 与遥测推送共用）
+nlohmann::json BuildSoftHealthDataJson(const MySoftHealthy::SoftHealthSnapshot& snapshot);
+
 #include OATPP_CODEGEN_BEGIN(ApiController)
 
 class SoftHealthyController : public base::BaseApiController {
@@ -0,0 +1,226 @@
+#include "TelemetryController.h"
+
+#include "controller/soft_healthy/SoftHealthyController.h"
+#include "telemetry/TelemetryHub.h"
+
+#include "oatpp/web/protocol/http/outgoing/Body.hpp"
+
+#include "MyEdgeManager.h"
+#include "MyFlyControlManager.h"
+#include "MyLog.h"
+#include "SoftHealthMonitorManager.h"
+#include "SoftHealthSnapshot.h"
+#include "pod_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+namespace my_api::telemetry_api {
+
+using namespace my_api::base;
+using my_api::telemetry::EventPtr;
+using my_api::telemetry::TelemetryHub;
+using my_api::telemetry::TelemetrySubscription;
+
+namespace {
+
+constexpr int kDefaultMinIntervalMs = 500;
+constexpr std::chrono::milliseconds kKeepAlive{15000};
+
+std::vector<std::string> SplitTopics(const std::string& value) {
+	std::vector<std::string> topics;
+	std::stringstream ss(value);
+	std::string item;
+	while (std::getline(ss, item, ',')) {
+		item.erase(0, item.find_first_not_of(" \t"));
+		item.erase(item.find_last_not_of(" \t") + 1);
+		if (!item.empty()) {
+			topics.push_back(item);
+		}
+	}
+	return topics;
+}
+
+/**
+ * @brief SSE 响应体：阻塞等待订阅的下一批事件，长度未知（chunked 传输）
+ *
+ * 事件字符串由 TelemetryHub 生成并在订阅者间共享，这里只做拷贝。
+ * 客户端断开后写入失败，oatpp 释放响应体，订阅随之退订。
+ */
+class SseBody : public oatpp::web::protocol::http::outgoing::Body {
+public:
+	explicit SseBody(std::shared_ptr<TelemetrySubscription> subscription)
+		: subscription_(std::move(subscription)) {}
+
+	v_io_size read(void* buffer, v_buff_size count, oatpp::async::Action& action) override {
+		(void)action;
+		while (index_ >= pending_.size()) {
+			pending_.clear();
+			index_ = 0;
+			offset_ = 0;
+			if (!subscription_->WaitEvents(pending_, kKeepAlive)) {
+				return 0;   // 订阅关闭，结束响应
+			}
+		}
+
+		auto* out = static_cast<char*>(buffer);
+		v_buff_size written = 0;
+		while (written < count && index_ < pending_.size()) {
+			const std::string& event = *pending_[index_];
+			const std::size_t n = std::min<std::size_t>(event.size() - offset_,
+			                                            static_cast<std::size_t>(count - written));
+			std::copy_n(event.data() + offset_, n, out + written);
+			written += static_cast<v_buff_size>(n);
+			offset_ += n;
+			if (offset_ == event.size()) {
+				++index_;
+				offset_ = 0;
+			}
+		}
+		return written;
+	}
+
+	void declareHeaders(oatpp::web::protocol::http::Headers& headers) override {
+		(void)headers;
+	}
+
+	p_char8 getKnownData() override {
+		return nullptr;
+	}
+
+	v_int64 getKnownSize() override {
+		return -1;
+	}
+
+private:
+	std::shared_ptr<TelemetrySubscription> subscription_;
+	std::vector<EventPtr> pending_;
+	std::size_t index_ = 0;
+	std::size_t offset_ = 0;
+};
+
+nlohmann::json FlyControlHeartbeatTopic() {
+	auto& manager = ::fly_control::MyFlyControlManager::GetInstance();
+	const bool has_heartbeat = manager.HasHeartbeat();
+	nlohmann::json data;
+	data["has_heartbeat"] = has_heartbeat;
+	data["heartbeat"] = has_heartbeat ? manager.GetLatestHeartbeatJson() : nlohmann::json::object();
+	return data;
+}
+
+nlohmann::json PodStatusTopic() {
+	auto& manager = PodModule::PodManager::GetInstance();
+	if (!manager.IsInitialized()) {
+		return {{"initialized", false}};
+	}
+	return manager.GetStatusSnapshot();
+}
+
+nlohmann::json EdgeStatusTopic() {
+	auto status_map = ::my_edge::MyEdgeManager::GetInstance().GetHeartbeatInfo();
+	nlohmann::json data = nlohmann::json::object();
+	for (const auto& item : status_map.items()) {
+		data[item.key()] = {
+			{"ip", item.value().value("ip", "")},
+			{"online", item.value().value("online", false)},
+			{"biz_status", item.value().value("biz_status", "")},
+			{"thread_id", item.value().value("thread_id", "")}
+		};
+	}
+	return data;
+}
+
+nlohmann::json SoftHealthyTopic() {
+	auto snap = MySoftHealthy::SoftHealthMonitorManager::getInstance().getData();
+	if (!snap) {
+		return nlohmann::json::object();
+	}
+	return my_api::soft_healthy::BuildSoftHealthDataJson(*snap);
+}
+
+} // namespace
+
+void RegisterDefaultTelemetryTopics() {
+	auto& hub = TelemetryHub::GetInstance();
+	hub.RegisterTopic("fly_control.heartbeat", 200, FlyControlHeartbeatTopic);
+	hub.RegisterTopic("pod.status", 500, PodStatusTopic);
+	hub.RegisterTopic("edge.status", 1000, EdgeStatusTopic);
+	hub.RegisterTopic("soft_healthy", 1000, SoftHealthyTopic);
+}
+
+TelemetryController::TelemetryController(const std::shared_ptr<ObjectMapper>& objectMapper)
+	: BaseApiController(objectMapper) {
+	RegisterDefaultTelemetryTopics();
+}
+
+std::shared_ptr<TelemetryController> TelemetryController::createShared(
+	const std::shared_ptr<ObjectMapper>& objectMapper) {
+	return std::make_shared<TelemetryController>(objectMapper);
+}
+
+// ============================================================
+//  GET /v1/telemetry/topics
+// ============================================================
+
+TelemetryController::MyAPIResponsePtr TelemetryController::getTelemetryTopics() {
+	MYLOG_DEBUG("[Telemetry API] 收到获取主题列表请求");
+	auto& hub = TelemetryHub::GetInstance();
+	nlohmann::json data;
+	data["topics"] = hub.Topics();
+	data["stats"] = hub.GetStatsJson();
+	return jsonOk(data, "获取遥测主题成功");
+}
+
+// ============================================================
+//  GET /v1/telemetry/stream
+// ============================================================
+
+TelemetryController::MyAPIResponsePtr TelemetryController::streamTelemetry(
+	const std::shared_ptr<IncomingRequest>& request) {
+	auto& hub = TelemetryHub::GetInstance();
+
+	std::vector<std::string> topics;
+	auto topics_param = request->getQueryParameter("topics");
+	if (topics_param && !topics_param->empty()) {
+		topics = SplitTopics(*topics_param);
+	} else {
+		topics = hub.Topics();
+	}
+	const auto known = hub.Topics();
+	for (const auto& topic : topics) {
+		if (std::find(known.begin(), known.end(), topic) == known.end()) {
+			return jsonError(400, "未知主题: " + topic, {{"topics", known}});
+		}
+	}
+
+	int min_interval_ms = kDefaultMinIntervalMs;
+	auto interval_param = request->getQueryParameter("min_interval_ms");
+	if (interval_param && !interval_param->empty()) {
+		try {
+			min_interval_ms = std::stoi(*interval_param);
+		} catch (...) {
+			return jsonError(400, "min_interval_ms 必须是整数");
+		}
+		if (min_interval_ms < TelemetryHub::kMinIntervalMs || min_interval_ms > TelemetryHub::kMaxIntervalMs) {
+			return jsonError(400, "min_interval_ms 必须在 " + std::to_string(TelemetryHub::kMinIntervalMs) +
+			                      "-" + std::to_string(TelemetryHub::kMaxIntervalMs) + " 范围内");
+		}
+	}
+
+	std::string err;
+	auto subscription = hub.Subscribe(topics, min_interval_ms, &err);
+	if (!subscription) {
+		MYLOG_WARN("[Telemetry API] 订阅失败: {}", err);
+		return jsonError(503, err);
+	}
+
+	auto response = OutgoingResponse::createShared(Status::CODE_200, std::make_shared<SseBody>(subscription));
+	response->putHeader("Content-Type", "text/event-stream");
+	response->putHeader("Cache-Control", "no-cache");
+	response->putHeader("X-Accel-Buffering", "no");
+	response->putHeader("Connection", "close");
+	return response;
+}
+
+} // namespace my_api::telemetry_api
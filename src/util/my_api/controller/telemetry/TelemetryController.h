@@ -0,0 +1,67 @@
+#pragma once
+
+/**
+ * @file TelemetryController.h
+ * @brief 遥测推送（SSE）REST API 控制器
+ *
+ * 对外暴露以下接口：
+ * - GET /v1/telemetry/topics : 可订阅的主题列表与推送统计
+ * - GET /v1/telemetry/stream : 订阅主题，服务端以 text/event-stream 推送快照与增量
+ *
+ * 默认主题：
+ * - fly_control.heartbeat : 飞控心跳（同 /v1/flycontrol/getHeartbeatJsonData 的 data）
+ * - pod.status            : 吊舱运行状态（同 /v1/pod/status 的 data）
+ * - edge.status           : 边缘体状态，按名称索引
+ * - soft_healthy          : 软件健康快照（同 /v1/softhealthy/getSoftHealthJsonData）
+ */
+
+#include "BaseApiController.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/web/server/api/ApiController.hpp"
+
+namespace my_api::telemetry_api {
+
+/// 向 TelemetryHub 注册默认主题（重复调用无副作用）
+void RegisterDefaultTelemetryTopics();
+
+#include OATPP_CODEGEN_BEGIN(ApiController)
+
+class TelemetryController : public base::BaseApiController {
+public:
+	using MyAPIResponsePtr = my_api::base::MyAPIResponsePtr;
+	static constexpr const char* SWAGGER_TAG = "TelemetryController";
+	explicit TelemetryController(const std::shared_ptr<ObjectMapper>& objectMapper);
+
+	static std::shared_ptr<TelemetryController> createShared(
+		const std::shared_ptr<ObjectMapper>& objectMapper);
+
+	ENDPOINT_INFO(getTelemetryTopics) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "获取可订阅的遥测主题";
+		info->description = "返回主题列表，以及各主题的版本号、订阅数、是否正在采样、发布与序列化次数。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "application/json");
+	}
+	ENDPOINT("GET", "/v1/telemetry/topics", getTelemetryTopics);
+
+	ENDPOINT_INFO(streamTelemetry) {
+		info->addTag(SWAGGER_TAG);
+		info->summary = "订阅遥测推送（Server-Sent Events）";
+		info->description =
+			"查询参数：\n"
+			"  topics          逗号分隔的主题名，缺省订阅全部主题\n"
+			"  min_interval_ms 同一连接的最小推送间隔（50-60000，默认 500），间隔内的多次变化合并为最新状态\n"
+			"事件格式：event 为主题名，id 为版本号，data 为 JSON：\n"
+			"  {\"topic\":..., \"version\":N, \"type\":\"snapshot\"|\"delta\", \"data\":{...}}\n"
+			"首次及落后多个版本时推送完整快照（snapshot），其余推送 JSON Merge Patch 增量（delta，null 表示删除）。\n"
+			"无更新时每 15 秒发送一条注释行保活。";
+		info->addResponse<oatpp::String>(Status::CODE_200, "text/event-stream");
+		info->addResponse<oatpp::String>(Status::CODE_400, "application/json");
+		info->addResponse<oatpp::String>(Status::CODE_503, "application/json");
+	}
+	ENDPOINT("GET", "/v1/telemetry/stream", streamTelemetry,
+	         REQUEST(std::shared_ptr<IncomingRequest>, request));
+};
+
+#include OATPP_CODEGEN_END(ApiController)
+
+} // namespace my_api::telemetry_api
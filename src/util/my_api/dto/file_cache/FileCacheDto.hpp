@@ -58,6 +58,29 @@ class CacheCreateFolderRequestDto : public oatpp::DTO {
     DTO_FIELD(String, new_folder_name);
 };
 
+class CacheUploadSessionRequestDto : public oatpp::DTO {
+    DTO_INIT(CacheUploadSessionRequestDto, DTO)
+
+    DTO_FIELD(String, filename);
+    DTO_FIELD(UInt64, total_size);
+
+    DTO_FIELD_INFO(filename) {
+        info->description = "上传完成后保存的文件名，支持子目录路径";
+        info->required = true;
+    }
+
+    DTO_FIELD_INFO(total_size) {
+        info->description = "文件总大小（字节）";
+        info->required = true;
+    }
+};
+
+class CacheUploadIdRequestDto : public oatpp::DTO {
+    DTO_INIT(CacheUploadIdRequestDto, DTO)
+
+    DTO_FIELD(String, upload_id);
+};
+
 #include OATPP_CODEGEN_END(DTO)
 
 }  // namespace my_api::dto
\ No newline at end of file
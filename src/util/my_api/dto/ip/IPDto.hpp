@@ -44,8 +44,9 @@ class IPModifyRequestDto : public oatpp::DTO {
  *
  * 示例 JSON:
  * {
- *   "max_threads": 64,
- *   "timeout_ms": 800
+ *   "timeout_ms": 800,
+ *   "rate_pps": 10000,
+ *   "retries": 1
  * }
  */
 class ScanConfigRequestDto : public oatpp::DTO {
@@ -53,13 +54,25 @@ class ScanConfigRequestDto : public oatpp::DTO {
 
 	DTO_FIELD(Int32, max_threads);
 	DTO_FIELD_INFO(max_threads) {
-		info->description = "最大并发扫描线程数（1-1024，默认 64）";
+		info->description = "保留字段：扫描已改为单 socket 事件循环，不再按线程并发（1-1024，默认 64）";
 		info->required = false;
 	}
 
 	DTO_FIELD(Int32, timeout_ms);
 	DTO_FIELD_INFO(timeout_ms) {
-		info->description = "单个 Ping 请求超时时间（100-5000 毫秒，默认 800）";
+		info->description = "每轮请求发完后等待应答的时间（100-5000 毫秒，默认 800）";
+		info->required = false;
+	}
+
+	DTO_FIELD(Int32, rate_pps);
+	DTO_FIELD_INFO(rate_pps) {
+		info->description = "Echo Request 发送速率（100-100000 包/秒，默认 10000）";
+		info->required = false;
+	}
+
+	DTO_FIELD(Int32, retries);
+	DTO_FIELD_INFO(retries) {
+		info->description = "对未应答地址的重发轮数（0-5，默认 1）";
 		info->required = false;
 	}
 };
@@ -0,0 +1,374 @@
+#include "TelemetryHub.h"
+
+#include "MyLog.h"
+
+#include <algorithm>
+
+namespace my_api::telemetry {
+
+namespace {
+
+constexpr const char* kSubsystem = "telemetry";
+
+const EventPtr& PingEvent() {
+    static const EventPtr ping = std::make_shared<const std::string>(": ping\n\n");
+    return ping;
+}
+
+} // namespace
+
+nlohmann::json CreateMergePatch(const nlohmann::json& from, const nlohmann::json& to) {
+    if (!from.is_object() || !to.is_object()) {
+        return to;
+    }
+    nlohmann::json patch = nlohmann::json::object();
+    for (auto it = from.begin(); it != from.end(); ++it) {
+        if (!to.contains(it.key())) {
+            patch[it.key()] = nullptr;
+        }
+    }
+    for (auto it = to.begin(); it != to.end(); ++it) {
+        auto old = from.find(it.key());
+        if (old == from.end()) {
+            patch[it.key()] = it.value();
+        } else if (*old != it.value()) {
+            patch[it.key()] = CreateMergePatch(*old, it.value());
+        }
+    }
+    return patch;
+}
+
+// ============================================================================
+// TelemetrySubscription
+// ============================================================================
+
+TelemetrySubscription::TelemetrySubscription(TelemetryHub* hub, std::vector<std::string> topics,
+                                             int min_interval_ms)
+    : hub_(hub), topics_(std::move(topics)), min_interval_ms_(min_interval_ms) {
+}
+
+TelemetrySubscription::~TelemetrySubscription() {
+    Close();
+}
+
+void TelemetrySubscription::Close() {
+    hub_->Unsubscribe(this);
+}
+
+bool TelemetrySubscription::WaitEvents(std::vector<EventPtr>& out, std::chrono::milliseconds keepalive) {
+    std::unique_lock<std::mutex> lock(hub_->mu_);
+    const auto keepalive_deadline = Clock::now() + keepalive;
+
+    for (;;) {
+        if (closed_) {
+            return false;
+        }
+
+        if (dirty_) {
+            // 限速：间隔内的多次更新合并，到时只发送各主题的最新版本
+            const auto next_send = last_send_ + std::chrono::milliseconds(min_interval_ms_);
+            if (Clock::now() < next_send) {
+                cv_.wait_until(lock, next_send);
+                continue;
+            }
+            dirty_ = false;
+
+            bool any = false;
+            for (const auto& name : topics_) {
+                auto it = hub_->topics_.find(name);
+                if (it == hub_->topics_.end() || it->second.version == 0) {
+                    continue;
+                }
+                auto& topic = it->second;
+                auto& sent = sent_versions_[name];
+                if (sent == topic.version) {
+                    continue;
+                }
+                const bool consecutive = sent + 1 == topic.version && topic.delta_event;
+                out.push_back(consecutive ? topic.delta_event : hub_->FullEventLocked(topic));
+                sent = topic.version;
+                any = true;
+            }
+            if (any) {
+                last_send_ = Clock::now();
+                return true;
+            }
+            continue;
+        }
+
+        if (cv_.wait_until(lock, keepalive_deadline) == std::cv_status::timeout && !dirty_ && !closed_) {
+            out.push_back(PingEvent());
+            return true;
+        }
+    }
+}
+
+// ============================================================================
+// TelemetryHub
+// ============================================================================
+
+TelemetryHub& TelemetryHub::GetInstance() {
+    // 故意不析构：推送连接可能在进程退出阶段才释放订阅
+    static TelemetryHub* inst = new TelemetryHub();
+    return *inst;
+}
+
+TelemetryHub::~TelemetryHub() {
+    Shutdown();
+}
+
+bool TelemetryHub::RegisterTopic(const std::string& topic, int sample_period_ms, Provider provider) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (topic.empty() || topics_.count(topic) > 0) {
+        return false;
+    }
+    Topic t;
+    t.name = topic;
+    t.provider = std::move(provider);
+    t.sample_period_ms = std::max(sample_period_ms, kMinIntervalMs);
+    topics_.emplace(topic, std::move(t));
+    MYLOG_INFO("[TelemetryHub] 注册主题: {}, sample_period_ms={}", topic, sample_period_ms);
+    return true;
+}
+
+bool TelemetryHub::Publish(const std::string& topic, nlohmann::json snapshot) {
+    auto next = std::make_shared<const nlohmann::json>(std::move(snapshot));
+
+    for (;;) {
+        std::shared_ptr<const nlohmann::json> prev;
+        std::uint64_t version = 0;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            auto it = topics_.find(topic);
+            if (it == topics_.end()) {
+                return false;
+            }
+            prev = it->second.snapshot;
+            version = it->second.version;
+        }
+
+        // 比较与序列化在锁外进行，不阻塞推送线程
+        if (prev && *prev == *next) {
+            return false;
+        }
+        EventPtr delta;
+        if (prev) {
+            delta = BuildEvent(topic, version + 1, "delta", CreateMergePatch(*prev, *next));
+        }
+
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = topics_.find(topic);
+        if (it == topics_.end()) {
+            return false;
+        }
+        auto& t = it->second;
+        if (t.version != version) {
+            continue;   // 期间有其它发布者更新了该主题，基于新版本重新计算
+        }
+        t.snapshot = std::move(next);
+        t.version = version + 1;
+        t.delta_event = std::move(delta);
+        t.full_event.reset();
+        t.publishes++;
+        if (t.delta_event) {
+            t.serializations++;
+        }
+        for (auto* sub : t.subscribers) {
+            sub->dirty_ = true;
+            sub->cv_.notify_all();
+        }
+        return true;
+    }
+}
+
+std::shared_ptr<TelemetrySubscription> TelemetryHub::Subscribe(const std::vector<std::string>& topics,
+                                                               int min_interval_ms,
+                                                               std::string* err) {
+    std::vector<std::string> names;
+    for (const auto& name : topics) {
+        if (std::find(names.begin(), names.end(), name) == names.end()) {
+            names.push_back(name);
+        }
+    }
+    if (names.empty()) {
+        if (err) *err = "至少需要订阅一个主题";
+        return nullptr;
+    }
+    min_interval_ms = std::clamp(min_interval_ms, kMinIntervalMs, kMaxIntervalMs);
+
+    std::lock_guard<std::mutex> lock(mu_);
+    if (shutdown_) {
+        if (err) *err = "推送服务已停止";
+        return nullptr;
+    }
+    for (const auto& name : names) {
+        if (topics_.count(name) == 0) {
+            if (err) *err = "未知主题: " + name;
+            return nullptr;
+        }
+    }
+    if (subscriber_count_ >= max_subscribers_) {
+        if (err) *err = "订阅数已达上限 " + std::to_string(max_subscribers_);
+        return nullptr;
+    }
+
+    std::shared_ptr<TelemetrySubscription> sub(new TelemetrySubscription(this, names, min_interval_ms));
+    ++subscriber_count_;
+    for (const auto& name : names) {
+        auto& t = topics_.at(name);
+        t.subscribers.insert(sub.get());
+        // 首个订阅者到来时开始采样，立即采一次让新订阅者尽快拿到快照
+        if (t.provider && t.timer == 0) {
+            t.timer = my_executor::MyExecutor::GetInstance().ScheduleEvery(
+                kSubsystem, t.sample_period_ms, [this, name] { Sample(name); }, 0);
+        }
+    }
+    MYLOG_INFO("[TelemetryHub] 新订阅: topics={}, min_interval_ms={}, subscribers={}",
+               nlohmann::json(names).dump(), min_interval_ms, subscriber_count_);
+    return sub;
+}
+
+void TelemetryHub::Unsubscribe(TelemetrySubscription* sub) {
+    std::vector<my_executor::TimerId> timers;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (sub->closed_) {
+            return;
+        }
+        sub->closed_ = true;
+        sub->cv_.notify_all();
+        --subscriber_count_;
+        for (const auto& name : sub->topics_) {
+            auto it = topics_.find(name);
+            if (it == topics_.end()) {
+                continue;
+            }
+            auto& t = it->second;
+            t.subscribers.erase(sub);
+            // 最后一个订阅者离开时停止采样
+            if (t.subscribers.empty() && t.timer != 0) {
+                timers.push_back(t.timer);
+                t.timer = 0;
+            }
+        }
+    }
+    // 采样回调需要 mu_，释放锁后再等待正在执行的回调结束
+    for (auto id : timers) {
+        my_executor::MyExecutor::GetInstance().CancelTimer(id);
+    }
+}
+
+void TelemetryHub::SetMaxSubscribers(std::size_t max_subscribers) {
+    std::lock_guard<std::mutex> lock(mu_);
+    max_subscribers_ = max_subscribers;
+}
+
+std::vector<std::string> TelemetryHub::Topics() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    std::vector<std::string> names;
+    names.reserve(topics_.size());
+    for (const auto& [name, topic] : topics_) {
+        (void)topic;
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+nlohmann::json TelemetryHub::GetStatsJson() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    nlohmann::json j;
+    j["subscribers"] = subscriber_count_;
+    j["max_subscribers"] = max_subscribers_;
+    j["topics"] = nlohmann::json::object();
+    for (const auto& [name, t] : topics_) {
+        j["topics"][name] = {
+            {"version", t.version},
+            {"subscribers", t.subscribers.size()},
+            {"sampling", t.timer != 0},
+            {"sample_period_ms", t.sample_period_ms},
+            {"publishes", t.publishes},
+            {"serializations", t.serializations}
+        };
+    }
+    return j;
+}
+
+void TelemetryHub::Shutdown() {
+    std::vector<my_executor::TimerId> timers;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (shutdown_) {
+            return;
+        }
+        shutdown_ = true;
+        for (auto& [name, t] : topics_) {
+            (void)name;
+            for (auto* sub : t.subscribers) {
+                sub->closed_ = true;
+                sub->cv_.notify_all();
+            }
+            t.subscribers.clear();
+            if (t.timer != 0) {
+                timers.push_back(t.timer);
+                t.timer = 0;
+            }
+        }
+        subscriber_count_ = 0;
+    }
+    for (auto id : timers) {
+        my_executor::MyExecutor::GetInstance().CancelTimer(id);
+    }
+}
+
+void TelemetryHub::Sample(const std::string& topic) {
+    Provider provider;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = topics_.find(topic);
+        if (it == topics_.end() || it->second.subscribers.empty()) {
+            return;
+        }
+        provider = it->second.provider;
+    }
+    if (!provider) {
+        return;
+    }
+    try {
+        Publish(topic, provider());
+    } catch (const std::exception& e) {
+        MYLOG_WARN("[TelemetryHub] 主题 {} 采样失败: {}", topic, e.what());
+    } catch (...) {
+        MYLOG_WARN("[TelemetryHub] 主题 {} 采样失败: unknown", topic);
+    }
+}
+
+EventPtr TelemetryHub::FullEventLocked(Topic& topic) {
+    if (!topic.full_event) {
+        topic.full_event = BuildEvent(topic.name, topic.version, "snapshot", *topic.snapshot);
+        topic.serializations++;
+    }
+    return topic.full_event;
+}
+
+EventPtr TelemetryHub::BuildEvent(const std::string& topic, std::uint64_t version,
+                                  const char* type, const nlohmann::json& data) {
+    nlohmann::json payload;
+    payload["topic"] = topic;
+    payload["version"] = version;
+    payload["type"] = type;
+    payload["data"] = data;
+
+    std::string event;
+    event.reserve(64 + topic.size());
+    event += "event: ";
+    event += topic;
+    event += "\nid: ";
+    event += std::to_string(version);
+    event += "\ndata: ";
+    event += payload.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+    event += "\n\n";
+    return std::make_shared<const std::string>(std::move(event));
+}
+
+} // namespace my_api::telemetry
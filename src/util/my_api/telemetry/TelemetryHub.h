@@ -0,0 +1,168 @@
+#pragma once
+
+/**
+ * @file TelemetryHub.h
+ * @brief 遥测推送中心：按主题采样状态，变化时生成一次事件，推送给所有订阅者
+ *
+ * - 主题（topic）：名称 + 采样周期 + 取快照的函数；仅在有订阅者时通过共享执行器定时采样，
+ *   快照与上一次相同则不产生事件
+ * - 事件：快照变化时版本号 +1，生成一条 SSE 增量事件（JSON Merge Patch，RFC 7386），
+ *   完整快照事件在首次需要时生成并缓存；同一版本的事件字符串被所有订阅者共享，
+ *   N 个客户端只序列化一次
+ * - 订阅者：每个订阅者记录各主题已发送到的版本；相邻版本发送增量，落后多个版本（被合并 / 新订阅）
+ *   时发送完整快照；min_interval_ms 限制发送频率，间隔内的多次更新合并为最新状态
+ *
+ * 事件格式（text/event-stream）：
+ *   event: <topic>
+ *   id: <version>
+ *   data: {"topic":"...","version":N,"type":"snapshot"|"delta","data":{...}}
+ *
+ * 增量使用 JSON Merge Patch：对象按键递归合并，null 表示删除该键，数组整体替换。
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "MyExecutor.h"
+
+namespace my_api::telemetry {
+
+using EventPtr = std::shared_ptr<const std::string>;
+
+/// 生成从 from 变为 to 的 JSON Merge Patch（两者相同时返回空对象）
+nlohmann::json CreateMergePatch(const nlohmann::json& from, const nlohmann::json& to);
+
+class TelemetryHub;
+
+/**
+ * @brief 一个客户端的订阅，由 TelemetryHub::Subscribe 创建，析构时自动退订
+ */
+class TelemetrySubscription {
+public:
+    ~TelemetrySubscription();
+
+    TelemetrySubscription(const TelemetrySubscription&) = delete;
+    TelemetrySubscription& operator=(const TelemetrySubscription&) = delete;
+
+    /**
+     * @brief 等待下一批事件并追加到 out
+     *
+     * 有主题更新且距上次发送已满 min_interval_ms 时返回各主题最新事件；
+     * keepalive 时间内没有任何更新则返回一条 SSE 注释行，用于保活与探测断开的客户端。
+     * @return 订阅已关闭（退订或 Hub 停止）时返回 false
+     */
+    bool WaitEvents(std::vector<EventPtr>& out, std::chrono::milliseconds keepalive);
+
+    /// 关闭订阅，正在 WaitEvents 的线程立即返回 false
+    void Close();
+
+    const std::vector<std::string>& Topics() const { return topics_; }
+    int MinIntervalMs() const { return min_interval_ms_; }
+
+private:
+    friend class TelemetryHub;
+    using Clock = std::chrono::steady_clock;
+
+    TelemetrySubscription(TelemetryHub* hub, std::vector<std::string> topics, int min_interval_ms);
+
+    TelemetryHub* hub_;
+    const std::vector<std::string> topics_;
+    const int min_interval_ms_;
+
+    // 以下字段由 hub_->mu_ 保护
+    std::condition_variable cv_;
+    std::unordered_map<std::string, std::uint64_t> sent_versions_;
+    bool dirty_ = true;                 // 有主题版本尚未发送
+    bool closed_ = false;
+    Clock::time_point last_send_{};
+};
+
+class TelemetryHub {
+public:
+    using Provider = std::function<nlohmann::json()>;
+
+    static constexpr int kMinIntervalMs = 50;
+    static constexpr int kMaxIntervalMs = 60000;
+    static constexpr std::size_t kDefaultMaxSubscribers = 32;
+
+    static TelemetryHub& GetInstance();
+
+    TelemetryHub() = default;
+    ~TelemetryHub();
+
+    TelemetryHub(const TelemetryHub&) = delete;
+    TelemetryHub& operator=(const TelemetryHub&) = delete;
+
+    /**
+     * @brief 注册主题
+     * @param sample_period_ms 有订阅者时的采样周期；provider 为空时主题只接收 Publish 推送
+     * @return 主题已存在返回 false
+     */
+    bool RegisterTopic(const std::string& topic, int sample_period_ms, Provider provider);
+
+    /**
+     * @brief 发布主题的最新快照；与上一版本相同则忽略
+     * @return 产生了新版本返回 true
+     */
+    bool Publish(const std::string& topic, nlohmann::json snapshot);
+
+    /**
+     * @brief 订阅若干主题
+     * @param min_interval_ms 最小发送间隔，取值限制在 [kMinIntervalMs, kMaxIntervalMs]
+     * @return 主题不存在、订阅数已满或 Hub 已停止时返回 nullptr，并在 err 中写入原因
+     */
+    std::shared_ptr<TelemetrySubscription> Subscribe(const std::vector<std::string>& topics,
+                                                     int min_interval_ms,
+                                                     std::string* err = nullptr);
+
+    void SetMaxSubscribers(std::size_t max_subscribers);
+
+    std::vector<std::string> Topics() const;
+
+    /// 各主题版本 / 订阅数 / 发布与序列化次数，订阅总数
+    nlohmann::json GetStatsJson() const;
+
+    /// 关闭所有订阅并停止采样，之后拒绝新订阅
+    void Shutdown();
+
+private:
+    friend class TelemetrySubscription;
+
+    struct Topic {
+        std::string name;
+        Provider provider;
+        int sample_period_ms = 0;
+        my_executor::TimerId timer = 0;
+        std::uint64_t version = 0;                 // 0 表示尚无快照
+        std::shared_ptr<const nlohmann::json> snapshot;
+        EventPtr delta_event;                      // version-1 -> version 的增量
+        EventPtr full_event;                       // 按需生成，版本变化时清空
+        std::set<TelemetrySubscription*> subscribers;
+        std::uint64_t publishes = 0;
+        std::uint64_t serializations = 0;
+    };
+
+    void Unsubscribe(TelemetrySubscription* sub);
+    void Sample(const std::string& topic);
+    EventPtr FullEventLocked(Topic& topic);
+    static EventPtr BuildEvent(const std::string& topic, std::uint64_t version,
+                               const char* type, const nlohmann::json& data);
+
+    mutable std::mutex mu_;
+    std::unordered_map<std::string, Topic> topics_;
+    std::size_t subscriber_count_ = 0;
+    std::size_t max_subscribers_ = kDefaultMaxSubscribers;
+    bool shutdown_ = false;
+};
+
+} // namespace my_api::telemetry
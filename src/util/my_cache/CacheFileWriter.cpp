@@ -0,0 +1,129 @@
+/**
+ * @file CacheFileWriter.cpp
+ * @brief 流式写入缓存文件的句柄 —— 实现文件
+ */
+
+#include "CacheFileWriter.h"
+#include "MyCache.h"
+#include "MyLog.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+namespace my_cache {
+
+CacheFileWriter::CacheFileWriter(MyCache* cache, Kind kind, int fd, std::filesystem::path path,
+                                 uint64_t base, uint64_t limit, std::string upload_id,
+                                 const ContentHasher& hasher)
+    : cache_(cache),
+      kind_(kind),
+      fd_(fd),
+      path_(std::move(path)),
+      base_(base),
+      size_(base),
+      limit_(limit),
+      upload_id_(std::move(upload_id)),
+      hasher_(hasher) {
+}
+
+CacheFileWriter::~CacheFileWriter() {
+    if (done_) {
+        return;
+    }
+    if (kind_ == Kind::Staged) {
+        // 未提交的普通写入：丢弃临时文件
+        CloseFd(false);
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+        MYLOG_DEBUG("[CacheFileWriter] 未提交，丢弃临时文件：{}", path_.string());
+    } else {
+        // 分片写入被中断：保留已写入的数据，供断点续传
+        CloseFd(true);
+        cache_->OnUploadChunkClosed(upload_id_, size_, hasher_);
+    }
+}
+
+CacheErrorCode CacheFileWriter::Write(const void* data, size_t size) {
+    if (done_ || fd_ < 0) {
+        return CacheErrorCode::InvalidArgument;
+    }
+    if (error_ != CacheErrorCode::Ok) {
+        return error_;
+    }
+    if (limit_ > 0 && size_ + size > limit_) {
+        MYLOG_WARN("[CacheFileWriter] 超过大小限制：已写入={} 字节, 本次={} 字节, 限制={} 字节",
+                   size_, size, limit_);
+        error_ = CacheErrorCode::FileTooLarge;
+        return error_;
+    }
+
+    const auto* ptr = static_cast<const char*>(data);
+    size_t left = size;
+    while (left > 0) {
+        ssize_t n = ::write(fd_, ptr, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            MYLOG_ERROR("[CacheFileWriter] 写入失败：{}, 错误：{}", path_.string(), std::strerror(errno));
+            error_ = CacheErrorCode::IoError;
+            return error_;
+        }
+        ptr += n;
+        left -= static_cast<size_t>(n);
+    }
+    hasher_.Update(data, size);
+    size_ += size;
+    return CacheErrorCode::Ok;
+}
+
+CacheResult<void> CacheFileWriter::Commit(const std::string& name) {
+    if (done_ || kind_ != Kind::Staged) {
+        return CacheResult<void>::Fail(CacheErrorCode::InvalidArgument);
+    }
+    if (error_ != CacheErrorCode::Ok) {
+        return CacheResult<void>::Fail(error_);   // 析构时删除临时文件
+    }
+    if (!CloseFd(true)) {
+        return CacheResult<void>::Fail(CacheErrorCode::IoError);
+    }
+
+    done_ = true;
+    auto result = cache_->CommitStagedFile(path_, name, size_, hasher_.HexDigest());
+    if (!result.Ok()) {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+    return result;
+}
+
+CacheResult<void> CacheFileWriter::Close() {
+    if (done_ || kind_ != Kind::Chunk) {
+        return CacheResult<void>::Fail(CacheErrorCode::InvalidArgument);
+    }
+    const bool synced = CloseFd(true);
+    done_ = true;
+    cache_->OnUploadChunkClosed(upload_id_, size_, hasher_);
+    if (!synced) {
+        return CacheResult<void>::Fail(CacheErrorCode::IoError);
+    }
+    return error_ == CacheErrorCode::Ok ? CacheResult<void>::Success() : CacheResult<void>::Fail(error_);
+}
+
+bool CacheFileWriter::CloseFd(bool sync) {
+    if (fd_ < 0) {
+        return true;
+    }
+    bool ok = true;
+    if (sync && ::fdatasync(fd_) != 0) {
+        MYLOG_ERROR("[CacheFileWriter] fdatasync 失败：{}, 错误：{}", path_.string(), std::strerror(errno));
+        ok = false;
+    }
+    if (::close(fd_) != 0) {
+        ok = false;
+    }
+    fd_ = -1;
+    return ok;
+}
+
+}  // namespace my_cache
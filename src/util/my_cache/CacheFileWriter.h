@@ -0,0 +1,94 @@
+#pragma once
+
+/**
+ * @file CacheFileWriter.h
+ * @brief 流式写入缓存文件的句柄
+ *
+ * 由 MyCache::OpenWriter() / MyCache::OpenUploadChunk() 创建：
+ *   - 普通写入（OpenWriter）：数据写入暂存目录下的临时文件，Commit(name) 时 fsync + rename 到缓存目录；
+ *     未 Commit 就析构会删除临时文件
+ *   - 分片写入（OpenUploadChunk）：数据追加到上传会话的分片文件，Close() 或析构时记录已接收字节数，
+ *     断点续传从该位置继续；整个文件由 MyCache::CommitUpload() 提交
+ *
+ * 写入过程中即检查大小限制，超限时 Write 返回 FileTooLarge，调用方无需先把数据读进内存；
+ * 同时边写边计算内容哈希，提交时用于 FileInfo::hash 与按内容去重。
+ * 句柄不是线程安全的，同一时间只应由一个线程使用。
+ */
+
+#include "CacheTypes.h"
+#include "ContentHash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace my_cache {
+
+class MyCache;
+
+class CacheFileWriter {
+public:
+    ~CacheFileWriter();
+
+    CacheFileWriter(const CacheFileWriter&) = delete;
+    CacheFileWriter& operator=(const CacheFileWriter&) = delete;
+
+    /**
+     * @brief 追加写入数据
+     * @return 超过大小限制返回 FileTooLarge，写盘失败返回 IoError；出错后后续写入均返回同一错误
+     */
+    CacheErrorCode Write(const void* data, size_t size);
+
+    /// 第一次写入失败的错误码，未出错时为 Ok
+    CacheErrorCode Error() const { return error_; }
+
+    /// 文件当前总大小（分片写入时包含之前分片已接收的部分）
+    uint64_t Size() const { return size_; }
+
+    /// 本句柄写入的字节数
+    uint64_t Written() const { return size_ - base_; }
+
+    /// 已写入内容的哈希（分片写入时为文件开头到当前位置的哈希）
+    std::string Hash() const { return hasher_.HexDigest(); }
+
+    /**
+     * @brief 普通写入：fsync 后原子重命名为缓存中的 name，并更新索引
+     * @param name 文件相对路径名（提交时才做路径校验，允许先写数据后确定文件名）
+     */
+    CacheResult<void> Commit(const std::string& name);
+
+    /**
+     * @brief 分片写入：fsync 并记录上传会话的已接收字节数
+     */
+    CacheResult<void> Close();
+
+private:
+    friend class MyCache;
+
+    enum class Kind {
+        Staged,   // 普通写入
+        Chunk,    // 上传会话分片
+    };
+
+    CacheFileWriter(MyCache* cache, Kind kind, int fd, std::filesystem::path path,
+                    uint64_t base, uint64_t limit, std::string upload_id,
+                    const ContentHasher& hasher = ContentHasher());
+
+    /// 关闭文件描述符；sync 为 true 时先 fdatasync
+    bool CloseFd(bool sync);
+
+    MyCache* cache_;
+    Kind kind_;
+    int fd_;
+    std::filesystem::path path_;      // 临时文件 / 分片文件路径
+    uint64_t base_;                   // 打开时文件已有的字节数
+    uint64_t size_;                   // 当前文件大小
+    uint64_t limit_;                  // 大小上限，0 表示不限制
+    std::string upload_id_;           // 分片写入所属的上传会话
+    ContentHasher hasher_;            // 与 size_ 同步更新，只包含写入成功的数据
+    CacheErrorCode error_ = CacheErrorCode::Ok;
+    bool done_ = false;               // 已 Commit / Close
+};
+
+}  // namespace my_cache
@@ -6,7 +6,10 @@
  *
  * 包含：
  *   - CacheStatus 模块状态枚举
+ *   - EvictionPolicy 容量淘汰策略
  *   - CacheConfig 配置结构体（由 Init 的 JSON 参数解析得到）
+ *   - CacheUsage 容量占用与淘汰统计
+ *   - UploadSessionInfo 断点续传上传会话信息
  *   - FileInfo 文件元信息结构体
  *   - CacheErrorCode 错误码枚举
  *   - CacheErrorCodeToString 错误码转字符串
@@ -38,6 +41,30 @@ enum class CacheStatus {
  */
 const char* CacheStatusToString(CacheStatus status);
 
+// ============================================================================
+// 容量淘汰策略
+// ============================================================================
+
+/**
+ * @brief 总容量超过高水位时选择淘汰文件的顺序
+ */
+enum class EvictionPolicy {
+    Lru = 0,      // 最久未访问的先淘汰
+    Lfu,          // 访问次数最少的先淘汰（次数相同按最久未访问）
+    Largest,      // 最大的文件先淘汰（大小相同按最久未访问）
+};
+
+/**
+ * @brief 将淘汰策略转为字符串（"lru" / "lfu" / "largest"）
+ */
+const char* EvictionPolicyToString(EvictionPolicy policy);
+
+/**
+ * @brief 解析淘汰策略字符串
+ * @return 无法识别时返回 false，out 保持不变
+ */
+bool ParseEvictionPolicy(const std::string& text, EvictionPolicy& out);
+
 // ============================================================================
 // 配置结构体
 // ============================================================================
@@ -50,7 +77,11 @@ const char* CacheStatusToString(CacheStatus status);
  * {
  *     "root_path": "/data/cache",
  *     "max_file_size": 104857600,
- *     "max_retention_seconds": 86400
+ *     "max_retention_seconds": 86400,
+ *     "max_total_size": 4096,
+ *     "eviction_policy": "lru",
+ *     "high_watermark": 0.95,
+ *     "low_watermark": 0.85
  * }
  * @endcode
  */
@@ -58,6 +89,24 @@ struct CacheConfig {
     std::string root_path;                  ///< 缓存根目录路径（必填）
     uint64_t max_file_size = 0;             ///< 单个文件最大大小（字节），0 表示不限制
     int64_t max_retention_seconds = 0;      ///< 文件最长保留时间（秒），0 表示不限制，-1 表示永久有效
+    uint64_t max_total_size = 0;            ///< 缓存总容量上限（字节，JSON 中以 MB 为单位），0 表示不限制
+    EvictionPolicy eviction_policy = EvictionPolicy::Lru; ///< 超过容量时的淘汰策略
+    double high_watermark = 0.95;           ///< 总占用超过 max_total_size * high_watermark 时开始淘汰
+    double low_watermark = 0.85;            ///< 淘汰到 max_total_size * low_watermark 以下为止
+    bool dedup = false;                     ///< 按内容去重：相同内容的文件以硬链接共享同一份数据
+};
+
+/**
+ * @brief 缓存容量占用与淘汰/过期清理统计
+ */
+struct CacheUsage {
+    uint64_t total_bytes = 0;      ///< 索引中所有文件的总大小（字节）
+    uint64_t file_count = 0;       ///< 索引中的文件数
+    uint64_t evicted_files = 0;    ///< 因容量淘汰的文件数（累计）
+    uint64_t evicted_bytes = 0;    ///< 因容量淘汰释放的字节数（累计）
+    uint64_t expired_files = 0;    ///< 因超过保留时间清理的文件数（累计）
+    uint64_t dedup_hits = 0;       ///< 写入时内容已存在、直接复用已有数据的次数（累计）
+    uint64_t dedup_saved_bytes = 0;///< 当前因去重共享而节省的磁盘空间（字节）
 };
 
 // ============================================================================
@@ -71,7 +120,28 @@ struct FileInfo {
     std::string name;          ///< 相对路径名（如 "sub/file.txt"）
     uint64_t size = 0;         ///< 文件大小（字节）
     std::string type;          ///< 文件扩展名（如 "txt"、"bin"，无扩展名为空）
-    std::string modified_at;   ///< 最后修改时间（ISO 8601 格式，如 "2026-03-31T14:30:00"）
+    int64_t modified_at_ms = 0; ///< 最后修改时间（Unix 毫秒，0 表示未知）；展示时用 FormatModifiedAt 转字符串
+    std::string hash;          ///< 内容哈希（XXH64，16 位十六进制）；经缓存写入的文件才有，外部放入的文件为空
+};
+
+/**
+ * @brief 将 FileInfo::modified_at_ms 格式化为本地时间 ISO 8601 字符串（如 "2026-03-31T14:30:00"）
+ * @return modified_at_ms <= 0 时返回空字符串
+ */
+std::string FormatModifiedAt(int64_t modified_at_ms);
+
+// ============================================================================
+// 上传会话
+// ============================================================================
+
+/**
+ * @brief 断点续传上传会话信息
+ */
+struct UploadSessionInfo {
+    std::string upload_id;     ///< 会话 ID
+    std::string name;          ///< 完成后保存的相对路径名
+    uint64_t total_size = 0;   ///< 文件总大小（字节）
+    uint64_t received = 0;     ///< 已接收字节数，下一个分片应从此偏移开始
 };
 
 // ============================================================================
@@ -91,6 +161,8 @@ enum class CacheErrorCode {
     InvalidArgument,     // 参数非法（如文件名为空）
     CreateDirFailed,     // 创建目录失败
     FileTooLarge,        // 文件超过最大大小限制
+    OffsetMismatch,      // 分片偏移与已接收字节数不一致（或会话正被其它请求写入）
+    UploadIncomplete,    // 上传会话尚未接收完全部数据
 };
 
 /**
@@ -0,0 +1,153 @@
+/**
+ * @file ContentHash.cpp
+ * @brief 文件内容哈希（XXH64）—— 实现文件
+ *
+ * 按 XXH64 规范实现（种子为 0），输入按小端读取。
+ */
+
+#include "ContentHash.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace my_cache {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+
+inline uint64_t Rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t Read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t Read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = Rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t value) {
+    acc ^= Round(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+/// 处理若干完整的 32 字节条带，返回处理后的指针
+inline const uint8_t* ConsumeStripes(uint64_t acc[4], const uint8_t* p, const uint8_t* limit) {
+    while (p + 32 <= limit) {
+        acc[0] = Round(acc[0], Read64(p));
+        acc[1] = Round(acc[1], Read64(p + 8));
+        acc[2] = Round(acc[2], Read64(p + 16));
+        acc[3] = Round(acc[3], Read64(p + 24));
+        p += 32;
+    }
+    return p;
+}
+
+}  // namespace
+
+ContentHasher::ContentHasher()
+    : acc_{kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1} {
+}
+
+void ContentHasher::Update(const void* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    const auto* p = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = p + size;
+    total_len_ += size;
+
+    // 先补齐上次剩下的不完整条带
+    if (buffered_ > 0) {
+        const size_t take = std::min(size, sizeof(buffer_) - buffered_);
+        std::memcpy(buffer_ + buffered_, p, take);
+        buffered_ += take;
+        p += take;
+        if (buffered_ < sizeof(buffer_)) {
+            return;
+        }
+        ConsumeStripes(acc_, buffer_, buffer_ + sizeof(buffer_));
+        buffered_ = 0;
+    }
+
+    p = ConsumeStripes(acc_, p, end);
+
+    if (p < end) {
+        buffered_ = static_cast<size_t>(end - p);
+        std::memcpy(buffer_, p, buffered_);
+    }
+}
+
+uint64_t ContentHasher::Digest() const {
+    uint64_t h;
+    if (total_len_ >= 32) {
+        h = Rotl(acc_[0], 1) + Rotl(acc_[1], 7) + Rotl(acc_[2], 12) + Rotl(acc_[3], 18);
+        h = MergeRound(h, acc_[0]);
+        h = MergeRound(h, acc_[1]);
+        h = MergeRound(h, acc_[2]);
+        h = MergeRound(h, acc_[3]);
+    } else {
+        h = kPrime5;   // 种子为 0
+    }
+    h += total_len_;
+
+    const uint8_t* p = buffer_;
+    const uint8_t* const end = buffer_ + buffered_;
+    while (p + 8 <= end) {
+        h ^= Round(0, Read64(p));
+        h = Rotl(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(Read32(p)) * kPrime1;
+        h = Rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * kPrime5;
+        h = Rotl(h, 11) * kPrime1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+std::string ContentHasher::HexDigest() const {
+    return HashToHex(Digest());
+}
+
+std::string HashBytes(const void* data, size_t size) {
+    ContentHasher hasher;
+    hasher.Update(data, size);
+    return hasher.HexDigest();
+}
+
+std::string HashToHex(uint64_t hash) {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+    return buf;
+}
+
+}  // namespace my_cache
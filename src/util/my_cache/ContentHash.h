@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * @file ContentHash.h
+ * @brief 文件内容哈希（XXH64，流式计算）
+ *
+ * 用于缓存文件的完整性校验与按内容去重：写入时边写边算，不需要再读一遍文件。
+ * XXH64 不是密码学哈希，仅用于识别相同内容；去重时同时比较文件大小。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace my_cache {
+
+class ContentHasher {
+public:
+    ContentHasher();
+
+    /// 追加数据
+    void Update(const void* data, size_t size);
+
+    /// 当前已追加数据的哈希值（不改变内部状态，可继续 Update）
+    uint64_t Digest() const;
+
+    /// Digest() 的 16 位小写十六进制表示
+    std::string HexDigest() const;
+
+private:
+    uint64_t acc_[4];          // 四路累加器
+    uint8_t buffer_[32];       // 不足一个 32 字节条带的数据
+    size_t buffered_ = 0;
+    uint64_t total_len_ = 0;
+};
+
+/// 一次性计算数据的哈希（十六进制）
+std::string HashBytes(const void* data, size_t size);
+
+/// 64 位哈希值转 16 位小写十六进制
+std::string HashToHex(uint64_t hash);
+
+}  // namespace my_cache
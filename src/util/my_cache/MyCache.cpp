@@ -8,8 +8,21 @@
 
 #include <nlohmann/json.hpp>
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <fstream>
+#include <random>
+#include <tuple>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using json = nlohmann::json;
 
@@ -21,20 +34,73 @@ namespace my_cache {
 
 namespace {
 
-/// 将 filesystem::file_time_type 转为 ISO 8601 字符串
-std::string FormatFileTime(const std::filesystem::file_time_type& ftime) {
-    auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-        ftime - std::filesystem::file_time_type::clock::now()
-             + std::chrono::system_clock::now()
-    );
-    std::time_t t = std::chrono::system_clock::to_time_t(sctp);
-    std::tm tm{};
-    localtime_r(&t, &tm);
-    char buf[32];
-    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+/// 需要监听的 inotify 事件：IN_MODIFY 在同一批事件内合并，避免持续写入的文件反复 stat
+constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+                                IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR;
+
+/// SaveFile 写入时使用的临时文件后缀；这类文件只存在于写入与重命名之间，不进入索引
+constexpr char kTempSuffix[] = ".mycache-tmp";
+
+/// 暂存目录（根目录下），存放流式写入的临时文件与上传分片；不监听、不索引，Init 时清空
+constexpr char kStagingDirName[] = ".mycache-staging";
+
+/// 数据块目录（根目录下，去重模式使用），文件名为 "<hash>-<size>"，缓存文件是它们的硬链接；不监听、不索引
+constexpr char kBlobDirName[] = ".mycache-blobs";
+
+/// 数据块文件名：哈希 + 大小，大小不同的内容即使哈希碰撞也不会共享
+std::string BlobKey(const std::string& hash, uint64_t size) {
+    return hash + "-" + std::to_string(size);
+}
+
+/// 解析数据块文件名，格式不符返回 false
+bool ParseBlobKey(const std::string& key, std::string& hash, uint64_t& size) {
+    constexpr size_t kHashLen = 16;
+    if (key.size() < kHashLen + 2 || key[kHashLen] != '-' ||
+        key.find_first_not_of("0123456789abcdef") < kHashLen) {
+        return false;
+    }
+    const std::string size_text = key.substr(kHashLen + 1);
+    if (size_text.find_first_not_of("0123456789") != std::string::npos || size_text.size() > 19) {
+        return false;
+    }
+    hash = key.substr(0, kHashLen);
+    size = std::stoull(size_text);
+    return true;
+}
+
+/// 是否为内部目录（暂存目录、数据块目录）
+bool IsInternalDir(const std::string& rel_dir) {
+    return rel_dir == kStagingDirName || rel_dir == kBlobDirName;
+}
+
+/// 生成 32 位十六进制随机串，用作暂存文件名与上传会话 ID
+std::string RandomHexId() {
+    static thread_local std::mt19937_64 rng{std::random_device{}()};
+    char buf[33];
+    std::snprintf(buf, sizeof(buf), "%016llx%016llx",
+                  static_cast<unsigned long long>(rng()), static_cast<unsigned long long>(rng()));
     return buf;
 }
 
+/// 对目录做 fsync，保证 rename 持久化
+void SyncDirectory(const std::filesystem::path& dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        (void)::fsync(fd);
+        ::close(fd);
+    }
+}
+
+bool IsTempFile(const std::string& rel_name) {
+    constexpr size_t n = sizeof(kTempSuffix) - 1;
+    return rel_name.size() > n && rel_name.compare(rel_name.size() - n, n, kTempSuffix) == 0;
+}
+
+/// 拼接相对路径（根目录的相对路径为空串）
+std::string JoinRelative(const std::string& rel_dir, const char* name) {
+    return rel_dir.empty() ? std::string(name) : rel_dir + "/" + name;
+}
+
 /// 提取文件扩展名（不含 '.'），如 "txt"、"bin"，无扩展名返回空
 std::string GetFileExtension(const std::string& name) {
     auto pos = name.rfind('.');
@@ -59,14 +125,39 @@ bool IsPathInsideRoot(const std::filesystem::path& root_path,
            resolved_string.rfind(root_prefix, 0) == 0;
 }
 
-std::string ToRelativeUnixPath(const std::filesystem::path& root_path,
-                               const std::filesystem::path& target_path) {
-    std::error_code ec;
-    auto relative_path = std::filesystem::relative(target_path, root_path, ec);
-    if (ec) {
-        return target_path.filename().string();
+/// 目录遍历得到的路径都以 root 为前缀，直接截取即可，无需 filesystem::relative 的规范化开销
+std::string ToRelativeUnixPath(const std::string& root_string, const std::string& target_string) {
+    if (target_string.size() > root_string.size() &&
+        target_string.compare(0, root_string.size(), root_string) == 0) {
+        return target_string.substr(root_string.size() + 1);
     }
-    return relative_path.generic_string();
+    return target_string;
+}
+
+/// 一次 stat 得到文件大小、修改时间与 inode；非常规文件、不存在或临时文件返回 false
+bool StatFileInfo(const std::string& full_path, const std::string& rel_name, FileInfo& info,
+                  uint64_t* inode = nullptr) {
+    if (IsTempFile(rel_name)) {
+        return false;
+    }
+    struct stat st {};
+    if (::stat(full_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    info.name = rel_name;
+    info.size = static_cast<uint64_t>(st.st_size);
+    info.type = GetFileExtension(rel_name);
+    info.modified_at_ms = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000 +
+                          st.st_mtim.tv_nsec / 1000000;
+    if (inode) {
+        *inode = static_cast<uint64_t>(st.st_ino);
+    }
+    return true;
+}
+
+int64_t NowUnixMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
 }  // namespace
@@ -75,6 +166,18 @@ std::string ToRelativeUnixPath(const std::filesystem::path& root_path,
 // 状态码/错误码转字符串
 // ============================================================================
 
+std::string FormatModifiedAt(int64_t modified_at_ms) {
+    if (modified_at_ms <= 0) {
+        return "";
+    }
+    std::time_t t = static_cast<std::time_t>(modified_at_ms / 1000);
+    std::tm tm{};
+    localtime_r(&t, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+    return buf;
+}
+
 const char* CacheStatusToString(CacheStatus status) {
     switch (status) {
         case CacheStatus::NotInitialized: return "NotInitialized";
@@ -84,6 +187,22 @@ const char* CacheStatusToString(CacheStatus status) {
     }
 }
 
+const char* EvictionPolicyToString(EvictionPolicy policy) {
+    switch (policy) {
+        case EvictionPolicy::Lru:     return "lru";
+        case EvictionPolicy::Lfu:     return "lfu";
+        case EvictionPolicy::Largest: return "largest";
+        default:                      return "unknown";
+    }
+}
+
+bool ParseEvictionPolicy(const std::string& text, EvictionPolicy& out) {
+    if (text == "lru") { out = EvictionPolicy::Lru; return true; }
+    if (text == "lfu") { out = EvictionPolicy::Lfu; return true; }
+    if (text == "largest") { out = EvictionPolicy::Largest; return true; }
+    return false;
+}
+
 const char* CacheErrorCodeToString(CacheErrorCode code) {
     switch (code) {
         case CacheErrorCode::Ok:               return "Ok";
@@ -95,6 +214,8 @@ const char* CacheErrorCodeToString(CacheErrorCode code) {
         case CacheErrorCode::InvalidArgument:  return "InvalidArgument";
         case CacheErrorCode::CreateDirFailed:  return "CreateDirFailed";
         case CacheErrorCode::FileTooLarge:     return "FileTooLarge";
+        case CacheErrorCode::OffsetMismatch:   return "OffsetMismatch";
+        case CacheErrorCode::UploadIncomplete: return "UploadIncomplete";
         default:                               return "Unknown";
     }
 }
@@ -108,16 +229,20 @@ MyCache::MyCache() {
 }
 
 MyCache::~MyCache() {
-    MYLOG_INFO("[MyCache] 开始析构，停止后台扫描线程...");
+    MYLOG_INFO("[MyCache] 开始析构，停止后台监听线程...");
 
     // 通知后台线程退出
     running_.store(false);
-    cv_.notify_all();
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        (void)::write(wake_fd_, &one, sizeof(one));
+    }
 
     // 等待线程结束
     if (scan_thread_.joinable()) {
         scan_thread_.join();
     }
+    CloseWatchFds();
 
     MYLOG_INFO("[MyCache] 析构完成");
 }
@@ -160,8 +285,38 @@ CacheResult<void> MyCache::Init(const std::string& config_json) {
         config_.max_retention_seconds = jcfg["max_retention_seconds"].get<int64_t>();
     }
 
-    MYLOG_INFO("[MyCache] 配置解析完成：root_path={}, max_file_size={}, max_retention_seconds={}",
-               config_.root_path, config_.max_file_size, config_.max_retention_seconds);
+    if (jcfg.contains("max_total_size") && jcfg["max_total_size"].is_number_unsigned()) {
+        config_.max_total_size = jcfg["max_total_size"].get<uint64_t>() * 1024 * 1024; // 与 max_file_size 一致，以 MB 为单位
+    }
+    if (jcfg.contains("eviction_policy") && jcfg["eviction_policy"].is_string()) {
+        const auto policy = jcfg["eviction_policy"].get<std::string>();
+        if (!ParseEvictionPolicy(policy, config_.eviction_policy)) {
+            MYLOG_WARN("[MyCache] 未知的 eviction_policy：{}，使用默认值 {}",
+                       policy, EvictionPolicyToString(config_.eviction_policy));
+        }
+    }
+    if (jcfg.contains("high_watermark") && jcfg["high_watermark"].is_number()) {
+        config_.high_watermark = jcfg["high_watermark"].get<double>();
+    }
+    if (jcfg.contains("low_watermark") && jcfg["low_watermark"].is_number()) {
+        config_.low_watermark = jcfg["low_watermark"].get<double>();
+    }
+    if (jcfg.contains("dedup") && jcfg["dedup"].is_boolean()) {
+        config_.dedup = jcfg["dedup"].get<bool>();
+    }
+    if (!(config_.high_watermark > 0.0 && config_.high_watermark <= 1.0 &&
+          config_.low_watermark > 0.0 && config_.low_watermark <= config_.high_watermark)) {
+        MYLOG_WARN("[MyCache] 水位配置非法：high_watermark={}, low_watermark={}，使用默认值 0.95 / 0.85",
+                   config_.high_watermark, config_.low_watermark);
+        config_.high_watermark = 0.95;
+        config_.low_watermark = 0.85;
+    }
+
+    MYLOG_INFO("[MyCache] 配置解析完成：root_path={}, max_file_size={}, max_retention_seconds={}, "
+               "max_total_size={}, eviction_policy={}, watermark={}/{}, dedup={}",
+               config_.root_path, config_.max_file_size, config_.max_retention_seconds,
+               config_.max_total_size, EvictionPolicyToString(config_.eviction_policy),
+               config_.high_watermark, config_.low_watermark, config_.dedup);
 
     // 3. 对传入路径进行规范化处理
     std::error_code ec;
@@ -200,15 +355,49 @@ CacheResult<void> MyCache::Init(const std::string& config_json) {
 
     MYLOG_INFO("[MyCache] 规范化根目录：{}", root_path_.string());
 
-    // 4. 首次扫描建立索引
+    // 重建暂存目录：上次运行遗留的临时文件与上传分片已无对应会话
+    staging_path_ = root_path_ / kStagingDirName;
+    std::filesystem::remove_all(staging_path_, ec);
+    if (!std::filesystem::create_directory(staging_path_, ec) || ec) {
+        MYLOG_ERROR("[MyCache] 创建暂存目录失败：{}, 错误：{}", staging_path_.string(), ec.message());
+        status_.store(CacheStatus::Error);
+        return CacheResult<void>::Fail(CacheErrorCode::CreateDirFailed);
+    }
+
+    // 数据块目录跨重启保留（其中的数据仍被缓存文件引用）；未开启去重时也保留该名字，不对外开放
+    blobs_path_ = root_path_ / kBlobDirName;
+    if (config_.dedup) {
+        std::filesystem::create_directories(blobs_path_, ec);
+        if (ec) {
+            MYLOG_ERROR("[MyCache] 创建数据块目录失败：{}, 错误：{}", blobs_path_.string(), ec.message());
+            status_.store(CacheStatus::Error);
+            return CacheResult<void>::Fail(CacheErrorCode::CreateDirFailed);
+        }
+    }
+
+    // 4. 创建 inotify 实例（失败时退化为周期全量扫描）
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        MYLOG_ERROR("[MyCache] 创建 eventfd 失败：{}", std::strerror(errno));
+        status_.store(CacheStatus::Error);
+        return CacheResult<void>::Fail(CacheErrorCode::IoError);
+    }
+    inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        MYLOG_WARN("[MyCache] inotify 不可用（{}），退化为每 {} 秒全量扫描",
+                   std::strerror(errno), kScanIntervalSec);
+    }
+
+    // 5. 首次扫描建立索引（同时为所有目录添加监听）
     RefreshIndex();
 
-    // 5. 启动后台扫描线程
+    // 6. 启动后台监听线程
     status_.store(CacheStatus::Running);
     running_.store(true);
     scan_thread_ = std::thread(&MyCache::ScanThreadFunc, this);
 
-    MYLOG_INFO("[MyCache] 初始化完成，后台扫描线程已启动，扫描间隔 {} 秒", kScanIntervalSec);
+    MYLOG_INFO("[MyCache] 初始化完成，后台线程已启动：模式={}, 监听目录数={}",
+               inotify_fd_ >= 0 ? "inotify" : "polling", dir_watches_.size());
     return CacheResult<void>::Success();
 }
 
@@ -224,6 +413,21 @@ const CacheConfig& MyCache::GetConfig() const {
     return config_;
 }
 
+CacheUsage MyCache::GetUsage() const {
+    CacheUsage usage;
+    {
+        std::shared_lock lock(index_mutex_);
+        usage.total_bytes = total_bytes_;
+        usage.file_count = file_index_.size();
+        usage.dedup_saved_bytes = dedup_saved_bytes_;
+    }
+    usage.evicted_files = evicted_files_.load(std::memory_order_relaxed);
+    usage.evicted_bytes = evicted_bytes_.load(std::memory_order_relaxed);
+    usage.expired_files = expired_files_.load(std::memory_order_relaxed);
+    usage.dedup_hits = dedup_hits_.load(std::memory_order_relaxed);
+    return usage;
+}
+
 // ============================================================================
 // 路径穿越校验
 // ============================================================================
@@ -265,6 +469,12 @@ CacheErrorCode MyCache::ValidatePath(const std::string& name,
         return CacheErrorCode::InvalidArgument;
     }
 
+    // 暂存目录与数据块目录仅供内部使用
+    if (IsPathInsideRoot(staging_path_, resolved) || IsPathInsideRoot(blobs_path_, resolved)) {
+        MYLOG_WARN("[MyCache] 不允许操作内部目录：{}", name);
+        return CacheErrorCode::InvalidArgument;
+    }
+
     full_path = resolved;
     return CacheErrorCode::Ok;
 }
@@ -313,6 +523,11 @@ CacheErrorCode MyCache::ValidateDirectoryPath(const std::string& folder_path,
         return CacheErrorCode::InvalidArgument;
     }
 
+    if (IsPathInsideRoot(staging_path_, resolved) || IsPathInsideRoot(blobs_path_, resolved)) {
+        MYLOG_WARN("[MyCache] 不允许操作内部目录：{}", folder_path);
+        return CacheErrorCode::InvalidArgument;
+    }
+
     full_path = resolved;
     return CacheErrorCode::Ok;
 }
@@ -332,12 +547,17 @@ CacheResult<void> MyCache::SaveFile(const std::string& name,
         return CacheResult<void>::Fail(code);
     }
 
-    // 检查文件大小限制
+    // 检查文件大小限制（单文件上限，以及不能超过整个缓存的容量）
     if (config_.max_file_size > 0 && data.size() > config_.max_file_size) {
         MYLOG_WARN("[MyCache] 文件超过大小限制：name={}, 大小={} 字节, 限制={} 字节",
                    name, data.size(), config_.max_file_size);
         return CacheResult<void>::Fail(CacheErrorCode::FileTooLarge);
     }
+    if (config_.max_total_size > 0 && data.size() > config_.max_total_size) {
+        MYLOG_WARN("[MyCache] 文件超过缓存总容量：name={}, 大小={} 字节, 总容量={} 字节",
+                   name, data.size(), config_.max_total_size);
+        return CacheResult<void>::Fail(CacheErrorCode::FileTooLarge);
+    }
 
     // 确保父目录存在
     std::error_code ec;
@@ -350,9 +570,19 @@ CacheResult<void> MyCache::SaveFile(const std::string& name,
         }
     }
 
+    // 去重模式下内容已存在时只建硬链接，不再写盘
+    const std::string hash = HashBytes(data.data(), data.size());
+    const std::string blob_key = BlobKey(hash, data.size());
+    if (config_.dedup && LinkExistingBlob(blob_key, full_path)) {
+        dedup_hits_.fetch_add(1, std::memory_order_relaxed);
+        IndexSavedFile(name, full_path, data.size(), hash);
+        MYLOG_INFO("[MyCache] 内容已存在，复用已有数据：{}, 大小={} 字节, hash={}", name, data.size(), hash);
+        return CacheResult<void>::Success();
+    }
+
     // 写入文件（原子：先写临时文件再重命名）
     auto tmp_path = full_path;
-    tmp_path += ".tmp";
+    tmp_path += kTempSuffix;
 
     {
         std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
@@ -370,6 +600,10 @@ CacheResult<void> MyCache::SaveFile(const std::string& name,
         }
     }
 
+    if (config_.dedup) {
+        AdoptBlob(tmp_path, blob_key);
+    }
+
     // 重命名临时文件为目标文件
     std::filesystem::rename(tmp_path, full_path, ec);
     if (ec) {
@@ -379,19 +613,9 @@ CacheResult<void> MyCache::SaveFile(const std::string& name,
         return CacheResult<void>::Fail(CacheErrorCode::IoError);
     }
 
-    // 立即更新内存索引
-    {
-        FileInfo info;
-        info.name = name;
-        info.size = data.size();
-        info.type = GetFileExtension(name);
-        info.modified_at = FormatFileTime(std::filesystem::last_write_time(full_path, ec));
-
-        std::unique_lock lock(index_mutex_);
-        file_index_[name] = std::move(info);
-    }
+    IndexSavedFile(name, full_path, data.size(), hash);
 
-    MYLOG_INFO("[MyCache] 文件保存成功：{}, 大小={} 字节", name, data.size());
+    MYLOG_INFO("[MyCache] 文件保存成功：{}, 大小={} 字节, hash={}", name, data.size(), hash);
     return CacheResult<void>::Success();
 }
 
@@ -419,7 +643,7 @@ CacheResult<void> MyCache::DeleteFile(const std::string& name) {
     // 立即更新内存索引
     {
         std::unique_lock lock(index_mutex_);
-        file_index_.erase(name);
+        EraseEntryLocked(name);
     }
 
     MYLOG_INFO("[MyCache] 文件删除成功：{}", name);
@@ -436,6 +660,16 @@ CacheResult<std::string> MyCache::GetFullPath(const std::string& name) {
         return CacheResult<std::string>::Fail(code);
     }
 
+    // 记录访问（下载等读取场景经由此接口拿路径）
+    {
+        std::shared_lock lock(index_mutex_);
+        auto it = file_index_.find(name);
+        if (it != file_index_.end()) {
+            it->second.last_access_ms.store(NowUnixMs(), std::memory_order_relaxed);
+            it->second.hits.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
     MYLOG_DEBUG("[MyCache] GetFullPath 结果：{} -> {}", name, full_path.string());
     return CacheResult<std::string>::Success(full_path.string());
 }
@@ -450,10 +684,15 @@ CacheResult<bool> MyCache::Exists(const std::string& name) {
         return CacheResult<bool>::Fail(code, false);
     }
 
-    // O(1) 查询内存索引（使用读锁）
+    // O(1) 查询内存索引（使用读锁；访问统计为原子变量，无需写锁）
     {
         std::shared_lock lock(index_mutex_);
-        bool found = file_index_.count(name) > 0;
+        auto it = file_index_.find(name);
+        bool found = it != file_index_.end();
+        if (found) {
+            it->second.last_access_ms.store(NowUnixMs(), std::memory_order_relaxed);
+            it->second.hits.fetch_add(1, std::memory_order_relaxed);
+        }
         MYLOG_DEBUG("[MyCache] Exists 结果：{} -> {}", name, found);
         return CacheResult<bool>::Success(found);
     }
@@ -486,37 +725,20 @@ CacheResult<std::vector<FileInfo>> MyCache::GetFileList(const std::string& folde
         return CacheResult<std::vector<FileInfo>>::Fail(CacheErrorCode::InvalidArgument);
     }
 
-    std::vector<FileInfo> result;
-    for (auto it = std::filesystem::recursive_directory_iterator(target_path, ec);
-         it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
-        if (ec) {
-            MYLOG_WARN("[MyCache] 遍历目录失败：{}, 错误：{}", target_path.string(), ec.message());
-            ec.clear();
-            continue;
-        }
-
-        if (!it->is_regular_file(ec) || ec) {
-            ec.clear();
-            continue;
-        }
-
-        FileInfo info;
-        info.name = ToRelativeUnixPath(root_path_, it->path());
-        info.size = it->file_size(ec);
-        if (ec) {
-            info.size = 0;
-            ec.clear();
-        }
-        info.type = GetFileExtension(info.name);
+    // 索引由 inotify 事件实时维护，直接按目录前缀过滤，不再遍历磁盘
+    std::string prefix;
+    if (target_path != root_path_) {
+        prefix = ToRelativeUnixPath(root_path_.string(), target_path.string()) + "/";
+    }
 
-        auto ftime = it->last_write_time(ec);
-        if (!ec) {
-            info.modified_at = FormatFileTime(ftime);
-        } else {
-            ec.clear();
+    std::vector<FileInfo> result;
+    {
+        std::shared_lock lock(index_mutex_);
+        for (const auto& [name, entry] : file_index_) {
+            if (name.compare(0, prefix.size(), prefix) == 0) {
+                result.push_back(entry.info);
+            }
         }
-
-        result.push_back(std::move(info));
     }
 
     std::sort(result.begin(), result.end(), [](const FileInfo& lhs, const FileInfo& rhs) {
@@ -590,41 +812,643 @@ CacheResult<std::string> MyCache::CreateSubdirectory(const std::string& folder_p
 }
 
 // ============================================================================
-// 后台扫描线程
+// 流式写入与断点续传
+// ============================================================================
+
+CacheResult<std::unique_ptr<CacheFileWriter>> MyCache::OpenWriter() {
+    using Result = CacheResult<std::unique_ptr<CacheFileWriter>>;
+    if (status_.load() != CacheStatus::Running) {
+        return Result::Fail(CacheErrorCode::NotInitialized);
+    }
+
+    auto path = staging_path_ / (RandomHexId() + kTempSuffix);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        MYLOG_ERROR("[MyCache] 创建暂存文件失败：{}, 错误：{}", path.string(), std::strerror(errno));
+        return Result::Fail(CacheErrorCode::IoError);
+    }
+
+    // 单文件上限与总容量上限取较小者，写入时即拦截
+    uint64_t limit = config_.max_file_size;
+    if (config_.max_total_size > 0 && (limit == 0 || config_.max_total_size < limit)) {
+        limit = config_.max_total_size;
+    }
+    MYLOG_DEBUG("[MyCache] OpenWriter：暂存文件={}, 大小上限={}", path.string(), limit);
+    return Result::Success(std::unique_ptr<CacheFileWriter>(
+        new CacheFileWriter(this, CacheFileWriter::Kind::Staged, fd, std::move(path), 0, limit, "")));
+}
+
+CacheResult<UploadSessionInfo> MyCache::BeginUpload(const std::string& name, uint64_t total_size) {
+    MYLOG_INFO("[MyCache] BeginUpload 请求：name={}, total_size={}", name, total_size);
+
+    std::filesystem::path full_path;
+    auto code = ValidatePath(name, full_path);
+    if (code != CacheErrorCode::Ok) {
+        return CacheResult<UploadSessionInfo>::Fail(code);
+    }
+    if (total_size == 0) {
+        return CacheResult<UploadSessionInfo>::Fail(CacheErrorCode::InvalidArgument);
+    }
+    if ((config_.max_file_size > 0 && total_size > config_.max_file_size) ||
+        (config_.max_total_size > 0 && total_size > config_.max_total_size)) {
+        MYLOG_WARN("[MyCache] 上传文件超过大小限制：name={}, total_size={}", name, total_size);
+        return CacheResult<UploadSessionInfo>::Fail(CacheErrorCode::FileTooLarge);
+    }
+
+    UploadSession session;
+    session.info.upload_id = RandomHexId();
+    session.info.name = name;
+    session.info.total_size = total_size;
+    session.part_path = staging_path_ / (session.info.upload_id + kTempSuffix);
+    session.last_active = std::chrono::steady_clock::now();
+
+    int fd = ::open(session.part_path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        MYLOG_ERROR("[MyCache] 创建分片文件失败：{}, 错误：{}", session.part_path.string(), std::strerror(errno));
+        return CacheResult<UploadSessionInfo>::Fail(CacheErrorCode::IoError);
+    }
+    ::close(fd);
+
+    UploadSessionInfo info = session.info;
+    {
+        std::lock_guard<std::mutex> lock(uploads_mutex_);
+        uploads_.emplace(info.upload_id, std::move(session));
+    }
+    WakeScanThread();    // 使后台线程开始按周期检查会话超时
+
+    MYLOG_INFO("[MyCache] 上传会话已创建：upload_id={}, name={}", info.upload_id, name);
+    return CacheResult<UploadSessionInfo>::Success(std::move(info));
+}
+
+CacheResult<UploadSessionInfo> MyCache::GetUpload(const std::string& upload_id) {
+    std::lock_guard<std::mutex> lock(uploads_mutex_);
+    auto it = uploads_.find(upload_id);
+    if (it == uploads_.end()) {
+        return CacheResult<UploadSessionInfo>::Fail(CacheErrorCode::FileNotFound);
+    }
+    return CacheResult<UploadSessionInfo>::Success(it->second.info);
+}
+
+CacheResult<std::unique_ptr<CacheFileWriter>> MyCache::OpenUploadChunk(const std::string& upload_id,
+                                                                       uint64_t offset) {
+    using Result = CacheResult<std::unique_ptr<CacheFileWriter>>;
+
+    std::lock_guard<std::mutex> lock(uploads_mutex_);
+    auto it = uploads_.find(upload_id);
+    if (it == uploads_.end()) {
+        return Result::Fail(CacheErrorCode::FileNotFound);
+    }
+    UploadSession& session = it->second;
+    if (session.busy) {
+        MYLOG_WARN("[MyCache] 上传会话正被其它请求写入：upload_id={}", upload_id);
+        return Result::Fail(CacheErrorCode::OffsetMismatch);
+    }
+    if (offset != session.info.received) {
+        MYLOG_WARN("[MyCache] 分片偏移不一致：upload_id={}, offset={}, received={}",
+                   upload_id, offset, session.info.received);
+        return Result::Fail(CacheErrorCode::OffsetMismatch);
+    }
+
+    int fd = ::open(session.part_path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        MYLOG_ERROR("[MyCache] 打开分片文件失败：{}, 错误：{}", session.part_path.string(), std::strerror(errno));
+        return Result::Fail(CacheErrorCode::IoError);
+    }
+    // 上一个分片写到一半异常退出时，文件可能比记录的已接收字节数更长，以记录为准
+    if (::ftruncate(fd, static_cast<off_t>(offset)) != 0 ||
+        ::lseek(fd, static_cast<off_t>(offset), SEEK_SET) < 0) {
+        MYLOG_ERROR("[MyCache] 定位分片文件失败：{}, 错误：{}", session.part_path.string(), std::strerror(errno));
+        ::close(fd);
+        return Result::Fail(CacheErrorCode::IoError);
+    }
+
+    session.busy = true;
+    session.last_active = std::chrono::steady_clock::now();
+    return Result::Success(std::unique_ptr<CacheFileWriter>(
+        new CacheFileWriter(this, CacheFileWriter::Kind::Chunk, fd, session.part_path,
+                            offset, session.info.total_size, upload_id, session.hasher)));
+}
+
+void MyCache::OnUploadChunkClosed(const std::string& upload_id, uint64_t received,
+                                  const ContentHasher& hasher) {
+    std::lock_guard<std::mutex> lock(uploads_mutex_);
+    auto it = uploads_.find(upload_id);
+    if (it == uploads_.end()) {
+        return;
+    }
+    it->second.info.received = received;
+    it->second.hasher = hasher;
+    it->second.busy = false;
+    it->second.last_active = std::chrono::steady_clock::now();
+    MYLOG_DEBUG("[MyCache] 分片写入结束：upload_id={}, received={}/{}",
+                upload_id, received, it->second.info.total_size);
+}
+
+CacheResult<void> MyCache::CommitUpload(const std::string& upload_id) {
+    std::filesystem::path part_path;
+    std::string name;
+    std::string hash;
+    uint64_t total_size = 0;
+    {
+        std::lock_guard<std::mutex> lock(uploads_mutex_);
+        auto it = uploads_.find(upload_id);
+        if (it == uploads_.end()) {
+            return CacheResult<void>::Fail(CacheErrorCode::FileNotFound);
+        }
+        UploadSession& session = it->second;
+        if (session.busy) {
+            return CacheResult<void>::Fail(CacheErrorCode::OffsetMismatch);
+        }
+        if (session.info.received != session.info.total_size) {
+            MYLOG_WARN("[MyCache] 上传未完成，无法提交：upload_id={}, received={}/{}",
+                       upload_id, session.info.received, session.info.total_size);
+            return CacheResult<void>::Fail(CacheErrorCode::UploadIncomplete);
+        }
+        session.busy = true;   // 提交期间禁止其它操作
+        part_path = session.part_path;
+        name = session.info.name;
+        total_size = session.info.total_size;
+        hash = session.hasher.HexDigest();
+    }
+
+    auto result = CommitStagedFile(part_path, name, total_size, hash);
+
+    std::lock_guard<std::mutex> lock(uploads_mutex_);
+    auto it = uploads_.find(upload_id);
+    if (result.Ok()) {
+        if (it != uploads_.end()) uploads_.erase(it);
+        MYLOG_INFO("[MyCache] 上传会话已提交：upload_id={}, name={}, 大小={} 字节", upload_id, name, total_size);
+    } else if (it != uploads_.end()) {
+        it->second.busy = false;   // 保留会话，允许排除问题后重试
+    }
+    return result;
+}
+
+CacheResult<void> MyCache::AbortUpload(const std::string& upload_id) {
+    std::filesystem::path part_path;
+    {
+        std::lock_guard<std::mutex> lock(uploads_mutex_);
+        auto it = uploads_.find(upload_id);
+        if (it == uploads_.end()) {
+            return CacheResult<void>::Fail(CacheErrorCode::FileNotFound);
+        }
+        if (it->second.busy) {
+            return CacheResult<void>::Fail(CacheErrorCode::OffsetMismatch);
+        }
+        part_path = it->second.part_path;
+        uploads_.erase(it);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(part_path, ec);
+    MYLOG_INFO("[MyCache] 上传会话已放弃：upload_id={}", upload_id);
+    return CacheResult<void>::Success();
+}
+
+CacheResult<void> MyCache::CommitStagedFile(const std::filesystem::path& staged_path,
+                                            const std::string& name, uint64_t size,
+                                            const std::string& hash) {
+    std::filesystem::path full_path;
+    auto code = ValidatePath(name, full_path);
+    if (code != CacheErrorCode::Ok) {
+        MYLOG_WARN("[MyCache] 提交暂存文件路径校验失败：name={}, 错误码={}", name, CacheErrorCodeToString(code));
+        return CacheResult<void>::Fail(code);
+    }
+
+    std::error_code ec;
+    auto parent = full_path.parent_path();
+    if (!std::filesystem::exists(parent, ec)) {
+        if (!std::filesystem::create_directories(parent, ec) || ec) {
+            MYLOG_ERROR("[MyCache] 创建父目录失败：{}, 错误：{}", parent.string(), ec.message());
+            return CacheResult<void>::Fail(CacheErrorCode::CreateDirFailed);
+        }
+    }
+
+    if (config_.dedup && !hash.empty()) {
+        const std::string blob_key = BlobKey(hash, size);
+        if (LinkExistingBlob(blob_key, full_path)) {
+            std::filesystem::remove(staged_path, ec);
+            dedup_hits_.fetch_add(1, std::memory_order_relaxed);
+            IndexSavedFile(name, full_path, size, hash);
+            MYLOG_INFO("[MyCache] 内容已存在，丢弃暂存文件并复用已有数据：{}, 大小={} 字节, hash={}", name, size, hash);
+            return CacheResult<void>::Success();
+        }
+        AdoptBlob(staged_path, blob_key);
+    }
+
+    // 暂存目录与目标位于同一文件系统，rename 是原子的；数据已由 CacheFileWriter fsync
+    std::filesystem::rename(staged_path, full_path, ec);
+    if (ec) {
+        MYLOG_ERROR("[MyCache] 重命名暂存文件失败：{} -> {}, 错误：{}",
+                    staged_path.string(), full_path.string(), ec.message());
+        return CacheResult<void>::Fail(CacheErrorCode::IoError);
+    }
+    SyncDirectory(parent);
+
+    IndexSavedFile(name, full_path, size, hash);
+    MYLOG_INFO("[MyCache] 流式写入文件提交成功：{}, 大小={} 字节, hash={}", name, size, hash);
+    return CacheResult<void>::Success();
+}
+
+void MyCache::IndexSavedFile(const std::string& name, const std::filesystem::path& full_path,
+                             uint64_t size, const std::string& hash) {
+    // 立即更新内存索引（不等待 inotify 事件）
+    {
+        FileInfo info;
+        uint64_t inode = 0;
+        if (!StatFileInfo(full_path.string(), name, info, &inode)) {
+            info.name = name;
+            info.size = size;
+            info.type = GetFileExtension(name);
+            info.modified_at_ms = NowUnixMs();
+        }
+        info.hash = hash;
+
+        std::unique_lock lock(index_mutex_);
+        UpsertEntryLocked(std::move(info), inode);
+    }
+
+    // 超过高水位时交给后台线程淘汰，不阻塞当前写入
+    if (config_.max_total_size > 0) {
+        std::shared_lock lock(index_mutex_);
+        if (total_bytes_ > static_cast<uint64_t>(config_.max_total_size * config_.high_watermark)) {
+            WakeScanThread();
+        }
+    }
+}
+
+void MyCache::CleanStaleUploads() {
+    const auto deadline = std::chrono::steady_clock::now() - std::chrono::seconds(kUploadSessionTimeoutSec);
+    std::vector<std::filesystem::path> stale;
+    {
+        std::lock_guard<std::mutex> lock(uploads_mutex_);
+        for (auto it = uploads_.begin(); it != uploads_.end();) {
+            if (!it->second.busy && it->second.last_active < deadline) {
+                MYLOG_INFO("[MyCache] 上传会话超时，清理：upload_id={}, name={}, received={}/{}",
+                           it->first, it->second.info.name, it->second.info.received, it->second.info.total_size);
+                stale.push_back(it->second.part_path);
+                it = uploads_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (const auto& path : stale) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+}
+
+// ============================================================================
+// 按内容去重
+// ============================================================================
+
+bool MyCache::LinkExistingBlob(const std::string& key, const std::filesystem::path& full_path) {
+    const auto blob = blobs_path_ / key;
+    const auto tmp = staging_path_ / (RandomHexId() + kTempSuffix);
+    if (::link(blob.c_str(), tmp.c_str()) != 0) {
+        if (errno != ENOENT) {
+            MYLOG_WARN("[MyCache] 链接数据块失败：{}, 错误：{}", blob.string(), std::strerror(errno));
+        }
+        return false;
+    }
+
+    // 共享数据的修改时间刷新为当前时间，避免刚保存的文件因旧数据的时间立即过期或被优先淘汰
+    (void)::utimensat(AT_FDCWD, tmp.c_str(), nullptr, 0);
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, full_path, ec);
+    // full_path 已经是同一数据块的硬链接时 rename 什么也不做，tmp 仍然存在
+    ::unlink(tmp.c_str());
+    if (ec) {
+        MYLOG_ERROR("[MyCache] 重命名数据块链接失败：{} -> {}, 错误：{}",
+                    tmp.string(), full_path.string(), ec.message());
+        return false;
+    }
+    SyncDirectory(full_path.parent_path());
+    return true;
+}
+
+void MyCache::AdoptBlob(const std::filesystem::path& file, const std::string& key) {
+    // 共享的数据不允许原地修改，否则会同时改变所有同内容的文件
+    (void)::chmod(file.c_str(), 0444);
+    const auto blob = blobs_path_ / key;
+    if (::link(file.c_str(), blob.c_str()) != 0 && errno != EEXIST) {
+        MYLOG_WARN("[MyCache] 登记数据块失败：{}, 错误：{}", blob.string(), std::strerror(errno));
+    }
+}
+
+void MyCache::CollectOrphanBlobs() {
+    std::vector<std::string> candidates;
+    {
+        std::unique_lock lock(index_mutex_);
+        candidates.swap(orphan_blobs_);
+    }
+
+    for (const auto& key : candidates) {
+        {
+            std::shared_lock lock(index_mutex_);
+            if (blob_refs_.count(key) > 0) {
+                continue;   // 已被重新引用
+            }
+        }
+        // 只剩数据块目录中的一个链接时才删除；外部仍持有硬链接的数据保留
+        const auto blob = blobs_path_ / key;
+        struct stat st {};
+        if (::stat(blob.c_str(), &st) == 0 && st.st_nlink <= 1) {
+            ::unlink(blob.c_str());
+            MYLOG_DEBUG("[MyCache] 删除无引用的数据块：{}", key);
+        }
+    }
+}
+
+// ============================================================================
+// 后台监听线程
 // ============================================================================
 
 void MyCache::ScanThreadFunc() {
-    MYLOG_INFO("[MyCache] 后台扫描线程启动");
+    MYLOG_INFO("[MyCache] 后台监听线程启动：模式={}", inotify_fd_ >= 0 ? "inotify" : "polling");
+
+    const bool watching = inotify_fd_ >= 0;
+    const bool need_expire = config_.max_retention_seconds > 0;
+    auto has_uploads = [this]() {
+        std::lock_guard<std::mutex> lock(uploads_mutex_);
+        return !uploads_.empty();
+    };
+    auto next_periodic = std::chrono::steady_clock::now() + std::chrono::seconds(kScanIntervalSec);
+
+    // 启动时目录里可能已经超出容量
+    EnforceCapacity();
 
     while (running_.load()) {
-        // 等待指定时间或被唤醒退出
-        {
-            std::unique_lock lock(cv_mutex_);
-            cv_.wait_for(lock, std::chrono::seconds(kScanIntervalSec), [this]() {
-                return !running_.load();
-            });
+        // 有事件或到达周期任务时间才醒来；inotify 模式且无过期策略时无限等待
+        int timeout_ms = -1;
+        if (!watching || need_expire || has_uploads()) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                next_periodic - std::chrono::steady_clock::now()).count();
+            timeout_ms = static_cast<int>(std::max<int64_t>(0, left));
+        }
+
+        pollfd fds[2];
+        fds[0] = {wake_fd_, POLLIN, 0};
+        fds[1] = {inotify_fd_, POLLIN, 0};
+        int rc = ::poll(fds, watching ? 2 : 1, timeout_ms);
+        if (rc < 0 && errno != EINTR) {
+            MYLOG_ERROR("[MyCache] poll 失败：{}", std::strerror(errno));
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
 
         if (!running_.load()) {
             break;
         }
 
-        // 执行一次目录扫描
-        RefreshIndex();
+        if (rc > 0 && (fds[0].revents & POLLIN)) {
+            uint64_t counter = 0;
+            (void)::read(wake_fd_, &counter, sizeof(counter));
+        }
+
+        if (watching && rc > 0 && (fds[1].revents & POLLIN)) {
+            if (!ProcessWatchEvents()) {
+                MYLOG_WARN("[MyCache] inotify 事件队列溢出，执行一次全量扫描");
+                RefreshIndex();
+            }
+        }
+
+        if (std::chrono::steady_clock::now() >= next_periodic) {
+            if (!watching) {
+                RefreshIndex();
+            }
+            CleanExpiredFiles();
+            CleanStaleUploads();
+            next_periodic = std::chrono::steady_clock::now() + std::chrono::seconds(kScanIntervalSec);
+        }
+
+        // SaveFile 唤醒或外部写入使占用增长时检查容量（未超过高水位时只读一次总大小）
+        EnforceCapacity();
+
+        if (config_.dedup) {
+            CollectOrphanBlobs();
+        }
+    }
+
+    MYLOG_INFO("[MyCache] 后台监听线程退出");
+}
+
+bool MyCache::ProcessWatchEvents() {
+    // 同一批事件中的文件变更先合并，最后每个文件只 stat 一次
+    std::unordered_set<std::string> dirty;
+    bool overflow = false;
+
+    alignas(struct inotify_event) char buf[64 * 1024];
+    while (true) {
+        ssize_t len = ::read(inotify_fd_, buf, sizeof(buf));
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN) {
+                MYLOG_WARN("[MyCache] 读取 inotify 事件失败：{}", std::strerror(errno));
+            }
+            break;
+        }
+        if (len == 0) break;
+
+        for (char* ptr = buf; ptr < buf + len;) {
+            const auto* ev = reinterpret_cast<const struct inotify_event*>(ptr);
+            ptr += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+
+            auto wit = watch_dirs_.find(ev->wd);
+            if (wit == watch_dirs_.end()) {
+                continue;  // 已移除目录的残留事件
+            }
+            const std::string rel_dir = wit->second;
+
+            if (ev->mask & IN_IGNORED) {
+                auto dit = dir_watches_.find(rel_dir);
+                if (dit != dir_watches_.end() && dit->second == ev->wd) {
+                    dir_watches_.erase(dit);
+                }
+                watch_dirs_.erase(wit);
+                continue;
+            }
+            if (ev->mask & IN_DELETE_SELF) {
+                if (rel_dir.empty()) {
+                    MYLOG_ERROR("[MyCache] 缓存根目录被删除：{}", root_path_.string());
+                }
+                continue;
+            }
+            if (ev->len == 0) {
+                continue;
+            }
+
+            const std::string rel_name = JoinRelative(rel_dir, ev->name);
+            if (ev->mask & IN_ISDIR) {
+                if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    AddDirectory(rel_name);
+                } else if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    RemoveDirectory(rel_name);
+                }
+                continue;
+            }
+            dirty.insert(rel_name);
+        }
+    }
+
+    if (overflow) {
+        return false;
+    }
+    for (const auto& rel_name : dirty) {
+        UpdateFileEntry(rel_name);
+    }
+    if (!dirty.empty()) {
+        MYLOG_DEBUG("[MyCache] 应用 inotify 增量：{} 个文件", dirty.size());
+    }
+    return true;
+}
+
+void MyCache::AddWatch(const std::filesystem::path& dir, const std::string& rel_dir) {
+    if (inotify_fd_ < 0) {
+        return;
+    }
+    int wd = ::inotify_add_watch(inotify_fd_, dir.c_str(), kWatchMask);
+    if (wd < 0) {
+        // ENOSPC 通常是 fs.inotify.max_user_watches 不足，该目录的外部变更只能靠溢出/重启后的全量扫描发现
+        MYLOG_WARN("[MyCache] 添加目录监听失败：{}, 错误：{}", dir.string(), std::strerror(errno));
+        return;
+    }
+    watch_dirs_[wd] = rel_dir;
+    dir_watches_[rel_dir] = wd;
+}
+
+void MyCache::AddDirectory(const std::string& rel_dir) {
+    if (IsInternalDir(rel_dir)) {
+        return;
+    }
+
+    // 先监听再遍历：遍历前已存在的文件由遍历发现，之后的变更由事件发现
+    const auto dir = root_path_ / rel_dir;
+    AddWatch(dir, rel_dir);
+
+    const std::string root_string = root_path_.string();
+    std::vector<std::pair<FileInfo, uint64_t>> found;   // (元信息, inode)
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(dir, ec);
+         it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        const std::string full = it->path().string();
+        const std::string rel = ToRelativeUnixPath(root_string, full);
+        if (it->is_directory(ec) && !it->is_symlink(ec)) {
+            AddWatch(it->path(), rel);
+            continue;
+        }
+        FileInfo info;
+        uint64_t inode = 0;
+        if (StatFileInfo(full, rel, info, &inode)) {
+            found.emplace_back(std::move(info), inode);
+        }
+    }
+
+    std::unique_lock lock(index_mutex_);
+    for (auto& [info, inode] : found) {
+        UpsertEntryLocked(std::move(info), inode);
+    }
+}
+
+void MyCache::RemoveDirectory(const std::string& rel_dir) {
+    const std::string prefix = rel_dir + "/";
+
+    // 移出根目录的子目录仍然存在，需要主动取消监听；已删除的目录 rm_watch 会返回 EINVAL，忽略即可
+    for (auto it = dir_watches_.begin(); it != dir_watches_.end();) {
+        if (it->first == rel_dir || it->first.compare(0, prefix.size(), prefix) == 0) {
+            ::inotify_rm_watch(inotify_fd_, it->second);
+            watch_dirs_.erase(it->second);
+            it = dir_watches_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::unique_lock lock(index_mutex_);
+    for (auto it = file_index_.begin(); it != file_index_.end();) {
+        if (it->first.compare(0, prefix.size(), prefix) == 0) {
+            it = EraseEntryLocked(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MyCache::UpdateFileEntry(const std::string& rel_name) {
+    FileInfo info;
+    uint64_t inode = 0;
+    const bool present = StatFileInfo((root_path_ / rel_name).string(), rel_name, info, &inode);
 
-        // 清理过期文件
-        CleanExpiredFiles();
+    std::unique_lock lock(index_mutex_);
+    if (present) {
+        UpsertEntryLocked(std::move(info), inode);
+    } else {
+        EraseEntryLocked(rel_name);
     }
+}
 
-    MYLOG_INFO("[MyCache] 后台扫描线程退出");
+void MyCache::CloseWatchFds() {
+    if (inotify_fd_ >= 0) {
+        ::close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+    if (wake_fd_ >= 0) {
+        ::close(wake_fd_);
+        wake_fd_ = -1;
+    }
+    watch_dirs_.clear();
+    dir_watches_.clear();
 }
 
 void MyCache::RefreshIndex() {
-    MYLOG_DEBUG("[MyCache] 开始扫描目录：{}", root_path_.string());
+    MYLOG_DEBUG("[MyCache] 开始全量扫描目录：{}", root_path_.string());
 
-    std::unordered_map<std::string, FileInfo> new_index;
+    std::unordered_map<std::string, std::pair<FileInfo, uint64_t>> new_index;   // 相对路径 → (元信息, inode)
+    const std::string root_string = root_path_.string();
+    const std::string staging_string = staging_path_.string();
+    const std::string blobs_string = blobs_path_.string();
     std::error_code ec;
 
+    // 去重模式：由数据块目录恢复 inode → 哈希（重启后哈希不丢失），顺便删除已无缓存文件引用的数据块
+    std::unordered_map<uint64_t, std::string> blob_hashes;
+    if (config_.dedup) {
+        for (auto it = std::filesystem::directory_iterator(blobs_path_, ec);
+             !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            const std::string key = it->path().filename().string();
+            std::string hash;
+            uint64_t size = 0;
+            struct stat st {};
+            if (::stat(it->path().c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+                continue;
+            }
+            if (st.st_nlink <= 1) {
+                ::unlink(it->path().c_str());
+                MYLOG_DEBUG("[MyCache] 删除无引用的数据块：{}", key);
+                continue;
+            }
+            if (ParseBlobKey(key, hash, size) && size == static_cast<uint64_t>(st.st_size)) {
+                blob_hashes.emplace(static_cast<uint64_t>(st.st_ino), std::move(hash));
+            }
+        }
+        ec.clear();
+    }
+
+    // 重建监听表：根目录先监听，遍历时目录先于其内容出现，保证不漏掉扫描期间的变更
+    std::unordered_map<int, std::string> old_watches;
+    old_watches.swap(watch_dirs_);
+    dir_watches_.clear();
+    AddWatch(root_path_, "");
+
     // 递归遍历缓存目录下的所有常规文件
     for (auto it = std::filesystem::recursive_directory_iterator(root_path_, ec);
          it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
@@ -634,37 +1458,52 @@ void MyCache::RefreshIndex() {
             continue;
         }
 
-        if (it->is_regular_file(ec) && !ec) {
-            // 计算相对于 root_path_ 的相对路径作为索引 key
-            auto rel = std::filesystem::relative(it->path(), root_path_, ec);
-            if (ec) continue;
-
-            std::string rel_str = rel.string();
-            FileInfo info;
-            info.name = rel_str;
-            info.size = it->file_size(ec);
-            if (ec) { info.size = 0; ec.clear(); }
-            info.type = GetFileExtension(rel_str);
+        const std::string full = it->path().string();
+        if (full == staging_string || full == blobs_string) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        std::string rel = ToRelativeUnixPath(root_string, full);
+        if (it->is_directory(ec) && !it->is_symlink(ec)) {
+            AddWatch(it->path(), rel);
+            continue;
+        }
 
-            auto ftime = it->last_write_time(ec);
-            if (!ec) {
-                info.modified_at = FormatFileTime(ftime);
-            } else {
-                info.modified_at = "";
-                ec.clear();
+        FileInfo info;
+        uint64_t inode = 0;
+        if (StatFileInfo(full, rel, info, &inode)) {
+            auto hash_it = blob_hashes.find(inode);
+            if (hash_it != blob_hashes.end()) {
+                info.hash = hash_it->second;
             }
+            new_index[std::move(rel)] = {std::move(info), inode};
+        }
+    }
 
-            new_index[rel_str] = std::move(info);
+    // 同一目录重复 add_watch 会返回同一个 wd；不再出现的旧 wd 说明目录已不存在，取消监听
+    for (const auto& [wd, rel_dir] : old_watches) {
+        if (watch_dirs_.count(wd) == 0) {
+            ::inotify_rm_watch(inotify_fd_, wd);
         }
     }
 
-    // 用写锁替换整个索引
+    // 写锁下与现有索引合并：已消失的删除，其余插入/更新（保留已有条目的访问统计）
+    size_t count = new_index.size();
     {
         std::unique_lock lock(index_mutex_);
-        file_index_.swap(new_index);
+        for (auto it = file_index_.begin(); it != file_index_.end();) {
+            if (new_index.count(it->first) == 0) {
+                it = EraseEntryLocked(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto& [name, entry] : new_index) {
+            UpsertEntryLocked(std::move(entry.first), entry.second);
+        }
     }
 
-    MYLOG_DEBUG("[MyCache] 扫描完成，索引文件数量：{}", file_index_.size());
+    MYLOG_DEBUG("[MyCache] 全量扫描完成，索引文件数量：{}, 监听目录数：{}", count, dir_watches_.size());
 }
 
 void MyCache::CleanExpiredFiles() {
@@ -674,27 +1513,15 @@ void MyCache::CleanExpiredFiles() {
 
     MYLOG_DEBUG("[MyCache] 开始清理过期文件（保留时间 {} 秒）", config_.max_retention_seconds);
 
-    auto now = std::chrono::system_clock::now();
+    const int64_t cutoff_ms = NowUnixMs() - config_.max_retention_seconds * 1000;
     std::vector<std::string> expired_names;
 
-    // 在读锁下收集过期文件（不在锁内做删除操作）
+    // 在读锁下按修改时间从旧到新收集，遇到第一个未过期的即停止：只访问已过期的条目（不在锁内做删除操作）
     {
         std::shared_lock lock(index_mutex_);
-        for (const auto& [name, info] : file_index_) {
-            std::error_code ec;
-            auto full_path = root_path_ / name;
-            auto ftime = std::filesystem::last_write_time(full_path, ec);
-            if (ec) continue;
-
-            // 将 file_time_type 转为 system_clock
-            auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-                ftime - std::filesystem::file_time_type::clock::now()
-                     + std::chrono::system_clock::now()
-            );
-
-            auto age = std::chrono::duration_cast<std::chrono::seconds>(now - sctp).count();
-            if (age > config_.max_retention_seconds) {
-                expired_names.push_back(name);
+        for (auto it = expiry_order_.begin(); it != expiry_order_.end() && it->first < cutoff_ms; ++it) {
+            if (it->first > 0) {
+                expired_names.push_back(it->second);
             }
         }
     }
@@ -705,8 +1532,9 @@ void MyCache::CleanExpiredFiles() {
         auto full_path = root_path_ / name;
         if (std::filesystem::remove(full_path, ec) && !ec) {
             MYLOG_INFO("[MyCache] 过期文件已清理：{}", name);
+            expired_files_.fetch_add(1, std::memory_order_relaxed);
             std::unique_lock lock(index_mutex_);
-            file_index_.erase(name);
+            EraseEntryLocked(name);
         } else {
             MYLOG_WARN("[MyCache] 清理过期文件失败：{}, 错误：{}", name, ec.message());
         }
@@ -717,4 +1545,162 @@ void MyCache::CleanExpiredFiles() {
     }
 }
 
+// ============================================================================
+// 容量淘汰
+// ============================================================================
+
+void MyCache::WakeScanThread() {
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        (void)::write(wake_fd_, &one, sizeof(one));
+    }
+}
+
+void MyCache::EnforceCapacity() {
+    if (config_.max_total_size == 0) {
+        return;
+    }
+    const auto high_bytes = static_cast<uint64_t>(config_.max_total_size * config_.high_watermark);
+    const auto low_bytes = static_cast<uint64_t>(config_.max_total_size * config_.low_watermark);
+
+    // 排序键 (k1, k2) 越小越先淘汰
+    struct Candidate {
+        std::string name;
+        uint64_t size;
+        int64_t k1;
+        int64_t k2;
+    };
+    std::vector<Candidate> candidates;
+    uint64_t total = 0;
+    {
+        std::shared_lock lock(index_mutex_);
+        total = total_bytes_;
+        if (total <= high_bytes) {
+            return;
+        }
+        candidates.reserve(file_index_.size());
+        for (const auto& [name, entry] : file_index_) {
+            const int64_t last_access = entry.last_access_ms.load(std::memory_order_relaxed);
+            Candidate c{name, entry.info.size, last_access, 0};
+            switch (config_.eviction_policy) {
+                case EvictionPolicy::Lfu:
+                    c.k1 = static_cast<int64_t>(entry.hits.load(std::memory_order_relaxed));
+                    c.k2 = last_access;
+                    break;
+                case EvictionPolicy::Largest:
+                    c.k1 = -static_cast<int64_t>(entry.info.size);
+                    c.k2 = last_access;
+                    break;
+                case EvictionPolicy::Lru:
+                default:
+                    break;
+            }
+            candidates.push_back(std::move(c));
+        }
+    }
+
+    // 只在越过高水位时排序一次，一直淘汰到低水位，避免在水位附近反复触发
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+        return std::tie(lhs.k1, lhs.k2) < std::tie(rhs.k1, rhs.k2);
+    });
+
+    MYLOG_INFO("[MyCache] 总占用 {} 字节超过高水位 {} 字节，按 {} 淘汰至 {} 字节以下",
+               total, high_bytes, EvictionPolicyToString(config_.eviction_policy), low_bytes);
+
+    uint64_t freed_files = 0;
+    uint64_t freed_bytes = 0;
+    for (const auto& c : candidates) {
+        if (total <= low_bytes) {
+            break;
+        }
+        std::error_code ec;
+        if (!std::filesystem::remove(root_path_ / c.name, ec) || ec) {
+            MYLOG_WARN("[MyCache] 淘汰文件失败：{}, 错误：{}", c.name, ec.message());
+            continue;
+        }
+        {
+            std::unique_lock lock(index_mutex_);
+            EraseEntryLocked(c.name);
+        }
+        total = total > c.size ? total - c.size : 0;
+        ++freed_files;
+        freed_bytes += c.size;
+        MYLOG_DEBUG("[MyCache] 淘汰文件：{}, 大小={} 字节", c.name, c.size);
+    }
+
+    evicted_files_.fetch_add(freed_files, std::memory_order_relaxed);
+    evicted_bytes_.fetch_add(freed_bytes, std::memory_order_relaxed);
+    MYLOG_INFO("[MyCache] 容量淘汰完成：删除 {} 个文件，释放 {} 字节，当前占用约 {} 字节",
+               freed_files, freed_bytes, total);
+}
+
+// ============================================================================
+// 索引维护
+// ============================================================================
+
+void MyCache::UpsertEntryLocked(FileInfo&& info, uint64_t inode) {
+    auto [it, inserted] = file_index_.try_emplace(info.name);
+    IndexEntry& entry = it->second;
+    if (inserted) {
+        entry.last_access_ms.store(info.modified_at_ms, std::memory_order_relaxed);
+    } else {
+        // inotify 事件触发的重新 stat 不带哈希：同一 inode 且大小未变时沿用已知哈希；
+        // 非去重模式的文件可能被原地修改，还要求修改时间未变（去重模式的数据只读，修改时间只会被刷新）
+        if (info.hash.empty() && !entry.info.hash.empty() && inode != 0 && entry.inode == inode &&
+            entry.info.size == info.size &&
+            (config_.dedup || entry.info.modified_at_ms == info.modified_at_ms)) {
+            info.hash = entry.info.hash;
+        }
+        total_bytes_ -= entry.info.size;
+        expiry_order_.erase({entry.info.modified_at_ms, it->first});
+        ReleaseBlobRefLocked(entry.info);
+    }
+    total_bytes_ += info.size;
+    expiry_order_.emplace(info.modified_at_ms, it->first);
+    AddBlobRefLocked(info);
+    entry.info = std::move(info);
+    entry.inode = inode;
+}
+
+MyCache::FileIndex::iterator MyCache::EraseEntryLocked(FileIndex::iterator it) {
+    total_bytes_ -= it->second.info.size;
+    expiry_order_.erase({it->second.info.modified_at_ms, it->first});
+    ReleaseBlobRefLocked(it->second.info);
+    return file_index_.erase(it);
+}
+
+void MyCache::EraseEntryLocked(const std::string& name) {
+    auto it = file_index_.find(name);
+    if (it != file_index_.end()) {
+        EraseEntryLocked(it);
+    }
+}
+
+void MyCache::AddBlobRefLocked(const FileInfo& info) {
+    if (!config_.dedup || info.hash.empty()) {
+        return;
+    }
+    uint32_t& refs = blob_refs_[BlobKey(info.hash, info.size)];
+    if (refs > 0) {
+        dedup_saved_bytes_ += info.size;
+    }
+    ++refs;
+}
+
+void MyCache::ReleaseBlobRefLocked(const FileInfo& info) {
+    if (!config_.dedup || info.hash.empty()) {
+        return;
+    }
+    auto it = blob_refs_.find(BlobKey(info.hash, info.size));
+    if (it == blob_refs_.end()) {
+        return;
+    }
+    if (--it->second > 0) {
+        dedup_saved_bytes_ -= info.size;
+    } else {
+        orphan_blobs_.push_back(it->first);
+        blob_refs_.erase(it);
+    }
+}
+
 }  // namespace my_cache
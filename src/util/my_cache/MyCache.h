@@ -7,8 +7,10 @@
  * 功能概述：
  *   - 管理本地文件系统中的一个缓存目录
  *   - 默认构造，通过 Init(JSON) 传入配置后启动
- *   - 后台线程定期扫描目录，维护内存文件索引，使 Exists 查询达到 O(1) 复杂度
- *   - 支持配置最大文件大小、最长保留时间
+ *   - 后台线程通过 inotify 监听目录变化，增量维护内存文件索引，使 Exists 查询达到 O(1) 复杂度
+ *   - 支持配置最大文件大小、最长保留时间、总容量上限（高/低水位 + LRU/LFU/按大小淘汰）
+ *   - 支持流式写入（CacheFileWriter）与断点续传上传会话，大文件无需整体读入内存
+ *   - 写入时计算内容哈希（FileInfo::hash），可选按内容去重（硬链接共享数据）
  *   - 所有操作均防止路径穿越攻击
  *   - MyCacheProvider 提供线程安全的单例包装
  *
@@ -17,15 +19,20 @@
  */
 
 #include "CacheTypes.h"
+#include "CacheFileWriter.h"
+#include "ContentHash.h"
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <memory>
 #include <filesystem>
 #include <mutex>
+#include <set>
 #include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace my_cache {
@@ -39,9 +46,13 @@ namespace my_cache {
  *
  * 职责：
  *   1. 管理 root_path 下的文件存取
- *   2. 后台线程每 5 秒扫描一次目录，维护内存文件索引
+ *   2. 后台线程监听 inotify 事件，按创建/删除/修改增量更新内存文件索引；
+ *      仅在初始化与事件队列溢出（IN_Q_OVERFLOW）时全量扫描，inotify 不可用时退化为每 5 秒全量扫描
  *   3. 所有公开接口均做路径穿越校验
  *   4. 可根据配置进行文件大小限制和过期清理
+ *   5. 记录 Exists/GetFullPath 的访问时间与次数，总容量超过高水位时按策略淘汰到低水位
+ *   6. 去重模式下，内容相同的文件都是 .mycache-blobs/<hash>-<size> 的硬链接；
+ *      写入前已知内容（SaveFile）时先查是否已存在，存在则不再写盘
  *
  * 使用流程：
  *   MyCache cache;
@@ -57,7 +68,7 @@ public:
      */
     MyCache();
 
-    /// 析构函数，停止后台扫描线程
+    /// 析构函数，停止后台监听线程
     ~MyCache();
 
     // 禁止拷贝和移动
@@ -75,6 +86,10 @@ public:
      *   - root_path (string, 必填): 缓存根目录路径，不存在时自动创建
      *   - max_file_size (uint64, 可选): 单个文件最大大小（字节），0 或缺省表示不限制
      *   - max_retention_seconds (int64, 可选): 文件最长保留时间（秒），0 或缺省表示不限制，-1 表示永久有效
+     *   - max_total_size (uint64, 可选): 缓存总容量上限（MB），0 或缺省表示不限制
+     *   - eviction_policy (string, 可选): "lru"（默认）/ "lfu" / "largest"
+     *   - high_watermark / low_watermark (number, 可选): 开始/停止淘汰的占用比例，默认 0.95 / 0.85
+     *   - dedup (bool, 可选): 是否按内容去重，默认 false
      *
      * @return CacheResult<void> 初始化结果
      */
@@ -93,10 +108,54 @@ public:
      * @param name 文件相对路径名（如 "a/b.txt"），支持子目录
      * @param data 文件二进制内容
      * @return CacheResult<void>，若超出 max_file_size 返回 FileTooLarge
+     *
+     * 去重模式下相同内容已存在时只创建硬链接，不写入数据。
      */
     CacheResult<void> SaveFile(const std::string& name,
                                const std::vector<uint8_t>& data);
 
+    /**
+     * @brief 打开一个流式写入句柄，数据先写入暂存目录，Commit(name) 时 fsync + rename 进缓存
+     *
+     * 写入过程中按 max_file_size / max_total_size 检查大小，适合上传等无法预知大小的场景。
+     */
+    CacheResult<std::unique_ptr<CacheFileWriter>> OpenWriter();
+
+    // ---- 断点续传上传会话 ----
+
+    /**
+     * @brief 创建上传会话
+     * @param name 完成后保存的相对路径名（此时即做路径与大小校验）
+     * @param total_size 文件总大小（字节），必须大于 0
+     * @return 会话信息（含 upload_id）
+     */
+    CacheResult<UploadSessionInfo> BeginUpload(const std::string& name, uint64_t total_size);
+
+    /**
+     * @brief 查询上传会话进度（客户端断线后据此确定续传偏移）
+     */
+    CacheResult<UploadSessionInfo> GetUpload(const std::string& upload_id);
+
+    /**
+     * @brief 打开一个分片写入句柄
+     * @param offset 分片起始偏移，必须等于已接收字节数，否则返回 OffsetMismatch
+     *
+     * 同一会话同一时间只允许一个分片写入；句柄 Close() 或析构时记录已接收字节数。
+     */
+    CacheResult<std::unique_ptr<CacheFileWriter>> OpenUploadChunk(const std::string& upload_id,
+                                                                  uint64_t offset);
+
+    /**
+     * @brief 数据接收完整后提交会话：rename 进缓存并更新索引，会话随之结束
+     * @return 未接收完整返回 UploadIncomplete
+     */
+    CacheResult<void> CommitUpload(const std::string& upload_id);
+
+    /**
+     * @brief 放弃上传会话并删除已接收的数据
+     */
+    CacheResult<void> AbortUpload(const std::string& upload_id);
+
     /**
      * @brief 删除缓存目录中的文件
      * @param name 文件相对路径名
@@ -105,14 +164,14 @@ public:
     CacheResult<void> DeleteFile(const std::string& name);
 
     /**
-     * @brief 获取文件的完整绝对路径
+     * @brief 获取文件的完整绝对路径（下载等读取场景使用，索引中存在时记为一次访问）
      * @param name 文件相对路径名
      * @return CacheResult<std::string> 成功时 value 为绝对路径
      */
     CacheResult<std::string> GetFullPath(const std::string& name);
 
     /**
-     * @brief O(1) 查询文件是否存在（基于内存索引）
+     * @brief O(1) 查询文件是否存在（基于内存索引）；命中时记为一次访问
      * @param name 文件相对路径名
      * @return CacheResult<bool> 成功时 value 为 true/false
      */
@@ -128,6 +187,11 @@ public:
      */
     const CacheConfig& GetConfig() const;
 
+    /**
+     * @brief 获取容量占用与淘汰统计
+     */
+    CacheUsage GetUsage() const;
+
     /**
      * @brief 获取缓存中所有文件的元信息列表
      * @return CacheResult<std::vector<FileInfo>> 成功时 value 为文件元信息列表
@@ -135,7 +199,7 @@ public:
     CacheResult<std::vector<FileInfo>> GetAllFileList();
 
     /**
-     * @brief 获取指定目录下的文件元信息列表
+     * @brief 获取指定目录下的文件元信息列表（基于内存索引，不遍历磁盘）
      * @param folder_path 目标目录，支持空字符串（表示缓存根目录）、相对路径或位于缓存根目录内的绝对路径
      * @return CacheResult<std::vector<FileInfo>> 成功时 value 为文件元信息列表
      */
@@ -151,6 +215,53 @@ public:
                                                 const std::string& new_folder_name);
 
 private:
+    friend class CacheFileWriter;
+
+    /// 上传会话（内存中保存，进程重启后失效，分片文件在 Init 时清理）
+    struct UploadSession {
+        UploadSessionInfo info;
+        std::filesystem::path part_path;                  // 分片数据文件（位于暂存目录）
+        bool busy = false;                                // 正在写入分片或提交
+        ContentHasher hasher;                             // 已接收数据的哈希状态，续传时接着计算
+        std::chrono::steady_clock::time_point last_active;
+    };
+
+    /// 索引条目：文件元信息 + 访问统计（访问统计在读锁下以原子方式更新）
+    struct IndexEntry {
+        FileInfo info;
+        std::atomic<int64_t> last_access_ms{0};   // 最近访问时间（Unix 毫秒）
+        std::atomic<uint64_t> hits{0};            // 访问次数
+        uint64_t inode = 0;                       // 文件 inode，用于判断重新 stat 时能否沿用已知哈希
+    };
+    using FileIndex = std::unordered_map<std::string, IndexEntry>;
+
+    // ---- 流式写入 ----
+
+    /// 将暂存目录中写好的文件 rename 为 name 并更新索引（CacheFileWriter::Commit / CommitUpload 调用）
+    CacheResult<void> CommitStagedFile(const std::filesystem::path& staged_path,
+                                       const std::string& name, uint64_t size, const std::string& hash);
+
+    /// 分片句柄关闭：记录已接收字节数与哈希状态并释放会话
+    void OnUploadChunkClosed(const std::string& upload_id, uint64_t received, const ContentHasher& hasher);
+
+    /// 文件写入缓存目录后更新索引，并在超过高水位时唤醒淘汰
+    void IndexSavedFile(const std::string& name, const std::filesystem::path& full_path,
+                        uint64_t size, const std::string& hash);
+
+    // ---- 按内容去重 ----
+
+    /// 内容已在数据块目录中时，原子地把 full_path 替换为它的硬链接；不存在或失败返回 false
+    bool LinkExistingBlob(const std::string& key, const std::filesystem::path& full_path);
+
+    /// 把刚写好的文件登记为数据块（设为只读并在数据块目录中建立硬链接），失败时仅记录日志
+    void AdoptBlob(const std::filesystem::path& file, const std::string& key);
+
+    /// 删除已没有任何缓存文件引用的数据块（后台线程调用）
+    void CollectOrphanBlobs();
+
+    /// 清理长时间无活动的上传会话
+    void CleanStaleUploads();
+
     // ---- 路径安全验证 ----
 
     /**
@@ -173,17 +284,59 @@ private:
                                          std::filesystem::path& full_path,
                                          bool allow_root = true) const;
 
-    // ---- 后台扫描线程 ----
+    // ---- 后台监听线程 ----
 
-    /// 后台线程入口函数
+    /// 后台线程入口函数：处理 inotify 事件，并按周期清理过期文件
     void ScanThreadFunc();
 
-    /// 执行一次目录扫描，更新内存索引（含文件元信息）
+    /// 全量扫描目录，重建内存索引；inotify 可用时同时为所有子目录补齐监听
     void RefreshIndex();
 
-    /// 清理过期文件（仅当 max_retention_seconds > 0 时生效）
+    /// 读取并应用一批 inotify 事件；返回 false 表示事件队列溢出，需要全量扫描
+    bool ProcessWatchEvents();
+
+    /// 为目录添加监听（不递归）
+    void AddWatch(const std::filesystem::path& dir, const std::string& rel_dir);
+
+    /// 为新出现的目录递归添加监听，并把其中已有的文件加入索引
+    void AddDirectory(const std::string& rel_dir);
+
+    /// 目录被删除或移出：移除其下所有监听与索引条目
+    void RemoveDirectory(const std::string& rel_dir);
+
+    /// 按当前磁盘状态更新单个文件的索引条目（文件不存在或非常规文件时移除）
+    void UpdateFileEntry(const std::string& rel_name);
+
+    /// 关闭 inotify 与唤醒用的文件描述符
+    void CloseWatchFds();
+
+    /// 清理过期文件（仅当 max_retention_seconds > 0 时生效），按修改时间有序遍历，只访问已过期的条目
     void CleanExpiredFiles();
 
+    // ---- 容量淘汰 ----
+
+    /// 总占用超过高水位时按策略删除文件，直到低于低水位（仅当 max_total_size > 0 时生效）
+    void EnforceCapacity();
+
+    /// 唤醒后台线程：检查容量，并按最新状态（如新建的上传会话）重新计算等待时间
+    void WakeScanThread();
+
+    // ---- 索引维护（调用方持有 index_mutex_ 写锁） ----
+
+    /// 插入或更新索引条目，同步维护总大小、过期顺序与数据块引用；新条目的访问时间初始化为修改时间
+    /// @param inode 文件 inode（0 表示未知）；info.hash 为空且文件未变时沿用原条目的哈希
+    void UpsertEntryLocked(FileInfo&& info, uint64_t inode = 0);
+
+    /// 删除索引条目，同步维护总大小与过期顺序；返回下一个迭代器
+    FileIndex::iterator EraseEntryLocked(FileIndex::iterator it);
+
+    /// 按名字删除索引条目（不存在时忽略）
+    void EraseEntryLocked(const std::string& name);
+
+    /// 去重模式下维护数据块引用计数；引用归零的数据块交给后台线程检查删除
+    void AddBlobRefLocked(const FileInfo& info);
+    void ReleaseBlobRefLocked(const FileInfo& info);
+
 private:
     CacheConfig config_;                       // 配置信息
     std::filesystem::path root_path_;          // 缓存根目录（规范化后的绝对路径）
@@ -191,13 +344,34 @@ private:
     std::atomic<bool> running_{false};         // 后台线程运行标记
 
     mutable std::shared_mutex index_mutex_;    // 保护文件索引的读写锁
-    std::unordered_map<std::string, FileInfo> file_index_; // 内存文件索引（相对路径→元信息）
-
-    std::thread scan_thread_;                  // 后台扫描线程
-    std::mutex cv_mutex_;                      // 条件变量互斥锁
-    std::condition_variable cv_;               // 用于优雅退出的条件变量
-
-    static constexpr int kScanIntervalSec = 5; // 扫描间隔（秒）
+    FileIndex file_index_;                     // 内存文件索引（相对路径→元信息）
+    std::set<std::pair<int64_t, std::string>> expiry_order_; // (修改时间, 相对路径)，过期清理按此顺序
+    uint64_t total_bytes_ = 0;                 // 索引中所有文件的总大小
+
+    std::atomic<uint64_t> evicted_files_{0};   // 淘汰统计
+    std::atomic<uint64_t> evicted_bytes_{0};
+    std::atomic<uint64_t> expired_files_{0};
+    std::atomic<uint64_t> dedup_hits_{0};
+
+    std::filesystem::path blobs_path_;         // 数据块目录（去重模式），不进入索引
+    std::unordered_map<std::string, uint32_t> blob_refs_; // 数据块 → 引用它的索引条目数（受 index_mutex_ 保护）
+    uint64_t dedup_saved_bytes_ = 0;           // 共享数据节省的字节数（受 index_mutex_ 保护）
+    std::vector<std::string> orphan_blobs_;    // 引用归零、待检查删除的数据块（受 index_mutex_ 保护）
+
+    std::filesystem::path staging_path_;       // 暂存目录（流式写入的临时文件与上传分片），不进入索引
+    std::mutex uploads_mutex_;                 // 保护上传会话表
+    std::unordered_map<std::string, UploadSession> uploads_; // upload_id → 会话
+
+    std::thread scan_thread_;                  // 后台监听线程
+    int inotify_fd_ = -1;                      // inotify 实例，-1 表示不可用（退化为周期全量扫描）
+    int wake_fd_ = -1;                         // eventfd，用于唤醒后台线程（析构、容量检查）
+
+    // 以下监听表仅由后台线程访问（Init 在线程启动前访问）
+    std::unordered_map<int, std::string> watch_dirs_;   // watch 描述符 → 相对目录（根目录为空串）
+    std::unordered_map<std::string, int> dir_watches_;  // 相对目录 → watch 描述符
+
+    static constexpr int kScanIntervalSec = 5; // 过期清理间隔；inotify 不可用时也是全量扫描间隔（秒）
+    static constexpr int kUploadSessionTimeoutSec = 3600; // 上传会话无活动超时（秒）
 };
 
 }  // namespace my_cache
@@ -13,6 +13,7 @@ namespace my_cache {
 // ============================================================================
 
 std::atomic<bool> MyCacheProvider::initialized_flag_{false};
+std::atomic<uint64_t> MyCacheProvider::generation_{1};
 std::unique_ptr<MyCache> MyCacheProvider::instance_ = nullptr;
 std::mutex MyCacheProvider::mutex_;
 
@@ -41,6 +42,7 @@ CacheResult<void> MyCacheProvider::Init(const std::string& config_json) {
     }
 
     initialized_flag_.store(true);
+    generation_.fetch_add(1);
     MYLOG_INFO("[MyCacheProvider] 初始化成功");
     return CacheResult<void>::Success();
 }
@@ -59,6 +61,7 @@ void MyCacheProvider::Destroy() {
     std::lock_guard lock(mutex_);
     instance_.reset();
     initialized_flag_.store(false);
+    generation_.fetch_add(1);
 }
 
 }  // namespace my_cache
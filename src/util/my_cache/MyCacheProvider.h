@@ -45,12 +45,20 @@ public:
      */
     static void Destroy();
 
+    /**
+     * @brief 实例代号，每次成功 Init 或 Destroy 时递增
+     *
+     * MyCache 的配置在 Init 后不再变化，API 层据此缓存配置查询的响应。
+     */
+    static uint64_t Generation() { return generation_.load(); }
+
     // 禁止实例化
     MyCacheProvider() = delete;
     ~MyCacheProvider() = delete;
 
 private:
     static std::atomic<bool> initialized_flag_;
+    static std::atomic<uint64_t> generation_;
     static std::unique_ptr<MyCache> instance_;
     static std::mutex mutex_;
 };
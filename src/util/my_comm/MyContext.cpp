@@ -7,12 +7,228 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <limits>
 #include <vector>
 
 #include "MyLog.h"
 
 namespace my_comm {
 
+namespace detail {
+
+/**
+ * @brief 单条记录的存储槽位
+ *
+ * 标量值与存在标志放在原子字段中，由 seq 组成 seqlock：写入方持有 mutex 并在写入前后
+ * 各递增一次 seq（奇数表示写入中），读取方无锁读取并在 seq 变化时重试。
+ * 非标量值、解释与时间戳由 mutex 保护。
+ */
+struct ContextSlot {
+    explicit ContextSlot(std::string n) : name(std::move(n)) {}
+
+    const std::string name;
+
+    std::atomic<uint64_t> seq{0};
+    std::atomic<bool> present{false};
+    std::atomic<bool> scalar{false};                 ///< 值在 bits 中（bool / 整数 / 浮点）
+    std::atomic<uint8_t> type{static_cast<uint8_t>(ContextValueType::Null)};
+    std::atomic<int64_t> bits{0};
+    std::atomic<uint64_t> version{0};
+
+    std::mutex mutex;
+    nlohmann::json value;                            ///< 非标量值
+    std::string description;
+    int64_t created_at_ms{0};
+    int64_t updated_at_ms{0};
+};
+
+}  // namespace detail
+
+namespace {
+
+/// 一次无锁读取得到的标量视图
+struct ScalarView {
+    bool present{false};
+    bool scalar{false};
+    ContextValueType type{ContextValueType::Null};
+    int64_t bits{0};
+};
+
+ScalarView ReadScalar(const detail::ContextSlot& slot) {
+    ScalarView v;
+    while (true) {
+        const uint64_t s1 = slot.seq.load(std::memory_order_acquire);
+        if (s1 & 1) continue;  // 写入中
+        v.present = slot.present.load(std::memory_order_relaxed);
+        v.scalar = slot.scalar.load(std::memory_order_relaxed);
+        v.type = static_cast<ContextValueType>(slot.type.load(std::memory_order_relaxed));
+        v.bits = slot.bits.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == s1) return v;
+    }
+}
+
+int64_t DoubleToBits(double d) {
+    int64_t b = 0;
+    std::memcpy(&b, &d, sizeof(b));
+    return b;
+}
+
+double BitsToDouble(int64_t b) {
+    double d = 0.0;
+    std::memcpy(&d, &b, sizeof(d));
+    return d;
+}
+
+bool ScalarToBool(const ScalarView& v) {
+    switch (v.type) {
+        case ContextValueType::Boolean: return v.bits != 0;
+        case ContextValueType::Integer: return v.bits != 0;
+        default:                        return BitsToDouble(v.bits) != 0.0;
+    }
+}
+
+int64_t ScalarToInt(const ScalarView& v) {
+    if (v.type == ContextValueType::Double) return static_cast<int64_t>(BitsToDouble(v.bits));
+    return v.bits;
+}
+
+double ScalarToDouble(const ScalarView& v) {
+    if (v.type == ContextValueType::Double) return BitsToDouble(v.bits);
+    return static_cast<double>(v.bits);
+}
+
+nlohmann::json ScalarToJson(const ScalarView& v) {
+    switch (v.type) {
+        case ContextValueType::Boolean: return nlohmann::json(v.bits != 0);
+        case ContextValueType::Integer: return nlohmann::json(v.bits);
+        default:                        return nlohmann::json(BitsToDouble(v.bits));
+    }
+}
+
+/// 调用者持有 slot.mutex，写入方被排斥，原子字段可直接读取
+ScalarView ViewLocked(const detail::ContextSlot& slot) {
+    ScalarView v;
+    v.present = slot.present.load(std::memory_order_relaxed);
+    v.scalar = slot.scalar.load(std::memory_order_relaxed);
+    v.type = static_cast<ContextValueType>(slot.type.load(std::memory_order_relaxed));
+    v.bits = slot.bits.load(std::memory_order_relaxed);
+    return v;
+}
+
+/// 调用者持有 slot.mutex
+nlohmann::json ValueLocked(const detail::ContextSlot& slot) {
+    const ScalarView v = ViewLocked(slot);
+    return v.scalar ? ScalarToJson(v) : slot.value;
+}
+
+// ---- 非标量值的类型转换（沿用原 GetBool / GetInt / GetDouble / GetString 的规则） ----
+
+bool JsonToBool(const std::string& name, const nlohmann::json& v, bool default_value) {
+    try {
+        if (v.is_boolean()) return v.get<bool>();
+        if (v.is_number()) return v.get<double>() != 0.0;
+        if (v.is_string()) {
+            const std::string& s = v.get_ref<const std::string&>();
+            return s == "true" || s == "1";
+        }
+    } catch (const std::exception& e) {
+        MYLOG_WARN("[MyContext] GetBool 转换失败({}): {}", name, e.what());
+    }
+    return default_value;
+}
+
+int64_t JsonToInt(const std::string& name, const nlohmann::json& v, int64_t default_value) {
+    try {
+        if (v.is_number_integer()) return v.get<int64_t>();
+        if (v.is_number()) return static_cast<int64_t>(v.get<double>());
+        if (v.is_boolean()) return v.get<bool>() ? 1 : 0;
+        if (v.is_string()) return static_cast<int64_t>(std::stoll(v.get_ref<const std::string&>()));
+    } catch (const std::exception& e) {
+        MYLOG_WARN("[MyContext] GetInt 转换失败({}): {}", name, e.what());
+    }
+    return default_value;
+}
+
+double JsonToDouble(const std::string& name, const nlohmann::json& v, double default_value) {
+    try {
+        if (v.is_number()) return v.get<double>();
+        if (v.is_boolean()) return v.get<bool>() ? 1.0 : 0.0;
+        if (v.is_string()) return std::stod(v.get_ref<const std::string&>());
+    } catch (const std::exception& e) {
+        MYLOG_WARN("[MyContext] GetDouble 转换失败({}): {}", name, e.what());
+    }
+    return default_value;
+}
+
+std::string JsonToString(const std::string& name, const nlohmann::json& v, const std::string& default_value) {
+    try {
+        if (v.is_string()) return v.get<std::string>();
+        return v.dump();
+    } catch (const std::exception& e) {
+        MYLOG_WARN("[MyContext] GetString 转换失败({}): {}", name, e.what());
+    }
+    return default_value;
+}
+
+// ---- 槽位读取：标量走无锁快速路径，其余在槽位锁内转换 ----
+
+bool SlotGetBool(detail::ContextSlot& slot, bool default_value) {
+    const ScalarView v = ReadScalar(slot);
+    if (!v.present) return default_value;
+    if (v.scalar) return ScalarToBool(v);
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    const ScalarView locked = ViewLocked(slot);
+    if (!locked.present) return default_value;
+    if (locked.scalar) return ScalarToBool(locked);
+    return JsonToBool(slot.name, slot.value, default_value);
+}
+
+int64_t SlotGetInt(detail::ContextSlot& slot, int64_t default_value) {
+    const ScalarView v = ReadScalar(slot);
+    if (!v.present) return default_value;
+    if (v.scalar) return ScalarToInt(v);
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    const ScalarView locked = ViewLocked(slot);
+    if (!locked.present) return default_value;
+    if (locked.scalar) return ScalarToInt(locked);
+    return JsonToInt(slot.name, slot.value, default_value);
+}
+
+double SlotGetDouble(detail::ContextSlot& slot, double default_value) {
+    const ScalarView v = ReadScalar(slot);
+    if (!v.present) return default_value;
+    if (v.scalar) return ScalarToDouble(v);
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    const ScalarView locked = ViewLocked(slot);
+    if (!locked.present) return default_value;
+    if (locked.scalar) return ScalarToDouble(locked);
+    return JsonToDouble(slot.name, slot.value, default_value);
+}
+
+std::string SlotGetString(detail::ContextSlot& slot, const std::string& default_value) {
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (!slot.present.load(std::memory_order_relaxed)) return default_value;
+    return JsonToString(slot.name, ValueLocked(slot), default_value);
+}
+
+/// seqlock 写入区间（调用者持有 slot.mutex）
+class SeqWrite {
+public:
+    explicit SeqWrite(detail::ContextSlot& slot) : slot_(slot) {
+        const uint64_t s = slot_.seq.load(std::memory_order_relaxed);
+        slot_.seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    ~SeqWrite() { slot_.seq.fetch_add(1, std::memory_order_release); }
+
+private:
+    detail::ContextSlot& slot_;
+};
+
+}  // namespace
+
 // ============================================================================
 // ContextEntry
 // ============================================================================
@@ -26,12 +242,74 @@ nlohmann::json ContextEntry::ToJson() const {
         j["type"] = MyContext::TypeToString(type);
         j["created_at_ms"] = created_at_ms;
         j["updated_at_ms"] = updated_at_ms;
+        j["version"] = version;
     } catch (const std::exception& e) {
         MYLOG_ERROR("[MyContext] ContextEntry::ToJson 序列化失败: {}", e.what());
     }
     return j;
 }
 
+// ============================================================================
+// ContextHandle
+// ============================================================================
+
+const std::string& ContextHandle::Name() const {
+    static const std::string kEmpty;
+    return slot_ ? slot_->name : kEmpty;
+}
+
+bool ContextHandle::Has() const {
+    return slot_ && ReadScalar(*slot_).present;
+}
+
+bool ContextHandle::GetBool(bool default_value) const {
+    return slot_ ? SlotGetBool(*slot_, default_value) : default_value;
+}
+
+int64_t ContextHandle::GetInt(int64_t default_value) const {
+    return slot_ ? SlotGetInt(*slot_, default_value) : default_value;
+}
+
+double ContextHandle::GetDouble(double default_value) const {
+    return slot_ ? SlotGetDouble(*slot_, default_value) : default_value;
+}
+
+std::string ContextHandle::GetString(const std::string& default_value) const {
+    return slot_ ? SlotGetString(*slot_, default_value) : default_value;
+}
+
+uint64_t ContextHandle::Version() const {
+    return slot_ ? slot_->version.load(std::memory_order_acquire) : 0;
+}
+
+bool ContextHandle::SetBool(bool value) {
+    if (!slot_) return false;
+    MyContext::PendingValue v{ContextValueType::Boolean, true, value ? 1 : 0, nullptr};
+    return MyContext::GetInstance().WriteSlot(*slot_, &v, nullptr, false, nullptr);
+}
+
+bool ContextHandle::SetInt(int64_t value) {
+    if (!slot_) return false;
+    MyContext::PendingValue v{ContextValueType::Integer, true, value, nullptr};
+    return MyContext::GetInstance().WriteSlot(*slot_, &v, nullptr, false, nullptr);
+}
+
+bool ContextHandle::SetDouble(double value) {
+    if (!slot_) return false;
+    MyContext::PendingValue v{ContextValueType::Double, true, DoubleToBits(value), nullptr};
+    return MyContext::GetInstance().WriteSlot(*slot_, &v, nullptr, false, nullptr);
+}
+
+bool ContextHandle::SetString(const std::string& value) {
+    return Set(nlohmann::json(value));
+}
+
+bool ContextHandle::Set(const nlohmann::json& value) {
+    if (!slot_) return false;
+    const MyContext::PendingValue v = MyContext::FromJson(value);
+    return MyContext::GetInstance().WriteSlot(*slot_, &v, nullptr, false, nullptr);
+}
+
 // ============================================================================
 // 单例
 // ============================================================================
@@ -74,61 +352,188 @@ const char* MyContext::TypeToString(ContextValueType type) {
     }
 }
 
-bool MyContext::SetLocked(const std::string& name, const nlohmann::json& value,
-                          const std::string& description) {
-    const int64_t now = NowMs();
-    auto it = entries_.find(name);
-    if (it == entries_.end()) {
-        ContextEntry entry;
-        entry.name = name;
-        entry.value = value;
-        entry.description = description;
-        entry.type = DeduceType(value);
-        entry.created_at_ms = now;
-        entry.updated_at_ms = now;
-        entries_.emplace(name, std::move(entry));
-        MYLOG_INFO("[MyContext] 新增上下文: {} (type={})", name, TypeToString(DeduceType(value)));
-    } else {
-        it->second.value = value;
-        it->second.type = DeduceType(value);
-        if (!description.empty()) {
-            it->second.description = description;
+bool MyContext::MatchPattern(const std::string& pattern, const std::string& name) {
+    if (pattern == "*") return true;
+    if (!pattern.empty() && pattern.back() == '*') {
+        return name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+    }
+    return pattern == name;
+}
+
+MyContext::PendingValue MyContext::FromJson(const nlohmann::json& value) {
+    PendingValue v;
+    v.type = DeduceType(value);
+    if (value.is_boolean()) {
+        v.scalar = true;
+        v.bits = value.get<bool>() ? 1 : 0;
+    } else if (value.is_number_unsigned()) {
+        // 超出 int64 范围的无符号数保留 JSON 原值
+        const uint64_t u = value.get<uint64_t>();
+        if (u <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            v.scalar = true;
+            v.bits = static_cast<int64_t>(u);
         }
-        it->second.updated_at_ms = now;
-        MYLOG_INFO("[MyContext] 更新上下文: {} (type={})", name, TypeToString(it->second.type));
+    } else if (value.is_number_integer()) {
+        v.scalar = true;
+        v.bits = value.get<int64_t>();
+    } else if (value.is_number_float()) {
+        v.scalar = true;
+        v.bits = DoubleToBits(value.get<double>());
     }
-    return true;
+    if (!v.scalar) v.json = &value;
+    return v;
 }
 
-// ============================================================================
-// 写入 / 注册
-// ============================================================================
+MyContext::Shard& MyContext::ShardFor(const std::string& name) const {
+    return shards_[std::hash<std::string>{}(name) % kShardCount];
+}
 
-bool MyContext::Set(const std::string& name, const nlohmann::json& value,
-                    const std::string& description) {
+detail::ContextSlot* MyContext::FindLocked(const Shard& shard, const std::string& name) {
+    auto it = shard.slots.find(name);
+    if (it == shard.slots.end() || !it->second->present.load(std::memory_order_acquire)) return nullptr;
+    return it->second.get();
+}
+
+MyContext::SlotPtr MyContext::GetOrCreateSlot(const std::string& name) {
+    Shard& shard = ShardFor(name);
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.slots.find(name);
+        if (it != shard.slots.end()) return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    SlotPtr& slot = shard.slots[name];
+    if (!slot) slot = std::make_shared<detail::ContextSlot>(name);
+    return slot;
+}
+
+detail::ContextSlot* MyContext::LookupForRead(const std::string& name) const {
+    thread_local std::unordered_map<std::string, SlotPtr> cache;
+    auto it = cache.find(name);
+    if (it != cache.end()) return it->second.get();
+
+    SlotPtr slot;
+    {
+        const Shard& shard = ShardFor(name);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto found = shard.slots.find(name);
+        if (found == shard.slots.end()) return nullptr;
+        slot = found->second;
+    }
+    if (cache.size() >= kReadCacheCapacity) cache.clear();
+    return cache.emplace(name, std::move(slot)).first->second.get();
+}
+
+bool MyContext::WriteSlot(detail::ContextSlot& slot, const PendingValue* value, const std::string* description,
+                          bool require_present, std::string* error_out) {
+    bool created = false;
+    ContextValueType type = ContextValueType::Null;
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        const bool present = slot.present.load(std::memory_order_relaxed);
+        if (require_present && !present) {
+            if (error_out) *error_out = "上下文不存在: " + slot.name;
+            return false;
+        }
+        const int64_t now = NowMs();
+        created = !present;
+
+        if (value) {
+            // 先准备好非标量 JSON（可能抛异常），再进入 seqlock 写区间
+            nlohmann::json json_value = value->scalar ? nlohmann::json() : *value->json;
+            {
+                SeqWrite write(slot);
+                slot.scalar.store(value->scalar, std::memory_order_relaxed);
+                slot.type.store(static_cast<uint8_t>(value->type), std::memory_order_relaxed);
+                slot.bits.store(value->bits, std::memory_order_relaxed);
+                slot.present.store(true, std::memory_order_relaxed);
+            }
+            slot.value = std::move(json_value);
+        }
+        if (description) slot.description = *description;
+        if (created) {
+            slot.created_at_ms = now;
+            size_.fetch_add(1, std::memory_order_relaxed);
+        }
+        slot.updated_at_ms = now;
+        slot.version.fetch_add(1, std::memory_order_release);
+        type = static_cast<ContextValueType>(slot.type.load(std::memory_order_relaxed));
+    }
+    version_.fetch_add(1, std::memory_order_acq_rel);
+
+    // 热点键可能被高频写入，更新只打 DEBUG 日志
+    if (created) {
+        MYLOG_INFO("[MyContext] 新增上下文: {} (type={})", slot.name, TypeToString(type));
+    } else {
+        MYLOG_DEBUG("[MyContext] 更新上下文: {} (type={})", slot.name, TypeToString(type));
+    }
+    Notify(slot, ContextChange::Kind::Set);
+    return true;
+}
+
+bool MyContext::SetValue(const std::string& name, const PendingValue& value, const std::string& description) {
     if (name.empty()) {
         MYLOG_WARN("[MyContext] Set 失败: name 不能为空");
         return false;
     }
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return SetLocked(name, value, description);
+        SlotPtr slot = GetOrCreateSlot(name);
+        // 新建记录时总是写入解释（可能为空），以免沿用已删除记录的解释
+        const bool keep_description = description.empty() && ReadScalar(*slot).present;
+        return WriteSlot(*slot, &value, keep_description ? nullptr : &description, false, nullptr);
     } catch (const std::exception& e) {
         MYLOG_ERROR("[MyContext] Set 异常: {}", e.what());
         return false;
     }
 }
 
+void MyContext::Notify(detail::ContextSlot& slot, ContextChange::Kind kind) {
+    if (subscription_count_.load(std::memory_order_acquire) == 0) return;
+    std::shared_ptr<const std::vector<Subscription>> subs = std::atomic_load(&subscriptions_);
+    if (!subs) return;
+
+    ContextChange change;
+    bool built = false;
+    for (const auto& sub : *subs) {
+        if (!MatchPattern(sub.pattern, slot.name)) continue;
+        if (!built) {
+            change.kind = kind;
+            change.name = slot.name;
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            change.version = slot.version.load(std::memory_order_relaxed);
+            if (kind == ContextChange::Kind::Set && slot.present.load(std::memory_order_relaxed)) {
+                change.value = ValueLocked(slot);
+                change.type = static_cast<ContextValueType>(slot.type.load(std::memory_order_relaxed));
+            }
+            built = true;
+        }
+        try {
+            sub.callback(change);
+        } catch (const std::exception& e) {
+            MYLOG_ERROR("[MyContext] 订阅回调异常({}): {}", slot.name, e.what());
+        }
+    }
+}
+
+// ============================================================================
+// 写入 / 注册
+// ============================================================================
+
+bool MyContext::Set(const std::string& name, const nlohmann::json& value,
+                    const std::string& description) {
+    return SetValue(name, FromJson(value), description);
+}
+
 bool MyContext::SetBool(const std::string& name, bool value, const std::string& description) {
-    return Set(name, nlohmann::json(value), description);
+    return SetValue(name, PendingValue{ContextValueType::Boolean, true, value ? 1 : 0, nullptr}, description);
 }
 
 bool MyContext::SetInt(const std::string& name, int64_t value, const std::string& description) {
-    return Set(name, nlohmann::json(value), description);
+    return SetValue(name, PendingValue{ContextValueType::Integer, true, value, nullptr}, description);
 }
 
 bool MyContext::SetDouble(const std::string& name, double value, const std::string& description) {
-    return Set(name, nlohmann::json(value), description);
+    return SetValue(name, PendingValue{ContextValueType::Double, true, DoubleToBits(value), nullptr}, description);
 }
 
 bool MyContext::SetString(const std::string& name, const std::string& value,
@@ -147,17 +552,19 @@ bool MyContext::UpdateValue(const std::string& name, const nlohmann::json& value
         return false;
     }
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = entries_.find(name);
-        if (it == entries_.end()) {
+        SlotPtr slot;
+        {
+            const Shard& shard = ShardFor(name);
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.slots.find(name);
+            if (it != shard.slots.end()) slot = it->second;
+        }
+        if (!slot) {
             error_out = "上下文不存在: " + name;
             return false;
         }
-        it->second.value = value;
-        it->second.type = DeduceType(value);
-        it->second.updated_at_ms = NowMs();
-        MYLOG_INFO("[MyContext] 修改上下文值: {} (type={})", name, TypeToString(it->second.type));
-        return true;
+        const PendingValue v = FromJson(value);
+        return WriteSlot(*slot, &v, nullptr, true, &error_out);
     } catch (const std::exception& e) {
         error_out = e.what();
         MYLOG_ERROR("[MyContext] UpdateValue 异常: {}", e.what());
@@ -172,15 +579,18 @@ bool MyContext::UpdateDescription(const std::string& name, const std::string& de
         return false;
     }
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = entries_.find(name);
-        if (it == entries_.end()) {
+        SlotPtr slot;
+        {
+            const Shard& shard = ShardFor(name);
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.slots.find(name);
+            if (it != shard.slots.end()) slot = it->second;
+        }
+        if (!slot) {
             error_out = "上下文不存在: " + name;
             return false;
         }
-        it->second.description = description;
-        it->second.updated_at_ms = NowMs();
-        return true;
+        return WriteSlot(*slot, nullptr, &description, true, &error_out);
     } catch (const std::exception& e) {
         error_out = e.what();
         MYLOG_ERROR("[MyContext] UpdateDescription 异常: {}", e.what());
@@ -194,8 +604,8 @@ bool MyContext::UpdateDescription(const std::string& name, const std::string& de
 
 bool MyContext::Has(const std::string& name) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return entries_.find(name) != entries_.end();
+        detail::ContextSlot* slot = LookupForRead(name);
+        return slot && ReadScalar(*slot).present;
     } catch (const std::exception& e) {
         MYLOG_ERROR("[MyContext] Has 异常: {}", e.what());
         return false;
@@ -204,10 +614,19 @@ bool MyContext::Has(const std::string& name) const {
 
 bool MyContext::GetEntry(const std::string& name, ContextEntry& out) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = entries_.find(name);
-        if (it == entries_.end()) return false;
-        out = it->second;
+        const Shard& shard = ShardFor(name);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        detail::ContextSlot* slot = FindLocked(shard, name);
+        if (!slot) return false;
+        std::lock_guard<std::mutex> slot_lock(slot->mutex);
+        if (!slot->present.load(std::memory_order_relaxed)) return false;
+        out.name = slot->name;
+        out.value = ValueLocked(*slot);
+        out.description = slot->description;
+        out.type = static_cast<ContextValueType>(slot->type.load(std::memory_order_relaxed));
+        out.created_at_ms = slot->created_at_ms;
+        out.updated_at_ms = slot->updated_at_ms;
+        out.version = slot->version.load(std::memory_order_relaxed);
         return true;
     } catch (const std::exception& e) {
         MYLOG_ERROR("[MyContext] GetEntry 异常: {}", e.what());
@@ -217,10 +636,13 @@ bool MyContext::GetEntry(const std::string& name, ContextEntry& out) const {
 
 bool MyContext::GetValue(const std::string& name, nlohmann::json& out) const {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = entries_.find(name);
-        if (it == entries_.end()) return false;
-        out = it->second.value;
+        const Shard& shard = ShardFor(name);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        detail::ContextSlot* slot = FindLocked(shard, name);
+        if (!slot) return false;
+        std::lock_guard<std::mutex> slot_lock(slot->mutex);
+        if (!slot->present.load(std::memory_order_relaxed)) return false;
+        out = ValueLocked(*slot);
         return true;
     } catch (const std::exception& e) {
         MYLOG_ERROR("[MyContext] GetValue 异常: {}", e.what());
@@ -229,71 +651,133 @@ bool MyContext::GetValue(const std::string& name, nlohmann::json& out) const {
 }
 
 bool MyContext::GetBool(const std::string& name, bool default_value) const {
-    nlohmann::json v;
-    if (!GetValue(name, v)) return default_value;
     try {
-        if (v.is_boolean()) return v.get<bool>();
-        if (v.is_number()) return v.get<double>() != 0.0;
-        if (v.is_string()) {
-            std::string s = v.get<std::string>();
-            return s == "true" || s == "1";
-        }
+        detail::ContextSlot* slot = LookupForRead(name);
+        return slot ? SlotGetBool(*slot, default_value) : default_value;
     } catch (const std::exception& e) {
-        MYLOG_WARN("[MyContext] GetBool 转换失败({}): {}", name, e.what());
+        MYLOG_ERROR("[MyContext] GetBool 异常: {}", e.what());
+        return default_value;
     }
-    return default_value;
 }
 
 int64_t MyContext::GetInt(const std::string& name, int64_t default_value) const {
-    nlohmann::json v;
-    if (!GetValue(name, v)) return default_value;
     try {
-        if (v.is_number()) return static_cast<int64_t>(v.get<double>());
-        if (v.is_boolean()) return v.get<bool>() ? 1 : 0;
-        if (v.is_string()) return static_cast<int64_t>(std::stoll(v.get<std::string>()));
+        detail::ContextSlot* slot = LookupForRead(name);
+        return slot ? SlotGetInt(*slot, default_value) : default_value;
     } catch (const std::exception& e) {
-        MYLOG_WARN("[MyContext] GetInt 转换失败({}): {}", name, e.what());
+        MYLOG_ERROR("[MyContext] GetInt 异常: {}", e.what());
+        return default_value;
     }
-    return default_value;
 }
 
 double MyContext::GetDouble(const std::string& name, double default_value) const {
-    nlohmann::json v;
-    if (!GetValue(name, v)) return default_value;
     try {
-        if (v.is_number()) return v.get<double>();
-        if (v.is_boolean()) return v.get<bool>() ? 1.0 : 0.0;
-        if (v.is_string()) return std::stod(v.get<std::string>());
+        detail::ContextSlot* slot = LookupForRead(name);
+        return slot ? SlotGetDouble(*slot, default_value) : default_value;
     } catch (const std::exception& e) {
-        MYLOG_WARN("[MyContext] GetDouble 转换失败({}): {}", name, e.what());
+        MYLOG_ERROR("[MyContext] GetDouble 异常: {}", e.what());
+        return default_value;
     }
-    return default_value;
 }
 
 std::string MyContext::GetString(const std::string& name, const std::string& default_value) const {
-    nlohmann::json v;
-    if (!GetValue(name, v)) return default_value;
     try {
-        if (v.is_string()) return v.get<std::string>();
-        return v.dump();
+        detail::ContextSlot* slot = LookupForRead(name);
+        return slot ? SlotGetString(*slot, default_value) : default_value;
     } catch (const std::exception& e) {
-        MYLOG_WARN("[MyContext] GetString 转换失败({}): {}", name, e.what());
+        MYLOG_ERROR("[MyContext] GetString 异常: {}", e.what());
+        return default_value;
+    }
+}
+
+// ============================================================================
+// 预解析句柄 / 变更订阅
+// ============================================================================
+
+ContextHandle MyContext::Resolve(const std::string& name) {
+    if (name.empty()) {
+        MYLOG_WARN("[MyContext] Resolve 失败: name 不能为空");
+        return ContextHandle();
+    }
+    try {
+        return ContextHandle(GetOrCreateSlot(name));
+    } catch (const std::exception& e) {
+        MYLOG_ERROR("[MyContext] Resolve 异常: {}", e.what());
+        return ContextHandle();
     }
-    return default_value;
+}
+
+uint64_t MyContext::Subscribe(const std::string& pattern, ContextSubscriber callback) {
+    if (pattern.empty() || !callback) {
+        MYLOG_WARN("[MyContext] Subscribe 失败: pattern 与 callback 不能为空");
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(sub_mutex_);
+    auto next = subscriptions_ ? std::make_shared<std::vector<Subscription>>(*subscriptions_)
+                               : std::make_shared<std::vector<Subscription>>();
+    const uint64_t id = next_subscription_id_++;
+    next->push_back({id, pattern, std::move(callback)});
+    subscription_count_.store(next->size(), std::memory_order_release);
+    std::atomic_store(&subscriptions_, std::shared_ptr<const std::vector<Subscription>>(std::move(next)));
+    MYLOG_INFO("[MyContext] 新增订阅 #{}: {}", id, pattern);
+    return id;
+}
+
+bool MyContext::Unsubscribe(uint64_t id) {
+    std::lock_guard<std::mutex> lock(sub_mutex_);
+    if (!subscriptions_) return false;
+    auto next = std::make_shared<std::vector<Subscription>>(*subscriptions_);
+    auto it = std::find_if(next->begin(), next->end(), [id](const Subscription& s) { return s.id == id; });
+    if (it == next->end()) return false;
+    next->erase(it);
+    subscription_count_.store(next->size(), std::memory_order_release);
+    std::atomic_store(&subscriptions_, std::shared_ptr<const std::vector<Subscription>>(std::move(next)));
+    return true;
 }
 
 // ============================================================================
 // 删除 / 清空 / 统计
 // ============================================================================
 
+namespace {
+
+/// 标记记录为已删除（调用者持有分片写锁），返回此前是否存在
+bool MarkErased(detail::ContextSlot& slot) {
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (!slot.present.load(std::memory_order_relaxed)) return false;
+    {
+        SeqWrite write(slot);
+        slot.present.store(false, std::memory_order_relaxed);
+        slot.scalar.store(false, std::memory_order_relaxed);
+        slot.type.store(static_cast<uint8_t>(ContextValueType::Null), std::memory_order_relaxed);
+        slot.bits.store(0, std::memory_order_relaxed);
+    }
+    slot.value = nullptr;
+    slot.description.clear();
+    slot.version.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+}  // namespace
+
 bool MyContext::Erase(const std::string& name) {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        const bool erased = entries_.erase(name) > 0;
-        if (erased) {
-            MYLOG_INFO("[MyContext] 删除上下文: {}", name);
+        SlotPtr erased;
+        {
+            Shard& shard = ShardFor(name);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.slots.find(name);
+            if (it == shard.slots.end()) return false;
+            if (MarkErased(*it->second)) erased = it->second;
+            // 没有句柄 / 读缓存引用的槽位直接释放；否则保留，重新写入后引用方继续可用
+            if (it->second.use_count() == (erased ? 2 : 1)) shard.slots.erase(it);
         }
-        return erased;
+        if (!erased) return false;
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        version_.fetch_add(1, std::memory_order_acq_rel);
+        MYLOG_INFO("[MyContext] 删除上下文: {}", name);
+        Notify(*erased, ContextChange::Kind::Erase);
+        return true;
     } catch (const std::exception& e) {
         MYLOG_ERROR("[MyContext] Erase 异常: {}", e.what());
         return false;
@@ -302,22 +786,30 @@ bool MyContext::Erase(const std::string& name) {
 
 void MyContext::Clear() {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        entries_.clear();
+        std::vector<SlotPtr> erased;
+        for (auto& shard : shards_) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            for (auto it = shard.slots.begin(); it != shard.slots.end();) {
+                const bool was_present = MarkErased(*it->second);
+                if (was_present) erased.push_back(it->second);
+                if (it->second.use_count() == (was_present ? 2 : 1)) {
+                    it = shard.slots.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        size_.fetch_sub(erased.size(), std::memory_order_relaxed);
+        version_.fetch_add(1, std::memory_order_acq_rel);
         MYLOG_INFO("[MyContext] 已清空全部上下文");
+        for (auto& slot : erased) Notify(*slot, ContextChange::Kind::Erase);
     } catch (const std::exception& e) {
         MYLOG_ERROR("[MyContext] Clear 异常: {}", e.what());
     }
 }
 
 std::size_t MyContext::Size() const {
-    try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return entries_.size();
-    } catch (const std::exception& e) {
-        MYLOG_ERROR("[MyContext] Size 异常: {}", e.what());
-        return 0;
-    }
+    return size_.load(std::memory_order_relaxed);
 }
 
 // ============================================================================
@@ -328,11 +820,22 @@ nlohmann::json MyContext::GetAllJson() const {
     nlohmann::json items = nlohmann::json::array();
     try {
         std::vector<ContextEntry> snapshot;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            snapshot.reserve(entries_.size());
-            for (const auto& kv : entries_) {
-                snapshot.push_back(kv.second);
+        snapshot.reserve(Size());
+        for (const auto& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (const auto& kv : shard.slots) {
+                detail::ContextSlot& slot = *kv.second;
+                std::lock_guard<std::mutex> slot_lock(slot.mutex);
+                if (!slot.present.load(std::memory_order_relaxed)) continue;
+                ContextEntry entry;
+                entry.name = slot.name;
+                entry.value = ValueLocked(slot);
+                entry.description = slot.description;
+                entry.type = static_cast<ContextValueType>(slot.type.load(std::memory_order_relaxed));
+                entry.created_at_ms = slot.created_at_ms;
+                entry.updated_at_ms = slot.updated_at_ms;
+                entry.version = slot.version.load(std::memory_order_relaxed);
+                snapshot.push_back(std::move(entry));
             }
         }
         std::sort(snapshot.begin(), snapshot.end(),
@@ -345,6 +848,7 @@ nlohmann::json MyContext::GetAllJson() const {
     }
     nlohmann::json out;
     out["count"] = items.size();
+    out["version"] = Version();
     out["items"] = items;
     return out;
 }
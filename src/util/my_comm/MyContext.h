@@ -14,16 +14,28 @@
  *   - type        值类型（由 value 自动推导）
  *   - created/updated_at_ms  创建/更新时间戳（毫秒）
  *
- * 值统一使用 nlohmann::json 承载，以支持多种数据类型；所有读写操作均加锁，
- * 可在多线程环境下安全使用。配套的 REST API 见
- * src/util/my_api/controller/context/ContextController。
+ * 读多写少的存储结构：
+ *   - 记录按 name 哈希分散到 kShardCount 个分片，每个分片一把读写锁；按名字读取标量时
+ *     先查线程本地的 name -> 槽位缓存，命中时不加锁，未命中才持有分片读锁；
+ *   - bool / 整数 / 浮点值存放在记录内的原子字段中（seqlock 保护），读取不构造、不拷贝 JSON；
+ *     字符串 / 对象 / 数组仍用 nlohmann::json 承载；
+ *   - Resolve() 返回预解析句柄，热点键通过句柄读取完全无锁；
+ *   - 每条记录带版本号（写入次数），全局另有变更计数 Version()；
+ *   - Subscribe() 按名字或前缀订阅变更通知。
+ * 配套的 REST API 见 src/util/my_api/controller/context/ContextController。
  */
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -52,15 +64,70 @@ struct ContextEntry {
     ContextValueType type{ContextValueType::Null};   ///< 值类型
     int64_t created_at_ms{0};                        ///< 创建时间戳（毫秒）
     int64_t updated_at_ms{0};                        ///< 最近更新时间戳（毫秒）
+    uint64_t version{0};                             ///< 记录版本（值或解释每修改一次加一）
 
     /// 序列化为 JSON 对象
     nlohmann::json ToJson() const;
 };
 
+/**
+ * @brief 上下文变更通知
+ */
+struct ContextChange {
+    enum class Kind { Set, Erase };
+
+    Kind kind{Kind::Set};
+    std::string name;
+    nlohmann::json value;                            ///< 新值（Erase 时为 null）
+    ContextValueType type{ContextValueType::Null};
+    uint64_t version{0};                             ///< 变更后的记录版本
+};
+
+using ContextSubscriber = std::function<void(const ContextChange& change)>;
+
+namespace detail {
+struct ContextSlot;
+}  // namespace detail
+
+/**
+ * @brief 预解析的上下文句柄
+ *
+ * 由 MyContext::Resolve() 获得，绑定到一条记录（记录不存在时也可解析，之后写入即可见）。
+ * 通过句柄读取 bool / 整数 / 浮点值不加锁、不查表；记录被 Erase 后句柄读到默认值，
+ * 重新写入后恢复。句柄可拷贝，可跨线程使用。
+ */
+class ContextHandle {
+public:
+    ContextHandle() = default;
+
+    bool Valid() const { return slot_ != nullptr; }
+    const std::string& Name() const;
+
+    bool Has() const;
+    bool GetBool(bool default_value = false) const;
+    int64_t GetInt(int64_t default_value = 0) const;
+    double GetDouble(double default_value = 0.0) const;
+    std::string GetString(const std::string& default_value = "") const;
+    /// 记录版本；记录不存在时返回最近一次的版本
+    uint64_t Version() const;
+
+    bool SetBool(bool value);
+    bool SetInt(int64_t value);
+    bool SetDouble(double value);
+    bool SetString(const std::string& value);
+    bool Set(const nlohmann::json& value);
+
+private:
+    friend class MyContext;
+    explicit ContextHandle(std::shared_ptr<detail::ContextSlot> slot) : slot_(std::move(slot)) {}
+
+    std::shared_ptr<detail::ContextSlot> slot_;
+};
+
 /**
  * @brief 运行时上下文单例
  *
- * 线程安全：所有公共方法内部均通过互斥锁保护，可在任意线程调用。
+ * 线程安全：所有公共方法均可在任意线程调用；读取只持有分片读锁或完全无锁。
  * 异常安全：所有方法均做了防御性处理，不会向外抛出异常导致进程崩溃。
  */
 class MyContext {
@@ -104,6 +171,24 @@ public:
     double GetDouble(const std::string& name, double default_value = 0.0) const;
     std::string GetString(const std::string& name, const std::string& default_value = "") const;
 
+    // ------------------------------------------------------------------
+    // 预解析句柄 / 变更订阅 / 版本
+    // ------------------------------------------------------------------
+    /// 解析热点键；记录不存在时同样返回有效句柄，name 为空时返回无效句柄
+    ContextHandle Resolve(const std::string& name);
+
+    /**
+     * @brief 订阅变更
+     * @param pattern 精确名字、"prefix*" 前缀或 "*"（全部）
+     * @param callback 在写入线程中同步调用（不持有任何内部锁），应尽快返回
+     * @return 订阅 ID（从 1 开始）；参数非法返回 0
+     */
+    uint64_t Subscribe(const std::string& pattern, ContextSubscriber callback);
+    bool Unsubscribe(uint64_t id);
+
+    /// 全局变更计数：任意记录被写入 / 删除时递增，可用于判断缓存是否过期
+    uint64_t Version() const { return version_.load(std::memory_order_acquire); }
+
     // ------------------------------------------------------------------
     // 删除 / 清空 / 统计
     // ------------------------------------------------------------------
@@ -122,18 +207,74 @@ public:
     /// 类型枚举转字符串
     static const char* TypeToString(ContextValueType type);
 
+    static constexpr std::size_t kShardCount = 16;
+    static constexpr std::size_t kReadCacheCapacity = 1024;   ///< 每个线程缓存的名字数上限
+
 private:
+    friend class ContextHandle;
+
     MyContext() = default;
     ~MyContext() = default;
 
+    using SlotPtr = std::shared_ptr<detail::ContextSlot>;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, SlotPtr> slots;   ///< 含已删除但仍被句柄引用的记录
+    };
+
+    struct Subscription {
+        uint64_t id{0};
+        std::string pattern;
+        ContextSubscriber callback;
+    };
+
     static ContextValueType DeduceType(const nlohmann::json& value);
     static int64_t NowMs();
+    static bool MatchPattern(const std::string& pattern, const std::string& name);
+
+    Shard& ShardFor(const std::string& name) const;
+    /// 查找记录（调用者持有分片锁）；不存在或已删除返回 nullptr
+    static detail::ContextSlot* FindLocked(const Shard& shard, const std::string& name);
+    /// 找到或创建记录槽位
+    SlotPtr GetOrCreateSlot(const std::string& name);
+    /**
+     * @brief 读路径查找：先查线程本地缓存，未命中时持分片读锁查表并缓存
+     *
+     * 缓存持有槽位引用，被缓存的槽位在 Erase 后只标记删除、不会从分片移除，
+     * 因此缓存项始终指向该名字当前的槽位，命中时无需任何锁。
+     * @return 槽位不存在返回 nullptr（是否已删除由调用方检查）
+     */
+    detail::ContextSlot* LookupForRead(const std::string& name) const;
+
+    /// 待写入的值：标量以 bits 承载（不构造 JSON），其余类型指向调用方的 JSON
+    struct PendingValue {
+        ContextValueType type{ContextValueType::Null};
+        bool scalar{false};
+        int64_t bits{0};
+        const nlohmann::json* json{nullptr};
+    };
+    static PendingValue FromJson(const nlohmann::json& value);
+
+    /**
+     * @brief 写入槽位
+     * @param value 为空指针时只更新 description
+     * @param description 为空指针时保留原解释
+     * @param require_present 为 true 时记录必须已存在，否则写入 error_out 并返回 false
+     */
+    bool WriteSlot(detail::ContextSlot& slot, const PendingValue* value, const std::string* description,
+                   bool require_present, std::string* error_out);
+    bool SetValue(const std::string& name, const PendingValue& value, const std::string& description);
+    void Notify(detail::ContextSlot& slot, ContextChange::Kind kind);
 
-    /// upsert 内部实现（调用者必须已持有 mutex_）
-    bool SetLocked(const std::string& name, const nlohmann::json& value, const std::string& description);
+    mutable std::array<Shard, kShardCount> shards_;
+    std::atomic<std::size_t> size_{0};
+    std::atomic<uint64_t> version_{0};
 
-    mutable std::mutex mutex_;
-    std::unordered_map<std::string, ContextEntry> entries_;
+    std::mutex sub_mutex_;
+    std::shared_ptr<const std::vector<Subscription>> subscriptions_;   ///< 写时复制
+    std::atomic<std::size_t> subscription_count_{0};
+    uint64_t next_subscription_id_{1};
 };
 
 }  // namespace my_comm
@@ -1,6 +1,8 @@
 #include "TaskQueue.h"
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
 #include <utility>
 
 namespace my_control {
@@ -17,52 +19,194 @@ TaskQueue::~TaskQueue() {
   MYLOG_INFO("[TaskQueue:{}] 析构完成", name_);
 }
 
+my_data::TimestampMs TaskQueue::DeadlineSortValue(my_data::TimestampMs deadline_at_ms) {
+  // 无截止时间的任务排在同优先级、有截止时间的任务之后
+  return deadline_at_ms > 0 ? deadline_at_ms : std::numeric_limits<my_data::TimestampMs>::max();
+}
+
+std::int64_t TaskQueue::SteadyNowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 void TaskQueue::Push(const my_data::Task& task) {
+  Push(my_data::Task(task));
+}
+
+void TaskQueue::Push(my_data::Task&& task) {
   {
     std::lock_guard<std::mutex> lk(mu_);
     if (shutdown_) {
       MYLOG_WARN("[TaskQueue:{}] Push 被拒绝：队列已 shutdown。task_id={}", name_, task.task_id);
       return;
     }
-    q_.push_back(task);
-    MYLOG_INFO("[TaskQueue:{}] Push 成功：task_id={}, device_id={}, size={}",
-               name_, task.task_id, task.device_id, q_.size());
+
+    const Key key{-task.priority, DeadlineSortValue(task.deadline_at_ms), next_seq_++};
+    Entry entry;
+    entry.task = std::move(task);
+    entry.enqueued_steady_ms = SteadyNowMs();
+    const my_data::Task& queued = q_.emplace(key, std::move(entry)).first->second.task;
+
+    if (!queued.task_id.empty()) {
+      auto [it, inserted] = by_id_.emplace(queued.task_id, key);
+      if (!inserted) {
+        MYLOG_WARN("[TaskQueue:{}] Push：task_id={} 重复，Cancel 只作用于最新一条", name_, queued.task_id);
+        it->second = key;
+      }
+    }
+    if (queued.deadline_at_ms > 0) {
+      by_deadline_.emplace(queued.deadline_at_ms, key);
+    }
+    ++stats_.pushed;
+
+    MYLOG_INFO("[TaskQueue:{}] Push 成功：task_id={}, device_id={}, priority={}, deadline_at_ms={}, size={}",
+               name_, queued.task_id, queued.device_id, queued.priority, queued.deadline_at_ms, q_.size());
   }
   cv_.notify_one();
+
+  // 在队列锁外通知；持 listener_mu_ 保证 SetPushListener 返回后不再有进行中的回调
+  std::lock_guard<std::mutex> llk(listener_mu_);
+  if (on_push_) {
+    on_push_();
+  }
 }
 
-bool TaskQueue::PopBlocking(my_data::Task& out, int timeout_ms) {
-  std::unique_lock<std::mutex> lk(mu_);
-
-  // 1) 无限等待
-  if (timeout_ms < 0) {
-    cv_.wait(lk, [&]() { return shutdown_ || !q_.empty(); });
-  } else {
-    // 2) 超时等待
-    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
-    bool ok = cv_.wait_until(lk, deadline, [&]() { return shutdown_ || !q_.empty(); });
-    if (!ok) {
-      MYLOG_WARN("[TaskQueue:{}] PopBlocking 超时：timeout_ms={}, size={}", name_, timeout_ms, q_.size());
-      return false;
+my_data::Task TaskQueue::TakeLocked(std::map<Key, Entry>::iterator it) {
+  const my_data::Task& task = it->second.task;
+  if (!task.task_id.empty()) {
+    auto id_it = by_id_.find(task.task_id);
+    if (id_it != by_id_.end() && id_it->second == it->first) {
+      by_id_.erase(id_it);
     }
   }
+  if (task.deadline_at_ms > 0) {
+    by_deadline_.erase({task.deadline_at_ms, it->first});
+  }
+  my_data::Task out = std::move(it->second.task);
+  q_.erase(it);
+  return out;
+}
 
-  // 被唤醒后：若队列为空
-  if (q_.empty()) {
-    if (shutdown_) {
-      MYLOG_INFO("[TaskQueue:{}] PopBlocking 返回 false：队列已 shutdown 且为空", name_);
-    } else {
-      // 理论上不会走到这（因为 wait 条件是 !q_.empty()）
-      MYLOG_WARN("[TaskQueue:{}] PopBlocking 异常情况：被唤醒但队列为空且未 shutdown", name_);
+void TaskQueue::CollectExpiredLocked(my_data::TimestampMs now_ms, std::vector<my_data::Task>& expired) {
+  while (!by_deadline_.empty() && by_deadline_.begin()->first < now_ms) {
+    auto it = q_.find(by_deadline_.begin()->second);
+    if (it == q_.end()) {
+      // 理论上不会出现：索引与队列不一致时只清索引
+      by_deadline_.erase(by_deadline_.begin());
+      continue;
     }
-    return false;
+    expired.push_back(TakeLocked(it));
+    ++stats_.expired;
   }
+}
 
-  out = std::move(q_.front());
-  q_.pop_front();
+void TaskQueue::ReportExpired(std::vector<my_data::Task>& expired) {
+  if (expired.empty()) return;
+
+  ExpiredPolicy policy;
+  ExpiredCallback cb;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    policy = expired_policy_;
+    cb = on_expired_;
+  }
 
-  MYLOG_INFO("[TaskQueue:{}] Pop 成功：task_id={}, device_id={}, size={}",
-             name_, out.task_id, out.device_id, q_.size());
+  const my_data::TimestampMs now_ms = my_data::NowMs();
+  for (auto& task : expired) {
+    MYLOG_WARN("[TaskQueue:{}] 任务已过截止时间，未执行即移出：task_id={}, deadline_at_ms={}, 过期 {} ms",
+               name_, task.task_id, task.deadline_at_ms, now_ms - task.deadline_at_ms);
+    if (policy != ExpiredPolicy::Fail || !cb) continue;
+
+    task.state = my_data::TaskState::Failed;
+    my_data::TaskResult result;
+    result.code = my_data::ErrorCode::Timeout;
+    result.message = "deadline exceeded before execution";
+    result.finished_at_ms = now_ms;
+    try {
+      cb(task, result);
+    } catch (const std::exception& e) {
+      MYLOG_ERROR("[TaskQueue:{}] 过期回调异常：task_id={}, err={}", name_, task.task_id, e.what());
+    } catch (...) {
+      MYLOG_ERROR("[TaskQueue:{}] 过期回调未知异常：task_id={}", name_, task.task_id);
+    }
+  }
+  expired.clear();
+}
+
+bool TaskQueue::PopBlocking(my_data::Task& out, int timeout_ms) {
+  return PopBlocking(out, timeout_ms, nullptr);
+}
+
+bool TaskQueue::PopBlocking(my_data::Task& out, int timeout_ms, PopInfo* info) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+  std::vector<my_data::Task> expired;
+
+  for (;;) {
+    std::unique_lock<std::mutex> lk(mu_);
+
+    // 1) 无限等待
+    if (timeout_ms < 0) {
+      cv_.wait(lk, [&]() { return shutdown_ || !q_.empty(); });
+    } else {
+      // 2) 超时等待
+      bool ok = cv_.wait_until(lk, deadline, [&]() { return shutdown_ || !q_.empty(); });
+      if (!ok) {
+        lk.unlock();
+        ReportExpired(expired);
+        MYLOG_DEBUG("[TaskQueue:{}] PopBlocking 超时：timeout_ms={}", name_, timeout_ms);
+        return false;
+      }
+    }
+
+    // 3) 先移出已过截止时间的任务
+    CollectExpiredLocked(my_data::NowMs(), expired);
+
+    // 被唤醒后：若队列为空
+    if (q_.empty()) {
+      if (shutdown_) {
+        lk.unlock();
+        ReportExpired(expired);
+        MYLOG_INFO("[TaskQueue:{}] PopBlocking 返回 false：队列已 shutdown 且为空", name_);
+        return false;
+      }
+      // 只剩过期任务被清掉：在锁外上报后继续等待
+      lk.unlock();
+      ReportExpired(expired);
+      continue;
+    }
+
+    auto it = q_.begin();
+    const std::int64_t wait_ms = SteadyNowMs() - it->second.enqueued_steady_ms;
+    out = TakeLocked(it);
+
+    ++stats_.popped;
+    stats_.total_wait_ms += wait_ms;
+    stats_.max_wait_ms = std::max(stats_.max_wait_ms, wait_ms);
+    if (info) info->queue_wait_ms = wait_ms;
+
+    MYLOG_INFO("[TaskQueue:{}] Pop 成功：task_id={}, device_id={}, priority={}, queue_wait_ms={}, size={}",
+               name_, out.task_id, out.device_id, out.priority, wait_ms, q_.size());
+    lk.unlock();
+    ReportExpired(expired);
+    return true;
+  }
+}
+
+bool TaskQueue::Cancel(const my_data::TaskId& task_id) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto id_it = by_id_.find(task_id);
+  if (id_it == by_id_.end()) {
+    MYLOG_WARN("[TaskQueue:{}] Cancel 未命中：task_id={} 不在队列中", name_, task_id);
+    return false;
+  }
+  auto it = q_.find(id_it->second);
+  if (it == q_.end()) {
+    by_id_.erase(id_it);
+    return false;
+  }
+  TakeLocked(it);
+  ++stats_.cancelled;
+  MYLOG_INFO("[TaskQueue:{}] Cancel 成功：task_id={}, size={}", name_, task_id, q_.size());
   return true;
 }
 
@@ -75,6 +219,8 @@ void TaskQueue::Clear() {
   std::lock_guard<std::mutex> lk(mu_);
   std::size_t n = q_.size();
   q_.clear();
+  by_id_.clear();
+  by_deadline_.clear();
   MYLOG_WARN("[TaskQueue:{}] Clear：清空 {} 条待执行任务", name_, n);
 }
 
@@ -93,4 +239,34 @@ bool TaskQueue::IsShutdown() const {
   return shutdown_;
 }
 
-} // namespace my_control
\ No newline at end of file
+void TaskQueue::SetExpiredPolicy(ExpiredPolicy policy) {
+  std::lock_guard<std::mutex> lk(mu_);
+  expired_policy_ = policy;
+}
+
+void TaskQueue::SetExpiredCallback(ExpiredCallback cb) {
+  std::lock_guard<std::mutex> lk(mu_);
+  on_expired_ = std::move(cb);
+}
+
+void TaskQueue::SetPushListener(PushListener cb) {
+  std::lock_guard<std::mutex> lk(listener_mu_);
+  on_push_ = std::move(cb);
+}
+
+nlohmann::json TaskQueue::GetStatsJson() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return nlohmann::json{
+      {"name", name_},
+      {"size", q_.size()},
+      {"pushed", stats_.pushed},
+      {"popped", stats_.popped},
+      {"cancelled", stats_.cancelled},
+      {"expired", stats_.expired},
+      {"avg_wait_ms", stats_.popped ? stats_.total_wait_ms / static_cast<std::int64_t>(stats_.popped) : 0},
+      {"max_wait_ms", stats_.max_wait_ms},
+      {"expired_policy", expired_policy_ == ExpiredPolicy::Fail ? "fail" : "drop"},
+  };
+}
+
+} // namespace my_control
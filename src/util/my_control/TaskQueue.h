@@ -2,9 +2,17 @@
 
 #include <condition_variable>
 #include <cstddef>
-#include <deque>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <mutex>
+#include <set>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
 
 #include "MyData.h"
 #include "MyLog.h"
@@ -13,20 +21,52 @@ namespace my_control {
 
 using namespace my_data;
 /**
- * @brief 线程安全任务队列（MVP）
+ * @brief 线程安全任务队列（按优先级 + 截止时间调度）
  *
  * @details
  * - 生产者：通常是 Edge（接收外部命令后 push task）
  * - 消费者：通常是每个 Device 的 Workflow 线程（阻塞 pop）
  *
+ * 出队顺序：
+ * - priority 大的先出
+ * - 同优先级按 deadline_at_ms 早的先出（deadline_at_ms <= 0 表示无截止时间，排在有截止时间之后）
+ * - 其余相同则按入队顺序（FIFO）
+ *
+ * 过期处理：
+ * - PopBlocking 取任务前，先把 deadline_at_ms 已过的任务移出队列，不交给执行方
+ * - ExpiredPolicy::Drop：只记日志；ExpiredPolicy::Fail：额外以 ErrorCode::Timeout 回调 ExpiredCallback
+ *
  * 语义约定：
  * - PopBlocking() 返回 false：
  *   1) timeout 到期且仍无数据（timeout_ms >= 0 时）
  *   2) 队列已 Shutdown 且队列为空
  * - Shutdown() 会唤醒所有阻塞的 PopBlocking()
+ * - Cancel(task_id) 以 O(log n) 移除尚未出队的任务
  */
 class TaskQueue {
 public:
+  enum class ExpiredPolicy {
+    Drop = 0,   // 丢弃（仅日志）
+    Fail = 1,   // 丢弃并回调失败结果
+  };
+
+  /**
+   * @brief 过期任务回调（在锁外、PopBlocking 所在线程触发）
+   */
+  using ExpiredCallback = std::function<void(const my_data::Task&, const my_data::TaskResult&)>;
+
+  /**
+   * @brief 入队通知（Push 成功后在锁外、Push 所在线程触发），用于事件驱动的消费方
+   */
+  using PushListener = std::function<void()>;
+
+  /**
+   * @brief 出队附带信息
+   */
+  struct PopInfo {
+    std::int64_t queue_wait_ms{0};   // 入队到出队的等待时间
+  };
+
   TaskQueue();
   explicit TaskQueue(std::string name);
   ~TaskQueue();
@@ -39,6 +79,11 @@ public:
    */
   void Push(const my_data::Task& task);
 
+  /**
+   * @brief 移动入队，热路径上避免复制 Task
+   */
+  void Push(my_data::Task&& task);
+
   /**
    * @brief 阻塞出队
    * @param out 出队的 Task
@@ -47,6 +92,17 @@ public:
    */
   bool PopBlocking(my_data::Task& out, int timeout_ms = -1);
 
+  /**
+   * @brief 阻塞出队，并返回该任务的排队等待时间
+   */
+  bool PopBlocking(my_data::Task& out, int timeout_ms, PopInfo* info);
+
+  /**
+   * @brief 按 task_id 取消尚未出队的任务
+   * @return 是否找到并移除
+   */
+  bool Cancel(const my_data::TaskId& task_id);
+
   /**
    * @brief 队列长度（线程安全）
    */
@@ -67,18 +123,72 @@ public:
    */
   bool IsShutdown() const;
 
+  /**
+   * @brief 过期处理策略（默认 Fail；未注册回调时与 Drop 相同）
+   */
+  void SetExpiredPolicy(ExpiredPolicy policy);
+
+  /**
+   * @brief 过期任务回调（ExpiredPolicy::Fail 时触发），传空函数表示取消注册
+   */
+  void SetExpiredCallback(ExpiredCallback cb);
+
+  /**
+   * @brief 入队通知，传空函数表示取消注册；返回后保证不再有进行中的通知
+   */
+  void SetPushListener(PushListener cb);
+
+  /**
+   * @brief 统计信息：入队/出队/取消/过期次数，排队等待时间平均值与最大值
+   */
+  nlohmann::json GetStatsJson() const;
+
   /**
    * @brief 队列名字（用于日志与定位）
    */
   const std::string& Name() const { return name_; }
 
 private:
+  // 排序键：(-priority, deadline 排序值, 入队序号)
+  using Key = std::tuple<int, my_data::TimestampMs, std::uint64_t>;
+
+  struct Entry {
+    my_data::Task task;
+    std::int64_t enqueued_steady_ms{0};
+  };
+
+  struct Stats {
+    std::uint64_t pushed{0};
+    std::uint64_t popped{0};
+    std::uint64_t cancelled{0};
+    std::uint64_t expired{0};
+    std::int64_t total_wait_ms{0};
+    std::int64_t max_wait_ms{0};
+  };
+
+  static my_data::TimestampMs DeadlineSortValue(my_data::TimestampMs deadline_at_ms);
+  static std::int64_t SteadyNowMs();
+
+  my_data::Task TakeLocked(std::map<Key, Entry>::iterator it);   // 移出任务并同步清理索引
+  void CollectExpiredLocked(my_data::TimestampMs now_ms, std::vector<my_data::Task>& expired);
+  void ReportExpired(std::vector<my_data::Task>& expired);
+
   std::string name_;
 
   mutable std::mutex mu_;         // 保护队列与状态
   std::condition_variable cv_;    // 用于阻塞等待
-  std::deque<my_data::Task> q_;   // 任务队列
+  std::map<Key, Entry> q_;        // 调度顺序
+  std::unordered_map<my_data::TaskId, Key> by_id_;   // task_id -> 排序键（取消用）
+  std::set<std::pair<my_data::TimestampMs, Key>> by_deadline_;   // 有截止时间的任务，按截止时间排序
+  std::uint64_t next_seq_{0};
   bool shutdown_{false};          // 是否已关闭
+
+  ExpiredPolicy expired_policy_{ExpiredPolicy::Fail};
+  ExpiredCallback on_expired_{};
+
+  std::mutex listener_mu_;        // 串行化入队通知与 SetPushListener
+  PushListener on_push_{};
+  Stats stats_{};
 };
 
-} // namespace my_control
\ No newline at end of file
+} // namespace my_control
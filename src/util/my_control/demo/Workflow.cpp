@@ -1,6 +1,5 @@
 #include "Workflow.h"
 
-#include <chrono>
 #include <utility>
 
 namespace my_control::demo {
@@ -23,102 +22,157 @@ bool Workflow::Start() {
   }
   stop_ = false;
 
-  MYLOG_INFO("[Workflow:{}] 启动线程", name_);
-  worker_ = std::thread(&Workflow::RunLoop, this);
+  // 过期任务不会交给 DoTask，通过 on_finish 上报 Timeout，保证每个任务都有结果
+  queue_.SetExpiredCallback([this](const my_data::Task& task, const my_data::TaskResult& result) {
+    if (on_finish_) on_finish_(task, result);
+  });
+
+  // 不再独占线程：有任务入队时才向共享执行器投递 drain 任务
+  queue_.SetPushListener([this]() { ScheduleDrain(); });
+
+  MYLOG_INFO("[Workflow:{}] 启动：运行在共享执行器 workflow 子系统", name_);
+  ScheduleDrain();   // Start 前已入队的任务
   return true;
 }
 
 void Workflow::Stop() {
   if (!running_.load()) return;
 
-  stop_ = true;
-  MYLOG_WARN("[Workflow:{}] Stop：请求停止线程", name_);
+  {
+    std::lock_guard<std::mutex> lk(drain_mu_);
+    stop_ = true;
+  }
+  MYLOG_WARN("[Workflow:{}] Stop：请求停止", name_);
 
   // 注意：queue 实例归 Edge，通常由 Edge 在全局 shutdown 时调用 queue.Shutdown()
   // 这里不强制 shutdown queue，以保持“队列归属”边界清晰。
 }
 
 void Workflow::Join() {
-  if (worker_.joinable()) {
-    MYLOG_INFO("[Workflow:{}] Join：等待线程回收...", name_);
-    worker_.join();
-    MYLOG_INFO("[Workflow:{}] Join：线程已回收", name_);
+  if (!running_.load()) return;
+
+  MYLOG_INFO("[Workflow:{}] Join：等待进行中的任务结束...", name_);
+  queue_.SetPushListener(nullptr);
+
+  my_executor::TimerId retry_timer = 0;
+  {
+    std::lock_guard<std::mutex> lk(drain_mu_);
+    retry_timer = estop_retry_timer_;
+    estop_retry_timer_ = 0;
   }
+  if (retry_timer != 0) {
+    my_executor::MyExecutor::GetInstance().CancelTimer(retry_timer, true);
+  }
+
+  {
+    std::unique_lock<std::mutex> lk(drain_mu_);
+    drain_cv_.wait(lk, [this]() { return !drain_scheduled_; });
+  }
+  queue_.SetExpiredCallback(nullptr);
   running_ = false;
+  MYLOG_INFO("[Workflow:{}] Join：已停止", name_);
 }
 
-void Workflow::RunLoop() {
-  MYLOG_INFO("[Workflow:{}] RunLoop 进入", name_);
+void Workflow::ScheduleDrain() {
+  std::lock_guard<std::mutex> lk(drain_mu_);
+  if (stop_.load() || drain_scheduled_) return;
+
+  drain_scheduled_ = true;
+  if (!my_executor::MyExecutor::GetInstance().Submit("workflow", [this]() { Drain(); })) {
+    drain_scheduled_ = false;
+    drain_cv_.notify_all();
+    MYLOG_ERROR("[Workflow:{}] 投递 drain 任务失败：执行器已停止", name_);
+  }
+}
 
+void Workflow::Drain() {
+  for (;;) {
+    const bool estop_paused = DrainQueue();
+
+    std::lock_guard<std::mutex> lk(drain_mu_);
+    // drain_scheduled_ 为 true 期间的 Push 不会另行投递，结束前复查一次
+    if (!stop_.load() && !estop_paused && queue_.Size() > 0) continue;
+
+    if (estop_paused && !stop_.load() && estop_retry_timer_ == 0) {
+      estop_retry_timer_ = my_executor::MyExecutor::GetInstance().ScheduleAfter("workflow", 200, [this]() {
+        {
+          std::lock_guard<std::mutex> tlk(drain_mu_);
+          estop_retry_timer_ = 0;
+        }
+        ScheduleDrain();
+      });
+    }
+    drain_scheduled_ = false;
+    drain_cv_.notify_all();
+    return;
+  }
+}
+
+bool Workflow::DrainQueue() {
   while (!stop_.load()) {
     // 1) EStop：不取新任务（MVP）
     if (estop_flag_ && estop_flag_->load()) {
       MYLOG_WARN("[Workflow:{}] EStop=true：暂停取新任务", name_);
-      std::this_thread::sleep_for(std::chrono::milliseconds(200));
-      continue;
+      return true;
     }
 
-    // 2) Pop：使用短超时以便响应 stop_（避免永久阻塞）
+    // 2) Pop：非阻塞，队列为空即结束本次 drain
     my_data::Task task;
-    bool ok = queue_.PopBlocking(task, /*timeout_ms*/ 1234);
-    if (!ok) {
-      // 可能是超时或 shutdown
-      if (queue_.IsShutdown()) {
-        MYLOG_WARN("[Workflow:{}] 检测到 queue shutdown，退出 RunLoop", name_);
-        break;
-      }
-      continue;
-    }
-
-    MYLOG_INFO("[Workflow:{}] 已取到任务：task_id={}, device_id={}, capability={}, action={}",
-               name_, task.task_id, task.device_id, task.capability, task.action);
-
-    // 3) on_start：Pop 成功后、DoTask 前触发
-    if (on_start_) {
-      try {
-        MYLOG_INFO("[Workflow:{}] on_start 回调触发：task_id={}", name_, task.task_id);
-        on_start_(task);
-      } catch (const std::exception& e) {
-        MYLOG_ERROR("[Workflow:{}] on_start 回调异常：task_id={}, err={}", name_, task.task_id, e.what());
-      } catch (...) {
-        MYLOG_ERROR("[Workflow:{}] on_start 回调未知异常：task_id={}", name_, task.task_id);
-      }
+    my_control::TaskQueue::PopInfo pop_info;
+    if (!queue_.PopBlocking(task, /*timeout_ms*/ 0, &pop_info)) {
+      return false;
     }
+    RunTask(task, pop_info);
+  }
+  return false;
+}
 
-    // 4) 执行
-    MYLOG_INFO("[Workflow:{}] 开始执行 task_id={}", name_, task.task_id);
+void Workflow::RunTask(const my_data::Task& task, const my_control::TaskQueue::PopInfo& pop_info) {
+  MYLOG_INFO("[Workflow:{}] 已取到任务：task_id={}, device_id={}, capability={}, action={}, priority={}, queue_wait_ms={}",
+             name_, task.task_id, task.device_id, task.capability, task.action, task.priority, pop_info.queue_wait_ms);
 
-    my_data::TaskResult result;
+  // 3) on_start：Pop 成功后、DoTask 前触发
+  if (on_start_) {
     try {
-      result = control_.DoTask(task);
+      MYLOG_INFO("[Workflow:{}] on_start 回调触发：task_id={}", name_, task.task_id);
+      on_start_(task);
     } catch (const std::exception& e) {
-      MYLOG_ERROR("[Workflow:{}] DoTask 异常：task_id={}, err={}", name_, task.task_id, e.what());
-      result.code = my_data::ErrorCode::InternalError;
-      result.message = std::string("DoTask exception: ") + e.what();
+      MYLOG_ERROR("[Workflow:{}] on_start 回调异常：task_id={}, err={}", name_, task.task_id, e.what());
     } catch (...) {
-      MYLOG_ERROR("[Workflow:{}] DoTask 未知异常：task_id={}", name_, task.task_id);
-      result.code = my_data::ErrorCode::InternalError;
-      result.message = "DoTask unknown exception";
+      MYLOG_ERROR("[Workflow:{}] on_start 回调未知异常：task_id={}", name_, task.task_id);
     }
+  }
 
-    MYLOG_INFO("[Workflow:{}] 执行完成 task_id={}, result_code={}, message={}",
-               name_, task.task_id, my_data::ToString(result.code), result.message);
-
-    // 5) on_finish：DoTask 后触发
-    if (on_finish_) {
-      try {
-        MYLOG_INFO("[Workflow:{}] on_finish 回调触发：task_id={}", name_, task.task_id);
-        on_finish_(task, result);
-      } catch (const std::exception& e) {
-        MYLOG_ERROR("[Workflow:{}] on_finish 回调异常：{}", name_, e.what());
-      } catch (...) {
-        MYLOG_ERROR("[Workflow:{}] on_finish 回调未知异常", name_);
-      }
-    }
+  // 4) 执行
+  MYLOG_INFO("[Workflow:{}] 开始执行 task_id={}", name_, task.task_id);
+
+  my_data::TaskResult result;
+  try {
+    result = control_.DoTask(task);
+  } catch (const std::exception& e) {
+    MYLOG_ERROR("[Workflow:{}] DoTask 异常：task_id={}, err={}", name_, task.task_id, e.what());
+    result.code = my_data::ErrorCode::InternalError;
+    result.message = std::string("DoTask exception: ") + e.what();
+  } catch (...) {
+    MYLOG_ERROR("[Workflow:{}] DoTask 未知异常：task_id={}", name_, task.task_id);
+    result.code = my_data::ErrorCode::InternalError;
+    result.message = "DoTask unknown exception";
   }
 
-  running_ = false;
-  MYLOG_WARN("[Workflow:{}] RunLoop 退出", name_);
+  MYLOG_INFO("[Workflow:{}] 执行完成 task_id={}, result_code={}, message={}",
+             name_, task.task_id, my_data::ToString(result.code), result.message);
+
+  // 5) on_finish：DoTask 后触发
+  if (on_finish_) {
+    try {
+      MYLOG_INFO("[Workflow:{}] on_finish 回调触发：task_id={}", name_, task.task_id);
+      on_finish_(task, result);
+    } catch (const std::exception& e) {
+      MYLOG_ERROR("[Workflow:{}] on_finish 回调异常：{}", name_, e.what());
+    } catch (...) {
+      MYLOG_ERROR("[Workflow:{}] on_finish 回调未知异常", name_);
+    }
+  }
 }
 
 } // namespace my_control::demo
\ No newline at end of file
@@ -1,24 +1,29 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
 #include <string>
-#include <thread>
 
 #include "MyData.h"
 #include "MyLog.h"
 #include "TaskQueue.h"
 #include "IControl.h"
+#include "MyExecutor.h"
 
 namespace my_control::demo {
 
 /**
- * @brief Workflow（调度线程）：每个 device_id 一条线程
+ * @brief Workflow（调度器）：每个 device_id 一个，运行在共享执行器 "workflow" 子系统上
  *
  * @details
  * - 绑定：TaskQueue& + IControl&
- * - 运行：循环 pop task -> (on_start) -> doTask -> (on_finish)
- * - 停止：Stop + Join；通常由 Device/Edge 生命周期控制
+ * - 运行：队列 Push 时投递一次 drain 任务，循环 pop task -> (on_start) -> doTask -> (on_finish) 直到队列为空；
+ *   同一 Workflow 同时最多一个 drain 任务，保证同一设备的任务串行执行
+ * - EStop：暂停取新任务，200ms 后由定时器重试
+ * - 过期：队列在出队前移出已过截止时间的任务，Workflow 以 ErrorCode::Timeout 触发 on_finish
+ * - 停止：Stop + Join；Join 等待进行中的 drain 任务结束；通常由 Device/Edge 生命周期控制
  */
 class Workflow {
 public:
@@ -52,7 +57,10 @@ public:
   const std::string& Name() const { return name_; }
 
 private:
-  void RunLoop();
+  void ScheduleDrain();                                       // 投递 drain 任务（已有进行中的则忽略）
+  void Drain();                                               // 执行器线程：消费队列直到为空/停止/EStop
+  bool DrainQueue();                                          // 返回 true 表示因 EStop 暂停
+  void RunTask(const my_data::Task& task, const my_control::TaskQueue::PopInfo& pop_info);
 
 private:
   std::string name_;
@@ -61,7 +69,11 @@ private:
 
   std::atomic<bool> running_{false};
   std::atomic<bool> stop_{false};
-  std::thread worker_;
+
+  std::mutex drain_mu_;                                       // 保护 drain_scheduled_ / estop_retry_timer_
+  std::condition_variable drain_cv_;
+  bool drain_scheduled_{false};                               // 已投递、尚未结束的 drain 任务
+  my_executor::TimerId estop_retry_timer_{0};
 
   // 外部注入（由 Edge 或 Device 注入），EStop=true 时不再取新任务
   std::atomic<bool>* estop_flag_{nullptr};
@@ -10,6 +10,7 @@
 
 #include "demo/Types.h"
 #include "demo/Error.h"
+#include "demo/JsonPayload.h"
 #include "demo/TaskResult.h"
 #include "demo/Task.h"
 #include "demo/Status.h"
@@ -0,0 +1,57 @@
+#include "JsonPayload.h"
+
+namespace my_data {
+
+JsonPayload::JsonPayload(const nlohmann::json& j) {
+  Assign(nlohmann::json(j));
+}
+
+JsonPayload::JsonPayload(nlohmann::json&& j) {
+  Assign(std::move(j));
+}
+
+JsonPayload& JsonPayload::operator=(const nlohmann::json& j) {
+  Assign(nlohmann::json(j));
+  return *this;
+}
+
+JsonPayload& JsonPayload::operator=(nlohmann::json&& j) {
+  Assign(std::move(j));
+  return *this;
+}
+
+void JsonPayload::Assign(nlohmann::json&& j) {
+  if (j.is_object() && j.empty()) {
+    data_.reset();
+    return;
+  }
+  data_ = std::make_shared<nlohmann::json>(std::move(j));
+}
+
+const nlohmann::json& JsonPayload::Get() const {
+  static const nlohmann::json kEmptyObject = nlohmann::json::object();
+  return data_ ? *data_ : kEmptyObject;
+}
+
+nlohmann::json& JsonPayload::Mutable() {
+  if (!data_) {
+    data_ = std::make_shared<nlohmann::json>(nlohmann::json::object());
+  } else if (data_.use_count() > 1) {
+    data_ = std::make_shared<nlohmann::json>(*data_);
+  }
+  return *data_;
+}
+
+std::string JsonPayload::dump(int indent) const {
+  return data_ ? data_->dump(indent) : std::string("{}");
+}
+
+void to_json(nlohmann::json& j, const JsonPayload& p) {
+  j = p.Get();
+}
+
+void from_json(const nlohmann::json& j, JsonPayload& p) {
+  p = j;
+}
+
+} // namespace my_data
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace my_data {
+
+/**
+ * @brief 写时复制的 JSON 载荷（Task::params / Task::policy / TaskResult::output）
+ *
+ * @details
+ * - 空对象不分配内存：默认构造、赋值空对象都只是一个空指针
+ * - 拷贝只增加引用计数，不深拷贝 JSON 树；Task 在 Edge → TaskQueue → Workflow 间传递时不再复制参数
+ * - 只读访问（value/contains/dump）与 nlohmann::json 保持同名，调用方无需改动
+ * - 需要修改时调用 Mutable()，若与其它副本共享会先复制一份
+ *
+ * 线程安全：与 std::shared_ptr 相同——不同副本可在不同线程并发读；同一个对象的并发写需外部加锁。
+ */
+class JsonPayload {
+public:
+  JsonPayload() = default;
+  JsonPayload(const nlohmann::json& j);   // NOLINT: 允许从 json 隐式构造，保持 task.params = json 写法
+  JsonPayload(nlohmann::json&& j);        // NOLINT
+
+  JsonPayload& operator=(const nlohmann::json& j);
+  JsonPayload& operator=(nlohmann::json&& j);
+
+  /**
+   * @brief 只读视图；为空时返回共享的空对象
+   */
+  const nlohmann::json& Get() const;
+  operator const nlohmann::json&() const { return Get(); }   // NOLINT
+
+  /**
+   * @brief 可写视图（必要时先复制，保证不影响其它副本）
+   */
+  nlohmann::json& Mutable();
+
+  /**
+   * @brief 是否与其它副本共享同一份数据（测试/统计用）
+   */
+  bool IsShared() const { return data_ && data_.use_count() > 1; }
+
+  bool empty() const { return !data_ || data_->empty(); }
+  std::size_t size() const { return data_ ? data_->size() : 0; }
+  bool is_object() const { return !data_ || data_->is_object(); }
+  bool contains(const std::string& key) const { return data_ && data_->contains(key); }
+  std::string dump(int indent = -1) const;
+
+  template <typename T>
+  T value(const std::string& key, const T& default_value) const {
+    return data_ ? data_->value(key, default_value) : default_value;
+  }
+  std::string value(const std::string& key, const char* default_value) const {
+    return data_ ? data_->value(key, default_value) : std::string(default_value);
+  }
+
+private:
+  void Assign(nlohmann::json&& j);
+
+  std::shared_ptr<nlohmann::json> data_{};   // nullptr 表示空对象；共享时只读
+};
+
+void to_json(nlohmann::json& j, const JsonPayload& p);
+void from_json(const nlohmann::json& j, JsonPayload& p);
+
+} // namespace my_data
@@ -46,13 +46,13 @@ nlohmann::json Task::toJson() const {
   j["device_id"] = device_id;
   j["capability"] = capability;
   j["action"] = action;
-  j["params"] = params;
+  j["params"] = params.Get();
   j["idempotency_key"] = idempotency_key;
   j["dedup_window_ms"] = dedup_window_ms;
   j["priority"] = priority;
   j["created_at_ms"] = created_at_ms;
   j["deadline_at_ms"] = deadline_at_ms;
-  j["policy"] = policy;
+  j["policy"] = policy.Get();
   j["state"] = static_cast<int>(state);
   j["result"] = result.toJson();
   return j;
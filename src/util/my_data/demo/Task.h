@@ -1,4 +1,5 @@
 #pragma once
+#include "JsonPayload.h"
 #include "TaskResult.h"
 #include "Types.h"
 #include <nlohmann/json.hpp>
@@ -22,7 +23,10 @@ enum class TaskState {
  *
  * @details
  * - 数据类中包含“幂等字段”，但 MVP 阶段不启用去重逻辑。
- * - params/output/policy 统一使用 nlohmann::json，初始化/扩展方便。
+ * - params/output/policy 使用 JsonPayload（写时复制的 nlohmann::json），空对象不分配内存，拷贝只加引用计数；
+ *   只在 API/DB 边界（toJson/fromJson）才展开成完整 JSON。
+ * - 在 Edge → TaskQueue → Workflow 之间按移动语义传递（TaskQueue::Push(Task&&)）。
+ * - capability/action 通常很短（< 16 字节），依赖 std::string 的小字符串优化内联存储，不做全局驻留。
  */
 struct Task {
   // 身份：全局唯一的任务标识与来源命令 ID
@@ -46,10 +50,10 @@ struct Task {
   // 能力与动作：描述要执行的功能和操作
   // - `capability`：能力域或模块名称（如 camera、motion）
   // - `action`：具体动作名称（如 capture、move_to）
-  // - `params`：动作参数，以 JSON 表示，方便扩展任意结构
+  // - `params`：动作参数，以 JSON 表示，方便扩展任意结构（写时复制，修改请用 params.Mutable()）
   std::string capability{};
   std::string action{};
-  nlohmann::json params = nlohmann::json::object();
+  JsonPayload params{};
 
   // 幂等与去重（预留字段，MVP 阶段未启用去重逻辑）
   // - `idempotency_key`：用于幂等判定的 key（来自客户端或网关）
@@ -71,7 +75,7 @@ struct Task {
   int priority{0};
   TimestampMs created_at_ms{0};
   TimestampMs deadline_at_ms{0};
-  nlohmann::json policy = nlohmann::json::object();
+  JsonPayload policy{};
 
   // 运行时状态与结果
   // - `state`：任务当前状态（Pending/Running/Succeeded/Failed/Cancelled）
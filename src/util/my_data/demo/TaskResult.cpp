@@ -21,7 +21,7 @@ nlohmann::json TaskResult::toJson() const {
   j["message"] = message;
   j["started_at_ms"] = started_at_ms;
   j["finished_at_ms"] = finished_at_ms;
-  j["output"] = output;
+  j["output"] = output.Get();
   return j;
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "Error.h"
+#include "JsonPayload.h"
 #include "Types.h"
 #include <nlohmann/json.hpp>
 #include <string>
@@ -14,7 +15,7 @@ struct TaskResult {
   std::string message{};
   TimestampMs started_at_ms{0};
   TimestampMs finished_at_ms{0};
-  nlohmann::json output = nlohmann::json::object();
+  JsonPayload output{};   // 写时复制，修改请用 output.Mutable()
 
   /**
    * @brief 可读字符串（用于日志）
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <sstream>
 
+#include "MyDBWriter.h"
 #include "sqlite3.h"
 
 namespace my_db {
@@ -24,6 +25,11 @@ DBConfig DBConfig::FromJson(const nlohmann::json& j) {
   c.status_snapshot_enable = j.value("status_snapshot_enable", c.status_snapshot_enable);
   c.status_snapshot_interval_ms = j.value("status_snapshot_interval_ms", c.status_snapshot_interval_ms);
 
+  c.writer_queue_capacity = j.value("writer_queue_capacity", c.writer_queue_capacity);
+  c.writer_batch_size = j.value("writer_batch_size", c.writer_batch_size);
+  c.writer_flush_interval_ms = j.value("writer_flush_interval_ms", c.writer_flush_interval_ms);
+  c.writer_enqueue_timeout_ms = j.value("writer_enqueue_timeout_ms", c.writer_enqueue_timeout_ms);
+
   return c;
 }
 
@@ -120,6 +126,7 @@ bool MyDB::Init(const DBConfig& cfg, std::string* err) {
   }
 
   initialized_ = true;
+  MyDBWriter::GetInstance().Start(cfg_);
   MYLOG_INFO("[MyDB] Init success: path={}", cfg_.path);
   return true;
 }
@@ -302,6 +309,9 @@ bool MyDB::Migrate(std::string* err) {
 }
 
 void MyDB::Close() {
+  // 先把写后队列落盘并释放缓存的 statement，否则 sqlite3_close 会失败
+  MyDBWriter::GetInstance().Stop();
+
   std::lock_guard<std::mutex> lk(mu_);
   if (db_) {
     MYLOG_WARN("[MyDB] Close db: path={}", cfg_.path);
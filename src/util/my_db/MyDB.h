@@ -29,6 +29,12 @@ struct DBConfig {
   bool status_snapshot_enable{true};
   int status_snapshot_interval_ms{5000};
 
+  // 写后持久化（MyDBWriter）
+  int writer_queue_capacity{4096};     // 内存队列上限
+  int writer_batch_size{128};          // 攒够多少条提交一次
+  int writer_flush_interval_ms{200};   // 最早一条最多等待多久提交
+  int writer_enqueue_timeout_ms{1000}; // 队列满时任务写入最多等待多久
+
   static DBConfig FromJson(const nlohmann::json& j);
 };
 
@@ -0,0 +1,270 @@
+#include "MyDBWriter.h"
+
+#include <algorithm>
+
+#include "MyDB.h"
+#include "sqlite3.h"
+
+namespace my_db {
+
+MyDBWriter& MyDBWriter::GetInstance() {
+  // 不析构：MyDB 的静态析构会调用 Close -> Stop，需要保证本对象仍然有效
+  static MyDBWriter* inst = new MyDBWriter();
+  return *inst;
+}
+
+void MyDBWriter::Start(const DBConfig& cfg) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (running_) {
+    MYLOG_WARN("[MyDBWriter] Start ignored: already running");
+    return;
+  }
+
+  capacity_ = static_cast<std::size_t>(std::max(1, cfg.writer_queue_capacity));
+  batch_size_ = static_cast<std::size_t>(std::max(1, cfg.writer_batch_size));
+  flush_interval_ms_ = std::max(0, cfg.writer_flush_interval_ms);
+  enqueue_timeout_ms_ = std::max(0, cfg.writer_enqueue_timeout_ms);
+
+  stop_ = false;
+  running_ = true;
+  th_ = std::thread(&MyDBWriter::WriterLoop, this);
+
+  MYLOG_INFO("[MyDBWriter] Start: capacity={}, batch_size={}, flush_interval_ms={}, enqueue_timeout_ms={}",
+             capacity_, batch_size_, flush_interval_ms_, enqueue_timeout_ms_);
+}
+
+void MyDBWriter::Stop() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!running_ || stop_) return;
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  space_cv_.notify_all();
+
+  if (th_.joinable()) th_.join();
+  FinalizeStatements();
+
+  std::lock_guard<std::mutex> lk(mu_);
+  running_ = false;
+  MYLOG_INFO("[MyDBWriter] Stop: enqueued={}, committed={}, failed={}, dropped={}, batches={}",
+             stats_.enqueued, stats_.committed, stats_.failed, stats_.dropped, stats_.batches);
+}
+
+bool MyDBWriter::IsRunning() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return running_ && !stop_;
+}
+
+bool MyDBWriter::Enqueue(const char* sql, BindFn bind, Mode mode, std::string* err) {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (!running_ || stop_) {
+    if (err) *err = "db writer not running";
+    return false;
+  }
+
+  if (queue_.size() >= capacity_) {
+    if (mode == Mode::DropIfFull) {
+      ++stats_.dropped;
+      if (err) *err = "db write queue full";
+      MYLOG_WARN("[MyDBWriter] queue full, drop write: capacity={}", capacity_);
+      return false;
+    }
+    const bool has_space = space_cv_.wait_for(lk, std::chrono::milliseconds(enqueue_timeout_ms_), [&] {
+      return stop_ || queue_.size() < capacity_;
+    });
+    if (!has_space || stop_) {
+      ++stats_.dropped;
+      if (err) *err = stop_ ? "db writer stopping" : "db write queue full (enqueue timeout)";
+      MYLOG_ERROR("[MyDBWriter] enqueue failed after {} ms: capacity={}", enqueue_timeout_ms_, capacity_);
+      return false;
+    }
+  }
+
+  queue_.push_back(WriteOp{sql, std::move(bind), Clock::now()});
+  ++enqueued_seq_;
+  ++stats_.enqueued;
+
+  // 第一条入队开始计时，攒够一批立即提交；其余情况写线程按超时自行醒来
+  if (queue_.size() == 1 || queue_.size() >= batch_size_) {
+    work_cv_.notify_one();
+  }
+  return true;
+}
+
+bool MyDBWriter::Flush(int timeout_ms) {
+  std::unique_lock<std::mutex> lk(mu_);
+  const std::uint64_t target = enqueued_seq_;
+  if (done_seq_ >= target) return true;
+
+  ++flush_waiters_;
+  work_cv_.notify_one();
+  auto pred = [&] { return done_seq_ >= target; };
+  bool ok = true;
+  if (timeout_ms < 0) {
+    done_cv_.wait(lk, pred);
+  } else {
+    ok = done_cv_.wait_for(lk, std::chrono::milliseconds(timeout_ms), pred);
+  }
+  --flush_waiters_;
+
+  if (!ok) {
+    MYLOG_WARN("[MyDBWriter] Flush timeout: timeout_ms={}, pending={}", timeout_ms, target - done_seq_);
+  }
+  return ok;
+}
+
+nlohmann::json MyDBWriter::GetStatsJson() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  nlohmann::json j = nlohmann::json::object();
+  j["running"] = running_ && !stop_;
+  j["queue_depth"] = queue_.size();
+  j["capacity"] = capacity_;
+  j["batch_size"] = batch_size_;
+  j["flush_interval_ms"] = flush_interval_ms_;
+  j["enqueued"] = stats_.enqueued;
+  j["committed"] = stats_.committed;
+  j["failed"] = stats_.failed;
+  j["dropped"] = stats_.dropped;
+  j["batches"] = stats_.batches;
+  j["max_batch"] = stats_.max_batch;
+  j["last_batch_us"] = stats_.last_batch_us;
+  return j;
+}
+
+void MyDBWriter::WriterLoop() {
+  MYLOG_INFO("[MyDBWriter] writer thread enter");
+
+  std::unique_lock<std::mutex> lk(mu_);
+  while (true) {
+    work_cv_.wait(lk, [&] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      if (stop_) break;
+      continue;
+    }
+
+    // 批大小或时间任一满足即提交；Stop/Flush 时不再等待
+    const auto due = queue_.front().enqueued_at + std::chrono::milliseconds(flush_interval_ms_);
+    work_cv_.wait_until(lk, due, [&] {
+      return stop_ || flush_waiters_ > 0 || queue_.size() >= batch_size_;
+    });
+
+    const std::size_t n = std::min(queue_.size(), batch_size_);
+    std::vector<WriteOp> batch;
+    batch.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      batch.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+
+    lk.unlock();
+    space_cv_.notify_all();
+    CommitBatch(batch);
+    lk.lock();
+
+    done_seq_ += n;
+    done_cv_.notify_all();
+  }
+
+  MYLOG_INFO("[MyDBWriter] writer thread exit");
+}
+
+void MyDBWriter::CommitBatch(std::vector<WriteOp>& batch) {
+  auto& db = MyDB::GetInstance();
+  const auto start = Clock::now();
+
+  std::uint64_t ok_cnt = 0;
+  std::uint64_t fail_cnt = 0;
+  bool tx_ok = false;
+  std::string tx_err;
+
+  if (db.IsInitialized()) {
+    // BEGIN/COMMIT 失败（如 busy）时整批回滚，稍后重试
+    for (int attempt = 0; attempt < 3 && !tx_ok; ++attempt) {
+      if (attempt > 0) {
+        MYLOG_WARN("[MyDBWriter] batch commit retry {}: size={}, err={}", attempt, batch.size(), tx_err);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50 * attempt));
+      }
+      ok_cnt = 0;
+      fail_cnt = 0;
+      tx_ok = db.Transaction([&](std::string*) -> bool {
+        for (auto& op : batch) {
+          std::string e;
+          if (ExecuteOp(op, &e)) {
+            ++ok_cnt;
+          } else {
+            ++fail_cnt;
+            MYLOG_ERROR("[MyDBWriter] write failed: err={}, sql={}", e, op.sql);
+          }
+        }
+        return true;
+      }, &tx_err);
+    }
+  } else {
+    tx_err = "db not initialized";
+  }
+
+  if (!tx_ok) {
+    ok_cnt = 0;
+    fail_cnt = batch.size();
+    MYLOG_ERROR("[MyDBWriter] batch dropped: size={}, err={}", batch.size(), tx_err);
+  }
+
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+  std::lock_guard<std::mutex> lk(mu_);
+  stats_.committed += ok_cnt;
+  stats_.failed += fail_cnt;
+  ++stats_.batches;
+  stats_.max_batch = std::max<std::uint64_t>(stats_.max_batch, batch.size());
+  stats_.last_batch_us = us;
+}
+
+bool MyDBWriter::ExecuteOp(WriteOp& op, std::string* err) {
+  sqlite3_stmt* stmt = GetStatement(op.sql, err);
+  if (!stmt) return false;
+
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if (op.bind && !op.bind(stmt, err)) {
+    sqlite3_reset(stmt);
+    return false;
+  }
+
+  const int rc = sqlite3_step(stmt);
+  const bool ok = (rc == SQLITE_DONE || rc == SQLITE_ROW);
+  if (!ok && err) *err = sqlite3_errmsg(sqlite3_db_handle(stmt));
+  sqlite3_reset(stmt);
+  return ok;
+}
+
+sqlite3_stmt* MyDBWriter::GetStatement(const char* sql, std::string* err) {
+  auto it = stmts_.find(sql);
+  if (it != stmts_.end()) return it->second;
+
+  sqlite3* h = MyDB::GetInstance().UnsafeHandle();
+  if (!h) {
+    if (err) *err = "db not initialized";
+    return nullptr;
+  }
+
+  sqlite3_stmt* stmt = nullptr;
+  const int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
+  if (rc != SQLITE_OK || !stmt) {
+    if (err) *err = sqlite3_errmsg(h);
+    if (stmt) sqlite3_finalize(stmt);
+    return nullptr;
+  }
+  stmts_.emplace(sql, stmt);
+  return stmt;
+}
+
+void MyDBWriter::FinalizeStatements() {
+  std::lock_guard<std::mutex> lk(MyDB::GetInstance().Mutex());
+  for (auto& [sql, stmt] : stmts_) {
+    sqlite3_finalize(stmt);
+  }
+  stmts_.clear();
+}
+
+} // namespace my_db
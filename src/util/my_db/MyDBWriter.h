@@ -0,0 +1,140 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "MyLog.h"
+
+struct sqlite3_stmt; // forward declare
+
+namespace my_db {
+
+struct DBConfig;
+
+/**
+ * @brief 写后（write-behind）持久化管线
+ *
+ * @details
+ * - Repository 的写操作只入队（有界内存队列），由单独的写线程批量落库
+ * - 写线程按 SQL 文本缓存 prepared statement，每次只 reset + 重新 bind
+ * - 攒够 batch_size 条或最早一条等待超过 flush_interval_ms 时，在一个事务里提交整批
+ * - 背压：
+ *   - Mode::Block：队列满时最多等待 enqueue_timeout_ms（任务/结果，不能丢）
+ *   - Mode::DropIfFull：队列满时立即失败并计入 dropped（状态快照，允许丢）
+ * - Flush() 等待调用前已入队的写操作全部提交；读接口在查询前调用，保证读到自己的写
+ * - Stop() 把队列写完后才退出，并释放缓存的 statement（MyDB::Close 会先调用）
+ *
+ * 单条写失败只记日志与计数，不影响同批其它写操作。
+ */
+class MyDBWriter {
+public:
+  enum class Mode {
+    Block = 0,
+    DropIfFull = 1,
+  };
+
+  /**
+   * @brief 绑定参数回调（在写线程中执行，可在这里做 JSON 序列化，避免占用调用方线程）
+   */
+  using BindFn = std::function<bool(sqlite3_stmt* stmt, std::string* err)>;
+
+  static MyDBWriter& GetInstance();
+
+  MyDBWriter(const MyDBWriter&) = delete;
+  MyDBWriter& operator=(const MyDBWriter&) = delete;
+
+  /**
+   * @brief 按配置启动写线程（MyDB::Init 成功后调用）；已运行时忽略
+   */
+  void Start(const DBConfig& cfg);
+
+  /**
+   * @brief 写完队列中剩余操作后停止写线程，并释放缓存的 statement
+   */
+  void Stop();
+
+  bool IsRunning() const;
+
+  /**
+   * @brief 提交一个写操作
+   * @param sql  SQL 文本（同时作为 statement 缓存的 key，请传常量字符串）
+   * @param bind 参数绑定回调
+   * @return 入队成功返回 true；未启动、队列满（DropIfFull）或等待超时（Block）返回 false
+   */
+  bool Enqueue(const char* sql, BindFn bind, Mode mode, std::string* err);
+
+  /**
+   * @brief 等待调用前已入队的写操作全部提交
+   * @param timeout_ms <0 表示一直等待
+   * @return 超时返回 false
+   */
+  bool Flush(int timeout_ms = -1);
+
+  /**
+   * @brief 统计：队列深度/容量、入队/提交/失败/丢弃次数、批次数与最近一批耗时
+   */
+  nlohmann::json GetStatsJson() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct WriteOp {
+    const char* sql{nullptr};
+    BindFn bind;
+    Clock::time_point enqueued_at{};
+  };
+
+  struct Stats {
+    std::uint64_t enqueued{0};
+    std::uint64_t committed{0};
+    std::uint64_t failed{0};
+    std::uint64_t dropped{0};
+    std::uint64_t batches{0};
+    std::uint64_t max_batch{0};
+    std::int64_t last_batch_us{0};
+  };
+
+  MyDBWriter() = default;
+
+  void WriterLoop();
+  void CommitBatch(std::vector<WriteOp>& batch);
+  bool ExecuteOp(WriteOp& op, std::string* err);
+  sqlite3_stmt* GetStatement(const char* sql, std::string* err);
+  void FinalizeStatements();
+
+private:
+  mutable std::mutex mu_;
+  std::condition_variable work_cv_;      // 唤醒写线程
+  std::condition_variable space_cv_;     // 队列有空位（Block 模式等待）
+  std::condition_variable done_cv_;      // 一批提交完成（Flush 等待）
+  std::deque<WriteOp> queue_;
+  bool running_{false};
+  bool stop_{false};
+  int flush_waiters_{0};
+  std::uint64_t enqueued_seq_{0};        // 已入队总数
+  std::uint64_t done_seq_{0};            // 已处理（提交或失败）总数
+  Stats stats_{};
+
+  std::size_t capacity_{4096};
+  std::size_t batch_size_{128};
+  int flush_interval_ms_{200};
+  int enqueue_timeout_ms_{1000};
+
+  std::thread th_;
+
+  // 仅写线程访问（Stop 在 join 之后访问）
+  std::unordered_map<std::string, sqlite3_stmt*> stmts_;
+};
+
+} // namespace my_db
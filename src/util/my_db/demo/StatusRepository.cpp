@@ -1,5 +1,6 @@
 #include "StatusRepository.h"
 
+#include "MyDBWriter.h"
 #include "sqlite3.h"
 
 namespace my_db::demo {
@@ -25,120 +26,59 @@ static bool BindInt64(sqlite3_stmt* stmt, int idx, std::int64_t v, std::string*
   return true;
 }
 
-static bool StepDone(sqlite3_stmt* stmt, sqlite3* db, std::string* err) {
-  int rc = sqlite3_step(stmt);
-  if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
-    if (err) *err = sqlite3_errmsg(db);
-    return false;
-  }
-  return true;
-}
-
 bool StatusRepository::InsertDeviceSnapshot(const my_data::EdgeId& edge_id,
                                             const my_data::DeviceStatus& st,
                                             std::string* err) {
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
-    return false;
-  }
-
-  const char* sql = R"SQL(
+  static const char* kSql = R"SQL(
     INSERT INTO device_status_snapshots(edge_id, device_id, ts_ms, status_json)
     VALUES(?, ?, ?, ?);
   )SQL";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
-    MYLOG_ERROR("[StatusRepo] InsertDeviceSnapshot prepare failed: {}", err ? *err : "");
-    return false;
-  }
-
-  std::string berr;
-  bool ok = true;
-  ok = ok && BindText(stmt, 1, edge_id, &berr);
-  ok = ok && BindText(stmt, 2, st.device_id, &berr);
-  ok = ok && BindInt64(stmt, 3, my_data::NowMs(), &berr);
-  ok = ok && BindText(stmt, 4, st.toString(), &berr);
+  // 快照按调用时刻打时间戳；队列满时直接丢弃，不阻塞 Edge 线程
+  const my_data::TimestampMs ts_ms = my_data::NowMs();
+  bool ok = my_db::MyDBWriter::GetInstance().Enqueue(kSql, [edge_id, st, ts_ms](sqlite3_stmt* stmt, std::string* berr) {
+    bool ok = true;
+    ok = ok && BindText(stmt, 1, edge_id, berr);
+    ok = ok && BindText(stmt, 2, st.device_id, berr);
+    ok = ok && BindInt64(stmt, 3, ts_ms, berr);
+    ok = ok && BindText(stmt, 4, st.toJson().dump(), berr);
+    return ok;
+  }, my_db::MyDBWriter::Mode::DropIfFull, err);
 
   if (!ok) {
-    sqlite3_finalize(stmt);
-    if (err) *err = berr;
-    MYLOG_ERROR("[StatusRepo] InsertDeviceSnapshot bind failed: {}", berr);
+    MYLOG_WARN("[StatusRepo] InsertDeviceSnapshot enqueue failed: device_id={}, err={}", st.device_id, err ? *err : "");
     return false;
   }
-
-  std::string serr;
-  ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
-
-  if (!ok) {
-    if (err) *err = serr;
-    MYLOG_ERROR("[StatusRepo] InsertDeviceSnapshot step failed: {}", serr);
-    return false;
-  }
-
-  MYLOG_DEBUG("[StatusRepo] InsertDeviceSnapshot ok: device_id={}", st.device_id);
+  MYLOG_DEBUG("[StatusRepo] InsertDeviceSnapshot queued: device_id={}", st.device_id);
   return true;
 }
 
 bool StatusRepository::InsertEdgeSnapshot(const my_data::EdgeStatus& st, std::string* err) {
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
-    return false;
-  }
-
-  const char* sql = R"SQL(
+  static const char* kSql = R"SQL(
     INSERT INTO edge_status_snapshots(edge_id, ts_ms, status_json)
     VALUES(?, ?, ?);
   )SQL";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
-    MYLOG_ERROR("[StatusRepo] InsertEdgeSnapshot prepare failed: {}", err ? *err : "");
-    return false;
-  }
-
-  std::string berr;
-  bool ok = true;
-  ok = ok && BindText(stmt, 1, st.edge_id, &berr);
-  ok = ok && BindInt64(stmt, 2, my_data::NowMs(), &berr);
-  ok = ok && BindText(stmt, 3, st.toString(), &berr);
-
-  if (!ok) {
-    sqlite3_finalize(stmt);
-    if (err) *err = berr;
-    MYLOG_ERROR("[StatusRepo] InsertEdgeSnapshot bind failed: {}", berr);
-    return false;
-  }
-
-  std::string serr;
-  ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
+  const my_data::TimestampMs ts_ms = my_data::NowMs();
+  bool ok = my_db::MyDBWriter::GetInstance().Enqueue(kSql, [st, ts_ms](sqlite3_stmt* stmt, std::string* berr) {
+    bool ok = true;
+    ok = ok && BindText(stmt, 1, st.edge_id, berr);
+    ok = ok && BindInt64(stmt, 2, ts_ms, berr);
+    ok = ok && BindText(stmt, 3, st.toJson().dump(), berr);
+    return ok;
+  }, my_db::MyDBWriter::Mode::DropIfFull, err);
 
   if (!ok) {
-    if (err) *err = serr;
-    MYLOG_ERROR("[StatusRepo] InsertEdgeSnapshot step failed: {}", serr);
+    MYLOG_WARN("[StatusRepo] InsertEdgeSnapshot enqueue failed: edge_id={}, err={}", st.edge_id, err ? *err : "");
     return false;
   }
-
-  MYLOG_DEBUG("[StatusRepo] InsertEdgeSnapshot ok: edge_id={}", st.edge_id);
+  MYLOG_DEBUG("[StatusRepo] InsertEdgeSnapshot queued: edge_id={}", st.edge_id);
   return true;
 }
 
 bool StatusRepository::CountEdgeSnapshots(const my_data::EdgeId& edge_id, std::int64_t* out_cnt, std::string* err) {
   if (out_cnt) *out_cnt = 0;
+  my_db::MyDBWriter::GetInstance().Flush();   // 先让之前的写入落库，保证读到自己的写
 
   auto& db = my_db::MyDB::GetInstance();
   std::lock_guard<std::mutex> lk(db.Mutex());
@@ -180,6 +120,7 @@ bool StatusRepository::CountEdgeSnapshots(const my_data::EdgeId& edge_id, std::i
 bool StatusRepository::CountDeviceSnapshots(const my_data::EdgeId& edge_id, const my_data::DeviceId& device_id,
                                             std::int64_t* out_cnt, std::string* err) {
   if (out_cnt) *out_cnt = 0;
+  my_db::MyDBWriter::GetInstance().Flush();   // 先让之前的写入落库，保证读到自己的写
 
   auto& db = my_db::MyDB::GetInstance();
   std::lock_guard<std::mutex> lk(db.Mutex());
@@ -13,6 +13,8 @@ class StatusRepository {
 public:
   static StatusRepository& GetInstance();
 
+  // 写操作进入 MyDBWriter 队列后立即返回（队列满时丢弃并返回 false，不阻塞调用方）；
+  // 计数查询前会先 Flush，能读到之前的写入
   bool InsertDeviceSnapshot(const my_data::EdgeId& edge_id,
                             const my_data::DeviceStatus& st,
                             std::string* err);
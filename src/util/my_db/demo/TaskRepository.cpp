@@ -2,6 +2,7 @@
 
 #include <sstream>
 
+#include "MyDBWriter.h"
 #include "sqlite3.h"
 
 namespace my_db::demo {
@@ -27,26 +28,8 @@ static bool BindInt64(sqlite3_stmt* stmt, int idx, std::int64_t v, std::string*
   return true;
 }
 
-static bool StepDone(sqlite3_stmt* stmt, sqlite3* db, std::string* err) {
-  int rc = sqlite3_step(stmt);
-  if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
-    if (err) *err = sqlite3_errmsg(db);
-    return false;
-  }
-  return true;
-}
-
 bool TaskRepository::UpsertTask(const my_data::Task& task, std::string* err) {
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
-    return false;
-  }
-
-  const char* sql = R"SQL(
+  static const char* kSql = R"SQL(
     INSERT INTO tasks(task_id, command_id, edge_id, device_id, capability, action, state, created_at_ms, deadline_at_ms, task_json)
     VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
     ON CONFLICT(task_id) DO UPDATE SET
@@ -61,60 +44,33 @@ bool TaskRepository::UpsertTask(const my_data::Task& task, std::string* err) {
       task_json=excluded.task_json;
   )SQL";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
-    MYLOG_ERROR("[TaskRepo] UpsertTask prepare failed: err={}", err ? *err : "");
-    return false;
-  }
-
-  std::string berr;
-  bool ok = true;
-  ok = ok && BindText(stmt, 1, task.task_id, &berr);
-  ok = ok && BindText(stmt, 2, task.command_id, &berr);
-  ok = ok && BindText(stmt, 3, task.edge_id, &berr);
-  ok = ok && BindText(stmt, 4, task.device_id, &berr);
-  ok = ok && BindText(stmt, 5, task.capability, &berr);
-  ok = ok && BindText(stmt, 6, task.action, &berr);
-  ok = ok && BindInt64(stmt, 7, static_cast<std::int64_t>(task.state), &berr);
-  ok = ok && BindInt64(stmt, 8, task.created_at_ms, &berr);
-  ok = ok && BindInt64(stmt, 9, task.deadline_at_ms, &berr);
-  ok = ok && BindText(stmt, 10, task.toString(), &berr);
-
-  if (!ok) {
-    sqlite3_finalize(stmt);
-    if (err) *err = berr;
-    MYLOG_ERROR("[TaskRepo] UpsertTask bind failed: {}", berr);
-    return false;
-  }
-
-  std::string serr;
-  ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
+  // Task 拷贝只复制字符串与 JsonPayload 引用；JSON 在写线程里展开
+  bool ok = my_db::MyDBWriter::GetInstance().Enqueue(kSql, [task](sqlite3_stmt* stmt, std::string* berr) {
+    bool ok = true;
+    ok = ok && BindText(stmt, 1, task.task_id, berr);
+    ok = ok && BindText(stmt, 2, task.command_id, berr);
+    ok = ok && BindText(stmt, 3, task.edge_id, berr);
+    ok = ok && BindText(stmt, 4, task.device_id, berr);
+    ok = ok && BindText(stmt, 5, task.capability, berr);
+    ok = ok && BindText(stmt, 6, task.action, berr);
+    ok = ok && BindInt64(stmt, 7, static_cast<std::int64_t>(task.state), berr);
+    ok = ok && BindInt64(stmt, 8, task.created_at_ms, berr);
+    ok = ok && BindInt64(stmt, 9, task.deadline_at_ms, berr);
+    ok = ok && BindText(stmt, 10, task.toJson().dump(), berr);
+    return ok;
+  }, my_db::MyDBWriter::Mode::Block, err);
 
   if (!ok) {
-    if (err) *err = serr;
-    MYLOG_ERROR("[TaskRepo] UpsertTask step failed: {}", serr);
+    MYLOG_ERROR("[TaskRepo] UpsertTask enqueue failed: task_id={}, err={}", task.task_id, err ? *err : "");
     return false;
   }
-
-  MYLOG_INFO("[TaskRepo] UpsertTask ok: task_id={}, device_id={}, state={}",
-             task.task_id, task.device_id, my_data::ToString(task.state));
+  MYLOG_DEBUG("[TaskRepo] UpsertTask queued: task_id={}, device_id={}, state={}",
+              task.task_id, task.device_id, my_data::ToString(task.state));
   return true;
 }
 
 bool TaskRepository::UpsertResult(const my_data::TaskId& task_id, const my_data::TaskResult& r, std::string* err) {
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
-    return false;
-  }
-
-  const char* sql = R"SQL(
+  static const char* kSql = R"SQL(
     INSERT INTO task_results(task_id, code, message, started_at_ms, finished_at_ms, result_json)
     VALUES(?, ?, ?, ?, ?, ?)
     ON CONFLICT(task_id) DO UPDATE SET
@@ -125,46 +81,28 @@ bool TaskRepository::UpsertResult(const my_data::TaskId& task_id, const my_data:
       result_json=excluded.result_json;
   )SQL";
 
-  sqlite3_stmt* stmt = nullptr;
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
-    MYLOG_ERROR("[TaskRepo] UpsertResult prepare failed: err={}", err ? *err : "");
-    return false;
-  }
-
-  std::string berr;
-  bool ok = true;
-  ok = ok && BindText(stmt, 1, task_id, &berr);
-  ok = ok && BindInt64(stmt, 2, static_cast<std::int64_t>(r.code), &berr);
-  ok = ok && BindText(stmt, 3, r.message, &berr);
-  ok = ok && BindInt64(stmt, 4, r.started_at_ms, &berr);
-  ok = ok && BindInt64(stmt, 5, r.finished_at_ms, &berr);
-  ok = ok && BindText(stmt, 6, r.toString(), &berr);
-
-  if (!ok) {
-    sqlite3_finalize(stmt);
-    if (err) *err = berr;
-    MYLOG_ERROR("[TaskRepo] UpsertResult bind failed: {}", berr);
-    return false;
-  }
-
-  std::string serr;
-  ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
+  bool ok = my_db::MyDBWriter::GetInstance().Enqueue(kSql, [task_id, r](sqlite3_stmt* stmt, std::string* berr) {
+    bool ok = true;
+    ok = ok && BindText(stmt, 1, task_id, berr);
+    ok = ok && BindInt64(stmt, 2, static_cast<std::int64_t>(r.code), berr);
+    ok = ok && BindText(stmt, 3, r.message, berr);
+    ok = ok && BindInt64(stmt, 4, r.started_at_ms, berr);
+    ok = ok && BindInt64(stmt, 5, r.finished_at_ms, berr);
+    ok = ok && BindText(stmt, 6, r.toJson().dump(), berr);
+    return ok;
+  }, my_db::MyDBWriter::Mode::Block, err);
 
   if (!ok) {
-    if (err) *err = serr;
-    MYLOG_ERROR("[TaskRepo] UpsertResult step failed: {}", serr);
+    MYLOG_ERROR("[TaskRepo] UpsertResult enqueue failed: task_id={}, err={}", task_id, err ? *err : "");
     return false;
   }
-
-  MYLOG_INFO("[TaskRepo] UpsertResult ok: task_id={}, code={}", task_id, my_data::ToString(r.code));
+  MYLOG_DEBUG("[TaskRepo] UpsertResult queued: task_id={}, code={}", task_id, my_data::ToString(r.code));
   return true;
 }
 
 bool TaskRepository::ExistsTask(const my_data::TaskId& task_id, bool* exists, std::string* err) {
   if (exists) *exists = false;
+  my_db::MyDBWriter::GetInstance().Flush();   // 先让之前的写入落库，保证读到自己的写
 
   auto& db = my_db::MyDB::GetInstance();
   std::lock_guard<std::mutex> lk(db.Mutex());
@@ -208,6 +146,7 @@ bool TaskRepository::ExistsTask(const my_data::TaskId& task_id, bool* exists, st
 
 bool TaskRepository::GetTaskJson(const my_data::TaskId& task_id, std::string* out_task_json, std::string* err) {
   if (out_task_json) out_task_json->clear();
+  my_db::MyDBWriter::GetInstance().Flush();   // 先让之前的写入落库，保证读到自己的写
 
   auto& db = my_db::MyDB::GetInstance();
   std::lock_guard<std::mutex> lk(db.Mutex());
@@ -253,6 +192,7 @@ bool TaskRepository::GetTaskJson(const my_data::TaskId& task_id, std::string* ou
 
 bool TaskRepository::GetResultJson(const my_data::TaskId& task_id, std::string* out_result_json, std::string* err) {
   if (out_result_json) out_result_json->clear();
+  my_db::MyDBWriter::GetInstance().Flush();   // 先让之前的写入落库，保证读到自己的写
 
   auto& db = my_db::MyDB::GetInstance();
   std::lock_guard<std::mutex> lk(db.Mutex());
@@ -297,84 +237,33 @@ bool TaskRepository::GetResultJson(const my_data::TaskId& task_id, std::string*
 }
 
 bool TaskRepository::UpdateTaskState(const my_data::TaskId& task_id, my_data::TaskState state, std::string* err) {
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
-    return false;
-  }
-
-  const char* sql = "UPDATE tasks SET state=? WHERE task_id=?;";
-  sqlite3_stmt* stmt = nullptr;
-
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
-    return false;
-  }
-
-  std::string berr;
-  bool ok = true;
-  ok = ok && BindInt64(stmt, 1, static_cast<std::int64_t>(state), &berr);
-  ok = ok && BindText(stmt, 2, task_id, &berr);
-
-  if (!ok) {
-    sqlite3_finalize(stmt);
-    if (err) *err = berr;
-    return false;
-  }
+  static const char* kSql = "UPDATE tasks SET state=? WHERE task_id=?;";
 
-  std::string serr;
-  ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
+  bool ok = my_db::MyDBWriter::GetInstance().Enqueue(kSql, [task_id, state](sqlite3_stmt* stmt, std::string* berr) {
+    return BindInt64(stmt, 1, static_cast<std::int64_t>(state), berr) &&
+           BindText(stmt, 2, task_id, berr);
+  }, my_db::MyDBWriter::Mode::Block, err);
 
   if (!ok) {
-    if (err) *err = serr;
+    MYLOG_ERROR("[TaskRepo] UpdateTaskState enqueue failed: task_id={}, err={}", task_id, err ? *err : "");
     return false;
   }
-
-  MYLOG_INFO("[TaskRepo] UpdateTaskState ok: task_id={}, state={}", task_id, my_data::ToString(state));
+  MYLOG_DEBUG("[TaskRepo] UpdateTaskState queued: task_id={}, state={}", task_id, my_data::ToString(state));
   return true;
 }
 
 bool TaskRepository::DeleteTask(const my_data::TaskId& task_id, std::string* err) {
-  auto& db = my_db::MyDB::GetInstance();
-  std::lock_guard<std::mutex> lk(db.Mutex());
-
-  sqlite3* h = db.UnsafeHandle();
-  if (!h) {
-    if (err) *err = "db not initialized";
-    return false;
-  }
+  static const char* kSql = "DELETE FROM tasks WHERE task_id=?;";
 
-  const char* sql = "DELETE FROM tasks WHERE task_id=?;";
-  sqlite3_stmt* stmt = nullptr;
-
-  int rc = sqlite3_prepare_v2(h, sql, -1, &stmt, nullptr);
-  if (rc != SQLITE_OK || !stmt) {
-    if (err) *err = sqlite3_errmsg(h);
-    return false;
-  }
-
-  std::string berr;
-  if (!BindText(stmt, 1, task_id, &berr)) {
-    sqlite3_finalize(stmt);
-    if (err) *err = berr;
-    return false;
-  }
-
-  std::string serr;
-  bool ok = StepDone(stmt, h, &serr);
-  sqlite3_finalize(stmt);
+  bool ok = my_db::MyDBWriter::GetInstance().Enqueue(kSql, [task_id](sqlite3_stmt* stmt, std::string* berr) {
+    return BindText(stmt, 1, task_id, berr);
+  }, my_db::MyDBWriter::Mode::Block, err);
 
   if (!ok) {
-    if (err) *err = serr;
+    MYLOG_ERROR("[TaskRepo] DeleteTask enqueue failed: task_id={}, err={}", task_id, err ? *err : "");
     return false;
   }
-
-  MYLOG_WARN("[TaskRepo] DeleteTask ok: task_id={}", task_id);
+  MYLOG_WARN("[TaskRepo] DeleteTask queued: task_id={}", task_id);
   return true;
 }
 
@@ -13,12 +13,14 @@ class TaskRepository {
 public:
   static TaskRepository& GetInstance();
 
+  // 写操作进入 MyDBWriter 队列后返回（队列满时最多等待 writer_enqueue_timeout_ms），
+  // 由写线程批量落库；读接口会先 Flush，能读到之前的写入
   bool UpsertTask(const my_data::Task& task, std::string* err);
   bool UpsertResult(const my_data::TaskId& task_id, const my_data::TaskResult& r, std::string* err);
 
   bool ExistsTask(const my_data::TaskId& task_id, bool* exists, std::string* err);
 
-  // 为 CRUD 测试提供：读取存储的 JSON 字符串（当前实现存的是 toString()）
+  // 为 CRUD 测试提供：读取存储的 JSON 字符串（Task::toJson / TaskResult::toJson）
   bool GetTaskJson(const my_data::TaskId& task_id, std::string* out_task_json, std::string* err);
   bool GetResultJson(const my_data::TaskId& task_id, std::string* out_result_json, std::string* err);
 
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <atomic>
+#include <thread>
 
 #include "JsonUtil.h"
 #include "MyDevice.h"
@@ -129,14 +130,14 @@ bool BaseEdge::Start(std::string* err) {
 
     MYLOG_INFO("[Edge:{}] Start 开始: devices={}", edge_id_, devices_.size());
 
-    // 1) 启动 self task 监控线程
-    StartSelfTaskMonitorThreadLocked();
+    // 1) 启动 self task 监控
+    StartSelfTaskMonitorLocked();
     
-    // 2) 启动 self action thread
-    StartSelfActionThreadLocked();
+    // 2) 启动 self action
+    StartSelfActionLocked();
 
-    // 3) 启动心跳/上报线程
-    StartSnapshotThreadLocked();
+    // 3) 启动心跳/上报
+    StartSnapshotLocked();
 
     // 4) 启动所有 device（如果有）
     for (auto& [device_id, dev] : devices_) {
@@ -215,14 +216,14 @@ SubmitResult BaseEdge::Submit(const my_data::RawCommand& cmd) {
                                             nerr.empty() ? "Normalize 失败" : ("Normalize 失败: " + nerr),
                                             cmd, device_id);
     }
-    my_data::Task task = *maybe_task;
+    const my_data::TaskId task_id = maybe_task->task_id;
 
-    // 7) push queue
+    // 7) push queue（移动入队，不复制 Task）
     std::string qerr;
-    if (!AppendTaskToQueueLocked(device_id, task, &qerr)) {
+    if (!AppendTaskToQueueLocked(device_id, std::move(*maybe_task), &qerr)) {
         return MakeResult(SubmitCode::InternalError,
                                             qerr.empty() ? "入队失败" : ("入队失败: " + qerr),
-                                            cmd, device_id, task.task_id);
+                                            cmd, device_id, task_id);
     }
 
     auto qit = queues_.find(device_id);
@@ -230,7 +231,7 @@ SubmitResult BaseEdge::Submit(const my_data::RawCommand& cmd) {
                                                  ? static_cast<std::int64_t>(qit->second->Size())
                                                  : 0;
 
-    return MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, task.task_id, qsize);
+    return MakeResult(SubmitCode::Ok, "已入队", cmd, device_id, task_id, qsize);
 }
 
 my_data::EdgeStatus BaseEdge::GetStatusSnapshot() const {
@@ -300,17 +301,23 @@ void BaseEdge::SetEStop(bool active, const std::string& reason) {
 }
 
 void BaseEdge::Shutdown() {
-    std::unique_lock<std::shared_mutex> lk(rw_mutex_);
+    {
+        std::unique_lock<std::shared_mutex> lk(rw_mutex_);
 
-    RunState rs = run_state_.load();
-    if (rs == RunState::Stopped || rs == RunState::Stopping) return;
+        RunState rs = run_state_.load();
+        if (rs == RunState::Stopped || rs == RunState::Stopping) return;
 
-    MYLOG_WARN("[Edge:{}] Shutdown 开始: run_state={}", edge_id_, RunStateToString(rs));
-    run_state_ = RunState::Stopping;
+        MYLOG_WARN("[Edge:{}] Shutdown 开始: run_state={}", edge_id_, RunStateToString(rs));
+        run_state_ = RunState::Stopping;
+    }
+
+    // 先停周期任务（避免回调访问被清理的 queues_/devices_）；
+    // 需在 rw_mutex_ 外等待，snapshot 回调本身要获取 rw_mutex_
+    StopSnapshot();
+    StopSelfAction();
+    StopSelfTaskMonitor();
 
-    // 先停线程（避免线程访问被清理的 queues_/devices_）
-    StopSnapshotThreadLocked();
-    StopSelfActionThreadLocked();
+    std::unique_lock<std::shared_mutex> lk(rw_mutex_);
 
     // stop devices
     for (auto& [device_id, dev] : devices_) {
@@ -392,22 +399,22 @@ nlohmann::json BaseEdge::GetRunTimeStatusInfo() const {
     nlohmann::json tj = nlohmann::json::object();
 
 
-    // 线程状态
+    // 周期任务状态
     tj["self_task_monitor"] = {
         {"enabled", self_task_monitor_enable_},
-        {"running", self_task_monitor_thread_.joinable()},
+        {"running", self_task_monitor_timer_.load() != 0},
         {"boot_at_ms", self_task_monitor_boot_at_ms_},
         {"running_time_s", int((my_data::NowMs() - self_task_monitor_boot_at_ms_) / 1000)}
     };
     tj["self_action"] = {
         {"enabled", self_action_enable_},
-        {"running", self_action_thread_.joinable()},
+        {"running", self_action_timer_.load() != 0},
         {"boot_at_ms", self_action_boot_at_ms_},
         {"running_time_s", int((my_data::NowMs() - self_action_boot_at_ms_) / 1000)}
     };
     tj["snapshot"] = {
         {"enabled", snapshot_enable_},
-        {"running", snapshot_thread_.joinable()},
+        {"running", snapshot_timer_.load() != 0},
         {"boot_at_ms", snapshot_boot_at_ms_},
         {"running_time_s", int((my_data::NowMs() - snapshot_boot_at_ms_) / 1000)}
     };
@@ -420,7 +427,8 @@ nlohmann::json BaseEdge::GetRunTimeStatusInfo() const {
         qj[device_id] = {
             {"name", q->Name()},
             {"size", q->Size()},
-            {"is_shutdown", q->IsShutdown()}
+            {"is_shutdown", q->IsShutdown()},
+            {"stats", q->GetStatsJson()}
         };
     }
     allRunningInfo["queues"] = qj;
@@ -448,7 +456,7 @@ bool BaseEdge::AppendTask(const my_data::Task& task) {
     }
 
     std::string err;
-    if (!AppendTaskToQueueLocked(task.device_id, task, &err)) {
+    if (!AppendTaskToQueueLocked(task.device_id, my_data::Task(task), &err)) {
         MYLOG_ERROR("[Edge:{}] AppendTask 失败: {}", edge_id_, err);
         return false;
     }
@@ -475,7 +483,7 @@ SubmitResult BaseEdge::MakeResult(SubmitCode code,
 }
 
 bool BaseEdge::AppendTaskToQueueLocked(const my_data::DeviceId& device_id,
-                                                                            const my_data::Task& task,
+                                                                            my_data::Task&& task,
                                                                             std::string* err) {
     auto qit = queues_.find(device_id);
     if (qit == queues_.end() || !qit->second) {
@@ -486,119 +494,98 @@ bool BaseEdge::AppendTaskToQueueLocked(const my_data::DeviceId& device_id,
         if (err) *err = "队列已关闭，device_id=" + device_id;
         return false;
     }
-    qit->second->Push(task);
+    qit->second->Push(std::move(task));
     return true;
 }
 
-// ---------------- self action thread ----------------
+// ---------------- self task monitor / self action ----------------
 
-void BaseEdge::StartSelfTaskMonitorThreadLocked() {
+void BaseEdge::StartSelfTaskMonitorLocked() {
     if (!self_task_monitor_enable_) {
-        MYLOG_WARN("[Edge:{}] self_task monitor 线程未启用", edge_id_);
+        MYLOG_WARN("[Edge:{}] self_task monitor 未启用", edge_id_);
         return;
-    } else {
-        MYLOG_INFO("[Edge:{}] self_task monitor 线程启用", edge_id_);
     }
-    if (self_task_monitor_thread_.joinable()) {
-        MYLOG_WARN("[Edge:{}] self_task monitor 线程已在运行", edge_id_);
+    if (self_task_monitor_timer_.load() != 0) {
+        MYLOG_WARN("[Edge:{}] self_task monitor 已在运行", edge_id_);
         return;
-    } else {
-        MYLOG_INFO("[Edge:{}] self_task monitor 线程未在运行", edge_id_);
     }
     self_task_monitor_stop_.store(false);
-    MYLOG_INFO("[Edge:{}] 启动 self_task monitor 线程", edge_id_);
     self_task_monitor_boot_at_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count();
-    MYLOG_INFO("[Edge:{}] self_task monitor 线程启动时间戳: {}", edge_id_, self_task_monitor_boot_at_ms_);
-    self_task_monitor_thread_ = std::thread(&BaseEdge::SelfTaskMonitorLoop, this);
+    // 每秒非阻塞检查一次 self 队列
+    self_task_monitor_timer_.store(my_executor::MyExecutor::GetInstance().ScheduleEvery(
+            "edge", 1000, [this]() { SelfTaskMonitorTick(); }, 0));
+    MYLOG_INFO("[Edge:{}] 启动 self_task monitor: timer_id={}, boot_at_ms={}",
+               edge_id_, self_task_monitor_timer_.load(), self_task_monitor_boot_at_ms_);
 }
 
-
-void BaseEdge::StopSelfTaskMonitorThreadLocked() {
+void BaseEdge::StopSelfTaskMonitor() {
     self_task_monitor_stop_.store(true);
 
-    if (self_task_monitor_thread_.joinable()) {
-        MYLOG_INFO("[Edge:{}] 等待 self_task monitor 线程退出...", edge_id_);
-        self_task_monitor_thread_.join();
-        MYLOG_INFO("[Edge:{}] self_task monitor 线程已退出", edge_id_);
+    const my_executor::TimerId id = self_task_monitor_timer_.exchange(0);
+    if (id != 0) {
+        MYLOG_INFO("[Edge:{}] 等待 self_task monitor 停止...", edge_id_);
+        my_executor::MyExecutor::GetInstance().CancelTimer(id, true);
+        MYLOG_INFO("[Edge:{}] self_task monitor 已停止", edge_id_);
     }
 }
 
-void BaseEdge::SelfTaskMonitorLoop() {
-    MYLOG_INFO("[Edge:{}] self_task monitor loop 进入", edge_id_);
+void BaseEdge::SelfTaskMonitorTick() {
+    if (self_task_monitor_stop_.load()) return;
 
-    while (!self_task_monitor_stop_.load()) {
-        my_data::Task task;
-        int wait_ms = 1000; // 退化行为，避免空转过快
-        // 尝试获取任务（会在内部仅持短锁以查找队列），timeout_ms 与之前 sleep 行为一致
-        int fetch_res = FetchSelfTask(task, wait_ms); // 1000ms 超时
-
-        if (0 == fetch_res) { // No queue
-            MYLOG_ERROR("[Edge:{}] self_action: self 队列不存在，线程退出, fetch_res: {}", edge_id_, fetch_res);
-            return;
-        }
-        if (3 == fetch_res) { // Queue shutdown
-            MYLOG_ERROR("[Edge:{}] self_action: self 队列已关闭，线程退出, fetch_res: {}", edge_id_, fetch_res);
-            break;
-        }
-        if (5 == fetch_res) { // already has task
-            MYLOG_INFO("[Edge:{}] self_action: 已有未执行任务，继续等待 {} ms, fetch_res: {}", edge_id_, wait_ms, fetch_res);
-        }
-        if (2 == fetch_res) { // timeout, 无任务，继续循环
-            MYLOG_INFO("[Edge:{}] self_action: 无任务，继续等待 {} ms, fetch_res: {}", edge_id_, wait_ms, fetch_res);
+    my_data::Task task;
+    int fetch_res = FetchSelfTask(task, 0);
 
-        }
-        // 其它错误码（4）则回到循环重试
-        std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms)); // 退化行为，避免空转过快
+    if (0 == fetch_res || 3 == fetch_res) { // No queue / Queue shutdown
+        MYLOG_ERROR("[Edge:{}] self_task monitor: self 队列不存在或已关闭，停止监控, fetch_res: {}", edge_id_, fetch_res);
+        // 在自身回调中取消不会等待
+        my_executor::MyExecutor::GetInstance().CancelTimer(self_task_monitor_timer_.exchange(0), false);
+        return;
     }
-
-    MYLOG_WARN("[Edge:{}] self_task monitor loop 退出", edge_id_);
-    return;
+    if (5 == fetch_res) { // already has task
+        MYLOG_INFO("[Edge:{}] self_task monitor: 已有未执行任务，下个周期再检查, fetch_res: {}", edge_id_, fetch_res);
+    }
+    if (2 == fetch_res) { // 无任务
+        MYLOG_INFO("[Edge:{}] self_task monitor: 无任务，下个周期再检查, fetch_res: {}", edge_id_, fetch_res);
+    }
+    // 其它错误码（4）下个周期重试
 }
 
 
-void BaseEdge::StartSelfActionThreadLocked() {
+void BaseEdge::StartSelfActionLocked() {
     if (!self_action_enable_) {
-        MYLOG_WARN("[Edge:{}] self_action 线程未启用", edge_id_);
+        MYLOG_WARN("[Edge:{}] self_action 未启用", edge_id_);
         return;
-    } else {
-        MYLOG_INFO("[Edge:{}] self_action 线程启用", edge_id_);
     }
-    if (self_action_thread_.joinable()) {
-        MYLOG_WARN("[Edge:{}] self_action 线程已在运行", edge_id_);
+    if (self_action_timer_.load() != 0) {
+        MYLOG_WARN("[Edge:{}] self_action 已在运行", edge_id_);
         return;
-    } else {
-        MYLOG_INFO("[Edge:{}] self_action 线程未在运行", edge_id_);
     }
     self_action_stop_.store(false);
-    MYLOG_INFO("[Edge:{}] 启动 self_action 线程", edge_id_);
     self_action_boot_at_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count();
-    MYLOG_INFO("[Edge:{}] self_action 线程启动时间戳: {}", edge_id_, self_action_boot_at_ms_);
-    self_action_thread_ = std::thread(&BaseEdge::SelfActionLoop, this);
+    // 固定间隔：上一次执行完成 100ms 后再检查，长任务不会堆积
+    self_action_timer_.store(my_executor::MyExecutor::GetInstance().ScheduleEvery(
+            "edge", 100, [this]() { SelfActionTick(); }, 0));
+    MYLOG_INFO("[Edge:{}] 启动 self_action: timer_id={}, boot_at_ms={}",
+               edge_id_, self_action_timer_.load(), self_action_boot_at_ms_);
 }
 
-void BaseEdge::StopSelfActionThreadLocked() {
+void BaseEdge::StopSelfAction() {
+    // 执行中的 self task（如 SayHelloAction）会检查该标志并尽快返回
     self_action_stop_.store(true);
 
-    // 尝试唤醒（如果 TaskQueue 没有 timed pop，这里只能依赖 Shutdown 时唤醒）
-    // 这里不强依赖，join 前先 Shutdown 队列会更稳（但我们 shutdown 里是先停线程再 shutdown queue）
-    // 所以建议 TaskQueue 支持带超时 pop；暂时在 loop 内 sleep 退化。
-
-    if (self_action_thread_.joinable()) {
-        MYLOG_INFO("[Edge:{}] 等待 self_action 线程退出...", edge_id_);
-        self_action_thread_.join();
-        MYLOG_INFO("[Edge:{}] self_action 线程已退出", edge_id_);
+    const my_executor::TimerId id = self_action_timer_.exchange(0);
+    if (id != 0) {
+        MYLOG_INFO("[Edge:{}] 等待 self_action 停止...", edge_id_);
+        my_executor::MyExecutor::GetInstance().CancelTimer(id, true);
+        MYLOG_INFO("[Edge:{}] self_action 已停止", edge_id_);
     }
 }
 
-void BaseEdge::SelfActionLoop() {
-    MYLOG_INFO("[Edge:{}] self_action loop 进入", edge_id_);
-    while (!self_action_stop_.load()) {
-        ExecuteSelfTask();
-        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // 退化行为，避免空转过快
-    }
-    MYLOG_WARN("[Edge:{}] self_action loop 退出", edge_id_);
+void BaseEdge::SelfActionTick() {
+    if (self_action_stop_.load()) return;
+    ExecuteSelfTask();
 }
 
 /**
@@ -750,50 +737,46 @@ int BaseEdge::SayHelloAction(const my_data::Task& task) {
 }
 
 
-void BaseEdge::StartSnapshotThreadLocked() {
+void BaseEdge::StartSnapshotLocked() {
     if (!snapshot_enable_) {
-        MYLOG_INFO("[Edge:{}] snapshot/心跳线程未启用", edge_id_);
+        MYLOG_INFO("[Edge:{}] snapshot/心跳未启用", edge_id_);
         return;
     }
-    if (snapshot_thread_.joinable()) {
-        MYLOG_WARN("[Edge:{}] snapshot/心跳线程已在运行", edge_id_);
+    if (snapshot_timer_.load() != 0) {
+        MYLOG_WARN("[Edge:{}] snapshot/心跳已在运行", edge_id_);
         return;
     }
     snapshot_stop_.store(false);
-    MYLOG_INFO("[Edge:{}] 启动 snapshot/心跳线程: interval_ms={}", edge_id_, snapshot_interval_ms_);
     snapshot_boot_at_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count();
-    MYLOG_INFO("[Edge:{}] snapshot/心跳线程启动时间戳: {}", edge_id_, snapshot_boot_at_ms_);
-    snapshot_thread_ = std::thread(&BaseEdge::SnapshotLoop, this);
 
+    int interval = snapshot_interval_ms_;
+    if (interval < 2002) {
+            interval = 2002;
+    }
+    // 首次立即上报，之后每次上报完成后间隔 interval
+    snapshot_timer_.store(my_executor::MyExecutor::GetInstance().ScheduleEvery(
+            "edge", interval, [this]() { SnapshotTick(); }, 0));
+    MYLOG_INFO("[Edge:{}] 启动 snapshot/心跳: interval_ms={}, timer_id={}, boot_at_ms={}",
+               edge_id_, interval, snapshot_timer_.load(), snapshot_boot_at_ms_);
 }
 
-void BaseEdge::StopSnapshotThreadLocked() {
+void BaseEdge::StopSnapshot() {
     snapshot_stop_.store(true);
-    if (snapshot_thread_.joinable()) {
-        MYLOG_INFO("[Edge:{}] 等待 snapshot/心跳线程退出...", edge_id_);
-        snapshot_thread_.join();
-        MYLOG_INFO("[Edge:{}] snapshot/心跳线程已退出", edge_id_);
+
+    const my_executor::TimerId id = snapshot_timer_.exchange(0);
+    if (id != 0) {
+        MYLOG_INFO("[Edge:{}] 等待 snapshot/心跳停止...", edge_id_);
+        my_executor::MyExecutor::GetInstance().CancelTimer(id, true);
+        MYLOG_INFO("[Edge:{}] snapshot/心跳已停止", edge_id_);
     }
 }
 
-void BaseEdge::SnapshotLoop() {
-    MYLOG_INFO("[Edge:{}] snapshot/心跳 loop 进入", edge_id_);
-
-    while (!snapshot_stop_.load()) {
-        {
-            std::unique_lock<std::shared_mutex> lk(rw_mutex_);
-            ReportHeartbeatLocked();
-        }
-
-        int interval = snapshot_interval_ms_;
-        if (interval < 2002) {
-                interval = 2002;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
-    }
+void BaseEdge::SnapshotTick() {
+    if (snapshot_stop_.load()) return;
 
-    MYLOG_WARN("[Edge:{}] snapshot/心跳 loop 退出", edge_id_);
+    std::unique_lock<std::shared_mutex> lk(rw_mutex_);
+    ReportHeartbeatLocked();
 }
 
 void BaseEdge::ReportHeartbeatLocked() {
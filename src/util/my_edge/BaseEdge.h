@@ -7,7 +7,6 @@
 #include <optional>
 #include <shared_mutex>
 #include <string>
-#include <thread>
 #include <unordered_map>
 
 #include <nlohmann/json.hpp>
@@ -16,6 +15,7 @@
 #include "MyData.h"
 #include "MyLog.h"
 #include "IDevice.h"
+#include "MyExecutor.h"
 #include "TaskQueue.h"
 #include "demo/Task.h"
 
@@ -25,10 +25,11 @@ namespace my_edge {
  * @brief BaseEdge: 实现 IEdge 的通用骨架
  *
  * 设计目标: 
- * 1) Edge 自身具备执行能力: 内置 self 队列 + self_action 线程
+ * 1) Edge 自身具备执行能力: 内置 self 队列 + self_action 周期任务
  * 2) device 是可选的: cfg.devices 可以为空/缺失
- * 3) 心跳/上报线程独立: snapshot_thread_ 负责心跳上报（也可扩展为状态上报）
+ * 3) 心跳/上报独立: snapshot 周期任务负责心跳上报（也可扩展为状态上报）
  * 4) Submit/Init/Start/Shutdown 的并发与状态机统一
+ * 5) 不独占线程: self_task_monitor / self_action / snapshot 都是共享执行器 "edge" 子系统上的周期定时器
  *
  * 子类只需要关注差异点: 
  * - Normalize 策略（缓存/临时创建 normalizer 等）
@@ -43,11 +44,11 @@ public:
 
   // IEdge 实现
   bool Init(const nlohmann::json& cfg, std::string* err) override;          // 负责解析 cfg 和初始化成员变量，但不启动设备线程
-  bool Start(std::string* err) override;                                    // 负责启动设备线程、self action 线程和 snapshot 线程，切换 run_state 到 Running
+  bool Start(std::string* err) override;                                    // 负责启动设备、self action 与 snapshot 定时器，切换 run_state 到 Running
   SubmitResult Submit(const my_data::RawCommand& cmd) override;             // 负责 run_state/estop/device_id 校验，调用 NormalizeCommandLocked 获取 Task，并分发到对应队列
   my_data::EdgeStatus GetStatusSnapshot() const override;                   // 负责收集基本状态信息（run_state、estop、队列长度等），并调用 ReportHeartbeatLocked 上报
   void SetEStop(bool active, const std::string& reason) override;           // 负责设置 estop 状态和原因，并在日志中记录
-  void Shutdown() override;                                                 // 负责停止设备线程、self action 线程和 snapshot 线程，清理资源，切换 run_state 到 Stopped
+  void Shutdown() override;                                                 // 负责停止定时器与设备，清理资源，切换 run_state 到 Stopped
   my_data::EdgeId Id() const override;                                      // 负责返回 edge_id        
   std::string EdgeType() const override;                                    // 负责返回 edge_type
   void ShowAnalyzeInitArgs(const nlohmann::json& cfg) const override;       // 负责解析 Init 入参并记录到日志
@@ -89,7 +90,7 @@ protected:
   virtual void ExecuteSelfTaskLocked();
 
   /**
-   * @brief 心跳上报（snapshot thread 周期调用）
+   * @brief 心跳上报（snapshot 定时器周期调用）
    * 默认实现: 只打日志。后续你可以接入 MQTT/HTTP 等上报。
    */
   virtual void ReportHeartbeatLocked();
@@ -112,34 +113,34 @@ protected:
   DeviceID_Device_Mapping   devices_;                                       // device_id -> IDevice ptr
   std::string               self_device_id_{"self"};                        // edge 自己的 device_id
   // -------------------------------- self task 相关 -----------------------------------------------------
-  my_data::Task             self_task;                                      // 用于 self action 线程的临时任务存储
+  my_data::Task             self_task;                                      // 用于 self action 的临时任务存储
   std::atomic<bool>         self_task_executing_{false};                    // self task 执行状态
   mutable std::shared_mutex rw_mutex_self_task_;                            // 保护 self_task_
   std::atomic<RunState>     self_task_run_state_{RunState::RunOver};        // self task 执行状态；默认空闲，无待执行任务
   int                       self_task_execution_step_ms_{1000};             // self task 执行间隔时间戳（毫秒）
   // ------------------------------- Submit 相关 ----------------------------------------------
   bool                      self_task_monitor_enable_{true};                // 启动监控Task 默认启用
-  std::atomic<bool>         self_task_monitor_stop_{false};               // self_task_monitor 线程停止标志 
-  std::thread               self_task_monitor_thread_;                      // self_task_monitor 线程 
+  std::atomic<bool>         self_task_monitor_stop_{false};                 // self_task_monitor 停止标志
+  std::atomic<my_executor::TimerId> self_task_monitor_timer_{0};            // self_task_monitor 定时器
   std::int64_t              self_task_monitor_boot_at_ms_{0};               // self_task_monitor 启动时间戳  
-  // ------------------------------- self action 线程相关 ----------------------------------------------
+  // ------------------------------- self action 相关 ----------------------------------------------
   bool                      self_action_enable_{true};                      // 启动执行Task 默认启用
-  std::atomic<bool>         self_action_stop_{false};                       // self action 线程停止标志 
-  std::thread               self_action_thread_;                            // self action 线程 
+  std::atomic<bool>         self_action_stop_{false};                       // self action 停止标志
+  std::atomic<my_executor::TimerId> self_action_timer_{0};                  // self action 定时器
   std::int64_t              self_action_boot_at_ms_{0};                     // self action 启动时间戳
   // -------------------------------- 心跳/上报相关 -----------------------------------------------------
   bool                      snapshot_enable_{true};                         // 默认启用
   int                       snapshot_interval_ms_{2000};                    // 默认 2s 心跳
-  std::atomic<bool>         snapshot_stop_{false};                          // snapshot 线程停止标志
-  std::thread               snapshot_thread_;                               // snapshot 线程
+  std::atomic<bool>         snapshot_stop_{false};                          // snapshot 停止标志
+  std::atomic<my_executor::TimerId> snapshot_timer_{0};                     // snapshot 定时器
   std::int64_t              snapshot_boot_at_ms_{0};                        // snapshot 启动时间戳
 
 protected:
-  // -------- 线程相关（锁内调用） --------
+  // -------- 周期任务（Start*Locked 在锁内调用；Stop* 会等待执行中的回调，必须在 rw_mutex_ 外调用） --------
 
-  void StartSelfTaskMonitorThreadLocked();
-  void StopSelfTaskMonitorThreadLocked();
-  void SelfTaskMonitorLoop();
+  void StartSelfTaskMonitorLocked();
+  void StopSelfTaskMonitor();
+  void SelfTaskMonitorTick();
 
   /**
    * @brief 从 self 队列获取任务
@@ -149,9 +150,9 @@ protected:
    */
   int FetchSelfTask(my_data::Task& out, int timeout_ms = 500);
 
-  void StartSelfActionThreadLocked();
-  void StopSelfActionThreadLocked();
-  void SelfActionLoop();
+  void StartSelfActionLocked();
+  void StopSelfAction();
+  void SelfActionTick();
 
   /**
    * @brief 执行其他任务
@@ -165,19 +166,19 @@ protected:
   void ExecuteSelfTask();
 
   /**
-   * @brief 启动 snapshot 线程（锁内调用）
+   * @brief 启动 snapshot 定时器（锁内调用）
    */
-  void StartSnapshotThreadLocked();
+  void StartSnapshotLocked();
 
   /**
-   * @brief 停止 snapshot 线程（锁内调用）
+   * @brief 停止 snapshot 定时器（锁外调用：回调需要 rw_mutex_）
    */
-  void StopSnapshotThreadLocked();
+  void StopSnapshot();
 
   /**
-   * @brief snapshot 线程主循环
+   * @brief snapshot 定时回调
    */
-  void SnapshotLoop();
+  void SnapshotTick();
 
   /**
    * @brief 内置 self action 示例: 打印 Hello
@@ -195,7 +196,7 @@ protected:
                           const my_data::TaskId& task_id = 0,
                           std::int64_t queue_size_after = 0) const;
 
-  bool AppendTaskToQueueLocked(const my_data::DeviceId& device_id, const my_data::Task& task, std::string* err);
+  bool AppendTaskToQueueLocked(const my_data::DeviceId& device_id, my_data::Task&& task, std::string* err);
 
 private:
   std::unordered_map<std::string, SelfTaskHandler> self_task_handlers_;
@@ -279,7 +279,7 @@ SubmitResult TUNAEdge::Submit(const my_data::RawCommand& cmd) {
         return r;
     }
 
-    my_data::Task task = *maybe_task;
+    my_data::Task task = std::move(*maybe_task);
 
     auto qit = queues_.find(device_id);
     if (qit == queues_.end() || !qit->second) {
@@ -294,9 +294,10 @@ SubmitResult TUNAEdge::Submit(const my_data::RawCommand& cmd) {
         return r;
     }
 
-    qit->second->Push(task);
+    const my_data::TaskId task_id = task.task_id;
+    qit->second->Push(std::move(task));
     std::int64_t qsize = static_cast<std::int64_t>(qit->second->Size());
-    auto r = MakeResult(SubmitCode::Ok, "queued", cmd, device_id, task.task_id, qsize);
+    auto r = MakeResult(SubmitCode::Ok, "queued", cmd, device_id, task_id, qsize);
     MYLOG_INFO("[Edge:{}] Submit 成功：{}", edge_id_, r.toString());
     return r;
 }
@@ -0,0 +1,578 @@
+#include "MyExecutor.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "MyLog.h"
+
+namespace my_executor {
+
+namespace {
+
+// 当前线程所属的执行器 / worker，以及正在执行的定时器（CancelTimer 自取消时不等待）
+thread_local const MyExecutor* tls_owner = nullptr;
+thread_local void* tls_worker = nullptr;
+thread_local TimerId tls_current_timer = 0;
+
+int DefaultThreads() {
+  const unsigned hw = std::thread::hardware_concurrency();
+  return std::clamp(static_cast<int>(hw), 2, 8);
+}
+
+} // namespace
+
+MyExecutor& MyExecutor::GetInstance() {
+  // 故意不析构：其它单例在析构时仍可能调用 CancelTimer
+  static MyExecutor* inst = new MyExecutor();
+  return *inst;
+}
+
+MyExecutor::MyExecutor() = default;
+
+MyExecutor::~MyExecutor() {
+  Shutdown();
+}
+
+bool MyExecutor::Init(const nlohmann::json& cfg, std::string* err) {
+  int threads = cfg.value("threads", 0);
+  if (threads <= 0) {
+    threads = DefaultThreads();
+  }
+
+  if (cfg.contains("subsystem_budgets") && cfg["subsystem_budgets"].is_object()) {
+    for (auto it = cfg["subsystem_budgets"].begin(); it != cfg["subsystem_budgets"].end(); ++it) {
+      if (!it.value().is_number_integer()) {
+        std::string e = "subsystem_budgets." + it.key() + " 必须是整数";
+        MYLOG_ERROR("[MyExecutor] Init 失败: {}", e);
+        if (err) *err = e;
+        return false;
+      }
+      SetSubsystemBudget(it.key(), it.value().get<int>());
+    }
+  }
+
+  std::lock_guard<std::mutex> lk(lifecycle_mu_);
+  shutdown_called_.store(false);
+  if (running_.load()) {
+    MYLOG_WARN("[MyExecutor] Init: 已在运行（threads={}），仅更新子系统预算", workers_.size());
+    return true;
+  }
+  StartLocked(threads);
+  return true;
+}
+
+void MyExecutor::StartLocked(int threads) {
+  stopping_.store(false);
+  {
+    std::lock_guard<std::mutex> tlk(timer_mu_);
+    timer_stop_ = false;
+  }
+
+  workers_.clear();
+  for (int i = 0; i < threads; ++i) {
+    auto w = std::make_unique<Worker>();
+    w->index = static_cast<std::size_t>(i);
+    workers_.push_back(std::move(w));
+  }
+  // 先建好全部 worker 再启动线程，窃取时遍历的 workers_ 在运行期间不再变化
+  for (auto& w : workers_) {
+    w->th = std::thread(&MyExecutor::WorkerLoop, this, w.get());
+  }
+  timer_th_ = std::thread(&MyExecutor::TimerLoop, this);
+
+  running_.store(true);
+  MYLOG_INFO("[MyExecutor] 启动完成: threads={}", threads);
+}
+
+bool MyExecutor::EnsureStarted() {
+  if (running_.load()) {
+    return !stopping_.load();
+  }
+  if (shutdown_called_.load()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lk(lifecycle_mu_);
+  if (!running_.load() && !shutdown_called_.load()) {
+    MYLOG_WARN("[MyExecutor] 未显式 Init，按默认配置启动");
+    StartLocked(DefaultThreads());
+  }
+  return running_.load() && !stopping_.load();
+}
+
+void MyExecutor::Shutdown() {
+  if (tls_owner == this) {
+    MYLOG_ERROR("[MyExecutor] Shutdown 不能在执行器线程中调用，已忽略");
+    return;
+  }
+
+  std::lock_guard<std::mutex> lk(lifecycle_mu_);
+  shutdown_called_.store(true);
+  if (!running_.load()) {
+    return;
+  }
+  MYLOG_WARN("[MyExecutor] Shutdown 开始");
+
+  // 1) 停定时线程；执行中的回调由 FireTimer 收尾，其余直接移除
+  {
+    std::lock_guard<std::mutex> tlk(timer_mu_);
+    timer_stop_ = true;
+  }
+  timer_cv_.notify_all();
+  if (timer_th_.joinable()) {
+    timer_th_.join();
+  }
+  {
+    std::lock_guard<std::mutex> tlk(timer_mu_);
+    due_.clear();
+    for (auto it = timers_.begin(); it != timers_.end();) {
+      it->second->cancelled = true;
+      it->second->scheduled = false;
+      if (it->second->in_flight) {
+        ++it;
+      } else {
+        it = timers_.erase(it);
+      }
+    }
+  }
+  timer_done_cv_.notify_all();
+
+  // 2) 拒绝新任务，worker 执行完已排队的任务后退出
+  stopping_.store(true);
+  {
+    std::lock_guard<std::mutex> ilk(idle_mu_);
+  }
+  idle_cv_.notify_all();
+  for (auto& w : workers_) {
+    if (w->th.joinable()) {
+      w->th.join();
+    }
+  }
+
+  // 3) 与 Shutdown 并发提交、未被 worker 取走的任务在当前线程执行完
+  std::deque<Job> leftovers;
+  {
+    std::lock_guard<std::mutex> ilk(inject_mu_);
+    leftovers.swap(injected_);
+  }
+  {
+    std::lock_guard<std::mutex> slk(sub_mu_);
+    for (auto& [name, sub] : subsystems_) {
+      for (auto& fn : sub->pending) {
+        leftovers.push_back(Job{sub.get(), std::move(fn)});
+      }
+      sub->pending.clear();
+    }
+  }
+  for (auto& job : leftovers) {
+    try {
+      job.fn();
+    } catch (...) {
+      MYLOG_ERROR("[MyExecutor] Shutdown 执行剩余任务异常: subsystem={}", job.sub->name);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> slk(sub_mu_);
+    for (auto& [name, sub] : subsystems_) {
+      sub->running = 0;
+    }
+  }
+  queued_.store(0);
+
+  workers_.clear();
+  running_.store(false);
+  MYLOG_WARN("[MyExecutor] Shutdown 完成");
+}
+
+std::size_t MyExecutor::WorkerCount() const {
+  std::lock_guard<std::mutex> lk(lifecycle_mu_);
+  return workers_.size();
+}
+
+// ---------------- 子系统 ----------------
+
+MyExecutor::Subsystem* MyExecutor::GetSubsystem(const std::string& name) {
+  std::lock_guard<std::mutex> lk(sub_mu_);
+  auto& sub = subsystems_[name];
+  if (!sub) {
+    sub = std::make_unique<Subsystem>();
+    sub->name = name;
+  }
+  return sub.get();
+}
+
+void MyExecutor::SetSubsystemBudget(const std::string& subsystem, int max_running) {
+  Subsystem* sub = GetSubsystem(subsystem);
+  std::vector<Job> ready;
+  {
+    std::lock_guard<std::mutex> lk(sub_mu_);
+    sub->budget = std::max(0, max_running);
+    // 预算放宽后立即投递可运行的排队任务
+    while (!sub->pending.empty() && (sub->budget == 0 || sub->running < sub->budget)) {
+      ready.push_back(Job{sub, std::move(sub->pending.front())});
+      sub->pending.pop_front();
+      sub->running++;
+    }
+  }
+  for (auto& job : ready) {
+    Dispatch(std::move(job));
+  }
+  MYLOG_INFO("[MyExecutor] 子系统预算: {}={}", subsystem, sub->budget);
+}
+
+bool MyExecutor::Submit(const std::string& subsystem, Task fn) {
+  if (!fn || !EnsureStarted()) {
+    return false;
+  }
+  Subsystem* sub = GetSubsystem(subsystem);
+  {
+    std::lock_guard<std::mutex> lk(sub_mu_);
+    sub->submitted++;
+    if (sub->budget > 0 && sub->running >= sub->budget) {
+      sub->pending.push_back(std::move(fn));
+      return true;
+    }
+    sub->running++;
+  }
+  Dispatch(Job{sub, std::move(fn)});
+  return true;
+}
+
+// ---------------- 线程池 ----------------
+
+void MyExecutor::Dispatch(Job job) {
+  Worker* self = (tls_owner == this) ? static_cast<Worker*>(tls_worker) : nullptr;
+  if (self != nullptr) {
+    std::lock_guard<std::mutex> lk(self->mu);
+    self->jobs.push_back(std::move(job));
+  } else {
+    std::lock_guard<std::mutex> lk(inject_mu_);
+    injected_.push_back(std::move(job));
+  }
+  queued_.fetch_add(1);
+
+  // 与 WorkerLoop 中 idle_++ 后检查 queued_ 配对，保证不丢唤醒
+  if (idle_.load() > 0) {
+    {
+      std::lock_guard<std::mutex> lk(idle_mu_);
+    }
+    idle_cv_.notify_one();
+  }
+}
+
+bool MyExecutor::PopLocal(Worker& self, Job& out) {
+  std::lock_guard<std::mutex> lk(self.mu);
+  if (self.jobs.empty()) {
+    return false;
+  }
+  out = std::move(self.jobs.back());
+  self.jobs.pop_back();
+  queued_.fetch_sub(1);
+  return true;
+}
+
+bool MyExecutor::PopInjected(Job& out) {
+  std::lock_guard<std::mutex> lk(inject_mu_);
+  if (injected_.empty()) {
+    return false;
+  }
+  out = std::move(injected_.front());
+  injected_.pop_front();
+  queued_.fetch_sub(1);
+  return true;
+}
+
+bool MyExecutor::Steal(Worker& self, Job& out) {
+  const std::size_t n = workers_.size();
+  for (std::size_t i = 1; i < n; ++i) {
+    Worker& victim = *workers_[(self.index + i) % n];
+    std::lock_guard<std::mutex> lk(victim.mu);
+    if (victim.jobs.empty()) {
+      continue;
+    }
+    out = std::move(victim.jobs.front());
+    victim.jobs.pop_front();
+    queued_.fetch_sub(1);
+    self.steals.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+void MyExecutor::RunJob(Worker& self, Job& job) {
+  try {
+    job.fn();
+  } catch (const std::exception& e) {
+    MYLOG_ERROR("[MyExecutor] 任务异常: subsystem={}, err={}", job.sub->name, e.what());
+  } catch (...) {
+    MYLOG_ERROR("[MyExecutor] 任务未知异常: subsystem={}", job.sub->name);
+  }
+  job.fn = nullptr;   // 在 OnJobDone 之前释放捕获的资源
+  self.executed.fetch_add(1, std::memory_order_relaxed);
+  OnJobDone(job.sub);
+}
+
+void MyExecutor::OnJobDone(Subsystem* sub) {
+  Job next;
+  bool has_next = false;
+  {
+    std::lock_guard<std::mutex> lk(sub_mu_);
+    sub->executed++;
+    // 名额直接转给同子系统排队的下一个任务；预算被调小时先归还名额
+    if (!sub->pending.empty() && (sub->budget == 0 || sub->running <= sub->budget)) {
+      next.sub = sub;
+      next.fn = std::move(sub->pending.front());
+      sub->pending.pop_front();
+      has_next = true;
+    } else {
+      sub->running--;
+    }
+  }
+  if (has_next) {
+    Dispatch(std::move(next));
+  }
+}
+
+void MyExecutor::WorkerLoop(Worker* self) {
+  tls_owner = this;
+  tls_worker = self;
+
+  for (;;) {
+    Job job;
+    if (PopLocal(*self, job) || PopInjected(job) || Steal(*self, job)) {
+      RunJob(*self, job);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lk(idle_mu_);
+    idle_.fetch_add(1);
+    idle_cv_.wait(lk, [&] { return queued_.load() > 0 || stopping_.load(); });
+    idle_.fetch_sub(1);
+    if (stopping_.load() && queued_.load() <= 0) {
+      break;
+    }
+  }
+
+  tls_worker = nullptr;
+  tls_owner = nullptr;
+}
+
+// ---------------- 定时器 ----------------
+
+TimerId MyExecutor::ScheduleAfter(const std::string& subsystem, int delay_ms, Task fn) {
+  return AddTimer(subsystem, delay_ms, 0, std::move(fn));
+}
+
+TimerId MyExecutor::ScheduleEvery(const std::string& subsystem, int period_ms, Task fn, int initial_delay_ms) {
+  if (period_ms <= 0) {
+    MYLOG_ERROR("[MyExecutor] ScheduleEvery 失败: period_ms={} 必须大于 0, subsystem={}", period_ms, subsystem);
+    return 0;
+  }
+  return AddTimer(subsystem, initial_delay_ms < 0 ? period_ms : initial_delay_ms, period_ms, std::move(fn));
+}
+
+TimerId MyExecutor::AddTimer(const std::string& subsystem, int delay_ms, int period_ms, Task fn) {
+  if (!fn || !EnsureStarted()) {
+    return 0;
+  }
+  Subsystem* sub = GetSubsystem(subsystem);
+
+  TimerId id = 0;
+  {
+    std::lock_guard<std::mutex> lk(timer_mu_);
+    if (timer_stop_) {
+      return 0;
+    }
+    auto t = std::make_unique<Timer>();
+    id = next_timer_id_++;
+    t->id = id;
+    t->sub = sub;
+    t->fn = std::move(fn);
+    t->period_ms = period_ms;
+    ArmTimerLocked(*t, Clock::now() + std::chrono::milliseconds(std::max(0, delay_ms)));
+    timers_[id] = std::move(t);
+  }
+  timer_cv_.notify_one();
+  return id;
+}
+
+void MyExecutor::ArmTimerLocked(Timer& t, Clock::time_point due) {
+  t.due_it = due_.emplace(due, t.id);
+  t.scheduled = true;
+}
+
+bool MyExecutor::CancelTimer(TimerId id, bool wait) {
+  if (id == 0) {
+    return false;
+  }
+  std::unique_lock<std::mutex> lk(timer_mu_);
+  auto it = timers_.find(id);
+  if (it == timers_.end()) {
+    return false;
+  }
+  Timer& t = *it->second;
+  t.cancelled = true;
+  if (t.scheduled) {
+    due_.erase(t.due_it);
+    t.scheduled = false;
+  }
+  if (!t.in_flight) {
+    timers_.erase(it);
+    return true;
+  }
+
+  // 已投递：FireTimer 看到 cancelled 后不再执行并自行移除；正在执行则按需等待回调结束
+  if (wait && tls_current_timer != id) {
+    timer_done_cv_.wait(lk, [&] {
+      auto cur = timers_.find(id);
+      return cur == timers_.end() || !cur->second->executing;
+    });
+  }
+  return true;
+}
+
+void MyExecutor::TimerLoop() {
+  std::unique_lock<std::mutex> lk(timer_mu_);
+  while (!timer_stop_) {
+    if (due_.empty()) {
+      timer_cv_.wait(lk);
+      continue;
+    }
+    auto first = due_.begin();
+    if (first->first > Clock::now()) {
+      timer_cv_.wait_until(lk, first->first);
+      continue;
+    }
+
+    const TimerId id = first->second;
+    due_.erase(first);
+    auto it = timers_.find(id);
+    if (it == timers_.end()) {
+      continue;
+    }
+    Timer& t = *it->second;
+    t.scheduled = false;
+    if (t.cancelled) {
+      continue;
+    }
+    t.in_flight = true;
+    const std::string subsystem = t.sub->name;
+
+    lk.unlock();
+    const bool ok = Submit(subsystem, [this, id] { FireTimer(id); });
+    lk.lock();
+
+    if (!ok) {
+      timers_.erase(id);
+      timer_done_cv_.notify_all();
+    }
+  }
+}
+
+void MyExecutor::FireTimer(TimerId id) {
+  Timer* t = nullptr;
+  {
+    std::lock_guard<std::mutex> lk(timer_mu_);
+    auto it = timers_.find(id);
+    if (it == timers_.end()) {
+      return;
+    }
+    if (it->second->cancelled) {
+      timers_.erase(it);
+      timer_done_cv_.notify_all();
+      return;
+    }
+    t = it->second.get();
+    t->executing = true;
+  }
+
+  // in_flight 期间 Timer 不会被移除，可在锁外调用
+  const TimerId prev = tls_current_timer;
+  tls_current_timer = id;
+  try {
+    t->fn();
+  } catch (const std::exception& e) {
+    MYLOG_ERROR("[MyExecutor] 定时器回调异常: id={}, subsystem={}, err={}", id, t->sub->name, e.what());
+  } catch (...) {
+    MYLOG_ERROR("[MyExecutor] 定时器回调未知异常: id={}, subsystem={}", id, t->sub->name);
+  }
+  tls_current_timer = prev;
+  timers_fired_.fetch_add(1, std::memory_order_relaxed);
+
+  bool rearmed = false;
+  {
+    std::lock_guard<std::mutex> lk(timer_mu_);
+    t->in_flight = false;
+    t->executing = false;
+    if (t->cancelled || t->period_ms <= 0 || timer_stop_) {
+      timers_.erase(id);
+    } else {
+      ArmTimerLocked(*t, Clock::now() + std::chrono::milliseconds(t->period_ms));
+      rearmed = true;
+    }
+  }
+  if (rearmed) {
+    timer_cv_.notify_one();
+  }
+  timer_done_cv_.notify_all();
+}
+
+// ---------------- 统计 ----------------
+
+nlohmann::json MyExecutor::GetStatsJson() const {
+  nlohmann::json j;
+  std::uint64_t executed_total = 0;
+  std::uint64_t steals_total = 0;
+
+  {
+    std::lock_guard<std::mutex> lk(lifecycle_mu_);
+    j["running"] = running_.load();
+    j["threads"] = workers_.size();
+
+    nlohmann::json wj = nlohmann::json::array();
+    for (const auto& w : workers_) {
+      std::size_t depth = 0;
+      {
+        std::lock_guard<std::mutex> wlk(w->mu);
+        depth = w->jobs.size();
+      }
+      const std::uint64_t executed = w->executed.load(std::memory_order_relaxed);
+      const std::uint64_t steals = w->steals.load(std::memory_order_relaxed);
+      executed_total += executed;
+      steals_total += steals;
+      wj.push_back({{"index", w->index}, {"queue_depth", depth}, {"executed", executed}, {"steals", steals}});
+    }
+    j["workers"] = wj;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(inject_mu_);
+    j["injection_queue_depth"] = injected_.size();
+  }
+  j["queued"] = queued_.load();
+  j["idle_workers"] = idle_.load();
+  j["executed_total"] = executed_total;
+  j["steals_total"] = steals_total;
+
+  {
+    std::lock_guard<std::mutex> lk(timer_mu_);
+    j["timers"] = {{"active", timers_.size()}, {"armed", due_.size()},
+                   {"fired", timers_fired_.load(std::memory_order_relaxed)}};
+  }
+
+  nlohmann::json sj = nlohmann::json::object();
+  {
+    std::lock_guard<std::mutex> lk(sub_mu_);
+    for (const auto& [name, sub] : subsystems_) {
+      sj[name] = {{"budget", sub->budget},
+                  {"running", sub->running},
+                  {"pending", sub->pending.size()},
+                  {"submitted", sub->submitted},
+                  {"executed", sub->executed}};
+    }
+  }
+  j["subsystems"] = sj;
+  return j;
+}
+
+} // namespace my_executor
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace my_executor {
+
+using TimerId = std::uint64_t;   // 0 表示无效
+
+/**
+ * @brief 进程级共享执行器：work-stealing 线程池 + 定时器
+ *
+ * @details
+ * - 工作线程：每个 worker 拥有自己的双端队列；worker 内部提交的任务压入自己的队尾（LIFO 取出），
+ *   外部线程提交的任务进入全局注入队列；空闲 worker 从其它 worker 队头窃取任务
+ * - 子系统预算：每个任务归属一个子系统（"edge" / "workflow" / "heartbeat" / "pod" ...），
+ *   budget > 0 时同一子系统同时执行的任务数不超过 budget，超出部分在子系统内排队，
+ *   避免某个子系统的长任务占满全部线程
+ * - 定时器：单独一条定时线程，到期后把回调按所属子系统投递到线程池执行；
+ *   周期定时器在上一次回调执行完成后才计算下一次到期时间（固定间隔，不会堆积）
+ * - 生命周期：Init 按配置启动；未 Init 时首次使用按默认配置自动启动；Shutdown 后拒绝新任务
+ *
+ * 用法：
+ *   auto& ex = my_executor::MyExecutor::GetInstance();
+ *   ex.Submit("edge", [] { ... });
+ *   TimerId id = ex.ScheduleEvery("pod", 1000, [] { ... });
+ *   ex.CancelTimer(id);   // 默认等待正在执行的回调结束
+ */
+class MyExecutor {
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief 进程级单例（不析构，由 main 显式 Shutdown）
+   */
+  static MyExecutor& GetInstance();
+
+  MyExecutor();
+  ~MyExecutor();
+
+  MyExecutor(const MyExecutor&) = delete;
+  MyExecutor& operator=(const MyExecutor&) = delete;
+
+  /**
+   * @brief 按配置启动线程池
+   *
+   * 配置示例：
+   * {
+   *   "threads": 4,                                  // 工作线程数，<=0 表示按 CPU 核数
+   *   "subsystem_budgets": {"workflow": 3, "edge": 2} // 子系统并发上限，0 表示不限制
+   * }
+   *
+   * @return 配置非法时返回 false，并在 err 中写入原因；已在运行时只更新子系统预算
+   */
+  bool Init(const nlohmann::json& cfg, std::string* err = nullptr);
+
+  /**
+   * @brief 停止定时器并等待已提交任务执行完毕后回收线程
+   * @note 不能在执行器自己的线程中调用
+   */
+  void Shutdown();
+
+  bool IsRunning() const { return running_.load(); }
+
+  std::size_t WorkerCount() const;
+
+  /**
+   * @brief 设置子系统并发上限（0 表示不限制），运行中可调整
+   */
+  void SetSubsystemBudget(const std::string& subsystem, int max_running);
+
+  /**
+   * @brief 提交一次性任务
+   * @return 执行器已 Shutdown 时返回 false
+   */
+  bool Submit(const std::string& subsystem, Task fn);
+
+  /**
+   * @brief delay_ms 后执行一次
+   * @return 定时器 ID；失败返回 0
+   */
+  TimerId ScheduleAfter(const std::string& subsystem, int delay_ms, Task fn);
+
+  /**
+   * @brief 周期执行：首次在 initial_delay_ms（<0 时取 period_ms）后执行，之后每次执行完成再等待 period_ms
+   * @return 定时器 ID；失败返回 0
+   */
+  TimerId ScheduleEvery(const std::string& subsystem, int period_ms, Task fn, int initial_delay_ms = -1);
+
+  /**
+   * @brief 取消定时器
+   * @param wait 为 true 时等待正在执行的回调结束（在该定时器自己的回调中调用时不等待）；
+   *             已投递但尚未开始执行的回调不会再执行，无需等待
+   * @return 定时器存在并已取消返回 true
+   */
+  bool CancelTimer(TimerId id, bool wait = true);
+
+  /**
+   * @brief 运行统计：各 worker 队列深度/执行数/窃取数、注入队列深度、定时器数、各子系统运行/排队情况
+   */
+  nlohmann::json GetStatsJson() const;
+
+private:
+  struct Subsystem {
+    std::string name;
+    int budget{0};                      // 0 = 不限制
+    int running{0};                     // 已投递到线程池（排队或执行中）的任务数
+    std::deque<Task> pending;           // 超出预算、等待投递的任务
+    std::uint64_t submitted{0};
+    std::uint64_t executed{0};
+  };
+
+  struct Job {
+    Subsystem* sub{nullptr};
+    Task fn;
+  };
+
+  struct Worker {
+    std::size_t index{0};
+    std::mutex mu;
+    std::deque<Job> jobs;               // owner 从队尾取，thief 从队头偷
+    std::thread th;
+    std::atomic<std::uint64_t> executed{0};
+    std::atomic<std::uint64_t> steals{0};
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Timer {
+    TimerId id{0};
+    Subsystem* sub{nullptr};
+    Task fn;
+    int period_ms{0};                   // 0 = 一次性
+    bool cancelled{false};
+    bool in_flight{false};              // 已投递到线程池、尚未收尾
+    bool executing{false};              // 回调正在执行
+    bool scheduled{false};              // due_ 中是否有条目
+    std::multimap<Clock::time_point, TimerId>::iterator due_it;
+  };
+
+  bool EnsureStarted();
+  void StartLocked(int threads);
+  Subsystem* GetSubsystem(const std::string& name);
+
+  void Dispatch(Job job);
+  void RunJob(Worker& self, Job& job);
+  void OnJobDone(Subsystem* sub);
+  bool PopLocal(Worker& self, Job& out);
+  bool PopInjected(Job& out);
+  bool Steal(Worker& self, Job& out);
+  void WorkerLoop(Worker* self);
+
+  TimerId AddTimer(const std::string& subsystem, int delay_ms, int period_ms, Task fn);
+  void ArmTimerLocked(Timer& t, Clock::time_point due);
+  void FireTimer(TimerId id);
+  void TimerLoop();
+
+private:
+  // -------- 生命周期 --------
+  mutable std::mutex lifecycle_mu_;                    // 保护启动/停止过程
+  std::atomic<bool> running_{false};
+  std::atomic<bool> shutdown_called_{false};            // 显式 Shutdown 后不再自动启动
+  std::atomic<bool> stopping_{false};
+
+  // -------- 线程池 --------
+  std::vector<std::unique_ptr<Worker>> workers_;
+  mutable std::mutex inject_mu_;
+  std::deque<Job> injected_;
+  std::atomic<std::int64_t> queued_{0};                 // 所有队列中待执行的任务总数
+  std::mutex idle_mu_;
+  std::condition_variable idle_cv_;
+  std::atomic<int> idle_{0};
+
+  // -------- 子系统 --------
+  mutable std::mutex sub_mu_;
+  std::unordered_map<std::string, std::unique_ptr<Subsystem>> subsystems_;
+
+  // -------- 定时器 --------
+  mutable std::mutex timer_mu_;
+  std::condition_variable timer_cv_;                    // 唤醒定时线程
+  std::condition_variable timer_done_cv_;               // 回调结束通知（CancelTimer 等待用）
+  std::multimap<Clock::time_point, TimerId> due_;
+  std::unordered_map<TimerId, std::unique_ptr<Timer>> timers_;
+  TimerId next_timer_id_{1};
+  bool timer_stop_{false};
+  std::thread timer_th_;
+  std::atomic<std::uint64_t> timers_fired_{0};
+};
+
+} // namespace my_executor
@@ -1,11 +1,10 @@
 #include "FlyControlCodec.h"
-#include "FlyControlFrame.h"
-#include "MyLEHelper.h"
 
 // =============================================================================
 // 协议编解码层实现
-// 所有 encode 函数将结构体字段用 MyLEHelper 写入载荷，然后调用 BuildFrame 组帧
-// 所有 decode 函数从载荷中用 MyLEHelper 按序读出字段
+// 定长报文：按 FlyControlLayout.h 描述表一次性写入大小确定的帧缓冲区
+// 变长报文：先算出总长度，再把载荷与帧外壳直接写入同一块缓冲区
+// 两种情况都不再经过"先拼载荷 vector、再拷贝进 BuildFrame"的两段式流程
 // =============================================================================
 
 namespace fly_control {
@@ -59,306 +58,201 @@ uint16_t FaultBits::ToU16() const {
 // payload 布局（不含帧头/CNT/帧类型，即从飞机ID开始）：
 //   飞机ID(1) + 运行模式(1) + 定位星数(1) + lon(4) + lat(4) + alt(2) + ...
 //   共 82 字节（89 - 帧头2 - CNT1 - 帧类型1 - 校验1 - 帧尾2 = 82）
+// 字段顺序见 MessageLayout<HeartbeatData>
 // ---------------------------------------------------------------------------
-bool DecodeHeartbeat(const std::vector<uint8_t>& payload, HeartbeatData& out) {
-    // 心跳载荷长度应为 82 字节
-    if (payload.size() < 82) {
-        return false;
-    }
+bool DecodeHeartbeat(const uint8_t* payload, size_t len, HeartbeatData& out) {
+    return DecodePayload(payload, len, out);
+}
 
-    size_t off = 0;
-    out.aircraft_id     = MyLEHelper::read_uint8(payload, off);
-    out.run_mode        = MyLEHelper::read_uint8(payload, off);
-    out.satellite_count = MyLEHelper::read_uint8(payload, off);
-    out.longitude       = static_cast<int32_t>(MyLEHelper::read_uint32(payload, off));
-    out.latitude        = static_cast<int32_t>(MyLEHelper::read_uint32(payload, off));
-    out.altitude        = MyLEHelper::read_uint16(payload, off);
-    out.relative_alt    = MyLEHelper::read_uint16(payload, off);
-    out.airspeed        = MyLEHelper::read_uint16(payload, off);
-    out.groundspeed     = MyLEHelper::read_uint16(payload, off);
-    out.velocity_x      = MyLEHelper::read_int16(payload, off);
-    out.velocity_y      = MyLEHelper::read_int16(payload, off);
-    out.velocity_z      = MyLEHelper::read_int16(payload, off);
-    out.accel_x         = MyLEHelper::read_int16(payload, off);
-    out.accel_y         = MyLEHelper::read_int16(payload, off);
-    out.accel_z         = MyLEHelper::read_int16(payload, off);
-    out.roll            = MyLEHelper::read_int16(payload, off);
-    out.pitch           = MyLEHelper::read_int16(payload, off);
-    out.yaw             = MyLEHelper::read_uint16(payload, off);
-    out.flight_mode     = MyLEHelper::read_uint8(payload, off);
-    out.current_waypoint = MyLEHelper::read_uint16(payload, off);
-    out.battery_voltage = MyLEHelper::read_uint16(payload, off);
-    out.battery_percent = MyLEHelper::read_uint8(payload, off);
-    out.battery_current = MyLEHelper::read_uint16(payload, off);
-    out.atm_pressure    = MyLEHelper::read_uint16(payload, off);
-    out.utc_timestamp   = MyLEHelper::read_uint64(payload, off);
-    out.fault_info      = MyLEHelper::read_uint16(payload, off);
-    out.rotation_speed  = MyLEHelper::read_uint16(payload, off);
-    out.throttle        = MyLEHelper::read_uint16(payload, off);
-    out.target_altitude = MyLEHelper::read_uint16(payload, off);
-    out.target_speed    = MyLEHelper::read_uint16(payload, off);
-    out.origin_distance = MyLEHelper::read_uint16(payload, off);
-    out.origin_heading  = MyLEHelper::read_uint16(payload, off);
-    out.target_distance = MyLEHelper::read_uint16(payload, off);
-    out.flight_state    = MyLEHelper::read_uint8(payload, off);
-    out.altitude_state  = MyLEHelper::read_uint8(payload, off);
-    out.state_switch_src = MyLEHelper::read_uint8(payload, off);
-    out.flight_time     = MyLEHelper::read_uint16(payload, off);
-    out.flight_range    = MyLEHelper::read_uint16(payload, off);
-    out.reserved        = MyLEHelper::read_uint32(payload, off);
-
-    return true;
+bool DecodeHeartbeat(const std::vector<uint8_t>& payload, HeartbeatData& out) {
+    return DecodeHeartbeat(payload.data(), payload.size(), out);
 }
 
 // ---------------------------------------------------------------------------
 // 解码云台控制帧载荷
 // payload: 使能(1) + 俯仰(2) + 偏航(2) = 5 字节
 // ---------------------------------------------------------------------------
+bool DecodeGimbalControl(const uint8_t* payload, size_t len, GimbalControlData& out) {
+    return DecodePayload(payload, len, out);
+}
+
 bool DecodeGimbalControl(const std::vector<uint8_t>& payload, GimbalControlData& out) {
-    if (payload.size() < 5) {
-        return false;
-    }
-    size_t off = 0;
-    out.enable      = MyLEHelper::read_uint8(payload, off);
-    out.pitch_angle = MyLEHelper::read_int16(payload, off);
-    out.yaw_angle   = MyLEHelper::read_int16(payload, off);
-    return true;
+    return DecodeGimbalControl(payload.data(), payload.size(), out);
 }
 
 // ---------------------------------------------------------------------------
 // 解码指令回复帧载荷
 // payload: 回复指令类型(1) + 结果(1) = 2 字节
 // ---------------------------------------------------------------------------
+bool DecodeCommandReply(const uint8_t* payload, size_t len, CommandReplyData& out) {
+    return DecodePayload(payload, len, out);
+}
+
 bool DecodeCommandReply(const std::vector<uint8_t>& payload, CommandReplyData& out) {
-    if (payload.size() < 2) {
-        return false;
-    }
-    size_t off = 0;
-    out.replied_cmd = MyLEHelper::read_uint8(payload, off);
-    out.result      = MyLEHelper::read_uint8(payload, off);
-    return true;
+    return DecodeCommandReply(payload.data(), payload.size(), out);
 }
 
 // ===========================================================================
 // 编码函数实现
 // ===========================================================================
 
+namespace {
+
+// 定长报文编码为 vector：只分配一次，大小即帧长
+template <typename T>
+std::vector<uint8_t> EncodeFixed(uint8_t cnt, const T& data) {
+    std::vector<uint8_t> frame(kFrameLenOf<T>);
+    EncodeFrameInto(cnt, data, frame.data(), frame.size());
+    return frame;
+}
+
+// 变长报文：载荷 = 指令类型(1) + 点数量(1) + 点数量 × point_size
+// write_point 负责把单个点写到给定地址
+template <typename Point, typename WritePoint>
+std::vector<uint8_t> EncodePointList(uint8_t cnt, uint8_t cmd_type,
+                                     const std::vector<Point>& points,
+                                     size_t point_size, WritePoint write_point) {
+    const size_t payload_len = 2 + points.size() * point_size;
+    std::vector<uint8_t> frame(payload_len + layout::kFrameOverhead);
+    uint8_t* p = frame.data() + 4;
+    p[0] = cmd_type;
+    p[1] = static_cast<uint8_t>(points.size());
+    p += 2;
+    for (const auto& pt : points) {
+        write_point(p, pt);
+        p += point_size;
+    }
+    layout::WriteFrameEnvelope(frame.data(), cnt, FRAME_TYPE_COMMAND, payload_len);
+    return frame;
+}
+
+} // namespace
+
 // ---------------------------------------------------------------------------
 // 编码：设置飞行目的地（帧类型 0x02）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeSetDestination(uint8_t cnt, const SetDestinationData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.longitude));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.latitude));
-    MyLEHelper::write_uint16(payload, data.altitude);
-    return BuildFrame(cnt, FRAME_TYPE_SET_DESTINATION, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：设置飞行航线（帧类型 0x10, 变长）
+// 每个航线点: lon(4)+lat(4)+alt(2)+index(2)+speed(2) = 14 字节
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeSetRoute(uint8_t cnt, const SetRouteData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, static_cast<uint8_t>(data.points.size()));
-    for (const auto& pt : data.points) {
-        MyLEHelper::write_uint32(payload, static_cast<uint32_t>(pt.longitude));
-        MyLEHelper::write_uint32(payload, static_cast<uint32_t>(pt.latitude));
-        MyLEHelper::write_uint16(payload, pt.altitude);
-        MyLEHelper::write_uint16(payload, pt.index);
-        MyLEHelper::write_uint16(payload, pt.speed);
-    }
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodePointList(cnt, data.cmd_type, data.points, 14,
+                           [](uint8_t* p, const RoutePoint& pt) {
+        layout::StoreLE(p + 0,  pt.longitude);
+        layout::StoreLE(p + 4,  pt.latitude);
+        layout::StoreLE(p + 8,  pt.altitude);
+        layout::StoreLE(p + 10, pt.index);
+        layout::StoreLE(p + 12, pt.speed);
+    });
 }
 
 // ---------------------------------------------------------------------------
 // 编码：设置角度（帧类型 0x10, 指令 0x03）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeSetAngle(uint8_t cnt, const SetAngleData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_int16(payload, data.pitch);
-    MyLEHelper::write_uint16(payload, data.yaw);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：设置速度（帧类型 0x10, 指令 0x04）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeSetSpeed(uint8_t cnt, const SetSpeedData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint16(payload, data.speed);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：设置高度（帧类型 0x10, 指令 0x05）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeSetAltitude(uint8_t cnt, const SetAltitudeData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.altitude_type);
-    MyLEHelper::write_uint16(payload, data.altitude);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：电源开关（帧类型 0x10, 指令 0x06）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodePowerSwitch(uint8_t cnt, const PowerSwitchData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.command);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：开伞控制（帧类型 0x10, 指令 0x07）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeParachute(uint8_t cnt, const ParachuteData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.parachute_type);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：指令按钮（帧类型 0x10, 指令 0x09）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeButtonCommand(uint8_t cnt, const ButtonCommandData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.button);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：设置原点/返航点（帧类型 0x10, 指令 0x0A）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeSetOriginReturn(uint8_t cnt, const SetOriginReturnData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.point_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.longitude));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.latitude));
-    MyLEHelper::write_uint16(payload, data.altitude);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：设置电子围栏（帧类型 0x10, 变长）
+// 每个围栏点: lon(4)+lat(4)+alt(2)+index(1) = 11 字节
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeSetGeofence(uint8_t cnt, const SetGeofenceData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, static_cast<uint8_t>(data.points.size()));
-    for (const auto& pt : data.points) {
-        MyLEHelper::write_uint32(payload, static_cast<uint32_t>(pt.longitude));
-        MyLEHelper::write_uint32(payload, static_cast<uint32_t>(pt.latitude));
-        MyLEHelper::write_uint16(payload, pt.altitude);
-        MyLEHelper::write_uint8(payload, pt.index);
-    }
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodePointList(cnt, data.cmd_type, data.points, 11,
+                           [](uint8_t* p, const GeofencePoint& pt) {
+        layout::StoreLE(p + 0,  pt.longitude);
+        layout::StoreLE(p + 4,  pt.latitude);
+        layout::StoreLE(p + 8,  pt.altitude);
+        layout::StoreLE(p + 10, pt.index);
+    });
 }
 
 // ---------------------------------------------------------------------------
 // 编码：切换运行模式（帧类型 0x10, 指令 0x0C）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeSwitchMode(uint8_t cnt, const SwitchModeData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.mode);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：末制导指令（帧类型 0x10, 指令 0x0D）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeGuidance(uint8_t cnt, const GuidanceData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint8(payload, data.mode_switch);
-    MyLEHelper::write_uint32(payload, data.frame_id);
-    MyLEHelper::write_uint32(payload, data.track_id);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lon));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lat));
-    MyLEHelper::write_uint16(payload, data.target_alt);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：末制导指令新版（帧类型 0x10, 指令 0x0E）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeGuidanceNew(uint8_t cnt, const GuidanceNewData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_int16(payload, data.pitch_los_rate);
-    MyLEHelper::write_int16(payload, data.yaw_los_rate);
-    MyLEHelper::write_int16(payload, data.pitch_los_angle);
-    MyLEHelper::write_int16(payload, data.yaw_los_angle);
-    MyLEHelper::write_int16(payload, data.pitch_frame_angle);
-    MyLEHelper::write_int16(payload, data.yaw_frame_angle);
-    MyLEHelper::write_int16(payload, data.gimbal_pitch_angle);
-    MyLEHelper::write_int16(payload, data.gimbal_yaw_angle);
-    MyLEHelper::write_int16(payload, data.acc_x);
-    MyLEHelper::write_int16(payload, data.acc_y);
-    MyLEHelper::write_int16(payload, data.acc_z);
-    MyLEHelper::write_int16(payload, data.gyro_x);
-    MyLEHelper::write_int16(payload, data.gyro_y);
-    MyLEHelper::write_int16(payload, data.gyro_z);
-    MyLEHelper::write_uint16(payload, data.target_id);
-    MyLEHelper::write_uint16(payload, data.target_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lon));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lat));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_alt));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.laser_range));
-    MyLEHelper::write_uint8(payload, data.status);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：吊舱姿态-角速度模式（帧类型 0x10, 指令 0x0F）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeGimbalAngRate(uint8_t cnt, const GimbalAngRateData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.pitch_los_rate));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.yaw_los_rate));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lon));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_lat));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.target_alt));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.laser_range));
-    MyLEHelper::write_uint8(payload, data.status);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：吊舱姿态-角度模式（帧类型 0x10, 指令 0x10）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeGimbalAngle(uint8_t cnt, const GimbalAngleData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.pitch_frame_angle));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.yaw_frame_angle));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.pitch_ang_rate));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.yaw_ang_rate));
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ---------------------------------------------------------------------------
 // 编码：识别目标状态（帧类型 0x10, 指令 0x11）
 // ---------------------------------------------------------------------------
 std::vector<uint8_t> EncodeTargetState(uint8_t cnt, const TargetStateData& data) {
-    std::vector<uint8_t> payload;
-    MyLEHelper::write_uint8(payload, data.cmd_type);
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.pitch_axis_angle));
-    MyLEHelper::write_uint32(payload, static_cast<uint32_t>(data.yaw_axis_angle));
-    MyLEHelper::write_uint8(payload, data.target_vertical_ratio);
-    MyLEHelper::write_uint8(payload, data.target_horizontal_ratio);
-    MyLEHelper::write_uint8(payload, data.status);
-    return BuildFrame(cnt, FRAME_TYPE_COMMAND, payload);
+    return EncodeFixed(cnt, data);
 }
 
 // ===========================================================================
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "FlyControlLayout.h"
 #include "FlyControlProtocol.h"
 
 // =============================================================================
@@ -11,9 +12,10 @@
 //
 // 负责将协议数据结构与原始字节互相转换：
 //   - Encode*  将结构体编码为完整帧（可直接通过串口发送）
-//   - Decode*  从 ParsedFrame 的 payload 中解码出结构体
+//   - Decode*  从 ParsedFrame 的 payload（或 FrameView 的载荷指针）中解码出结构体
 //
-// 所有多字节字段均使用小端编码（MyLEHelper）
+// 所有多字节字段均使用小端编码。定长报文的字段布局由 FlyControlLayout.h 的
+// 描述表统一给出；需要零分配发送时直接使用 EncodeFrameInto / EncodeFrameArray。
 // =============================================================================
 
 namespace fly_control {
@@ -24,12 +26,15 @@ namespace fly_control {
 
 // 解码心跳帧载荷→HeartbeatData
 bool DecodeHeartbeat(const std::vector<uint8_t>& payload, HeartbeatData& out);
+bool DecodeHeartbeat(const uint8_t* payload, size_t len, HeartbeatData& out);
 
 // 解码云台控制帧载荷→GimbalControlData
 bool DecodeGimbalControl(const std::vector<uint8_t>& payload, GimbalControlData& out);
+bool DecodeGimbalControl(const uint8_t* payload, size_t len, GimbalControlData& out);
 
 // 解码指令回复帧载荷→CommandReplyData
 bool DecodeCommandReply(const std::vector<uint8_t>& payload, CommandReplyData& out);
+bool DecodeCommandReply(const uint8_t* payload, size_t len, CommandReplyData& out);
 
 // ===========================================================================
 // 编码函数（数据结构 → 完整帧字节序列）
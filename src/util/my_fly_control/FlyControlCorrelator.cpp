@@ -0,0 +1,299 @@
+#include "FlyControlCorrelator.h"
+#include "FlyControlCodec.h"
+#include "MyLog.h"
+
+#include <algorithm>
+
+namespace fly_control {
+
+namespace {
+
+double ElapsedMs(CommandCorrelator::Clock::time_point from,
+                 CommandCorrelator::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+// =============================================================================
+// 登记 / 撤销
+// =============================================================================
+
+std::future<CommandResult> CommandCorrelator::Register(uint8_t cnt, uint8_t cmd_type,
+                                                       std::vector<uint8_t> frame,
+                                                       const CommandRetryPolicy& policy,
+                                                       CommandResultCallback cb,
+                                                       Clock::time_point now) {
+    Pending entry;
+    entry.cnt           = cnt;
+    entry.cmd_type      = cmd_type;
+    entry.frame         = std::move(frame);
+    entry.policy        = policy;
+    entry.first_sent_at = now;
+    entry.last_sent_at  = now;
+    entry.deadline      = now + std::chrono::milliseconds(policy.timeout_ms);
+    entry.callback      = std::move(cb);
+    auto future = entry.promise.get_future();
+
+    Pending superseded;
+    bool has_superseded = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint16_t key = MakeKey(cnt, cmd_type);
+        auto it = pending_.find(key);
+        if (it != pending_.end()) {
+            // CNT 回绕后同一 key 仍在途：旧指令不可能再被可靠匹配，直接结束
+            superseded = std::move(it->second);
+            pending_.erase(it);
+            has_superseded = true;
+            ++stats_[cmd_type].aborted;
+        }
+        ++stats_[cmd_type].sent;
+        pending_.emplace(key, std::move(entry));
+    }
+
+    if (has_superseded) {
+        MYLOG_WARN("指令 {} cnt={} 在途期间被同 CNT 新指令顶替", GetCommandName(cmd_type), cnt);
+        CommandResult result;
+        result.cnt      = superseded.cnt;
+        result.cmd_type = superseded.cmd_type;
+        result.attempts = superseded.attempts;
+        result.error    = "superseded by a newer command with the same CNT";
+        Finish(superseded, std::move(result));
+    }
+    return future;
+}
+
+void CommandCorrelator::Cancel(uint8_t cnt, uint8_t cmd_type, const std::string& reason) {
+    Pending entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_.find(MakeKey(cnt, cmd_type));
+        if (it == pending_.end()) {
+            return;
+        }
+        entry = std::move(it->second);
+        pending_.erase(it);
+        ++stats_[cmd_type].aborted;
+    }
+
+    CommandResult result;
+    result.cnt      = entry.cnt;
+    result.cmd_type = entry.cmd_type;
+    result.attempts = entry.attempts;
+    result.error    = reason;
+    Finish(entry, std::move(result));
+}
+
+// =============================================================================
+// 回复匹配
+// =============================================================================
+
+bool CommandCorrelator::OnReply(const CommandReplyData& reply, Clock::time_point now) {
+    Pending entry;
+    CommandResult result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_.find(MakeKey(reply.cnt, reply.replied_cmd));
+        if (it == pending_.end()) {
+            // 飞控未回显 CNT：匹配同指令类型中最早发出的一条
+            for (auto cur = pending_.begin(); cur != pending_.end(); ++cur) {
+                if (cur->second.cmd_type != reply.replied_cmd) {
+                    continue;
+                }
+                if (it == pending_.end() ||
+                    cur->second.first_sent_at < it->second.first_sent_at) {
+                    it = cur;
+                }
+            }
+        }
+        if (it == pending_.end()) {
+            return false;
+        }
+
+        entry = std::move(it->second);
+        pending_.erase(it);
+
+        result.cnt      = entry.cnt;
+        result.cmd_type = entry.cmd_type;
+        result.replied  = true;
+        result.result   = reply.result;
+        result.success  = (reply.result == 0x00);
+        result.attempts = entry.attempts;
+        result.rtt_ms   = ElapsedMs(entry.last_sent_at, now);
+        if (!result.success) {
+            result.error = "fly control replied failure";
+        }
+
+        auto& st = stats_[entry.cmd_type];
+        ++st.replied;
+        if (result.success) {
+            ++st.success;
+        } else {
+            ++st.failed;
+        }
+        RecordRttLocked(st, result.rtt_ms);
+    }
+
+    Finish(entry, std::move(result));
+    return true;
+}
+
+// =============================================================================
+// 超时与重试
+// =============================================================================
+
+void CommandCorrelator::CollectTimeouts(Clock::time_point now,
+                                        std::vector<CommandResend>& resend) {
+    std::vector<Pending> expired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            Pending& p = it->second;
+            if (now < p.deadline) {
+                ++it;
+                continue;
+            }
+
+            auto& st = stats_[p.cmd_type];
+            if (p.attempts <= p.policy.max_retries && !p.frame.empty()) {
+                // 还有重试机会：重新计时并交给发送方重发
+                ++p.attempts;
+                ++st.retries;
+                p.last_sent_at = now;
+                p.deadline     = now + std::chrono::milliseconds(p.policy.timeout_ms);
+
+                CommandResend item;
+                item.cnt      = p.cnt;
+                item.cmd_type = p.cmd_type;
+                item.attempt  = p.attempts;
+                item.frame    = p.frame;
+                resend.push_back(std::move(item));
+                ++it;
+                continue;
+            }
+
+            ++st.timeouts;
+            expired.push_back(std::move(p));
+            it = pending_.erase(it);
+        }
+    }
+
+    for (auto& p : expired) {
+        MYLOG_WARN("指令 {} cnt={} 等待回复超时, attempts={}",
+                   GetCommandName(p.cmd_type), p.cnt, p.attempts);
+        CommandResult result;
+        result.cnt       = p.cnt;
+        result.cmd_type  = p.cmd_type;
+        result.timed_out = true;
+        result.attempts  = p.attempts;
+        result.error     = "reply timeout";
+        Finish(p, std::move(result));
+    }
+}
+
+void CommandCorrelator::FailAll(const std::string& reason) {
+    std::map<uint16_t, Pending> drained;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drained.swap(pending_);
+        for (const auto& kv : drained) {
+            ++stats_[kv.second.cmd_type].aborted;
+        }
+    }
+
+    for (auto& kv : drained) {
+        CommandResult result;
+        result.cnt      = kv.second.cnt;
+        result.cmd_type = kv.second.cmd_type;
+        result.attempts = kv.second.attempts;
+        result.error    = reason;
+        Finish(kv.second, std::move(result));
+    }
+}
+
+size_t CommandCorrelator::PendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+// =============================================================================
+// 统计
+// =============================================================================
+
+nlohmann::json CommandCorrelator::GetStatsJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    nlohmann::json commands = nlohmann::json::array();
+    for (const auto& kv : stats_) {
+        const CommandStats& st = kv.second;
+
+        nlohmann::json buckets = nlohmann::json::array();
+        for (size_t i = 0; i < st.rtt_buckets.size(); ++i) {
+            nlohmann::json b;
+            if (i < kRttBucketsMs.size()) {
+                b["le_ms"] = kRttBucketsMs[i];
+            } else {
+                b["le_ms"] = "inf";
+            }
+            b["count"] = st.rtt_buckets[i];
+            buckets.push_back(b);
+        }
+
+        nlohmann::json item;
+        item["cmd_type"]    = kv.first;
+        item["cmd_name"]    = GetCommandName(kv.first);
+        item["sent"]        = st.sent;
+        item["replied"]     = st.replied;
+        item["success"]     = st.success;
+        item["failed"]      = st.failed;
+        item["timeouts"]    = st.timeouts;
+        item["retries"]     = st.retries;
+        item["aborted"]     = st.aborted;
+        item["rtt_min_ms"]  = st.rtt_min_ms;
+        item["rtt_max_ms"]  = st.rtt_max_ms;
+        item["rtt_avg_ms"]  = st.replied > 0 ? st.rtt_sum_ms / static_cast<double>(st.replied) : 0.0;
+        item["rtt_histogram"] = buckets;
+        commands.push_back(item);
+    }
+
+    nlohmann::json j;
+    j["pending"]  = pending_.size();
+    j["commands"] = commands;
+    return j;
+}
+
+void CommandCorrelator::ResetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.clear();
+}
+
+void CommandCorrelator::RecordRttLocked(CommandStats& st, double rtt_ms) {
+    if (st.replied == 1) {
+        st.rtt_min_ms = rtt_ms;
+        st.rtt_max_ms = rtt_ms;
+    } else {
+        st.rtt_min_ms = std::min(st.rtt_min_ms, rtt_ms);
+        st.rtt_max_ms = std::max(st.rtt_max_ms, rtt_ms);
+    }
+    st.rtt_sum_ms += rtt_ms;
+
+    size_t idx = 0;
+    while (idx < kRttBucketsMs.size() && rtt_ms > static_cast<double>(kRttBucketsMs[idx])) {
+        ++idx;
+    }
+    ++st.rtt_buckets[idx];
+}
+
+void CommandCorrelator::Finish(Pending& p, CommandResult&& result) {
+    if (p.callback) {
+        try {
+            p.callback(result);
+        } catch (const std::exception& e) {
+            MYLOG_ERROR("指令回调异常: cmd={}, err={}", GetCommandName(p.cmd_type), e.what());
+        }
+    }
+    p.promise.set_value(std::move(result));
+}
+
+} // namespace fly_control
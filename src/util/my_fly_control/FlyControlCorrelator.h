@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "FlyControlProtocol.h"
+
+// =============================================================================
+// 指令应答关联器（待回复表）
+//
+// 功能：
+//   1. 每条发出的指令按 (CNT, 指令类型) 登记到待回复表，返回 future 并可附带回调
+//   2. 收到回复帧时按 (CNT, 指令类型) 精确匹配；飞控若不回显 CNT，
+//      退化为匹配同指令类型中最早发出的一条
+//   3. 超时未回复的指令按重试策略重发原始帧（CNT 不变），重试耗尽后以超时完成
+//   4. 按指令类型统计发送/成功/失败/超时/重试次数和 RTT 直方图
+//
+// 本类不持有串口，只负责记账；重发由 MyFlyControl 在接收线程中执行。
+// 多条指令可同时在途，发送方无需停等。
+// =============================================================================
+
+namespace fly_control {
+
+// 单条指令的最终结果
+struct CommandResult {
+    uint8_t     cnt       = 0;      // 发送时的帧计数
+    uint8_t     cmd_type  = 0;      // 指令类型
+    bool        success   = false;  // 收到回复且结果为成功
+    bool        replied   = false;  // 是否收到回复
+    bool        timed_out = false;  // 是否因超时（重试耗尽）结束
+    uint8_t     result    = 0xFF;   // 飞控回复的结果码（0x00=成功）
+    uint32_t    attempts  = 0;      // 总发送次数（含首次）
+    double      rtt_ms    = 0.0;    // 最后一次发送到收到回复的耗时
+    std::string error;              // 失败原因
+};
+
+using CommandResultCallback = std::function<void(const CommandResult&)>;
+
+// 重试策略
+struct CommandRetryPolicy {
+    uint32_t timeout_ms  = 2000;    // 单次等待回复超时
+    uint32_t max_retries = 0;       // 超时后最多重发次数
+};
+
+// 需要重发的帧
+struct CommandResend {
+    uint8_t              cnt      = 0;
+    uint8_t              cmd_type = 0;
+    uint32_t             attempt  = 0;  // 本次为第几次发送
+    std::vector<uint8_t> frame;
+};
+
+class CommandCorrelator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // RTT 直方图桶上界（毫秒），最后一个桶收纳超出上界的样本
+    static constexpr std::array<uint32_t, 12> kRttBucketsMs = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+
+    CommandCorrelator() = default;
+    CommandCorrelator(const CommandCorrelator&) = delete;
+    CommandCorrelator& operator=(const CommandCorrelator&) = delete;
+
+    // 登记一条即将发送的指令，必须在真正写串口之前调用，避免回复先于登记到达
+    // frame 仅在 policy.max_retries > 0 时需要（用于重发），否则可传空
+    std::future<CommandResult> Register(uint8_t cnt, uint8_t cmd_type,
+                                        std::vector<uint8_t> frame,
+                                        const CommandRetryPolicy& policy,
+                                        CommandResultCallback cb = nullptr,
+                                        Clock::time_point now = Clock::now());
+
+    // 发送失败时撤销登记，并以失败完成
+    void Cancel(uint8_t cnt, uint8_t cmd_type, const std::string& reason);
+
+    // 处理一条回复帧，返回是否匹配到待回复指令
+    bool OnReply(const CommandReplyData& reply, Clock::time_point now = Clock::now());
+
+    // 扫描超时条目：可重试的追加到 resend 并重新计时，重试耗尽的以超时完成
+    void CollectTimeouts(Clock::time_point now, std::vector<CommandResend>& resend);
+
+    // 以失败完成全部在途指令（模块停止时调用）
+    void FailAll(const std::string& reason);
+
+    // 当前在途指令数
+    size_t PendingCount() const;
+
+    // 按指令类型输出统计信息
+    nlohmann::json GetStatsJson() const;
+
+    // 清空统计信息（不影响在途指令）
+    void ResetStats();
+
+private:
+    struct Pending {
+        uint8_t                    cnt      = 0;
+        uint8_t                    cmd_type = 0;
+        std::vector<uint8_t>       frame;
+        CommandRetryPolicy         policy;
+        uint32_t                   attempts = 1;
+        Clock::time_point          first_sent_at;
+        Clock::time_point          last_sent_at;
+        Clock::time_point          deadline;
+        std::promise<CommandResult> promise;
+        CommandResultCallback      callback;
+    };
+
+    struct CommandStats {
+        uint64_t sent     = 0;
+        uint64_t replied  = 0;
+        uint64_t success  = 0;
+        uint64_t failed   = 0;  // 回复结果为失败
+        uint64_t timeouts = 0;
+        uint64_t retries  = 0;
+        uint64_t aborted  = 0;  // 发送失败、被顶替或模块停止
+        double   rtt_sum_ms = 0.0;
+        double   rtt_min_ms = 0.0;
+        double   rtt_max_ms = 0.0;
+        std::array<uint64_t, kRttBucketsMs.size() + 1> rtt_buckets{};
+    };
+
+    static uint16_t MakeKey(uint8_t cnt, uint8_t cmd_type) {
+        return static_cast<uint16_t>((static_cast<uint16_t>(cnt) << 8) | cmd_type);
+    }
+
+    // 从表中摘除并填写结果；调用方在锁外调用 Finish
+    static void Finish(Pending& p, CommandResult&& result);
+
+    void RecordRttLocked(CommandStats& st, double rtt_ms);
+
+    mutable std::mutex                 mutex_;
+    std::map<uint16_t, Pending>        pending_;   // key = (cnt << 8) | cmd_type
+    std::map<uint8_t, CommandStats>    stats_;     // 按指令类型
+};
+
+} // namespace fly_control
@@ -1,4 +1,5 @@
 #include "FlyControlFrame.h"
+#include "FlyControlLayout.h"
 #include "MyLog.h"
 
 #include <algorithm>
@@ -58,10 +59,49 @@ std::vector<uint8_t> BuildFrame(uint8_t cnt, uint8_t frame_type,
 // FrameParser 实现
 // =============================================================================
 
+FrameParser::FrameParser(size_t capacity)
+    : buffer_(capacity > 0 ? capacity : kDefaultCapacity) {}
+
 void FrameParser::FeedData(const uint8_t* data, size_t len) {
-    for (size_t i = 0; i < len; ++i) {
-        buffer_.push_back(data[i]);
+    if (data == nullptr || len == 0) {
+        return;
+    }
+
+    const size_t capacity = buffer_.size();
+
+    // 单次喂入超过整个缓冲区：只保留最新的 capacity 字节
+    if (len >= capacity) {
+        dropped_bytes_ += (tail_ - head_) + (len - capacity);
+        MYLOG_WARN("帧解析器单次喂入数据超过缓冲区容量, len={}, capacity={}, 丢弃旧数据",
+                   len, capacity);
+        std::memcpy(buffer_.data(), data + (len - capacity), capacity);
+        head_ = 0;
+        tail_ = capacity;
+        return;
+    }
+
+    // 尾部空间不足：先把未解析数据整体前移
+    if (capacity - tail_ < len && head_ > 0) {
+        const size_t pending = tail_ - head_;
+        if (pending > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + head_, pending);
+        }
+        head_ = 0;
+        tail_ = pending;
     }
+
+    // 压缩后仍放不下：丢弃最旧的数据为新数据腾出空间
+    if (capacity - tail_ < len) {
+        const size_t overflow = len - (capacity - tail_);
+        dropped_bytes_ += overflow;
+        MYLOG_WARN("帧解析器缓冲区溢出, pending={}, len={}, capacity={}, 丢弃最旧 {} 字节",
+                   tail_ - head_, len, capacity, overflow);
+        std::memmove(buffer_.data(), buffer_.data() + overflow, tail_ - overflow);
+        tail_ -= overflow;
+    }
+
+    std::memcpy(buffer_.data() + tail_, data, len);
+    tail_ += len;
 }
 
 void FrameParser::FeedData(const std::vector<uint8_t>& data) {
@@ -69,24 +109,61 @@ void FrameParser::FeedData(const std::vector<uint8_t>& data) {
 }
 
 void FrameParser::Reset() {
-    buffer_.clear();
+    head_ = 0;
+    tail_ = 0;
     MYLOG_WARN("帧解析器已重置，缓冲区已清空");
 }
 
 size_t FrameParser::BufferSize() const {
+    return tail_ - head_;
+}
+
+size_t FrameParser::Capacity() const {
     return buffer_.size();
 }
 
+uint64_t FrameParser::DroppedBytes() const {
+    return dropped_bytes_;
+}
+
+void FrameParser::Discard(size_t n) {
+    head_ += std::min(n, tail_ - head_);
+    if (head_ == tail_) {
+        // 缓冲区已空，读写下标归零，后续写入无需 memmove
+        head_ = 0;
+        tail_ = 0;
+    }
+}
+
 // ---------------------------------------------------------------------------
 // 在缓冲区中搜索帧头 0xEB 0x90，丢弃帧头之前的脏数据
 // ---------------------------------------------------------------------------
 bool FrameParser::FindHeader() {
-    while (buffer_.size() >= 2) {
-        if (buffer_[0] == FRAME_HEADER_0 && buffer_[1] == FRAME_HEADER_1) {
+    while (BufferSize() >= 2) {
+        const uint8_t* begin = Data();
+        const auto* hit = static_cast<const uint8_t*>(
+            std::memchr(begin, FRAME_HEADER_0, BufferSize()));
+        if (hit == nullptr) {
+            // 整段都没有帧头首字节，全部丢弃
+            dropped_bytes_ += BufferSize();
+            Discard(BufferSize());
+            return false;
+        }
+
+        const size_t skip = static_cast<size_t>(hit - begin);
+        dropped_bytes_ += skip;
+        Discard(skip);
+
+        if (BufferSize() < 2) {
+            // 帧头首字节位于缓冲区末尾，等待更多数据
+            return false;
+        }
+        if (Data()[1] == FRAME_HEADER_1) {
             return true;
         }
-        // 丢弃一个无效字节，继续搜索
-        buffer_.pop_front();
+        // 只匹配到帧头首字节，丢弃后继续搜索
+        ++dropped_bytes_;
+        Discard(1);
     }
     return false;
 }
@@ -95,52 +172,9 @@ bool FrameParser::FindHeader() {
 // 根据帧类型确定帧总长度
 // ---------------------------------------------------------------------------
 size_t FrameParser::GetExpectedFrameLen(uint8_t frame_type, uint8_t cmd_byte) const {
-    switch (frame_type) {
-        case FRAME_TYPE_HEARTBEAT:
-            // 心跳帧固定 89 字节
-            return HEARTBEAT_FRAME_LEN;
-
-        case FRAME_TYPE_SET_DESTINATION:
-            // 帧头(2)+CNT(1)+帧类型(1)+指令(1)+lon(4)+lat(4)+alt(2)+校验(1)+帧尾(2) = 18
-            return 18;
-
-        case FRAME_TYPE_REPLY:
-            // 帧头(2)+CNT(1)+帧类型(1)+回复指令(1)+结果(1)+校验(1)+帧尾(2) = 9
-            return 9;
-
-        case FRAME_TYPE_GIMBAL_CONTROL:
-            // 帧头(2)+CNT(1)+帧类型(1)+使能(1)+俯仰(2)+偏航(2)+校验(1)+帧尾(2) = 12
-            return 12;
-
-        case FRAME_TYPE_COMMAND: {
-            // 指令帧需要根据子指令类型确定长度
-            // 固定部分 = 帧头(2)+CNT(1)+帧类型(1)+指令类型(1) = 5
-            // 再加上指令体+校验(1)+帧尾(2) = +3
-            constexpr size_t CMD_OVERHEAD = 5 + 3; // 帧头CNT帧类型+指令类型 + 校验帧尾
-            switch (cmd_byte) {
-                case CMD_SET_ROUTE:    return 0;  // 变长，需要动态计算
-                case CMD_SET_GEOFENCE: return 0;  // 变长，需要动态计算
-                case CMD_SET_ANGLE:    return CMD_OVERHEAD + 4;  // pitch(2)+yaw(2)
-                case CMD_SET_SPEED:    return CMD_OVERHEAD + 2;  // speed(2)
-                case CMD_SET_ALTITUDE: return CMD_OVERHEAD + 3;  // type(1)+alt(2)
-                case CMD_POWER_SWITCH: return CMD_OVERHEAD + 1;  // cmd(1)
-                case CMD_PARACHUTE:    return CMD_OVERHEAD + 1;  // type(1)
-                case CMD_BUTTON:       return CMD_OVERHEAD + 1;  // button(1)
-                case CMD_SET_ORIGIN_RETURN: return CMD_OVERHEAD + 11; // type(1)+lon(4)+lat(4)+alt(2)
-                case CMD_SWITCH_MODE:  return CMD_OVERHEAD + 1;  // mode(1)
-                case CMD_GUIDANCE:     return CMD_OVERHEAD + 19; // mode(1)+frameid(4)+trackid(4)+lon(4)+lat(4)+alt(2)
-                case CMD_GUIDANCE_NEW: return CMD_OVERHEAD + 49; // 很多字段
-                case CMD_GIMBAL_ANG_RATE: return CMD_OVERHEAD + 25; // 6×4+1
-                case CMD_GIMBAL_ANGLE: return CMD_OVERHEAD + 16; // 4×4
-                case CMD_TARGET_STATE: return CMD_OVERHEAD + 11; // 2×4+3
-                default:
-                    return 0;  // 未知指令，无法确定长度
-            }
-        }
-
-        default:
-            return 0;  // 未知帧类型
-    }
+    // 定长帧长度统一取自 FlyControlLayout.h 的报文描述表，
+    // 航线/电子围栏等变长指令帧返回 0，由 CalcVariableLenFrameLen 处理
+    return layout::FrameLen(frame_type, cmd_byte);
 }
 
 // ---------------------------------------------------------------------------
@@ -152,12 +186,13 @@ size_t FrameParser::CalcVariableLenFrameLen(uint8_t frame_type) const {
     }
 
     // 至少需要 6 字节才能读到 指令类型(byte4) 和 点数量(byte5)
-    if (buffer_.size() < 6) {
+    if (BufferSize() < 6) {
         return 0;
     }
 
-    uint8_t cmd_byte = buffer_[4];
-    uint8_t count    = buffer_[5];
+    const uint8_t* buf = Data();
+    uint8_t cmd_byte = buf[4];
+    uint8_t count    = buf[5];
 
     // 帧固定部分 = 帧头(2)+CNT(1)+帧类型(1)+指令类型(1)+点数量(1)+校验(1)+帧尾(2) = 9
     constexpr size_t VAR_OVERHEAD = 9;
@@ -176,9 +211,9 @@ size_t FrameParser::CalcVariableLenFrameLen(uint8_t frame_type) const {
 }
 
 // ---------------------------------------------------------------------------
-// 尝试从缓冲区中解析出一个完整帧
+// 尝试从缓冲区中解析出一个完整帧（零拷贝）
 // ---------------------------------------------------------------------------
-bool FrameParser::PopFrame(ParsedFrame& frame) {
+bool FrameParser::PopFrameView(FrameView& view) {
     while (true) {
         // 步骤1：查找帧头
         if (!FindHeader()) {
@@ -187,16 +222,17 @@ bool FrameParser::PopFrame(ParsedFrame& frame) {
 
         // 步骤2：至少需要 5 字节才能读到帧类型和可能的指令类型
         // 帧头(2) + CNT(1) + 帧类型(1) + 至少1字节载荷或校验
-        if (buffer_.size() < 5) {
+        if (BufferSize() < 5) {
             return false;
         }
 
-        uint8_t frame_type = buffer_[3];
+        const uint8_t* buf = Data();
+        uint8_t frame_type = buf[3];
         uint8_t cmd_byte   = 0;
 
         // 对于指令帧，第5字节是指令类型
-        if (frame_type == FRAME_TYPE_COMMAND && buffer_.size() >= 5) {
-            cmd_byte = buffer_[4];
+        if (frame_type == FRAME_TYPE_COMMAND) {
+            cmd_byte = buf[4];
         }
 
         // 步骤3：确定帧总长度
@@ -209,7 +245,8 @@ bool FrameParser::PopFrame(ParsedFrame& frame) {
                 // 数据不够或未知帧类型
                 if (frame_type != FRAME_TYPE_COMMAND) {
                     // 未知帧类型，丢弃帧头继续搜索
-                    buffer_.pop_front();
+                    ++dropped_bytes_;
+                    Discard(1);
                     continue;
                 }
                 // 指令帧但数据不够，等待更多数据
@@ -218,46 +255,62 @@ bool FrameParser::PopFrame(ParsedFrame& frame) {
         }
 
         // 步骤4：检查缓冲区长度是否足够
-        if (buffer_.size() < expected_len) {
+        if (BufferSize() < expected_len) {
+            if (expected_len > Capacity()) {
+                // 声明的帧长超过缓冲区容量，不可能收齐，视为伪帧头
+                ++dropped_bytes_;
+                Discard(1);
+                continue;
+            }
             return false;  // 数据不够，等待更多数据
         }
 
         // 步骤5：校验帧尾
-        if (buffer_[expected_len - 2] != FRAME_TAIL_0 ||
-            buffer_[expected_len - 1] != FRAME_TAIL_1) {
+        if (buf[expected_len - 2] != FRAME_TAIL_0 ||
+            buf[expected_len - 1] != FRAME_TAIL_1) {
             // 帧尾不匹配，当前帧头无效，丢弃继续搜索
-            buffer_.pop_front();
+            ++dropped_bytes_;
+            Discard(1);
             continue;
         }
 
-        // 步骤6：校验和验证
+        // 步骤6：校验和验证（直接在缓冲区上计算）
         // 校验和位置 = expected_len - 3（帧尾2字节之前1字节）
         size_t chk_pos = expected_len - 3;
-        uint8_t received_chk = buffer_[chk_pos];
-
-        // 将缓冲区前 chk_pos 字节复制出来计算校验和
-        std::vector<uint8_t> raw(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(chk_pos));
-        uint8_t calc_chk = CalcChecksum(raw.data(), raw.size());
-
-        // 步骤7：组装 ParsedFrame
-        frame.cnt        = buffer_[2];
-        frame.frame_type = buffer_[3];
-        frame.checksum   = received_chk;
-        frame.valid      = (calc_chk == received_chk);
+        uint8_t received_chk = buf[chk_pos];
+        uint8_t calc_chk = CalcChecksum(buf, chk_pos);
 
+        // 步骤7：填充帧视图
         // 载荷 = 帧头(2)+CNT(1)+帧类型(1) 之后，到校验和之前
-        size_t payload_start = 4;
-        size_t payload_len   = chk_pos - payload_start;
-        frame.payload.assign(buffer_.begin() + static_cast<std::ptrdiff_t>(payload_start),
-                             buffer_.begin() + static_cast<std::ptrdiff_t>(payload_start + payload_len));
-
-        // 步骤8：从缓冲区中移除已解析的帧
-        for (size_t i = 0; i < expected_len; ++i) {
-            buffer_.pop_front();
-        }
-
+        constexpr size_t payload_start = 4;
+        view.cnt         = buf[2];
+        view.frame_type  = buf[3];
+        view.payload     = buf + payload_start;
+        view.payload_len = chk_pos - payload_start;
+        view.checksum    = received_chk;
+        view.valid       = (calc_chk == received_chk);
+
+        // 步骤8：移动读下标；帧数据仍留在缓冲区中，直到下一次 FeedData 才可能被覆盖
+        Discard(expected_len);
         return true;
     }
 }
 
+// ---------------------------------------------------------------------------
+// 尝试从缓冲区中解析出一个完整帧（载荷复制到 ParsedFrame）
+// ---------------------------------------------------------------------------
+bool FrameParser::PopFrame(ParsedFrame& frame) {
+    FrameView view;
+    if (!PopFrameView(view)) {
+        return false;
+    }
+
+    frame.cnt        = view.cnt;
+    frame.frame_type = view.frame_type;
+    frame.checksum   = view.checksum;
+    frame.valid      = view.valid;
+    frame.payload.assign(view.payload, view.payload + view.payload_len);
+    return true;
+}
+
 } // namespace fly_control
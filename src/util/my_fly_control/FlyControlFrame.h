@@ -2,7 +2,6 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <vector>
 
 #include "FlyControlProtocol.h"
@@ -15,7 +14,8 @@
 //   2. CalcChecksum  - 计算校验和（所有字节求和取低8位）
 //   3. FeedData      - 向帧解析器喂入字节流
 //   4. PopFrame      - 从解析器中取出一个完整且校验通过的帧
-//   5. Reset         - 重置帧解析器状态
+//   5. PopFrameView  - 零拷贝取帧，载荷以指针+长度的视图形式指向解析器内部缓冲区
+//   6. Reset         - 重置帧解析器状态
 // =============================================================================
 
 namespace fly_control {
@@ -32,26 +32,59 @@ uint8_t CalcChecksum(const uint8_t* data, size_t len);
 std::vector<uint8_t> BuildFrame(uint8_t cnt, uint8_t frame_type,
                                 const std::vector<uint8_t>& payload);
 
+// ---------------------------------------------------------------------------
+// 帧视图：PopFrameView 的输出，不持有数据
+// payload 指向解析器内部缓冲区，仅在下一次 FeedData / PopFrame* / Reset 之前有效
+// ---------------------------------------------------------------------------
+struct FrameView {
+    uint8_t        cnt         = 0;        // 帧计数
+    uint8_t        frame_type  = 0;        // 帧类型
+    const uint8_t* payload     = nullptr;  // 载荷起始地址
+    size_t         payload_len = 0;        // 载荷长度
+    uint8_t        checksum    = 0;        // 收到的校验和
+    bool           valid       = false;    // 校验是否通过
+};
+
 // ---------------------------------------------------------------------------
 // 帧解析器：从连续字节流中拆出完整帧
+//
+// 内部使用一块构造时一次性分配的定长连续缓冲区，[head_, tail_) 为待解析数据：
+//   - 解析时只移动 head_，不逐字节弹出
+//   - 尾部空间不足时才把未解析数据整体 memmove 到缓冲区起始处
+//   - 帧头用 memchr 搜索，校验和直接在缓冲区上原地计算
+// 稳定运行后喂数据和取帧都不会产生堆分配。
 // ---------------------------------------------------------------------------
 class FrameParser {
 public:
-    FrameParser() = default;
+    // 默认容量需大于最长的变长帧（航线帧 255 点 = 9 + 255*14 = 3579 字节）
+    static constexpr size_t kDefaultCapacity = 8192;
+
+    explicit FrameParser(size_t capacity = kDefaultCapacity);
 
     // 喂入一段字节数据（可能包含多帧、半帧、粘包）
+    // 缓冲区放不下时丢弃最旧的数据，丢弃字节数计入 DroppedBytes()
     void FeedData(const uint8_t* data, size_t len);
     void FeedData(const std::vector<uint8_t>& data);
 
     // 尝试取出一个完整帧，成功返回 true 并填充 frame
+    // frame.payload 会复用已有容量，调用方循环复用同一个 ParsedFrame 时不会反复分配
     bool PopFrame(ParsedFrame& frame);
 
+    // 零拷贝取帧，成功返回 true 并填充 view
+    bool PopFrameView(FrameView& view);
+
     // 重置解析器内部状态
     void Reset();
 
     // 当前缓冲区中待处理字节数
     size_t BufferSize() const;
 
+    // 缓冲区容量
+    size_t Capacity() const;
+
+    // 累计因缓冲区溢出或帧同步失败而丢弃的字节数
+    uint64_t DroppedBytes() const;
+
 private:
     // 在缓冲区中查找帧头位置，丢弃帧头之前的无效字节
     // 返回是否找到帧头
@@ -65,7 +98,16 @@ private:
     // 返回 0 表示数据不够无法确定
     size_t CalcVariableLenFrameLen(uint8_t frame_type) const;
 
-    std::deque<uint8_t> buffer_;   // 接收缓冲区
+    // 丢弃缓冲区头部 n 个字节
+    void Discard(size_t n);
+
+    // 待解析数据的起始地址
+    const uint8_t* Data() const { return buffer_.data() + head_; }
+
+    std::vector<uint8_t> buffer_;            // 定长接收缓冲区（构造时分配，之后不再扩容）
+    size_t               head_{0};           // 待解析数据起始下标
+    size_t               tail_{0};           // 待解析数据结束下标（不含）
+    uint64_t             dropped_bytes_{0};  // 累计丢弃字节数
 };
 
 } // namespace fly_control
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "FlyControlProtocol.h"
+
+// =============================================================================
+// 报文线格式描述表（编译期）
+//
+// 每条定长报文的载荷布局只在 MessageLayout<T> 特化中声明一次：
+//   - 字段顺序 = 线上字节顺序，字段宽度 = 结构体成员类型宽度，全部小端
+//   - kFrameType / kCmdType 给出帧类型与指令类型（非指令帧 kCmdType 为 0）
+//   - kPayloadLen / kFrameLen 由字段表在编译期求和得到
+//
+// 编码直接写入调用方提供的缓冲区，解码直接从帧载荷读取，不经过中间 vector；
+// 帧解析器的 GetExpectedFrameLen 也从同一张表取值，保证收发长度一致。
+//
+// 变长报文（航线、电子围栏）不在表内，仍由 FlyControlCodec.cpp 手写编解码。
+// =============================================================================
+
+namespace fly_control {
+namespace layout {
+
+// ---------------------------------------------------------------------------
+// 小端读写（循环边界为编译期常量，编译后即单条 load/store）
+// ---------------------------------------------------------------------------
+template <typename T>
+inline void StoreLE(uint8_t* out, T value) {
+    static_assert(std::is_integral<T>::value, "StoreLE 仅支持整数类型");
+    using U = typename std::make_unsigned<T>::type;
+    const U u = static_cast<U>(value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<uint8_t>(u >> (8 * i));
+    }
+}
+
+template <typename T>
+inline T LoadLE(const uint8_t* in) {
+    static_assert(std::is_integral<T>::value, "LoadLE 仅支持整数类型");
+    using U = typename std::make_unsigned<T>::type;
+    U u = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        u = static_cast<U>(u | (static_cast<U>(in[i]) << (8 * i)));
+    }
+    return static_cast<T>(u);
+}
+
+// ---------------------------------------------------------------------------
+// 成员指针类型萃取
+// ---------------------------------------------------------------------------
+template <typename M>
+struct MemberTraits;
+
+template <typename S, typename T>
+struct MemberTraits<T S::*> {
+    using Struct = S;
+    using Type   = T;
+};
+
+// ---------------------------------------------------------------------------
+// 字段表：Fields<&S::a, &S::b, ...>
+// ---------------------------------------------------------------------------
+template <auto... Members>
+struct Fields {
+    static constexpr size_t kSize =
+        (size_t{0} + ... + sizeof(typename MemberTraits<decltype(Members)>::Type));
+
+    template <typename S>
+    static void Store(const S& s, uint8_t* out) {
+        size_t off = 0;
+        ((StoreLE(out + off, s.*Members),
+          off += sizeof(typename MemberTraits<decltype(Members)>::Type)), ...);
+    }
+
+    template <typename S>
+    static void Load(const uint8_t* in, S& s) {
+        size_t off = 0;
+        ((s.*Members = LoadLE<typename MemberTraits<decltype(Members)>::Type>(in + off),
+          off += sizeof(typename MemberTraits<decltype(Members)>::Type)), ...);
+    }
+};
+
+// 帧固定开销：帧头(2) + CNT(1) + 帧类型(1) + 校验(1) + 帧尾(2)
+constexpr size_t kFrameOverhead = FRAME_HEADER_LEN + 1 + 1 + FRAME_CHECKSUM_LEN + FRAME_TAIL_LEN;
+
+// ---------------------------------------------------------------------------
+// 报文描述基类
+// ---------------------------------------------------------------------------
+template <uint8_t FrameType, uint8_t CmdType, typename FieldList>
+struct MessageDesc {
+    using FieldsT = FieldList;
+    static constexpr uint8_t kFrameType  = FrameType;
+    static constexpr uint8_t kCmdType    = CmdType;
+    static constexpr size_t  kPayloadLen = FieldList::kSize;
+    static constexpr size_t  kFrameLen   = kPayloadLen + kFrameOverhead;
+};
+
+template <typename T>
+struct MessageLayout;  // 未特化的类型不是定长报文
+
+// ---- 飞控→域控 ----
+
+template <>
+struct MessageLayout<HeartbeatData>
+    : MessageDesc<FRAME_TYPE_HEARTBEAT, 0, Fields<
+          &HeartbeatData::aircraft_id,     &HeartbeatData::run_mode,
+          &HeartbeatData::satellite_count, &HeartbeatData::longitude,
+          &HeartbeatData::latitude,        &HeartbeatData::altitude,
+          &HeartbeatData::relative_alt,    &HeartbeatData::airspeed,
+          &HeartbeatData::groundspeed,     &HeartbeatData::velocity_x,
+          &HeartbeatData::velocity_y,      &HeartbeatData::velocity_z,
+          &HeartbeatData::accel_x,         &HeartbeatData::accel_y,
+          &HeartbeatData::accel_z,         &HeartbeatData::roll,
+          &HeartbeatData::pitch,           &HeartbeatData::yaw,
+          &HeartbeatData::flight_mode,     &HeartbeatData::current_waypoint,
+          &HeartbeatData::battery_voltage, &HeartbeatData::battery_percent,
+          &HeartbeatData::battery_current, &HeartbeatData::atm_pressure,
+          &HeartbeatData::utc_timestamp,   &HeartbeatData::fault_info,
+          &HeartbeatData::rotation_speed,  &HeartbeatData::throttle,
+          &HeartbeatData::target_altitude, &HeartbeatData::target_speed,
+          &HeartbeatData::origin_distance, &HeartbeatData::origin_heading,
+          &HeartbeatData::target_distance, &HeartbeatData::flight_state,
+          &HeartbeatData::altitude_state,  &HeartbeatData::state_switch_src,
+          &HeartbeatData::flight_time,     &HeartbeatData::flight_range,
+          &HeartbeatData::reserved>> {};
+
+template <>
+struct MessageLayout<GimbalControlData>
+    : MessageDesc<FRAME_TYPE_GIMBAL_CONTROL, 0, Fields<
+          &GimbalControlData::enable, &GimbalControlData::pitch_angle,
+          &GimbalControlData::yaw_angle>> {};
+
+template <>
+struct MessageLayout<CommandReplyData>
+    : MessageDesc<FRAME_TYPE_REPLY, 0, Fields<
+          &CommandReplyData::replied_cmd, &CommandReplyData::result>> {};
+
+// ---- 域控→飞控 ----
+
+template <>
+struct MessageLayout<SetDestinationData>
+    : MessageDesc<FRAME_TYPE_SET_DESTINATION, CMD_SET_DESTINATION, Fields<
+          &SetDestinationData::cmd_type, &SetDestinationData::longitude,
+          &SetDestinationData::latitude, &SetDestinationData::altitude>> {};
+
+template <>
+struct MessageLayout<SetAngleData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_SET_ANGLE, Fields<
+          &SetAngleData::cmd_type, &SetAngleData::pitch, &SetAngleData::yaw>> {};
+
+template <>
+struct MessageLayout<SetSpeedData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_SET_SPEED, Fields<
+          &SetSpeedData::cmd_type, &SetSpeedData::speed>> {};
+
+template <>
+struct MessageLayout<SetAltitudeData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_SET_ALTITUDE, Fields<
+          &SetAltitudeData::cmd_type, &SetAltitudeData::altitude_type,
+          &SetAltitudeData::altitude>> {};
+
+template <>
+struct MessageLayout<PowerSwitchData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_POWER_SWITCH, Fields<
+          &PowerSwitchData::cmd_type, &PowerSwitchData::command>> {};
+
+template <>
+struct MessageLayout<ParachuteData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_PARACHUTE, Fields<
+          &ParachuteData::cmd_type, &ParachuteData::parachute_type>> {};
+
+template <>
+struct MessageLayout<ButtonCommandData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_BUTTON, Fields<
+          &ButtonCommandData::cmd_type, &ButtonCommandData::button>> {};
+
+template <>
+struct MessageLayout<SetOriginReturnData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_SET_ORIGIN_RETURN, Fields<
+          &SetOriginReturnData::cmd_type,  &SetOriginReturnData::point_type,
+          &SetOriginReturnData::longitude, &SetOriginReturnData::latitude,
+          &SetOriginReturnData::altitude>> {};
+
+template <>
+struct MessageLayout<SwitchModeData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_SWITCH_MODE, Fields<
+          &SwitchModeData::cmd_type, &SwitchModeData::mode>> {};
+
+template <>
+struct MessageLayout<GuidanceData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_GUIDANCE, Fields<
+          &GuidanceData::cmd_type,   &GuidanceData::mode_switch,
+          &GuidanceData::frame_id,   &GuidanceData::track_id,
+          &GuidanceData::target_lon, &GuidanceData::target_lat,
+          &GuidanceData::target_alt>> {};
+
+template <>
+struct MessageLayout<GuidanceNewData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_GUIDANCE_NEW, Fields<
+          &GuidanceNewData::cmd_type,
+          &GuidanceNewData::pitch_los_rate,     &GuidanceNewData::yaw_los_rate,
+          &GuidanceNewData::pitch_los_angle,    &GuidanceNewData::yaw_los_angle,
+          &GuidanceNewData::pitch_frame_angle,  &GuidanceNewData::yaw_frame_angle,
+          &GuidanceNewData::gimbal_pitch_angle, &GuidanceNewData::gimbal_yaw_angle,
+          &GuidanceNewData::acc_x,  &GuidanceNewData::acc_y,  &GuidanceNewData::acc_z,
+          &GuidanceNewData::gyro_x, &GuidanceNewData::gyro_y, &GuidanceNewData::gyro_z,
+          &GuidanceNewData::target_id,  &GuidanceNewData::target_type,
+          &GuidanceNewData::target_lon, &GuidanceNewData::target_lat,
+          &GuidanceNewData::target_alt, &GuidanceNewData::laser_range,
+          &GuidanceNewData::status>> {};
+
+template <>
+struct MessageLayout<GimbalAngRateData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_GIMBAL_ANG_RATE, Fields<
+          &GimbalAngRateData::cmd_type,
+          &GimbalAngRateData::pitch_los_rate, &GimbalAngRateData::yaw_los_rate,
+          &GimbalAngRateData::target_lon,     &GimbalAngRateData::target_lat,
+          &GimbalAngRateData::target_alt,     &GimbalAngRateData::laser_range,
+          &GimbalAngRateData::status>> {};
+
+template <>
+struct MessageLayout<GimbalAngleData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_GIMBAL_ANGLE, Fields<
+          &GimbalAngleData::cmd_type,
+          &GimbalAngleData::pitch_frame_angle, &GimbalAngleData::yaw_frame_angle,
+          &GimbalAngleData::pitch_ang_rate,    &GimbalAngleData::yaw_ang_rate>> {};
+
+template <>
+struct MessageLayout<TargetStateData>
+    : MessageDesc<FRAME_TYPE_COMMAND, CMD_TARGET_STATE, Fields<
+          &TargetStateData::cmd_type,
+          &TargetStateData::pitch_axis_angle, &TargetStateData::yaw_axis_angle,
+          &TargetStateData::target_vertical_ratio,
+          &TargetStateData::target_horizontal_ratio,
+          &TargetStateData::status>> {};
+
+// 与协议文档核对的长度断言
+static_assert(MessageLayout<HeartbeatData>::kFrameLen == HEARTBEAT_FRAME_LEN, "心跳帧长度应为 89 字节");
+static_assert(MessageLayout<SetDestinationData>::kFrameLen == 18, "设置目的地帧长度应为 18 字节");
+static_assert(MessageLayout<CommandReplyData>::kFrameLen == 9, "回复帧长度应为 9 字节");
+static_assert(MessageLayout<GimbalControlData>::kFrameLen == 12, "云台控制帧长度应为 12 字节");
+static_assert(MessageLayout<GuidanceNewData>::kPayloadLen == 50, "末制导(新版)载荷应为 50 字节");
+
+// ---------------------------------------------------------------------------
+// 按指令类型查询定长指令帧长度（帧类型 0x10）
+// 返回 0 表示变长或未知指令
+// ---------------------------------------------------------------------------
+constexpr size_t CommandFrameLen(uint8_t cmd_type) {
+    switch (cmd_type) {
+        case CMD_SET_ANGLE:         return MessageLayout<SetAngleData>::kFrameLen;
+        case CMD_SET_SPEED:         return MessageLayout<SetSpeedData>::kFrameLen;
+        case CMD_SET_ALTITUDE:      return MessageLayout<SetAltitudeData>::kFrameLen;
+        case CMD_POWER_SWITCH:      return MessageLayout<PowerSwitchData>::kFrameLen;
+        case CMD_PARACHUTE:         return MessageLayout<ParachuteData>::kFrameLen;
+        case CMD_BUTTON:            return MessageLayout<ButtonCommandData>::kFrameLen;
+        case CMD_SET_ORIGIN_RETURN: return MessageLayout<SetOriginReturnData>::kFrameLen;
+        case CMD_SWITCH_MODE:       return MessageLayout<SwitchModeData>::kFrameLen;
+        case CMD_GUIDANCE:          return MessageLayout<GuidanceData>::kFrameLen;
+        case CMD_GUIDANCE_NEW:      return MessageLayout<GuidanceNewData>::kFrameLen;
+        case CMD_GIMBAL_ANG_RATE:   return MessageLayout<GimbalAngRateData>::kFrameLen;
+        case CMD_GIMBAL_ANGLE:      return MessageLayout<GimbalAngleData>::kFrameLen;
+        case CMD_TARGET_STATE:      return MessageLayout<TargetStateData>::kFrameLen;
+        default:                    return 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 按帧类型查询定长帧长度（指令帧需结合 cmd_type）
+// 返回 0 表示变长或未知帧
+// ---------------------------------------------------------------------------
+constexpr size_t FrameLen(uint8_t frame_type, uint8_t cmd_type) {
+    switch (frame_type) {
+        case FRAME_TYPE_HEARTBEAT:       return MessageLayout<HeartbeatData>::kFrameLen;
+        case FRAME_TYPE_SET_DESTINATION: return MessageLayout<SetDestinationData>::kFrameLen;
+        case FRAME_TYPE_REPLY:           return MessageLayout<CommandReplyData>::kFrameLen;
+        case FRAME_TYPE_GIMBAL_CONTROL:  return MessageLayout<GimbalControlData>::kFrameLen;
+        case FRAME_TYPE_COMMAND:         return CommandFrameLen(cmd_type);
+        default:                         return 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 写帧外壳：在 out[4, 4+payload_len) 已填好载荷的前提下，
+// 补齐帧头、CNT、帧类型、校验和与帧尾
+// ---------------------------------------------------------------------------
+inline void WriteFrameEnvelope(uint8_t* out, uint8_t cnt, uint8_t frame_type, size_t payload_len) {
+    out[0] = FRAME_HEADER_0;
+    out[1] = FRAME_HEADER_1;
+    out[2] = cnt;
+    out[3] = frame_type;
+
+    const size_t chk_pos = 4 + payload_len;
+    uint32_t sum = 0;
+    for (size_t i = 0; i < chk_pos; ++i) {
+        sum += out[i];
+    }
+    out[chk_pos]     = static_cast<uint8_t>(sum & 0xFF);
+    out[chk_pos + 1] = FRAME_TAIL_0;
+    out[chk_pos + 2] = FRAME_TAIL_1;
+}
+
+} // namespace layout
+
+// =============================================================================
+// 表驱动编解码接口
+// =============================================================================
+
+// 定长报文完整帧长度
+template <typename T>
+constexpr size_t kFrameLenOf = layout::MessageLayout<T>::kFrameLen;
+
+// 把定长报文编码为完整帧，写入 out（容量至少 kFrameLenOf<T>）
+// 返回写入字节数；容量不足返回 0
+template <typename T>
+inline size_t EncodeFrameInto(uint8_t cnt, const T& data, uint8_t* out, size_t capacity) {
+    using L = layout::MessageLayout<T>;
+    if (out == nullptr || capacity < L::kFrameLen) {
+        return 0;
+    }
+    L::FieldsT::Store(data, out + 4);
+    layout::WriteFrameEnvelope(out, cnt, L::kFrameType, L::kPayloadLen);
+    return L::kFrameLen;
+}
+
+// 把定长报文编码为栈上定长数组（无堆分配）
+template <typename T>
+inline std::array<uint8_t, kFrameLenOf<T>> EncodeFrameArray(uint8_t cnt, const T& data) {
+    std::array<uint8_t, kFrameLenOf<T>> frame{};
+    EncodeFrameInto(cnt, data, frame.data(), frame.size());
+    return frame;
+}
+
+// 从帧载荷解码定长报文；载荷不足返回 false
+template <typename T>
+inline bool DecodePayload(const uint8_t* payload, size_t len, T& out) {
+    using L = layout::MessageLayout<T>;
+    if (payload == nullptr || len < L::kPayloadLen) {
+        return false;
+    }
+    L::FieldsT::Load(payload, out);
+    return true;
+}
+
+} // namespace fly_control
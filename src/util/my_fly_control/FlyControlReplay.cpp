@@ -0,0 +1,110 @@
+#include "FlyControlReplay.h"
+#include "FlyControlCodec.h"
+#include "FlyControlLayout.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace fly_control {
+
+TelemetryReplayer::TelemetryReplayer(const TelemetryReader& reader)
+    : reader_(reader) {}
+
+ReplayStats TelemetryReplayer::Run(const ReplayOptions& options,
+                                   const HeartbeatSink& on_heartbeat,
+                                   const std::atomic<bool>* stop) {
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t kFrameLen = kFrameLenOf<HeartbeatData>;
+
+    ReplayStats stats;
+    parser_.Reset();
+
+    const size_t first = reader_.LowerBound(options.begin_ns);
+    const size_t last  = reader_.LowerBound(options.end_ns);
+    if (first >= last) {
+        return stats;
+    }
+
+    const size_t batch = std::max<size_t>(options.feed_batch, kFrameLen);
+    std::vector<uint8_t> pending;
+    pending.reserve(batch + kFrameLen);
+
+    const uint64_t base_ns = reader_.TimestampAt(first);
+    const auto     start   = Clock::now();
+
+    for (size_t i = first; i < last; ++i) {
+        if (stop != nullptr && stop->load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        const uint64_t ts = reader_.TimestampAt(i);
+        if (options.speed > 0.0) {
+            // 按录制间隔等待：到点前先把已攒的字节喂掉
+            const uint64_t offset_ns = ts > base_ns ? ts - base_ns : 0;
+            const auto due = start + std::chrono::nanoseconds(
+                static_cast<int64_t>(static_cast<double>(offset_ns) / options.speed));
+            if (due > Clock::now()) {
+                if (!pending.empty()) {
+                    parser_.FeedData(pending.data(), pending.size());
+                    stats.bytes += pending.size();
+                    pending.clear();
+                    Drain(on_heartbeat, stats);
+                }
+                std::this_thread::sleep_until(due);
+            }
+        }
+
+        // 在待喂缓冲区尾部原地组帧：载荷原样拷贝，再补帧头与校验
+        const size_t offset = pending.size();
+        pending.resize(offset + kFrameLen);
+        std::copy_n(reader_.PayloadAt(i), TelemetryRecorder::kPayloadLen, pending.data() + offset + 4);
+        layout::WriteFrameEnvelope(pending.data() + offset, reader_.CntAt(i),
+                                   FRAME_TYPE_HEARTBEAT, TelemetryRecorder::kPayloadLen);
+        ++stats.records;
+
+        if (pending.size() >= batch) {
+            parser_.FeedData(pending.data(), pending.size());
+            stats.bytes += pending.size();
+            pending.clear();
+            Drain(on_heartbeat, stats);
+        }
+    }
+
+    if (!pending.empty()) {
+        parser_.FeedData(pending.data(), pending.size());
+        stats.bytes += pending.size();
+        Drain(on_heartbeat, stats);
+    }
+
+    stats.elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    if (stats.records > 0) {
+        const uint64_t end_ts = reader_.TimestampAt(first + stats.records - 1);
+        stats.recorded_span_ms = end_ts > base_ns ? static_cast<double>(end_ts - base_ns) / 1e6 : 0.0;
+    }
+    return stats;
+}
+
+void TelemetryReplayer::Drain(const HeartbeatSink& on_heartbeat, ReplayStats& stats) {
+    FrameView frame;
+    while (parser_.PopFrameView(frame)) {
+        ++stats.frames;
+        if (!frame.valid || frame.frame_type != FRAME_TYPE_HEARTBEAT) {
+            ++stats.bad_frames;
+            continue;
+        }
+        HeartbeatData hb;
+        hb.cnt = frame.cnt;
+        if (!DecodeHeartbeat(frame.payload, frame.payload_len, hb)) {
+            ++stats.bad_frames;
+            continue;
+        }
+        ++stats.heartbeats;
+        if (on_heartbeat) {
+            on_heartbeat(hb);
+        }
+    }
+}
+
+} // namespace fly_control
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+#include "FlyControlFrame.h"
+#include "FlyControlProtocol.h"
+#include "FlyControlTelemetry.h"
+
+// =============================================================================
+// 遥测回放
+//
+// 把 TelemetryRecorder 录下的心跳重新组成完整帧，按读串口的批次大小喂入 FrameParser，
+// 解析出的心跳交给下游回调，用于下游消费者的回归测试与压力测试：
+//   - speed = 1.0 按录制时的时间间隔回放；speed = N 为 N 倍速
+//   - speed <= 0 不等待，尽可能快地回放（压测）
+//   - 可用 [begin_ns, end_ns) 截取一段时间窗口，起点通过时间戳索引定位
+// =============================================================================
+
+namespace fly_control {
+
+struct ReplayOptions {
+    double   speed      = 1.0;
+    uint64_t begin_ns   = 0;
+    uint64_t end_ns     = std::numeric_limits<uint64_t>::max();
+    size_t   feed_batch = 256;   // 每次喂入解析器的最大字节数（模拟串口读批次）
+};
+
+struct ReplayStats {
+    uint64_t records         = 0;   // 送入的记录数
+    uint64_t bytes           = 0;   // 喂入解析器的字节数
+    uint64_t frames          = 0;   // 解析出的帧数
+    uint64_t heartbeats      = 0;   // 成功解码并回调的心跳数
+    uint64_t bad_frames      = 0;   // 校验失败或解码失败的帧
+    double   elapsed_ms      = 0.0;
+    double   recorded_span_ms = 0.0; // 回放片段在录制时的时间跨度
+};
+
+class TelemetryReplayer {
+public:
+    // 单帧回调：收到的每个有效心跳
+    using HeartbeatSink = std::function<void(const HeartbeatData&)>;
+
+    explicit TelemetryReplayer(const TelemetryReader& reader);
+
+    // 同步回放，stop 非空且被置为 true 时提前结束
+    ReplayStats Run(const ReplayOptions& options,
+                    const HeartbeatSink& on_heartbeat,
+                    const std::atomic<bool>* stop = nullptr);
+
+private:
+    void Drain(const HeartbeatSink& on_heartbeat, ReplayStats& stats);
+
+    const TelemetryReader& reader_;
+    FrameParser            parser_;
+};
+
+} // namespace fly_control
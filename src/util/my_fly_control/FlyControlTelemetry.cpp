@@ -0,0 +1,368 @@
+#include "FlyControlTelemetry.h"
+#include "MyLog.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fly_control {
+
+namespace {
+
+constexpr char     kFileMagic[8] = {'F', 'C', 'T', 'E', 'L', 'E', 'M', '1'};
+constexpr uint32_t kFileVersion  = 1;
+constexpr uint32_t kChunkAlign   = 32;   // 32 × 128B = 4096B，保证 chunk 按页对齐
+
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t chunk_records;
+    uint32_t payload_len;
+    uint64_t record_count;
+    uint64_t chunk_count;
+    uint64_t created_ns;
+};
+
+void SetError(std::string* err, const std::string& msg) {
+    if (err) {
+        *err = msg;
+    }
+}
+
+std::string IndexPath(const std::string& file_path) {
+    return file_path + ".idx";
+}
+
+} // namespace
+
+// =============================================================================
+// TelemetryRecorder
+// =============================================================================
+
+TelemetryRecorder::~TelemetryRecorder() {
+    Close();
+}
+
+uint64_t TelemetryRecorder::NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+bool TelemetryRecorder::Open(const std::string& file_path, uint32_t chunk_records, std::string* err) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CloseLocked();
+
+    chunk_records = std::max<uint32_t>(chunk_records, kChunkAlign);
+    chunk_records = (chunk_records + kChunkAlign - 1) / kChunkAlign * kChunkAlign;
+
+    const int fd = ::open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        SetError(err, "打开遥测记录文件失败: " + file_path + ", error=" + std::strerror(errno));
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(kHeaderSize)) != 0) {
+        SetError(err, std::string("设置遥测记录文件大小失败: ") + std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    void* header = ::mmap(nullptr, kHeaderSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (header == MAP_FAILED) {
+        SetError(err, std::string("映射遥测记录文件头失败: ") + std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    FILE* idx = std::fopen(IndexPath(file_path).c_str(), "wb");
+    if (idx == nullptr) {
+        SetError(err, "打开遥测索引文件失败: " + IndexPath(file_path) + ", error=" + std::strerror(errno));
+        ::munmap(header, kHeaderSize);
+        ::close(fd);
+        return false;
+    }
+
+    path_           = file_path;
+    fd_             = fd;
+    idx_file_       = idx;
+    header_map_     = static_cast<uint8_t*>(header);
+    chunk_records_  = chunk_records;
+    chunk_bytes_    = static_cast<size_t>(chunk_records) * kRecordSize;
+    chunk_no_       = 0;
+    chunk_used_     = 0;
+    stats_          = Stats{};
+
+    FileHeader fh{};
+    std::memcpy(fh.magic, kFileMagic, sizeof(kFileMagic));
+    fh.version       = kFileVersion;
+    fh.record_size   = static_cast<uint32_t>(kRecordSize);
+    fh.chunk_records = chunk_records_;
+    fh.payload_len   = static_cast<uint32_t>(kPayloadLen);
+    fh.created_ns    = NowNs();
+    std::memcpy(header_map_, &fh, sizeof(fh));
+
+    MYLOG_INFO("飞控遥测记录已开启: file={}, chunk_records={}", path_, chunk_records_);
+    return true;
+}
+
+void TelemetryRecorder::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CloseLocked();
+}
+
+bool TelemetryRecorder::IsOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fd_ >= 0;
+}
+
+void TelemetryRecorder::CloseLocked() {
+    if (fd_ < 0) {
+        return;
+    }
+    SealChunkLocked();
+    if (header_map_ != nullptr) {
+        ::munmap(header_map_, kHeaderSize);
+        header_map_ = nullptr;
+    }
+    if (idx_file_ != nullptr) {
+        std::fclose(idx_file_);
+        idx_file_ = nullptr;
+    }
+    ::close(fd_);
+    fd_ = -1;
+    MYLOG_INFO("飞控遥测记录已关闭: file={}, records={}, chunks={}", path_, stats_.records, stats_.chunks);
+}
+
+bool TelemetryRecorder::MapNextChunkLocked(std::string* err) {
+    const off_t offset = static_cast<off_t>(kHeaderSize + chunk_no_ * chunk_bytes_);
+    if (::ftruncate(fd_, offset + static_cast<off_t>(chunk_bytes_)) != 0) {
+        SetError(err, std::string("扩展遥测记录文件失败: ") + std::strerror(errno));
+        return false;
+    }
+    void* map = ::mmap(nullptr, chunk_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, offset);
+    if (map == MAP_FAILED) {
+        SetError(err, std::string("映射遥测记录 chunk 失败: ") + std::strerror(errno));
+        return false;
+    }
+    chunk_map_  = static_cast<uint8_t*>(map);
+    chunk_used_ = 0;
+    current_    = TelemetryChunkIndex{};
+    current_.chunk = chunk_no_;
+    ++stats_.chunks;
+
+    auto* fh = reinterpret_cast<FileHeader*>(header_map_);
+    fh->chunk_count = chunk_no_ + 1;
+    return true;
+}
+
+void TelemetryRecorder::SealChunkLocked() {
+    if (chunk_map_ == nullptr) {
+        return;
+    }
+    ::munmap(chunk_map_, chunk_bytes_);
+    chunk_map_ = nullptr;
+
+    if (idx_file_ != nullptr && current_.count > 0) {
+        std::fwrite(&current_, sizeof(current_), 1, idx_file_);
+        std::fflush(idx_file_);
+    }
+}
+
+bool TelemetryRecorder::AppendPayload(uint64_t timestamp_ns, uint8_t cnt,
+                                      const uint8_t* payload, size_t payload_len) {
+    if (payload == nullptr || payload_len != kPayloadLen) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        ++stats_.dropped;
+        return false;
+    }
+
+    if (chunk_map_ != nullptr && chunk_used_ == chunk_records_) {
+        SealChunkLocked();
+        ++chunk_no_;
+    }
+    if (chunk_map_ == nullptr) {
+        std::string err;
+        if (!MapNextChunkLocked(&err)) {
+            ++stats_.dropped;
+            MYLOG_WARN("飞控遥测记录写入失败: {}", err);
+            return false;
+        }
+    }
+
+    const uint32_t seq = static_cast<uint32_t>(stats_.records);
+    uint8_t* rec = chunk_map_ + static_cast<size_t>(chunk_used_) * kRecordSize;
+    layout::StoreLE<uint64_t>(rec, timestamp_ns);
+    layout::StoreLE<uint32_t>(rec + 8, seq);
+    rec[12] = cnt;
+    std::memcpy(rec + kPayloadOffset, payload, kPayloadLen);
+
+    if (current_.count == 0) {
+        current_.first_ns = timestamp_ns;
+    }
+    current_.last_ns = timestamp_ns;
+    ++current_.count;
+    ++chunk_used_;
+    ++stats_.records;
+
+    reinterpret_cast<FileHeader*>(header_map_)->record_count = stats_.records;
+    return true;
+}
+
+bool TelemetryRecorder::Append(uint64_t timestamp_ns, const HeartbeatData& hb) {
+    uint8_t payload[kPayloadLen];
+    layout::MessageLayout<HeartbeatData>::FieldsT::Store(hb, payload);
+    return AppendPayload(timestamp_ns, hb.cnt, payload, kPayloadLen);
+}
+
+std::function<void(const HeartbeatData&)> TelemetryRecorder::MakeHeartbeatCallback() {
+    return [this](const HeartbeatData& hb) { Append(NowNs(), hb); };
+}
+
+TelemetryRecorder::Stats TelemetryRecorder::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// =============================================================================
+// TelemetryReader
+// =============================================================================
+
+TelemetryReader::~TelemetryReader() {
+    Close();
+}
+
+bool TelemetryReader::Open(const std::string& file_path, std::string* err) {
+    Close();
+
+    const int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        SetError(err, "打开遥测记录文件失败: " + file_path + ", error=" + std::strerror(errno));
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < TelemetryRecorder::kHeaderSize) {
+        SetError(err, "遥测记录文件过小: " + file_path);
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        SetError(err, std::string("映射遥测记录文件失败: ") + std::strerror(errno));
+        return false;
+    }
+
+    FileHeader fh{};
+    std::memcpy(&fh, map, sizeof(fh));
+    if (std::memcmp(fh.magic, kFileMagic, sizeof(kFileMagic)) != 0 ||
+        fh.record_size != TelemetryRecorder::kRecordSize ||
+        fh.payload_len != TelemetryRecorder::kPayloadLen ||
+        fh.chunk_records == 0) {
+        SetError(err, "遥测记录文件头无效: " + file_path);
+        ::munmap(map, size);
+        return false;
+    }
+
+    map_           = static_cast<uint8_t*>(map);
+    map_size_      = size;
+    chunk_records_ = fh.chunk_records;
+    const size_t capacity = (size - TelemetryRecorder::kHeaderSize) / TelemetryRecorder::kRecordSize;
+    count_ = static_cast<size_t>(std::min<uint64_t>(fh.record_count, capacity));
+
+    // 读取旁路索引；缺失或与数据不一致的 chunk 直接由首尾记录重建
+    std::vector<TelemetryChunkIndex> on_disk;
+    if (FILE* idx = std::fopen(IndexPath(file_path).c_str(), "rb")) {
+        TelemetryChunkIndex entry;
+        while (std::fread(&entry, sizeof(entry), 1, idx) == 1) {
+            on_disk.push_back(entry);
+        }
+        std::fclose(idx);
+    }
+
+    const size_t chunk_count = (count_ + chunk_records_ - 1) / chunk_records_;
+    chunks_.clear();
+    chunks_.reserve(chunk_count);
+    for (size_t c = 0; c < chunk_count; ++c) {
+        const size_t first = c * chunk_records_;
+        const size_t n = std::min<size_t>(chunk_records_, count_ - first);
+        if (c < on_disk.size() && on_disk[c].chunk == c && on_disk[c].count == n) {
+            chunks_.push_back(on_disk[c]);
+            continue;
+        }
+        TelemetryChunkIndex entry;
+        entry.chunk    = c;
+        entry.first_ns = TimestampAt(first);
+        entry.last_ns  = TimestampAt(first + n - 1);
+        entry.count    = n;
+        chunks_.push_back(entry);
+    }
+    return true;
+}
+
+void TelemetryReader::Close() {
+    if (map_ != nullptr) {
+        ::munmap(map_, map_size_);
+        map_ = nullptr;
+    }
+    map_size_ = 0;
+    count_    = 0;
+    chunks_.clear();
+}
+
+const uint8_t* TelemetryReader::RecordAt(size_t i) const {
+    return map_ + TelemetryRecorder::kHeaderSize + i * TelemetryRecorder::kRecordSize;
+}
+
+uint64_t TelemetryReader::TimestampAt(size_t i) const {
+    return layout::LoadLE<uint64_t>(RecordAt(i));
+}
+
+uint8_t TelemetryReader::CntAt(size_t i) const {
+    return RecordAt(i)[12];
+}
+
+const uint8_t* TelemetryReader::PayloadAt(size_t i) const {
+    return RecordAt(i) + TelemetryRecorder::kPayloadOffset;
+}
+
+bool TelemetryReader::Read(size_t i, TelemetryRecord& out) const {
+    if (map_ == nullptr || i >= count_) {
+        return false;
+    }
+    const uint8_t* rec = RecordAt(i);
+    out.timestamp_ns  = layout::LoadLE<uint64_t>(rec);
+    out.seq           = layout::LoadLE<uint32_t>(rec + 8);
+    out.heartbeat.cnt = rec[12];
+    return DecodePayload(rec + TelemetryRecorder::kPayloadOffset, TelemetryRecorder::kPayloadLen,
+                         out.heartbeat);
+}
+
+size_t TelemetryReader::LowerBound(uint64_t timestamp_ns) const {
+    // 先按 chunk 末时间戳定位 chunk，再在 chunk 内二分（记录按时间追加，单调不减）
+    auto chunk_it = std::partition_point(chunks_.begin(), chunks_.end(),
+                                         [&](const TelemetryChunkIndex& c) { return c.last_ns < timestamp_ns; });
+    if (chunk_it == chunks_.end()) {
+        return count_;
+    }
+    size_t lo = static_cast<size_t>(chunk_it->chunk) * chunk_records_;
+    size_t hi = lo + static_cast<size_t>(chunk_it->count);
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (TimestampAt(mid) < timestamp_ns) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+} // namespace fly_control
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "FlyControlLayout.h"
+#include "FlyControlProtocol.h"
+
+// =============================================================================
+// 飞控遥测记录（心跳全速率落盘）
+//
+// TelemetryRecorder：把每个心跳以定长记录追加到内存映射文件
+//   - 文件按 chunk 增长：每次 ftruncate 扩一个 chunk 并只映射当前 chunk，
+//     追加一条记录只有一次 memcpy，不走 write 系统调用
+//   - 记录保存心跳的线上载荷（小端字节），与结构体内存布局无关，回放时可原样组帧
+//   - 每个 chunk 封存时向旁路索引文件 <file>.idx 追加 {chunk, 首/末时间戳, 条数}
+//
+// TelemetryReader：只读映射整个文件，按下标或时间戳（先查 chunk 索引再二分）定位记录。
+//   索引文件缺失或落后（异常退出）时按 chunk 首尾记录补齐。
+//
+// 文件布局：
+//   [FileHeader，占 4096 字节][chunk 0][chunk 1]...
+//   chunk = chunk_records 条 × 128 字节记录
+//   记录 = [timestamp_ns 8B][seq 4B][cnt 1B][保留 3B][心跳载荷 82B][保留]
+// =============================================================================
+
+namespace fly_control {
+
+// 一条遥测记录（读出后的形式）
+struct TelemetryRecord {
+    uint64_t      timestamp_ns = 0;   // system_clock 纳秒
+    uint32_t      seq          = 0;   // 记录序号
+    HeartbeatData heartbeat;
+};
+
+// chunk 索引项（同时是 .idx 文件中的磁盘格式）
+struct TelemetryChunkIndex {
+    uint64_t chunk    = 0;
+    uint64_t first_ns = 0;
+    uint64_t last_ns  = 0;
+    uint64_t count    = 0;
+};
+
+class TelemetryRecorder {
+public:
+    static constexpr size_t   kHeaderSize          = 4096;
+    static constexpr size_t   kRecordSize          = 128;
+    static constexpr size_t   kPayloadOffset       = 16;
+    static constexpr size_t   kPayloadLen          = layout::MessageLayout<HeartbeatData>::kPayloadLen;
+    static constexpr uint32_t kDefaultChunkRecords = 4096;
+
+    static_assert(kPayloadOffset + kPayloadLen <= kRecordSize, "心跳载荷超出定长记录");
+
+    struct Stats {
+        uint64_t records = 0;   // 已追加记录数
+        uint64_t chunks  = 0;   // 已使用 chunk 数
+        uint64_t dropped = 0;   // 未打开或映射失败时丢弃的记录
+    };
+
+    TelemetryRecorder() = default;
+    ~TelemetryRecorder();
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    // 创建（覆盖）记录文件；chunk_records 会向上取整为 32 的倍数，保证 chunk 按页对齐
+    bool Open(const std::string& file_path,
+              uint32_t chunk_records = kDefaultChunkRecords,
+              std::string* err = nullptr);
+
+    // 封存当前 chunk、写索引并关闭文件
+    void Close();
+
+    bool IsOpen() const;
+
+    // 追加心跳的线上载荷（payload_len 必须等于 kPayloadLen）
+    bool AppendPayload(uint64_t timestamp_ns, uint8_t cnt, const uint8_t* payload, size_t payload_len);
+
+    // 追加已解码的心跳（按协议描述表重新编码为线上载荷）
+    bool Append(uint64_t timestamp_ns, const HeartbeatData& hb);
+
+    // 供 MyFlyControl::SetOnHeartbeat 直接使用的回调，以当前时间打戳
+    std::function<void(const HeartbeatData&)> MakeHeartbeatCallback();
+
+    Stats GetStats() const;
+
+    // 当前时间（system_clock 纳秒）
+    static uint64_t NowNs();
+
+private:
+    bool MapNextChunkLocked(std::string* err);
+    void SealChunkLocked();
+    void CloseLocked();
+
+    mutable std::mutex mutex_;
+    std::string        path_;
+    int                fd_            = -1;
+    FILE*              idx_file_      = nullptr;
+    uint8_t*           header_map_    = nullptr;
+    uint8_t*           chunk_map_     = nullptr;
+    uint32_t           chunk_records_ = kDefaultChunkRecords;
+    size_t             chunk_bytes_   = 0;
+    uint64_t           chunk_no_      = 0;     // 当前映射的 chunk 编号
+    uint32_t           chunk_used_    = 0;     // 当前 chunk 已写记录数
+    TelemetryChunkIndex current_;
+    Stats              stats_;
+};
+
+class TelemetryReader {
+public:
+    TelemetryReader() = default;
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    bool Open(const std::string& file_path, std::string* err = nullptr);
+    void Close();
+
+    size_t Count() const { return count_; }
+    const std::vector<TelemetryChunkIndex>& Chunks() const { return chunks_; }
+
+    // 读取第 i 条记录并解码心跳
+    bool Read(size_t i, TelemetryRecord& out) const;
+
+    // 第 i 条记录的原始字段（回放组帧用，不解码）
+    uint64_t TimestampAt(size_t i) const;
+    uint8_t CntAt(size_t i) const;
+    const uint8_t* PayloadAt(size_t i) const;
+
+    // 第一条 timestamp_ns >= ts 的记录下标；都小于 ts 时返回 Count()
+    size_t LowerBound(uint64_t timestamp_ns) const;
+
+private:
+    const uint8_t* RecordAt(size_t i) const;
+
+    uint8_t*  map_           = nullptr;
+    size_t    map_size_      = 0;
+    size_t    count_         = 0;
+    uint32_t  chunk_records_ = 0;
+    std::vector<TelemetryChunkIndex> chunks_;
+};
+
+} // namespace fly_control
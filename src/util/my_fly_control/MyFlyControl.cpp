@@ -1,7 +1,9 @@
 #include "MyFlyControl.h"
 #include "MyLog.h"
+#include "MyProtocolTrace.h"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
@@ -14,15 +16,20 @@ namespace fly_control {
 
 namespace {
 
-std::string BytesToHexString(const std::vector<uint8_t>& data, size_t max_bytes = 96) {
-    if (data.empty()) {
+// 飞控模块日志开关：收发热路径的逐帧日志走 DEBUG/TRACE，级别未开启时不构造十六进制字符串
+MyLog::LogModule& kLog = MyLog::GetModule("fly_control");
+
+constexpr uint8_t kTraceChannel = 0;
+
+std::string BytesToHexString(const uint8_t* data, size_t len, size_t max_bytes = 96) {
+    if (data == nullptr || len == 0) {
         return "<empty>";
     }
 
     std::ostringstream oss;
     oss << std::hex << std::uppercase << std::setfill('0');
 
-    const size_t limit = std::min(data.size(), max_bytes);
+    const size_t limit = std::min(len, max_bytes);
     for (size_t i = 0; i < limit; ++i) {
         if (i != 0) {
             oss << ' ';
@@ -30,13 +37,17 @@ std::string BytesToHexString(const std::vector<uint8_t>& data, size_t max_bytes
         oss << std::setw(2) << static_cast<int>(data[i]);
     }
 
-    if (data.size() > limit) {
-        oss << " ...( +" << (data.size() - limit) << " bytes)";
+    if (len > limit) {
+        oss << " ...( +" << (len - limit) << " bytes)";
     }
 
     return oss.str();
 }
 
+std::string BytesToHexString(const std::vector<uint8_t>& data, size_t max_bytes = 96) {
+    return BytesToHexString(data.data(), data.size(), max_bytes);
+}
+
 void LogSerialSnapshot(const std::string& prefix,
                        const my_serial::SerialPortSnapshot& snapshot) {
     MYLOG_INFO(
@@ -75,6 +86,55 @@ bool MyFlyControl::Init(const nlohmann::json& cfg, std::string* err) {
         return false;
     }
     LogSerialSnapshot("飞控模块串口初始化成功，串口快照:", serial_.GetSnapshot());
+
+    // 指令应答超时与重试策略
+    retry_policy_.timeout_ms  = cfg.value("reply_timeout_ms", 2000u);
+    retry_policy_.max_retries = cfg.value("command_max_retries", 0u);
+    MYLOG_INFO("飞控指令应答策略: reply_timeout_ms={}, command_max_retries={}",
+               retry_policy_.timeout_ms, retry_policy_.max_retries);
+
+    // 模块日志级别（默认 info：逐帧 DEBUG/TRACE 日志关闭）
+    const std::string log_level = cfg.value("log_level", std::string("info"));
+    if (!MyLog::SetModuleLevel(kLog.name, log_level)) {
+        MYLOG_WARN("飞控模块 log_level 无效: {}, 保持原级别", log_level);
+    }
+
+    // 协议抓包：原始收发字节写入二进制环形文件，替代十六进制日志
+    trace_.Close();
+    if (cfg.contains("protocol_trace") && cfg["protocol_trace"].is_object()) {
+        const auto& trace_cfg = cfg["protocol_trace"];
+        if (trace_cfg.value("enable", false)) {
+            MyLog::ProtocolTrace::Options opt;
+            opt.file_path           = trace_cfg.value("file", std::string("logs/fly_control_trace.bin"));
+            opt.ring_bytes          = trace_cfg.value("ring_bytes", opt.ring_bytes);
+            opt.sample_every        = trace_cfg.value("sample_every", opt.sample_every);
+            opt.max_records_per_sec = trace_cfg.value("max_records_per_sec", opt.max_records_per_sec);
+            std::string trace_err;
+            if (trace_.Open(opt, &trace_err)) {
+                MYLOG_INFO("飞控协议抓包已开启: file={}, ring_bytes={}, sample_every={}, max_records_per_sec={}",
+                           opt.file_path, opt.ring_bytes, opt.sample_every, opt.max_records_per_sec);
+            } else {
+                MYLOG_WARN("飞控协议抓包开启失败: {}", trace_err);
+            }
+        }
+    }
+
+    // 遥测记录：每个心跳以定长记录追加到分块映射文件，供事后分析与回放
+    record_telemetry_ = false;
+    recorder_.Close();
+    if (cfg.contains("telemetry_record") && cfg["telemetry_record"].is_object()) {
+        const auto& rec_cfg = cfg["telemetry_record"];
+        if (rec_cfg.value("enable", false)) {
+            const std::string file = rec_cfg.value("file", std::string("logs/fly_control_telemetry.bin"));
+            const uint32_t chunk_records =
+                rec_cfg.value("chunk_records", TelemetryRecorder::kDefaultChunkRecords);
+            std::string rec_err;
+            record_telemetry_ = recorder_.Open(file, chunk_records, &rec_err);
+            if (!record_telemetry_) {
+                MYLOG_WARN("飞控遥测记录开启失败: {}", rec_err);
+            }
+        }
+    }
     return true;
 }
 
@@ -122,6 +182,9 @@ void MyFlyControl::Stop() {
     }
     recv_thread_.reset();
 
+    // 接收线程已退出，在途指令不会再收到回复
+    correlator_.FailAll("fly control stopped");
+
     serial_.Close();
     MYLOG_INFO("飞控模块已停止");
 }
@@ -183,9 +246,10 @@ bool MyFlyControl::SendSetDestination(int32_t lon, int32_t lat, uint16_t alt,
     data.longitude = lon;
     data.latitude  = lat;
     data.altitude  = alt;
-    auto frame = EncodeSetDestination(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
     MYLOG_INFO("发送指令: 设置飞行目的地");
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendSetRoute(const std::vector<RoutePoint>& points,
@@ -196,26 +260,29 @@ bool MyFlyControl::SendSetRoute(const std::vector<RoutePoint>& points,
     }
     SetRouteData data;
     data.points = points;
-    auto frame = EncodeSetRoute(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeSetRoute(cnt, data);
     MYLOG_INFO("发送指令: 设置飞行航线, 航线点数={}", points.size());
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendSetAngle(int16_t pitch, uint16_t yaw, std::string* err) {
     SetAngleData data;
     data.pitch = pitch;
     data.yaw   = yaw;
-    auto frame = EncodeSetAngle(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
     MYLOG_INFO("发送指令: 角度控制");
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendSetSpeed(uint16_t speed, std::string* err) {
     SetSpeedData data;
     data.speed = speed;
-    auto frame = EncodeSetSpeed(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
     MYLOG_INFO("发送指令: 速度控制, speed={}", speed);
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendSetAltitude(uint8_t alt_type, uint16_t altitude,
@@ -223,33 +290,37 @@ bool MyFlyControl::SendSetAltitude(uint8_t alt_type, uint16_t altitude,
     SetAltitudeData data;
     data.altitude_type = alt_type;
     data.altitude      = altitude;
-    auto frame = EncodeSetAltitude(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
     MYLOG_INFO("发送指令: 高度控制");
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendPowerSwitch(uint8_t command, std::string* err) {
     PowerSwitchData data;
     data.command = command;
-    auto frame = EncodePowerSwitch(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
     MYLOG_INFO("发送指令: 电源开关, cmd=0x{:02X}", command);
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendParachute(uint8_t parachute_type, std::string* err) {
     ParachuteData data;
     data.parachute_type = parachute_type;
-    auto frame = EncodeParachute(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
     MYLOG_INFO("发送指令: 开伞控制, type=0x{:02X}", parachute_type);
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendButtonCommand(uint8_t button, std::string* err) {
     ButtonCommandData data;
     data.button = button;
-    auto frame = EncodeButtonCommand(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
     MYLOG_INFO("发送指令: 指令按钮=0x{:02X}", button);
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendSetOriginReturn(uint8_t point_type, int32_t lon,
@@ -260,9 +331,10 @@ bool MyFlyControl::SendSetOriginReturn(uint8_t point_type, int32_t lon,
     data.longitude  = lon;
     data.latitude   = lat;
     data.altitude   = alt;
-    auto frame = EncodeSetOriginReturn(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
     MYLOG_INFO("发送指令: 设置{}", point_type == 0 ? "原点" : "返航点");
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendSetGeofence(const std::vector<GeofencePoint>& points,
@@ -273,47 +345,97 @@ bool MyFlyControl::SendSetGeofence(const std::vector<GeofencePoint>& points,
     }
     SetGeofenceData data;
     data.points = points;
-    auto frame = EncodeSetGeofence(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeSetGeofence(cnt, data);
     MYLOG_INFO("发送指令: 设置电子围栏, 点数={}", points.size());
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendSwitchMode(uint8_t mode, std::string* err) {
     SwitchModeData data;
     data.mode = mode;
-    auto frame = EncodeSwitchMode(NextCnt(), data);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
     MYLOG_INFO("发送指令: 切换运行模式=0x{:02X}", mode);
-    return SendRawData(frame, err);
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendGuidance(const GuidanceData& data, std::string* err) {
-    auto frame = EncodeGuidance(NextCnt(), data);
-    MYLOG_INFO("发送指令: 末制导指令");
-    return SendRawData(frame, err);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
+    MYLOG_MODULE_DEBUG(kLog, "发送指令: 末制导指令");
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendGuidanceNew(const GuidanceNewData& data, std::string* err) {
-    auto frame = EncodeGuidanceNew(NextCnt(), data);
-    MYLOG_INFO("发送指令: 末制导指令(新版)");
-    return SendRawData(frame, err);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
+    MYLOG_MODULE_DEBUG(kLog, "发送指令: 末制导指令(新版)");
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendGimbalAngRate(const GimbalAngRateData& data, std::string* err) {
-    auto frame = EncodeGimbalAngRate(NextCnt(), data);
-    MYLOG_INFO("发送指令: 吊舱姿态-角速度模式");
-    return SendRawData(frame, err);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
+    MYLOG_MODULE_DEBUG(kLog, "发送指令: 吊舱姿态-角速度模式");
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendGimbalAngle(const GimbalAngleData& data, std::string* err) {
-    auto frame = EncodeGimbalAngle(NextCnt(), data);
-    MYLOG_INFO("发送指令: 吊舱姿态-角度模式");
-    return SendRawData(frame, err);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
+    MYLOG_MODULE_DEBUG(kLog, "发送指令: 吊舱姿态-角度模式");
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
 }
 
 bool MyFlyControl::SendTargetState(const TargetStateData& data, std::string* err) {
-    auto frame = EncodeTargetState(NextCnt(), data);
-    MYLOG_INFO("发送指令: 识别目标状态");
-    return SendRawData(frame, err);
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeFrameArray(cnt, data);
+    MYLOG_MODULE_DEBUG(kLog, "发送指令: 识别目标状态");
+    return SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), -1, nullptr, nullptr, err);
+}
+
+// =============================================================================
+// 异步发送
+// =============================================================================
+
+std::future<CommandResult> MyFlyControl::SendSetRouteAsync(const std::vector<RoutePoint>& points,
+                                                           CommandResultCallback cb,
+                                                           int max_retries) {
+    if (points.empty() || points.size() > 50) {
+        return RejectCommand(CMD_SET_ROUTE, "航线点数量必须在 1~50 之间", cb);
+    }
+    SetRouteData data;
+    data.points = points;
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeSetRoute(cnt, data);
+    std::future<CommandResult> result;
+    SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), max_retries, std::move(cb),
+                &result, nullptr);
+    return result;
+}
+
+std::future<CommandResult> MyFlyControl::SendSetGeofenceAsync(const std::vector<GeofencePoint>& points,
+                                                              CommandResultCallback cb,
+                                                              int max_retries) {
+    if (points.size() < 3 || points.size() > 50) {
+        return RejectCommand(CMD_SET_GEOFENCE, "电子围栏点数量必须在 3~50 之间", cb);
+    }
+    SetGeofenceData data;
+    data.points = points;
+    const uint8_t cnt = NextCnt();
+    auto frame = EncodeSetGeofence(cnt, data);
+    std::future<CommandResult> result;
+    SendTracked(cnt, data.cmd_type, frame.data(), frame.size(), max_retries, std::move(cb),
+                &result, nullptr);
+    return result;
+}
+
+nlohmann::json MyFlyControl::GetCommandStatsJson() const {
+    nlohmann::json j = correlator_.GetStatsJson();
+    j["reply_timeout_ms"]    = retry_policy_.timeout_ms;
+    j["command_max_retries"] = retry_policy_.max_retries;
+    return j;
 }
 
 // =============================================================================
@@ -323,14 +445,19 @@ bool MyFlyControl::SendTargetState(const TargetStateData& data, std::string* err
 void MyFlyControl::ReceiveLoop() {
     LogSerialSnapshot("飞控接收线程启动，当前串口状态:", serial_.GetSnapshot());
     constexpr size_t READ_BUF_SIZE = 256;
+    std::array<uint8_t, READ_BUF_SIZE> read_buf{};  // 读缓冲区，循环复用
+    FrameView frame;                                 // 取帧结果（指向解析器缓冲区的视图）
     size_t read_count = 0;
     size_t empty_read_count = 0;
     size_t total_bytes = 0;
 
     while (running_.load()) {
+        // 处理回复超时与重发
+        ServicePendingCommands();
+
         // 从串口读取数据
         std::string err;
-        auto bytes = serial_.ReadBytes(READ_BUF_SIZE, &err);
+        const size_t n = serial_.ReadInto(read_buf.data(), read_buf.size(), &err);
         ++read_count;
 
         if (!err.empty()) {
@@ -339,11 +466,11 @@ void MyFlyControl::ReceiveLoop() {
             continue;
         }
 
-        if (bytes.empty()) {
+        if (n == 0) {
             ++empty_read_count;
             if (empty_read_count == 1 || empty_read_count % 5 == 0) {
                 const auto snapshot = serial_.GetSnapshot();
-                MYLOG_INFO(
+                MYLOG_MODULE_DEBUG(kLog,
                     "飞控串口暂未读到数据: read_count={}, empty_read_count={}, parser_buffer_pending={}, port={}, available_bytes={}",
                     read_count,
                     empty_read_count,
@@ -357,33 +484,33 @@ void MyFlyControl::ReceiveLoop() {
         }
 
         empty_read_count = 0;
-        total_bytes += bytes.size();
+        total_bytes += n;
+        trace_.Record(kTraceChannel, MyLog::ProtocolTrace::kDirRx, read_buf.data(), n);
 
         const size_t parser_buffer_before = parser_.BufferSize();
-        MYLOG_INFO(
+        MYLOG_MODULE_TRACE(kLog,
             "飞控串口收到原始数据: read_count={}, bytes={}, total_bytes={}, parser_buffer_before={}, hex={}",
             read_count,
-            bytes.size(),
+            n,
             total_bytes,
             parser_buffer_before,
-            BytesToHexString(bytes));
+            BytesToHexString(read_buf.data(), n));
 
         // 喂入帧解析器
-        parser_.FeedData(bytes);
-        MYLOG_INFO("飞控帧解析器已喂入数据: parser_buffer_after_feed={}", parser_.BufferSize());
+        parser_.FeedData(read_buf.data(), n);
+        MYLOG_MODULE_TRACE(kLog, "飞控帧解析器已喂入数据: parser_buffer_after_feed={}", parser_.BufferSize());
 
-        // 尝试取出所有可用帧
-        ParsedFrame frame;
+        // 尝试取出所有可用帧（零拷贝视图，载荷直接在解析器缓冲区上解码）
         size_t parsed_frame_count = 0;
-        while (parser_.PopFrame(frame)) {
+        while (parser_.PopFrameView(frame)) {
             ++parsed_frame_count;
-            MYLOG_INFO(
+            MYLOG_MODULE_DEBUG(kLog,
                 "飞控帧解析结果: index={}, cnt={}, frame_type=0x{:02X}({}), payload_len={}, checksum=0x{:02X}, valid={}",
                 parsed_frame_count,
                 frame.cnt,
                 frame.frame_type,
                 GetFrameTypeName(frame.frame_type),
-                frame.payload.size(),
+                frame.payload_len,
                 frame.checksum,
                 frame.valid ? "true" : "false");
 
@@ -392,17 +519,17 @@ void MyFlyControl::ReceiveLoop() {
                     "收到校验和不通过的帧, 帧类型=0x{:02X}, cnt={}, payload_len={}, payload_hex={}, 丢弃",
                     frame.frame_type,
                     frame.cnt,
-                    frame.payload.size(),
-                    BytesToHexString(frame.payload));
+                    frame.payload_len,
+                    BytesToHexString(frame.payload, frame.payload_len));
                 continue;
             }
             HandleFrame(frame);
         }
 
         if (parsed_frame_count == 0) {
-            MYLOG_INFO("当前读取批次尚未拼出完整帧: parser_buffer_remaining={}", parser_.BufferSize());
+            MYLOG_MODULE_TRACE(kLog, "当前读取批次尚未拼出完整帧: parser_buffer_remaining={}", parser_.BufferSize());
         } else {
-            MYLOG_INFO(
+            MYLOG_MODULE_TRACE(kLog,
                 "当前读取批次拆帧完成: parsed_frame_count={}, parser_buffer_remaining={}",
                 parsed_frame_count,
                 parser_.BufferSize());
@@ -415,13 +542,13 @@ void MyFlyControl::ReceiveLoop() {
                parser_.BufferSize());
 }
 
-void MyFlyControl::HandleFrame(const ParsedFrame& frame) {
+void MyFlyControl::HandleFrame(const FrameView& frame) {
     switch (frame.frame_type) {
         case FRAME_TYPE_HEARTBEAT: {
             HeartbeatData hb;
             hb.cnt = frame.cnt;
-            if (DecodeHeartbeat(frame.payload, hb)) {
-                MYLOG_INFO(
+            if (DecodeHeartbeat(frame.payload, frame.payload_len, hb)) {
+                MYLOG_MODULE_DEBUG(kLog,
                     "收到飞控心跳: cnt={}, aircraft_id={}, run_mode=0x{:02X}, satellites={}, lon={:.7f}, lat={:.7f}, altitude={:.1f}m, relative_alt={:.1f}m, flight_mode=0x{:02X}, flight_state=0x{:02X}, battery={}%, fault_info=0x{:04X}",
                     hb.cnt,
                     hb.aircraft_id,
@@ -436,6 +563,11 @@ void MyFlyControl::HandleFrame(const ParsedFrame& frame) {
                     hb.battery_percent,
                     hb.fault_info);
 
+                if (record_telemetry_) {
+                    recorder_.AppendPayload(TelemetryRecorder::NowNs(), frame.cnt,
+                                            frame.payload, frame.payload_len);
+                }
+
                 // 更新最新心跳数据
                 bool first_heartbeat = false;
                 {
@@ -463,9 +595,13 @@ void MyFlyControl::HandleFrame(const ParsedFrame& frame) {
         case FRAME_TYPE_REPLY: {
             CommandReplyData reply;
             reply.cnt = frame.cnt;
-            if (DecodeCommandReply(frame.payload, reply)) {
-                MYLOG_INFO("收到指令回复: {}={}", GetCommandName(reply.replied_cmd),
-                           reply.result == 0 ? "成功" : "失败");
+            if (DecodeCommandReply(frame.payload, frame.payload_len, reply)) {
+                MYLOG_MODULE_DEBUG(kLog, "收到指令回复: {}={}", GetCommandName(reply.replied_cmd),
+                                   reply.result == 0 ? "成功" : "失败");
+                if (!correlator_.OnReply(reply)) {
+                    MYLOG_WARN("指令回复未匹配到在途指令: cnt={}, cmd={}",
+                               reply.cnt, GetCommandName(reply.replied_cmd));
+                }
                 std::lock_guard<std::mutex> lock(cb_mutex_);
                 if (on_reply_) {
                     on_reply_(reply);
@@ -479,12 +615,12 @@ void MyFlyControl::HandleFrame(const ParsedFrame& frame) {
         case FRAME_TYPE_GIMBAL_CONTROL: {
             GimbalControlData gimbal;
             gimbal.cnt = frame.cnt;
-            if (DecodeGimbalControl(frame.payload, gimbal)) {
-                MYLOG_INFO("收到云台控制: cnt={}, enable={}, pitch_angle={}, yaw_angle={}",
-                           gimbal.cnt,
-                           gimbal.enable,
-                           gimbal.pitch_angle,
-                           gimbal.yaw_angle);
+            if (DecodeGimbalControl(frame.payload, frame.payload_len, gimbal)) {
+                MYLOG_MODULE_DEBUG(kLog, "收到云台控制: cnt={}, enable={}, pitch_angle={}, yaw_angle={}",
+                                   gimbal.cnt,
+                                   gimbal.enable,
+                                   gimbal.pitch_angle,
+                                   gimbal.yaw_angle);
                 std::lock_guard<std::mutex> lock(cb_mutex_);
                 if (on_gimbal_) {
                     on_gimbal_(gimbal);
@@ -502,18 +638,96 @@ void MyFlyControl::HandleFrame(const ParsedFrame& frame) {
 }
 
 bool MyFlyControl::SendRawData(const std::vector<uint8_t>& data, std::string* err) {
+    return SendRawData(data.data(), data.size(), err);
+}
+
+bool MyFlyControl::SendRawData(const uint8_t* data, size_t len, std::string* err) {
     std::lock_guard<std::mutex> lock(send_mutex_);
-    MYLOG_INFO("飞控串口发送原始数据: bytes={}, hex={}", data.size(), BytesToHexString(data));
-    size_t written = serial_.Write(data, err);
-    if (written != data.size()) {
+    trace_.Record(kTraceChannel, MyLog::ProtocolTrace::kDirTx, data, len);
+    MYLOG_MODULE_TRACE(kLog, "飞控串口发送原始数据: bytes={}, hex={}", len, BytesToHexString(data, len));
+    size_t written = serial_.Write(data, len, err);
+    if (written != len) {
         MYLOG_WARN("飞控串口发送字节数不匹配: expected={}, actual={}, err={}",
-                   data.size(),
+                   len,
                    written,
                    (err != nullptr && !err->empty()) ? *err : std::string("unknown error"));
     } else {
-        MYLOG_INFO("飞控串口发送完成: written={}", written);
+        MYLOG_MODULE_TRACE(kLog, "飞控串口发送完成: written={}", written);
+    }
+    return written == len;
+}
+
+bool MyFlyControl::SendTracked(uint8_t cnt, uint8_t cmd_type, const uint8_t* frame, size_t len,
+                               int max_retries, CommandResultCallback cb,
+                               std::future<CommandResult>* result, std::string* err) {
+    CommandRetryPolicy policy = retry_policy_;
+    if (max_retries >= 0) {
+        policy.max_retries = static_cast<uint32_t>(max_retries);
+    }
+
+    // 接收线程未运行时收不到回复，不登记
+    if (!running_.load()) {
+        const bool ok = SendRawData(frame, len, err);
+        if (result != nullptr) {
+            std::promise<CommandResult> done;
+            CommandResult r;
+            r.cnt      = cnt;
+            r.cmd_type = cmd_type;
+            r.attempts = 1;
+            r.error    = ok ? "fly control not running, reply not tracked" : "serial write failed";
+            if (cb) {
+                cb(r);
+            }
+            done.set_value(std::move(r));
+            *result = done.get_future();
+        }
+        return ok;
+    }
+
+    // 先登记再发送，避免回复先于登记到达；仅需重发时保留原始帧
+    std::vector<uint8_t> copy;
+    if (policy.max_retries > 0) {
+        copy.assign(frame, frame + len);
+    }
+    auto future = correlator_.Register(cnt, cmd_type, std::move(copy), policy, std::move(cb));
+
+    std::string send_err;
+    const bool ok = SendRawData(frame, len, &send_err);
+    if (!ok) {
+        correlator_.Cancel(cnt, cmd_type, send_err.empty() ? "serial write failed" : send_err);
+        if (err) *err = send_err;
+    }
+    if (result != nullptr) {
+        *result = std::move(future);
+    }
+    return ok;
+}
+
+std::future<CommandResult> MyFlyControl::RejectCommand(uint8_t cmd_type, const std::string& error,
+                                                       const CommandResultCallback& cb) {
+    MYLOG_WARN("指令参数非法，未发送: cmd={}, err={}", GetCommandName(cmd_type), error);
+    CommandResult r;
+    r.cmd_type = cmd_type;
+    r.error    = error;
+    if (cb) {
+        cb(r);
+    }
+    std::promise<CommandResult> done;
+    done.set_value(std::move(r));
+    return done.get_future();
+}
+
+void MyFlyControl::ServicePendingCommands() {
+    resend_buf_.clear();
+    correlator_.CollectTimeouts(CommandCorrelator::Clock::now(), resend_buf_);
+    for (const auto& item : resend_buf_) {
+        MYLOG_WARN("指令等待回复超时，重发: cmd={}, cnt={}, attempt={}",
+                   GetCommandName(item.cmd_type), item.cnt, item.attempt);
+        std::string err;
+        if (!SendRawData(item.frame.data(), item.frame.size(), &err)) {
+            correlator_.Cancel(item.cnt, item.cmd_type, err.empty() ? "serial write failed" : err);
+        }
     }
-    return written == data.size();
 }
 
 uint8_t MyFlyControl::NextCnt() {
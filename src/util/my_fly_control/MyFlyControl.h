@@ -3,6 +3,7 @@
 #include <atomic>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -12,8 +13,11 @@
 #include <nlohmann/json.hpp>
 
 #include "FlyControlCodec.h"
+#include "FlyControlCorrelator.h"
 #include "FlyControlFrame.h"
 #include "FlyControlProtocol.h"
+#include "FlyControlTelemetry.h"
+#include "MyProtocolTrace.h"
 #include "MySerial.h"
 
 // =============================================================================
@@ -25,7 +29,8 @@
 //   3. 提供各类飞行控制指令的发送接口
 //   4. 维护最新的飞控心跳状态，线程安全可读
 //   5. 支持注册回调：心跳更新、指令回复、云台控制
-//   6. 指令发送支持超时等待回复（2秒超时）
+//   6. 指令按 (CNT, 指令类型) 登记到待回复表，可多条同时在途，
+//      超时按配置重发，异步接口返回 future / 回调
 //
 // 使用示例：
 //   fly_control::MyFlyControl fc;
@@ -57,6 +62,9 @@ public:
     // 兼容两套字段：
     //   1. { "port": "/dev/ttyS1", "baudrate": 115200, "timeout_ms": 100 }
     //   2. { "device": "/dev/ttyS1", "baud_rate": 115200, "data_bits": 8, "stop_bits": 1, "flow_control": "none" }
+    // 可选字段：reply_timeout_ms（等待回复超时，默认 2000）、command_max_retries（超时重发次数，默认 0）、
+    //          log_level（模块日志级别，默认 info）、protocol_trace（二进制抓包环形文件）、
+    //          telemetry_record（心跳全速率落盘，见设计文档）
     bool Init(const nlohmann::json& cfg, std::string* err = nullptr);
 
     // 启动后台接收线程
@@ -150,15 +158,59 @@ public:
     // 发送识别目标状态
     bool SendTargetState(const TargetStateData& data, std::string* err = nullptr);
 
+    // -----------------------------------------------------------------------
+    // 异步发送（不等待回复，结果通过 future / 回调返回）
+    //
+    // max_retries < 0 时使用配置中的 command_max_retries。
+    // 发送失败、参数非法或模块未运行时返回的 future 立即就绪，success=false。
+    // -----------------------------------------------------------------------
+
+    // 发送定长指令（SetSpeedData、GuidanceNewData 等）
+    template <typename T>
+    std::future<CommandResult> SendCommandAsync(const T& data,
+                                                CommandResultCallback cb = nullptr,
+                                                int max_retries = -1) {
+        const uint8_t cnt = NextCnt();
+        const auto frame = EncodeFrameArray(cnt, data);
+        std::future<CommandResult> result;
+        SendTracked(cnt, data.cmd_type, frame.data(), frame.size(),
+                    max_retries, std::move(cb), &result, nullptr);
+        return result;
+    }
+
+    std::future<CommandResult> SendSetRouteAsync(const std::vector<RoutePoint>& points,
+                                                 CommandResultCallback cb = nullptr,
+                                                 int max_retries = -1);
+
+    std::future<CommandResult> SendSetGeofenceAsync(const std::vector<GeofencePoint>& points,
+                                                    CommandResultCallback cb = nullptr,
+                                                    int max_retries = -1);
+
+    // 按指令类型的发送/回复/超时统计与 RTT 直方图
+    nlohmann::json GetCommandStatsJson() const;
+
 private:
     // 后台接收线程主循环
     void ReceiveLoop();
 
     // 处理一个已解析的帧
-    void HandleFrame(const ParsedFrame& frame);
+    void HandleFrame(const FrameView& frame);
 
     // 通过串口发送字节数据
     bool SendRawData(const std::vector<uint8_t>& data, std::string* err);
+    bool SendRawData(const uint8_t* data, size_t len, std::string* err);
+
+    // 登记到待回复表后发送；发送失败时撤销登记。result 非空时返回该指令的 future
+    bool SendTracked(uint8_t cnt, uint8_t cmd_type, const uint8_t* frame, size_t len,
+                     int max_retries, CommandResultCallback cb,
+                     std::future<CommandResult>* result, std::string* err);
+
+    // 参数校验失败：不占用 CNT、不发送，回调后返回已就绪的失败结果
+    static std::future<CommandResult> RejectCommand(uint8_t cmd_type, const std::string& error,
+                                                    const CommandResultCallback& cb);
+
+    // 接收线程中调用：处理回复超时，重发仍有重试次数的指令
+    void ServicePendingCommands();
 
     // 获取下一个 CNT 值（自增计数器）
     uint8_t NextCnt();
@@ -179,6 +231,14 @@ private:
     std::mutex                    send_mutex_;     // 发送锁
     std::atomic<uint8_t>          cnt_{0};         // 帧计数器
 
+    CommandCorrelator             correlator_;     // 指令待回复表
+    CommandRetryPolicy            retry_policy_;   // 默认超时与重试策略
+    std::vector<CommandResend>    resend_buf_;     // 重发缓冲（仅接收线程使用）
+
+    MyLog::ProtocolTrace          trace_;          // 协议抓包（原始收发字节）
+    TelemetryRecorder             recorder_;       // 心跳遥测记录
+    bool                          record_telemetry_{false};
+
     // 回调函数
     HeartbeatCallback             on_heartbeat_;
     CommandReplyCallback          on_reply_;
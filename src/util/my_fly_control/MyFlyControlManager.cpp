@@ -132,6 +132,11 @@ bool MyFlyControlManager::HasHeartbeat() const {
     return controller && controller->HasHeartbeat();
 }
 
+nlohmann::json MyFlyControlManager::GetCommandStatsJson() const {
+    auto controller = GetControllerSnapshot();
+    return controller ? controller->GetCommandStatsJson() : nlohmann::json::object();
+}
+
 bool MyFlyControlManager::SendSetDestination(int32_t lon, int32_t lat, uint16_t alt,
                                              std::string* err) {
     auto controller = GetInitializedController(err);
@@ -216,6 +221,28 @@ bool MyFlyControlManager::SendTargetState(const TargetStateData& data, std::stri
     return controller ? controller->SendTargetState(data, err) : false;
 }
 
+std::future<CommandResult> MyFlyControlManager::SendSetRouteAsync(const std::vector<RoutePoint>& points,
+                                                                  CommandResultCallback cb,
+                                                                  int max_retries) {
+    std::string err;
+    auto controller = GetInitializedController(&err);
+    if (!controller) {
+        return MakeFailedResult(CMD_SET_ROUTE, err, cb);
+    }
+    return controller->SendSetRouteAsync(points, std::move(cb), max_retries);
+}
+
+std::future<CommandResult> MyFlyControlManager::SendSetGeofenceAsync(const std::vector<GeofencePoint>& points,
+                                                                     CommandResultCallback cb,
+                                                                     int max_retries) {
+    std::string err;
+    auto controller = GetInitializedController(&err);
+    if (!controller) {
+        return MakeFailedResult(CMD_SET_GEOFENCE, err, cb);
+    }
+    return controller->SendSetGeofenceAsync(points, std::move(cb), max_retries);
+}
+
 std::shared_ptr<MyFlyControl> MyFlyControlManager::GetControllerSnapshot() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return controller_;
@@ -232,4 +259,18 @@ std::shared_ptr<MyFlyControl> MyFlyControlManager::GetInitializedController(std:
     return controller_;
 }
 
+std::future<CommandResult> MyFlyControlManager::MakeFailedResult(uint8_t cmd_type,
+                                                                 const std::string& err,
+                                                                 const CommandResultCallback& cb) {
+    CommandResult result;
+    result.cmd_type = cmd_type;
+    result.error    = err;
+    if (cb) {
+        cb(result);
+    }
+    std::promise<CommandResult> promise;
+    promise.set_value(std::move(result));
+    return promise.get_future();
+}
+
 } // namespace fly_control
\ No newline at end of file
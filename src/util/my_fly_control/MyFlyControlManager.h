@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -72,6 +73,9 @@ public:
     FaultBits GetFaultBits() const;
     bool HasHeartbeat() const;
 
+    // 按指令类型的发送/回复/超时统计与 RTT 直方图
+    nlohmann::json GetCommandStatsJson() const;
+
     // -----------------------------------------------------------------------
     // 指令发送（对 MyFlyControl 的统一转发）
     // -----------------------------------------------------------------------
@@ -94,6 +98,29 @@ public:
     bool SendGimbalAngle(const GimbalAngleData& data, std::string* err = nullptr);
     bool SendTargetState(const TargetStateData& data, std::string* err = nullptr);
 
+    // -----------------------------------------------------------------------
+    // 异步指令发送（未初始化时返回立即就绪的失败结果）
+    // -----------------------------------------------------------------------
+
+    template <typename T>
+    std::future<CommandResult> SendCommandAsync(const T& data,
+                                                CommandResultCallback cb = nullptr,
+                                                int max_retries = -1) {
+        std::string err;
+        auto controller = GetInitializedController(&err);
+        if (!controller) {
+            return MakeFailedResult(data.cmd_type, err, cb);
+        }
+        return controller->SendCommandAsync(data, std::move(cb), max_retries);
+    }
+
+    std::future<CommandResult> SendSetRouteAsync(const std::vector<RoutePoint>& points,
+                                                 CommandResultCallback cb = nullptr,
+                                                 int max_retries = -1);
+    std::future<CommandResult> SendSetGeofenceAsync(const std::vector<GeofencePoint>& points,
+                                                    CommandResultCallback cb = nullptr,
+                                                    int max_retries = -1);
+
 private:
     MyFlyControlManager();
     ~MyFlyControlManager();
@@ -104,6 +131,10 @@ private:
     // 获取已经完成初始化的底层飞控对象；若尚未初始化则返回空指针并填充错误信息
     std::shared_ptr<MyFlyControl> GetInitializedController(std::string* err) const;
 
+    // 构造一个立即就绪的失败结果
+    static std::future<CommandResult> MakeFailedResult(uint8_t cmd_type, const std::string& err,
+                                                       const CommandResultCallback& cb);
+
 private:
     mutable std::mutex            mutex_;
     std::shared_ptr<MyFlyControl> controller_;
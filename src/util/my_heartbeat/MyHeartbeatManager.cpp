@@ -4,6 +4,7 @@
 #include <mutex>
 #include <chrono>
 #include <random>
+#include <algorithm>
 
 #include "MyLog.h"
 #include "MyEdgeManager.h"
@@ -60,6 +61,7 @@ void HeartbeatManager::Init(const nlohmann::json& config) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     config_ = config;
+    config_generation_.fetch_add(1);
     MYLOG_INFO("初始化 HeartbeatManager 配置（业务配置）: {}", config_.dump(4));
 
     // interval / log format
@@ -90,41 +92,43 @@ void HeartbeatManager::Start() {
         return;
     }
 
-    MYLOG_INFO("Starting HeartbeatManager worker thread...");
-    worker_ = std::thread(&HeartbeatManager::WorkerLoop, this);
+    // initial jitter，避免多实例同时上报
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<int> jitter_ms(0, 3000);
+    const int period_ms = std::max(1, interval_sec_) * 1000;
+
+    timer_id_ = my_executor::MyExecutor::GetInstance().ScheduleEvery(
+        "heartbeat", period_ms, [this]() { HeartbeatTick(); }, jitter_ms(gen));
+    if (timer_id_ == 0) {
+        running_.store(false);
+        MYLOG_ERROR("HeartbeatManager 启动失败：无法注册心跳定时器");
+        return;
+    }
+    MYLOG_INFO("HeartbeatManager started: period_ms={}, timer_id={}", period_ms, timer_id_);
 }
 
 void HeartbeatManager::Stop() {
     if (!running_.exchange(false)) {
         return;
     }
-    if (worker_.joinable()) {
-        worker_.join();
-    }
+    my_executor::MyExecutor::GetInstance().CancelTimer(timer_id_, true);
+    timer_id_ = 0;
     MYLOG_INFO("HeartbeatManager stopped");
 }
 
-void HeartbeatManager::WorkerLoop() {
-    // initial jitter
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> jitter_ms(0, 3000);
-    std::this_thread::sleep_for(std::chrono::milliseconds(jitter_ms(gen)));
-
-    while (running_.load()) {
-        try {
-            BuildHeartbeat();
-            SendHeartbeat(); // log
-            SendOnceByMQTT();      // mqtt publish (if publisher injected)
-        } catch (const std::exception& e) {
-            MYLOG_ERROR("Heartbeat error: {}", e.what());
-        } catch (...) {
-            MYLOG_ERROR("Heartbeat unknown error");
-        }
-
-        for (int i = 0; i < interval_sec_ && running_.load(); ++i) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
+void HeartbeatManager::HeartbeatTick() {
+    if (!running_.load()) {
+        return;
+    }
+    try {
+        BuildHeartbeat();
+        SendHeartbeat(); // log
+        SendOnceByMQTT();      // mqtt publish (if publisher injected)
+    } catch (const std::exception& e) {
+        MYLOG_ERROR("Heartbeat error: {}", e.what());
+    } catch (...) {
+        MYLOG_ERROR("Heartbeat unknown error");
     }
 }
 
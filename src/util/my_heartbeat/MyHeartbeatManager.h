@@ -1,6 +1,6 @@
 #pragma once
 #include <atomic>
-#include <thread>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 #include <mutex>
 #include <vector>
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "IMqttPublisher.hpp"
+#include "MyExecutor.h"
 
 namespace my_heartbeat {
 
@@ -43,16 +44,21 @@ public:
      */
     nlohmann::json GetHeartbeatSnapshot();
     nlohmann::json GetInitConfig();
+
+    /**
+     * @brief 心跳配置的代号，每次 Init 时递增（API 层据此判断配置是否变化）
+     */
+    uint64_t GetConfigGeneration() const { return config_generation_.load(); }
     
 private:
     HeartbeatManager();
     ~HeartbeatManager() { Stop(); }
 
     /**
-     * @brief 心跳工作线程主循环
+     * @brief 心跳周期回调（共享执行器 "heartbeat" 子系统上的定时器）
      * 
      */
-    void WorkerLoop();
+    void HeartbeatTick();
 
     /**
      * @brief 构建心跳数据
@@ -77,8 +83,8 @@ private:
     static std::string formatTopic(const std::string& fmt, const std::string& source);
 
 private:
-    std::atomic<bool> running_{false};                            // 线程运行状态
-    std::thread worker_;                                            // 心跳工作线程
+    std::atomic<bool> running_{false};                            // 运行状态
+    my_executor::TimerId timer_id_{0};                              // 心跳定时器
     std::shared_ptr<my_mqtt::IMqttPublisher> publisher_{nullptr};            // MQTT 发布器
     std::string topic_fmt_{"system/heartbeats"};                    // 主题格式
     int qos_{1};                                                    // MQTT QoS 等级
@@ -86,6 +92,7 @@ private:
     uint64_t seq_{0};                                               // 心跳序列号
     std::mutex mutex_;                                              // 保护 heartbeat_data_ / config_ / publisher_ 等
     nlohmann::json config_;                                         // 心跳配置（业务配置）
+    std::atomic<uint64_t> config_generation_{1};                    // 心跳配置代号
     nlohmann::json heartbeat_data_;                                 // 心跳数据
     int interval_sec_{5};                                           // 心跳间隔秒数
     bool simple_json4log{false};                                    // 日志简化输出
@@ -9,6 +9,8 @@
 #include <stdexcept>
 #include <sys/stat.h>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <vector>
 #include "spdlog/sinks/stdout_color_sinks.h"
 
@@ -18,6 +20,21 @@ static std::shared_ptr<spdlog::logger> logger;
 
 namespace {
 
+std::mutex& ModuleMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// 模块对象只增不删，保证 GetModule 返回的引用长期有效
+std::map<std::string, std::unique_ptr<LogModule>>& ModuleRegistry() {
+    static std::map<std::string, std::unique_ptr<LogModule>> modules;
+    return modules;
+}
+
+}  // namespace
+
+namespace {
+
 std::string NormalizePath(std::string path) {
     std::replace(path.begin(), path.end(), '\\', '/');
     return path;
@@ -265,13 +282,39 @@ void Init(const std::string& log_file, size_t max_file_size, size_t max_files, b
     // 设置全局格式
     spdlog::set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [%s:%# %!] %v");
     spdlog::set_level(spdlog::level::debug);
-    spdlog::flush_on(spdlog::level::info);
+    // 逐条 flush 会让高频 info 日志拖慢调用线程，改为 warn 以上立即落盘，其余每秒刷一次
+    spdlog::flush_on(spdlog::level::warn);
+    spdlog::flush_every(std::chrono::seconds(1));
 
     for(const std::string& logItem : logInfos) {
         MYLOG_INFO("{}", logItem);
     }
 }
 
+LogModule& GetModule(const std::string& name) {
+    std::lock_guard<std::mutex> lock(ModuleMutex());
+    auto& modules = ModuleRegistry();
+    auto it = modules.find(name);
+    if (it == modules.end()) {
+        it = modules.emplace(name, std::make_unique<LogModule>(name)).first;
+    }
+    return *it->second;
+}
+
+void SetModuleLevel(const std::string& name, spdlog::level::level_enum level) {
+    GetModule(name).level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+bool SetModuleLevel(const std::string& name, const std::string& level_name) {
+    const spdlog::level::level_enum level = spdlog::level::from_str(level_name);
+    // from_str 对无法识别的名字返回 off，这里只接受显式写 off 的情况
+    if (level == spdlog::level::off && level_name != "off") {
+        return false;
+    }
+    SetModuleLevel(name, level);
+    return true;
+}
+
 void Info(const std::string& msg) {
     spdlog::info(msg);
 }
@@ -4,6 +4,7 @@
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/async.h>
 #include <spdlog/async_logger.h>
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -29,17 +30,79 @@ void Flush();
  */
 void ArchiveOldLogs(const std::string& log_dir, const std::string& archive_dir = "archive");
 
-// 推荐使用的宏（可输出文件、行号、函数名）
-#define MYLOG_INFO(...) \
-    spdlog::log(spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__}, spdlog::level::info, __VA_ARGS__)
+// -----------------------------------------------------------------------------
+// 模块级日志开关
+//
+// 每个模块持有一个 LogModule，运行期可单独调整输出级别，例如：
+//   static MyLog::LogModule& kLog = MyLog::GetModule("fly_control");
+//   MYLOG_MODULE_DEBUG(kLog, "hex={}", BytesToHexString(buf, n));
+// 级别未达到时整条语句被跳过，参数（如十六进制字符串）不会被求值。
+// -----------------------------------------------------------------------------
+struct LogModule {
+    explicit LogModule(std::string module_name) : name(std::move(module_name)) {}
 
-#define MYLOG_DEBUG(...) \
-    spdlog::log(spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__}, spdlog::level::debug, __VA_ARGS__)
+    const std::string name;
+    std::atomic<int>  level{SPDLOG_LEVEL_TRACE};  // 模块最低输出级别，默认不额外限制
+};
 
-#define MYLOG_WARN(...) \
-    spdlog::log(spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__}, spdlog::level::warn, __VA_ARGS__)
+// 获取（不存在则创建）指定名称的模块，返回的引用在进程内长期有效
+LogModule& GetModule(const std::string& name);
 
-#define MYLOG_ERROR(...) \
-    spdlog::log(spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__}, spdlog::level::err, __VA_ARGS__)
+// 设置模块输出级别；level_name 取 trace/debug/info/warn/error/critical/off
+void SetModuleLevel(const std::string& name, spdlog::level::level_enum level);
+bool SetModuleLevel(const std::string& name, const std::string& level_name);
+
+// 是否需要输出：同时满足模块级别和全局 logger 级别
+inline bool ShouldLog(const LogModule& module, spdlog::level::level_enum level) {
+    return static_cast<int>(level) >= module.level.load(std::memory_order_relaxed) &&
+           spdlog::should_log(level);
+}
 
 }  // namespace MyLog
+
+// -----------------------------------------------------------------------------
+// 编译期级别裁剪：-DMYLOG_ACTIVE_LEVEL=SPDLOG_LEVEL_INFO 可把 TRACE/DEBUG 宏整体编译掉
+// -----------------------------------------------------------------------------
+#ifndef MYLOG_ACTIVE_LEVEL
+#define MYLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+#define MYLOG_LOG_(level, ...)                                                               \
+    do {                                                                                     \
+        if (spdlog::should_log(level)) {                                                     \
+            spdlog::log(spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__}, level, __VA_ARGS__); \
+        }                                                                                    \
+    } while (0)
+
+#define MYLOG_MODULE_LOG_(module, level, ...)                                                \
+    do {                                                                                     \
+        if (MyLog::ShouldLog(module, level)) {                                               \
+            spdlog::log(spdlog::source_loc{__FILE__, __LINE__, __FUNCTION__}, level, __VA_ARGS__); \
+        }                                                                                    \
+    } while (0)
+
+// 推荐使用的宏（可输出文件、行号、函数名；级别未开启时不求值参数）
+#if MYLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define MYLOG_TRACE(...)               MYLOG_LOG_(spdlog::level::trace, __VA_ARGS__)
+#define MYLOG_MODULE_TRACE(module, ...) MYLOG_MODULE_LOG_(module, spdlog::level::trace, __VA_ARGS__)
+#else
+#define MYLOG_TRACE(...)               (void)0
+#define MYLOG_MODULE_TRACE(module, ...) (void)0
+#endif
+
+#if MYLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define MYLOG_DEBUG(...)               MYLOG_LOG_(spdlog::level::debug, __VA_ARGS__)
+#define MYLOG_MODULE_DEBUG(module, ...) MYLOG_MODULE_LOG_(module, spdlog::level::debug, __VA_ARGS__)
+#else
+#define MYLOG_DEBUG(...)               (void)0
+#define MYLOG_MODULE_DEBUG(module, ...) (void)0
+#endif
+
+#define MYLOG_INFO(...)                MYLOG_LOG_(spdlog::level::info, __VA_ARGS__)
+#define MYLOG_WARN(...)                MYLOG_LOG_(spdlog::level::warn, __VA_ARGS__)
+#define MYLOG_ERROR(...)               MYLOG_LOG_(spdlog::level::err, __VA_ARGS__)
+
+#define MYLOG_MODULE_INFO(module, ...)  MYLOG_MODULE_LOG_(module, spdlog::level::info, __VA_ARGS__)
+#define MYLOG_MODULE_WARN(module, ...)  MYLOG_MODULE_LOG_(module, spdlog::level::warn, __VA_ARGS__)
+#define MYLOG_MODULE_ERROR(module, ...) MYLOG_MODULE_LOG_(module, spdlog::level::err, __VA_ARGS__)
+
@@ -0,0 +1,346 @@
+#include "MyProtocolTrace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MyLog {
+
+namespace {
+
+constexpr char     kFileMagic[8]  = {'P', 'T', 'R', 'A', 'C', 'E', '0', '1'};
+constexpr uint32_t kFileVersion   = 1;
+constexpr uint32_t kRecordMagic   = 0x43525450;  // "PTRC"
+constexpr uint32_t kWrapMarker    = 0xFFFFFFFF;
+constexpr size_t   kAlign         = 8;
+
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t capacity;
+    uint64_t write_pos;
+    uint64_t oldest_pos;
+    uint64_t wrapped;
+    uint64_t next_seq;
+    uint64_t reserved;
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader must be 64 bytes");
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t len;          // 保存的载荷长度；kWrapMarker 表示回绕标记
+    uint64_t seq;
+    uint64_t timestamp_ns;
+    uint8_t  channel;
+    uint8_t  direction;
+    uint16_t reserved;
+    uint32_t orig_len;
+};
+static_assert(sizeof(RecordHeader) == 32, "RecordHeader must be 32 bytes");
+
+size_t AlignUp(size_t n) {
+    return (n + kAlign - 1) & ~(kAlign - 1);
+}
+
+void SetError(std::string* err, const std::string& msg) {
+    if (err) {
+        *err = msg;
+    }
+}
+
+}  // namespace
+
+ProtocolTrace::~ProtocolTrace() {
+    Close();
+}
+
+// =============================================================================
+// 打开 / 关闭
+// =============================================================================
+
+bool ProtocolTrace::Open(const Options& options, std::string* err) {
+    Close();
+
+    if (options.file_path.empty()) {
+        SetError(err, "[ProtocolTrace] file_path 为空");
+        return false;
+    }
+
+    const size_t capacity = AlignUp(std::max<size_t>(options.ring_bytes, 4096));
+    const size_t map_size = sizeof(FileHeader) + capacity;
+
+    const int fd = ::open(options.file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        SetError(err, "[ProtocolTrace] 打开文件失败: " + options.file_path + ", error=" + std::strerror(errno));
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(map_size)) != 0) {
+        SetError(err, std::string("[ProtocolTrace] 设置文件大小失败: ") + std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    void* map = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        SetError(err, std::string("[ProtocolTrace] mmap 失败: ") + std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_    = options;
+    fd_         = fd;
+    map_        = static_cast<uint8_t*>(map);
+    map_size_   = map_size;
+    ring_       = map_ + sizeof(FileHeader);
+    capacity_   = capacity;
+    write_pos_  = 0;
+    oldest_pos_ = 0;
+    wrapped_    = false;
+    next_seq_   = 0;
+    window_start_ = std::chrono::steady_clock::now();
+    window_count_ = 0;
+    stats_      = Stats{};
+
+    FileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version     = kFileVersion;
+    header.header_size = sizeof(FileHeader);
+    header.capacity    = capacity_;
+    std::memcpy(map_, &header, sizeof(header));
+
+    sample_every_.store(std::max<uint32_t>(options.sample_every, 1), std::memory_order_relaxed);
+    sample_counter_.store(0, std::memory_order_relaxed);
+    sampled_out_.store(0, std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_release);
+    return true;
+}
+
+void ProtocolTrace::Close() {
+    enabled_.store(false, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (map_ != nullptr) {
+        SyncHeaderLocked();
+        ::munmap(map_, map_size_);
+        map_  = nullptr;
+        ring_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+// =============================================================================
+// 写入
+// =============================================================================
+
+void ProtocolTrace::Record(uint8_t channel, uint8_t direction, const uint8_t* data, size_t len) {
+    if (!enabled_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const uint32_t sample_every = sample_every_.load(std::memory_order_relaxed);
+    if (sample_every > 1 &&
+        sample_counter_.fetch_add(1, std::memory_order_relaxed) % sample_every != 0) {
+        sampled_out_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const auto wall_now = std::chrono::system_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ring_ == nullptr || !AdmitLocked(std::chrono::steady_clock::now())) {
+        return;
+    }
+
+    // 单条记录最多占记录区的一半，超出部分截断
+    const size_t max_payload = capacity_ / 2 - sizeof(RecordHeader);
+    const size_t saved_len   = std::min(len, max_payload);
+    if (saved_len < len) {
+        ++stats_.truncated;
+    }
+    const size_t record_size = AlignUp(sizeof(RecordHeader) + saved_len);
+
+    if (write_pos_ + record_size > capacity_) {
+        // 尾部放不下：写回绕标记，尾部旧记录随之作废
+        if (write_pos_ + sizeof(RecordHeader) <= capacity_) {
+            RecordHeader marker{};
+            marker.magic = kRecordMagic;
+            marker.len   = kWrapMarker;
+            std::memcpy(ring_ + write_pos_, &marker, sizeof(marker));
+        }
+        write_pos_  = 0;
+        oldest_pos_ = 0;
+        wrapped_    = true;
+        ++stats_.wraps;
+    }
+
+    AdvanceOldestLocked(write_pos_, write_pos_ + record_size);
+
+    RecordHeader header{};
+    header.magic        = kRecordMagic;
+    header.len          = static_cast<uint32_t>(saved_len);
+    header.seq          = next_seq_++;
+    header.timestamp_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(wall_now.time_since_epoch()).count());
+    header.channel      = channel;
+    header.direction    = direction;
+    header.orig_len     = static_cast<uint32_t>(std::min<size_t>(len, UINT32_MAX));
+    std::memcpy(ring_ + write_pos_, &header, sizeof(header));
+    if (saved_len > 0) {
+        std::memcpy(ring_ + write_pos_ + sizeof(header), data, saved_len);
+    }
+
+    write_pos_ += record_size;
+    ++stats_.records;
+    stats_.bytes += saved_len;
+    SyncHeaderLocked();
+}
+
+bool ProtocolTrace::AdmitLocked(std::chrono::steady_clock::time_point now) {
+    if (options_.max_records_per_sec == 0) {
+        return true;
+    }
+    if (now - window_start_ >= std::chrono::seconds(1)) {
+        window_start_ = now;
+        window_count_ = 0;
+    }
+    if (window_count_ >= options_.max_records_per_sec) {
+        ++stats_.rate_limited;
+        return false;
+    }
+    ++window_count_;
+    return true;
+}
+
+void ProtocolTrace::AdvanceOldestLocked(size_t begin, size_t end) {
+    if (!wrapped_) {
+        return;
+    }
+    // 新记录覆盖的区间内若有旧记录起点，把最旧位置推到被覆盖记录之后
+    while (oldest_pos_ >= begin && oldest_pos_ < end) {
+        if (oldest_pos_ + sizeof(RecordHeader) > capacity_) {
+            oldest_pos_ = 0;
+            break;
+        }
+        RecordHeader old{};
+        std::memcpy(&old, ring_ + oldest_pos_, sizeof(old));
+        if (old.magic != kRecordMagic || old.len == kWrapMarker) {
+            oldest_pos_ = 0;
+            break;
+        }
+        oldest_pos_ += AlignUp(sizeof(RecordHeader) + old.len);
+    }
+}
+
+void ProtocolTrace::SyncHeaderLocked() {
+    if (map_ == nullptr) {
+        return;
+    }
+    auto* header       = reinterpret_cast<FileHeader*>(map_);
+    header->write_pos  = write_pos_;
+    header->oldest_pos = oldest_pos_;
+    header->wrapped    = wrapped_ ? 1 : 0;
+    header->next_seq   = next_seq_;
+}
+
+ProtocolTrace::Stats ProtocolTrace::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.sampled_out = sampled_out_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// =============================================================================
+// 读取
+// =============================================================================
+
+bool ProtocolTrace::ReadAll(const std::string& file_path,
+                            const std::function<bool(const RecordView&)>& on_record,
+                            std::string* err) {
+    const int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        SetError(err, "[ProtocolTrace] 打开文件失败: " + file_path + ", error=" + std::strerror(errno));
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        SetError(err, "[ProtocolTrace] 文件过小或无法读取: " + file_path);
+        ::close(fd);
+        return false;
+    }
+    const size_t file_size = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        SetError(err, std::string("[ProtocolTrace] mmap 失败: ") + std::strerror(errno));
+        return false;
+    }
+
+    const auto* base = static_cast<const uint8_t*>(map);
+    FileHeader header{};
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 ||
+        header.header_size != sizeof(FileHeader) ||
+        header.header_size + header.capacity > file_size ||
+        header.write_pos > header.capacity || header.oldest_pos > header.capacity) {
+        SetError(err, "[ProtocolTrace] 文件头无效: " + file_path);
+        ::munmap(map, file_size);
+        return false;
+    }
+
+    const uint8_t* ring = base + header.header_size;
+    const size_t capacity = header.capacity;
+    size_t pos = header.wrapped ? header.oldest_pos : 0;
+    bool first = header.wrapped != 0 && header.next_seq > 0;
+    bool ok = true;
+
+    // 从最旧记录开始沿链读到写指针为止
+    while (first || pos != header.write_pos) {
+        first = false;
+        if (pos + sizeof(RecordHeader) > capacity) {
+            pos = 0;
+            continue;
+        }
+        RecordHeader rec{};
+        std::memcpy(&rec, ring + pos, sizeof(rec));
+        if (rec.magic != kRecordMagic) {
+            SetError(err, "[ProtocolTrace] 记录损坏, offset=" + std::to_string(pos));
+            ok = false;
+            break;
+        }
+        if (rec.len == kWrapMarker) {
+            pos = 0;
+            continue;
+        }
+        if (pos + sizeof(RecordHeader) + rec.len > capacity) {
+            SetError(err, "[ProtocolTrace] 记录长度越界, offset=" + std::to_string(pos));
+            ok = false;
+            break;
+        }
+
+        RecordView view;
+        view.seq          = rec.seq;
+        view.timestamp_ns = rec.timestamp_ns;
+        view.channel      = rec.channel;
+        view.direction    = rec.direction;
+        view.orig_len     = rec.orig_len;
+        view.data         = ring + pos + sizeof(RecordHeader);
+        view.len          = rec.len;
+        if (!on_record(view)) {
+            break;
+        }
+        pos += AlignUp(sizeof(RecordHeader) + rec.len);
+    }
+
+    ::munmap(map, file_size);
+    return ok;
+}
+
+}  // namespace MyLog
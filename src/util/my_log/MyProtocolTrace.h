@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// =============================================================================
+// ProtocolTrace — 协议抓包通道
+//
+// 把收发的原始帧以二进制形式写入一个定长环形文件，替代在日志里打印十六进制字符串：
+//   1. 文件一次性 ftruncate 到固定大小并 mmap，写入只有一次 memcpy，不走 write 系统调用
+//   2. 写满后回到开头覆盖最旧记录，文件头记录写指针和最旧记录位置，可离线按时间顺序读出
+//   3. 支持按 1/N 采样与每秒记录数上限，避免高频帧把抓包打满
+//
+// 文件布局：
+//   [FileHeader 64B][记录区 capacity 字节]
+//   记录 = [RecordHeader 32B][载荷]，按 8 字节对齐；
+//   记录区尾部放不下下一条时写入一个 length=kWrapMarker 的记录头（若放得下），然后回到开头。
+//
+// 使用示例：
+//   MyLog::ProtocolTrace trace;
+//   MyLog::ProtocolTrace::Options opt;
+//   opt.file_path = "logs/fly_control_trace.bin";
+//   trace.Open(opt, &err);
+//   trace.Record(0, MyLog::ProtocolTrace::kDirRx, buf, n);
+// =============================================================================
+
+namespace MyLog {
+
+class ProtocolTrace {
+public:
+    static constexpr uint8_t kDirRx = 0;  // 接收方向
+    static constexpr uint8_t kDirTx = 1;  // 发送方向
+
+    struct Options {
+        std::string file_path;
+        size_t      ring_bytes          = 4 * 1024 * 1024;  // 记录区大小
+        uint32_t    sample_every        = 1;                 // 每 N 条记录 1 条，1 表示全部记录
+        uint32_t    max_records_per_sec = 0;                 // 每秒最多记录条数，0 表示不限
+    };
+
+    // 读出的一条记录
+    struct RecordView {
+        uint64_t       seq          = 0;
+        uint64_t       timestamp_ns = 0;   // system_clock 纳秒
+        uint8_t        channel      = 0;
+        uint8_t        direction    = 0;
+        uint32_t       orig_len     = 0;   // 原始长度（可能大于实际保存的 len）
+        const uint8_t* data         = nullptr;
+        size_t         len          = 0;
+    };
+
+    struct Stats {
+        uint64_t records      = 0;   // 已写入记录数
+        uint64_t bytes        = 0;   // 已写入载荷字节数
+        uint64_t sampled_out  = 0;   // 因采样跳过
+        uint64_t rate_limited = 0;   // 因速率上限丢弃
+        uint64_t truncated    = 0;   // 载荷过长被截断
+        uint64_t wraps        = 0;   // 环形回绕次数
+    };
+
+    ProtocolTrace() = default;
+    ~ProtocolTrace();
+
+    ProtocolTrace(const ProtocolTrace&) = delete;
+    ProtocolTrace& operator=(const ProtocolTrace&) = delete;
+
+    // 创建/覆盖环形文件并开始记录
+    bool Open(const Options& options, std::string* err = nullptr);
+
+    // 停止记录并解除映射
+    void Close();
+
+    bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // 记录一帧；未开启、被采样跳过或超过速率上限时直接返回
+    void Record(uint8_t channel, uint8_t direction, const uint8_t* data, size_t len);
+
+    Stats GetStats() const;
+
+    // 按时间顺序遍历环形文件中的记录（离线分析用），回调返回 false 时提前结束
+    static bool ReadAll(const std::string& file_path,
+                        const std::function<bool(const RecordView&)>& on_record,
+                        std::string* err = nullptr);
+
+private:
+    bool AdmitLocked(std::chrono::steady_clock::time_point now);
+    void AdvanceOldestLocked(size_t begin, size_t end);
+    void SyncHeaderLocked();
+
+    std::atomic<bool>     enabled_{false};
+    std::atomic<uint32_t> sample_every_{1};
+    std::atomic<uint64_t> sample_counter_{0};
+    std::atomic<uint64_t> sampled_out_{0};
+
+    mutable std::mutex    mutex_;
+    Options               options_;
+    int                   fd_         = -1;
+    uint8_t*              map_        = nullptr;
+    size_t                map_size_   = 0;
+    uint8_t*              ring_       = nullptr;   // 记录区起点
+    size_t                capacity_   = 0;
+    size_t                write_pos_  = 0;
+    size_t                oldest_pos_ = 0;
+    bool                  wrapped_    = false;
+    uint64_t              next_seq_   = 0;
+
+    std::chrono::steady_clock::time_point window_start_{};
+    uint32_t              window_count_ = 0;
+
+    Stats                 stats_;
+};
+
+}  // namespace MyLog
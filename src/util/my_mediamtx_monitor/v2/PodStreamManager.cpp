@@ -3,7 +3,7 @@
  * @brief 吊舱视频拉流守护模块 - 核心实现
  * 
  * 实现 PodStreamManager 的所有核心功能，包括:
- * - 双线程架构 (Monitor + Worker)
+ * - Monitor 定时器 (共享执行器) + Worker 线程
  * - 状态机管理
  * - 子进程生命周期管理 (fork/exec)
  * - 网络连通性探测 (ICMP ping)
@@ -202,15 +202,34 @@ void PodStreamManager::Start() {
         return;
     }
 
-    if (monitor_th_.joinable() || worker_th_.joinable()) {
+    if (monitor_timer_ != 0 || worker_th_.joinable()) {
         MYLOG_WARN("管理器线程已启动，忽略重复 Start()");
         return;
     }
 
     quit_.store(false);
 
-    monitor_th_ = std::thread(&PodStreamManager::MonitorLoop, this);
-    MYLOG_INFO("监控线程已启动");
+    connect_success_count_.store(0);
+    connect_fail_count_.store(0);
+    last_probe_result_ = false;
+    last_probe_count_ = 0;
+    MYLOG_INFO("监控启动 - 正在监控 {}", config_.pod_ip);
+
+    // 探测与去抖交给进程内探测服务，MonitorTick 只同步状态
+    my_tools::ProbeTargetOptions probe_opts;
+    probe_opts.ip = config_.pod_ip;
+    probe_opts.name = "pod_stream";
+    probe_opts.interval_ms = std::max(1, config_.monitor_period_ms);
+    probe_opts.timeout_ms = 1000;
+    probe_opts.up_threshold = config_.connect_debounce_count;
+    probe_opts.down_threshold = config_.disconnect_debounce_count;
+    probe_handle_ = my_tools::ReachabilityProber::GetInstance().Watch(probe_opts);
+    if (probe_handle_ == 0) {
+        MYLOG_WARN("注册吊舱 IP 探测失败，退回单次探测: {}", config_.pod_ip);
+    }
+    monitor_timer_ = my_executor::MyExecutor::GetInstance().ScheduleEvery(
+        "pod_stream", std::max(1, config_.monitor_period_ms), [this]() { MonitorTick(); }, 0);
+    MYLOG_INFO("监控定时器已注册: timer_id={}", monitor_timer_);
 
     worker_th_ = std::thread(&PodStreamManager::WorkerLoop, this);
     MYLOG_INFO("工作线程已启动");
@@ -232,12 +251,19 @@ void PodStreamManager::Stop() {
     // 设置退出标志
     quit_.store(true);
     
-    // 等待线程结束
-    if (monitor_th_.joinable()) {
-        monitor_th_.join();
-        tempLog = std::string("监控线程已停止");
+    // 取消监控定时器并等待进行中的探测结束
+    if (monitor_timer_ != 0) {
+        my_executor::MyExecutor::GetInstance().CancelTimer(monitor_timer_, true);
+        monitor_timer_ = 0;
+        tempLog = std::string("监控已停止");
         MYLOG_INFO(tempLog.c_str());
     }
+    if (probe_handle_ != 0) {
+        my_tools::ReachabilityProber::GetInstance().Unwatch(probe_handle_);
+        probe_handle_ = 0;
+    }
+    
+    // 等待线程结束
     
     if (worker_th_.joinable()) {
         worker_th_.join();
@@ -365,77 +391,88 @@ void PodStreamManager::ResetBackoff() {
 }
 
 // ============================================================================
-// Monitor Thread - 连通性监控
+// Monitor - 连通性监控
 // ============================================================================
 
-void PodStreamManager::MonitorLoop() {
+void PodStreamManager::MonitorTick() {
+    if (quit_.load()) {
+        return;
+    }
     std::string tempLog = "";
-    tempLog = std::string("监控线程启动 - 正在监控 " + config_.pod_ip);
-    MYLOG_INFO(tempLog.c_str());
-    int local_success_count = 0;
-    int local_fail_count = 0;
-    bool last_probe_result = false;
-    
-    while (!quit_.load()) {
-        // 探测连通性
-        bool probe_ok = ProbeConnectivityOnce();
-        
-        if (probe_ok) {
-            local_fail_count = 0;
-            ++local_success_count;
-            
-            // 去抖: 连续成功 N 次才认为 connected
-            if (!is_connected_.load() && 
-                local_success_count >= config_.connect_debounce_count) {
-                is_connected_.store(true);
-                tempLog = std::string("网络已连通 " + config_.pod_ip + 
-                      " (经过 " + std::to_string(local_success_count) + " 次探测)");
-                MYLOG_INFO(tempLog.c_str());
-            }
-        } else {
-            local_success_count = 0;
-            ++local_fail_count;
-            
-            // 去抖: 连续失败 N 次才认为 disconnected
-            if (is_connected_.load() && 
-                local_fail_count >= config_.disconnect_debounce_count) {
-                is_connected_.store(false);
-                tempLog = std::string("网络已断开 " + config_.pod_ip + 
-                      " (连续 " + std::to_string(local_fail_count) + " 次失败)");
-                MYLOG_INFO(tempLog.c_str());
+
+    if (probe_handle_ != 0) {
+        my_tools::ReachabilityStats stats;
+        if (!my_tools::ReachabilityProber::GetInstance().GetStats(probe_handle_, stats) ||
+            stats.probes == last_probe_count_) {
+            return;  // 尚无新的探测结果
+        }
+        last_probe_count_ = stats.probes;
+        connect_success_count_.store(stats.consecutive_ok);
+        connect_fail_count_.store(stats.consecutive_fail);
+
+        if (stats.reachable != is_connected_.load()) {
+            is_connected_.store(stats.reachable);
+            if (stats.reachable) {
+                MYLOG_INFO("网络已连通 {} (经过 {} 次探测, rtt={:.2f}ms)", config_.pod_ip, stats.consecutive_ok, stats.rtt_last_ms);
+            } else {
+                MYLOG_INFO("网络已断开 {} (连续 {} 次失败, 窗口丢包 {:.0f}%)", config_.pod_ip, stats.consecutive_fail, stats.loss_pct);
             }
         }
+        if (stats.last_ok != last_probe_result_) {
+            MYLOG_INFO("探测结果变化: {}", stats.last_ok ? "成功" : "失败");
+            last_probe_result_ = stats.last_ok;
+        }
+        return;
+    }
+
+    int local_success_count = connect_success_count_.load();
+    int local_fail_count = connect_fail_count_.load();
+
+    // 探测连通性
+    bool probe_ok = ProbeConnectivityOnce();
+    
+    if (probe_ok) {
+        local_fail_count = 0;
+        ++local_success_count;
         
-        // 更新计数器 (供外部调试查看)
-        connect_success_count_.store(local_success_count);
-        connect_fail_count_.store(local_fail_count);
-        
-        // 调试日志 (仅在状态变化时输出)
-        if (probe_ok != last_probe_result) {
-            tempLog = std::string(std::string("探测结果变化: ") + 
-                  (probe_ok ? "成功" : "失败"));
+        // 去抖: 连续成功 N 次才认为 connected
+        if (!is_connected_.load() && 
+            local_success_count >= config_.connect_debounce_count) {
+            is_connected_.store(true);
+            tempLog = std::string("网络已连通 " + config_.pod_ip + 
+                  " (经过 " + std::to_string(local_success_count) + " 次探测)");
             MYLOG_INFO(tempLog.c_str());
-            last_probe_result = probe_ok;
         }
+    } else {
+        local_success_count = 0;
+        ++local_fail_count;
         
-        // 休眠等待下一次探测
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(config_.monitor_period_ms));
+        // 去抖: 连续失败 N 次才认为 disconnected
+        if (is_connected_.load() && 
+            local_fail_count >= config_.disconnect_debounce_count) {
+            is_connected_.store(false);
+            tempLog = std::string("网络已断开 " + config_.pod_ip + 
+                  " (连续 " + std::to_string(local_fail_count) + " 次失败)");
+            MYLOG_INFO(tempLog.c_str());
+        }
     }
     
-    tempLog = std::string("监控线程已退出");
-    MYLOG_INFO(tempLog.c_str());
+    // 更新计数器 (供外部调试查看，同时作为下次探测的去抖状态)
+    connect_success_count_.store(local_success_count);
+    connect_fail_count_.store(local_fail_count);
+    
+    // 调试日志 (仅在状态变化时输出)
+    if (probe_ok != last_probe_result_) {
+        tempLog = std::string(std::string("探测结果变化: ") + 
+              (probe_ok ? "成功" : "失败"));
+        MYLOG_INFO(tempLog.c_str());
+        last_probe_result_ = probe_ok;
+    }
 }
 
 bool PodStreamManager::ProbeConnectivityOnce() {
-    // 使用 ping 命令探测 (ICMP)
-    // -c 1: 发送 1 个包
-    // -W 1: 超时 1 秒
-    // -q: 静默模式
-    std::string cmd = "ping -c 1 -W 1 -q " + config_.pod_ip + " > /dev/null 2>&1";
-    
-    int ret = system(cmd.c_str());
-    return (ret == 0);
+    // 进程内 ICMP 探测，超时 1 秒（原为 fork "ping -c 1 -W 1"）
+    return my_tools::ReachabilityProber::GetInstance().ProbeOnce(config_.pod_ip, 1000);
 }
 
 // ============================================================================
@@ -24,6 +24,8 @@
 #include <sys/types.h>
 
 #include "PodConfig.h"
+#include "MyExecutor.h"
+#include "ReachabilityProber.h"
 
 
 namespace pod_stream {
@@ -41,9 +43,9 @@ namespace pod_stream {
  * - 鲁棒: 网络抖动、进程崩溃、配置写失败等异常可自恢复
  * - 可观测: 关键状态变化、启动/停止动作、错误信息必须日志化
  * 
- * 双线程架构:
- * - Monitor Thread: 周期探测吊舱连通性，维护 is_connected 状态
- * - Worker Thread: 根据连通状态驱动状态机，管理 MediaMTX 子进程
+ * 架构:
+ * - Monitor: 共享执行器 "pod_stream" 子系统上的周期定时器，探测吊舱连通性，维护 is_connected 状态
+ * - Worker Thread: 根据连通状态驱动状态机，管理 MediaMTX 子进程（含退避等待，保留独立线程）
  */
 class PodStreamManager final {
 public:
@@ -79,7 +81,7 @@ public:
     /**
      * @brief 启动管理器
      * 
-     * 启动监控线程和工作线程，开始管理 MediaMTX 子进程。
+     * 注册连通性监控定时器并启动工作线程，开始管理 MediaMTX 子进程。
      */
     void Start();
 
@@ -141,12 +143,13 @@ private:
     // ========== 核心线程函数 ==========
     
     /**
-     * @brief 监控线程主循环
+     * @brief 连通性监控（定时器回调，每 monitor_period_ms 一次）
      * 
-     * 周期性探测吊舱 IP 连通性，更新 is_connected 状态。
-     * 使用去抖逻辑避免网络抖动导致状态频繁切换。
+     * 吊舱 IP 由 ReachabilityProber 按 monitor_period_ms 周期探测并去抖，
+     * 这里只同步其去抖后的状态与计数到 is_connected，不再阻塞执行器线程。
+     * 注册探测目标失败时退回单次探测 + 本地去抖。
      */
-    void MonitorLoop();
+    void MonitorTick();
     
     /**
      * @brief 工作线程主循环 (状态机调度)
@@ -162,7 +165,7 @@ private:
      * @brief 单次连通性探测
      * @return 是否连通
      * 
-     * 使用 ICMP ping 探测吊舱 IP 是否可达。
+     * 进程内 ICMP 探测吊舱 IP 是否可达（无 ICMP 权限时退回 TCP），超时 1 秒。
      */
     bool ProbeConnectivityOnce();
     
@@ -264,7 +267,7 @@ private:
     std::atomic<bool> inited_{false};     ///< 是否已初始化
     std::atomic<bool> quit_{false};       ///< 退出标志，通知线程退出
     
-    // ========== 连通性状态 (Monitor Thread 写, Worker Thread 读) ==========
+    // ========== 连通性状态 (Monitor 写, Worker Thread 读) ==========
     std::atomic<bool> is_connected_{false};
     
     // ========== 子进程状态 ==========
@@ -275,12 +278,15 @@ private:
     State state_{State::kIdle};
     
     // ========== 线程对象 ==========
-    std::thread monitor_th_;
+    my_executor::TimerId monitor_timer_{0};
     std::thread worker_th_;
     
     // ========== 去抖计数器 ==========
     std::atomic<int> connect_success_count_{0};
     std::atomic<int> connect_fail_count_{0};
+    bool last_probe_result_{false};   ///< 上次探测结果（仅 MonitorTick 访问）
+    my_tools::ReachabilityProber::Handle probe_handle_{0};  ///< 吊舱 IP 的持续探测句柄
+    uint64_t last_probe_count_{0};    ///< 已同步的探测次数（仅 MonitorTick 访问）
     
     // ========== 崩溃统计与退避 ==========
     mutable std::mutex crash_mtx_;
@@ -0,0 +1,323 @@
+#include "MqttDispatcher.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include "MyLog.h"
+
+namespace my_mqtt {
+
+namespace {
+
+bool ReadInt(const nlohmann::json& j, const char* key, int min_value, int max_value,
+             int& value, std::string* err) {
+    auto it = j.find(key);
+    if (it == j.end()) {
+        return true;
+    }
+    if (!it->is_number_integer()) {
+        if (err) *err = std::string(key) + " 必须是整数";
+        return false;
+    }
+    const auto v = it->get<long long>();
+    if (v < min_value || v > max_value) {
+        if (err) *err = std::string(key) + " 必须在 " + std::to_string(min_value) + "-" +
+                        std::to_string(max_value) + " 范围内";
+        return false;
+    }
+    value = static_cast<int>(v);
+    return true;
+}
+
+std::uint64_t ElapsedUs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+} // namespace
+
+const char* DispatchModeToString(DispatchMode mode) {
+    switch (mode) {
+        case DispatchMode::Inline: return "inline";
+        case DispatchMode::Lanes:  return "lanes";
+    }
+    return "unknown";
+}
+
+const char* LaneKeyToString(LaneKey key) {
+    switch (key) {
+        case LaneKey::Topic: return "topic";
+        case LaneKey::Route: return "route";
+    }
+    return "unknown";
+}
+
+const char* OverflowPolicyToString(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::DropNewest: return "drop_newest";
+        case OverflowPolicy::DropOldest: return "drop_oldest";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// DispatchOptions
+// ============================================================================
+
+bool DispatchOptions::FromJson(const nlohmann::json& j, DispatchOptions& out, std::string* err) {
+    if (!j.is_object()) {
+        if (err) *err = "dispatch 配置必须是对象";
+        return false;
+    }
+
+    DispatchOptions next = out;
+
+    auto read_string = [&](const char* key, std::string& value) {
+        auto it = j.find(key);
+        if (it == j.end()) {
+            return false;
+        }
+        value = it->is_string() ? it->get<std::string>() : std::string();
+        return true;
+    };
+
+    std::string value;
+    if (read_string("mode", value)) {
+        if (value == "inline") {
+            next.mode = DispatchMode::Inline;
+        } else if (value == "lanes") {
+            next.mode = DispatchMode::Lanes;
+        } else {
+            if (err) *err = "mode 只能是 inline 或 lanes";
+            return false;
+        }
+    }
+    if (read_string("lane_key", value)) {
+        if (value == "topic") {
+            next.lane_key = LaneKey::Topic;
+        } else if (value == "route") {
+            next.lane_key = LaneKey::Route;
+        } else {
+            if (err) *err = "lane_key 只能是 topic 或 route";
+            return false;
+        }
+    }
+    if (read_string("overflow", value)) {
+        if (value == "drop_newest") {
+            next.overflow = OverflowPolicy::DropNewest;
+        } else if (value == "drop_oldest") {
+            next.overflow = OverflowPolicy::DropOldest;
+        } else {
+            if (err) *err = "overflow 只能是 drop_newest 或 drop_oldest";
+            return false;
+        }
+    }
+
+    if (!ReadInt(j, "lanes", 1, 64, next.lanes, err) ||
+        !ReadInt(j, "queue_capacity", 1, 1 << 20, next.queue_capacity, err)) {
+        return false;
+    }
+
+    out = next;
+    return true;
+}
+
+nlohmann::json DispatchOptions::ToJson() const {
+    nlohmann::json j;
+    j["mode"] = DispatchModeToString(mode);
+    j["lanes"] = lanes;
+    j["queue_capacity"] = queue_capacity;
+    j["lane_key"] = LaneKeyToString(lane_key);
+    j["overflow"] = OverflowPolicyToString(overflow);
+    return j;
+}
+
+// ============================================================================
+// MqttDispatcher
+// ============================================================================
+
+MqttDispatcher::MqttDispatcher(const DispatchOptions& options) : options_(options) {
+    if (options_.mode != DispatchMode::Lanes) {
+        return;
+    }
+    lanes_.reserve(static_cast<std::size_t>(options_.lanes));
+    for (int i = 0; i < options_.lanes; ++i) {
+        lanes_.push_back(std::make_unique<Lane>());
+    }
+    for (auto& lane : lanes_) {
+        Lane* raw = lane.get();
+        lane->worker = std::thread([this, raw] { LaneLoop(*raw); });
+    }
+    MYLOG_INFO("MqttDispatcher: lanes={} capacity={} key={} overflow={}", options_.lanes,
+               options_.queue_capacity, LaneKeyToString(options_.lane_key),
+               OverflowPolicyToString(options_.overflow));
+}
+
+MqttDispatcher::~MqttDispatcher() {
+    Stop();
+}
+
+std::size_t MqttDispatcher::Dispatch(const std::shared_ptr<const TopicRouter>& router,
+                                     const std::string& topic,
+                                     const std::string& payload) {
+    // 命中下标缓冲按线程复用（先移出再放回，回调中嵌套分发时各自使用独立缓冲）
+    static thread_local std::vector<std::uint32_t> tls_matched;
+    std::vector<std::uint32_t> matched = std::move(tls_matched);
+    matched.clear();
+    router->Match(topic, matched);
+    const std::size_t hits = matched.size();
+
+    if (hits > 0) {
+        dispatched_.fetch_add(1, std::memory_order_relaxed);
+        const auto now = std::chrono::steady_clock::now();
+
+        if (options_.mode == DispatchMode::Inline) {
+            RunHandlers(*router, matched, topic, payload, now);
+        } else if (stopped_.load()) {
+            CountDropped(*router, matched);
+        } else {
+            auto message = std::make_shared<const Message>(Message{topic, payload});
+            const auto& routes = router->Routes();
+            if (options_.lane_key == LaneKey::Topic) {
+                const std::size_t index = std::hash<std::string>{}(topic) % lanes_.size();
+                Enqueue(*lanes_[index], Task{router, std::move(message), matched, now});
+            } else {
+                for (const auto route : matched) {
+                    const std::size_t index = std::hash<std::string>{}(routes[route].filter) % lanes_.size();
+                    Enqueue(*lanes_[index], Task{router, message, {route}, now});
+                }
+            }
+        }
+    }
+
+    tls_matched = std::move(matched);
+    return hits;
+}
+
+void MqttDispatcher::Enqueue(Lane& lane, Task task) {
+    Task discarded;
+    {
+        std::lock_guard<std::mutex> lk(lane.mtx);
+        if (lane.stopping) {
+            discarded = std::move(task);
+        } else if (lane.queue.size() >= static_cast<std::size_t>(options_.queue_capacity) &&
+                   options_.overflow == OverflowPolicy::DropNewest) {
+            ++lane.dropped;
+            discarded = std::move(task);
+        } else {
+            if (lane.queue.size() >= static_cast<std::size_t>(options_.queue_capacity)) {
+                ++lane.dropped;
+                discarded = std::move(lane.queue.front());
+                lane.queue.pop_front();
+            }
+            lane.queue.push_back(std::move(task));
+            lane.max_depth = std::max(lane.max_depth, lane.queue.size());
+        }
+    }
+    lane.cv.notify_one();
+
+    // 统计计数放在锁外，丢弃的任务在此析构
+    if (discarded.router) {
+        CountDropped(*discarded.router, discarded.routes);
+    }
+}
+
+void MqttDispatcher::LaneLoop(Lane& lane) {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lk(lane.mtx);
+            lane.cv.wait(lk, [&] { return lane.stopping || !lane.queue.empty(); });
+            if (lane.stopping) {
+                return;
+            }
+            task = std::move(lane.queue.front());
+            lane.queue.pop_front();
+        }
+
+        RunHandlers(*task.router, task.routes, task.message->topic, task.message->payload, task.enqueued);
+
+        std::lock_guard<std::mutex> lk(lane.mtx);
+        ++lane.processed;
+    }
+}
+
+void MqttDispatcher::RunHandlers(const TopicRouter& router,
+                                 const std::vector<std::uint32_t>& indices,
+                                 const std::string& topic,
+                                 const std::string& payload,
+                                 std::chrono::steady_clock::time_point enqueued) {
+    const auto& routes = router.Routes();
+    for (const auto index : indices) {
+        const auto& r = routes[index];
+        const auto start = std::chrono::steady_clock::now();
+        bool ok = true;
+        try {
+            r.handler(topic, payload);
+        } catch (const std::exception& e) {
+            ok = false;
+            MYLOG_ERROR("route handler exception filter={} err={}", r.filter, e.what());
+        } catch (...) {
+            ok = false;
+            MYLOG_ERROR("route handler unknown exception filter={}", r.filter);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        r.stats->RecordHandled(ElapsedUs(enqueued, start), ElapsedUs(start, end), ok);
+    }
+}
+
+void MqttDispatcher::CountDropped(const TopicRouter& router, const std::vector<std::uint32_t>& indices) {
+    const auto& routes = router.Routes();
+    for (const auto index : indices) {
+        routes[index].stats->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MqttDispatcher::Stop() {
+    if (stopped_.exchange(true)) {
+        return;
+    }
+    std::size_t discarded_total = 0;
+    for (auto& lane : lanes_) {
+        std::deque<Task> pending;
+        {
+            std::lock_guard<std::mutex> lk(lane->mtx);
+            lane->stopping = true;
+            pending.swap(lane->queue);
+            lane->dropped += pending.size();
+        }
+        lane->cv.notify_all();
+        if (lane->worker.joinable()) {
+            lane->worker.join();
+        }
+        for (const auto& task : pending) {
+            CountDropped(*task.router, task.routes);
+        }
+        discarded_total += pending.size();
+    }
+    if (!lanes_.empty()) {
+        MYLOG_INFO("MqttDispatcher stopped, discarded pending={}", discarded_total);
+    }
+}
+
+nlohmann::json MqttDispatcher::GetStatsJson() const {
+    nlohmann::json j = options_.ToJson();
+    j["dispatched"] = dispatched_.load(std::memory_order_relaxed);
+    j["stopped"] = stopped_.load();
+    nlohmann::json lanes = nlohmann::json::array();
+    for (std::size_t i = 0; i < lanes_.size(); ++i) {
+        const auto& lane = *lanes_[i];
+        std::lock_guard<std::mutex> lk(lane.mtx);
+        lanes.push_back({
+            {"index", i},
+            {"depth", lane.queue.size()},
+            {"max_depth", lane.max_depth},
+            {"processed", lane.processed},
+            {"dropped", lane.dropped},
+        });
+    }
+    j["lanes"] = lanes;
+    return j;
+}
+
+} // namespace my_mqtt
@@ -0,0 +1,146 @@
+#pragma once
+
+/**
+ * @file MqttDispatcher.hpp
+ * @brief MQTT 消息分发：在 mosquitto 网络线程上直接执行，或投递到有序工作通道（lane）
+ *
+ * 由 mqtt_comm 节点 model_args.dispatch 提供，示例：
+ * {
+ *   "mode": "lanes",            // "inline"：在网络线程执行回调（默认）；"lanes"：投递到工作通道
+ *   "lanes": 4,                 // 工作通道（线程）数
+ *   "queue_capacity": 256,      // 每个通道的排队上限
+ *   "lane_key": "topic",        // "topic"：按主题哈希选通道；"route"：按路由过滤器哈希选通道
+ *   "overflow": "drop_oldest"   // 通道满时："drop_oldest" 丢弃最早的一条；"drop_newest" 丢弃新消息
+ * }
+ *
+ * 同一主题（lane_key=topic）或同一路由（lane_key=route）总是落在同一通道，
+ * 通道内先进先出、单线程执行，因此保持该主题 / 路由上的消息顺序。
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "TopicRouter.hpp"
+
+namespace my_mqtt {
+
+enum class DispatchMode {
+    Inline,   // 在 mosquitto 网络线程上同步执行回调
+    Lanes,    // 投递到工作通道，由通道线程执行回调
+};
+
+enum class LaneKey {
+    Topic,    // 按消息主题选通道：一条消息的所有路由在同一通道依次执行
+    Route,    // 按路由过滤器选通道：不同路由互不阻塞，同一路由内保持顺序
+};
+
+enum class OverflowPolicy {
+    DropNewest,   // 丢弃新到的消息
+    DropOldest,   // 丢弃通道中最早的消息，为新消息腾出位置
+};
+
+const char* DispatchModeToString(DispatchMode mode);
+const char* LaneKeyToString(LaneKey key);
+const char* OverflowPolicyToString(OverflowPolicy policy);
+
+struct DispatchOptions {
+    DispatchMode mode = DispatchMode::Inline;
+    int lanes = 2;
+    int queue_capacity = 256;
+    LaneKey lane_key = LaneKey::Topic;
+    OverflowPolicy overflow = OverflowPolicy::DropOldest;
+
+    /**
+     * @brief 从 JSON 解析，未出现的字段保持默认值
+     * @return 字段类型或取值非法时返回 false，并在 err 中写入原因；out 不被修改
+     */
+    static bool FromJson(const nlohmann::json& j, DispatchOptions& out, std::string* err = nullptr);
+
+    nlohmann::json ToJson() const;
+};
+
+/**
+ * @brief 路由回调分发器
+ *
+ * Inline 模式下 Dispatch 直接执行命中路由的回调；Lanes 模式下按主题 / 路由哈希
+ * 投递到固定数量的有界通道，每个通道一个线程。通道满时按 overflow 策略丢弃，
+ * 丢弃计入对应路由的 RouteStats::dropped。
+ *
+ * 任务持有路由表快照，AddRoute 替换路由表不影响已排队的消息。
+ */
+class MqttDispatcher {
+public:
+    explicit MqttDispatcher(const DispatchOptions& options);
+    ~MqttDispatcher();
+
+    MqttDispatcher(const MqttDispatcher&) = delete;
+    MqttDispatcher& operator=(const MqttDispatcher&) = delete;
+
+    /**
+     * @brief 分发一条消息到 router 中所有命中的路由
+     * @return 命中的路由数（Lanes 模式下包含被丢弃的）
+     */
+    std::size_t Dispatch(const std::shared_ptr<const TopicRouter>& router,
+                         const std::string& topic,
+                         const std::string& payload);
+
+    /**
+     * @brief 停止所有通道线程；尚未执行的消息被丢弃并计数。之后的 Dispatch 直接丢弃
+     */
+    void Stop();
+
+    const DispatchOptions& Options() const { return options_; }
+
+    /// 各通道排队 / 处理 / 丢弃统计
+    nlohmann::json GetStatsJson() const;
+
+private:
+    struct Message {
+        std::string topic;
+        std::string payload;
+    };
+
+    struct Task {
+        std::shared_ptr<const TopicRouter> router;
+        std::shared_ptr<const Message> message;
+        std::vector<std::uint32_t> routes;            // 路由下标，按注册顺序
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    struct Lane {
+        mutable std::mutex mtx;
+        std::condition_variable cv;
+        std::deque<Task> queue;
+        bool stopping = false;
+        std::thread worker;
+        std::uint64_t processed = 0;
+        std::uint64_t dropped = 0;
+        std::size_t max_depth = 0;
+    };
+
+    void Enqueue(Lane& lane, Task task);
+    void LaneLoop(Lane& lane);
+    static void RunHandlers(const TopicRouter& router,
+                            const std::vector<std::uint32_t>& indices,
+                            const std::string& topic,
+                            const std::string& payload,
+                            std::chrono::steady_clock::time_point enqueued);
+    static void CountDropped(const TopicRouter& router, const std::vector<std::uint32_t>& indices);
+
+    DispatchOptions options_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::atomic<bool> stopped_{false};
+    std::atomic<std::uint64_t> dispatched_{0};
+};
+
+} // namespace my_mqtt
@@ -0,0 +1,566 @@
+#include "MqttOutbox.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "MyLog.h"
+#include "TopicRouter.hpp"
+
+namespace my_mqtt {
+
+namespace {
+
+constexpr std::uint32_t kRecordMagic = 0x424F514D;   // "MQOB"
+constexpr std::size_t kRecordHeaderSize = 16;         // magic + topic_len + payload_len + qos + retain + 2 字节保留
+
+std::int64_t RecordSize(const OutboxMessage& message) {
+    return static_cast<std::int64_t>(kRecordHeaderSize + message.topic.size() + message.payload.size());
+}
+
+void WriteRecord(std::ofstream& out, const OutboxMessage& message) {
+    char header[kRecordHeaderSize] = {};
+    const auto topic_len = static_cast<std::uint32_t>(message.topic.size());
+    const auto payload_len = static_cast<std::uint32_t>(message.payload.size());
+    std::memcpy(header, &kRecordMagic, 4);
+    std::memcpy(header + 4, &topic_len, 4);
+    std::memcpy(header + 8, &payload_len, 4);
+    header[12] = static_cast<char>(message.qos);
+    header[13] = message.retain ? 1 : 0;
+    out.write(header, sizeof(header));
+    out.write(message.topic.data(), static_cast<std::streamsize>(message.topic.size()));
+    out.write(message.payload.data(), static_cast<std::streamsize>(message.payload.size()));
+}
+
+/// 读取一条记录；记录不完整或损坏时返回 false
+bool ReadRecord(std::ifstream& in, std::int64_t remaining, OutboxMessage& message, std::int64_t& size) {
+    if (remaining < static_cast<std::int64_t>(kRecordHeaderSize)) {
+        return false;
+    }
+    char header[kRecordHeaderSize];
+    if (!in.read(header, sizeof(header))) {
+        return false;
+    }
+    std::uint32_t magic = 0;
+    std::uint32_t topic_len = 0;
+    std::uint32_t payload_len = 0;
+    std::memcpy(&magic, header, 4);
+    std::memcpy(&topic_len, header + 4, 4);
+    std::memcpy(&payload_len, header + 8, 4);
+    size = static_cast<std::int64_t>(kRecordHeaderSize) + topic_len + payload_len;
+    if (magic != kRecordMagic || size > remaining) {
+        return false;
+    }
+    message.topic.resize(topic_len);
+    message.payload.resize(payload_len);
+    message.qos = header[12];
+    message.retain = header[13] != 0;
+    return static_cast<bool>(in.read(message.topic.data(), topic_len)) &&
+           static_cast<bool>(in.read(message.payload.data(), payload_len));
+}
+
+bool ReadInt(const nlohmann::json& j, const char* key, int min_value, int max_value,
+             int& value, std::string* err) {
+    auto it = j.find(key);
+    if (it == j.end()) {
+        return true;
+    }
+    if (!it->is_number_integer()) {
+        if (err) *err = std::string(key) + " 必须是整数";
+        return false;
+    }
+    const auto v = it->get<long long>();
+    if (v < min_value || v > max_value) {
+        if (err) *err = std::string(key) + " 必须在 " + std::to_string(min_value) + "-" +
+                        std::to_string(max_value) + " 范围内";
+        return false;
+    }
+    value = static_cast<int>(v);
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// OutboxOptions
+// ============================================================================
+
+bool OutboxOptions::FromJson(const nlohmann::json& j, OutboxOptions& out, std::string* err) {
+    if (!j.is_object()) {
+        if (err) *err = "outbox 配置必须是对象";
+        return false;
+    }
+
+    OutboxOptions next = out;
+
+    if (auto it = j.find("enabled"); it != j.end()) {
+        if (!it->is_boolean()) {
+            if (err) *err = "enabled 必须是布尔值";
+            return false;
+        }
+        next.enabled = it->get<bool>();
+    }
+
+    if (!ReadInt(j, "capacity", 1, 1 << 20, next.capacity, err) ||
+        !ReadInt(j, "batch_size", 1, 4096, next.batch_size, err) ||
+        !ReadInt(j, "retry_interval_ms", 1, 60 * 1000, next.retry_interval_ms, err)) {
+        return false;
+    }
+
+    if (auto it = j.find("coalesce_topics"); it != j.end()) {
+        if (!it->is_array()) {
+            if (err) *err = "coalesce_topics 必须是数组";
+            return false;
+        }
+        std::vector<std::string> topics;
+        for (const auto& item : *it) {
+            if (!item.is_string() || !IsValidTopicFilter(item.get<std::string>())) {
+                if (err) *err = "coalesce_topics 包含非法主题过滤器: " + item.dump();
+                return false;
+            }
+            topics.push_back(item.get<std::string>());
+        }
+        next.coalesce_topics = std::move(topics);
+    }
+
+    if (auto it = j.find("persist_path"); it != j.end()) {
+        if (!it->is_string()) {
+            if (err) *err = "persist_path 必须是字符串";
+            return false;
+        }
+        next.persist_path = it->get<std::string>();
+    }
+
+    if (auto it = j.find("persist_max_bytes"); it != j.end()) {
+        if (!it->is_number_integer() || it->get<long long>() < 1024) {
+            if (err) *err = "persist_max_bytes 必须是不小于 1024 的整数";
+            return false;
+        }
+        next.persist_max_bytes = it->get<std::int64_t>();
+    }
+
+    out = std::move(next);
+    return true;
+}
+
+nlohmann::json OutboxOptions::ToJson() const {
+    nlohmann::json j;
+    j["enabled"] = enabled;
+    j["capacity"] = capacity;
+    j["batch_size"] = batch_size;
+    j["retry_interval_ms"] = retry_interval_ms;
+    j["coalesce_topics"] = coalesce_topics;
+    j["persist_path"] = persist_path;
+    j["persist_max_bytes"] = persist_max_bytes;
+    return j;
+}
+
+// ============================================================================
+// MqttOutbox
+// ============================================================================
+
+MqttOutbox::MqttOutbox(const OutboxOptions& options, OutboxBatchSender sender)
+    : options_(options), sender_(std::move(sender)) {
+    LoadPersisted();
+    worker_ = std::thread([this] { SenderLoop(); });
+    MYLOG_INFO("MqttOutbox: capacity={} batch_size={} coalesce_topics={} persist_path={}",
+               options_.capacity, options_.batch_size, options_.coalesce_topics.size(),
+               options_.persist_path.empty() ? "<none>" : options_.persist_path);
+}
+
+MqttOutbox::~MqttOutbox() {
+    Stop();
+}
+
+bool MqttOutbox::IsCoalesceTopic(const std::string& topic) const {
+    for (const auto& filter : options_.coalesce_topics) {
+        if (TopicFilterMatches(filter, topic)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MqttOutbox::Enqueue(OutboxMessage message) {
+    Entry entry;
+    entry.coalesce = IsCoalesceTopic(message.topic);
+    entry.persistable = !entry.coalesce && message.qos >= 1;
+    entry.message = std::move(message);
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (stopping_) {
+            return false;
+        }
+        enqueued_.fetch_add(1, std::memory_order_relaxed);
+        PushLocked(std::move(entry), false);
+        wake = HasWorkLocked();
+    }
+    if (wake) {
+        cv_.notify_one();
+    }
+    return true;
+}
+
+void MqttOutbox::SetConnected(bool connected) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (connected_ == connected) {
+            return;
+        }
+        connected_ = connected;
+    }
+    cv_.notify_one();
+    drained_cv_.notify_all();
+}
+
+bool MqttOutbox::Flush(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lk(mtx_);
+    return drained_cv_.wait_for(lk, timeout, [&] {
+        return queue_.empty() && in_flight_ == 0 && replay_offset_.load() >= file_bytes_.load();
+    });
+}
+
+void MqttOutbox::Stop() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    std::vector<Entry> persistable;
+    std::size_t discarded = 0;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (!options_.persist_path.empty()) {
+            persistable = TakePersistableLocked();
+        }
+        discarded = queue_.size();
+        queue_.clear();
+        latest_.clear();
+        persistable_count_ = 0;
+    }
+    AppendToFile(persistable);
+    drained_cv_.notify_all();
+    MYLOG_INFO("MqttOutbox stopped, persisted={} discarded={} backlog_bytes={}",
+               persistable.size(), discarded, file_bytes_.load() - replay_offset_.load());
+}
+
+// ----------------------------------------------------------------------------
+// 内存队列（调用方持有 mtx_）
+// ----------------------------------------------------------------------------
+
+bool MqttOutbox::HasWorkLocked() const {
+    if (connected_) {
+        return !queue_.empty() || replay_offset_.load() < file_bytes_.load();
+    }
+    return !options_.persist_path.empty() && persistable_count_ > 0;
+}
+
+void MqttOutbox::PushLocked(Entry entry, bool front) {
+    if (entry.coalesce) {
+        auto it = latest_.find(entry.message.topic);
+        if (it != latest_.end()) {
+            // 队列中已有该主题未发送的值：新值就地替换；放回的旧值直接丢弃
+            if (!front) {
+                it->second->message = std::move(entry.message);
+            }
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    if (queue_.size() >= static_cast<std::size_t>(options_.capacity)) {
+        dropped_overflow_.fetch_add(1, std::memory_order_relaxed);
+        if (front) {
+            return;   // 放回的条目本身最旧
+        }
+        PopFrontLocked();
+    }
+
+    persistable_count_ += entry.persistable ? 1 : 0;
+    // deque 两端插入不会使已有元素的指针失效
+    Entry& stored = front ? queue_.emplace_front(std::move(entry)) : queue_.emplace_back(std::move(entry));
+    if (stored.coalesce) {
+        latest_[stored.message.topic] = &stored;
+    }
+    max_depth_ = std::max(max_depth_, queue_.size());
+}
+
+MqttOutbox::Entry MqttOutbox::PopFrontLocked() {
+    Entry entry = std::move(queue_.front());
+    queue_.pop_front();
+    if (entry.coalesce) {
+        latest_.erase(entry.message.topic);
+    }
+    persistable_count_ -= entry.persistable ? 1 : 0;
+    return entry;
+}
+
+std::vector<MqttOutbox::Entry> MqttOutbox::TakePersistableLocked() {
+    std::vector<Entry> taken;
+    if (persistable_count_ == 0) {
+        return taken;
+    }
+    std::deque<Entry> rest;
+    for (auto& entry : queue_) {
+        if (entry.persistable) {
+            taken.push_back(std::move(entry));
+        } else {
+            rest.push_back(std::move(entry));
+        }
+    }
+    queue_.swap(rest);
+    latest_.clear();
+    for (auto& entry : queue_) {
+        if (entry.coalesce) {
+            latest_[entry.message.topic] = &entry;
+        }
+    }
+    persistable_count_ = 0;
+    return taken;
+}
+
+// ----------------------------------------------------------------------------
+// 发送线程
+// ----------------------------------------------------------------------------
+
+void MqttOutbox::SenderLoop() {
+    const auto retry = std::chrono::milliseconds(options_.retry_interval_ms);
+    std::vector<OutboxMessage> messages;
+    std::vector<Entry> batch;
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    for (;;) {
+        cv_.wait(lk, [&] { return stopping_ || HasWorkLocked(); });
+        if (stopping_) {
+            return;
+        }
+
+        if (!connected_) {
+            // 离线：QoS>=1 消息按顺序落盘，内存只保留可丢失 / 最新值消息
+            auto entries = TakePersistableLocked();
+            lk.unlock();
+            AppendToFile(entries);
+            lk.lock();
+            continue;
+        }
+
+        if (replay_offset_.load() < file_bytes_.load()) {
+            // 在线且有积压：先回放文件，保证 QoS>=1 消息顺序
+            lk.unlock();
+            const bool ok = ReplayBatch();
+            lk.lock();
+            drained_cv_.notify_all();
+            if (!ok) {
+                cv_.wait_for(lk, retry, [&] { return stopping_; });
+            }
+            continue;
+        }
+
+        batch.clear();
+        while (batch.size() < static_cast<std::size_t>(options_.batch_size) && !queue_.empty()) {
+            batch.push_back(PopFrontLocked());
+        }
+        in_flight_ = batch.size();
+        lk.unlock();
+
+        messages.clear();
+        for (auto& entry : batch) {
+            messages.push_back(std::move(entry.message));
+        }
+        std::size_t sent = 0;
+        try {
+            sent = std::min(sender_(messages), messages.size());
+        } catch (const std::exception& e) {
+            MYLOG_ERROR("MqttOutbox: 发送异常 err={}", e.what());
+        }
+
+        lk.lock();
+        sent_.fetch_add(sent, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        const bool failed = sent < messages.size();
+        if (failed) {
+            send_failures_.fetch_add(1, std::memory_order_relaxed);
+            // 未发送的消息按原顺序放回队首
+            for (std::size_t i = messages.size(); i > sent; --i) {
+                Entry& entry = batch[i - 1];
+                entry.message = std::move(messages[i - 1]);
+                PushLocked(std::move(entry), true);
+            }
+        }
+        in_flight_ = 0;
+        drained_cv_.notify_all();
+        if (failed) {
+            cv_.wait_for(lk, retry, [&] { return stopping_; });
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// 持久化文件
+// ----------------------------------------------------------------------------
+
+void MqttOutbox::LoadPersisted() {
+    if (options_.persist_path.empty()) {
+        return;
+    }
+    std::error_code ec;
+    const std::filesystem::path path(options_.persist_path);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    if (!std::filesystem::exists(path, ec)) {
+        return;
+    }
+
+    const auto size = static_cast<std::int64_t>(std::filesystem::file_size(path, ec));
+    if (ec) {
+        MYLOG_WARN("MqttOutbox: 读取持久化文件大小失败 path={} err={}", options_.persist_path, ec.message());
+        return;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    std::int64_t valid = 0;
+    std::size_t records = 0;
+    OutboxMessage message;
+    std::int64_t record_size = 0;
+    while (valid < size && ReadRecord(in, size - valid, message, record_size)) {
+        valid += record_size;
+        ++records;
+    }
+    in.close();
+
+    if (valid < size) {
+        MYLOG_WARN("MqttOutbox: 持久化文件尾部不完整，截断 {} -> {} 字节", size, valid);
+        std::filesystem::resize_file(path, static_cast<std::uintmax_t>(valid), ec);
+    }
+    file_bytes_.store(valid);
+    replay_offset_.store(0);
+    if (records > 0) {
+        MYLOG_INFO("MqttOutbox: 待回放离线消息 {} 条（{} 字节）", records, valid);
+    }
+}
+
+void MqttOutbox::AppendToFile(const std::vector<Entry>& entries) {
+    if (entries.empty()) {
+        return;
+    }
+    std::ofstream out(options_.persist_path, std::ios::binary | std::ios::app);
+    if (!out) {
+        MYLOG_ERROR("MqttOutbox: 打开持久化文件失败 path={}，丢弃 {} 条消息", options_.persist_path, entries.size());
+        dropped_persist_.fetch_add(entries.size(), std::memory_order_relaxed);
+        return;
+    }
+    std::int64_t bytes = file_bytes_.load();
+    for (const auto& entry : entries) {
+        const auto size = RecordSize(entry.message);
+        if (bytes + size > options_.persist_max_bytes) {
+            dropped_persist_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        WriteRecord(out, entry.message);
+        bytes += size;
+        persisted_.fetch_add(1, std::memory_order_relaxed);
+    }
+    out.flush();
+    if (!out) {
+        MYLOG_ERROR("MqttOutbox: 写入持久化文件失败 path={}", options_.persist_path);
+    }
+    file_bytes_.store(bytes);
+}
+
+bool MqttOutbox::ReplayBatch() {
+    const std::int64_t end = file_bytes_.load();
+    std::int64_t offset = replay_offset_.load();
+
+    std::ifstream in(options_.persist_path, std::ios::binary);
+    if (!in || !in.seekg(offset)) {
+        MYLOG_ERROR("MqttOutbox: 读取持久化文件失败 path={}，放弃积压 {} 字节", options_.persist_path, end - offset);
+        dropped_persist_.fetch_add(1, std::memory_order_relaxed);
+        replay_offset_.store(end);
+        return true;
+    }
+
+    std::vector<OutboxMessage> messages;
+    std::vector<std::int64_t> sizes;
+    while (messages.size() < static_cast<std::size_t>(options_.batch_size) && offset < end) {
+        OutboxMessage message;
+        std::int64_t size = 0;
+        if (!ReadRecord(in, end - offset, message, size)) {
+            MYLOG_ERROR("MqttOutbox: 持久化记录损坏 offset={}，跳过剩余 {} 字节", offset, end - offset);
+            offset = end;
+            break;
+        }
+        offset += size;
+        messages.push_back(std::move(message));
+        sizes.push_back(size);
+    }
+    in.close();
+
+    std::size_t sent = 0;
+    if (!messages.empty()) {
+        try {
+            sent = std::min(sender_(messages), messages.size());
+        } catch (const std::exception& e) {
+            MYLOG_ERROR("MqttOutbox: 回放发送异常 err={}", e.what());
+        }
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        sent_.fetch_add(sent, std::memory_order_relaxed);
+        replayed_.fetch_add(sent, std::memory_order_relaxed);
+    }
+
+    std::int64_t advanced = replay_offset_.load();
+    for (std::size_t i = 0; i < sent; ++i) {
+        advanced += sizes[i];
+    }
+    if (sent == messages.size()) {
+        advanced = offset;   // 含跳过的损坏尾部
+    }
+
+    if (advanced >= file_bytes_.load()) {
+        // 积压全部回放完成，截断文件（离线追加只发生在本线程，此时不会有并发写入）
+        std::error_code ec;
+        std::filesystem::resize_file(options_.persist_path, 0, ec);
+        file_bytes_.store(0);
+        replay_offset_.store(0);
+    } else {
+        replay_offset_.store(advanced);
+    }
+
+    if (sent < messages.size()) {
+        send_failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+nlohmann::json MqttOutbox::GetStatsJson() const {
+    nlohmann::json j = options_.ToJson();
+    std::lock_guard<std::mutex> lk(mtx_);
+    j["connected"] = connected_;
+    j["depth"] = queue_.size();
+    j["max_depth"] = max_depth_;
+    j["in_flight"] = in_flight_;
+    j["enqueued"] = enqueued_.load(std::memory_order_relaxed);
+    j["coalesced"] = coalesced_.load(std::memory_order_relaxed);
+    j["sent"] = sent_.load(std::memory_order_relaxed);
+    j["batches"] = batches_.load(std::memory_order_relaxed);
+    j["send_failures"] = send_failures_.load(std::memory_order_relaxed);
+    j["dropped_overflow"] = dropped_overflow_.load(std::memory_order_relaxed);
+    j["dropped_persist"] = dropped_persist_.load(std::memory_order_relaxed);
+    j["persisted"] = persisted_.load(std::memory_order_relaxed);
+    j["replayed"] = replayed_.load(std::memory_order_relaxed);
+    j["backlog_bytes"] = file_bytes_.load() - replay_offset_.load();
+    return j;
+}
+
+} // namespace my_mqtt
@@ -0,0 +1,163 @@
+#pragma once
+
+/**
+ * @file MqttOutbox.hpp
+ * @brief MQTT 发布出站队列：有界缓冲、最新值合并、批量发送、离线持久化与重连回放
+ *
+ * 由 mqtt_comm 节点 model_args.outbox 提供，示例：
+ * {
+ *   "enabled": true,
+ *   "capacity": 4096,                               // 内存队列上限，满时丢弃最早的一条
+ *   "batch_size": 64,                               // 每批发送的最大条数
+ *   "retry_interval_ms": 500,                       // 发送失败后的重试间隔
+ *   "coalesce_topics": ["/system/heartbeats/+"],    // 最新值主题：队列中未发送的旧值被新值替换
+ *   "persist_path": "/tmp/fast_cpp_server/mqtt_outbox.bin",   // 为空表示不持久化
+ *   "persist_max_bytes": 67108864                   // 持久化文件上限，超出后丢弃新的 QoS>=1 消息
+ * }
+ *
+ * 顺序保证：QoS>=1 的非合并消息按发布顺序送出（离线期间写入文件，重连后先回放文件再发内存队列）。
+ * 回放为至少一次：进程在回放中途退出时，已发送但尚未截断的记录会在下次启动时重发。
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace my_mqtt {
+
+struct OutboxMessage {
+    std::string topic;
+    std::string payload;
+    int qos{0};
+    bool retain{false};
+};
+
+/**
+ * @brief 批量发送回调：按顺序发送 batch，返回从头开始连续发送成功的条数
+ *
+ * 返回值小于 batch.size() 表示发送失败（通常是连接断开），剩余消息稍后重试。
+ */
+using OutboxBatchSender = std::function<std::size_t(const std::vector<OutboxMessage>& batch)>;
+
+struct OutboxOptions {
+    bool enabled = false;
+    int capacity = 4096;
+    int batch_size = 64;
+    int retry_interval_ms = 500;
+    std::vector<std::string> coalesce_topics;
+    std::string persist_path;
+    std::int64_t persist_max_bytes = 64LL * 1024 * 1024;
+
+    /**
+     * @brief 从 JSON 解析，未出现的字段保持默认值
+     * @return 字段类型或取值非法时返回 false，并在 err 中写入原因；out 不被修改
+     */
+    static bool FromJson(const nlohmann::json& j, OutboxOptions& out, std::string* err = nullptr);
+
+    nlohmann::json ToJson() const;
+};
+
+/**
+ * @brief 发布出站队列
+ *
+ * 发布方只做入队（不持有发送锁、不等待网络），由一个发送线程按批取出并调用 OutboxBatchSender。
+ * - 在线：先回放持久化文件中的积压，再按批发送内存队列。
+ * - 离线：发送线程把内存中 QoS>=1 的非合并消息按顺序追加到持久化文件，
+ *   其余消息留在内存（有界，合并主题只保留最新值）。
+ *
+ * 文件只由发送线程（以及 Stop 之后）读写；记录格式为定长头 + topic + payload，
+ * 启动时截掉不完整的尾部记录。
+ */
+class MqttOutbox {
+public:
+    MqttOutbox(const OutboxOptions& options, OutboxBatchSender sender);
+    ~MqttOutbox();
+
+    MqttOutbox(const MqttOutbox&) = delete;
+    MqttOutbox& operator=(const MqttOutbox&) = delete;
+
+    /**
+     * @brief 入队一条消息
+     * @return 已停止时返回 false；队列满时丢弃最早的一条，仍返回 true
+     */
+    bool Enqueue(OutboxMessage message);
+
+    /// 连接状态变化（由 mosquitto 连接 / 断开回调调用）
+    void SetConnected(bool connected);
+
+    /**
+     * @brief 等待内存队列与持久化积压全部发送完成
+     * @return 超时或离线时返回 false
+     */
+    bool Flush(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 停止发送线程；开启持久化时内存中的 QoS>=1 消息写入文件，下次启动回放
+     */
+    void Stop();
+
+    const OutboxOptions& Options() const { return options_; }
+
+    nlohmann::json GetStatsJson() const;
+
+private:
+    struct Entry {
+        OutboxMessage message;
+        bool coalesce{false};      // 最新值主题
+        bool persistable{false};   // 离线时需要写入文件（QoS>=1 且非合并）
+    };
+
+    void SenderLoop();
+    bool HasWorkLocked() const;
+    void PushLocked(Entry entry, bool front);
+    Entry PopFrontLocked();
+    std::vector<Entry> TakePersistableLocked();
+    bool IsCoalesceTopic(const std::string& topic) const;
+
+    // 持久化文件（仅发送线程 / Stop 之后调用）
+    void LoadPersisted();
+    void AppendToFile(const std::vector<Entry>& entries);
+    bool ReplayBatch();
+
+    OutboxOptions options_;
+    OutboxBatchSender sender_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::condition_variable drained_cv_;
+    std::deque<Entry> queue_;
+    std::unordered_map<std::string, Entry*> latest_;   // 合并主题 -> 队列中未发送的条目
+    std::size_t persistable_count_ = 0;
+    std::size_t in_flight_ = 0;
+    bool connected_ = false;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    // 持久化文件状态：file_bytes_ 为有效记录总长，replay_offset_ 为已回放位置
+    std::atomic<std::int64_t> file_bytes_{0};
+    std::atomic<std::int64_t> replay_offset_{0};
+
+    // 统计
+    std::atomic<std::uint64_t> enqueued_{0};
+    std::atomic<std::uint64_t> coalesced_{0};
+    std::atomic<std::uint64_t> sent_{0};
+    std::atomic<std::uint64_t> batches_{0};
+    std::atomic<std::uint64_t> send_failures_{0};
+    std::atomic<std::uint64_t> dropped_overflow_{0};
+    std::atomic<std::uint64_t> dropped_persist_{0};
+    std::atomic<std::uint64_t> persisted_{0};
+    std::atomic<std::uint64_t> replayed_{0};
+    std::size_t max_depth_ = 0;
+};
+
+} // namespace my_mqtt
@@ -1,19 +1,9 @@
 #include "MqttService.hpp"
 
-#include <algorithm>
-#include <sstream>
-
 #include "MyLog.h"
 
 namespace my_mqtt {
 
-// namespace-level types (forward-declared in header)
-struct Route {
-    std::string filter;
-    Handler handler;
-    int qos{0};
-};
-
 class PublisherAdapter final : public IMqttPublisher {
 public:
     explicit PublisherAdapter(MqttService& svc) : svc_(svc) {}
@@ -27,14 +17,6 @@ private:
 
 static std::atomic<bool> g_mosq_inited{false};
 
-static std::vector<std::string> splitTopic(const std::string& s) {
-    std::vector<std::string> out;
-    std::stringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, '/')) out.push_back(item);
-    return out;
-}
-
 MqttService& MqttService::GetInstance() {
     static MqttService inst;
     return inst;
@@ -74,6 +56,26 @@ bool MqttService::Init(const nlohmann::json& cfg) {
         return false;
     }
 
+    DispatchOptions dispatch_options;
+    if (cfg_.contains("dispatch")) {
+        std::string err;
+        if (!DispatchOptions::FromJson(cfg_["dispatch"], dispatch_options, &err)) {
+            MYLOG_ERROR("my_mqtt::MqttService Init failed: dispatch 配置非法: {}", err);
+            return false;
+        }
+    }
+    dispatch_options_ = dispatch_options;
+
+    OutboxOptions outbox_options;
+    if (cfg_.contains("outbox")) {
+        std::string err;
+        if (!OutboxOptions::FromJson(cfg_["outbox"], outbox_options, &err)) {
+            MYLOG_ERROR("my_mqtt::MqttService Init failed: outbox 配置非法: {}", err);
+            return false;
+        }
+    }
+    outbox_options_ = outbox_options;
+
     if (!g_mosq_inited.exchange(true)) {
         mosquitto_lib_init();
     }
@@ -109,6 +111,11 @@ bool MqttService::Init(const nlohmann::json& cfg) {
     mosquitto_log_callback_set(mosq_, &MqttService::on_log_static);
 
     publisher_adapter_ = std::make_shared<PublisherAdapter>(*this);
+    std::atomic_store(&dispatcher_, std::make_shared<MqttDispatcher>(dispatch_options_));
+    if (outbox_options_.enabled) {
+        std::atomic_store(&outbox_, std::make_shared<MqttOutbox>(
+            outbox_options_, [this](const std::vector<OutboxMessage>& batch) { return PublishBatch(batch); }));
+    }
 
     inited_.store(true);
     MYLOG_INFO("my_mqtt::MqttService Init ok host={} port={} client_id={}",
@@ -152,6 +159,11 @@ void MqttService::Stop() {
     running_.store(false);
     connected_.store(false);
 
+    // 先停止出站队列（发送线程不再调用 mosquitto_publish），开启持久化时未发送的 QoS>=1 消息落盘
+    if (auto outbox = std::atomic_exchange(&outbox_, std::shared_ptr<MqttOutbox>())) {
+        outbox->Stop();
+    }
+
     if (mosq_) {
         mosquitto_disconnect(mosq_);
         mosquitto_loop_stop(mosq_, true);
@@ -159,7 +171,12 @@ void MqttService::Stop() {
         mosq_ = nullptr;
     }
 
-    routes_.clear();
+    // 网络线程已退出，不会再有新消息；停止工作通道（丢弃未执行的消息）
+    if (auto dispatcher = std::atomic_exchange(&dispatcher_, std::shared_ptr<MqttDispatcher>())) {
+        dispatcher->Stop();
+    }
+
+    std::atomic_store(&router_, TopicRouter::Empty());
     publisher_adapter_.reset();
 
     // 注意：mosquitto_lib_cleanup 是全局的，通常进程退出时再调用
@@ -178,6 +195,10 @@ bool MqttService::Publish(const std::string& topic,
                           const std::string& payload,
                           int qos,
                           bool retain) {
+    if (auto outbox = std::atomic_load(&outbox_)) {
+        return outbox->Enqueue(OutboxMessage{topic, payload, qos, retain});
+    }
+
     if (!running_.load() || !mosq_) {
         MYLOG_WARN("Publish skipped: service not running");
         return false;
@@ -199,6 +220,35 @@ bool MqttService::Publish(const std::string& topic,
     return true;
 }
 
+std::size_t MqttService::PublishBatch(const std::vector<OutboxMessage>& batch) {
+    if (!running_.load() || !connected_.load()) {
+        return 0;
+    }
+
+    // 一批消息只获取一次发布锁；遇到失败即停止，剩余消息由出站队列稍后重试
+    std::lock_guard<std::mutex> lk(pub_mtx_);
+    if (!mosq_) {
+        return 0;
+    }
+    std::size_t sent = 0;
+    for (const auto& m : batch) {
+        int rc = mosquitto_publish(mosq_,
+                                   nullptr,
+                                   m.topic.c_str(),
+                                   static_cast<int>(m.payload.size()),
+                                   m.payload.data(),
+                                   m.qos,
+                                   m.retain);
+        if (rc != MOSQ_ERR_SUCCESS) {
+            MYLOG_WARN("outbox publish failed: {} topic={}, {} message(s) deferred",
+                       mosquitto_strerror(rc), m.topic, batch.size() - sent);
+            break;
+        }
+        ++sent;
+    }
+    return sent;
+}
+
 bool MqttService::Subscribe(const std::string& topicFilter, int qos) {
     if (!running_.load() || !mosq_) {
         MYLOG_WARN("Subscribe skipped: service not running");
@@ -218,9 +268,17 @@ void MqttService::AddRoute(std::string topicFilter, Handler handler, int qos) {
         return;
     }
 
+    if (!IsValidTopicFilter(topicFilter)) {
+        MYLOG_WARN("AddRoute ignored: invalid filter={}", topicFilter);
+        return;
+    }
+
     {
+        // 写者之间由 mtx_ 串行化；分发线程继续使用旧快照，直到新表替换完成
         std::lock_guard<std::mutex> lk(mtx_);
-        routes_.push_back(Route{topicFilter, std::move(handler), qos});
+        std::vector<Route> routes = LoadRouter()->Routes();
+        routes.push_back(Route{topicFilter, std::move(handler), qos});
+        std::atomic_store(&router_, TopicRouter::Build(std::move(routes)));
     }
 
     if (!Subscribe(topicFilter, qos)) {
@@ -257,15 +315,14 @@ void MqttService::on_log_static(struct mosquitto* m, void* obj, int level, const
 // instance handlers
 void MqttService::OnConnect(int rc) {
     connected_.store(rc == 0);
+    if (auto outbox = std::atomic_load(&outbox_)) {
+        outbox->SetConnected(rc == 0);
+    }
     if (rc == 0) {
         MYLOG_INFO("MQTT connected OK");
         // 连接成功后（或重连后），为已注册的 routes 自动订阅主题
-        std::vector<Route> routes_copy;
-        {
-            std::lock_guard<std::mutex> lk(mtx_);
-            routes_copy = routes_;
-        }
-        for (const auto &r : routes_copy) {
+        const auto router = LoadRouter();
+        for (const auto &r : router->Routes()) {
             if (!mosq_) break;
             int sub_rc = mosquitto_subscribe(mosq_, nullptr, r.filter.c_str(), r.qos);
             if (sub_rc != MOSQ_ERR_SUCCESS) {
@@ -281,6 +338,9 @@ void MqttService::OnConnect(int rc) {
 
 void MqttService::OnDisconnect(int rc) {
     connected_.store(false);
+    if (auto outbox = std::atomic_load(&outbox_)) {
+        outbox->SetConnected(false);
+    }
     if (!running_.load()) {
         MYLOG_INFO("MQTT disconnected (service stopping) rc={}", rc);
         return;
@@ -301,47 +361,18 @@ void MqttService::OnMessage(const mosquitto_message* msg) {
     DispatchRoutes(topic, payload);
 }
 
-void MqttService::DispatchRoutes(const std::string& topic, const std::string& payload) {
-    std::vector<Route> routes_copy;
-    {
-        std::lock_guard<std::mutex> lk(mtx_);
-        if (!running_.load()) return;
-        routes_copy = routes_;
-    }
-
-    for (const auto& r : routes_copy) {
-        if (MatchTopicFilter(r.filter, topic)) {
-            try {
-                r.handler(topic, payload);
-            } catch (const std::exception& e) {
-                MYLOG_ERROR("route handler exception filter={} err={}", r.filter, e.what());
-            } catch (...) {
-                MYLOG_ERROR("route handler unknown exception filter={}", r.filter);
-            }
-        }
-    }
+std::shared_ptr<const TopicRouter> MqttService::LoadRouter() const {
+    return std::atomic_load(&router_);
 }
 
-bool MqttService::MatchTopicFilter(const std::string& filter, const std::string& topic) {
-    const auto f = splitTopic(filter);
-    const auto t = splitTopic(topic);
-
-    size_t i = 0;
-    for (; i < f.size(); ++i) {
-        const auto& fp = f[i];
-
-        if (fp == "#") {
-            return true; // match rest
-        }
-
-        if (i >= t.size()) return false;
-
-        if (fp == "+") continue;
-
-        if (fp != t[i]) return false;
-    }
+void MqttService::DispatchRoutes(const std::string& topic, const std::string& payload) {
+    if (!running_.load()) return;
 
-    return i == t.size();
+    // 持有快照期间路由表不会被修改；inline 模式在当前（网络）线程执行回调，
+    // lanes 模式只做匹配和入队，回调由工作通道线程执行，不阻塞保活与其他主题
+    const auto dispatcher = std::atomic_load(&dispatcher_);
+    if (!dispatcher) return;
+    dispatcher->Dispatch(LoadRouter(), topic, payload);
 }
 
 // PublisherAdapter 方法实现
@@ -368,12 +399,13 @@ const nlohmann::json MqttService::GetConfig() {
 const nlohmann::json MqttService::GetRoutes() {
     MYLOG_INFO("MqttService GetRoutes called");
     try {
-        std::lock_guard<std::mutex> lock(mtx_);
+        const auto router = LoadRouter();
         nlohmann::json routes_json = nlohmann::json::array();
-        for (const auto& r : routes_) {
+        for (const auto& r : router->Routes()) {
             nlohmann::json route;
             route["filter"] = r.filter;
             route["qos"] = r.qos;
+            route["stats"] = r.stats->ToJson();
             routes_json.push_back(route);
         }
         return routes_json;
@@ -385,4 +417,25 @@ const nlohmann::json MqttService::GetRoutes() {
     
 }
 
+const nlohmann::json MqttService::GetDispatchStats() {
+    const auto dispatcher = std::atomic_load(&dispatcher_);
+    if (!dispatcher) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        nlohmann::json j = dispatch_options_.ToJson();
+        j["running"] = false;
+        return j;
+    }
+    nlohmann::json j = dispatcher->GetStatsJson();
+    j["running"] = running_.load();
+    return j;
+}
+
+const nlohmann::json MqttService::GetOutboxStats() {
+    if (auto outbox = std::atomic_load(&outbox_)) {
+        return outbox->GetStatsJson();
+    }
+    std::lock_guard<std::mutex> lk(mtx_);
+    return outbox_options_.ToJson();
+}
+
 } // namespace my_mqtt
\ No newline at end of file
@@ -11,13 +11,14 @@
 #include <mosquitto.h>
 
 #include "IMqttPublisher.hpp"
+#include "MqttDispatcher.hpp"
+#include "MqttOutbox.hpp"
+#include "TopicRouter.hpp"
 
 namespace my_mqtt {
-using Handler = std::function<void(const std::string& topic, const std::string& payload)>;
 
 class MqttService;
 
-struct Route;
 class PublisherAdapter;
 
 /**
@@ -36,7 +37,12 @@ public:
     //   "client_id":"app_01",
     //   "clean_session":true,
     //   "username":"", "password":"",
-    //   "reconnect": { "min_sec":2, "max_sec":32 }
+    //   "reconnect": { "min_sec":2, "max_sec":32 },
+    //   "dispatch": { "mode":"lanes", "lanes":4, "queue_capacity":256,
+    //                 "lane_key":"topic", "overflow":"drop_oldest" },  // 见 MqttDispatcher.hpp
+    //   "outbox": { "enabled":true, "capacity":4096, "batch_size":64,
+    //               "coalesce_topics":["/system/heartbeats/+"],
+    //               "persist_path":"/tmp/fast_cpp_server/mqtt_outbox.bin" }  // 见 MqttOutbox.hpp
     // }
     bool Init(const nlohmann::json& cfg);
     bool Start();   // connect + loop_start
@@ -47,6 +53,8 @@ public:
     /**
      * @brief 发布消息
      * 
+     * 启用 outbox 时只入队（离线也接受），由出站队列批量发送；否则直接调用 mosquitto_publish。
+     * 
      * @param topic 主题
      * @param payload 消息内容
      * @param qos 服务质量等级
@@ -72,6 +80,9 @@ public:
     /**
      * @brief 添加路由，注册后自动订阅对应主题过滤器
      * 
+     * 路由表为不可变快照，添加时基于当前快照构建新表并整体替换，
+     * 消息分发读取快照时不加锁。非法过滤器（'+'/'#' 未独占一层、'#' 不在末层）被忽略。
+     * 
      * @param topicFilter 主题过滤器
      * @param handler 消息处理回调
      * @param qos 服务质量等级
@@ -86,8 +97,16 @@ public:
     std::shared_ptr<IMqttPublisher> GetPublisher();
 
     const nlohmann::json GetConfig();
+
+    /// 路由列表，含每条路由的处理 / 丢弃 / 耗时统计
     const nlohmann::json GetRoutes();
 
+    /// 分发模式与各工作通道统计
+    const nlohmann::json GetDispatchStats();
+
+    /// 出站队列配置与统计（未启用时只返回配置）
+    const nlohmann::json GetOutboxStats();
+
 private:
     MqttService() = default;                                // 私有构造函数
     ~MqttService();                                         // 私有析构函数
@@ -106,10 +125,11 @@ private:
     void OnDisconnect(int rc);                                                                      // NOLINT
     void OnMessage(const mosquitto_message* msg);                                                   // NOLINT
     void DispatchRoutes(const std::string& topic, const std::string& payload);                      // NOLINT
-    static bool MatchTopicFilter(const std::string& filter, const std::string& topic);              // NOLINT
+    std::size_t PublishBatch(const std::vector<OutboxMessage>& batch);                              // NOLINT
+    std::shared_ptr<const TopicRouter> LoadRouter() const;                                          // NOLINT
 
 private:
-    std::mutex                              mtx_;                       // 保护 mosq_ / routes_ / config
+    std::mutex                              mtx_;                       // 保护 mosq_ / config，串行化路由表更新
     std::mutex                              pub_mtx_;                   // 保护 mosquitto_publish（线程安全）
     nlohmann::json                          cfg_;                       // 配置                   
     std::string                             host_;                      // MQTT 服务器地址
@@ -125,7 +145,11 @@ private:
     std::atomic<bool>                       running_{false};          // 是否正在运行
     std::atomic<bool>                       connected_{false};        // 是否已连接
     struct mosquitto*                       mosq_{nullptr};             // mosquitto 客户端句柄
-    std::vector<Route>                      routes_;                    // 路由列表
+    std::shared_ptr<const TopicRouter>      router_{TopicRouter::Empty()};  // 路由表快照（std::atomic_load / atomic_store 访问）
+    DispatchOptions                         dispatch_options_;          // 消息分发配置
+    std::shared_ptr<MqttDispatcher>         dispatcher_;                // 消息分发器（std::atomic_load / atomic_store 访问）
+    OutboxOptions                           outbox_options_;            // 出站队列配置
+    std::shared_ptr<MqttOutbox>             outbox_;                    // 出站队列，未启用时为空（std::atomic_load / atomic_store 访问）
     std::shared_ptr<PublisherAdapter>       publisher_adapter_;         // 发布者适配器
 };
 
@@ -0,0 +1,205 @@
+#include "TopicRouter.hpp"
+
+#include <algorithm>
+
+#include "MyLog.h"
+
+namespace my_mqtt {
+
+namespace {
+
+// 取出第一层，rest 前移到下一层；返回是否已是最后一层
+bool NextLevel(std::string_view& rest, std::string_view& level) {
+    const auto slash = rest.find('/');
+    if (slash == std::string_view::npos) {
+        level = rest;
+        rest = std::string_view();
+        return true;
+    }
+    level = rest.substr(0, slash);
+    rest.remove_prefix(slash + 1);
+    return false;
+}
+
+void UpdateMax(std::atomic<std::uint64_t>& target, std::uint64_t value) {
+    auto current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+void RouteStats::RecordHandled(std::uint64_t queue_us, std::uint64_t handler_us, bool ok) {
+    handled.fetch_add(1, std::memory_order_relaxed);
+    if (!ok) {
+        errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    queue_us_total.fetch_add(queue_us, std::memory_order_relaxed);
+    handler_us_total.fetch_add(handler_us, std::memory_order_relaxed);
+    UpdateMax(queue_us_max, queue_us);
+    UpdateMax(handler_us_max, handler_us);
+}
+
+nlohmann::json RouteStats::ToJson() const {
+    const auto n = handled.load(std::memory_order_relaxed);
+    nlohmann::json j;
+    j["handled"] = n;
+    j["errors"] = errors.load(std::memory_order_relaxed);
+    j["dropped"] = dropped.load(std::memory_order_relaxed);
+    j["queue_us_avg"] = n ? queue_us_total.load(std::memory_order_relaxed) / n : 0;
+    j["queue_us_max"] = queue_us_max.load(std::memory_order_relaxed);
+    j["handler_us_avg"] = n ? handler_us_total.load(std::memory_order_relaxed) / n : 0;
+    j["handler_us_max"] = handler_us_max.load(std::memory_order_relaxed);
+    return j;
+}
+
+bool IsValidTopicFilter(std::string_view filter) {
+    if (filter.empty()) {
+        return false;
+    }
+    std::string_view rest = filter;
+    std::string_view level;
+    for (;;) {
+        const bool last = NextLevel(rest, level);
+        if (level.find_first_of("+#") != std::string_view::npos) {
+            if (level.size() != 1) {
+                return false;
+            }
+            if (level == "#" && !last) {
+                return false;
+            }
+        }
+        if (last) {
+            return true;
+        }
+    }
+}
+
+bool TopicFilterMatches(std::string_view filter, std::string_view topic) {
+    std::string_view f_rest = filter;
+    std::string_view t_rest = topic;
+    std::string_view f_level;
+    std::string_view t_level;
+    bool t_done = false;
+
+    for (;;) {
+        const bool f_last = NextLevel(f_rest, f_level);
+        if (f_level == "#") {
+            return true;   // 匹配剩余所有层（含零层）
+        }
+        if (t_done) {
+            return false;  // 主题已结束，过滤器还有非 '#' 层
+        }
+        t_done = NextLevel(t_rest, t_level);
+        if (f_level != "+" && f_level != t_level) {
+            return false;
+        }
+        if (f_last) {
+            return t_done;   // 过滤器结束时主题也必须结束
+        }
+    }
+}
+
+// ============================================================================
+// TopicRouter
+// ============================================================================
+
+struct TopicRouter::Node {
+    std::vector<std::pair<std::string, std::unique_ptr<Node>>> children;   // 按层名排序
+    std::unique_ptr<Node> plus;                                              // '+' 子节点
+    std::vector<std::uint32_t> exact;                                        // 过滤器在本层结束
+    std::vector<std::uint32_t> multi;                                        // 过滤器在本层之后为 '#'
+
+    const Node* Find(std::string_view level) const {
+        auto it = std::lower_bound(children.begin(), children.end(), level,
+                                   [](const auto& child, std::string_view key) { return child.first < key; });
+        if (it != children.end() && it->first == level) {
+            return it->second.get();
+        }
+        return nullptr;
+    }
+
+    Node* FindOrCreate(std::string_view level, std::size_t& created) {
+        auto it = std::lower_bound(children.begin(), children.end(), level,
+                                   [](const auto& child, std::string_view key) { return child.first < key; });
+        if (it != children.end() && it->first == level) {
+            return it->second.get();
+        }
+        ++created;
+        it = children.emplace(it, std::string(level), std::make_unique<Node>());
+        return it->second.get();
+    }
+
+    // rest 为尚未匹配的主题层，done 表示主题所有层都已匹配
+    void Collect(std::string_view rest, bool done, std::vector<std::uint32_t>& out) const {
+        out.insert(out.end(), multi.begin(), multi.end());
+        if (done) {
+            out.insert(out.end(), exact.begin(), exact.end());
+            return;
+        }
+        std::string_view level;
+        const bool last = NextLevel(rest, level);
+        if (const Node* child = Find(level)) {
+            child->Collect(rest, last, out);
+        }
+        if (plus) {
+            plus->Collect(rest, last, out);
+        }
+    }
+};
+
+TopicRouter::TopicRouter() : root_(std::make_unique<Node>()) {}
+
+TopicRouter::~TopicRouter() = default;
+
+std::shared_ptr<const TopicRouter> TopicRouter::Build(std::vector<Route> routes) {
+    std::shared_ptr<TopicRouter> router(new TopicRouter());
+    router->routes_ = std::move(routes);
+
+    for (std::size_t i = 0; i < router->routes_.size(); ++i) {
+        const std::string& filter = router->routes_[i].filter;
+        if (!IsValidTopicFilter(filter)) {
+            MYLOG_WARN("TopicRouter: 非法主题过滤器，跳过 filter={}", filter);
+            continue;
+        }
+        const auto index = static_cast<std::uint32_t>(i);
+        Node* node = router->root_.get();
+        std::string_view rest = filter;
+        std::string_view level;
+        for (;;) {
+            const bool last = NextLevel(rest, level);
+            if (level == "#") {
+                node->multi.push_back(index);
+                break;
+            }
+            if (level == "+") {
+                if (!node->plus) {
+                    node->plus = std::make_unique<Node>();
+                    ++router->node_count_;
+                }
+                node = node->plus.get();
+            } else {
+                node = node->FindOrCreate(level, router->node_count_);
+            }
+            if (last) {
+                node->exact.push_back(index);
+                break;
+            }
+        }
+    }
+    return router;
+}
+
+std::shared_ptr<const TopicRouter> TopicRouter::Empty() {
+    static const std::shared_ptr<const TopicRouter> empty = Build({});
+    return empty;
+}
+
+void TopicRouter::Match(std::string_view topic, std::vector<std::uint32_t>& out) const {
+    const auto begin = out.size();
+    root_->Collect(topic, false, out);
+    // 不同分支收集的下标各自有序，合并后恢复注册顺序
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(begin), out.end());
+}
+
+} // namespace my_mqtt
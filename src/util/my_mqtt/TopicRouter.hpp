@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace my_mqtt {
+
+using Handler = std::function<void(const std::string& topic, const std::string& payload)>;
+
+/**
+ * @brief 单条路由的处理统计（无锁计数，路由表快照之间共享）
+ */
+struct RouteStats {
+    std::atomic<std::uint64_t> handled{0};             // 已执行的回调次数
+    std::atomic<std::uint64_t> errors{0};              // 回调抛出异常次数
+    std::atomic<std::uint64_t> dropped{0};             // 队列溢出 / 停止时丢弃的消息数
+    std::atomic<std::uint64_t> queue_us_total{0};      // 入队到开始执行的等待时间
+    std::atomic<std::uint64_t> queue_us_max{0};
+    std::atomic<std::uint64_t> handler_us_total{0};    // 回调执行时间
+    std::atomic<std::uint64_t> handler_us_max{0};
+
+    void RecordHandled(std::uint64_t queue_us, std::uint64_t handler_us, bool ok);
+    nlohmann::json ToJson() const;
+};
+
+/**
+ * @brief 一条消息路由：主题过滤器 + 处理回调
+ */
+struct Route {
+    std::string filter;
+    Handler handler;
+    int qos{0};
+    std::shared_ptr<RouteStats> stats{std::make_shared<RouteStats>()};
+};
+
+/**
+ * @brief 校验主题过滤器（MQTT 3.1.1 4.7）
+ *
+ * 非空；'+' 必须独占一层；'#' 必须独占一层且位于最后一层。
+ */
+bool IsValidTopicFilter(std::string_view filter);
+
+/**
+ * @brief 单个过滤器与主题的匹配，不分配内存
+ *
+ * '+' 匹配一层（含空层），'#' 匹配剩余任意层（含零层，"a/#" 匹配 "a"）。
+ */
+bool TopicFilterMatches(std::string_view filter, std::string_view topic);
+
+/**
+ * @brief 不可变的订阅路由表（主题树）
+ *
+ * 所有过滤器按层建成一棵树，每个节点保存精确子层、'+' 子节点，以及在该层结束 / 以 '#' 结束的路由。
+ * 匹配沿主题逐层下降，复杂度只与主题层数和命中的通配分支有关，与路由总数无关，且不分配内存。
+ *
+ * 构建后不再修改：MqttService 在 AddRoute 时基于旧表构建新表并整体替换（RCU 风格），
+ * 分发线程持有旧表的 shared_ptr 即可无锁读取。
+ */
+class TopicRouter {
+public:
+    /**
+     * @brief 构建路由表；非法过滤器的路由保留在 Routes() 中但不参与匹配
+     */
+    static std::shared_ptr<const TopicRouter> Build(std::vector<Route> routes);
+
+    /// 空路由表
+    static std::shared_ptr<const TopicRouter> Empty();
+
+    /// 按注册顺序排列的全部路由
+    const std::vector<Route>& Routes() const { return routes_; }
+
+    /// 树节点数（不含根），用于统计
+    std::size_t NodeCount() const { return node_count_; }
+
+    /**
+     * @brief 收集与 topic 匹配的路由下标，按注册顺序（升序）追加到 out
+     *
+     * out 由调用方复用，容量足够时不分配内存。
+     */
+    void Match(std::string_view topic, std::vector<std::uint32_t>& out) const;
+
+    TopicRouter(const TopicRouter&) = delete;
+    TopicRouter& operator=(const TopicRouter&) = delete;
+    ~TopicRouter();
+
+private:
+    struct Node;
+
+    TopicRouter();
+
+    std::vector<Route> routes_;
+    std::unique_ptr<Node> root_;
+    std::size_t node_count_ = 0;
+};
+
+} // namespace my_mqtt
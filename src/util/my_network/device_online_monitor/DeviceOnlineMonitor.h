@@ -2,10 +2,16 @@
 #define DEVICE_ONLINE_MONITOR_H
 
 #include <string>
-#include <thread>
 #include <mutex>
-#include <atomic>
 
+#include "ReachabilityProber.h"
+
+/**
+ * @brief 设备在线监控（TCP 端口探测）
+ *
+ * 由 ReachabilityProber 共享的探测线程按 interval_seconds 周期对 host:port 发起非阻塞
+ * connect：一次成功即在线，连续 fail_threshold 次失败判定离线。不再为每个实例创建线程。
+ */
 class DeviceOnlineMonitor {
 public:
 
@@ -20,19 +26,13 @@ public:
     bool isOnline();
 
 private:
-    void monitorLoop();
-    bool tryConnect();
-
     std::string host_;
     int port_;
     int interval_seconds_;
     int fail_threshold_;
 
-    std::atomic<bool> running_;
-    std::thread monitor_thread_;
-
     std::mutex mutex_;
-    bool online_;
+    my_tools::ReachabilityProber::Handle handle_;  ///< 0 表示未运行
 
     bool initialized_;
 };
@@ -27,6 +27,7 @@ bool PodManager::Init(const nlohmann::json& config) {
     }
 
     init_config_ = config;
+    config_generation_.fetch_add(1);
     MYLOG_INFO("[吊舱管理器] 开始初始化，配置: {}", config.dump(4));
 
     // 解析 pod_args
@@ -203,6 +204,7 @@ void PodManager::ResetForTest() {
 
     registry_.clear();
     init_config_.clear();
+    config_generation_.fetch_add(1);
     initialized_.store(false);
     MYLOG_INFO("[吊舱管理器] ResetForTest 完成，已清空所有吊舱实例");
 }
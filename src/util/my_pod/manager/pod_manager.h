@@ -17,6 +17,7 @@
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include <cstdint>
 
 namespace PodModule {
 
@@ -53,6 +54,9 @@ public:
     /** @brief 获取初始化时的配置 */
     nlohmann::json GetInitConfig() const;
 
+    /** @brief 初始化配置的代号，配置变化（Init / ResetForTest）时递增 */
+    uint64_t GetConfigGeneration() const { return config_generation_.load(); }
+
     /**
      * @brief 添加一个吊舱
      * @param pod 吊舱实例
@@ -125,6 +129,7 @@ private:
 
     PodRegistry registry_;
     nlohmann::json init_config_;
+    std::atomic<uint64_t> config_generation_{1};
     mutable std::mutex mutex_;
     std::atomic<bool> initialized_{false};
 };
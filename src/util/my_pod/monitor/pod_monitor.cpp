@@ -46,10 +46,20 @@ void PodMonitor::start(IPod* pod, const PodMonitorConfig& config) {
         online_history_.clear();
     }
 
+    last_status_time_ = 0;
+    last_ptz_time_    = 0;
+    last_laser_time_  = 0;
+    last_stream_time_ = 0;
+
     running_.store(true);
-    monitor_thread_ = std::thread(&PodMonitor::monitorLoop, this);
+    {
+        std::lock_guard<std::mutex> lk(timer_mutex_);
+        timer_id_ = my_executor::MyExecutor::GetInstance().ScheduleEvery(
+            "pod", static_cast<int>(std::max<uint32_t>(config.poll_interval_ms, 1)),
+            [this]() { pollOnce(); }, 0);
+    }
 
-    MYLOG_INFO("[PodMonitor] 监控线程已启动 (pod={}, poll={}ms, status={}ms, ptz={}ms)",
+    MYLOG_INFO("[PodMonitor] 监控已启动 (pod={}, poll={}ms, status={}ms, ptz={}ms)",
                pod_->getPodId(), config.poll_interval_ms,
                config.status_interval_ms, config.ptz_interval_ms);
 }
@@ -58,10 +68,14 @@ void PodMonitor::stop() {
     if (!running_.load()) return;
 
     running_.store(false);
-    if (monitor_thread_.joinable()) {
-        monitor_thread_.join();
+    my_executor::TimerId id = 0;
+    {
+        std::lock_guard<std::mutex> lk(timer_mutex_);
+        id = timer_id_;
+        timer_id_ = 0;
     }
-    MYLOG_INFO("[PodMonitor] 监控线程已停止");
+    my_executor::MyExecutor::GetInstance().CancelTimer(id, true);
+    MYLOG_INFO("[PodMonitor] 监控已停止 (pod={})", pod_ ? pod_->getPodId() : "");
 }
 
 bool PodMonitor::isRunning() const {
@@ -76,9 +90,24 @@ PodRuntimeStatus PodMonitor::getRuntimeStatus() const {
 }
 
 void PodMonitor::updateConfig(const PodMonitorConfig& config) {
-    std::lock_guard<std::mutex> lk(config_mutex_);
-    config_ = config;
+    uint32_t old_poll_ms = 0;
+    {
+        std::lock_guard<std::mutex> lk(config_mutex_);
+        old_poll_ms = config_.poll_interval_ms;
+        config_ = config;
+    }
     MYLOG_INFO("[PodMonitor] 轮询配置已更新");
+
+    // 定时器周期固定，poll_interval_ms 变化时重新注册
+    if (!running_.load() || old_poll_ms == config.poll_interval_ms) {
+        return;
+    }
+    std::lock_guard<std::mutex> lk(timer_mutex_);
+    auto& executor = my_executor::MyExecutor::GetInstance();
+    executor.CancelTimer(timer_id_, true);
+    timer_id_ = executor.ScheduleEvery(
+        "pod", static_cast<int>(std::max<uint32_t>(config.poll_interval_ms, 1)),
+        [this]() { pollOnce(); });
 }
 
 // ==================== 工具方法 ====================
@@ -90,61 +119,47 @@ uint64_t PodMonitor::nowMs() {
         ).count());
 }
 
-// ==================== 监控主循环 ====================
-
-void PodMonitor::monitorLoop() {
-    MYLOG_INFO("[PodMonitor] 监控循环开始 (pod={})", pod_->getPodId());
-
-    uint64_t last_status_time = 0;
-    uint64_t last_ptz_time    = 0;
-    uint64_t last_laser_time  = 0;
-    uint64_t last_stream_time = 0;
-
-    while (running_.load()) {
-        // 读取当前配置快照
-        PodMonitorConfig cfg;
-        {
-            std::lock_guard<std::mutex> lk(config_mutex_);
-            cfg = config_;
-        }
+// ==================== 一轮轮询 ====================
 
-        const uint64_t now = nowMs();
+void PodMonitor::pollOnce() {
+    if (!running_.load()) {
+        return;
+    }
 
-        // ---- 按顺序依次轮询各能力 ----
+    // 读取当前配置快照
+    PodMonitorConfig cfg;
+    {
+        std::lock_guard<std::mutex> lk(config_mutex_);
+        cfg = config_;
+    }
 
-        // 1) 状态 / 在线检测
-        if (cfg.enable_status_poll && (now - last_status_time >= cfg.status_interval_ms)) {
-            pollStatus();
-            last_status_time = nowMs();
-        }
+    const uint64_t now = nowMs();
 
-        // 2) 云台姿态
-        if (cfg.enable_ptz_poll && (now - last_ptz_time >= cfg.ptz_interval_ms)) {
-            pollPtz();
-            last_ptz_time = nowMs();
-        }
+    // ---- 按顺序依次轮询各能力 ----
 
-        // 3) 激光测距
-        if (cfg.enable_laser_poll && (now - last_laser_time >= cfg.laser_interval_ms)) {
-            pollLaser();
-            last_laser_time = nowMs();
-        }
+    // 1) 状态 / 在线检测
+    if (cfg.enable_status_poll && (now - last_status_time_ >= cfg.status_interval_ms)) {
+        pollStatus();
+        last_status_time_ = nowMs();
+    }
 
-        // 4) 流媒体状态
-        if (cfg.enable_stream_poll && (now - last_stream_time >= cfg.stream_interval_ms)) {
-            pollStream();
-            last_stream_time = nowMs();
-        }
+    // 2) 云台姿态
+    if (cfg.enable_ptz_poll && (now - last_ptz_time_ >= cfg.ptz_interval_ms)) {
+        pollPtz();
+        last_ptz_time_ = nowMs();
+    }
 
-        // ---- 可中断睡眠：分片 100ms，快速响应 stop() ----
-        const uint32_t step_ms = 100;
-        for (uint32_t slept = 0; slept < cfg.poll_interval_ms && running_.load(); slept += step_ms) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(
-                std::min(step_ms, cfg.poll_interval_ms - slept)));
-        }
+    // 3) 激光测距
+    if (cfg.enable_laser_poll && (now - last_laser_time_ >= cfg.laser_interval_ms)) {
+        pollLaser();
+        last_laser_time_ = nowMs();
     }
 
-    MYLOG_INFO("[PodMonitor] 监控循环结束 (pod={})", pod_->getPodId());
+    // 4) 流媒体状态
+    if (cfg.enable_stream_poll && (now - last_stream_time_ >= cfg.stream_interval_ms)) {
+        pollStream();
+        last_stream_time_ = nowMs();
+    }
 }
 
 // ==================== 各能力轮询（try-catch 保护） ====================
@@ -4,20 +4,21 @@
  * @file pod_monitor.h
  * @brief 吊舱后台监控器
  *
- * PodMonitor 在独立线程中定期轮询各项能力模块，将采集结果
- * 聚合到 PodRuntimeStatus 数据对象中。外部读取时直接获取
+ * PodMonitor 在共享执行器（"pod" 子系统）上以定时任务定期轮询各项能力模块，
+ * 将采集结果聚合到 PodRuntimeStatus 数据对象中。外部读取时直接获取
  * 快照，无需实时查询设备。
  *
  * 设计要点：
  * - 轮询顺序：依次按 状态→云台→激光→流媒体 执行
  * - 在线判定：使用滑动窗口，需连续多次检测以确定最终状态
  * - 错误隔离：每个能力的轮询均用 try-catch 保护，
- *   单个能力异常不影响其余能力和主循环
- * - 可中断关闭：主循环睡眠分片，确保 stop() 快速返回
+ *   单个能力异常不影响其余能力和后续轮询
+ * - 不独占线程：每轮结束后由定时器在 poll_interval_ms 后触发下一轮，
+ *   stop() 取消定时器并等待进行中的一轮结束
  */
 
 #include "../common/pod_models.h"
-#include <thread>
+#include "MyExecutor.h"
 #include <atomic>
 #include <mutex>
 #include <deque>
@@ -37,13 +38,13 @@ public:
     PodMonitor& operator=(const PodMonitor&) = delete;
 
     /**
-     * @brief 启动监控线程
+     * @brief 启动监控
      * @param pod  关联的 Pod 实例（非拥有，生命周期由调用方保证）
      * @param config 轮询配置
      */
     void start(IPod* pod, const PodMonitorConfig& config = {});
 
-    /** @brief 停止监控线程（阻塞至线程退出） */
+    /** @brief 停止监控（阻塞至进行中的一轮轮询结束） */
     void stop();
 
     /** @brief 是否正在运行 */
@@ -52,12 +53,12 @@ public:
     /** @brief 获取运行时状态快照（线程安全） */
     PodRuntimeStatus getRuntimeStatus() const;
 
-    /** @brief 更新轮询配置（线程安全，下一轮循环生效） */
+    /** @brief 更新轮询配置（线程安全，下一轮生效；poll_interval_ms 变化时重新注册定时器） */
     void updateConfig(const PodMonitorConfig& config);
 
 private:
-    /** @brief 监控主循环 */
-    void monitorLoop();
+    /** @brief 一轮轮询（定时器回调） */
+    void pollOnce();
 
     /** @brief 轮询状态/在线检测 */
     void pollStatus();
@@ -84,9 +85,16 @@ private:
     mutable std::mutex  status_mutex_;      // 保护 runtime_status_ + online_history_
     mutable std::mutex  config_mutex_;      // 保护 config_
 
-    std::thread         monitor_thread_;
+    std::mutex          timer_mutex_;       // 保护 timer_id_（不可在 pollOnce 中获取）
+    my_executor::TimerId timer_id_ = 0;
     std::atomic<bool>   running_{false};
 
+    // 各能力上次轮询时间（仅 pollOnce 访问，同一时刻只有一个回调在执行）
+    uint64_t            last_status_time_ = 0;
+    uint64_t            last_ptz_time_    = 0;
+    uint64_t            last_laser_time_  = 0;
+    uint64_t            last_stream_time_ = 0;
+
     std::deque<bool>    online_history_;     // 在线检测滑动窗口
 };
 
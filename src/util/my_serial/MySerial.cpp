@@ -342,6 +342,24 @@ size_t MySerial::Write(const std::vector<uint8_t>& data, std::string* err) {
     return written;
 }
 
+size_t MySerial::Write(const uint8_t* data, size_t len, std::string* err) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t written = 0;
+    ExecuteWithError(err, last_error_, [this, data, len, &written]() {
+        if (!initialized_ || !serial_) {
+            throw std::runtime_error("MySerial is not initialized");
+        }
+        if (!serial_->isOpen()) {
+            throw std::runtime_error("Serial port is not open");
+        }
+        if (data == nullptr || len == 0) {
+            return;
+        }
+        written = serial_->write(data, len);
+    });
+    return written;
+}
+
 std::string MySerial::Read(size_t size, std::string* err) {
     std::lock_guard<std::mutex> lock(mutex_);
     std::string result;
@@ -374,6 +392,24 @@ std::vector<uint8_t> MySerial::ReadBytes(size_t size, std::string* err) {
     return result;
 }
 
+size_t MySerial::ReadInto(uint8_t* buf, size_t size, std::string* err) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t read_size = 0;
+    ExecuteWithError(err, last_error_, [this, buf, size, &read_size]() {
+        if (!initialized_ || !serial_) {
+            throw std::runtime_error("MySerial is not initialized");
+        }
+        if (!serial_->isOpen()) {
+            throw std::runtime_error("Serial port is not open");
+        }
+        if (buf == nullptr || size == 0) {
+            return;
+        }
+        read_size = serial_->read(buf, size);
+    });
+    return read_size;
+}
+
 std::string MySerial::ReadLine(size_t max_size, const std::string& eol, std::string* err) {
     std::lock_guard<std::mutex> lock(mutex_);
     std::string result;
@@ -60,8 +60,12 @@ public:
 
     size_t Write(const std::string& data, std::string* err = nullptr);
     size_t Write(const std::vector<uint8_t>& data, std::string* err = nullptr);
+    // 直接写出调用方缓冲区（定长帧在栈上编码后发送，避免每次分配）
+    size_t Write(const uint8_t* data, size_t len, std::string* err = nullptr);
     std::string Read(size_t size, std::string* err = nullptr);
     std::vector<uint8_t> ReadBytes(size_t size, std::string* err = nullptr);
+    // 直接读入调用方提供的缓冲区，返回实际读取字节数（接收热路径使用，避免每次分配）
+    size_t ReadInto(uint8_t* buf, size_t size, std::string* err = nullptr);
     std::string ReadLine(size_t max_size = 65536, const std::string& eol = "\n", std::string* err = nullptr);
     size_t Available(std::string* err = nullptr) const;
     std::vector<nlohmann::json> ListAvailablePorts() const;
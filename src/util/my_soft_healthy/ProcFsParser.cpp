@@ -0,0 +1,180 @@
+#include "ProcFsParser.h"
+
+namespace MySoftHealthy {
+
+namespace {
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+inline bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n'; }
+
+// 解析 [p, end) 开头的无符号整数（允许前导空白），p 前移到数字之后
+bool scan_u64(const char*& p, const char* end, uint64_t& out) {
+  while (p < end && is_space(*p)) ++p;
+  if (p >= end || !is_digit(*p)) return false;
+  uint64_t v = 0;
+  while (p < end && is_digit(*p)) {
+    v = v * 10 + static_cast<uint64_t>(*p - '0');
+    ++p;
+  }
+  out = v;
+  return true;
+}
+
+bool scan_i64(const char*& p, const char* end, int64_t& out) {
+  while (p < end && is_space(*p)) ++p;
+  bool neg = false;
+  if (p < end && *p == '-') { neg = true; ++p; }
+  uint64_t v = 0;
+  if (!scan_u64(p, end, v)) return false;
+  out = neg ? -static_cast<int64_t>(v) : static_cast<int64_t>(v);
+  return true;
+}
+
+// 行首匹配 "key:"，成功时 p 指向冒号之后
+bool match_key(const char*& p, const char* end, std::string_view key) {
+  if (static_cast<size_t>(end - p) <= key.size()) return false;
+  if (std::string_view(p, key.size()) != key || p[key.size()] != ':') return false;
+  p += key.size() + 1;
+  return true;
+}
+
+inline const char* next_line(const char* p, const char* end) {
+  while (p < end && *p != '\n') ++p;
+  return p < end ? p + 1 : end;
+}
+
+} // namespace
+
+bool parse_proc_stat(std::string_view text, ProcStatFields& out) {
+  const char* begin = text.data();
+  const char* end = begin + text.size();
+
+  // comm 可能包含 ')'，所以右括号取最后一个
+  size_t lparen = text.find('(');
+  size_t rparen = text.rfind(')');
+  if (lparen == std::string_view::npos || rparen == std::string_view::npos || rparen <= lparen) return false;
+
+  const char* p = begin;
+  int64_t pid = 0;
+  if (!scan_i64(p, begin + lparen, pid)) return false;
+  out.pid = static_cast<int>(pid);
+  out.comm = text.substr(lparen + 1, rparen - lparen - 1);
+
+  p = begin + rparen + 1;
+  int field = 3;
+  while (p < end) {
+    while (p < end && is_space(*p)) ++p;
+    if (p >= end) break;
+    if (field == 3) {
+      out.state = *p;
+      while (p < end && !is_space(*p)) ++p;
+    } else {
+      int64_t v = 0;
+      if (!scan_i64(p, end, v)) {
+        // 非数字字段（不应出现），跳过整个 token
+        while (p < end && !is_space(*p)) ++p;
+      } else {
+        switch (field) {
+          case 4:  out.ppid = static_cast<int>(v); break;
+          case 14: out.utime = static_cast<uint64_t>(v); break;
+          case 15: out.stime = static_cast<uint64_t>(v); break;
+          case 18: out.priority = static_cast<int>(v); break;
+          case 19: out.nice = static_cast<int>(v); break;
+          case 20: out.num_threads = static_cast<uint32_t>(v); break;
+          case 22: out.start_time = static_cast<uint64_t>(v); break;
+          case 39: out.processor = static_cast<int>(v); break;
+          default: break;
+        }
+      }
+    }
+    if (field == 39) return true;
+    ++field;
+  }
+  return field > 22;
+}
+
+void parse_proc_status(std::string_view text, ProcStatusFields& out) {
+  const char* p = text.data();
+  const char* end = p + text.size();
+  while (p < end) {
+    const char* q = p;
+    switch (*p) {
+      case 'V':
+        if (match_key(q, end, "VmRSS")) out.has_vm_rss = scan_u64(q, end, out.vm_rss_kb);
+        else if (match_key(q, end, "VmSize")) out.has_vm_size = scan_u64(q, end, out.vm_size_kb);
+        break;
+      case 'v':
+        if (match_key(q, end, "voluntary_ctxt_switches")) out.has_ctx = scan_u64(q, end, out.voluntary_ctxt_switches);
+        break;
+      case 'n':
+        // 该行在 status 的末尾，读到后即可结束
+        if (match_key(q, end, "nonvoluntary_ctxt_switches")) {
+          scan_u64(q, end, out.nonvoluntary_ctxt_switches);
+          return;
+        }
+        break;
+      default:
+        break;
+    }
+    p = next_line(q, end);
+  }
+}
+
+bool parse_proc_io(std::string_view text, ProcIoFields& out) {
+  const char* p = text.data();
+  const char* end = p + text.size();
+  int found = 0;
+  while (p < end) {
+    const char* q = p;
+    if (match_key(q, end, "rchar")) found += scan_u64(q, end, out.rchar);
+    else if (match_key(q, end, "wchar")) found += scan_u64(q, end, out.wchar);
+    else if (match_key(q, end, "read_bytes")) found += scan_u64(q, end, out.read_bytes);
+    else if (match_key(q, end, "write_bytes")) found += scan_u64(q, end, out.write_bytes);
+    p = next_line(q, end);
+  }
+  return found == 4;
+}
+
+bool parse_host_cpu_total(std::string_view text, uint64_t& out_total) {
+  if (text.size() < 4 || text.substr(0, 4) != "cpu ") return false;
+  const char* p = text.data() + 4;
+  const char* end = text.data() + text.size();
+  const char* eol = p;
+  while (eol < end && *eol != '\n') ++eol;
+
+  uint64_t total = 0, v = 0;
+  int n = 0;
+  while (scan_u64(p, eol, v)) {
+    total += v;
+    ++n;
+  }
+  if (n == 0) return false;
+  out_total = total;
+  return true;
+}
+
+bool parse_loadavg_last_pid(std::string_view text, int& out_last_pid) {
+  // 格式："0.00 0.01 0.05 1/123 4567"
+  const char* p = text.data();
+  const char* end = p + text.size();
+  for (int skip = 0; skip < 4; ++skip) {
+    while (p < end && is_space(*p)) ++p;
+    while (p < end && !is_space(*p)) ++p;
+  }
+  uint64_t v = 0;
+  if (!scan_u64(p, end, v)) return false;
+  out_last_pid = static_cast<int>(v);
+  return true;
+}
+
+int parse_pid_name(const char* name) {
+  if (!name || !is_digit(*name)) return -1;
+  int v = 0;
+  for (; *name; ++name) {
+    if (!is_digit(*name)) return -1;
+    v = v * 10 + (*name - '0');
+  }
+  return v;
+}
+
+} // namespace MySoftHealthy
@@ -0,0 +1,61 @@
+#pragma once
+// /proc 文本解析（零分配）：在调用方提供的缓冲区上直接扫描字段，不构造 string / stringstream
+// 所有 string_view 输出都指向输入文本，生命周期与输入缓冲区一致
+#include <cstdint>
+#include <string_view>
+
+namespace MySoftHealthy {
+
+// /proc/<pid>/stat 与 /proc/<pid>/task/<tid>/stat 中关心的字段（字段编号见 proc(5)）
+struct ProcStatFields {
+  int pid = 0;                 // 1
+  std::string_view comm;       // 2（去掉括号，可能包含空格和括号）
+  char state = '?';            // 3
+  int ppid = -1;               // 4
+  uint64_t utime = 0;          // 14
+  uint64_t stime = 0;          // 15
+  int priority = 0;            // 18
+  int nice = 0;                // 19
+  uint32_t num_threads = 0;    // 20
+  uint64_t start_time = 0;     // 22
+  int processor = -1;          // 39
+};
+
+// /proc/<pid>/status 中关心的字段（数值原样保留，单位 kB 的字段不做换算）
+struct ProcStatusFields {
+  bool has_vm_rss = false;
+  bool has_vm_size = false;
+  bool has_ctx = false;
+  uint64_t vm_rss_kb = 0;
+  uint64_t vm_size_kb = 0;
+  uint64_t voluntary_ctxt_switches = 0;
+  uint64_t nonvoluntary_ctxt_switches = 0;
+};
+
+// /proc/<pid>/io
+struct ProcIoFields {
+  uint64_t rchar = 0;
+  uint64_t wchar = 0;
+  uint64_t read_bytes = 0;
+  uint64_t write_bytes = 0;
+};
+
+// 解析 stat 行；comm 以最后一个 ')' 为界，字段不足 22 个时返回 false
+bool parse_proc_stat(std::string_view text, ProcStatFields& out);
+
+// 解析 status；只识别 VmRSS / VmSize / (non)voluntary_ctxt_switches，其余行跳过
+void parse_proc_status(std::string_view text, ProcStatusFields& out);
+
+// 解析 io；四个字段都出现时返回 true
+bool parse_proc_io(std::string_view text, ProcIoFields& out);
+
+// 解析 /proc/stat 首行 "cpu ..." 的 jiffies 总和
+bool parse_host_cpu_total(std::string_view text, uint64_t& out_total);
+
+// 解析 /proc/loadavg 第 5 列（最近一次创建的 pid/tid），用于判断是否有新任务出现
+bool parse_loadavg_last_pid(std::string_view text, int& out_last_pid);
+
+// 纯数字目录名（readdir 得到的 pid/tid）转 int，非数字返回 -1
+int parse_pid_name(const char* name);
+
+} // namespace MySoftHealthy
@@ -0,0 +1,611 @@
+#include "ProcFsSampler.h"
+#include "ProcFsParser.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "MyLog.h"
+
+namespace MySoftHealthy {
+
+namespace {
+
+// /proc/stat 只需要首行 "cpu ..."，不必读完后面很长的 intr 行
+constexpr size_t kHostStatPrefix = 512;
+
+const char* sched_policy_name(int pol) {
+  switch (pol) {
+    case SCHED_OTHER: return "OTHER";
+    case SCHED_FIFO: return "FIFO";
+    case SCHED_RR: return "RR";
+#ifdef SCHED_BATCH
+    case SCHED_BATCH: return "BATCH";
+#endif
+#ifdef SCHED_IDLE
+    case SCHED_IDLE: return "IDLE";
+#endif
+#ifdef SCHED_DEADLINE
+    case SCHED_DEADLINE: return "DEADLINE";
+#endif
+    default: return "UNKNOWN";
+  }
+}
+
+// cmdline 以 '\0' 分隔参数，转为空格并去掉末尾空白
+void assign_cmdline(std::string& dst, std::string_view raw) {
+  dst.assign(raw.data(), raw.size());
+  std::replace(dst.begin(), dst.end(), '\0', ' ');
+  while (!dst.empty() && (dst.back() == ' ' || dst.back() == '\n')) dst.pop_back();
+}
+
+} // namespace
+
+ProcFsSampler::ProcFsSampler() : buf_(16 * 1024) {}
+
+ProcFsSampler::~ProcFsSampler() {
+  reset();
+}
+
+ProcFsSamplerStats ProcFsSampler::stats() const {
+  ProcFsSamplerStats s = stats_;
+  s.known_pids = static_cast<uint32_t>(pids_.size());
+  return s;
+}
+
+void ProcFsSampler::reset() {
+  for (auto& kv : procs_) close_proc(kv.second);
+  procs_.clear();
+  close_fd(host_stat_fd_);
+  close_fd(loadavg_fd_);
+  if (proc_dir_) {
+    closedir(proc_dir_);
+    proc_dir_ = nullptr;
+    proc_fd_ = -1;
+    --stats_.cached_fds;
+  }
+  pids_.clear();
+  children_.clear();
+  children_dirty_ = true;
+  target_key_.clear();
+  last_pid_ = -1;
+  cycles_since_full_ = 0;
+}
+
+// ============================================================================
+// fd / 读取
+// ============================================================================
+
+bool ProcFsSampler::pread_into_buf(int fd, std::string_view& out, size_t limit) {
+  size_t cap = limit ? std::min(limit, buf_.size()) : buf_.size();
+  for (;;) {
+    ssize_t n = ::pread(fd, buf_.data(), cap, 0);
+    ++stats_.reads;
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    // 读满说明缓冲区可能不够（limit 模式下只要前缀）
+    if (limit || static_cast<size_t>(n) < cap) {
+      out = std::string_view(buf_.data(), static_cast<size_t>(n));
+      return n > 0;
+    }
+    buf_.resize(buf_.size() * 2);
+    cap = buf_.size();
+  }
+}
+
+bool ProcFsSampler::read_cached(int& slot, int dir_fd, const char* name, std::string_view& out, size_t limit) {
+  if (slot >= 0) {
+    if (pread_into_buf(slot, out, limit)) return true;
+    // 目标已退出（ESRCH）或无权限，关闭后由调用方决定是否回收
+    close_fd(slot);
+    return false;
+  }
+  int fd = ::openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+  ++stats_.opens;
+  if (fd < 0) return false;
+  bool ok = pread_into_buf(fd, out, limit);
+  if (ok && stats_.cached_fds < fd_budget_) {
+    slot = fd;
+    ++stats_.cached_fds;
+  } else {
+    ::close(fd);
+  }
+  return ok;
+}
+
+bool ProcFsSampler::read_once(int dir_fd, const char* name, std::string_view& out) {
+  int fd = ::openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+  ++stats_.opens;
+  if (fd < 0) return false;
+  bool ok = pread_into_buf(fd, out, 0);
+  ::close(fd);
+  return ok;
+}
+
+void ProcFsSampler::close_fd(int& fd) {
+  if (fd < 0) return;
+  ::close(fd);
+  fd = -1;
+  --stats_.cached_fds;
+}
+
+void ProcFsSampler::close_task(TaskEntry& t) {
+  close_fd(t.stat_fd);
+  close_fd(t.status_fd);
+  close_fd(t.io_fd);
+}
+
+void ProcFsSampler::close_proc(ProcEntry& e) {
+  for (auto& t : e.tasks) close_task(t);
+  e.tasks.clear();
+  if (e.task_dir) {
+    closedir(e.task_dir);
+    e.task_dir = nullptr;
+    --stats_.cached_fds;
+  }
+  close_fd(e.stat_fd);
+  close_fd(e.status_fd);
+  close_fd(e.io_fd);
+  close_fd(e.dir_fd);
+}
+
+// ============================================================================
+// pid 表
+// ============================================================================
+
+bool ProcFsSampler::ensure_proc_root() {
+  if (proc_dir_) return true;
+  int fd = ::open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  ++stats_.opens;
+  if (fd < 0) return false;
+  proc_dir_ = fdopendir(fd);
+  if (!proc_dir_) {
+    ::close(fd);
+    return false;
+  }
+  proc_fd_ = fd;
+  ++stats_.cached_fds;
+  return true;
+}
+
+void ProcFsSampler::update_target(const SoftHealthMonitorConfig& cfg) {
+  std::string key;
+  if (cfg.target_pid) key = "pid:" + std::to_string(*cfg.target_pid);
+  else if (cfg.target_name) key = "name:" + *cfg.target_name;
+  else if (cfg.target_cmdline_regex) key = "regex:" + *cfg.target_cmdline_regex;
+  if (key == target_key_) return;
+
+  MYLOG_INFO("ProcFsSampler: 目标变化 [{}] -> [{}]，重建 pid 表", target_key_, key);
+  target_key_ = std::move(key);
+  target_pid_ = cfg.target_pid;
+  target_name_.reset();
+  target_regex_.reset();
+  if (!cfg.target_pid) {
+    if (cfg.target_name) {
+      target_name_ = cfg.target_name;
+    } else if (cfg.target_cmdline_regex) {
+      try {
+        target_regex_ = std::make_unique<std::regex>(*cfg.target_cmdline_regex, std::regex::ECMAScript);
+      } catch (const std::exception& e) {
+        MYLOG_WARN("命令行正则编译失败：{}", e.what());
+      }
+    }
+  }
+  // root 标记依赖目标，全部 pid 重新评估
+  pids_.clear();
+  children_dirty_ = true;
+}
+
+bool ProcFsSampler::poll_new_tasks() {
+  std::string_view txt;
+  int last_pid = -1;
+  if (!read_cached(loadavg_fd_, proc_fd_, "loadavg", txt) || !parse_loadavg_last_pid(txt, last_pid)) {
+    return true; // 读不到 loadavg 时退化为每轮扫描
+  }
+  if (last_pid == last_pid_) return false;
+  last_pid_ = last_pid;
+  return true;
+}
+
+bool ProcFsSampler::match_root(int pid, std::string_view comm) {
+  if (target_name_) {
+    if (comm != *target_name_) return false;
+    MYLOG_INFO("按 target_name 解析到 root 进程 pid={} comm={}", pid, comm);
+    return true;
+  }
+  if (target_regex_) {
+    char path[32];
+    std::snprintf(path, sizeof(path), "%d/cmdline", pid);
+    std::string_view raw;
+    if (!read_once(proc_fd_, path, raw)) return false;
+    std::string cmd;
+    assign_cmdline(cmd, raw);
+    if (cmd.empty() || !std::regex_search(cmd, *target_regex_)) return false;
+    MYLOG_INFO("按 target_cmdline_regex 解析到 root 进程 pid={} cmd={}", pid, cmd);
+    return true;
+  }
+  return false;
+}
+
+void ProcFsSampler::rescan_pids(bool full) {
+  ++stats_.pid_rescans;
+  if (full) ++stats_.full_rescans;
+  ++scan_seq_;
+
+  char path[32];
+  rewinddir(proc_dir_);
+  while (dirent* ent = readdir(proc_dir_)) {
+    int pid = parse_pid_name(ent->d_name);
+    if (pid <= 0) continue;
+    auto res = pids_.try_emplace(pid);
+    PidInfo& info = res.first->second;
+    info.seen_scan = scan_seq_;
+    bool inserted = res.second;
+    // 已知 pid 只在全量刷新时重读；正在跟踪的进程每轮都会读自己的 stat，无需在这里读
+    if (!inserted && (!full || procs_.count(pid))) continue;
+
+    std::snprintf(path, sizeof(path), "%d/stat", pid);
+    std::string_view txt;
+    ProcStatFields f;
+    if (!read_once(proc_fd_, path, txt) || !parse_proc_stat(txt, f)) {
+      pids_.erase(res.first);
+      continue;
+    }
+    if (info.ppid != f.ppid) {
+      info.ppid = f.ppid;
+      children_dirty_ = true;
+    }
+    if (inserted) info.root = match_root(pid, f.comm);
+  }
+
+  for (auto it = pids_.begin(); it != pids_.end();) {
+    if (it->second.seen_scan != scan_seq_) {
+      it = pids_.erase(it);
+      children_dirty_ = true;
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::vector<int> ProcFsSampler::resolve_roots() const {
+  std::vector<int> roots;
+  if (target_pid_) {
+    roots.push_back(*target_pid_);
+    return roots;
+  }
+  for (const auto& kv : pids_) {
+    if (kv.second.root) roots.push_back(kv.first);
+  }
+  std::sort(roots.begin(), roots.end());
+  return roots;
+}
+
+void ProcFsSampler::rebuild_children() {
+  if (!children_dirty_) return;
+  for (auto& kv : children_) kv.second.clear();
+  for (const auto& kv : pids_) children_[kv.second.ppid].push_back(kv.first);
+  children_dirty_ = false;
+}
+
+std::vector<int> ProcFsSampler::collect_subtree(const std::vector<int>& roots) {
+  rebuild_children();
+  std::vector<int> res;
+  std::vector<int> stack = roots;
+  while (!stack.empty()) {
+    int pid = stack.back();
+    stack.pop_back();
+    if (std::find(res.begin(), res.end(), pid) != res.end()) continue;
+    res.push_back(pid);
+    auto it = children_.find(pid);
+    if (it != children_.end()) stack.insert(stack.end(), it->second.begin(), it->second.end());
+  }
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+// ============================================================================
+// 进程 / 线程
+// ============================================================================
+
+bool ProcFsSampler::sample_process(ProcEntry& e, const SoftHealthMonitorConfig& cfg, ProcessSnapshot& ps) {
+  if (e.dir_fd < 0) {
+    char path[16];
+    std::snprintf(path, sizeof(path), "%d", e.pid);
+    e.dir_fd = ::openat(proc_fd_, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    ++stats_.opens;
+    if (e.dir_fd < 0) return false;
+    ++stats_.cached_fds;
+  }
+
+  std::string_view txt;
+  ProcStatFields f;
+  if (!read_cached(e.stat_fd, e.dir_fd, "stat", txt) || !parse_proc_stat(txt, f)) return false;
+
+  ps.pid = e.pid;
+  ps.ppid = f.ppid;
+  ps.state = f.state;
+  ps.utime_ticks = f.utime;
+  ps.stime_ticks = f.stime;
+  ps.start_time_ticks = f.start_time;
+  ps.threads_count = f.num_threads;
+
+  // cmdline 只在首次或 comm 变化（通常意味着 exec）时重读
+  if (f.comm != e.comm) {
+    e.comm.assign(f.comm.data(), f.comm.size());
+    e.cmdline.clear();
+    if (read_once(e.dir_fd, "cmdline", txt)) assign_cmdline(e.cmdline, txt);
+  }
+  ps.name = e.comm;
+  ps.cmdline = e.cmdline;
+
+  if (read_cached(e.status_fd, e.dir_fd, "status", txt)) {
+    ProcStatusFields s;
+    parse_proc_status(txt, s);
+    if (s.has_vm_rss) ps.vm_rss_bytes = s.vm_rss_kb * 1024ULL;
+    if (s.has_vm_size) ps.vm_size_bytes = s.vm_size_kb * 1024ULL;
+    if (cfg.include_ctx_switches && s.has_ctx) {
+      ps.voluntary_ctxt_switches = s.voluntary_ctxt_switches;
+      ps.nonvoluntary_ctxt_switches = s.nonvoluntary_ctxt_switches;
+    }
+  }
+
+  if (cfg.include_proc_io && !e.io_denied) {
+    ProcIoFields io;
+    if (read_cached(e.io_fd, e.dir_fd, "io", txt) && parse_proc_io(txt, io)) {
+      ps.io_rchar = io.rchar;
+      ps.io_wchar = io.wchar;
+      ps.io_read_bytes = io.read_bytes;
+      ps.io_write_bytes = io.write_bytes;
+    } else {
+      e.io_denied = true;
+    }
+  }
+  return true;
+}
+
+void ProcFsSampler::rescan_tasks(ProcEntry& e) {
+  ++stats_.task_rescans;
+  tid_buf_.clear();
+  rewinddir(e.task_dir);
+  while (dirent* ent = readdir(e.task_dir)) {
+    int tid = parse_pid_name(ent->d_name);
+    if (tid > 0) tid_buf_.push_back(tid);
+  }
+  std::sort(tid_buf_.begin(), tid_buf_.end());
+
+  // 与现有条目按 tid 归并：保留仍存在线程的 fd，关闭已退出线程的 fd
+  std::vector<TaskEntry> merged;
+  merged.reserve(tid_buf_.size());
+  size_t j = 0;
+  for (int tid : tid_buf_) {
+    while (j < e.tasks.size() && e.tasks[j].tid < tid) close_task(e.tasks[j++]);
+    if (j < e.tasks.size() && e.tasks[j].tid == tid) {
+      merged.push_back(std::move(e.tasks[j++]));
+    } else {
+      TaskEntry t;
+      t.tid = tid;
+      merged.push_back(std::move(t));
+    }
+  }
+  for (; j < e.tasks.size(); ++j) close_task(e.tasks[j]);
+  e.tasks.swap(merged);
+  e.tasks_dirty = false;
+}
+
+void ProcFsSampler::sample_threads(ProcEntry& e, uint32_t num_threads, const SoftHealthMonitorConfig& cfg,
+                                   const std::unordered_map<int, uint64_t>* prev_tid_ticks,
+                                   uint64_t host_delta, int num_cpus,
+                                   std::unordered_map<int, uint64_t>& out_ticks,
+                                   std::vector<ThreadSnapshot>& out_top) {
+  if (!e.task_dir) {
+    int fd = ::openat(e.dir_fd, "task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    ++stats_.opens;
+    if (fd < 0) return;
+    e.task_dir = fdopendir(fd);
+    if (!e.task_dir) {
+      ::close(fd);
+      return;
+    }
+    ++stats_.cached_fds;
+    e.tasks_dirty = true;
+  }
+  if (e.tasks_dirty || e.tasks.size() != num_threads) rescan_tasks(e);
+
+  const int task_fd = dirfd(e.task_dir);
+  char path[32];
+  std::string_view txt;
+
+  // 阶段一：每个线程的 stat 只读一次，得到 ticks 并计算 delta
+  order_.clear();
+  out_ticks.reserve(e.tasks.size());
+  for (size_t i = 0; i < e.tasks.size(); ++i) {
+    TaskEntry& t = e.tasks[i];
+    ProcStatFields f;
+    if (t.stat_fd < 0) std::snprintf(path, sizeof(path), "%d/stat", t.tid);
+    if (!read_cached(t.stat_fd, task_fd, path, txt) || !parse_proc_stat(txt, f)) {
+      // 线程已退出，下一轮重新列举 task 目录
+      close_task(t);
+      e.tasks_dirty = true;
+      continue;
+    }
+    t.utime = f.utime;
+    t.stime = f.stime;
+    t.state = f.state;
+    t.priority = f.priority;
+    t.nice = f.nice;
+    if (f.comm != t.comm) t.comm.assign(f.comm.data(), f.comm.size());
+
+    uint64_t ticks = f.utime + f.stime;
+    uint64_t prev = 0;
+    if (prev_tid_ticks) {
+      auto it = prev_tid_ticks->find(t.tid);
+      if (it != prev_tid_ticks->end()) prev = it->second;
+    }
+    t.delta = (ticks >= prev) ? (ticks - prev) : 0;
+    out_ticks[t.tid] = ticks;
+    order_.push_back(static_cast<int>(i));
+  }
+  stats_.sampled_threads += static_cast<uint32_t>(order_.size());
+
+  // 阶段二：选 topN，只对入选线程读 status / io
+  int topn = cfg.threads_topn;
+  if (topn == 0 || order_.empty()) return;
+  if (topn < 0 || topn > static_cast<int>(order_.size())) topn = static_cast<int>(order_.size());
+
+  auto by_delta = [&](int a, int b) {
+    const TaskEntry& x = e.tasks[a];
+    const TaskEntry& y = e.tasks[b];
+    if (x.delta != y.delta) return x.delta > y.delta;
+    return x.utime + x.stime > y.utime + y.stime;
+  };
+  std::partial_sort(order_.begin(), order_.begin() + topn, order_.end(), by_delta);
+
+  out_top.reserve(topn);
+  for (int k = 0; k < topn; ++k) {
+    TaskEntry& t = e.tasks[order_[k]];
+    ThreadSnapshot ts;
+    ts.tid = t.tid;
+    ts.name = t.comm;
+    ts.state = t.state;
+    ts.priority = t.priority;
+    ts.nice = t.nice;
+    int pol = sched_getscheduler(t.tid);
+    ts.policy = pol == -1 ? "UNKNOWN" : sched_policy_name(pol);
+    ts.utime_ticks = t.utime;
+    ts.stime_ticks = t.stime;
+    if (host_delta > 0) {
+      double pct_machine = (double)t.delta / (double)host_delta * 100.0;
+      ts.cpu_pct_machine = pct_machine;
+      ts.cpu_pct_core = pct_machine * num_cpus;
+    }
+
+    if (cfg.include_ctx_switches) {
+      if (t.status_fd < 0) std::snprintf(path, sizeof(path), "%d/status", t.tid);
+      if (read_cached(t.status_fd, task_fd, path, txt)) {
+        ProcStatusFields s;
+        parse_proc_status(txt, s);
+        if (s.has_ctx) {
+          ts.voluntary_ctxt_switches = s.voluntary_ctxt_switches;
+          ts.nonvoluntary_ctxt_switches = s.nonvoluntary_ctxt_switches;
+        }
+      }
+    }
+
+    if (cfg.include_thread_io) {
+      if (t.io_fd < 0) std::snprintf(path, sizeof(path), "%d/io", t.tid);
+      ProcIoFields io;
+      if (read_cached(t.io_fd, task_fd, path, txt) && parse_proc_io(txt, io)) {
+        ts.rchar = io.rchar;
+        ts.wchar = io.wchar;
+        ts.read_bytes = io.read_bytes;
+        ts.write_bytes = io.write_bytes;
+      }
+    }
+
+    out_top.push_back(std::move(ts));
+  }
+}
+
+// ============================================================================
+// 一轮采样
+// ============================================================================
+
+void ProcFsSampler::sample(SoftHealthSnapshot& snap, const SoftHealthMonitorConfig& cfg, const SoftHealthSnapshot* prev) {
+  auto t0 = std::chrono::steady_clock::now();
+  ++cycle_;
+  ++stats_.cycles;
+  stats_.sampled_threads = 0;
+  fd_budget_ = cfg.max_cached_fds > 0 ? static_cast<uint32_t>(cfg.max_cached_fds) : 0;
+
+  if (!ensure_proc_root()) {
+    MYLOG_ERROR("ProcFsSampler: 打开 /proc 失败，errno={}", errno);
+    return;
+  }
+  update_target(cfg);
+
+  std::string_view txt;
+  uint64_t host_total = 0;
+  if (read_cached(host_stat_fd_, proc_fd_, "stat", txt, kHostStatPrefix)) {
+    parse_host_cpu_total(txt, host_total);
+  }
+  snap.host.total_cpu_jiffies = host_total;
+  uint64_t prev_total = prev ? prev->host.total_cpu_jiffies : 0;
+  uint64_t host_delta = (prev && prev_total > 0 && host_total >= prev_total) ? (host_total - prev_total) : 0;
+
+  // pid 表：有新任务创建时增量扫描，每 rescan_every_cycles 轮全量刷新
+  bool full = pids_.empty() || (cfg.rescan_every_cycles > 0 && ++cycles_since_full_ >= cfg.rescan_every_cycles);
+  bool changed = poll_new_tasks();
+  if (full || changed) rescan_pids(full);
+  if (full) cycles_since_full_ = 0;
+
+  snap.roots = resolve_roots();
+  if (snap.roots.empty()) {
+    MYLOG_WARN("ProcFsSampler: 未解析到任何 root 进程");
+  }
+
+  std::vector<int> subtree = collect_subtree(snap.roots);
+  for (int pid : subtree) {
+    auto res = procs_.try_emplace(pid);
+    ProcEntry& e = res.first->second;
+    e.pid = pid;
+    e.seen_cycle = cycle_;
+
+    ProcessSnapshot ps;
+    if (!sample_process(e, cfg, ps)) {
+      MYLOG_DEBUG("ProcFsSampler: pid={} 已退出", pid);
+      close_proc(e);
+      procs_.erase(res.first);
+      if (pids_.erase(pid)) children_dirty_ = true;
+      continue;
+    }
+
+    auto pit = pids_.find(pid);
+    if (pit != pids_.end() && pit->second.ppid != ps.ppid) {
+      pit->second.ppid = ps.ppid;
+      children_dirty_ = true;
+    }
+
+    const std::unordered_map<int, uint64_t>* prev_tid_ticks = nullptr;
+    if (prev) {
+      auto it = prev->pid_tid_ticks.find(pid);
+      if (it != prev->pid_tid_ticks.end()) prev_tid_ticks = &it->second;
+    }
+    sample_threads(e, ps.threads_count, cfg, prev_tid_ticks, host_delta, snap.host.num_cpus,
+                   snap.pid_tid_ticks[pid], ps.top_threads);
+    snap.processes[pid] = std::move(ps);
+  }
+
+  // 回收已离开子树（或已退出）的进程条目
+  for (auto it = procs_.begin(); it != procs_.end();) {
+    if (it->second.seen_cycle != cycle_) {
+      close_proc(it->second);
+      it = procs_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // 填充 children（只保留 subtree 中的 child）
+  rebuild_children();
+  for (auto& kv : snap.processes) {
+    auto it = children_.find(kv.first);
+    if (it == children_.end()) continue;
+    for (int ch : it->second) {
+      if (snap.processes.count(ch)) kv.second.children.push_back(ch);
+    }
+    std::sort(kv.second.children.begin(), kv.second.children.end());
+  }
+
+  stats_.tracked_pids = static_cast<uint32_t>(snap.processes.size());
+  stats_.last_cycle_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - t0).count());
+}
+
+} // namespace MySoftHealthy
@@ -0,0 +1,154 @@
+#pragma once
+// /proc 采样器（ProcFsSampler）
+// 替代 ProcessInfoCollector + ThreadInfoCollector 的逐轮 ifstream 读取：
+//   - /proc、/proc/<pid>、/proc/<pid>/task 的目录 fd 以及 stat/status/io 文件 fd 跨周期保留，
+//     每轮只做 pread(fd, buf, n, 0)，读入复用的缓冲区并用 ProcFsParser 零分配解析
+//   - 全量 pid 表只在 /proc/loadavg 的 last_pid 变化（有新任务创建）时增量扫描：只读新 pid 的 stat；
+//     每 rescan_every_cycles 轮做一次全量刷新，兜底 ppid 变化（孤儿进程被收养等）
+//   - task 目录只在线程数（stat 第 20 列）变化或有线程退出时重新列举
+//   - 每个 tid 的 stat 每轮只读一次，同时用于 pid_tid_ticks 与 topN 选择
+// 进程退出后其缓存 fd 读取返回 ESRCH，据此回收条目，也天然避免了 PID 复用串号。
+//
+// 非线程安全：由 SoftHealthMonitorManager 在 refresh 锁内串行调用。
+#include "SoftHealthMonitorConfig.h"
+#include "SoftHealthSnapshot.h"
+#include <dirent.h>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MySoftHealthy {
+
+struct ProcFsSamplerStats {
+  uint64_t cycles = 0;
+  uint64_t pid_rescans = 0;      // 增量扫描 /proc 的次数
+  uint64_t full_rescans = 0;     // 其中全量刷新 ppid 的次数
+  uint64_t task_rescans = 0;     // 重新列举 task 目录的次数
+  uint64_t opens = 0;            // 累计 open/openat 次数
+  uint64_t reads = 0;            // 累计 pread 次数
+  uint32_t cached_fds = 0;       // 当前持有的 fd 数（含目录 fd）
+  uint32_t known_pids = 0;       // pid 表大小
+  uint32_t tracked_pids = 0;     // 最近一轮采样的进程数
+  uint32_t sampled_threads = 0;  // 最近一轮采样的线程数
+  uint64_t last_cycle_us = 0;    // 最近一轮耗时
+};
+
+class ProcFsSampler {
+public:
+  ProcFsSampler();
+  ~ProcFsSampler();
+
+  ProcFsSampler(const ProcFsSampler&) = delete;
+  ProcFsSampler& operator=(const ProcFsSampler&) = delete;
+
+  // 完成一轮采样：填充 snap.host.total_cpu_jiffies、roots、processes（含 children / top_threads）
+  // 与 pid_tid_ticks。prev 为上一轮快照（可为空），用于线程 topN 的 delta 排序
+  void sample(SoftHealthSnapshot& snap, const SoftHealthMonitorConfig& cfg, const SoftHealthSnapshot* prev);
+
+  ProcFsSamplerStats stats() const;
+
+  // 关闭所有缓存 fd，下一轮重新建立
+  void reset();
+
+private:
+  struct TaskEntry {
+    int tid = 0;
+    int stat_fd = -1;
+    int status_fd = -1;
+    int io_fd = -1;
+
+    // 本轮 stat 结果
+    uint64_t utime = 0;
+    uint64_t stime = 0;
+    uint64_t delta = 0;       // 与 prev 的 ticks 差
+    char state = '?';
+    int priority = 0;
+    int nice = 0;
+    std::string comm;         // 仅在变化时重新赋值
+  };
+
+  struct ProcEntry {
+    int pid = 0;
+    int dir_fd = -1;          // /proc/<pid>
+    int stat_fd = -1;
+    int status_fd = -1;
+    int io_fd = -1;
+    DIR* task_dir = nullptr;  // /proc/<pid>/task
+    bool io_denied = false;   // io 无权限（非本用户进程），不再重试
+    bool tasks_dirty = true;
+    uint32_t seen_cycle = 0;
+    std::string comm;
+    std::string cmdline;
+    std::vector<TaskEntry> tasks;  // 按 tid 升序
+  };
+
+  struct PidInfo {
+    int ppid = -1;
+    bool root = false;        // 匹配 target_name / target_cmdline_regex
+    uint32_t seen_scan = 0;
+  };
+
+  // ---- fd / 读取 ----
+  // 读取 dir_fd 下的 name 到 buf_；slot < 0 时打开，fd 预算允许则缓存到 slot。limit > 0 时只读前 limit 字节
+  bool read_cached(int& slot, int dir_fd, const char* name, std::string_view& out, size_t limit = 0);
+  bool read_once(int dir_fd, const char* name, std::string_view& out);
+  bool pread_into_buf(int fd, std::string_view& out, size_t limit);
+  void close_fd(int& fd);
+  void close_task(TaskEntry& t);
+  void close_proc(ProcEntry& e);
+
+  // ---- pid 表 ----
+  bool ensure_proc_root();
+  void update_target(const SoftHealthMonitorConfig& cfg);
+  bool poll_new_tasks();
+  void rescan_pids(bool full);
+  bool match_root(int pid, std::string_view comm);
+  std::vector<int> resolve_roots() const;
+  void rebuild_children();
+  std::vector<int> collect_subtree(const std::vector<int>& roots);
+
+  // ---- 进程 / 线程 ----
+  bool sample_process(ProcEntry& e, const SoftHealthMonitorConfig& cfg, ProcessSnapshot& ps);
+  void rescan_tasks(ProcEntry& e);
+  void sample_threads(ProcEntry& e, uint32_t num_threads, const SoftHealthMonitorConfig& cfg,
+                      const std::unordered_map<int, uint64_t>* prev_tid_ticks,
+                      uint64_t host_delta, int num_cpus,
+                      std::unordered_map<int, uint64_t>& out_ticks,
+                      std::vector<ThreadSnapshot>& out_top);
+
+private:
+  int proc_fd_ = -1;               // /proc
+  DIR* proc_dir_ = nullptr;        // /proc 的目录流（rewinddir 复用）
+  int host_stat_fd_ = -1;          // /proc/stat
+  int loadavg_fd_ = -1;            // /proc/loadavg
+
+  std::vector<char> buf_;          // 复用读缓冲区（按需扩容）
+  std::vector<int> tid_buf_;       // task 目录列举时复用
+  std::vector<int> order_;         // 线程 topN 排序时复用
+
+  // 目标解析
+  std::string target_key_;
+  std::optional<int> target_pid_;
+  std::optional<std::string> target_name_;
+  std::unique_ptr<std::regex> target_regex_;
+
+  std::unordered_map<int, PidInfo> pids_;                 // 全部 pid -> ppid / 是否为 root
+  std::unordered_map<int, std::vector<int>> children_;    // ppid -> 子进程（pid 表变化后重建）
+  bool children_dirty_ = true;
+  int last_pid_ = -1;
+  uint32_t scan_seq_ = 0;
+  int cycles_since_full_ = 0;
+
+  std::unordered_map<int, ProcEntry> procs_;              // 子树内进程的缓存条目
+  uint32_t cycle_ = 0;
+  uint32_t fd_budget_ = 1024;
+
+  ProcFsSamplerStats stats_;
+};
+
+} // namespace MySoftHealthy
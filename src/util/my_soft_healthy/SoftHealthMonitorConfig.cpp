@@ -14,6 +14,8 @@ void generateSampleConfigByJson(const nlohmann::json& j, SoftHealthMonitorConfig
   if (j.contains("target_pid") && !j["target_pid"].is_null())                       cfg.target_pid            = j["target_pid"].get<int>();
   if (j.contains("target_name") && !j["target_name"].is_null())                     cfg.target_name           = j["target_name"].get<std::string>();
   if (j.contains("target_cmdline_regex") && !j["target_cmdline_regex"].is_null())   cfg.target_cmdline_regex  = j["target_cmdline_regex"].get<std::string>();
+  if (j.contains("rescan_every_cycles"))                                            cfg.rescan_every_cycles   = j["rescan_every_cycles"].get<int>();
+  if (j.contains("max_cached_fds"))                                                 cfg.max_cached_fds        = j["max_cached_fds"].get<int>();
 }
 
 
@@ -28,6 +30,8 @@ void ShowSoftHealthMonitorConfigAsJson(const SoftHealthMonitorConfig& cfg) {
   if (cfg.target_pid) j["target_pid"] = *cfg.target_pid;
   if (cfg.target_name) j["target_name"] = *cfg.target_name;
   if (cfg.target_cmdline_regex) j["target_cmdline_regex"] = *cfg.target_cmdline_regex;
+  j["rescan_every_cycles"] = cfg.rescan_every_cycles;
+  j["max_cached_fds"] = cfg.max_cached_fds;
 
   MYLOG_INFO("当前 SoftHealthMonitorConfig 配置:\n{}", j.dump(4));
   std::cout << "当前 SoftHealthMonitorConfig 配置:\n" << j.dump(4) << std::endl;
@@ -33,6 +33,11 @@ struct SoftHealthMonitorConfig {
   // 并发度 / 超时等（留作扩展/保护）
   int max_concurrent_probes = 4;
   int per_pid_timeout_ms = 2000;
+
+  // /proc 采样器：每隔多少轮全量刷新一次 pid 表的 ppid（<=0 表示只在有新任务时增量扫描）
+  int rescan_every_cycles = 12;
+  // 采样器跨周期缓存的 fd 上限，超出后退化为每次 open/close
+  int max_cached_fds = 1024;
 };
 
 
@@ -3,8 +3,7 @@
 // 使用 atomic shared_ptr<const SoftHealthSnapshot> 发布不可变快照，保证并发读取安全
 #include "SoftHealthMonitorConfig.h"
 #include "SoftHealthSnapshot.h"
-#include "ProcessInfoCollector.h"
-#include "ThreadInfoCollector.h"
+#include "ProcFsSampler.h"
 #include "ResourceUsageAnalyzer.h"
 #include <atomic>
 #include <condition_variable>
@@ -40,9 +39,12 @@ public:
     applyConfig(cfg);
   }
 
-  // 立即触发一次采样并返回快照（阻塞）
+  // 立即触发一次采样并返回快照（阻塞；与后台 loop 串行）
   std::shared_ptr<const SoftHealthSnapshot> refresh_now();
 
+  // 采样器统计（fd 缓存、扫描次数、最近一轮耗时）
+  ProcFsSamplerStats getSamplerStats() const;
+
   // 非阻塞获取当前快照（shared_ptr 保证线程安全）
   std::shared_ptr<const SoftHealthSnapshot> getData() const;
 
@@ -56,9 +58,9 @@ private:
 
 private:
   SoftHealthMonitorConfig     cfg_;
-  ProcessInfoCollector        proc_col_;
-  ThreadInfoCollector         thread_col_;
+  ProcFsSampler               sampler_;
   ResourceUsageAnalyzer       analyzer_;
+  mutable std::mutex          refresh_mtx_;   // 串行化 refresh_now（sampler_ / prev_snapshot_ 非线程安全）
 
   // 使用普通的 shared_ptr 存储当前 snapshot，并通过 std::atomic_store / std::atomic_load
   // 保证并发替换/读取的原子性（避免使用 std::atomic<std::shared_ptr<...>>，
@@ -88,6 +88,34 @@ float CPUInfoTools::getUsagePercent(const std::string& oneCPUInfo) {
     }
 }
 
+std::vector<CPUTicks> CPUInfoTools::CollectCPUTicks() {
+    std::vector<CPUTicks> ticks;
+    std::ifstream file("/proc/stat");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind("cpu", 0) != 0) break;  // cpu 行都在文件开头
+        std::istringstream iss(line);
+        std::string label;
+        iss >> label;
+        uint64_t value = 0, total = 0, idle = 0;
+        for (int i = 0; iss >> value; ++i) {
+            // guest / guest_nice 已计入 user / nice，不重复累加
+            if (i >= 8) break;
+            total += value;
+            if (i == 3 || i == 4) idle += value;  // idle + iowait
+        }
+        ticks.push_back({total - idle, total});
+    }
+    return ticks;
+}
+
+float CPUInfoTools::UsageBetween(const CPUTicks& prev, const CPUTicks& curr) {
+    if (curr.total <= prev.total || curr.busy < prev.busy) return 0.0f;
+    uint64_t busy = curr.busy - prev.busy;
+    uint64_t total = curr.total - prev.total;
+    return std::min(100.0f, 100.0f * static_cast<float>(busy) / static_cast<float>(total));
+}
+
 std::string CPUInfoTools::getArchitecture() const {
     try {
         std::ifstream cpuinfo("/proc/cpuinfo");
@@ -2,8 +2,17 @@
 
 #include "SystemHealthy.pb.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace MySystemHealthy {
 
+// /proc/stat 中一行 cpu 的累计 jiffies（busy = total - idle - iowait）
+struct CPUTicks {
+    uint64_t busy = 0;
+    uint64_t total = 0;
+};
+
 class CPUInfoTools {
 public:
     CPUInfoTools();
@@ -14,6 +23,12 @@ public:
 
     static float getUsagePercent(const std::string& oneCPUInfo);
 
+    // 读取累计 ticks：[0] 为汇总行 "cpu"，其后依次为 cpu0、cpu1 ...；两次读数作差即为区间使用率
+    static std::vector<CPUTicks> CollectCPUTicks();
+
+    // 两次读数之间的使用率（百分比），total 未增长时返回 0
+    static float UsageBetween(const CPUTicks& prev, const CPUTicks& curr);
+
     std::string getArchitecture() const;
 
 };
@@ -0,0 +1,389 @@
+#include "MetricsRingStore.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "MyLog.h"
+
+namespace MySystemHealthy {
+
+namespace {
+
+constexpr int kMaxSlots = 1000000;
+
+bool ReadInt(const nlohmann::json& j, const char* key, int64_t min_value, int64_t max_value,
+             int64_t& out, std::string* err) {
+  if (!j.contains(key)) return true;
+  const auto& v = j.at(key);
+  if (!v.is_number_integer()) {
+    if (err) *err = std::string(key) + " 必须是整数";
+    return false;
+  }
+  int64_t value = v.get<int64_t>();
+  if (value < min_value || value > max_value) {
+    if (err) *err = std::string(key) + " 必须在 " + std::to_string(min_value) + "-" + std::to_string(max_value) + " 范围内";
+    return false;
+  }
+  out = value;
+  return true;
+}
+
+inline int64_t FloorDiv(int64_t a, int64_t b) {
+  int64_t q = a / b;
+  return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+} // namespace
+
+// ============================================================================
+// MetricsStoreOptions
+// ============================================================================
+
+bool MetricsStoreOptions::FromJson(const nlohmann::json& j, MetricsStoreOptions& out, std::string* err) {
+  if (!j.is_object()) {
+    if (err) *err = "metrics_store 必须是对象";
+    return false;
+  }
+  int64_t slots_1s = out.slots_1s;
+  int64_t slots_10s = out.slots_10s;
+  int64_t slots_1m = out.slots_1m;
+  int64_t budget = out.memory_budget_bytes;
+  int64_t idle = out.idle_evict_seconds;
+  if (!ReadInt(j, "slots_1s", 1, kMaxSlots, slots_1s, err)) return false;
+  if (!ReadInt(j, "slots_10s", 1, kMaxSlots, slots_10s, err)) return false;
+  if (!ReadInt(j, "slots_1m", 1, kMaxSlots, slots_1m, err)) return false;
+  if (!ReadInt(j, "memory_budget_bytes", 64 * 1024, std::numeric_limits<int64_t>::max(), budget, err)) return false;
+  if (!ReadInt(j, "idle_evict_seconds", 0, 30LL * 24 * 3600, idle, err)) return false;
+
+  out.slots_1s = static_cast<int>(slots_1s);
+  out.slots_10s = static_cast<int>(slots_10s);
+  out.slots_1m = static_cast<int>(slots_1m);
+  out.memory_budget_bytes = budget;
+  out.idle_evict_seconds = static_cast<int>(idle);
+  return true;
+}
+
+nlohmann::json MetricsStoreOptions::ToJson() const {
+  return {
+    {"slots_1s", slots_1s},
+    {"slots_10s", slots_10s},
+    {"slots_1m", slots_1m},
+    {"memory_budget_bytes", memory_budget_bytes},
+    {"idle_evict_seconds", idle_evict_seconds},
+  };
+}
+
+// ============================================================================
+// MetricsRingStore
+// ============================================================================
+
+MetricsRingStore::MetricsRingStore(const MetricsStoreOptions& options) : options_(options) {
+  RebuildLocked();
+}
+
+void MetricsRingStore::Reconfigure(const MetricsStoreOptions& options) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  options_ = options;
+  RebuildLocked();
+}
+
+void MetricsRingStore::RebuildLocked() {
+  capacity_ = std::max<size_t>(1, static_cast<size_t>(options_.memory_budget_bytes) / BytesPerSeries());
+  series_.clear();
+  series_.resize(capacity_);
+  index_.clear();
+  free_.clear();
+  free_.reserve(capacity_);
+  // 倒序压入，使低下标先被使用
+  for (size_t i = capacity_; i > 0; --i) free_.push_back(i - 1);
+  newest_ts_ = 0;
+  MYLOG_INFO("MetricsRingStore: 单条序列 {} 字节，序列容量 {}", BytesPerSeries(), capacity_);
+}
+
+int MetricsRingStore::SlotsOf(int tier) const {
+  switch (tier) {
+    case 0: return options_.slots_1s;
+    case 1: return options_.slots_10s;
+    default: return options_.slots_1m;
+  }
+}
+
+size_t MetricsRingStore::BytesPerSeries() const {
+  constexpr size_t kSlotBytes = sizeof(int64_t) + sizeof(float) * 2 + sizeof(double) + sizeof(uint32_t);
+  size_t slots = 0;
+  for (int t = 0; t < kTierCount; ++t) slots += static_cast<size_t>(SlotsOf(t));
+  return slots * kSlotBytes;
+}
+
+int MetricsRingStore::TierOfStep(int step_seconds) {
+  for (int t = 0; t < kTierCount; ++t) {
+    if (kTierSteps[t] == step_seconds) return t;
+  }
+  return -1;
+}
+
+bool MetricsRingStore::Matches(const std::string& pattern, const std::string& name) {
+  if (!pattern.empty() && pattern.back() == '*') {
+    return name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+  }
+  return pattern == name;
+}
+
+MetricsRingStore::Series* MetricsRingStore::FindOrCreateLocked(std::string_view name, int64_t ts) {
+  std::string key(name);
+  auto it = index_.find(key);
+  if (it != index_.end()) return &series_[it->second];
+
+  if (free_.empty()) {
+    // 淘汰空闲最久的序列（例如已退出的线程），仍在写入的序列不淘汰
+    size_t victim = capacity_;
+    int64_t oldest = std::numeric_limits<int64_t>::max();
+    for (size_t i = 0; i < series_.size(); ++i) {
+      if (series_[i].in_use && series_[i].last_ts < oldest) {
+        oldest = series_[i].last_ts;
+        victim = i;
+      }
+    }
+    if (victim == capacity_ || ts - oldest <= options_.idle_evict_seconds) {
+      ++series_rejected_;
+      return nullptr;
+    }
+    index_.erase(series_[victim].name);
+    series_[victim].in_use = false;
+    free_.push_back(victim);
+    ++series_evicted_;
+  }
+
+  size_t idx = free_.back();
+  free_.pop_back();
+  Series& s = series_[idx];
+  for (int t = 0; t < kTierCount; ++t) {
+    TierRing& ring = s.tiers[t];
+    size_t slots = static_cast<size_t>(SlotsOf(t));
+    if (ring.bucket.size() != slots) {
+      ring.bucket.assign(slots, -1);
+      ring.min.assign(slots, 0.0f);
+      ring.max.assign(slots, 0.0f);
+      ring.sum.assign(slots, 0.0);
+      ring.count.assign(slots, 0);
+    } else {
+      std::fill(ring.bucket.begin(), ring.bucket.end(), -1);
+    }
+  }
+  s.name = std::move(key);
+  s.label.clear();
+  s.last_ts = ts;
+  s.last_value = 0.0;
+  s.in_use = true;
+  index_.emplace(s.name, idx);
+  return &s;
+}
+
+void MetricsRingStore::RecordLocked(std::string_view name, int64_t ts, double value, std::string_view label) {
+  Series* s = FindOrCreateLocked(name, ts);
+  if (!s) return;
+  if (!label.empty() && s->label != label) s->label.assign(label.data(), label.size());
+
+  bool written = false;
+  const float fv = static_cast<float>(value);
+  for (int t = 0; t < kTierCount; ++t) {
+    TierRing& ring = s->tiers[t];
+    const int64_t bucket = FloorDiv(ts, kTierSteps[t]);
+    const int64_t slots = static_cast<int64_t>(ring.bucket.size());
+    if (bucket <= FloorDiv(newest_ts_, kTierSteps[t]) - slots) continue; // 早于该档的保留范围
+    const size_t slot = static_cast<size_t>(((bucket % slots) + slots) % slots);
+    if (ring.bucket[slot] == bucket) {
+      ring.min[slot] = std::min(ring.min[slot], fv);
+      ring.max[slot] = std::max(ring.max[slot], fv);
+      ring.sum[slot] += value;
+      ++ring.count[slot];
+    } else if (ring.bucket[slot] < bucket) {
+      ring.bucket[slot] = bucket;
+      ring.min[slot] = fv;
+      ring.max[slot] = fv;
+      ring.sum[slot] = value;
+      ring.count[slot] = 1;
+    } else {
+      continue; // 该档的槽位已被更新的桶占用，点太旧
+    }
+    written = true;
+  }
+
+  if (!written) {
+    ++points_too_old_;
+    return;
+  }
+  ++points_written_;
+  if (ts >= s->last_ts) {
+    s->last_ts = ts;
+    s->last_value = value;
+  }
+  newest_ts_ = std::max(newest_ts_, ts);
+}
+
+void MetricsRingStore::Record(std::string_view name, int64_t ts, double value, std::string_view label) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  RecordLocked(name, ts, value, label);
+}
+
+void MetricsRingStore::RecordBatch(int64_t ts, const std::vector<Sample>& samples) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  for (const auto& sample : samples) RecordLocked(sample.name, ts, sample.value, sample.label);
+}
+
+void MetricsRingStore::RangeLocked(const Series& s, int tier, int64_t from, int64_t to,
+                                   std::vector<MetricPoint>& out) const {
+  const TierRing& ring = s.tiers[tier];
+  const int64_t slots = static_cast<int64_t>(ring.bucket.size());
+  if (slots == 0 || from > to) return;
+  const int step = kTierSteps[tier];
+  int64_t first = FloorDiv(from, step);
+  const int64_t last = FloorDiv(to, step);
+  // 环中最多只保存最近 slots 个桶
+  first = std::max(first, FloorDiv(newest_ts_, step) - slots + 1);
+  for (int64_t b = first; b <= last; ++b) {
+    const size_t slot = static_cast<size_t>(((b % slots) + slots) % slots);
+    if (ring.bucket[slot] != b) continue;
+    MetricPoint p;
+    p.ts = b * step;
+    p.count = ring.count[slot];
+    p.min = ring.min[slot];
+    p.max = ring.max[slot];
+    p.avg = ring.sum[slot] / static_cast<double>(p.count);
+    out.push_back(p);
+  }
+}
+
+std::vector<MetricPoint> MetricsRingStore::Range(const std::string& name, int64_t from, int64_t to,
+                                                 int step_seconds) const {
+  std::vector<MetricPoint> out;
+  int tier = TierOfStep(step_seconds);
+  if (tier < 0) return out;
+  std::lock_guard<std::mutex> lk(mtx_);
+  auto it = index_.find(name);
+  if (it == index_.end()) return out;
+  RangeLocked(series_[it->second], tier, from, to, out);
+  return out;
+}
+
+bool MetricsRingStore::Query(const MetricsQuery& query, nlohmann::json& out, std::string* err) const {
+  if (query.pattern.empty()) {
+    if (err) *err = "name 不能为空";
+    return false;
+  }
+  if (query.max_points <= 0 || query.max_series <= 0) {
+    if (err) *err = "max_points / max_series 必须大于 0";
+    return false;
+  }
+  int tier = -1;
+  if (query.step_seconds != 0) {
+    tier = TierOfStep(query.step_seconds);
+    if (tier < 0) {
+      if (err) *err = "step 只支持 1 / 10 / 60 秒";
+      return false;
+    }
+  }
+
+  std::lock_guard<std::mutex> lk(mtx_);
+  int64_t to = query.to > 0 ? query.to : newest_ts_;
+  int64_t from = query.from > 0 ? query.from : to - 600;
+  if (from > to) {
+    if (err) *err = "from 不能大于 to";
+    return false;
+  }
+
+  // 自动选择：能覆盖 from 且点数不超过 max_points 的最细一档，否则取最粗一档
+  if (tier < 0) {
+    tier = kTierCount - 1;
+    for (int t = 0; t < kTierCount; ++t) {
+      const int64_t step = kTierSteps[t];
+      const int64_t retention = static_cast<int64_t>(SlotsOf(t)) * step;
+      if (newest_ts_ - from < retention && (to - from) / step + 1 <= query.max_points) {
+        tier = t;
+        break;
+      }
+    }
+  }
+  const int step = kTierSteps[tier];
+  bool truncated = false;
+  if ((to - from) / step + 1 > query.max_points) {
+    from = to - static_cast<int64_t>(query.max_points - 1) * step;
+    truncated = true;
+  }
+
+  std::vector<const Series*> matched;
+  for (const auto& kv : index_) {
+    if (Matches(query.pattern, kv.first)) matched.push_back(&series_[kv.second]);
+  }
+  std::sort(matched.begin(), matched.end(), [](const Series* a, const Series* b) { return a->name < b->name; });
+  if (matched.size() > static_cast<size_t>(query.max_series)) {
+    matched.resize(static_cast<size_t>(query.max_series));
+    truncated = true;
+  }
+
+  nlohmann::json series = nlohmann::json::array();
+  std::vector<MetricPoint> points;
+  for (const Series* s : matched) {
+    points.clear();
+    RangeLocked(*s, tier, from, to, points);
+    nlohmann::json pts = nlohmann::json::array();
+    for (const auto& p : points) pts.push_back({p.ts, p.avg, p.min, p.max, p.count});
+    series.push_back({{"name", s->name}, {"label", s->label}, {"points", std::move(pts)}});
+  }
+
+  out = {
+    {"from", from},
+    {"to", to},
+    {"step_seconds", step},
+    {"truncated", truncated},
+    {"columns", {"ts", "avg", "min", "max", "count"}},
+    {"series", std::move(series)},
+  };
+  return true;
+}
+
+nlohmann::json MetricsRingStore::ListSeries(const std::string& pattern) const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  std::vector<const Series*> matched;
+  for (const auto& kv : index_) {
+    if (Matches(pattern, kv.first)) matched.push_back(&series_[kv.second]);
+  }
+  std::sort(matched.begin(), matched.end(), [](const Series* a, const Series* b) { return a->name < b->name; });
+  nlohmann::json arr = nlohmann::json::array();
+  for (const Series* s : matched) {
+    arr.push_back({{"name", s->name}, {"label", s->label}, {"last_ts", s->last_ts}, {"last_value", s->last_value}});
+  }
+  return arr;
+}
+
+nlohmann::json MetricsRingStore::GetStatsJson() const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  nlohmann::json retention = nlohmann::json::object();
+  for (int t = 0; t < kTierCount; ++t) {
+    retention[std::to_string(kTierSteps[t]) + "s"] = static_cast<int64_t>(SlotsOf(t)) * kTierSteps[t];
+  }
+  return {
+    {"options", options_.ToJson()},
+    {"bytes_per_series", BytesPerSeries()},
+    {"series_capacity", capacity_},
+    {"series_count", index_.size()},
+    {"retention_seconds", retention},
+    {"newest_ts", newest_ts_},
+    {"points_written", points_written_},
+    {"points_too_old", points_too_old_},
+    {"series_evicted", series_evicted_},
+    {"series_rejected", series_rejected_},
+  };
+}
+
+size_t MetricsRingStore::SeriesCapacity() const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  return capacity_;
+}
+
+size_t MetricsRingStore::SeriesCount() const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  return index_.size();
+}
+
+} // namespace MySystemHealthy
@@ -0,0 +1,144 @@
+#pragma once
+// 进程内时序环形存储（MetricsRingStore）
+// 每条序列按 1s / 10s / 1m 三档分辨率各保留一个定长环，写入时同时累加到三档，
+// 每个槽位保存 min / max / sum / count（列式存储：同一档的各列分别是连续数组）。
+// 总内存由 memory_budget_bytes 固定：序列容量 = 预算 / 单条序列字节数，
+// 容量满时淘汰空闲最久（超过 idle_evict_seconds 未写入）的序列，否则丢弃新序列。
+//
+// 由 MySystemHealthyManager 定期写入主机与软件健康指标，/v1/metrics/* 接口查询。
+// 配置（system_healthy 节点 model_args.metrics_store）示例：
+// {
+//   "slots_1s": 600,                 // 1 秒档保留 10 分钟
+//   "slots_10s": 360,                // 10 秒档保留 1 小时
+//   "slots_1m": 1440,                // 1 分钟档保留 24 小时
+//   "memory_budget_bytes": 16777216,
+//   "idle_evict_seconds": 600
+// }
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace MySystemHealthy {
+
+struct MetricsStoreOptions {
+  int slots_1s = 600;
+  int slots_10s = 360;
+  int slots_1m = 1440;
+  int64_t memory_budget_bytes = 16LL * 1024 * 1024;
+  int idle_evict_seconds = 600;
+
+  // 从 JSON 解析，未出现的字段保持默认值；非法时返回 false 并写入 err，out 不被修改
+  static bool FromJson(const nlohmann::json& j, MetricsStoreOptions& out, std::string* err = nullptr);
+
+  nlohmann::json ToJson() const;
+};
+
+// 一个聚合点（某档分辨率下一个时间桶）
+struct MetricPoint {
+  int64_t ts = 0;        // 桶起始时间（unix 秒）
+  double avg = 0.0;
+  float min = 0.0f;
+  float max = 0.0f;
+  uint32_t count = 0;
+};
+
+struct MetricsQuery {
+  std::string pattern;   // 完整序列名，或以 '*' 结尾的前缀
+  int64_t from = 0;      // unix 秒；0 表示 to - 600
+  int64_t to = 0;        // unix 秒；0 表示最新写入时间
+  int step_seconds = 0;  // 1 / 10 / 60；0 表示按范围与 max_points 自动选择
+  int max_points = 600;  // 每条序列最多返回的点数
+  int max_series = 50;   // 最多返回的序列数
+};
+
+class MetricsRingStore {
+public:
+  static constexpr int kTierCount = 3;
+  static constexpr std::array<int, kTierCount> kTierSteps = {1, 10, 60};
+
+  explicit MetricsRingStore(const MetricsStoreOptions& options = MetricsStoreOptions());
+
+  MetricsRingStore(const MetricsRingStore&) = delete;
+  MetricsRingStore& operator=(const MetricsRingStore&) = delete;
+
+  // 清空全部序列并按新配置重建
+  void Reconfigure(const MetricsStoreOptions& options);
+
+  struct Sample {
+    std::string name;
+    double value = 0.0;
+    std::string label;   // 可选的展示名（进程名 / 线程名等）
+  };
+
+  // 写入一个点；早于环覆盖范围的旧点被忽略
+  void Record(std::string_view name, int64_t ts, double value, std::string_view label = {});
+
+  // 同一时间戳批量写入（只加一次锁）
+  void RecordBatch(int64_t ts, const std::vector<Sample>& samples);
+
+  // 查询单条序列某档分辨率下 [from, to] 内的点（按时间升序，跳过空桶）
+  std::vector<MetricPoint> Range(const std::string& name, int64_t from, int64_t to, int step_seconds) const;
+
+  // 按 pattern 查询多条序列，输出：
+  // { "from", "to", "step_seconds", "truncated", "series": [ {"name","label","points":[[ts,avg,min,max,count],...]} ] }
+  bool Query(const MetricsQuery& query, nlohmann::json& out, std::string* err = nullptr) const;
+
+  // 序列列表：名称、展示名、最新值与最新时间
+  nlohmann::json ListSeries(const std::string& pattern = "*") const;
+
+  nlohmann::json GetStatsJson() const;
+
+  size_t SeriesCapacity() const;
+  size_t SeriesCount() const;
+
+private:
+  // 一档分辨率的环：各列分别连续存放，bucket 为 ts / step，-1 表示空槽
+  struct TierRing {
+    std::vector<int64_t> bucket;
+    std::vector<float> min;
+    std::vector<float> max;
+    std::vector<double> sum;
+    std::vector<uint32_t> count;
+  };
+
+  struct Series {
+    std::string name;
+    std::string label;
+    int64_t last_ts = 0;
+    double last_value = 0.0;
+    bool in_use = false;
+    std::array<TierRing, kTierCount> tiers;
+  };
+
+  void RebuildLocked();
+  int SlotsOf(int tier) const;
+  size_t BytesPerSeries() const;
+  Series* FindOrCreateLocked(std::string_view name, int64_t ts);
+  void RecordLocked(std::string_view name, int64_t ts, double value, std::string_view label);
+  void RangeLocked(const Series& s, int tier, int64_t from, int64_t to, std::vector<MetricPoint>& out) const;
+  static int TierOfStep(int step_seconds);
+  static bool Matches(const std::string& pattern, const std::string& name);
+
+  MetricsStoreOptions options_;
+  size_t capacity_ = 0;
+
+  mutable std::mutex mtx_;
+  std::vector<Series> series_;                      // 大小为 capacity_，按需分配环
+  std::unordered_map<std::string, size_t> index_;   // 名称 -> series_ 下标
+  std::vector<size_t> free_;                        // 空闲下标
+  int64_t newest_ts_ = 0;
+
+  // 统计
+  uint64_t points_written_ = 0;
+  uint64_t points_too_old_ = 0;
+  uint64_t series_evicted_ = 0;
+  uint64_t series_rejected_ = 0;
+};
+
+} // namespace MySystemHealthy
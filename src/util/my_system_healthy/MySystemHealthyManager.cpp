@@ -7,6 +7,7 @@
 #include "NetInfoTools.h"
 #include "GPUInfoTools.h"
 #include "ProcessInfoTools.h"
+#include "SoftHealthMonitorManager.h"
 
 // using namespace SystemHealthyTools;
 
@@ -23,9 +24,10 @@ MySystemHealthyManager& MySystemHealthyManager::GetInstance() {
   return instance;
 }
 
-void MySystemHealthyManager::Init(int update_interval_sec) {
+void MySystemHealthyManager::Init(int update_interval_sec, const MetricsStoreOptions& store_options) {
   interval_sec_ = update_interval_sec;
   if (running_) return;
+  metrics_.Reconfigure(store_options);
   running_ = true;
   worker_ = std::thread(&MySystemHealthyManager::WorkerLoop, this);
   MYLOG_INFO("MySystemHealthyManager started with interval: {} sec", interval_sec_);
@@ -45,16 +47,12 @@ void MySystemHealthyManager::WorkerLoop() {
     info.set_platform("x86_64"); // todo
     info.set_uptime_seconds(static_cast<uint64_t>(time(nullptr))); // todo
 
-    CPUInfoTools::CollectCPUInfo();
-    MemInfoTools::CollectMemInfo();
-    DiskInfoTools::CollectDiskInfo();
-    NetInfoTools::CollectNetInfo();
+    *info.mutable_cpu_info() = CPUInfoTools::CollectCPUInfo();
+    *info.mutable_mem_info() = MemInfoTools::CollectMemInfo();
+    *info.mutable_disk_info() = DiskInfoTools::CollectDiskInfo();
+    *info.mutable_net_info() = NetInfoTools::CollectNetInfo();
     GPUInfoTools::CollectGPUInfo();
 
-    // *info.mutable_cpu_info() = CPUInfoTools::CollectCPUInfo();
-    // *info.mutable_mem_info() = MemInfoTools::CollectMemInfo();
-    // *info.mutable_disk_info() = DiskInfoTools::CollectDiskInfo();
-    // *info.mutable_net_info() = NetInfoTools::CollectNetInfo();
     // for (auto& gpu : GPUInfoTools::CollectGPUInfo()) {
     //   *info.add_gpu_infos() = gpu;
     // }
@@ -62,6 +60,9 @@ void MySystemHealthyManager::WorkerLoop() {
     //   *info.add_processes() = proc;
     // }
 
+    RecordHostMetrics(static_cast<int64_t>(time(nullptr)), info);
+    RecordSoftHealthMetrics();
+
     {
       std::lock_guard<std::mutex> lock(mutex_);
       current_info_ = info;
@@ -70,6 +71,70 @@ void MySystemHealthyManager::WorkerLoop() {
   }
 }
 
+void MySystemHealthyManager::RecordHostMetrics(int64_t now, SystemHealthy::SystemInfo& info) {
+  std::vector<MetricsRingStore::Sample> samples;
+  const auto sample_time = std::chrono::steady_clock::now();
+  const auto ticks = CPUInfoTools::CollectCPUTicks();
+  const auto& mem = info.mem_info();
+  const auto& disk = info.disk_info();
+  const auto& net = info.net_info();
+
+  samples.push_back({"host.mem.used_pct", mem.usage_percent()});
+  samples.push_back({"host.mem.available_bytes", static_cast<double>(mem.available_bytes())});
+
+  // 累计值需要两轮作差，首轮只记录内存
+  if (has_prev_) {
+    if (!ticks.empty() && ticks.size() == prev_cpu_ticks_.size()) {
+      samples.push_back({"host.cpu.usage_pct", CPUInfoTools::UsageBetween(prev_cpu_ticks_[0], ticks[0])});
+      auto* cpu = info.mutable_cpu_info();
+      for (size_t i = 1; i < ticks.size(); ++i) {
+        float usage = CPUInfoTools::UsageBetween(prev_cpu_ticks_[i], ticks[i]);
+        samples.push_back({"host.cpu.core." + std::to_string(i - 1) + ".usage_pct", usage});
+        if (static_cast<int>(i - 1) < cpu->cores_size()) cpu->mutable_cores(static_cast<int>(i - 1))->set_usage_percent(usage);
+      }
+    }
+    double dt = std::chrono::duration<double>(sample_time - prev_sample_time_).count();
+    if (dt > 0) {
+      auto rate = [dt](uint64_t curr, uint64_t prev) { return curr >= prev ? static_cast<double>(curr - prev) / dt : 0.0; };
+      samples.push_back({"host.disk.read_bytes_per_sec", rate(disk.read_bytes(), prev_disk_read_)});
+      samples.push_back({"host.disk.write_bytes_per_sec", rate(disk.write_bytes(), prev_disk_write_)});
+      samples.push_back({"host.net.recv_bytes_per_sec", rate(net.recv_bytes(), prev_net_recv_)});
+      samples.push_back({"host.net.transmit_bytes_per_sec", rate(net.transmit_bytes(), prev_net_transmit_)});
+    }
+  }
+
+  prev_cpu_ticks_ = ticks;
+  prev_disk_read_ = disk.read_bytes();
+  prev_disk_write_ = disk.write_bytes();
+  prev_net_recv_ = net.recv_bytes();
+  prev_net_transmit_ = net.transmit_bytes();
+  prev_sample_time_ = sample_time;
+  has_prev_ = true;
+
+  metrics_.RecordBatch(now, samples);
+}
+
+void MySystemHealthyManager::RecordSoftHealthMetrics() {
+  auto snap = MySoftHealthy::SoftHealthMonitorManager::getInstance().getData();
+  if (!snap) return;
+  const int64_t ts = std::chrono::duration_cast<std::chrono::seconds>(snap->ts.time_since_epoch()).count();
+  if (ts == last_soft_ts_) return;  // 快照未更新
+  last_soft_ts_ = ts;
+
+  std::vector<MetricsRingStore::Sample> samples;
+  for (const auto& kv : snap->processes) {
+    const auto& p = kv.second;
+    const std::string prefix = "proc." + std::to_string(p.pid) + ".";
+    samples.push_back({prefix + "cpu_pct_core", p.cpu_pct_core, p.name});
+    samples.push_back({prefix + "rss_bytes", static_cast<double>(p.vm_rss_bytes), p.name});
+    samples.push_back({prefix + "threads", static_cast<double>(p.threads_count), p.name});
+    for (const auto& t : p.top_threads) {
+      samples.push_back({"thread." + std::to_string(t.tid) + ".cpu_pct_core", t.cpu_pct_core, p.name + "/" + t.name});
+    }
+  }
+  metrics_.RecordBatch(ts, samples);
+}
+
 const SystemHealthy::SystemInfo MySystemHealthyManager::GetSystemInfo() {
   std::lock_guard<std::mutex> lock(mutex_);
   return current_info_;
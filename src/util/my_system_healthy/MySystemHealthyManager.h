@@ -3,7 +3,11 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <vector>
 #include "SystemHealthy.pb.h"
+#include "CPUInfoTools.h"
+#include "MetricsRingStore.h"
 #include "MyLog.h"
 
 namespace MySystemHealthy {
@@ -13,20 +17,39 @@ class MySystemHealthyManager {
 public:
   static MySystemHealthyManager& GetInstance();
 
-  void Init(int update_interval_sec = 5); // 可传入采样周期
+  void Init(int update_interval_sec = 5,
+            const MetricsStoreOptions& store_options = MetricsStoreOptions()); // 可传入采样周期与时序存储配置
   const SystemHealthy::SystemInfo GetSystemInfo();
   void Shutdown();
 
+  // 历史指标（主机 CPU/内存/磁盘/网络，以及软件健康快照中的进程与 TopN 线程 CPU）
+  MetricsRingStore& Metrics() { return metrics_; }
+
 private:
   MySystemHealthyManager();
   ~MySystemHealthyManager();
   void WorkerLoop();
+  // 计算区间使用率 / 速率并写入 metrics_，同时回填 info 中的 CPU 核心使用率
+  void RecordHostMetrics(int64_t now, SystemHealthy::SystemInfo& info);
+  // 软件健康快照更新后写入进程与线程序列
+  void RecordSoftHealthMetrics();
 
   std::thread worker_;
   std::mutex mutex_;
   std::atomic<bool> running_;
   SystemHealthy::SystemInfo current_info_;
   int interval_sec_ = 5;
+
+  MetricsRingStore metrics_;
+  // 上一轮的累计值，用于计算区间使用率与速率（仅工作线程访问）
+  std::vector<CPUTicks> prev_cpu_ticks_;
+  uint64_t prev_disk_read_ = 0;
+  uint64_t prev_disk_write_ = 0;
+  uint64_t prev_net_recv_ = 0;
+  uint64_t prev_net_transmit_ = 0;
+  std::chrono::steady_clock::time_point prev_sample_time_;
+  bool has_prev_ = false;
+  int64_t last_soft_ts_ = 0;
 };
 
 }; 
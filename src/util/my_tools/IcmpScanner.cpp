@@ -0,0 +1,330 @@
+#include "IcmpScanner.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+#include "MyIPTools.h"
+#include "MyLog.h"
+
+namespace my_tools {
+
+namespace {
+
+constexpr int kIcmpFilter = 1;                 ///< linux/icmp.h 中的 ICMP_FILTER（该头文件与 netinet/ip_icmp.h 冲突）
+constexpr uint8_t kEchoReply   = 0;
+constexpr uint8_t kEchoRequest = 8;
+constexpr size_t kMaxTargetsPerRun = 65535;    ///< 一段扫描可用的 sequence 数
+constexpr int kBurstLimit = 256;               ///< 单次唤醒最多补发的包数，避免落后时瞬间突发
+constexpr int64_t kProgressIntervalNs = 100 * 1000 * 1000;
+constexpr int kRecvBufferBytes = 1 << 20;
+
+/// 每个目标的定长状态
+struct Target {
+	uint32_t addr = 0;         ///< 网络字节序
+	int64_t sent_ns = 0;
+	float rtt_ms = 0.0f;
+	uint8_t attempts = 0;
+	bool valid = false;
+	bool alive = false;
+};
+
+int64_t NowNs() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint16_t RandomU16() {
+	thread_local std::mt19937 rng{std::random_device{}()};
+	return static_cast<uint16_t>(rng() & 0xFFFF);
+}
+
+/// 作用域结束时关闭 fd
+struct FdGuard {
+	int fd = -1;
+	explicit FdGuard(int f) : fd(f) {}
+	~FdGuard() { if (fd >= 0) ::close(fd); }
+	FdGuard(const FdGuard&) = delete;
+	FdGuard& operator=(const FdGuard&) = delete;
+};
+
+/// 一次扫描共享的 socket 与计数
+struct ScanContext {
+	int fd = -1;
+	int epfd = -1;
+	bool raw = true;
+	uint16_t ident = 0;        ///< raw socket 的 identifier；ping socket 由内核按端口分配
+	const IcmpScanOptions* options = nullptr;
+	const IcmpScanner::ProgressCallback* on_progress = nullptr;
+	IcmpScanProgress progress;
+	int64_t start_ns = 0;
+	int64_t last_report_ns = 0;
+};
+
+/// 发送一个 Echo Request，返回 0 或 errno
+int SendEcho(const ScanContext& ctx, uint16_t sequence, uint32_t addr) {
+	ICMPHeader req{};
+	req.type     = kEchoRequest;
+	req.code     = 0;
+	req.id       = htons(ctx.ident);
+	req.sequence = htons(sequence);
+	req.checksum = IcmpScanner::Checksum(&req, sizeof(req));
+
+	struct sockaddr_in dest{};
+	dest.sin_family      = AF_INET;
+	dest.sin_addr.s_addr = addr;
+	ssize_t n = ::sendto(ctx.fd, &req, sizeof(req), 0,
+	                     reinterpret_cast<struct sockaddr*>(&dest), sizeof(dest));
+	return n < 0 ? errno : 0;
+}
+
+/// 读空接收队列，按 sequence + 来源地址匹配 [begin, end) 内的目标，返回新确认存活的数量
+int DrainReplies(ScanContext& ctx, std::vector<Target>& hosts, size_t begin, size_t end, uint16_t seq_base) {
+	int matched = 0;
+	uint8_t buf[1500];
+	while (true) {
+		struct sockaddr_in from{};
+		socklen_t from_len = sizeof(from);
+		ssize_t n = ::recvfrom(ctx.fd, buf, sizeof(buf), 0,
+		                       reinterpret_cast<struct sockaddr*>(&from), &from_len);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			break;  // EAGAIN：已读空
+		}
+		++ctx.progress.packets_received;
+
+		// raw socket 带 IP 头，ping socket 只有 ICMP 部分
+		size_t offset = 0;
+		if (ctx.raw) {
+			if (n < 20) continue;
+			offset = static_cast<size_t>(buf[0] & 0x0F) * 4;
+		}
+		if (static_cast<size_t>(n) < offset + sizeof(ICMPHeader)) continue;
+
+		ICMPHeader reply{};
+		std::memcpy(&reply, buf + offset, sizeof(reply));
+		if (reply.type != kEchoReply) continue;
+		if (ctx.raw && ntohs(reply.id) != ctx.ident) continue;  // 其他扫描或 PingHost 的应答
+
+		const size_t slot = static_cast<uint16_t>(ntohs(reply.sequence) - seq_base);
+		if (slot >= end - begin) continue;
+		Target& t = hosts[begin + slot];
+		if (t.alive || from.sin_addr.s_addr != t.addr) continue;
+
+		t.alive  = true;
+		t.rtt_ms = static_cast<float>(NowNs() - t.sent_ns) / 1e6f;
+		++ctx.progress.replied;
+		++matched;
+	}
+	return matched;
+}
+
+void ReportProgress(ScanContext& ctx, int64_t now, bool force) {
+	if (!ctx.on_progress || !*ctx.on_progress) return;
+	if (!force && now - ctx.last_report_ns < kProgressIntervalNs) return;
+	ctx.last_report_ns = now;
+	ctx.progress.elapsed_ms = static_cast<double>(now - ctx.start_ns) / 1e6;
+	(*ctx.on_progress)(ctx.progress);
+}
+
+/**
+ * @brief 扫描 [begin, end) 段目标（段长不超过 sequence 空间）
+ * @return false 表示 epoll 出错，err 已写入
+ */
+bool RunSegment(ScanContext& ctx, std::vector<Target>& hosts, size_t begin, size_t end, std::string& err) {
+	const IcmpScanOptions& opt = *ctx.options;
+	const uint16_t seq_base = RandomU16();
+	const int64_t interval_ns = std::max<int64_t>(1, 1000000000LL / opt.rate_pps);
+	const int64_t timeout_ns = static_cast<int64_t>(opt.timeout_ms) * 1000000LL;
+
+	int remaining = 0;
+	for (size_t i = begin; i < end; ++i) {
+		if (hosts[i].valid) ++remaining;
+	}
+
+	for (int pass = 0; pass <= opt.retries && remaining > 0; ++pass) {
+		ctx.progress.pass = pass;
+		size_t cursor = begin;
+		const int64_t pass_start = NowNs();
+		int64_t sent_in_pass = 0;
+		int64_t deadline = 0;
+
+		while (remaining > 0) {
+			int64_t now = NowNs();
+
+			// 按速率补发到期的请求
+			if (cursor < end) {
+				int64_t budget = std::min<int64_t>((now - pass_start) / interval_ns + 1 - sent_in_pass, kBurstLimit);
+				while (budget > 0 && cursor < end) {
+					Target& t = hosts[cursor];
+					if (!t.valid || t.alive) {
+						++cursor;
+						continue;
+					}
+					int rc = SendEcho(ctx, static_cast<uint16_t>(seq_base + (cursor - begin)), t.addr);
+					if (rc == EAGAIN || rc == EWOULDBLOCK || rc == ENOBUFS) {
+						break;  // 发送缓冲区满，下次唤醒再试
+					}
+					t.sent_ns = NowNs();
+					if (t.attempts++ == 0) ++ctx.progress.probed;
+					if (rc == 0) {
+						++ctx.progress.packets_sent;
+					} else {
+						MYLOG_DEBUG("[IcmpScanner] 发送失败: {}", std::strerror(rc));
+					}
+					++cursor;
+					++sent_in_pass;
+					--budget;
+				}
+				if (cursor >= end) deadline = NowNs() + timeout_ns;
+			}
+
+			now = NowNs();
+			if (cursor >= end && now >= deadline) break;
+
+			int wait_ms = 1;
+			if (cursor >= end) {
+				wait_ms = static_cast<int>(std::min<int64_t>((deadline - now + 999999) / 1000000, 100));
+			}
+			struct epoll_event ev{};
+			int n = ::epoll_wait(ctx.epfd, &ev, 1, wait_ms);
+			if (n < 0 && errno != EINTR) {
+				err = std::string("epoll_wait 失败: ") + std::strerror(errno);
+				return false;
+			}
+			if (n > 0) remaining -= DrainReplies(ctx, hosts, begin, end, seq_base);
+			ReportProgress(ctx, NowNs(), false);
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+// ============================================================
+//  Checksum —— RFC 1071
+// ============================================================
+
+uint16_t IcmpScanner::Checksum(const void* data, int len) {
+	const auto* ptr = static_cast<const uint8_t*>(data);
+	uint32_t sum = 0;
+
+	while (len > 1) {
+		uint16_t word = 0;
+		std::memcpy(&word, ptr, 2);
+		sum += word;
+		ptr += 2;
+		len -= 2;
+	}
+
+	// 剩余奇数字节
+	if (len == 1) {
+		uint16_t last = 0;
+		std::memcpy(&last, ptr, 1);
+		sum += last;
+	}
+
+	// 折叠进位
+	while (sum >> 16) {
+		sum = (sum & 0xFFFF) + (sum >> 16);
+	}
+
+	return static_cast<uint16_t>(~sum);
+}
+
+// ============================================================
+//  Scan —— 单 socket + epoll 批量探测
+// ============================================================
+
+IcmpScanReport IcmpScanner::Scan(const std::vector<std::string>& targets,
+                                 const IcmpScanOptions& options,
+                                 const ProgressCallback& on_progress) {
+	IcmpScanReport report;
+	ScanContext ctx;
+	ctx.options     = &options;
+	ctx.on_progress = &on_progress;
+	ctx.start_ns    = NowNs();
+	ctx.progress.total = static_cast<int>(targets.size());
+
+	if (options.rate_pps <= 0 || options.timeout_ms < 0 || options.retries < 0) {
+		report.error = "扫描参数非法：rate_pps 必须大于 0，timeout_ms / retries 不能为负";
+		report.progress = ctx.progress;
+		return report;
+	}
+
+	std::vector<Target> hosts(targets.size());
+	for (size_t i = 0; i < targets.size(); ++i) {
+		struct in_addr a{};
+		if (::inet_pton(AF_INET, targets[i].c_str(), &a) == 1) {
+			hosts[i].addr  = a.s_addr;
+			hosts[i].valid = true;
+		}
+	}
+
+	// 优先 raw socket；没有 CAP_NET_RAW 时尝试内核 ping socket（受 net.ipv4.ping_group_range 控制）
+	int fd = ::socket(AF_INET, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+	if (fd < 0) {
+		ctx.raw = false;
+		fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+	}
+	if (fd < 0) {
+		report.error = std::string("无法创建 ICMP socket（需 CAP_NET_RAW 或 ping_group_range 授权）: ") + std::strerror(errno);
+		report.progress = ctx.progress;
+		return report;
+	}
+	FdGuard fd_guard(fd);
+	ctx.fd = fd;
+
+	if (ctx.raw) {
+		// 内核侧只放行 Echo Reply，减少无关 ICMP 流量的唤醒
+		uint32_t filter = ~(1U << kEchoReply);
+		::setsockopt(fd, SOL_RAW, kIcmpFilter, &filter, sizeof(filter));
+		ctx.ident = RandomU16();
+	}
+	// 整段应答可能在几毫秒内集中到达，放大接收缓冲避免丢包
+	int rcvbuf = kRecvBufferBytes;
+	::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+	int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+	if (epfd < 0) {
+		report.error = std::string("epoll_create1 失败: ") + std::strerror(errno);
+		report.progress = ctx.progress;
+		return report;
+	}
+	FdGuard ep_guard(epfd);
+	ctx.epfd = epfd;
+
+	struct epoll_event ev{};
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	if (::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+		report.error = std::string("epoll_ctl 失败: ") + std::strerror(errno);
+		report.progress = ctx.progress;
+		return report;
+	}
+
+	for (size_t begin = 0; begin < hosts.size(); begin += kMaxTargetsPerRun) {
+		size_t end = std::min(hosts.size(), begin + kMaxTargetsPerRun);
+		if (!RunSegment(ctx, hosts, begin, end, report.error)) break;
+	}
+
+	for (size_t i = 0; i < hosts.size(); ++i) {
+		if (hosts[i].alive) {
+			report.alive.push_back({targets[i], static_cast<double>(hosts[i].rtt_ms)});
+		}
+	}
+	ReportProgress(ctx, NowNs(), true);
+	ctx.progress.elapsed_ms = static_cast<double>(NowNs() - ctx.start_ns) / 1e6;
+	report.progress = ctx.progress;
+	return report;
+}
+
+} // namespace my_tools
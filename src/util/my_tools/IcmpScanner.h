@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace my_tools {
+
+/**
+ * @brief ICMP 批量探测参数
+ */
+struct IcmpScanOptions {
+	int timeout_ms = 800;      ///< 每轮最后一个请求发出后等待应答的时间（毫秒）
+	int rate_pps   = 10000;    ///< 发送速率（包/秒），按 1ms 粒度分批发送
+	int retries    = 1;        ///< 对未应答目标的重发轮数（0 表示只发一轮）
+};
+
+/**
+ * @brief 扫描进度（回调与结果共用）
+ */
+struct IcmpScanProgress {
+	int total      = 0;        ///< 目标总数
+	int probed     = 0;        ///< 至少发出过一次请求的目标数
+	int replied    = 0;        ///< 已收到应答的目标数
+	int pass       = 0;        ///< 当前轮次（从 0 开始）
+	uint64_t packets_sent     = 0;  ///< 发出的 Echo Request 数（含重发）
+	uint64_t packets_received = 0;  ///< 收到的 ICMP 包数（含不属于本次扫描的包）
+	double elapsed_ms = 0.0;
+};
+
+/**
+ * @brief 单个目标的探测结果
+ */
+struct IcmpScanHost {
+	std::string ip;
+	double rtt_ms = 0.0;       ///< 最后一次发送到收到应答的耗时
+};
+
+/**
+ * @brief 扫描报告
+ */
+struct IcmpScanReport {
+	std::vector<IcmpScanHost> alive;   ///< 存活目标，按输入顺序
+	IcmpScanProgress progress;         ///< 结束时的进度与计数
+	std::string error;                 ///< 为空表示成功
+};
+
+/**
+ * @brief 基于 epoll 的单 socket ICMP 批量探测器
+ *
+ * 一次扫描只创建一个非阻塞 ICMP socket（优先 SOCK_RAW，失败时退回内核 ping
+ * socket SOCK_DGRAM），按 rate_pps 节奏发出全部 Echo Request，每个目标使用独立的
+ * sequence（= 基准值 + 目标下标），应答到达时按 sequence 与来源地址匹配目标。
+ * 内存只与目标数成正比（每个目标一个定长条目），不再为每个 IP 创建线程和 socket。
+ *
+ * raw socket 上设置 ICMP_FILTER 只接收 Echo Reply，并用随机 identifier 区分
+ * 同时进行的其他扫描 / PingHost。超过 65535 个目标时按 sequence 空间分段扫描。
+ */
+class IcmpScanner {
+public:
+	using ProgressCallback = std::function<void(const IcmpScanProgress&)>;
+
+	/**
+	 * @brief 探测一组 IPv4 地址
+	 * @param targets 目标地址（非法地址会被忽略并计入 total）
+	 * @param options 探测参数
+	 * @param on_progress 进度回调，在扫描线程中约每 100ms 及结束时调用一次，可为空
+	 * @return 扫描报告
+	 */
+	static IcmpScanReport Scan(const std::vector<std::string>& targets,
+	                           const IcmpScanOptions& options = IcmpScanOptions(),
+	                           const ProgressCallback& on_progress = nullptr);
+
+	/**
+	 * @brief 计算 ICMP 校验和（RFC 1071）
+	 */
+	static uint16_t Checksum(const void* data, int len);
+};
+
+} // namespace my_tools
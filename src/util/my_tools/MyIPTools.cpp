@@ -13,13 +13,11 @@
 #include <atomic>
 #include <cerrno>
 #include <chrono>
-#include <condition_variable>
 #include <cstring>
 #include <functional>
 #include <mutex>
 #include <set>
 #include <string>
-#include <thread>
 #include <vector>
 
 #include "MyLog.h"
@@ -398,20 +396,45 @@ IPResult MyIPTools::ModifyIP(const std::string& interface_name,
 
 std::atomic<int> MyIPTools::s_max_threads{64};
 std::atomic<int> MyIPTools::s_ping_timeout_ms{800};
+std::atomic<int> MyIPTools::s_scan_rate_pps{10000};
+std::atomic<int> MyIPTools::s_scan_retries{1};
+
+// 最近一次扫描的进度，由扫描线程写入、API 线程读取
+static std::mutex s_progress_mutex;
+static ScanProgress s_progress;
 
 // ============================================================
 //  InitScanner —— 设置扫描参数
 // ============================================================
 
-void MyIPTools::InitScanner(int max_threads, int timeout_ms) {
+void MyIPTools::InitScanner(int max_threads, int timeout_ms, int rate_pps, int retries) {
 	if (max_threads < 1) max_threads = 1;
 	if (max_threads > 1024) max_threads = 1024;
 	if (timeout_ms < 100) timeout_ms = 100;
 	if (timeout_ms > 5000) timeout_ms = 5000;
+	if (rate_pps < 100) rate_pps = 100;
+	if (rate_pps > 100000) rate_pps = 100000;
+	if (retries < 0) retries = 0;
+	if (retries > 5) retries = 5;
 
 	s_max_threads.store(max_threads);
 	s_ping_timeout_ms.store(timeout_ms);
-	MYLOG_INFO("[MyIPTools] 扫描器初始化: 最大线程数={}, 超时={}ms", max_threads, timeout_ms);
+	s_scan_rate_pps.store(rate_pps);
+	s_scan_retries.store(retries);
+	MYLOG_INFO("[MyIPTools] 扫描器初始化: 超时={}ms, 速率={}pps, 重发轮数={}", timeout_ms, rate_pps, retries);
+}
+
+IcmpScanOptions MyIPTools::GetScanOptions() {
+	IcmpScanOptions options;
+	options.timeout_ms = s_ping_timeout_ms.load();
+	options.rate_pps   = s_scan_rate_pps.load();
+	options.retries    = s_scan_retries.load();
+	return options;
+}
+
+ScanProgress MyIPTools::GetScanProgress() {
+	std::lock_guard<std::mutex> lock(s_progress_mutex);
+	return s_progress;
 }
 
 // ============================================================
@@ -438,27 +461,7 @@ bool MyIPTools::HasRawSocketPermission() {
 // ============================================================
 
 uint16_t MyIPTools::ComputeICMPChecksum(const void* data, int len) {
-	const auto* ptr = static_cast<const uint16_t*>(data);
-	uint32_t sum = 0;
-
-	while (len > 1) {
-		sum += *ptr++;
-		len -= 2;
-	}
-
-	// 剩余奇数字节
-	if (len == 1) {
-		uint16_t last = 0;
-		std::memcpy(&last, ptr, 1);
-		sum += last;
-	}
-
-	// 折叠进位
-	while (sum >> 16) {
-		sum = (sum & 0xFFFF) + (sum >> 16);
-	}
-
-	return static_cast<uint16_t>(~sum);
+	return IcmpScanner::Checksum(data, len);
 }
 
 // 全局原子序列号，保证每次 PingHost 调用使用唯一 sequence
@@ -601,6 +604,57 @@ std::vector<std::string> MyIPTools::GenerateSubnetIPs(const std::string& ip, int
 	return result;
 }
 
+// ============================================================
+//  RunICMPScan —— 单 socket 批量探测并记录进度
+// ============================================================
+
+void MyIPTools::RunICMPScan(const std::string& target, const std::vector<std::string>& candidates,
+                            ScanResult& scan_result) {
+	{
+		std::lock_guard<std::mutex> lock(s_progress_mutex);
+		s_progress = ScanProgress();
+		s_progress.running = true;
+		s_progress.target = target;
+		s_progress.detail.total = static_cast<int>(candidates.size());
+	}
+
+	int last_logged = 0;
+	auto report = IcmpScanner::Scan(candidates, GetScanOptions(), [&](const IcmpScanProgress& p) {
+		{
+			std::lock_guard<std::mutex> lock(s_progress_mutex);
+			s_progress.detail = p;
+		}
+		if (p.probed - last_logged >= 512 || p.probed == p.total) {
+			last_logged = p.probed;
+			MYLOG_INFO("[MyIPTools] 扫描进度 [{}]: 已探测 {}/{}，已应答 {}", target, p.probed, p.total, p.replied);
+		}
+	});
+
+	std::vector<std::string> active_ips;
+	active_ips.reserve(report.alive.size());
+	for (const auto& host : report.alive) {
+		MYLOG_DEBUG("[MyIPTools] 发现活跃设备: {} ({:.2f}ms)", host.ip, host.rtt_ms);
+		active_ips.push_back(host.ip);
+	}
+
+	// IP 排序（候选列表可能来自按字符串排序的集合）
+	std::sort(active_ips.begin(), active_ips.end(), [](const std::string& a, const std::string& b) {
+		struct in_addr aa{}, bb{};
+		::inet_pton(AF_INET, a.c_str(), &aa);
+		::inet_pton(AF_INET, b.c_str(), &bb);
+		return ntohl(aa.s_addr) < ntohl(bb.s_addr);
+	});
+
+	scan_result.active_ips = std::move(active_ips);
+	scan_result.active_count = static_cast<int>(scan_result.active_ips.size());
+	scan_result.error = report.error;
+
+	std::lock_guard<std::mutex> lock(s_progress_mutex);
+	s_progress.running = false;
+	s_progress.detail = report.progress;
+	s_progress.error = report.error;
+}
+
 // ============================================================
 //  ScanActiveDevices —— 全局扫描入口
 // ============================================================
@@ -669,80 +723,9 @@ ScanResult MyIPTools::ScanActiveDevices() {
 		return scan_result;
 	}
 
-	// 并发扫描：使用条件变量控制最大线程数（C++17 兼容）
-	const int max_threads = s_max_threads.load();
-	const int timeout = s_ping_timeout_ms.load();
-
-	std::mutex result_mutex;
-	std::vector<std::string> active_ips;
-
-	// C++17 信号量替代：mutex + condition_variable + counter
-	std::mutex sem_mutex;
-	std::condition_variable sem_cv;
-	int sem_count = max_threads;
-
-	auto sem_acquire = [&]() {
-		std::unique_lock<std::mutex> lock(sem_mutex);
-		sem_cv.wait(lock, [&]() { return sem_count > 0; });
-		--sem_count;
-	};
-
-	auto sem_release = [&]() {
-		{
-			std::lock_guard<std::mutex> lock(sem_mutex);
-			++sem_count;
-		}
-		sem_cv.notify_one();
-	};
-
-	std::vector<std::thread> threads;
-	threads.reserve(candidates.size());
-
-	std::atomic<int> progress{0};
-	const int total = static_cast<int>(candidates.size());
-
-	for (const auto& target_ip : candidates) {
-		sem_acquire();  // 获取信号量，控制并发数
-
-		threads.emplace_back([&, target_ip]() {
-			MYLOG_DEBUG("[MyIPTools] 正在探测 {}...", target_ip);
-
-			bool alive = PingHost(target_ip, timeout);
-
-			if (alive) {
-				std::lock_guard<std::mutex> lock(result_mutex);
-				active_ips.push_back(target_ip);
-				MYLOG_INFO("[MyIPTools] 发现活跃设备: {}", target_ip);
-			}
-
-			int done = progress.fetch_add(1) + 1;
-			if (done % 50 == 0 || done == total) {
-				MYLOG_INFO("[MyIPTools] 扫描进度: {}/{}", done, total);
-			}
-
-			sem_release();  // 释放信号量
-		});
-	}
-
-	// 等待所有线程完成
-	for (auto& t : threads) {
-		if (t.joinable()) {
-			t.join();
-		}
-	}
-
-	// 排序结果
-	std::sort(active_ips.begin(), active_ips.end(), [](const std::string& a, const std::string& b) {
-		struct in_addr aa{}, bb{};
-		::inet_pton(AF_INET, a.c_str(), &aa);
-		::inet_pton(AF_INET, b.c_str(), &bb);
-		return ntohl(aa.s_addr) < ntohl(bb.s_addr);
-	});
+	RunICMPScan("local", candidates, scan_result);
 
 	auto end_time = std::chrono::steady_clock::now();
-
-	scan_result.active_ips = std::move(active_ips);
-	scan_result.active_count = static_cast<int>(scan_result.active_ips.size());
 	scan_result.scan_duration_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
 
 	MYLOG_INFO("[MyIPTools] 扫描完成: 总计扫描 {} 个 IP, 发现 {} 个活跃设备, 耗时 {:.1f}ms",
@@ -786,76 +769,9 @@ ScanResult MyIPTools::ScanTargetSubnet(const std::string& cidr) {
 	scan_result.total_scanned = static_cast<int>(candidates.size());
 	MYLOG_INFO("[MyIPTools] 指定网段扫描: {}，待扫描 IP 总数: {}", cidr, candidates.size());
 
-	// 并发扫描（复用同样的信号量并发模型）
-	const int max_threads = s_max_threads.load();
-	const int timeout = s_ping_timeout_ms.load();
-
-	std::mutex result_mutex;
-	std::vector<std::string> active_ips;
-
-	std::mutex sem_mutex;
-	std::condition_variable sem_cv;
-	int sem_count = max_threads;
-
-	auto sem_acquire = [&]() {
-		std::unique_lock<std::mutex> lock(sem_mutex);
-		sem_cv.wait(lock, [&]() { return sem_count > 0; });
-		--sem_count;
-	};
-
-	auto sem_release = [&]() {
-		{
-			std::lock_guard<std::mutex> lock(sem_mutex);
-			++sem_count;
-		}
-		sem_cv.notify_one();
-	};
-
-	std::vector<std::thread> threads;
-	threads.reserve(candidates.size());
-
-	std::atomic<int> progress{0};
-	const int total = static_cast<int>(candidates.size());
-
-	for (const auto& target_ip : candidates) {
-		sem_acquire();
-
-		threads.emplace_back([&, target_ip]() {
-			bool alive = PingHost(target_ip, timeout);
-
-			if (alive) {
-				std::lock_guard<std::mutex> lock(result_mutex);
-				active_ips.push_back(target_ip);
-				MYLOG_INFO("[MyIPTools] 发现活跃设备: {}", target_ip);
-			}
-
-			int done = progress.fetch_add(1) + 1;
-			if (done % 50 == 0 || done == total) {
-				MYLOG_INFO("[MyIPTools] 指定网段扫描进度: {}/{}", done, total);
-			}
-
-			sem_release();
-		});
-	}
-
-	for (auto& t : threads) {
-		if (t.joinable()) {
-			t.join();
-		}
-	}
-
-	// IP 排序
-	std::sort(active_ips.begin(), active_ips.end(), [](const std::string& a, const std::string& b) {
-		struct in_addr aa{}, bb{};
-		::inet_pton(AF_INET, a.c_str(), &aa);
-		::inet_pton(AF_INET, b.c_str(), &bb);
-		return ntohl(aa.s_addr) < ntohl(bb.s_addr);
-	});
+	RunICMPScan(cidr, candidates, scan_result);
 
 	auto end_time = std::chrono::steady_clock::now();
-
-	scan_result.active_ips = std::move(active_ips);
-	scan_result.active_count = static_cast<int>(scan_result.active_ips.size());
 	scan_result.scan_duration_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
 
 	MYLOG_INFO("[MyIPTools] 指定网段扫描完成 [{}]: 扫描 {} 个 IP, 发现 {} 个活跃设备, 耗时 {:.1f}ms",
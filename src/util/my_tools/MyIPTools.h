@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+#include "IcmpScanner.h"
+
 namespace my_tools {
 
 /**
@@ -77,6 +79,16 @@ struct ScanResult {
 	std::string error;                    ///< 错误信息（为空表示无错误）
 };
 
+/**
+ * @brief 最近一次（或正在进行的）扫描进度
+ */
+struct ScanProgress {
+	bool running = false;                 ///< 是否正在扫描
+	std::string target;                   ///< 扫描目标："local"（全部本机网段）或 CIDR
+	IcmpScanProgress detail;              ///< 目标数、已探测数、已应答数、轮次与耗时
+	std::string error;                    ///< 上次扫描的错误信息
+};
+
 class MyIPTools {
 public:
 	/**
@@ -135,18 +147,29 @@ public:
 
 	/**
 	 * @brief 初始化扫描器参数
-	 * @param max_threads 最大并发线程数（默认 64）
-	 * @param timeout_ms 单个 Ping 请求超时时间（毫秒，默认 800）
+	 * @param max_threads 保留参数（事件循环扫描器不再按线程并发，仅做范围修正后记录）
+	 * @param timeout_ms 每轮发送结束后等待应答的时间（毫秒，默认 800）
+	 * @param rate_pps 发送速率（包/秒，默认 10000）
+	 * @param retries 对未应答目标的重发轮数（默认 1）
+	 */
+	static void InitScanner(int max_threads = 64, int timeout_ms = 800, int rate_pps = 10000, int retries = 1);
+
+	/**
+	 * @brief 获取当前扫描参数
+	 */
+	static IcmpScanOptions GetScanOptions();
+
+	/**
+	 * @brief 获取最近一次（或正在进行的）扫描进度
 	 */
-	static void InitScanner(int max_threads = 64, int timeout_ms = 800);
+	static ScanProgress GetScanProgress();
 
 	/**
 	 * @brief 扫描所有本机网段内的活跃设备
 	 *
 	 * 自动调用 GetAllIPs() 获取本机所有 IP / 子网，遍历各网段生成候选 IP
-	 * 列表，使用原生 ICMP Raw Socket 发送 Echo Request 并等待 Reply。
-	 * 线程模型为"即时线程"：为每个候选 IP 启动 std::thread，通过信号量
-	 * 控制最大并发数。
+	 * 列表，由 IcmpScanner 在单个 ICMP socket 上按速率发出全部 Echo Request，
+	 * 通过 epoll 异步匹配应答。进度可通过 GetScanProgress() 查询。
 	 *
 	 * 需要 CAP_NET_RAW 权限或 Root。
 	 *
@@ -158,7 +181,7 @@ public:
 	 * @brief 扫描指定网段内的活跃设备
 	 *
 	 * 接受 CIDR 格式（如 "192.168.2.0/24"），生成该网段的候选 IP 列表，
-	 * 使用原生 ICMP Raw Socket 并发探测。
+	 * 由 IcmpScanner 单 socket 批量探测（/20 网段约数百毫秒）。
 	 *
 	 * 需要 CAP_NET_RAW 权限或 Root。
 	 *
@@ -194,15 +217,25 @@ private:
 	static IPResult ModifyIP(const std::string& interface_name,
 	                         const std::string& ip, int prefix_len, bool is_add);
 
+	/**
+	 * @brief 探测候选 IP 并填充扫描结果，同时更新扫描进度
+	 */
+	static void RunICMPScan(const std::string& target, const std::vector<std::string>& candidates,
+	                        ScanResult& scan_result);
+
 	/**
 	 * @brief 计算 ICMP 校验和（RFC 1071）
 	 */
 	static uint16_t ComputeICMPChecksum(const void* data, int len);
 
-	/// 最大并发扫描线程数
+	/// 最大并发扫描线程数（保留兼容）
 	static std::atomic<int> s_max_threads;
 	/// 单个 Ping 超时时间（毫秒）
 	static std::atomic<int> s_ping_timeout_ms;
+	/// 扫描发送速率（包/秒）
+	static std::atomic<int> s_scan_rate_pps;
+	/// 扫描重发轮数
+	static std::atomic<int> s_scan_retries;
 };
 
 } // namespace my_tools
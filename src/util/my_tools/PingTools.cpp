@@ -3,37 +3,14 @@
 #include <cpr/cpr.h>
 
 #include <arpa/inet.h>
-#include <cstdlib>
 #include <cstring>
 #include <cerrno>
 #include <netinet/in.h>
-#include <sstream>
 #include <sys/socket.h>
-#include <sys/wait.h>
 #include <unistd.h>
 
 #include "MyLog.h"
-
-namespace {
-
-std::string quoteForShell(const std::string& value) {
-    std::string quoted = "'";
-    for (char ch : value) {
-        if (ch == '\'') {
-            quoted += "'\\''";
-        } else {
-            quoted.push_back(ch);
-        }
-    }
-    quoted.push_back('\'');
-    return quoted;
-}
-
-bool isExitSuccess(int status) {
-    return status != -1 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
-}
-
-} // namespace
+#include "ReachabilityProber.h"
 
 namespace my_tools::ping_tools {
 
@@ -50,24 +27,23 @@ bool PingFuncByCPR::PingURL(const std::string& url) {
 
 bool PingFuncBySystem::PingIP(const std::string& ip, int count, int timeout_sec) {
     if (ip.empty()) {
-        MYLOG_WARN("系统 ping 失败：ip 不能为空");
+        MYLOG_WARN("Ping 失败：ip 不能为空");
         return false;
     }
 
     if (count <= 0 || timeout_sec <= 0) {
-        MYLOG_WARN("系统 ping 参数非法: ip={}, count={}, timeout_sec={}", ip, count, timeout_sec);
+        MYLOG_WARN("Ping 参数非法: ip={}, count={}, timeout_sec={}", ip, count, timeout_sec);
         return false;
     }
 
-    std::ostringstream command;
-    command << "ping -c " << count
-            << " -W " << timeout_sec
-            << " " << quoteForShell(ip)
-            << " > /dev/null 2>&1";
-
-    const int status = std::system(command.str().c_str());
-    const bool reachable = isExitSuccess(status);
-    MYLOG_INFO("System ping {} -> reachable={}, raw_status={}", ip, reachable, status);
+    // 进程内探测（ICMP，无权限时退回 TCP），与 ping -c N 一致：任一次成功即可达
+    auto& prober = ReachabilityProber::GetInstance();
+    double rtt_ms = 0.0;
+    bool reachable = false;
+    for (int i = 0; i < count && !reachable; ++i) {
+        reachable = prober.ProbeOnce(ip, timeout_sec * 1000, ProbeMethod::kAuto, 80, &rtt_ms);
+    }
+    MYLOG_INFO("Ping {} -> reachable={}, rtt={:.2f}ms", ip, reachable, reachable ? rtt_ms : 0.0);
     return reachable;
 }
 
@@ -11,6 +11,12 @@ public:
 
 class PingFuncBySystem {
 public:
+    /**
+     * @brief 探测 IP 是否可达（最多 count 次，任一次成功即返回 true）
+     *
+     * 通过 ReachabilityProber 在进程内发送 ICMP Echo（无 ICMP 权限时退回 TCP connect），
+     * 不再 fork 系统 ping 命令；保留原类名与参数以兼容调用方。
+     */
     static bool PingIP(const std::string& ip, int count = 1, int timeout_sec = 1);
 
     static bool PingIPBySocket(const std::string& ip, int port = 1, int timeout_sec = 1);
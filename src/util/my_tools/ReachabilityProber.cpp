@@ -0,0 +1,583 @@
+#include "ReachabilityProber.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include "IcmpScanner.h"
+#include "MyIPTools.h"
+#include "MyLog.h"
+
+namespace my_tools {
+
+namespace {
+
+constexpr int kIcmpFilter = 1;                 ///< linux/icmp.h 中的 ICMP_FILTER
+constexpr uint8_t kEchoReply   = 0;
+constexpr uint8_t kEchoRequest = 8;
+constexpr uint64_t kWakeTag = std::numeric_limits<uint64_t>::max();      ///< epoll data：唤醒 eventfd
+constexpr uint64_t kIcmpTag = std::numeric_limits<uint64_t>::max() - 1;  ///< epoll data：ICMP socket
+constexpr int kMaxWaitMs = 1000;
+constexpr int kMaxEvents = 64;
+
+int64_t NowNs() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t UnixMs() {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint16_t RandomU16() {
+	thread_local std::mt19937 rng{std::random_device{}()};
+	return static_cast<uint16_t>(rng() & 0xFFFF);
+}
+
+bool ParseIPv4(const std::string& ip, uint32_t& addr) {
+	struct in_addr a{};
+	if (::inet_pton(AF_INET, ip.c_str(), &a) != 1) return false;
+	addr = a.s_addr;
+	return true;
+}
+
+} // namespace
+
+std::string ProbeMethodToString(ProbeMethod method) {
+	switch (method) {
+		case ProbeMethod::kIcmp: return "icmp";
+		case ProbeMethod::kTcp:  return "tcp";
+		default:                 return "auto";
+	}
+}
+
+ReachabilityProber& ReachabilityProber::GetInstance() {
+	static ReachabilityProber instance;
+	return instance;
+}
+
+ReachabilityProber::~ReachabilityProber() {
+	// 静态析构阶段日志器可能已销毁，这里不打日志
+	StopWorker();
+}
+
+// ============================================================
+//  生命周期
+// ============================================================
+
+bool ReachabilityProber::EnsureStartedLocked() {
+	if (running_) return true;
+
+	epfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+	wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (epfd_ < 0 || wake_fd_ < 0) {
+		MYLOG_ERROR("[ReachabilityProber] 初始化 epoll / eventfd 失败: {}", std::strerror(errno));
+		if (epfd_ >= 0) ::close(epfd_);
+		if (wake_fd_ >= 0) ::close(wake_fd_);
+		epfd_ = wake_fd_ = -1;
+		return false;
+	}
+	struct epoll_event ev{};
+	ev.events = EPOLLIN;
+	ev.data.u64 = kWakeTag;
+	::epoll_ctl(epfd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+	// 优先 raw socket；没有 CAP_NET_RAW 时尝试内核 ping socket；都不可用时 kAuto 退回 TCP
+	icmp_raw_ = true;
+	icmp_fd_ = ::socket(AF_INET, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+	if (icmp_fd_ < 0) {
+		icmp_raw_ = false;
+		icmp_fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+	}
+	if (icmp_fd_ >= 0) {
+		if (icmp_raw_) {
+			uint32_t filter = ~(1U << kEchoReply);
+			::setsockopt(icmp_fd_, SOL_RAW, kIcmpFilter, &filter, sizeof(filter));
+			icmp_ident_ = RandomU16();
+		}
+		ev.events = EPOLLIN;
+		ev.data.u64 = kIcmpTag;
+		::epoll_ctl(epfd_, EPOLL_CTL_ADD, icmp_fd_, &ev);
+	} else {
+		MYLOG_WARN("[ReachabilityProber] 无法创建 ICMP socket，自动模式将使用 TCP 探测: {}", std::strerror(errno));
+	}
+	next_seq_ = RandomU16();
+
+	running_ = true;
+	worker_ = std::thread(&ReachabilityProber::Loop, this);
+	MYLOG_INFO("[ReachabilityProber] 探测线程已启动，ICMP 模式: {}",
+	           icmp_fd_ < 0 ? "不可用" : (icmp_raw_ ? "raw" : "ping socket"));
+	return true;
+}
+
+void ReachabilityProber::Shutdown() {
+	if (StopWorker()) MYLOG_INFO("[ReachabilityProber] 探测线程已停止");
+}
+
+bool ReachabilityProber::StopWorker() {
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		if (!running_) return false;
+		running_ = false;
+	}
+	Wake();
+	if (worker_.joinable()) worker_.join();
+
+	std::lock_guard<std::mutex> lock(mtx_);
+	for (auto& kv : probes_) {
+		Probe& p = kv.second;
+		if (p.fd >= 0) ::close(p.fd);
+		if (p.oneshot) {
+			std::lock_guard<std::mutex> g(p.oneshot->mtx);
+			p.oneshot->done = true;
+			p.oneshot->cv.notify_all();
+		}
+	}
+	for (auto& p : queued_) {
+		std::lock_guard<std::mutex> g(p.oneshot->mtx);
+		p.oneshot->done = true;
+		p.oneshot->cv.notify_all();
+	}
+	probes_.clear();
+	icmp_seq_.clear();
+	queued_.clear();
+	targets_.clear();
+	if (icmp_fd_ >= 0) ::close(icmp_fd_);
+	if (wake_fd_ >= 0) ::close(wake_fd_);
+	if (epfd_ >= 0) ::close(epfd_);
+	icmp_fd_ = wake_fd_ = epfd_ = -1;
+	return true;
+}
+
+void ReachabilityProber::Wake() {
+	int fd = -1;
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		fd = wake_fd_;
+	}
+	if (fd < 0) return;
+	uint64_t one = 1;
+	ssize_t n = ::write(fd, &one, sizeof(one));
+	(void)n;
+}
+
+// ============================================================
+//  对外接口
+// ============================================================
+
+ReachabilityProber::Handle ReachabilityProber::Watch(const ProbeTargetOptions& options, ChangeCallback on_change) {
+	uint32_t addr = 0;
+	if (!ParseIPv4(options.ip, addr)) {
+		MYLOG_WARN("[ReachabilityProber] 非法 IP，忽略探测目标: '{}'", options.ip);
+		return 0;
+	}
+
+	Target target;
+	target.options = options;
+	target.options.interval_ms    = std::max(10, options.interval_ms);
+	target.options.timeout_ms     = std::max(1, options.timeout_ms);
+	target.options.up_threshold   = std::max(1, options.up_threshold);
+	target.options.down_threshold = std::max(1, options.down_threshold);
+	target.options.window         = std::max(1, options.window);
+	if (target.options.tcp_port <= 0 || target.options.tcp_port > 65535) target.options.tcp_port = 80;
+	target.addr = addr;
+	target.on_change = std::move(on_change);
+
+	Handle handle = 0;
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		if (!EnsureStartedLocked()) return 0;
+		if (target.options.method == ProbeMethod::kAuto) {
+			target.stats.method = icmp_fd_ >= 0 ? ProbeMethod::kIcmp : ProbeMethod::kTcp;
+		} else {
+			target.stats.method = target.options.method;
+		}
+		handle = next_handle_++;
+		targets_.emplace(handle, std::move(target));
+	}
+	Wake();
+	MYLOG_INFO("[ReachabilityProber] 开始探测 {} ({})，周期 {}ms", options.name.empty() ? options.ip : options.name,
+	           options.ip, std::max(10, options.interval_ms));
+	return handle;
+}
+
+void ReachabilityProber::Unwatch(Handle handle) {
+	std::lock_guard<std::mutex> lock(mtx_);
+	auto it = targets_.find(handle);
+	if (it == targets_.end()) return;
+	if (it->second.in_flight != 0) {
+		auto p = probes_.find(it->second.in_flight);
+		if (p != probes_.end()) {
+			if (p->second.fd >= 0) ::close(p->second.fd);
+			if (p->second.method == ProbeMethod::kIcmp) icmp_seq_.erase(p->second.seq);
+			probes_.erase(p);
+		}
+	}
+	targets_.erase(it);
+}
+
+bool ReachabilityProber::IsReachable(Handle handle) const {
+	std::lock_guard<std::mutex> lock(mtx_);
+	auto it = targets_.find(handle);
+	return it != targets_.end() && it->second.stats.reachable;
+}
+
+bool ReachabilityProber::GetStats(Handle handle, ReachabilityStats& out) const {
+	std::lock_guard<std::mutex> lock(mtx_);
+	auto it = targets_.find(handle);
+	if (it == targets_.end()) return false;
+	out = it->second.stats;
+	return true;
+}
+
+bool ReachabilityProber::ProbeOnce(const std::string& ip, int timeout_ms, ProbeMethod method,
+                                   int tcp_port, double* rtt_ms) {
+	Probe probe;
+	if (!ParseIPv4(ip, probe.addr)) return false;
+	probe.oneshot = std::make_shared<OneShot>();
+	probe.method = method;
+	probe.tcp_port = (tcp_port > 0 && tcp_port <= 65535) ? tcp_port : 80;
+	probe.timeout_ms = std::max(1, timeout_ms);
+
+	auto oneshot = probe.oneshot;
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		if (!EnsureStartedLocked()) return false;
+		if (method == ProbeMethod::kIcmp && icmp_fd_ < 0) return false;
+		queued_.push_back(std::move(probe));
+	}
+	Wake();
+
+	// 探测线程按 deadline 结束探测；额外的等待只用于防止线程异常时永久阻塞
+	std::unique_lock<std::mutex> lock(oneshot->mtx);
+	oneshot->cv.wait_for(lock, std::chrono::milliseconds(timeout_ms + kMaxWaitMs), [&]() { return oneshot->done; });
+	if (oneshot->ok && rtt_ms) *rtt_ms = oneshot->rtt_ms;
+	return oneshot->ok;
+}
+
+bool ReachabilityProber::IcmpAvailable() {
+	std::lock_guard<std::mutex> lock(mtx_);
+	return EnsureStartedLocked() && icmp_fd_ >= 0;
+}
+
+nlohmann::json ReachabilityProber::StatsToJson(const ReachabilityStats& stats) {
+	return {
+		{"reachable", stats.reachable},
+		{"last_ok", stats.last_ok},
+		{"method", ProbeMethodToString(stats.method)},
+		{"consecutive_ok", stats.consecutive_ok},
+		{"consecutive_fail", stats.consecutive_fail},
+		{"probes", stats.probes},
+		{"probes_ok", stats.probes_ok},
+		{"loss_pct", stats.loss_pct},
+		{"rtt_last_ms", stats.rtt_last_ms},
+		{"rtt_avg_ms", stats.rtt_avg_ms},
+		{"rtt_min_ms", stats.rtt_min_ms},
+		{"rtt_max_ms", stats.rtt_max_ms},
+		{"last_change_ms", stats.last_change_ms},
+	};
+}
+
+nlohmann::json ReachabilityProber::GetStatsJson() const {
+	std::lock_guard<std::mutex> lock(mtx_);
+	nlohmann::json j;
+	j["running"] = running_.load();
+	j["icmp_mode"] = icmp_fd_ < 0 ? "none" : (icmp_raw_ ? "raw" : "dgram");
+	j["in_flight"] = probes_.size();
+	j["targets"] = nlohmann::json::array();
+	for (const auto& kv : targets_) {
+		nlohmann::json t = StatsToJson(kv.second.stats);
+		t["handle"] = kv.first;
+		t["name"] = kv.second.options.name;
+		t["ip"] = kv.second.options.ip;
+		t["interval_ms"] = kv.second.options.interval_ms;
+		if (kv.second.stats.method == ProbeMethod::kTcp) t["tcp_port"] = kv.second.options.tcp_port;
+		j["targets"].push_back(std::move(t));
+	}
+	return j;
+}
+
+// ============================================================
+//  探测线程
+// ============================================================
+
+void ReachabilityProber::StartProbeLocked(Probe probe, int64_t now, std::vector<PendingCallback>& callbacks) {
+	if (probe.method == ProbeMethod::kAuto) {
+		probe.method = icmp_fd_ >= 0 ? ProbeMethod::kIcmp : ProbeMethod::kTcp;
+	}
+	probe.id = next_probe_id_++;
+	probe.sent_ns = now;
+	probe.deadline_ns = now + static_cast<int64_t>(probe.timeout_ms) * 1000000LL;
+	const uint64_t id = probe.id;
+
+	bool immediate = false;   // 已得到结果（发送失败 / connect 立即完成）
+	bool immediate_ok = false;
+
+	if (probe.method == ProbeMethod::kIcmp) {
+		if (icmp_fd_ < 0) {
+			immediate = true;
+		} else {
+			// 跳过仍被占用的 sequence（16 位空间对同时在途的探测足够）
+			while (icmp_seq_.count(next_seq_)) ++next_seq_;
+			probe.seq = next_seq_++;
+
+			ICMPHeader req{};
+			req.type     = kEchoRequest;
+			req.id       = htons(icmp_ident_);
+			req.sequence = htons(probe.seq);
+			req.checksum = IcmpScanner::Checksum(&req, sizeof(req));
+			struct sockaddr_in dest{};
+			dest.sin_family      = AF_INET;
+			dest.sin_addr.s_addr = probe.addr;
+			if (::sendto(icmp_fd_, &req, sizeof(req), 0, reinterpret_cast<struct sockaddr*>(&dest), sizeof(dest)) < 0) {
+				MYLOG_DEBUG("[ReachabilityProber] ICMP 发送失败: {}", std::strerror(errno));
+				immediate = true;
+			} else {
+				icmp_seq_[probe.seq] = id;
+			}
+		}
+	} else {
+		struct sockaddr_in dest{};
+		dest.sin_family      = AF_INET;
+		dest.sin_addr.s_addr = probe.addr;
+		dest.sin_port        = htons(static_cast<uint16_t>(probe.tcp_port));
+		probe.fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (probe.fd < 0) {
+			immediate = true;
+		} else if (::connect(probe.fd, reinterpret_cast<struct sockaddr*>(&dest), sizeof(dest)) == 0) {
+			immediate = immediate_ok = true;
+		} else if (errno == EINPROGRESS) {
+			struct epoll_event ev{};
+			ev.events = EPOLLOUT;
+			ev.data.u64 = id;
+			::epoll_ctl(epfd_, EPOLL_CTL_ADD, probe.fd, &ev);
+		} else {
+			immediate = true;
+			immediate_ok = (errno == ECONNREFUSED) && probe.tcp_refused_ok;
+		}
+	}
+
+	if (probe.target != 0) {
+		auto it = targets_.find(probe.target);
+		if (it != targets_.end()) it->second.in_flight = id;
+	}
+	probes_.emplace(id, std::move(probe));
+	if (immediate) CompleteLocked(id, immediate_ok, NowNs(), callbacks);
+}
+
+void ReachabilityProber::CompleteLocked(uint64_t probe_id, bool ok, int64_t now, std::vector<PendingCallback>& callbacks) {
+	auto it = probes_.find(probe_id);
+	if (it == probes_.end()) return;
+	Probe probe = std::move(it->second);
+	probes_.erase(it);
+
+	if (probe.fd >= 0) ::close(probe.fd);  // close 时自动从 epoll 移除
+	if (probe.method == ProbeMethod::kIcmp) {
+		auto s = icmp_seq_.find(probe.seq);
+		if (s != icmp_seq_.end() && s->second == probe_id) icmp_seq_.erase(s);
+	}
+	const double rtt_ms = static_cast<double>(now - probe.sent_ns) / 1e6;
+
+	if (probe.oneshot) {
+		std::lock_guard<std::mutex> g(probe.oneshot->mtx);
+		probe.oneshot->ok = ok;
+		probe.oneshot->rtt_ms = rtt_ms;
+		probe.oneshot->done = true;
+		probe.oneshot->cv.notify_all();
+		return;
+	}
+
+	auto t = targets_.find(probe.target);
+	if (t == targets_.end() || t->second.in_flight != probe_id) return;
+	Target& target = t->second;
+	target.in_flight = 0;
+	// 按发送时刻计算下一周期；超时长于周期时立即发起下一次
+	target.next_due_ns = std::max<int64_t>(now, probe.sent_ns + static_cast<int64_t>(target.options.interval_ms) * 1000000LL);
+	UpdateTargetLocked(target, ok, rtt_ms, callbacks);
+}
+
+void ReachabilityProber::UpdateTargetLocked(Target& target, bool ok, double rtt_ms,
+                                            std::vector<PendingCallback>& callbacks) {
+	ReachabilityStats& s = target.stats;
+	++s.probes;
+	s.last_ok = ok;
+	if (ok) {
+		++s.probes_ok;
+		++s.consecutive_ok;
+		s.consecutive_fail = 0;
+		s.rtt_last_ms = rtt_ms;
+	} else {
+		++s.consecutive_fail;
+		s.consecutive_ok = 0;
+	}
+
+	target.history.emplace_back(ok, static_cast<float>(rtt_ms));
+	while (static_cast<int>(target.history.size()) > target.options.window) target.history.pop_front();
+
+	int ok_count = 0;
+	double sum = 0.0;
+	double mn = 0.0;
+	double mx = 0.0;
+	for (const auto& h : target.history) {
+		if (!h.first) continue;
+		const double r = h.second;
+		if (ok_count == 0 || r < mn) mn = r;
+		if (ok_count == 0 || r > mx) mx = r;
+		sum += r;
+		++ok_count;
+	}
+	s.loss_pct = 100.0 * static_cast<double>(target.history.size() - ok_count) / target.history.size();
+	s.rtt_avg_ms = ok_count > 0 ? sum / ok_count : 0.0;
+	s.rtt_min_ms = mn;
+	s.rtt_max_ms = mx;
+
+	bool changed = false;
+	if (!s.reachable && s.consecutive_ok >= target.options.up_threshold) {
+		s.reachable = changed = true;
+	} else if (s.reachable && s.consecutive_fail >= target.options.down_threshold) {
+		s.reachable = false;
+		changed = true;
+	}
+	if (!changed) return;
+
+	s.last_change_ms = UnixMs();
+	MYLOG_INFO("[ReachabilityProber] {} ({}) {}，窗口丢包 {:.0f}%", target.options.name.empty() ? target.options.ip : target.options.name,
+	           target.options.ip, s.reachable ? "可达" : "不可达", s.loss_pct);
+	if (target.on_change) callbacks.push_back({target.on_change, s.reachable, s});
+}
+
+void ReachabilityProber::DrainIcmpLocked(int64_t now, std::vector<PendingCallback>& callbacks) {
+	uint8_t buf[1500];
+	while (true) {
+		struct sockaddr_in from{};
+		socklen_t from_len = sizeof(from);
+		ssize_t n = ::recvfrom(icmp_fd_, buf, sizeof(buf), 0, reinterpret_cast<struct sockaddr*>(&from), &from_len);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			break;
+		}
+
+		// raw socket 带 IP 头，ping socket 只有 ICMP 部分（identifier 由内核按 socket 过滤）
+		size_t offset = 0;
+		if (icmp_raw_) {
+			if (n < 20) continue;
+			offset = static_cast<size_t>(buf[0] & 0x0F) * 4;
+		}
+		if (static_cast<size_t>(n) < offset + sizeof(ICMPHeader)) continue;
+
+		ICMPHeader reply{};
+		std::memcpy(&reply, buf + offset, sizeof(reply));
+		if (reply.type != kEchoReply) continue;
+		if (icmp_raw_ && ntohs(reply.id) != icmp_ident_) continue;  // IcmpScanner / PingHost 的应答
+
+		auto s = icmp_seq_.find(ntohs(reply.sequence));
+		if (s == icmp_seq_.end()) continue;
+		auto p = probes_.find(s->second);
+		if (p == probes_.end() || p->second.addr != from.sin_addr.s_addr) continue;
+		CompleteLocked(s->second, true, now, callbacks);
+	}
+}
+
+void ReachabilityProber::Loop() {
+	std::vector<PendingCallback> callbacks;
+	struct epoll_event events[kMaxEvents];
+
+	auto run_callbacks = [&callbacks]() {
+		for (auto& c : callbacks) {
+			try {
+				c.cb(c.reachable, c.stats);
+			} catch (const std::exception& e) {
+				MYLOG_ERROR("[ReachabilityProber] 状态回调异常: {}", e.what());
+			}
+		}
+		callbacks.clear();
+	};
+
+	while (running_) {
+		int wait_ms = kMaxWaitMs;
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			int64_t now = NowNs();
+
+			std::vector<Probe> queued;
+			queued.swap(queued_);
+			for (auto& p : queued) StartProbeLocked(std::move(p), now, callbacks);
+
+			for (auto& kv : targets_) {
+				Target& t = kv.second;
+				if (t.in_flight != 0 || t.next_due_ns > now) continue;
+				Probe p;
+				p.target = kv.first;
+				p.addr = t.addr;
+				p.method = t.stats.method;
+				p.tcp_port = t.options.tcp_port;
+				p.tcp_refused_ok = t.options.tcp_refused_ok;
+				p.timeout_ms = t.options.timeout_ms;
+				StartProbeLocked(std::move(p), now, callbacks);
+			}
+
+			now = NowNs();
+			std::vector<uint64_t> expired;
+			int64_t next_event = now + static_cast<int64_t>(kMaxWaitMs) * 1000000LL;
+			for (const auto& kv : probes_) {
+				if (kv.second.deadline_ns <= now) {
+					expired.push_back(kv.first);
+				} else {
+					next_event = std::min(next_event, kv.second.deadline_ns);
+				}
+			}
+			for (uint64_t id : expired) CompleteLocked(id, false, now, callbacks);
+			for (const auto& kv : targets_) {
+				if (kv.second.in_flight == 0) next_event = std::min(next_event, kv.second.next_due_ns);
+			}
+			wait_ms = static_cast<int>(std::max<int64_t>(0, (next_event - now + 999999) / 1000000));
+		}
+		run_callbacks();
+
+		int n = ::epoll_wait(epfd_, events, kMaxEvents, wait_ms);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			MYLOG_ERROR("[ReachabilityProber] epoll_wait 失败: {}", std::strerror(errno));
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			continue;
+		}
+		if (n == 0) continue;
+
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			const int64_t now = NowNs();
+			for (int i = 0; i < n; ++i) {
+				const uint64_t tag = events[i].data.u64;
+				if (tag == kWakeTag) {
+					uint64_t v = 0;
+					ssize_t r = ::read(wake_fd_, &v, sizeof(v));
+					(void)r;
+				} else if (tag == kIcmpTag) {
+					DrainIcmpLocked(now, callbacks);
+				} else {
+					auto p = probes_.find(tag);
+					if (p == probes_.end()) continue;  // 已超时或已取消
+					int err = 0;
+					socklen_t len = sizeof(err);
+					::getsockopt(p->second.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+					const bool ok = err == 0 || (err == ECONNREFUSED && p->second.tcp_refused_ok);
+					CompleteLocked(tag, ok, now, callbacks);
+				}
+			}
+		}
+		run_callbacks();
+	}
+}
+
+} // namespace my_tools
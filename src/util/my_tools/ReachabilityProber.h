@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace my_tools {
+
+/**
+ * @brief 探测方式
+ */
+enum class ProbeMethod {
+	kAuto = 0,   ///< 有 ICMP socket 权限时用 ICMP，否则 TCP connect
+	kIcmp,       ///< ICMP Echo（raw socket，或内核 ping socket）
+	kTcp,        ///< 非阻塞 TCP connect
+};
+
+std::string ProbeMethodToString(ProbeMethod method);
+
+/**
+ * @brief 持续探测目标的参数
+ */
+struct ProbeTargetOptions {
+	std::string ip;                    ///< IPv4 地址
+	std::string name;                  ///< 调用方标识，用于日志与统计输出
+	ProbeMethod method = ProbeMethod::kAuto;
+	int tcp_port = 80;                 ///< TCP 探测端口
+	bool tcp_refused_ok = true;        ///< 对端回 RST（端口未监听）是否算可达；检查具体服务时设为 false
+	int interval_ms = 1000;            ///< 探测周期（上一次探测结束前不会发起下一次）
+	int timeout_ms = 1000;             ///< 单次探测超时
+	int up_threshold = 1;              ///< 连续成功 N 次判定为可达
+	int down_threshold = 3;            ///< 连续失败 N 次判定为不可达
+	int window = 20;                   ///< 丢包率 / RTT 统计窗口（最近 N 次探测）
+};
+
+/**
+ * @brief 目标的去抖状态与统计
+ */
+struct ReachabilityStats {
+	bool reachable = false;            ///< 去抖后的状态（初始为不可达）
+	bool last_ok = false;              ///< 最近一次探测结果
+	ProbeMethod method = ProbeMethod::kAuto;  ///< 实际使用的探测方式
+	int consecutive_ok = 0;
+	int consecutive_fail = 0;
+	uint64_t probes = 0;               ///< 累计探测次数
+	uint64_t probes_ok = 0;            ///< 累计成功次数
+	double loss_pct = 0.0;             ///< 窗口内丢包率（%）
+	double rtt_last_ms = 0.0;
+	double rtt_avg_ms = 0.0;           ///< 窗口内成功探测的 RTT
+	double rtt_min_ms = 0.0;
+	double rtt_max_ms = 0.0;
+	int64_t last_change_ms = 0;        ///< 最近一次状态切换的 unix 毫秒时间（0 表示从未切换）
+};
+
+/**
+ * @brief 进程内可达性探测服务（单例）
+ *
+ * 所有调用方的探测共用一个后台线程、一个 epoll 与一个 ICMP socket：
+ * - ICMP：优先 raw socket，没有 CAP_NET_RAW 时退回内核 ping socket，按 sequence + 来源地址匹配应答；
+ * - TCP：每次探测一个非阻塞 connect，由 epoll 等待可写后读取 SO_ERROR。
+ * Watch() 注册的目标按周期探测，并内置连续成功 / 失败次数去抖和窗口统计；
+ * ProbeOnce() 提供同步的单次探测，用于替代 system("ping ...")。
+ *
+ * 状态变化回调在探测线程中执行（不持有内部锁），回调内不要调用 ProbeOnce / Shutdown。
+ */
+class ReachabilityProber {
+public:
+	using Handle = uint64_t;
+	using ChangeCallback = std::function<void(bool reachable, const ReachabilityStats& stats)>;
+
+	static ReachabilityProber& GetInstance();
+
+	ReachabilityProber(const ReachabilityProber&) = delete;
+	ReachabilityProber& operator=(const ReachabilityProber&) = delete;
+
+	/**
+	 * @brief 注册持续探测目标
+	 * @return 句柄；IP 非法时返回 0
+	 */
+	Handle Watch(const ProbeTargetOptions& options, ChangeCallback on_change = nullptr);
+
+	/// 取消探测目标（进行中的探测结果被丢弃）
+	void Unwatch(Handle handle);
+
+	/// 去抖后的可达状态；句柄无效时返回 false
+	bool IsReachable(Handle handle) const;
+
+	/// 读取目标统计；句柄无效时返回 false
+	bool GetStats(Handle handle, ReachabilityStats& out) const;
+
+	/**
+	 * @brief 同步探测一次
+	 * @param rtt_ms 可选，成功时写入 RTT
+	 * @return true 可达
+	 */
+	bool ProbeOnce(const std::string& ip, int timeout_ms = 1000, ProbeMethod method = ProbeMethod::kAuto,
+	               int tcp_port = 80, double* rtt_ms = nullptr);
+
+	/// 是否拿到了 ICMP socket（raw 或 ping socket）
+	bool IcmpAvailable();
+
+	/// 所有目标的状态与统计
+	nlohmann::json GetStatsJson() const;
+
+	/// 停止探测线程并清空所有目标
+	void Shutdown();
+
+private:
+	ReachabilityProber() = default;
+	~ReachabilityProber();
+
+	/// 单次探测的等待结果（ProbeOnce 使用）
+	struct OneShot {
+		std::mutex mtx;
+		std::condition_variable cv;
+		bool done = false;
+		bool ok = false;
+		double rtt_ms = 0.0;
+	};
+
+	/// 进行中的探测
+	struct Probe {
+		uint64_t id = 0;
+		Handle target = 0;                 ///< 0 表示单次探测
+		std::shared_ptr<OneShot> oneshot;
+		uint32_t addr = 0;                 ///< 网络字节序
+		ProbeMethod method = ProbeMethod::kIcmp;
+		int tcp_port = 80;
+		bool tcp_refused_ok = true;
+		int timeout_ms = 1000;
+		int fd = -1;                       ///< TCP socket
+		uint16_t seq = 0;                  ///< ICMP sequence
+		int64_t sent_ns = 0;
+		int64_t deadline_ns = 0;
+	};
+
+	struct Target {
+		ProbeTargetOptions options;
+		uint32_t addr = 0;
+		ChangeCallback on_change;
+		ReachabilityStats stats;
+		std::deque<std::pair<bool, float>> history;  ///< 窗口内 (是否成功, RTT 毫秒)
+		int64_t next_due_ns = 0;
+		uint64_t in_flight = 0;            ///< 进行中的探测 id，0 表示空闲
+	};
+
+	/// 回调在释放锁后执行
+	struct PendingCallback {
+		ChangeCallback cb;
+		bool reachable = false;
+		ReachabilityStats stats;
+	};
+
+	bool EnsureStartedLocked();
+	bool StopWorker();                 ///< 停止线程并释放资源，返回此前是否在运行
+	void Wake();
+	void Loop();
+	void StartProbeLocked(Probe probe, int64_t now, std::vector<PendingCallback>& callbacks);
+	void CompleteLocked(uint64_t probe_id, bool ok, int64_t now, std::vector<PendingCallback>& callbacks);
+	void DrainIcmpLocked(int64_t now, std::vector<PendingCallback>& callbacks);
+	void UpdateTargetLocked(Target& target, bool ok, double rtt_ms, std::vector<PendingCallback>& callbacks);
+	static nlohmann::json StatsToJson(const ReachabilityStats& stats);
+
+	mutable std::mutex mtx_;
+	std::thread worker_;
+	std::atomic<bool> running_{false};
+	int epfd_ = -1;
+	int wake_fd_ = -1;
+	int icmp_fd_ = -1;
+	bool icmp_raw_ = false;
+	uint16_t icmp_ident_ = 0;
+	uint16_t next_seq_ = 0;
+
+	Handle next_handle_ = 1;
+	uint64_t next_probe_id_ = 1;
+	std::unordered_map<Handle, Target> targets_;
+	std::unordered_map<uint64_t, Probe> probes_;         ///< 进行中的探测
+	std::unordered_map<uint16_t, uint64_t> icmp_seq_;    ///< ICMP sequence -> 探测 id
+	std::vector<Probe> queued_;                          ///< 待发起的单次探测
+};
+
+} // namespace my_tools
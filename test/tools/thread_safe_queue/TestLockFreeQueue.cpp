@@ -0,0 +1,185 @@
+#include "lock_free_queue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using tools::thread_safe_queue::MpmcQueue;
+using tools::thread_safe_queue::SpscQueue;
+
+// 两种队列共用的用例
+template <typename Q>
+class LockFreeQueueTest : public ::testing::Test {};
+
+using QueueTypes = ::testing::Types<SpscQueue<std::string>, MpmcQueue<std::string>>;
+TYPED_TEST_SUITE(LockFreeQueueTest, QueueTypes);
+
+// --------------------- 容量与基本收发 ------------------------
+TYPED_TEST(LockFreeQueueTest, CapacityRoundsUpAndNonBlockingFull) {
+    TypeParam q(5);
+    EXPECT_EQ(q.capacity(), 8u);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(q.push(std::to_string(i), false));
+    }
+    EXPECT_FALSE(q.push("overflow", false));
+    EXPECT_EQ(q.size(), 8u);
+
+    std::string value;
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(q.pop(value, false));
+        EXPECT_EQ(value, std::to_string(i));
+    }
+    EXPECT_FALSE(q.pop(value, false));
+    EXPECT_TRUE(q.empty());
+}
+
+// --------------------- emplace / 移动 ------------------------
+TYPED_TEST(LockFreeQueueTest, EmplaceAndMovePush) {
+    TypeParam q(4);
+    EXPECT_TRUE(q.emplace(3, 'x'));
+    std::string moved(64, 'm');
+    EXPECT_TRUE(q.push(std::move(moved)));
+
+    std::string value;
+    ASSERT_TRUE(q.pop(value));
+    EXPECT_EQ(value, "xxx");
+    ASSERT_TRUE(q.pop(value));
+    EXPECT_EQ(value, std::string(64, 'm'));
+}
+
+// --------------------- 超时 ------------------------
+TYPED_TEST(LockFreeQueueTest, PopTimeout) {
+    TypeParam q(4);
+    std::string value;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(q.pop(value, true, 50));
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_GE(elapsed, 45);
+    EXPECT_LT(elapsed, 1000);
+
+    ASSERT_TRUE(q.push("a"));
+    ASSERT_TRUE(q.push("b"));
+    ASSERT_TRUE(q.push("c"));
+    ASSERT_TRUE(q.push("d"));
+    EXPECT_FALSE(q.push_for("e", 20));
+}
+
+// --------------------- shutdown ------------------------
+TYPED_TEST(LockFreeQueueTest, ShutdownWakesWaitersAndDrains) {
+    TypeParam q(4);
+    std::string value;
+    std::thread waiter([&] { EXPECT_FALSE(q.pop(value)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    q.shutdown();
+    waiter.join();
+
+    TypeParam q2(4);
+    ASSERT_TRUE(q2.push("left"));
+    q2.shutdown();
+    EXPECT_FALSE(q2.push("rejected"));
+    ASSERT_TRUE(q2.pop(value));
+    EXPECT_EQ(value, "left");
+    EXPECT_FALSE(q2.pop(value));
+}
+
+// --------------------- pop_n ------------------------
+TYPED_TEST(LockFreeQueueTest, PopNTakesAvailableUpToLimit) {
+    TypeParam q(16);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(q.push(std::to_string(i)));
+    }
+    std::vector<std::string> out;
+    EXPECT_EQ(q.pop_n(out, 4), 4u);
+    EXPECT_EQ(q.pop_n(out, 100), 6u);
+    ASSERT_EQ(out.size(), 10u);
+    EXPECT_EQ(out.front(), "0");
+    EXPECT_EQ(out.back(), "9");
+    EXPECT_EQ(q.pop_n(out, 4, true, 20), 0u);
+}
+
+// --------------------- 析构释放剩余元素 ------------------------
+TYPED_TEST(LockFreeQueueTest, DestructorReleasesRemaining) {
+    auto tracker = std::make_shared<int>(0);
+    {
+        using Q = typename std::conditional<std::is_same<TypeParam, SpscQueue<std::string>>::value,
+                                            SpscQueue<std::shared_ptr<int>>,
+                                            MpmcQueue<std::shared_ptr<int>>>::type;
+        Q q(8);
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_TRUE(q.push(tracker));
+        }
+        EXPECT_EQ(tracker.use_count(), 6);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+// --------------------- 并发：SPSC 保序 ------------------------
+TEST(SpscQueueTest, ConcurrentOrderPreserved) {
+    SpscQueue<uint64_t> q(64);
+    constexpr uint64_t kCount = 200000;
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < kCount; ++i) {
+            ASSERT_TRUE(q.push(i));
+        }
+    });
+    uint64_t expect = 0;
+    std::vector<uint64_t> batch;
+    while (expect < kCount) {
+        batch.clear();
+        q.pop_n(batch, 32);
+        for (uint64_t v : batch) {
+            ASSERT_EQ(v, expect);
+            ++expect;
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(q.empty());
+}
+
+// --------------------- 并发：MPMC 不丢不重 ------------------------
+TEST(MpmcQueueTest, ConcurrentNoLossNoDuplicate) {
+    MpmcQueue<uint64_t> q(128);
+    constexpr int      kProducers = 4;
+    constexpr int      kConsumers = 4;
+    constexpr uint64_t kPerProducer = 50000;
+
+    std::vector<std::atomic<uint8_t>> seen(kProducers * kPerProducer);
+    std::atomic<uint64_t> consumed{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint64_t i = 0; i < kPerProducer; ++i) {
+                ASSERT_TRUE(q.push(p * kPerProducer + i));
+            }
+        });
+    }
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&] {
+            uint64_t v;
+            while (q.pop(v)) {
+                seen[v].fetch_add(1, std::memory_order_relaxed);
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (int p = 0; p < kProducers; ++p) {
+        threads[p].join();
+    }
+    while (!q.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    q.shutdown();
+    for (size_t i = kProducers; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+
+    EXPECT_EQ(consumed.load(), kProducers * kPerProducer);
+    for (auto& s : seen) {
+        ASSERT_EQ(s.load(), 1);
+    }
+}
@@ -0,0 +1,133 @@
+#include "lock_free_queue.h"
+#include "thread_safe_queue.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using tools::thread_safe_queue::MpmcQueue;
+using tools::thread_safe_queue::SpscQueue;
+using tools::thread_safe_queue::ThreadSafeQueue;
+
+// =============================================================================
+// 队列性能基准
+//
+// 不同生产者/消费者数下对比 ThreadSafeQueue（关闭日志）、SpscQueue、MpmcQueue：
+//   - 吞吐：每秒传递的元素数
+//   - 延迟：元素入队时记录 steady_clock 时间戳，出队时计算差值，取 p50 / p99
+// 元素总数可用环境变量 QUEUE_BENCH_ITEMS 调整（默认 200000）
+// =============================================================================
+
+namespace {
+
+struct BenchResult {
+    double   items_per_sec = 0.0;
+    uint64_t p50_ns        = 0;
+    uint64_t p99_ns        = 0;
+};
+
+uint64_t NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t BenchItems() {
+    const char* env = std::getenv("QUEUE_BENCH_ITEMS");
+    if (env != nullptr) {
+        const long long v = std::atoll(env);
+        if (v > 0) {
+            return static_cast<uint64_t>(v);
+        }
+    }
+    return 200000;
+}
+
+// Q 需提供 push(uint64_t) / pop(uint64_t&) / shutdown()
+template <typename Q>
+BenchResult RunBench(Q& q, int producers, int consumers, uint64_t total) {
+    const uint64_t per_producer = total / producers;
+    const uint64_t expected     = per_producer * producers;
+
+    std::atomic<uint64_t> consumed{0};
+    std::vector<std::vector<uint64_t>> latencies(consumers);
+    std::vector<std::thread> threads;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            auto& lat = latencies[c];
+            lat.reserve(expected / consumers + 1024);
+            uint64_t ts;
+            while (q.pop(ts)) {
+                lat.push_back(NowNs() - ts);
+                if (consumed.fetch_add(1, std::memory_order_relaxed) + 1 == expected) {
+                    q.shutdown();
+                }
+            }
+        });
+    }
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                q.push(NowNs());
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<uint64_t> all;
+    all.reserve(expected);
+    for (auto& lat : latencies) {
+        all.insert(all.end(), lat.begin(), lat.end());
+    }
+    BenchResult r;
+    r.items_per_sec = sec > 0 ? static_cast<double>(all.size()) / sec : 0.0;
+    if (!all.empty()) {
+        std::nth_element(all.begin(), all.begin() + all.size() / 2, all.end());
+        r.p50_ns = all[all.size() / 2];
+        std::nth_element(all.begin(), all.begin() + all.size() * 99 / 100, all.end());
+        r.p99_ns = all[all.size() * 99 / 100];
+    }
+    EXPECT_EQ(all.size(), expected);
+    return r;
+}
+
+void Print(const char* name, int producers, int consumers, const BenchResult& r) {
+    std::printf("[QueueBench] %-16s %dP%dC  %12.0f items/s  p50=%8llu ns  p99=%10llu ns\n",
+                name, producers, consumers, r.items_per_sec,
+                static_cast<unsigned long long>(r.p50_ns),
+                static_cast<unsigned long long>(r.p99_ns));
+}
+
+} // namespace
+
+TEST(LockFreeQueueBench, ThroughputAndLatency) {
+    const uint64_t total = BenchItems();
+    constexpr size_t kCapacity = 1024;
+
+    {
+        SpscQueue<uint64_t> q(kCapacity);
+        Print("SpscQueue", 1, 1, RunBench(q, 1, 1, total));
+    }
+
+    const int pcs[][2] = {{1, 1}, {2, 2}, {4, 4}, {4, 1}};
+    for (const auto& pc : pcs) {
+        {
+            ThreadSafeQueue<uint64_t> q(false);
+            q.init(kCapacity);
+            Print("ThreadSafeQueue", pc[0], pc[1], RunBench(q, pc[0], pc[1], total));
+        }
+        {
+            MpmcQueue<uint64_t> q(kCapacity);
+            Print("MpmcQueue", pc[0], pc[1], RunBench(q, pc[0], pc[1], total));
+        }
+    }
+}
@@ -5,6 +5,7 @@
  * 测试覆盖：
  *   - ValidateFilename 入参校验（合法/非法场景）
  *   - CacheErrorToHttpCode 错误码→HTTP 状态码映射
+ *   - ParseRangeHeader 下载 Range 请求头解析
  *   - 与 MyCache 集成的完整上传/查询/删除/列表流程
  */
 
@@ -153,6 +154,50 @@ TEST(FileApi_ErrorMapping, AllCodesMapCorrectly) {
     EXPECT_EQ(CacheErrorToHttpCode(CacheErrorCode::InvalidArgument), 400);
     EXPECT_EQ(CacheErrorToHttpCode(CacheErrorCode::CreateDirFailed), 500);
     EXPECT_EQ(CacheErrorToHttpCode(CacheErrorCode::FileTooLarge), 413);
+    EXPECT_EQ(CacheErrorToHttpCode(CacheErrorCode::OffsetMismatch), 409);
+    EXPECT_EQ(CacheErrorToHttpCode(CacheErrorCode::UploadIncomplete), 409);
+}
+
+// ============================================================================
+// ParseRangeHeader 测试
+// ============================================================================
+
+/// 单区间的三种形式
+TEST(FileApi_RangeHeader, SingleRangeForms) {
+    ByteRange r;
+    ASSERT_EQ(ParseRangeHeader("bytes=0-99", 1000, r), RangeParseResult::Partial);
+    EXPECT_EQ(r.start, 0u);
+    EXPECT_EQ(r.length, 100u);
+
+    ASSERT_EQ(ParseRangeHeader("bytes=900-", 1000, r), RangeParseResult::Partial);
+    EXPECT_EQ(r.start, 900u);
+    EXPECT_EQ(r.length, 100u);
+
+    ASSERT_EQ(ParseRangeHeader("bytes=-10", 1000, r), RangeParseResult::Partial);
+    EXPECT_EQ(r.start, 990u);
+    EXPECT_EQ(r.length, 10u);
+
+    // 结束位置超出文件末尾时截断；后缀长度超过文件大小时返回整个文件
+    ASSERT_EQ(ParseRangeHeader("bytes=500-5000", 1000, r), RangeParseResult::Partial);
+    EXPECT_EQ(r.length, 500u);
+    ASSERT_EQ(ParseRangeHeader("bytes=-5000", 1000, r), RangeParseResult::Partial);
+    EXPECT_EQ(r.start, 0u);
+    EXPECT_EQ(r.length, 1000u);
+}
+
+/// 无法满足与无法识别的区间
+TEST(FileApi_RangeHeader, UnsatisfiableAndIgnored) {
+    ByteRange r;
+    EXPECT_EQ(ParseRangeHeader("bytes=1000-", 1000, r), RangeParseResult::Unsatisfiable);
+    EXPECT_EQ(ParseRangeHeader("bytes=-0", 1000, r), RangeParseResult::Unsatisfiable);
+    EXPECT_EQ(ParseRangeHeader("bytes=0-", 0, r), RangeParseResult::Unsatisfiable);
+
+    EXPECT_EQ(ParseRangeHeader("", 1000, r), RangeParseResult::None);
+    EXPECT_EQ(ParseRangeHeader("items=0-1", 1000, r), RangeParseResult::None);
+    EXPECT_EQ(ParseRangeHeader("bytes=0-1,5-6", 1000, r), RangeParseResult::None);
+    EXPECT_EQ(ParseRangeHeader("bytes=9-3", 1000, r), RangeParseResult::None);
+    EXPECT_EQ(ParseRangeHeader("bytes=a-3", 1000, r), RangeParseResult::None);
+    EXPECT_EQ(ParseRangeHeader("bytes=99999999999999999999999-", 1000, r), RangeParseResult::None);
 }
 
 // ============================================================================
@@ -262,7 +307,7 @@ TEST(FileApi_Integration, ListFilesReturnsCorrectMetadata) {
             EXPECT_FALSE(fi.name.empty());
             EXPECT_GT(fi.size, 0u);
             EXPECT_FALSE(fi.type.empty());
-            EXPECT_FALSE(fi.modified_at.empty());
+            EXPECT_GT(fi.modified_at_ms, 0);
         }
     }
     CleanupDir(dir);
@@ -0,0 +1,492 @@
+/**
+ * @file TestMyAPIServer.cpp
+ * @brief MyAPI 服务运行参数、阻塞调用卸载与连接处理性能基准
+ *
+ * 测试覆盖：
+ *   - ApiServerOptions 解析（默认值 / 合法配置 / 非法配置不修改原值）
+ *   - BaseApiController::runBlocking：正常返回、超时 504、异常 500、子系统预算限制并发
+ *   - 响应缓存：代号不变时复用响应体，ETag / If-None-Match 返回 304，代号变化后重新构建
+ *   - 进程内压测（oatpp 虚拟网络接口，无真实 socket）：threaded / pooled 两种连接处理模式下
+ *     /v1/edges/status、/v1/flycontrol/status、/v1/cache/list 的 req/s 与 p99 延迟
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "ApiServerOptions.h"
+#include "BaseApiController.hpp"
+#include "PooledHttpConnectionHandler.h"
+#include "controller/demo/edges/EdgesController.hpp"
+#include "controller/file_cache/FileApiController.h"
+#include "controller/fly_control/FlyControlController.h"
+#include "MyCacheProvider.h"
+#include "MyExecutor.h"
+
+#include "oatpp/core/base/Environment.hpp"
+#include "oatpp/network/Server.hpp"
+#include "oatpp/network/virtual_/Interface.hpp"
+#include "oatpp/network/virtual_/client/ConnectionProvider.hpp"
+#include "oatpp/network/virtual_/server/ConnectionProvider.hpp"
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+#include "oatpp/web/client/HttpRequestExecutor.hpp"
+#include "oatpp/web/protocol/http/outgoing/BufferBody.hpp"
+#include "oatpp/web/server/HttpConnectionHandler.hpp"
+
+using namespace my_api;
+using json = nlohmann::json;
+
+// ============================================================================
+// 测试辅助
+// ============================================================================
+
+namespace {
+
+class OatppEnv {
+public:
+    OatppEnv() { oatpp::base::Environment::init(); }
+    ~OatppEnv() { oatpp::base::Environment::destroy(); }
+};
+
+// 暴露 runBlocking 供测试调用
+class ProbeController : public base::BaseApiController {
+public:
+    ProbeController()
+        : base::BaseApiController(oatpp::parser::json::mapping::ObjectMapper::createShared()) {}
+
+    base::OutgoingResponsePtr Call(const std::string& route,
+                                   std::function<base::OutgoingResponsePtr()> fn,
+                                   int timeout_ms = 0) {
+        return runBlocking(route, std::move(fn), timeout_ms);
+    }
+
+    base::OutgoingResponsePtr Ok() { return jsonOk({{"value", 1}}); }
+
+    base::OutgoingResponsePtr Cached(const std::shared_ptr<IncomingRequest>& request,
+                                     const std::string& key,
+                                     std::uint64_t generation,
+                                     const std::function<std::string()>& build) {
+        return cachedJsonResponse(request, key, generation, build);
+    }
+};
+
+int StatusOf(const base::OutgoingResponsePtr& response) {
+    return response ? response->getStatus().code : -1;
+}
+
+ApiServerOptions TestBlockingOptions(const std::string& subsystem, int budget) {
+    ApiServerOptions options;
+    options.blocking_subsystem = subsystem;
+    options.blocking_budget = budget;
+    options.blocking_timeout_ms = 2000;
+    my_executor::MyExecutor::GetInstance().SetSubsystemBudget(subsystem, budget);
+    base::BaseApiController::SetBlockingCallOptions(options);
+    return options;
+}
+
+int EnvInt(const char* name, int fallback) {
+    const char* v = std::getenv(name);
+    if (v == nullptr) return fallback;
+    const int n = std::atoi(v);
+    return n > 0 ? n : fallback;
+}
+
+} // namespace
+
+// ============================================================================
+// ApiServerOptions
+// ============================================================================
+
+TEST(MyAPIServer_Options, DefaultsAndRouteTimeout) {
+    ApiServerOptions options;
+    EXPECT_EQ(options.mode, ServerMode::Threaded);
+    EXPECT_GE(options.EffectiveWorkerThreads(), 4);
+    EXPECT_EQ(options.TimeoutFor("ip.scan"), options.blocking_timeout_ms);
+
+    options.route_timeouts_ms["ip.scan"] = 60000;
+    EXPECT_EQ(options.TimeoutFor("ip.scan"), 60000);
+    EXPECT_EQ(options.TimeoutFor("pod.ptz"), options.blocking_timeout_ms);
+}
+
+TEST(MyAPIServer_Options, ParseValidConfig) {
+    const json cfg = {
+        {"mode", "pooled"},
+        {"worker_threads", 6},
+        {"max_pending_connections", 10},
+        {"keep_alive_timeout_ms", 0},
+        {"blocking_budget", 3},
+        {"route_timeouts_ms", {{"pod.ptz", 3000}}}
+    };
+    ApiServerOptions options;
+    std::string err;
+    ASSERT_TRUE(ApiServerOptions::FromJson(cfg, options, &err)) << err;
+    EXPECT_EQ(options.mode, ServerMode::Pooled);
+    EXPECT_EQ(options.EffectiveWorkerThreads(), 6);
+    EXPECT_EQ(options.max_pending_connections, 10);
+    EXPECT_EQ(options.keep_alive_timeout_ms, 0);
+    EXPECT_EQ(options.blocking_budget, 3);
+    EXPECT_EQ(options.blocking_subsystem, "api_blocking");
+    EXPECT_EQ(options.TimeoutFor("pod.ptz"), 3000);
+    EXPECT_EQ(options.ToJson()["mode"], "pooled");
+}
+
+TEST(MyAPIServer_Options, InvalidConfigLeavesOptionsUnchanged) {
+    ApiServerOptions options;
+    options.worker_threads = 5;
+    std::string err;
+
+    EXPECT_FALSE(ApiServerOptions::FromJson({{"mode", "async"}}, options, &err));
+    EXPECT_NE(err.find("mode"), std::string::npos);
+
+    EXPECT_FALSE(ApiServerOptions::FromJson({{"worker_threads", 2}, {"blocking_timeout_ms", 0}}, options, &err));
+    EXPECT_EQ(options.worker_threads, 5);
+
+    EXPECT_FALSE(ApiServerOptions::FromJson({{"route_timeouts_ms", {{"ip.scan", -1}}}}, options, &err));
+    EXPECT_NE(err.find("ip.scan"), std::string::npos);
+    EXPECT_TRUE(options.route_timeouts_ms.empty());
+}
+
+// ============================================================================
+// runBlocking
+// ============================================================================
+
+TEST(MyAPIServer_RunBlocking, ReturnsHandlerResponse) {
+    OatppEnv env;
+    TestBlockingOptions("api_blocking_test", 2);
+    auto controller = std::make_shared<ProbeController>();
+
+    auto response = controller->Call("probe", [controller] { return controller->Ok(); });
+    EXPECT_EQ(StatusOf(response), 200);
+}
+
+TEST(MyAPIServer_RunBlocking, TimeoutReturns504AndSkipsQueuedCall) {
+    OatppEnv env;
+    TestBlockingOptions("api_blocking_timeout_test", 1);
+    auto controller = std::make_shared<ProbeController>();
+    auto ran = std::make_shared<std::atomic<int>>(0);
+
+    // 第一个调用占住唯一名额并超时，第二个调用在子系统内排队期间超时，之后不应再执行
+    auto slow = [controller, ran] {
+        ran->fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        return controller->Ok();
+    };
+    EXPECT_EQ(StatusOf(controller->Call("probe.slow", slow, 50)), 504);
+    EXPECT_EQ(StatusOf(controller->Call("probe.slow", slow, 50)), 504);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(700));
+    EXPECT_EQ(ran->load(), 1);
+}
+
+TEST(MyAPIServer_RunBlocking, ExceptionReturns500) {
+    OatppEnv env;
+    TestBlockingOptions("api_blocking_test", 2);
+    auto controller = std::make_shared<ProbeController>();
+
+    auto response = controller->Call("probe.throw", []() -> base::OutgoingResponsePtr {
+        throw std::runtime_error("boom");
+    });
+    EXPECT_EQ(StatusOf(response), 500);
+}
+
+TEST(MyAPIServer_RunBlocking, BudgetBoundsConcurrentCalls) {
+    OatppEnv env;
+    TestBlockingOptions("api_blocking_budget_test", 2);
+    auto controller = std::make_shared<ProbeController>();
+
+    auto running = std::make_shared<std::atomic<int>>(0);
+    auto peak = std::make_shared<std::atomic<int>>(0);
+    std::vector<std::thread> callers;
+    std::atomic<int> ok{0};
+    for (int i = 0; i < 6; ++i) {
+        callers.emplace_back([&, controller, running, peak] {
+            auto response = controller->Call("probe.budget", [controller, running, peak] {
+                const int now = running->fetch_add(1) + 1;
+                int prev = peak->load();
+                while (now > prev && !peak->compare_exchange_weak(prev, now)) {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                running->fetch_sub(1);
+                return controller->Ok();
+            });
+            if (StatusOf(response) == 200) ok.fetch_add(1);
+        });
+    }
+    for (auto& t : callers) t.join();
+
+    EXPECT_EQ(ok.load(), 6);
+    EXPECT_LE(peak->load(), 2);
+}
+
+// ============================================================================
+// 进程内压测
+//
+// 服务端与客户端通过 oatpp::network::virtual_::Interface 连接，不经过真实网络，
+// 只测连接处理 + 路由 + 控制器本身。每个客户端线程复用一条 keep-alive 连接连续发请求。
+// 可用环境变量调整：API_BENCH_MS（每个接口的压测时长，默认 1000）、API_BENCH_CLIENTS（默认 8）
+// ============================================================================
+
+namespace {
+
+struct BenchResult {
+    std::uint64_t requests = 0;
+    std::uint64_t errors = 0;
+    double rps = 0;
+    double p50_us = 0;
+    double p99_us = 0;
+};
+
+class BenchServer {
+public:
+    BenchServer(const std::string& name, ServerMode mode, int workers) {
+        auto mapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+        auto router = oatpp::web::server::HttpRouter::createShared();
+        router->addController(my_api::edge::EdgesController::createShared(mapper));
+        router->addController(my_api::fly_control_api::FlyControlController::createShared(mapper));
+        router->addController(my_api::file_cache_api::FileApiController::createShared(mapper));
+
+        if (mode == ServerMode::Pooled) {
+            PooledHttpConnectionHandler::Options options;
+            options.worker_threads = workers;
+            options.max_pending_connections = workers;
+            handler_ = PooledHttpConnectionHandler::createShared(router, options);
+        } else {
+            handler_ = oatpp::web::server::HttpConnectionHandler::createShared(router);
+        }
+
+        interface_ = oatpp::network::virtual_::Interface::obtainShared("my_api_bench_" + name);
+        provider_ = oatpp::network::virtual_::server::ConnectionProvider::createShared(interface_);
+        server_ = std::make_shared<oatpp::network::Server>(provider_, handler_);
+        thread_ = std::thread([this] { server_->run([this] { return running_.load(); }); });
+    }
+
+    ~BenchServer() {
+        running_ = false;
+        provider_->stop();
+        if (thread_.joinable()) thread_.join();
+        handler_->stop();
+    }
+
+    std::shared_ptr<oatpp::network::virtual_::Interface> Interface() const { return interface_; }
+
+private:
+    std::shared_ptr<oatpp::network::ConnectionHandler> handler_;
+    std::shared_ptr<oatpp::network::virtual_::Interface> interface_;
+    std::shared_ptr<oatpp::network::virtual_::server::ConnectionProvider> provider_;
+    std::shared_ptr<oatpp::network::Server> server_;
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+BenchResult RunEndpoint(const std::shared_ptr<oatpp::network::virtual_::Interface>& iface,
+                        const std::string& method, const std::string& path, const std::string& body,
+                        int clients, int duration_ms) {
+    auto client_provider = oatpp::network::virtual_::client::ConnectionProvider::createShared(iface);
+    auto executor = oatpp::web::client::HttpRequestExecutor::createShared(client_provider);
+
+    std::vector<std::vector<double>> latencies(static_cast<std::size_t>(clients));
+    std::atomic<std::uint64_t> errors{0};
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::milliseconds(duration_ms);
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c] {
+            auto& samples = latencies[static_cast<std::size_t>(c)];
+            std::shared_ptr<oatpp::web::client::RequestExecutor::ConnectionHandle> connection;
+            oatpp::web::protocol::http::Headers headers;
+            if (!body.empty()) {
+                headers.put("Content-Type", "application/json");
+            }
+            while (std::chrono::steady_clock::now() < deadline) {
+                const auto t0 = std::chrono::steady_clock::now();
+                try {
+                    if (!connection) {
+                        connection = executor->getConnection();
+                    }
+                    std::shared_ptr<oatpp::web::protocol::http::outgoing::Body> request_body;
+                    if (!body.empty()) {
+                        request_body = oatpp::web::protocol::http::outgoing::BufferBody::createShared(
+                            oatpp::String(body.c_str()), "application/json");
+                    }
+                    auto response = executor->execute(method.c_str(), path.c_str(), headers, request_body, connection);
+                    response->readBodyToString();
+                    if (response->getStatusCode() != 200) {
+                        errors.fetch_add(1);
+                    }
+                } catch (...) {
+                    errors.fetch_add(1);
+                    connection.reset();
+                    continue;
+                }
+                samples.push_back(std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - t0).count());
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    BenchResult result;
+    result.requests = all.size();
+    result.errors = errors.load();
+    result.rps = seconds > 0 ? static_cast<double>(all.size()) / seconds : 0;
+    if (!all.empty()) {
+        auto at = [&](double q) {
+            const auto idx = static_cast<std::size_t>(q * static_cast<double>(all.size() - 1));
+            return all[idx];
+        };
+        result.p50_us = at(0.50);
+        result.p99_us = at(0.99);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(MyAPIServerBench, ThreadedVsPooled) {
+    OatppEnv env;
+    const int duration_ms = EnvInt("API_BENCH_MS", 1000);
+    const int clients = EnvInt("API_BENCH_CLIENTS", 8);
+
+    const auto old_level = spdlog::get_level();
+    spdlog::set_level(spdlog::level::warn);   // 关掉逐请求 INFO 日志，只测请求处理本身
+
+    const std::string cache_dir = "/tmp/my_api_bench_" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    my_cache::MyCacheProvider::Destroy();
+    ASSERT_TRUE(my_cache::MyCacheProvider::Init(json{{"root_path", cache_dir}}.dump()).Ok());
+    auto cache = my_cache::MyCacheProvider::Get().value;
+    for (int i = 0; i < 50; ++i) {
+        const std::string content = "bench file " + std::to_string(i);
+        cache->SaveFile("file_" + std::to_string(i) + ".txt",
+                        std::vector<uint8_t>(content.begin(), content.end()));
+    }
+
+    struct Endpoint {
+        const char* method;
+        const char* path;
+        const char* body;
+    };
+    const Endpoint endpoints[] = {
+        {"GET", "/v1/edges/status", ""},
+        {"GET", "/v1/cache/info", ""},
+        {"GET", "/v1/flycontrol/status", ""},
+        {"POST", "/v1/cache/list", "{}"},
+    };
+    const std::pair<const char*, ServerMode> modes[] = {
+        {"threaded", ServerMode::Threaded},
+        {"pooled", ServerMode::Pooled},
+    };
+
+    for (const auto& [mode_name, mode] : modes) {
+        BenchServer server(mode_name, mode, clients);
+        for (const auto& ep : endpoints) {
+            auto r = RunEndpoint(server.Interface(), ep.method, ep.path, ep.body, clients, duration_ms);
+            std::printf("[ApiBench] %-9s %-24s %10.0f req/s  p50=%8.1fus  p99=%8.1fus  errors=%llu\n",
+                        mode_name, ep.path, r.rps, r.p50_us, r.p99_us,
+                        static_cast<unsigned long long>(r.errors));
+            EXPECT_GT(r.requests, 0u) << mode_name << " " << ep.path;
+            EXPECT_EQ(r.errors, 0u) << mode_name << " " << ep.path;
+        }
+    }
+
+    my_cache::MyCacheProvider::Destroy();
+    std::error_code ec;
+    std::filesystem::remove_all(cache_dir, ec);
+    spdlog::set_level(old_level);
+}
+
+// ============================================================================
+// 响应缓存（ETag）
+// ============================================================================
+
+TEST(MyAPIServer_ResponseCache, ReusesBodyUntilGenerationChanges) {
+    auto controller = std::make_shared<ProbeController>();
+    int builds = 0;
+    auto build = [&builds] {
+        ++builds;
+        return json{{"builds", builds}}.dump();
+    };
+
+    auto first = controller->Cached(nullptr, "probe.cache", 1, build);
+    auto second = controller->Cached(nullptr, "probe.cache", 1, build);
+    EXPECT_EQ(StatusOf(first), 200);
+    EXPECT_EQ(StatusOf(second), 200);
+    EXPECT_EQ(builds, 1);
+
+    auto etag = first->getHeader("ETag");
+    ASSERT_TRUE(etag);
+    EXPECT_EQ(*etag, *second->getHeader("ETag"));
+
+    auto third = controller->Cached(nullptr, "probe.cache", 2, build);
+    EXPECT_EQ(builds, 2);
+    EXPECT_NE(*etag, *third->getHeader("ETag"));
+}
+
+TEST(MyAPIServer_ResponseCache, IfNoneMatchOverHttp) {
+    OatppEnv env;
+    const auto old_level = spdlog::get_level();
+    spdlog::set_level(spdlog::level::warn);
+
+    const std::string cache_dir = "/tmp/my_api_etag_" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    my_cache::MyCacheProvider::Destroy();
+    ASSERT_TRUE(my_cache::MyCacheProvider::Init(json{{"root_path", cache_dir + "_a"}}.dump()).Ok());
+
+    {
+        BenchServer server("etag", ServerMode::Threaded, 2);
+        auto client_provider = oatpp::network::virtual_::client::ConnectionProvider::createShared(server.Interface());
+        auto executor = oatpp::web::client::HttpRequestExecutor::createShared(client_provider);
+        auto get = [&](const std::string& if_none_match) {
+            oatpp::web::protocol::http::Headers headers;
+            if (!if_none_match.empty()) {
+                headers.put("If-None-Match", oatpp::String(if_none_match));
+            }
+            return executor->execute("GET", "/v1/cache/info", headers, nullptr, executor->getConnection());
+        };
+
+        auto r1 = get("");
+        ASSERT_EQ(r1->getStatusCode(), 200);
+        auto etag = r1->getHeader("ETag");
+        ASSERT_TRUE(etag);
+        EXPECT_NE(r1->readBodyToString()->find("_a"), std::string::npos);
+
+        auto r2 = get(*etag);
+        EXPECT_EQ(r2->getStatusCode(), 304);
+        auto r2_body = r2->readBodyToString();
+        EXPECT_TRUE(!r2_body || r2_body->empty());
+        EXPECT_EQ(get("W/" + *etag)->getStatusCode(), 304);
+        EXPECT_EQ(get("\"other\"")->getStatusCode(), 200);
+
+        // 重新初始化后代号变化，旧 ETag 不再命中
+        my_cache::MyCacheProvider::Destroy();
+        ASSERT_TRUE(my_cache::MyCacheProvider::Init(json{{"root_path", cache_dir + "_b"}}.dump()).Ok());
+        auto r3 = get(*etag);
+        EXPECT_EQ(r3->getStatusCode(), 200);
+        EXPECT_NE(r3->readBodyToString()->find("_b"), std::string::npos);
+    }
+
+    my_cache::MyCacheProvider::Destroy();
+    std::error_code ec;
+    std::filesystem::remove_all(cache_dir + "_a", ec);
+    std::filesystem::remove_all(cache_dir + "_b", ec);
+    spdlog::set_level(old_level);
+}
@@ -0,0 +1,265 @@
+/**
+ * @file TestTelemetryHub.cpp
+ * @brief 遥测推送中心 TelemetryHub 单元测试
+ *
+ * 测试覆盖：
+ *   - JSON Merge Patch 生成（修改 / 新增 / 删除 / 嵌套 / 非对象）
+ *   - Publish：相同快照不产生新版本
+ *   - 订阅：首次推送快照，之后相邻版本推送增量，落后多个版本（合并）推送快照
+ *   - 多订阅者共享同一事件，序列化次数与订阅者数量无关
+ *   - 未知主题 / 订阅数上限 / 保活 / Shutdown 关闭订阅
+ *   - 有订阅者时按周期采样，最后一个订阅者离开后停止采样
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "telemetry/TelemetryHub.h"
+
+using namespace my_api::telemetry;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// 从 SSE 事件中取出 data 行的 JSON
+nlohmann::json EventData(const EventPtr& event) {
+    const auto pos = event->find("data: ");
+    if (pos == std::string::npos) {
+        return nullptr;
+    }
+    const auto end = event->find('\n', pos);
+    return nlohmann::json::parse(event->substr(pos + 6, end - pos - 6));
+}
+
+std::vector<EventPtr> Wait(const std::shared_ptr<TelemetrySubscription>& sub,
+                           std::chrono::milliseconds keepalive = 2000ms) {
+    std::vector<EventPtr> out;
+    EXPECT_TRUE(sub->WaitEvents(out, keepalive));
+    return out;
+}
+
+} // namespace
+
+// ============================================================================
+// CreateMergePatch
+// ============================================================================
+
+TEST(TelemetryMergePatchTest, ChangedAddedRemovedAndNested) {
+    nlohmann::json from = {{"a", 1}, {"b", 2}, {"n", {{"x", 1}, {"y", 2}}}, {"arr", {1, 2}}};
+    nlohmann::json to = {{"a", 1}, {"c", 3}, {"n", {{"x", 5}, {"y", 2}}}, {"arr", {1, 2, 3}}};
+
+    auto patch = CreateMergePatch(from, to);
+    EXPECT_EQ(patch, (nlohmann::json{{"b", nullptr}, {"c", 3}, {"n", {{"x", 5}}}, {"arr", {1, 2, 3}}}));
+
+    // 按 RFC 7386 应用补丁后应得到目标
+    auto applied = from;
+    applied.merge_patch(patch);
+    EXPECT_EQ(applied, to);
+}
+
+TEST(TelemetryMergePatchTest, IdenticalAndNonObject) {
+    nlohmann::json j = {{"a", {{"b", 1}}}};
+    EXPECT_EQ(CreateMergePatch(j, j), nlohmann::json::object());
+    EXPECT_EQ(CreateMergePatch(j, 5), nlohmann::json(5));
+    EXPECT_EQ(CreateMergePatch(nlohmann::json::array(), j), j);
+}
+
+// ============================================================================
+// Publish / Subscribe
+// ============================================================================
+
+TEST(TelemetryHubTest, PublishIgnoresUnchangedSnapshot) {
+    TelemetryHub hub;
+    ASSERT_TRUE(hub.RegisterTopic("t", 100, nullptr));
+    EXPECT_FALSE(hub.RegisterTopic("t", 100, nullptr));
+
+    EXPECT_TRUE(hub.Publish("t", {{"v", 1}}));
+    EXPECT_FALSE(hub.Publish("t", {{"v", 1}}));
+    EXPECT_TRUE(hub.Publish("t", {{"v", 2}}));
+    EXPECT_FALSE(hub.Publish("missing", {{"v", 1}}));
+
+    auto stats = hub.GetStatsJson();
+    EXPECT_EQ(stats["topics"]["t"]["version"], 2);
+    EXPECT_EQ(stats["topics"]["t"]["publishes"], 2);
+}
+
+TEST(TelemetryHubTest, SnapshotThenDelta) {
+    TelemetryHub hub;
+    hub.RegisterTopic("t", 100, nullptr);
+    hub.Publish("t", {{"a", 1}, {"b", 1}});
+
+    auto sub = hub.Subscribe({"t"}, TelemetryHub::kMinIntervalMs);
+    ASSERT_NE(sub, nullptr);
+
+    auto first = Wait(sub);
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first[0]->rfind("event: t\nid: 1\n", 0), 0u);
+    auto data = EventData(first[0]);
+    EXPECT_EQ(data["type"], "snapshot");
+    EXPECT_EQ(data["data"], (nlohmann::json{{"a", 1}, {"b", 1}}));
+
+    hub.Publish("t", {{"a", 2}, {"b", 1}});
+    auto second = Wait(sub);
+    ASSERT_EQ(second.size(), 1u);
+    data = EventData(second[0]);
+    EXPECT_EQ(data["type"], "delta");
+    EXPECT_EQ(data["version"], 2);
+    EXPECT_EQ(data["data"], (nlohmann::json{{"a", 2}}));
+}
+
+TEST(TelemetryHubTest, CoalescedUpdatesSendLatestSnapshot) {
+    TelemetryHub hub;
+    hub.RegisterTopic("t", 100, nullptr);
+    hub.Publish("t", {{"v", 0}});
+
+    auto sub = hub.Subscribe({"t"}, 300);
+    ASSERT_NE(sub, nullptr);
+    Wait(sub);
+
+    // 限速间隔内的多次更新合并为一次，跳过了中间版本，因此发送完整快照
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 1; i <= 5; ++i) {
+        hub.Publish("t", {{"v", i}});
+    }
+    auto events = Wait(sub);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 250ms);
+    ASSERT_EQ(events.size(), 1u);
+    auto data = EventData(events[0]);
+    EXPECT_EQ(data["type"], "snapshot");
+    EXPECT_EQ(data["version"], 6);
+    EXPECT_EQ(data["data"]["v"], 5);
+}
+
+TEST(TelemetryHubTest, EventsSharedAcrossSubscribers) {
+    TelemetryHub hub;
+    hub.SetMaxSubscribers(64);
+    hub.RegisterTopic("t", 100, nullptr);
+    hub.Publish("t", {{"v", 0}});
+
+    std::vector<std::shared_ptr<TelemetrySubscription>> subs;
+    for (int i = 0; i < 50; ++i) {
+        subs.push_back(hub.Subscribe({"t"}, TelemetryHub::kMinIntervalMs));
+        ASSERT_NE(subs.back(), nullptr);
+    }
+    std::vector<EventPtr> snapshots;
+    for (auto& sub : subs) {
+        snapshots.push_back(Wait(sub).at(0));
+    }
+    hub.Publish("t", {{"v", 1}});
+    std::vector<EventPtr> deltas;
+    for (auto& sub : subs) {
+        deltas.push_back(Wait(sub).at(0));
+    }
+
+    // 同一版本的事件是同一个字符串对象
+    for (std::size_t i = 1; i < subs.size(); ++i) {
+        EXPECT_EQ(snapshots[i].get(), snapshots[0].get());
+        EXPECT_EQ(deltas[i].get(), deltas[0].get());
+    }
+    // 一次快照 + 一次增量，与订阅者数量无关
+    EXPECT_EQ(hub.GetStatsJson()["topics"]["t"]["serializations"], 2);
+}
+
+TEST(TelemetryHubTest, MultipleTopicsInOneBatch) {
+    TelemetryHub hub;
+    hub.RegisterTopic("a", 100, nullptr);
+    hub.RegisterTopic("b", 100, nullptr);
+    hub.Publish("a", {{"x", 1}});
+    hub.Publish("b", {{"y", 1}});
+
+    auto sub = hub.Subscribe({"a", "b", "a"}, TelemetryHub::kMinIntervalMs);
+    ASSERT_NE(sub, nullptr);
+    EXPECT_EQ(sub->Topics().size(), 2u);
+    EXPECT_EQ(Wait(sub).size(), 2u);
+}
+
+// ============================================================================
+// 错误与生命周期
+// ============================================================================
+
+TEST(TelemetryHubTest, RejectsUnknownTopicAndSubscriberLimit) {
+    TelemetryHub hub;
+    hub.RegisterTopic("t", 100, nullptr);
+    hub.SetMaxSubscribers(1);
+
+    std::string err;
+    EXPECT_EQ(hub.Subscribe({"nope"}, 500, &err), nullptr);
+    EXPECT_NE(err.find("nope"), std::string::npos);
+    EXPECT_EQ(hub.Subscribe({}, 500, &err), nullptr);
+
+    auto sub = hub.Subscribe({"t"}, 500, &err);
+    ASSERT_NE(sub, nullptr);
+    EXPECT_EQ(hub.Subscribe({"t"}, 500, &err), nullptr);
+
+    // 退订后名额释放
+    sub.reset();
+    EXPECT_EQ(hub.GetStatsJson()["subscribers"], 0);
+    EXPECT_NE(hub.Subscribe({"t"}, 500, &err), nullptr);
+}
+
+TEST(TelemetryHubTest, KeepalivePingWhenIdle) {
+    TelemetryHub hub;
+    hub.RegisterTopic("t", 100, nullptr);
+    auto sub = hub.Subscribe({"t"}, TelemetryHub::kMinIntervalMs);
+    ASSERT_NE(sub, nullptr);
+
+    auto events = Wait(sub, 100ms);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(*events[0], ": ping\n\n");
+}
+
+TEST(TelemetryHubTest, ShutdownClosesWaitingSubscription) {
+    TelemetryHub hub;
+    hub.RegisterTopic("t", 100, nullptr);
+    auto sub = hub.Subscribe({"t"}, TelemetryHub::kMinIntervalMs);
+    ASSERT_NE(sub, nullptr);
+
+    std::atomic<bool> returned{false};
+    bool result = true;
+    std::thread waiter([&] {
+        std::vector<EventPtr> out;
+        result = sub->WaitEvents(out, 10s);
+        returned = true;
+    });
+    std::this_thread::sleep_for(50ms);
+    EXPECT_FALSE(returned.load());
+    hub.Shutdown();
+    waiter.join();
+    EXPECT_FALSE(result);
+
+    std::string err;
+    EXPECT_EQ(hub.Subscribe({"t"}, 500, &err), nullptr);
+}
+
+TEST(TelemetryHubTest, SamplesOnlyWhileSubscribed) {
+    TelemetryHub hub;
+    std::atomic<int> calls{0};
+    hub.RegisterTopic("t", 50, [&] {
+        int n = ++calls;
+        return nlohmann::json{{"n", n}};
+    });
+
+    std::this_thread::sleep_for(150ms);
+    EXPECT_EQ(calls.load(), 0);
+
+    auto sub = hub.Subscribe({"t"}, TelemetryHub::kMinIntervalMs);
+    ASSERT_NE(sub, nullptr);
+    auto events = Wait(sub);
+    ASSERT_FALSE(events.empty());
+    EXPECT_EQ(EventData(events[0])["type"], "snapshot");
+    EXPECT_TRUE(hub.GetStatsJson()["topics"]["t"]["sampling"].get<bool>());
+
+    sub.reset();
+    EXPECT_FALSE(hub.GetStatsJson()["topics"]["t"]["sampling"].get<bool>());
+    std::this_thread::sleep_for(100ms);
+    const int after_stop = calls.load();
+    std::this_thread::sleep_for(200ms);
+    EXPECT_EQ(calls.load(), after_stop);
+}
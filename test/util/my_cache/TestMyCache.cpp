@@ -10,19 +10,24 @@
  *   - 路径穿越攻击防护
  *   - 空文件名等非法输入
  *   - 子目录文件操作
- *   - 后台线程索引同步
+ *   - 后台线程索引同步（inotify 增量：外部创建/删除/修改、子目录创建/移除）
  *   - 文件大小限制
  *   - 过期文件清理
+ *   - 总容量淘汰（LRU / LFU / largest，高低水位）
+ *   - 流式写入（CacheFileWriter）与断点续传上传会话
+ *   - 内容哈希（XXH64）与按内容去重
  *   - MyCacheProvider 单例包装器
  *   - 错误码转换
  *   - 边界条件：空数据、大文件名等
  */
 
 #include <gtest/gtest.h>
+#include <sys/stat.h>
 #include <filesystem>
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -67,6 +72,16 @@ std::string MakeConfig(const std::string& dir,
     return j.dump();
 }
 
+/// 轮询等待条件成立（inotify 事件异步应用到索引）
+bool WaitFor(const std::function<bool()>& pred, int timeout_ms = 2000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return pred();
+}
+
 }  // namespace
 
 // ============================================================================
@@ -567,7 +582,8 @@ TEST(MyCache_GetAllFileList, ReturnsCorrectFileInfo) {
         ASSERT_NE(f1, nullptr);
         EXPECT_EQ(f1->size, 12u);
         EXPECT_EQ(f1->type, "txt");
-        EXPECT_FALSE(f1->modified_at.empty());
+        EXPECT_GT(f1->modified_at_ms, 0);
+        EXPECT_EQ(FormatModifiedAt(f1->modified_at_ms).size(), 19u);  // "YYYY-MM-DDTHH:MM:SS"
 
         auto* f2 = find_by_name("data.bin");
         ASSERT_NE(f2, nullptr);
@@ -716,13 +732,8 @@ TEST(MyCache_BackgroundScan, DetectsExternallyCreatedFile) {
             ofs << "created externally";
         }
 
-        // 等待后台线程扫描（扫描间隔 5 秒，等 7 秒确保至少扫描一次）
-        std::this_thread::sleep_for(std::chrono::seconds(7));
-
-        // 后台线程应该已经发现这个文件
-        auto r = cache.Exists("external.txt");
-        EXPECT_TRUE(r.Ok());
-        EXPECT_TRUE(r.value);
+        // inotify 事件到达后索引即更新，远小于原先 5 秒的扫描间隔
+        EXPECT_TRUE(WaitFor([&] { return cache.Exists("external.txt").value; }));
     }
     CleanupDir(dir);
 }
@@ -743,13 +754,521 @@ TEST(MyCache_BackgroundScan, DetectsExternallyDeletedFile) {
         std::error_code ec;
         std::filesystem::remove(std::filesystem::path(dir) / "will_vanish.txt", ec);
 
-        // 等待后台线程扫描
-        std::this_thread::sleep_for(std::chrono::seconds(7));
+        EXPECT_TRUE(WaitFor([&] { return !cache.Exists("will_vanish.txt").value; }));
+    }
+    CleanupDir(dir);
+}
 
-        // 索引应该已更新
-        auto r = cache.Exists("will_vanish.txt");
-        EXPECT_TRUE(r.Ok());
-        EXPECT_FALSE(r.value);
+/// 测试：外部修改文件内容后，索引中的大小随之更新
+TEST(MyCache_BackgroundScan, DetectsExternallyModifiedFile) {
+    auto dir = MakeTestDir("bg_scan_mod");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+        ASSERT_TRUE(cache.SaveFile("grow.log", ToBytes("1234")).Ok());
+
+        {
+            std::ofstream ofs(std::filesystem::path(dir) / "grow.log", std::ios::app);
+            ofs << "56789";
+        }
+
+        auto size_of = [&]() -> uint64_t {
+            auto list = cache.GetAllFileList();
+            return list.value.size() == 1 ? list.value[0].size : 0;
+        };
+        EXPECT_TRUE(WaitFor([&] { return size_of() == 9u; }));
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：外部新建的多级子目录及其中的文件会被监听并加入索引；整个目录删除后索引同步移除
+TEST(MyCache_BackgroundScan, TracksExternalSubdirectories) {
+    auto dir = MakeTestDir("bg_scan_subdir");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        auto sub = std::filesystem::path(dir) / "rec" / "2026";
+        std::filesystem::create_directories(sub);
+        std::ofstream(sub / "a.mp4") << "a";
+        EXPECT_TRUE(WaitFor([&] { return cache.Exists("rec/2026/a.mp4").value; }));
+
+        // 新目录已被监听：之后在其中创建的文件同样能被发现
+        std::ofstream(sub / "b.mp4") << "b";
+        EXPECT_TRUE(WaitFor([&] { return cache.Exists("rec/2026/b.mp4").value; }));
+
+        // 目录改名：旧路径移除，新路径下的文件加入索引
+        std::filesystem::rename(std::filesystem::path(dir) / "rec", std::filesystem::path(dir) / "old");
+        EXPECT_TRUE(WaitFor([&] {
+            return !cache.Exists("rec/2026/a.mp4").value && cache.Exists("old/2026/b.mp4").value;
+        }));
+
+        std::filesystem::remove_all(std::filesystem::path(dir) / "old");
+        EXPECT_TRUE(WaitFor([&] { return cache.GetAllFileList().value.empty(); }));
+    }
+    CleanupDir(dir);
+}
+
+// ============================================================================
+// 容量淘汰与过期清理测试
+// ============================================================================
+
+namespace {
+
+/// 容量淘汰配置：总容量 1 MB，默认水位 0.95 / 0.85
+std::string MakeEvictionConfig(const std::string& dir, const std::string& policy) {
+    json j;
+    j["root_path"] = dir;
+    j["max_total_size"] = 1;
+    j["eviction_policy"] = policy;
+    return j.dump();
+}
+
+}  // namespace
+
+/// 测试：超过高水位后按 LRU 淘汰到低水位以下，最近访问过的文件保留
+TEST(MyCache_Eviction, LruEvictsLeastRecentlyUsed) {
+    auto dir = MakeTestDir("evict_lru");
+    {
+        MyCache cache;
+        cache.Init(MakeEvictionConfig(dir, "lru"));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+        EXPECT_EQ(cache.GetConfig().max_total_size, 1024u * 1024u);
+
+        const std::vector<uint8_t> chunk(150 * 1024, 0x5A);
+        for (int i = 0; i < 6; ++i) {
+            ASSERT_TRUE(cache.SaveFile("f" + std::to_string(i) + ".bin", chunk).Ok());
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        // f0 最早写入，但最近被访问过，应当保留
+        EXPECT_TRUE(cache.Exists("f0.bin").value);
+
+        // 第 7 个文件使占用达到 1050 KB，超过 0.95 MB 高水位
+        ASSERT_TRUE(cache.SaveFile("f6.bin", chunk).Ok());
+        ASSERT_TRUE(WaitFor([&] { return cache.GetUsage().evicted_files > 0; }));
+
+        auto usage = cache.GetUsage();
+        EXPECT_LE(usage.total_bytes, static_cast<uint64_t>(1024 * 1024 * 0.85));
+        EXPECT_EQ(usage.evicted_files, 2u);
+        EXPECT_EQ(usage.evicted_bytes, 2u * 150 * 1024);
+        EXPECT_TRUE(cache.Exists("f0.bin").value);
+        EXPECT_FALSE(cache.Exists("f1.bin").value);
+        EXPECT_FALSE(cache.Exists("f2.bin").value);
+        EXPECT_TRUE(cache.Exists("f6.bin").value);
+        EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(dir) / "f1.bin"));
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：LFU 淘汰访问次数最少的文件；largest 淘汰最大的文件
+TEST(MyCache_Eviction, LfuAndLargestPolicies) {
+    auto dir = MakeTestDir("evict_lfu");
+    {
+        MyCache cache;
+        cache.Init(MakeEvictionConfig(dir, "lfu"));
+        ASSERT_EQ(cache.GetConfig().eviction_policy, EvictionPolicy::Lfu);
+
+        const std::vector<uint8_t> chunk(300 * 1024, 0x01);
+        ASSERT_TRUE(cache.SaveFile("hot.bin", chunk).Ok());
+        ASSERT_TRUE(cache.SaveFile("warm.bin", chunk).Ok());
+        ASSERT_TRUE(cache.SaveFile("cold.bin", chunk).Ok());
+        for (int i = 0; i < 3; ++i) cache.Exists("hot.bin");
+        for (int i = 0; i < 2; ++i) cache.Exists("warm.bin");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        // cold 与 new 都未被访问过，次数相同时先淘汰更早的 cold；淘汰一个即低于低水位
+        ASSERT_TRUE(cache.SaveFile("new.bin", std::vector<uint8_t>(100 * 1024, 0x02)).Ok());
+        ASSERT_TRUE(WaitFor([&] { return cache.GetUsage().evicted_files > 0; }));
+        EXPECT_EQ(cache.GetUsage().evicted_files, 1u);
+        EXPECT_FALSE(cache.Exists("cold.bin").value);
+        EXPECT_TRUE(cache.Exists("new.bin").value);
+        EXPECT_TRUE(cache.Exists("warm.bin").value);
+        EXPECT_TRUE(cache.Exists("hot.bin").value);
+    }
+    CleanupDir(dir);
+
+    dir = MakeTestDir("evict_largest");
+    {
+        MyCache cache;
+        cache.Init(MakeEvictionConfig(dir, "largest"));
+        ASSERT_TRUE(cache.SaveFile("big.bin", std::vector<uint8_t>(600 * 1024, 0x01)).Ok());
+        ASSERT_TRUE(cache.SaveFile("small1.bin", std::vector<uint8_t>(200 * 1024, 0x01)).Ok());
+        ASSERT_TRUE(cache.SaveFile("small2.bin", std::vector<uint8_t>(200 * 1024, 0x01)).Ok());
+        ASSERT_TRUE(WaitFor([&] { return cache.GetUsage().evicted_files > 0; }));
+        EXPECT_FALSE(cache.Exists("big.bin").value);
+        EXPECT_TRUE(cache.Exists("small1.bin").value);
+        EXPECT_TRUE(cache.Exists("small2.bin").value);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：单个文件超过缓存总容量时直接拒绝
+TEST(MyCache_Eviction, RejectsFileLargerThanCapacity) {
+    auto dir = MakeTestDir("evict_reject");
+    {
+        MyCache cache;
+        cache.Init(MakeEvictionConfig(dir, "lru"));
+        auto r = cache.SaveFile("huge.bin", std::vector<uint8_t>(1024 * 1024 + 1, 0x01));
+        EXPECT_EQ(r.code, CacheErrorCode::FileTooLarge);
+        EXPECT_EQ(cache.GetUsage().file_count, 0u);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：修改时间超过保留时间的文件被清理，其余文件不受影响
+TEST(MyCache_Expiry, RemovesOnlyExpiredFiles) {
+    auto dir = MakeTestDir("expiry");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir, 0, 60));
+        ASSERT_TRUE(cache.SaveFile("old.txt", ToBytes("old")).Ok());
+        ASSERT_TRUE(cache.SaveFile("fresh.txt", ToBytes("fresh")).Ok());
+
+        // 把 old.txt 的修改时间改到一小时前（IN_ATTRIB 事件更新索引中的修改时间）
+        std::filesystem::last_write_time(std::filesystem::path(dir) / "old.txt",
+                                         std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+
+        // 过期清理每 5 秒执行一次
+        EXPECT_TRUE(WaitFor([&] { return !cache.Exists("old.txt").value; }, 8000));
+        EXPECT_TRUE(cache.Exists("fresh.txt").value);
+        EXPECT_EQ(cache.GetUsage().expired_files, 1u);
+    }
+    CleanupDir(dir);
+}
+
+// ============================================================================
+// 流式写入与断点续传测试
+// ============================================================================
+
+namespace {
+
+std::string ReadFileContent(const std::filesystem::path& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+size_t CountStagingFiles(const std::string& dir) {
+    std::error_code ec;
+    size_t n = 0;
+    for (auto it = std::filesystem::directory_iterator(std::filesystem::path(dir) / ".mycache-staging", ec);
+         it != std::filesystem::directory_iterator(); ++it) {
+        ++n;
+    }
+    return n;
+}
+
+}  // namespace
+
+/// 测试：分多次写入后提交，文件出现在缓存中，暂存目录被清空且不进入索引
+TEST(MyCache_Stream, WriterCommitsIntoCache) {
+    auto dir = MakeTestDir("stream_commit");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        auto w = cache.OpenWriter();
+        ASSERT_TRUE(w.Ok());
+        ASSERT_EQ(w.value->Write("hello ", 6), CacheErrorCode::Ok);
+        ASSERT_EQ(w.value->Write("stream", 6), CacheErrorCode::Ok);
+        EXPECT_EQ(w.value->Size(), 12u);
+        EXPECT_EQ(CountStagingFiles(dir), 1u);
+        EXPECT_TRUE(cache.GetAllFileList().value.empty());   // 暂存文件不可见
+
+        ASSERT_TRUE(w.value->Commit("video/a.mp4").Ok());
+        EXPECT_TRUE(cache.Exists("video/a.mp4").value);
+        EXPECT_EQ(ReadFileContent(std::filesystem::path(dir) / "video" / "a.mp4"), "hello stream");
+        EXPECT_EQ(CountStagingFiles(dir), 0u);
+        EXPECT_EQ(cache.GetAllFileList().value.size(), 1u);
+
+        // 暂存目录不允许通过公开接口访问
+        EXPECT_EQ(cache.SaveFile(".mycache-staging/x.bin", ToBytes("x")).code, CacheErrorCode::InvalidArgument);
+        EXPECT_EQ(cache.GetFileList(".mycache-staging").code, CacheErrorCode::InvalidArgument);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：超过大小限制时写入即失败；未提交的句柄析构后删除临时文件
+TEST(MyCache_Stream, WriterEnforcesLimitAndDiscardsOnDestroy) {
+    auto dir = MakeTestDir("stream_limit");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir, 1));   // max_file_size = 1 MB
+
+        {
+            auto w = cache.OpenWriter();
+            ASSERT_TRUE(w.Ok());
+            std::vector<uint8_t> chunk(512 * 1024, 0x11);
+            EXPECT_EQ(w.value->Write(chunk.data(), chunk.size()), CacheErrorCode::Ok);
+            EXPECT_EQ(w.value->Write(chunk.data(), chunk.size()), CacheErrorCode::Ok);
+            EXPECT_EQ(w.value->Write(chunk.data(), 1), CacheErrorCode::FileTooLarge);
+            EXPECT_EQ(w.value->Commit("big.bin").code, CacheErrorCode::FileTooLarge);
+        }
+        {
+            auto w = cache.OpenWriter();
+            ASSERT_TRUE(w.Ok());
+            w.value->Write("abandoned", 9);
+        }
+        EXPECT_EQ(CountStagingFiles(dir), 0u);
+        EXPECT_FALSE(cache.Exists("big.bin").value);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：断点续传——偏移必须连续，中断的分片保留已写数据，完整后提交
+TEST(MyCache_Stream, ResumableUploadSession) {
+    auto dir = MakeTestDir("stream_session");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+
+        auto begin = cache.BeginUpload("fw/image.bin", 10);
+        ASSERT_TRUE(begin.Ok());
+        const std::string id = begin.value.upload_id;
+        EXPECT_EQ(begin.value.received, 0u);
+
+        {
+            auto chunk = cache.OpenUploadChunk(id, 0);
+            ASSERT_TRUE(chunk.Ok());
+            // 同一会话同时只允许一个分片
+            EXPECT_EQ(cache.OpenUploadChunk(id, 0).code, CacheErrorCode::OffsetMismatch);
+            ASSERT_EQ(chunk.value->Write("0123", 4), CacheErrorCode::Ok);
+            ASSERT_TRUE(chunk.value->Close().Ok());
+        }
+        EXPECT_EQ(cache.GetUpload(id).value.received, 4u);
+        EXPECT_EQ(cache.OpenUploadChunk(id, 0).code, CacheErrorCode::OffsetMismatch);
+        EXPECT_EQ(cache.CommitUpload(id).code, CacheErrorCode::UploadIncomplete);
+
+        {
+            // 连接中断：句柄未 Close 就析构，已写入的部分仍然有效
+            auto chunk = cache.OpenUploadChunk(id, 4);
+            ASSERT_TRUE(chunk.Ok());
+            ASSERT_EQ(chunk.value->Write("45", 2), CacheErrorCode::Ok);
+        }
+        EXPECT_EQ(cache.GetUpload(id).value.received, 6u);
+
+        {
+            auto chunk = cache.OpenUploadChunk(id, 6);
+            ASSERT_TRUE(chunk.Ok());
+            EXPECT_EQ(chunk.value->Write("6789X", 5), CacheErrorCode::FileTooLarge);   // 超过 total_size
+            ASSERT_EQ(chunk.value->Write("6789", 4), CacheErrorCode::FileTooLarge);    // 出错后保持错误
+        }
+        EXPECT_EQ(cache.GetUpload(id).value.received, 6u);
+
+        {
+            auto chunk = cache.OpenUploadChunk(id, 6);
+            ASSERT_TRUE(chunk.Ok());
+            ASSERT_EQ(chunk.value->Write("6789", 4), CacheErrorCode::Ok);
+            ASSERT_TRUE(chunk.value->Close().Ok());
+        }
+        ASSERT_TRUE(cache.CommitUpload(id).Ok());
+        EXPECT_EQ(ReadFileContent(std::filesystem::path(dir) / "fw" / "image.bin"), "0123456789");
+        EXPECT_TRUE(cache.Exists("fw/image.bin").value);
+        // 哈希跨分片（含中断与失败的分片）连续计算，只包含实际接收的数据
+        auto files = cache.GetAllFileList().value;
+        ASSERT_EQ(files.size(), 1u);
+        EXPECT_EQ(files[0].hash, HashBytes("0123456789", 10));
+        EXPECT_EQ(cache.GetUpload(id).code, CacheErrorCode::FileNotFound);
+        EXPECT_EQ(CountStagingFiles(dir), 0u);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：放弃会话删除分片；会话创建时即做路径与大小校验
+TEST(MyCache_Stream, AbortAndValidateSession) {
+    auto dir = MakeTestDir("stream_abort");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir, 1));
+
+        EXPECT_EQ(cache.BeginUpload("../escape.bin", 10).code, CacheErrorCode::PathTraversal);
+        EXPECT_EQ(cache.BeginUpload("zero.bin", 0).code, CacheErrorCode::InvalidArgument);
+        EXPECT_EQ(cache.BeginUpload("huge.bin", 2 * 1024 * 1024).code, CacheErrorCode::FileTooLarge);
+
+        auto begin = cache.BeginUpload("tmp.bin", 100);
+        ASSERT_TRUE(begin.Ok());
+        EXPECT_EQ(CountStagingFiles(dir), 1u);
+        ASSERT_TRUE(cache.AbortUpload(begin.value.upload_id).Ok());
+        EXPECT_EQ(CountStagingFiles(dir), 0u);
+        EXPECT_EQ(cache.AbortUpload(begin.value.upload_id).code, CacheErrorCode::FileNotFound);
+    }
+    CleanupDir(dir);
+}
+
+// ============================================================================
+// 内容哈希与按内容去重测试
+// ============================================================================
+
+namespace {
+
+std::string MakeDedupConfig(const std::string& dir) {
+    json j;
+    j["root_path"] = dir;
+    j["dedup"] = true;
+    return j.dump();
+}
+
+struct stat StatPath(const std::filesystem::path& path) {
+    struct stat st {};
+    ::stat(path.c_str(), &st);
+    return st;
+}
+
+size_t CountBlobs(const std::string& dir) {
+    std::error_code ec;
+    size_t n = 0;
+    for (auto it = std::filesystem::directory_iterator(std::filesystem::path(dir) / ".mycache-blobs", ec);
+         it != std::filesystem::directory_iterator(); ++it) {
+        ++n;
+    }
+    return n;
+}
+
+std::string HashOf(MyCache& cache, const std::string& name) {
+    for (const auto& fi : cache.GetAllFileList().value) {
+        if (fi.name == name) return fi.hash;
+    }
+    return {};
+}
+
+}  // namespace
+
+/// 测试：XXH64 标准测试向量；任意切分的流式计算与一次性计算结果一致
+TEST(MyCache_ContentHash, KnownVectorsAndStreaming) {
+    EXPECT_EQ(HashBytes("", 0), "ef46db3751d8e999");
+    EXPECT_EQ(HashBytes("a", 1), "d24ec4f1a98c6e5b");
+    EXPECT_EQ(HashBytes("abc", 3), "44bc2cf5ad770999");
+
+    std::vector<uint8_t> data;
+    for (int r = 0; r < 3; ++r) {
+        for (int i = 0; i < 256; ++i) data.push_back(static_cast<uint8_t>(i));
+    }
+    EXPECT_EQ(HashBytes(data.data(), data.size()), "8e03c838c596036f");
+
+    ContentHasher hasher;
+    const size_t steps[] = {1, 7, 31, 33, 5, 100};
+    size_t pos = 0;
+    for (size_t k = 0; pos < data.size(); ++k) {
+        size_t n = std::min(steps[k % 6], data.size() - pos);
+        hasher.Update(data.data() + pos, n);
+        pos += n;
+    }
+    EXPECT_EQ(hasher.HexDigest(), "8e03c838c596036f");
+}
+
+/// 测试：未开启去重时也记录哈希；外部事件重新 stat 后哈希保留
+TEST(MyCache_Dedup, HashRecordedWithoutDedup) {
+    auto dir = MakeTestDir("hash_plain");
+    {
+        MyCache cache;
+        cache.Init(MakeConfig(dir));
+        ASSERT_TRUE(cache.SaveFile("a.txt", ToBytes("abc")).Ok());
+        ASSERT_TRUE(cache.SaveFile("b.txt", ToBytes("abc")).Ok());
+        EXPECT_EQ(HashOf(cache, "a.txt"), "44bc2cf5ad770999");
+
+        // 未开启去重：内容相同也是独立的文件
+        EXPECT_NE(StatPath(std::filesystem::path(dir) / "a.txt").st_ino,
+                  StatPath(std::filesystem::path(dir) / "b.txt").st_ino);
+        EXPECT_EQ(cache.GetUsage().dedup_hits, 0u);
+
+        // 等 inotify 事件处理完后哈希仍在
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_EQ(HashOf(cache, "a.txt"), "44bc2cf5ad770999");
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：相同内容以硬链接共享，统计节省的空间；数据块目录不可访问
+TEST(MyCache_Dedup, IdenticalContentSharesData) {
+    auto dir = MakeTestDir("dedup_share");
+    {
+        MyCache cache;
+        cache.Init(MakeDedupConfig(dir));
+        ASSERT_EQ(cache.Status(), CacheStatus::Running);
+
+        const std::vector<uint8_t> data(4096, 0x5A);
+        ASSERT_TRUE(cache.SaveFile("fw/v1.bin", data).Ok());
+        ASSERT_TRUE(cache.SaveFile("fw/copy.bin", data).Ok());
+        ASSERT_TRUE(cache.SaveFile("other.bin", ToBytes("different")).Ok());
+
+        const auto a = StatPath(std::filesystem::path(dir) / "fw" / "v1.bin");
+        const auto b = StatPath(std::filesystem::path(dir) / "fw" / "copy.bin");
+        EXPECT_EQ(a.st_ino, b.st_ino);
+        EXPECT_EQ(a.st_nlink, 3u);   // 两个缓存文件 + 数据块
+        EXPECT_EQ(CountBlobs(dir), 2u);
+
+        const std::string hash = HashBytes(data.data(), data.size());
+        EXPECT_EQ(HashOf(cache, "fw/v1.bin"), hash);
+        EXPECT_EQ(HashOf(cache, "fw/copy.bin"), hash);
+
+        auto usage = cache.GetUsage();
+        EXPECT_EQ(usage.dedup_hits, 1u);
+        EXPECT_EQ(usage.dedup_saved_bytes, 4096u);
+        EXPECT_EQ(usage.file_count, 3u);
+
+        // 同名再次保存相同内容：仍是同一份数据，节省统计不变
+        ASSERT_TRUE(cache.SaveFile("fw/copy.bin", data).Ok());
+        EXPECT_EQ(StatPath(std::filesystem::path(dir) / "fw" / "copy.bin").st_nlink, 3u);
+        EXPECT_EQ(cache.GetUsage().dedup_saved_bytes, 4096u);
+
+        EXPECT_EQ(cache.Exists(".mycache-blobs/" + hash + "-4096").code, CacheErrorCode::InvalidArgument);
+        EXPECT_EQ(cache.GetFileList(".mycache-blobs").code, CacheErrorCode::InvalidArgument);
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：最后一个引用删除后数据块被回收
+TEST(MyCache_Dedup, OrphanBlobCollected) {
+    auto dir = MakeTestDir("dedup_gc");
+    {
+        MyCache cache;
+        cache.Init(MakeDedupConfig(dir));
+
+        ASSERT_TRUE(cache.SaveFile("a.bin", ToBytes("payload")).Ok());
+        ASSERT_TRUE(cache.SaveFile("b.bin", ToBytes("payload")).Ok());
+        ASSERT_EQ(CountBlobs(dir), 1u);
+
+        ASSERT_TRUE(cache.DeleteFile("a.bin").Ok());
+        EXPECT_EQ(cache.GetUsage().dedup_saved_bytes, 0u);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_EQ(CountBlobs(dir), 1u);
+        EXPECT_EQ(ReadFileContent(std::filesystem::path(dir) / "b.bin"), "payload");
+
+        ASSERT_TRUE(cache.DeleteFile("b.bin").Ok());
+        EXPECT_TRUE(WaitFor([&] { return CountBlobs(dir) == 0; }));
+    }
+    CleanupDir(dir);
+}
+
+/// 测试：流式写入提交时复用已有数据；重启后由数据块目录恢复哈希
+TEST(MyCache_Dedup, WriterDedupAndHashSurvivesRestart) {
+    auto dir = MakeTestDir("dedup_writer");
+    const std::string hash = HashBytes("firmware-image", 14);
+    {
+        MyCache cache;
+        cache.Init(MakeDedupConfig(dir));
+        ASSERT_TRUE(cache.SaveFile("first.img", ToBytes("firmware-image")).Ok());
+
+        auto w = cache.OpenWriter();
+        ASSERT_TRUE(w.Ok());
+        ASSERT_EQ(w.value->Write("firmware-", 9), CacheErrorCode::Ok);
+        ASSERT_EQ(w.value->Write("image", 5), CacheErrorCode::Ok);
+        EXPECT_EQ(w.value->Hash(), hash);
+        ASSERT_TRUE(w.value->Commit("second.img").Ok());
+
+        EXPECT_EQ(cache.GetUsage().dedup_hits, 1u);
+        EXPECT_EQ(CountStagingFiles(dir), 0u);
+        EXPECT_EQ(StatPath(std::filesystem::path(dir) / "first.img").st_ino,
+                  StatPath(std::filesystem::path(dir) / "second.img").st_ino);
+    }
+    {
+        MyCache cache;
+        cache.Init(MakeDedupConfig(dir));
+        EXPECT_EQ(HashOf(cache, "first.img"), hash);
+        EXPECT_EQ(HashOf(cache, "second.img"), hash);
+        EXPECT_EQ(cache.GetUsage().dedup_saved_bytes, 14u);
     }
     CleanupDir(dir);
 }
@@ -824,6 +1343,8 @@ TEST(MyCache_ErrorCode, ToStringCoversAllCodes) {
     EXPECT_STREQ(CacheErrorCodeToString(CacheErrorCode::InvalidArgument), "InvalidArgument");
     EXPECT_STREQ(CacheErrorCodeToString(CacheErrorCode::CreateDirFailed), "CreateDirFailed");
     EXPECT_STREQ(CacheErrorCodeToString(CacheErrorCode::FileTooLarge), "FileTooLarge");
+    EXPECT_STREQ(CacheErrorCodeToString(CacheErrorCode::OffsetMismatch), "OffsetMismatch");
+    EXPECT_STREQ(CacheErrorCodeToString(CacheErrorCode::UploadIncomplete), "UploadIncomplete");
 }
 
 /// 测试：状态码转字符串
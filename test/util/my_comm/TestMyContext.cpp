@@ -0,0 +1,403 @@
+/**
+ * @file TestMyContext.cpp
+ * @brief 运行时上下文 MyContext 单元测试与读性能基准
+ *
+ * 测试覆盖：
+ *   - 标量快速路径与 JSON 值的读写、类型转换规则
+ *   - upsert / UpdateValue / UpdateDescription / Erase / Clear / Size / GetAllJson
+ *   - 预解析句柄：记录不存在时解析、删除后读到默认值、重新写入后恢复
+ *   - 变更订阅：精确名字 / 前缀 / 全部，删除通知，取消订阅
+ *   - 并发：写入方持续递增时读取方不会读到撕裂或回退的值
+ *   - 基准：并发写入下按名字读取、句柄读取与旧实现（单锁 + JSON 拷贝）的读吞吐
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "MyContext.h"
+
+using my_comm::ContextChange;
+using my_comm::ContextEntry;
+using my_comm::ContextHandle;
+using my_comm::ContextValueType;
+using my_comm::MyContext;
+
+namespace {
+
+/// 测试之间共享单例，每个用例用独立前缀并在结束时清理
+class ContextScope {
+public:
+    explicit ContextScope(std::string prefix) : prefix_(std::move(prefix)) {}
+    ~ContextScope() {
+        auto all = MyContext::GetInstance().GetAllJson();
+        for (const auto& item : all["items"]) {
+            const std::string name = item["name"].get<std::string>();
+            if (name.compare(0, prefix_.size(), prefix_) == 0) MyContext::GetInstance().Erase(name);
+        }
+    }
+    std::string operator()(const std::string& key) const { return prefix_ + key; }
+
+private:
+    std::string prefix_;
+};
+
+} // namespace
+
+// ============================================================
+//  测试：读写与类型转换
+// ============================================================
+
+TEST(MyContextTest, TypedValuesAndConversions) {
+    auto& ctx = MyContext::GetInstance();
+    ContextScope k("t1.");
+
+    ASSERT_TRUE(ctx.SetBool(k("flag"), true, "开关"));
+    ASSERT_TRUE(ctx.SetInt(k("count"), 42));
+    ASSERT_TRUE(ctx.SetDouble(k("ratio"), 2.75));
+    ASSERT_TRUE(ctx.SetString(k("text"), "17"));
+    ASSERT_TRUE(ctx.Set(k("obj"), {{"a", 1}}));
+    ASSERT_TRUE(ctx.Set(k("big"), nlohmann::json(18446744073709551615ULL)));
+
+    EXPECT_TRUE(ctx.GetBool(k("flag")));
+    EXPECT_EQ(ctx.GetInt(k("flag")), 1);
+    EXPECT_EQ(ctx.GetInt(k("count")), 42);
+    EXPECT_DOUBLE_EQ(ctx.GetDouble(k("count")), 42.0);
+    EXPECT_TRUE(ctx.GetBool(k("count")));
+    EXPECT_EQ(ctx.GetInt(k("ratio")), 2);
+    EXPECT_DOUBLE_EQ(ctx.GetDouble(k("ratio")), 2.75);
+    EXPECT_EQ(ctx.GetInt(k("text")), 17);
+    EXPECT_FALSE(ctx.GetBool(k("text")));
+    EXPECT_EQ(ctx.GetString(k("count")), "42");
+    EXPECT_EQ(ctx.GetString(k("flag")), "true");
+    EXPECT_EQ(ctx.GetString(k("text")), "17");
+    EXPECT_EQ(ctx.GetString(k("obj")), "{\"a\":1}");
+    EXPECT_EQ(ctx.GetInt(k("obj"), -1), -1);
+    EXPECT_EQ(ctx.GetInt(k("missing"), -5), -5);
+
+    nlohmann::json v;
+    ASSERT_TRUE(ctx.GetValue(k("count"), v));
+    EXPECT_TRUE(v.is_number_integer());
+    EXPECT_EQ(v.get<int64_t>(), 42);
+    ASSERT_TRUE(ctx.GetValue(k("big"), v));
+    EXPECT_EQ(v.get<uint64_t>(), 18446744073709551615ULL);
+
+    ContextEntry entry;
+    ASSERT_TRUE(ctx.GetEntry(k("ratio"), entry));
+    EXPECT_EQ(entry.type, ContextValueType::Double);
+    EXPECT_EQ(entry.version, 1u);
+    ASSERT_TRUE(ctx.GetEntry(k("flag"), entry));
+    EXPECT_EQ(entry.description, "开关");
+    EXPECT_EQ(entry.type, ContextValueType::Boolean);
+
+    // 类型切换：标量 <-> JSON
+    ASSERT_TRUE(ctx.SetString(k("count"), "abc"));
+    EXPECT_EQ(ctx.GetInt(k("count"), 7), 7);
+    ASSERT_TRUE(ctx.SetInt(k("count"), 9));
+    EXPECT_EQ(ctx.GetString(k("count")), "9");
+}
+
+TEST(MyContextTest, UpsertUpdateEraseAndSerialize) {
+    auto& ctx = MyContext::GetInstance();
+    ContextScope k("t2.");
+    const std::size_t base_size = ctx.Size();
+    const uint64_t base_version = ctx.Version();
+
+    ASSERT_TRUE(ctx.SetInt(k("b"), 1, "第一版解释"));
+    ASSERT_TRUE(ctx.SetInt(k("b"), 2));  // 空解释保留原解释
+    ASSERT_TRUE(ctx.SetInt(k("a"), 3));
+    EXPECT_EQ(ctx.Size(), base_size + 2);
+    EXPECT_EQ(ctx.Version(), base_version + 3);
+
+    ContextEntry entry;
+    ASSERT_TRUE(ctx.GetEntry(k("b"), entry));
+    EXPECT_EQ(entry.description, "第一版解释");
+    EXPECT_EQ(entry.version, 2u);
+
+    std::string err;
+    EXPECT_FALSE(ctx.UpdateValue(k("missing"), 1, err));
+    EXPECT_FALSE(err.empty());
+    EXPECT_FALSE(ctx.Has(k("missing")));
+    EXPECT_TRUE(ctx.UpdateValue(k("b"), "text", err));
+    EXPECT_TRUE(ctx.UpdateDescription(k("b"), "新解释", err));
+    ASSERT_TRUE(ctx.GetEntry(k("b"), entry));
+    EXPECT_EQ(entry.value, "text");
+    EXPECT_EQ(entry.type, ContextValueType::String);
+    EXPECT_EQ(entry.description, "新解释");
+    EXPECT_EQ(entry.version, 4u);
+
+    auto all = ctx.GetAllJson();
+    EXPECT_EQ(all["count"].get<std::size_t>(), ctx.Size());
+    EXPECT_EQ(all["version"].get<uint64_t>(), ctx.Version());
+    std::vector<std::string> names;
+    for (const auto& item : all["items"]) names.push_back(item["name"]);
+    EXPECT_TRUE(std::is_sorted(names.begin(), names.end()));
+
+    nlohmann::json j;
+    ASSERT_TRUE(ctx.GetEntryJson(k("a"), j));
+    EXPECT_EQ(j["type"], "integer");
+    EXPECT_EQ(j["version"].get<uint64_t>(), 1u);
+
+    // 删除后重新创建：解释不沿用
+    EXPECT_TRUE(ctx.Erase(k("b")));
+    EXPECT_FALSE(ctx.Erase(k("b")));
+    EXPECT_FALSE(ctx.Has(k("b")));
+    EXPECT_EQ(ctx.Size(), base_size + 1);
+    ASSERT_TRUE(ctx.SetInt(k("b"), 5));
+    ASSERT_TRUE(ctx.GetEntry(k("b"), entry));
+    EXPECT_TRUE(entry.description.empty());
+
+    EXPECT_FALSE(ctx.Set("", 1));
+}
+
+// ============================================================
+//  测试：预解析句柄
+// ============================================================
+
+TEST(MyContextTest, HandleResolvesBeforeCreateAndSurvivesErase) {
+    auto& ctx = MyContext::GetInstance();
+    ContextScope k("t3.");
+
+    ContextHandle h = ctx.Resolve(k("hot"));
+    ASSERT_TRUE(h.Valid());
+    EXPECT_EQ(h.Name(), k("hot"));
+    EXPECT_FALSE(h.Has());
+    EXPECT_EQ(h.GetInt(-1), -1);
+    EXPECT_FALSE(ctx.Has(k("hot")));   // 仅解析不算存在
+    EXPECT_FALSE(ctx.Resolve("").Valid());
+
+    const std::size_t size = ctx.Size();
+    ASSERT_TRUE(ctx.SetInt(k("hot"), 10, "热点"));
+    EXPECT_TRUE(h.Has());
+    EXPECT_EQ(h.GetInt(), 10);
+    EXPECT_EQ(ctx.Size(), size + 1);
+
+    ASSERT_TRUE(h.SetDouble(1.5));
+    EXPECT_DOUBLE_EQ(ctx.GetDouble(k("hot")), 1.5);
+    ASSERT_TRUE(h.SetBool(true));
+    EXPECT_TRUE(ctx.GetBool(k("hot")));
+    ASSERT_TRUE(h.SetString("on"));
+    EXPECT_EQ(ctx.GetString(k("hot")), "on");
+    EXPECT_EQ(h.GetString(), "on");
+    EXPECT_EQ(h.Version(), 4u);
+
+    ContextEntry entry;
+    ASSERT_TRUE(ctx.GetEntry(k("hot"), entry));
+    EXPECT_EQ(entry.description, "热点");   // 句柄写入不改解释
+
+    ASSERT_TRUE(ctx.Erase(k("hot")));
+    EXPECT_FALSE(h.Has());
+    EXPECT_EQ(h.GetInt(-2), -2);
+    ASSERT_TRUE(ctx.SetInt(k("hot"), 11));
+    EXPECT_EQ(h.GetInt(), 11);
+
+    ContextHandle invalid;
+    EXPECT_FALSE(invalid.SetInt(1));
+    EXPECT_EQ(invalid.GetInt(3), 3);
+}
+
+// ============================================================
+//  测试：变更订阅
+// ============================================================
+
+TEST(MyContextTest, SubscriptionsMatchExactPrefixAndErase) {
+    auto& ctx = MyContext::GetInstance();
+    ContextScope k("t4.");
+
+    std::mutex mtx;
+    std::vector<ContextChange> exact;
+    std::vector<ContextChange> prefix;
+    const uint64_t id1 = ctx.Subscribe(k("mode"), [&](const ContextChange& c) {
+        std::lock_guard<std::mutex> lock(mtx);
+        exact.push_back(c);
+    });
+    const uint64_t id2 = ctx.Subscribe(k("*"), [&](const ContextChange& c) {
+        std::lock_guard<std::mutex> lock(mtx);
+        prefix.push_back(c);
+    });
+    const uint64_t id3 = ctx.Subscribe(k("*"), [](const ContextChange&) {
+        throw std::runtime_error("回调异常不影响写入");
+    });
+    ASSERT_NE(id1, 0u);
+    ASSERT_NE(id2, 0u);
+    EXPECT_EQ(ctx.Subscribe("", [](const ContextChange&) {}), 0u);
+
+    ASSERT_TRUE(ctx.SetInt(k("mode"), 3));
+    ASSERT_TRUE(ctx.SetString(k("other"), "x"));
+    ASSERT_TRUE(ctx.Resolve(k("mode")).SetBool(false));
+    ASSERT_TRUE(ctx.Erase(k("mode")));
+    ASSERT_TRUE(ctx.SetInt("t4_unrelated", 1));
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        ASSERT_EQ(exact.size(), 3u);
+        EXPECT_EQ(exact[0].kind, ContextChange::Kind::Set);
+        EXPECT_EQ(exact[0].value, 3);
+        EXPECT_EQ(exact[0].type, ContextValueType::Integer);
+        EXPECT_EQ(exact[0].version, 1u);
+        EXPECT_EQ(exact[1].value, false);
+        EXPECT_EQ(exact[2].kind, ContextChange::Kind::Erase);
+        EXPECT_TRUE(exact[2].value.is_null());
+        ASSERT_EQ(prefix.size(), 4u);
+        EXPECT_EQ(prefix[1].name, k("other"));
+    }
+
+    EXPECT_TRUE(ctx.Unsubscribe(id1));
+    EXPECT_FALSE(ctx.Unsubscribe(id1));
+    ASSERT_TRUE(ctx.SetInt(k("mode"), 4));
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        EXPECT_EQ(exact.size(), 3u);
+        EXPECT_EQ(prefix.size(), 5u);
+    }
+    ctx.Unsubscribe(id2);
+    ctx.Unsubscribe(id3);
+    ctx.Erase("t4_unrelated");
+}
+
+// ============================================================
+//  测试：并发一致性
+// ============================================================
+
+TEST(MyContextTest, ConcurrentReadersSeeMonotonicValues) {
+    auto& ctx = MyContext::GetInstance();
+    ContextScope k("t5.");
+    ASSERT_TRUE(ctx.SetInt(k("counter"), 0));
+    ASSERT_TRUE(ctx.SetDouble(k("pair"), 0.0));
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+    std::thread writer([&]() {
+        ContextHandle counter = ctx.Resolve(k("counter"));
+        for (int64_t i = 1; i <= 200000; ++i) {
+            counter.SetInt(i);
+            // 整数与浮点交替写入同一键：读取方不能读到类型与值不匹配的结果
+            ctx.SetDouble(k("pair"), (i & 1) ? 0.5 : 0.25);
+        }
+        stop = true;
+    });
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&, r]() {
+            ContextHandle counter = ctx.Resolve(k("counter"));
+            int64_t last = 0;
+            while (!stop) {
+                const int64_t v = (r == 0) ? ctx.GetInt(k("counter")) : counter.GetInt();
+                if (v < last) ++errors;
+                last = v;
+                const double d = ctx.GetDouble(k("pair"));
+                if (d != 0.0 && d != 0.5 && d != 0.25) ++errors;
+            }
+        });
+    }
+    writer.join();
+    for (auto& t : readers) t.join();
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(ctx.GetInt(k("counter")), 200000);
+}
+
+// ============================================================
+//  基准：并发写入下的读吞吐
+// ============================================================
+
+namespace {
+
+/// 旧实现的读路径：整表一把锁，读取时在锁内拷贝 JSON 再转换
+class LegacyContext {
+public:
+    void Set(const std::string& name, const nlohmann::json& v) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[name] = v;
+    }
+    int64_t GetInt(const std::string& name) const {
+        nlohmann::json v;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(name);
+            if (it == entries_.end()) return 0;
+            v = it->second;
+        }
+        return v.is_number() ? static_cast<int64_t>(v.get<double>()) : 0;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, nlohmann::json> entries_;
+};
+
+template <typename ReadFn, typename WriteFn>
+double MeasureReadsPerSec(int readers, int writers, int duration_ms, ReadFn read, WriteFn write) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total{0};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w]() {
+            int64_t i = 0;
+            while (!stop) {
+                write(w, i++);
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        });
+    }
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            uint64_t n = 0;
+            int64_t sink = 0;
+            while (!stop) {
+                for (int j = 0; j < 64; ++j) sink += read(r, j);
+                n += 64;
+            }
+            total += n + (sink == -1 ? 1 : 0);
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+    stop = true;
+    for (auto& t : threads) t.join();
+    return static_cast<double>(total.load()) * 1000.0 / duration_ms;
+}
+
+} // namespace
+
+TEST(MyContextTest, BenchmarkReadsUnderConcurrentWriters) {
+    auto& ctx = MyContext::GetInstance();
+    ContextScope k("bench.");
+    const int keys = 64;
+    const int readers = 4;
+    const int writers = 2;
+    const int duration_ms = 300;
+
+    std::vector<std::string> names;
+    std::vector<ContextHandle> handles;
+    LegacyContext legacy;
+    for (int i = 0; i < keys; ++i) {
+        names.push_back(k("flag." + std::to_string(i)));
+        ctx.SetInt(names.back(), i);
+        legacy.Set(names.back(), i);
+        handles.push_back(ctx.Resolve(names.back()));
+    }
+
+    const double legacy_rps = MeasureReadsPerSec(readers, writers, duration_ms,
+        [&](int r, int j) { return legacy.GetInt(names[(r * 7 + j) % keys]); },
+        [&](int w, int64_t i) { legacy.Set(names[(w + i) % keys], i); });
+    const double name_rps = MeasureReadsPerSec(readers, writers, duration_ms,
+        [&](int r, int j) { return ctx.GetInt(names[(r * 7 + j) % keys]); },
+        [&](int w, int64_t i) { ctx.SetInt(names[(w + i) % keys], i); });
+    const double handle_rps = MeasureReadsPerSec(readers, writers, duration_ms,
+        [&](int r, int j) { return handles[(r * 7 + j) % keys].GetInt(); },
+        [&](int w, int64_t i) { handles[(w + i) % keys].SetInt(i); });
+
+    std::printf("[bench] MyContext 读吞吐（%d 读 / %d 写线程, %d 键）: 旧实现 %.2f M/s, 按名字 %.2f M/s, 句柄 %.2f M/s\n",
+                readers, writers, keys, legacy_rps / 1e6, name_rps / 1e6, handle_rps / 1e6);
+    EXPECT_GT(name_rps, legacy_rps);
+    EXPECT_GT(handle_rps, name_rps);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+#include "IControl.h"
+#include "MyData.h"
+#include "TaskQueue.h"
+#include "demo/Workflow.h"
+
+using namespace my_control;
+using namespace my_control::demo;
+
+// =============================================================================
+// Task 派发性能基准（提交 → 执行）
+//
+// 1) 单线程模拟 Edge::Submit 的数据流转：Normalize 生成 Task → Submit 取出 → TaskQueue 入队
+//    - LegacyTask：改造前的布局（params/policy/output 为 nlohmann::json，沿途按值复制）
+//    - Task：JsonPayload + 移动传递
+// 2) TaskQueue + Workflow 端到端：复制入队 vs 移动入队，统计 tasks/s
+// 任务数可用环境变量 TASK_BENCH_ITEMS 调整（默认 100000）
+// =============================================================================
+
+namespace {
+
+// 改造前的 Task 布局，只用于对比
+struct LegacyTask {
+  std::string task_id, command_id, trace_id, span_id, edge_id, device_id;
+  std::string capability, action;
+  nlohmann::json params = nlohmann::json::object();
+  std::string idempotency_key;
+  std::int64_t dedup_window_ms{0};
+  int priority{0};
+  std::int64_t created_at_ms{0};
+  std::int64_t deadline_at_ms{0};
+  nlohmann::json policy = nlohmann::json::object();
+  nlohmann::json output = nlohmann::json::object();
+};
+
+std::uint64_t BenchItems() {
+  const char* env = std::getenv("TASK_BENCH_ITEMS");
+  if (env != nullptr) {
+    const long long v = std::atoll(env);
+    if (v > 0) {
+      return static_cast<std::uint64_t>(v);
+    }
+  }
+  return 100000;
+}
+
+const nlohmann::json& SampleParams() {
+  static const nlohmann::json p = {{"lat", 30.123456}, {"lon", 120.654321}, {"depth", 12.5},
+                                   {"speed", 1.2}, {"mode", "cruise"}};
+  return p;
+}
+
+template <typename T>
+void FillTask(T& t, std::uint64_t i) {
+  t.task_id = "task-" + std::to_string(i);
+  t.command_id = "cmd-" + std::to_string(i);
+  t.edge_id = "edge-1";
+  t.device_id = "uuv-1";
+  t.capability = "navigate";
+  t.action = "set";
+  t.params = SampleParams();
+}
+
+double Rate(std::uint64_t n, std::chrono::steady_clock::time_point start) {
+  const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return sec > 0 ? static_cast<double>(n) / sec : 0.0;
+}
+
+class NoopControl : public IControl {
+public:
+  bool Init(const nlohmann::json&, std::string*) override { return true; }
+  my_data::TaskResult DoTask(const my_data::Task&) override { return {}; }
+  std::string Name() const override { return "NoopControl"; }
+};
+
+double RunWorkflow(std::uint64_t total, bool move_push) {
+  TaskQueue q("bench-queue");
+  NoopControl ctrl;
+  Workflow wf("bench-wf", q, ctrl);
+
+  std::atomic<std::uint64_t> finished{0};
+  wf.SetFinishCallback([&](const my_data::Task&, const my_data::TaskResult&) {
+    finished.fetch_add(1, std::memory_order_relaxed);
+  });
+  EXPECT_TRUE(wf.Start());
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::uint64_t i = 0; i < total; ++i) {
+    my_data::Task t;
+    FillTask(t, i);
+    if (move_push) {
+      q.Push(std::move(t));
+    } else {
+      q.Push(t);
+    }
+  }
+  while (finished.load(std::memory_order_relaxed) < total) {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  const double rate = Rate(total, start);
+
+  q.Shutdown();
+  wf.Stop();
+  wf.Join();
+  EXPECT_EQ(finished.load(), total);
+  return rate;
+}
+
+} // namespace
+
+TEST(TaskDispatchBench, SubmitToExecute) {
+  const std::uint64_t total = BenchItems();
+  const auto old_level = spdlog::get_level();
+  spdlog::set_level(spdlog::level::warn);   // 关掉逐任务 INFO 日志，只测派发本身
+
+  std::uint64_t sink = 0;
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < total; ++i) {
+      LegacyTask normalized;
+      FillTask(normalized, i);
+      LegacyTask submitted = normalized;   // Submit: task = *maybe_task
+      LegacyTask queued = submitted;       // TaskQueue::Push: entry.task = task
+      sink += queued.params.size();
+    }
+    std::printf("[TaskBench] %-26s %12.0f tasks/s\n", "legacy copy chain", Rate(total, start));
+  }
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < total; ++i) {
+      my_data::Task normalized;
+      FillTask(normalized, i);
+      my_data::Task submitted = std::move(normalized);
+      my_data::Task queued = std::move(submitted);
+      sink += queued.params.size();
+    }
+    std::printf("[TaskBench] %-26s %12.0f tasks/s\n", "payload move chain", Rate(total, start));
+  }
+  EXPECT_EQ(sink, total * 2 * SampleParams().size());
+
+  std::printf("[TaskBench] %-26s %12.0f tasks/s\n", "workflow copy push", RunWorkflow(total, false));
+  std::printf("[TaskBench] %-26s %12.0f tasks/s\n", "workflow move push", RunWorkflow(total, true));
+
+  spdlog::set_level(old_level);
+}
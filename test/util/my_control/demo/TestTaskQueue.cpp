@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "MyData.h"
 #include "MyLog.h"
 #include "TaskQueue.h"
@@ -32,4 +37,99 @@ TEST(MyControl_TaskQueue, ShutdownWakeUp) {
   bool ok = q.PopBlocking(out, 10);
   EXPECT_FALSE(ok);
   EXPECT_TRUE(q.IsShutdown());
-}
\ No newline at end of file
+}
+namespace {
+
+my_data::Task MakeTask(const std::string& id, int priority, my_data::TimestampMs deadline_at_ms = 0) {
+  my_data::Task t;
+  t.task_id = id;
+  t.device_id = "dev-1";
+  t.priority = priority;
+  t.deadline_at_ms = deadline_at_ms;
+  return t;
+}
+
+std::vector<std::string> DrainIds(TaskQueue& q) {
+  std::vector<std::string> ids;
+  my_data::Task out;
+  while (q.PopBlocking(out, 0)) {
+    ids.push_back(out.task_id);
+  }
+  return ids;
+}
+
+} // namespace
+
+TEST(MyControl_TaskQueue, PriorityThenDeadlineThenFifo) {
+  TaskQueue q("test-queue-priority");
+  const my_data::TimestampMs now = my_data::NowMs();
+
+  q.Push(MakeTask("telemetry-1", 0));
+  q.Push(MakeTask("telemetry-2", 0));
+  q.Push(MakeTask("urgent-late", 5, now + 60000));
+  q.Push(MakeTask("urgent-no-deadline", 5));
+  q.Push(MakeTask("urgent-early", 5, now + 1000));
+  q.Push(MakeTask("normal", 1));
+
+  std::vector<std::string> expect{"urgent-early", "urgent-late", "urgent-no-deadline",
+                                  "normal", "telemetry-1", "telemetry-2"};
+  EXPECT_EQ(DrainIds(q), expect);
+}
+
+TEST(MyControl_TaskQueue, CancelByTaskId) {
+  TaskQueue q("test-queue-cancel");
+  q.Push(MakeTask("a", 0));
+  q.Push(MakeTask("b", 0, my_data::NowMs() + 60000));
+  q.Push(MakeTask("c", 0));
+
+  EXPECT_TRUE(q.Cancel("b"));
+  EXPECT_FALSE(q.Cancel("b"));
+  EXPECT_FALSE(q.Cancel("missing"));
+  EXPECT_EQ(q.Size(), 2u);
+
+  std::vector<std::string> expect{"a", "c"};
+  EXPECT_EQ(DrainIds(q), expect);
+  EXPECT_EQ(q.GetStatsJson()["cancelled"].get<int>(), 1);
+}
+
+TEST(MyControl_TaskQueue, ExpiredTasksAreFailedNotExecuted) {
+  TaskQueue q("test-queue-expired");
+  std::vector<std::string> failed;
+  q.SetExpiredCallback([&](const my_data::Task& t, const my_data::TaskResult& r) {
+    EXPECT_EQ(r.code, my_data::ErrorCode::Timeout);
+    EXPECT_EQ(t.state, my_data::TaskState::Failed);
+    failed.push_back(t.task_id);
+  });
+
+  const my_data::TimestampMs now = my_data::NowMs();
+  q.Push(MakeTask("expired-high", 9, now - 10));
+  q.Push(MakeTask("alive", 0, now + 60000));
+  q.Push(MakeTask("expired-low", 0, now - 5));
+
+  my_data::Task out;
+  ASSERT_TRUE(q.PopBlocking(out, 10));
+  EXPECT_EQ(out.task_id, "alive");
+  std::vector<std::string> expect_failed{"expired-high", "expired-low"};
+  EXPECT_EQ(failed, expect_failed);
+  EXPECT_EQ(q.Size(), 0u);
+
+  // Drop 策略：只移出，不回调
+  failed.clear();
+  q.SetExpiredPolicy(TaskQueue::ExpiredPolicy::Drop);
+  q.Push(MakeTask("expired-dropped", 0, now - 1));
+  EXPECT_FALSE(q.PopBlocking(out, 10));
+  EXPECT_TRUE(failed.empty());
+  EXPECT_EQ(q.GetStatsJson()["expired"].get<int>(), 3);
+}
+
+TEST(MyControl_TaskQueue, ReportsQueueWaitTime) {
+  TaskQueue q("test-queue-wait");
+  q.Push(MakeTask("slow", 0));
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+  my_data::Task out;
+  TaskQueue::PopInfo info;
+  ASSERT_TRUE(q.PopBlocking(out, 10, &info));
+  EXPECT_GE(info.queue_wait_ms, 25);
+  EXPECT_GE(q.GetStatsJson()["max_wait_ms"].get<int>(), 25);
+}
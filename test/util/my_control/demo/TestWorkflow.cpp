@@ -2,7 +2,10 @@
 
 #include <atomic>
 #include <chrono>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "MyData.h"
 #include "TaskQueue.h"
@@ -48,4 +51,88 @@ TEST(MyControl_Workflow, ExecuteOneTask) {
   q.Shutdown();
   wf.Stop();
   wf.Join();
-}
\ No newline at end of file
+}
+TEST(MyControl_Workflow, ExpiredTaskReportsTimeout) {
+  TaskQueue q("workflow-queue-expired");
+
+  UUVControl ctrl;
+  std::string err;
+  ASSERT_TRUE(ctrl.Init(nlohmann::json{{"simulate_latency_ms", 1}}, &err));
+
+  Workflow wf("wf-expired", q, ctrl);
+
+  std::atomic<int> started{0};
+  std::atomic<int> timed_out{0};
+  wf.SetStartCallback([&](const my_data::Task&) { started.fetch_add(1); });
+  wf.SetFinishCallback([&](const my_data::Task&, const my_data::TaskResult& r) {
+    if (r.code == my_data::ErrorCode::Timeout) timed_out.fetch_add(1);
+  });
+
+  my_data::Task t;
+  t.task_id = "task-expired";
+  t.device_id = "uuv-1";
+  t.capability = "navigate";
+  t.action = "set";
+  t.deadline_at_ms = my_data::NowMs() - 1;
+  q.Push(t);
+
+  ASSERT_TRUE(wf.Start());
+  for (int i = 0; i < 50 && timed_out.load() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  EXPECT_EQ(timed_out.load(), 1);
+  EXPECT_EQ(started.load(), 0);
+
+  q.Shutdown();
+  wf.Stop();
+  wf.Join();
+}
+
+TEST(MyControl_Workflow, EStopPausesAndResumesInOrder) {
+  TaskQueue q("workflow-queue-estop");
+
+  UUVControl ctrl;
+  std::string err;
+  ASSERT_TRUE(ctrl.Init(nlohmann::json{{"simulate_latency_ms", 1}}, &err));
+
+  Workflow wf("wf-estop", q, ctrl);
+
+  std::atomic<bool> estop{true};
+  wf.SetEStopFlag(&estop);
+
+  std::mutex mu;
+  std::vector<std::string> order;
+  wf.SetFinishCallback([&](const my_data::Task& task, const my_data::TaskResult&) {
+    std::lock_guard<std::mutex> lk(mu);
+    order.push_back(task.task_id);
+  });
+
+  ASSERT_TRUE(wf.Start());
+  for (int i = 0; i < 5; ++i) {
+    my_data::Task t;
+    t.task_id = "task-" + std::to_string(i);
+    t.device_id = "uuv-1";
+    t.capability = "navigate";
+    t.action = "set";
+    q.Push(t);
+  }
+
+  // EStop 期间不取任务
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(q.Size(), 5u);
+
+  // 解除后由重试定时器恢复，同一设备的任务按入队顺序串行执行
+  estop.store(false);
+  for (int i = 0; i < 100 && q.Size() > 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  wf.Stop();
+  wf.Join();
+
+  std::lock_guard<std::mutex> lk(mu);
+  ASSERT_EQ(order.size(), 5u);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(order[i], "task-" + std::to_string(i));
+  }
+}
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include "MyData.h"
+
+using namespace my_data;
+
+TEST(MyData_JsonPayload, EmptyByDefault) {
+  JsonPayload p;
+  EXPECT_TRUE(p.empty());
+  EXPECT_TRUE(p.is_object());
+  EXPECT_EQ(p.dump(), "{}");
+  EXPECT_FALSE(p.contains("x"));
+  EXPECT_EQ(p.value("x", 3), 3);
+  EXPECT_EQ(p.value("s", "def"), "def");
+}
+
+TEST(MyData_JsonPayload, CopySharesUntilMutated) {
+  JsonPayload a = nlohmann::json{{"rate", 0.8}, {"mode", "auto"}};
+  JsonPayload b = a;
+  EXPECT_TRUE(a.IsShared());
+  EXPECT_EQ(&a.Get(), &b.Get());
+
+  b.Mutable()["rate"] = 1.5;
+  EXPECT_FALSE(a.IsShared());
+  EXPECT_DOUBLE_EQ(a.value("rate", 0.0), 0.8);
+  EXPECT_DOUBLE_EQ(b.value("rate", 0.0), 1.5);
+  EXPECT_EQ(b.value("mode", ""), "auto");
+}
+
+TEST(MyData_JsonPayload, TaskCopyAndMoveKeepParams) {
+  Task t;
+  t.task_id = "task-1";
+  t.params = nlohmann::json{{"lat", 1.0}};
+
+  Task copy = t;
+  EXPECT_TRUE(t.params.IsShared());
+  Task moved = std::move(copy);
+  EXPECT_DOUBLE_EQ(moved.params.value("lat", 0.0), 1.0);
+  EXPECT_EQ(moved.toJson()["params"], (nlohmann::json{{"lat", 1.0}}));
+  EXPECT_EQ(moved.toJson()["policy"], nlohmann::json::object());
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#include "MyDB.h"
+#include "MyDBWriter.h"
+#include "MyData.h"
+#include "demo/StatusRepository.h"
+#include "demo/TaskRepository.h"
+
+using namespace my_db;
+using namespace my_db::demo;
+
+static std::string DbPathWriter() {
+  return "/tmp/fast_cpp_server_test_db_writer.db";
+}
+
+static DBConfig WriterCfg() {
+  DBConfig cfg;
+  cfg.enable = true;
+  cfg.type = "sqlite";
+  cfg.path = DbPathWriter();
+  cfg.wal = true;
+  cfg.busy_timeout_ms = 1000;
+  cfg.synchronous = "NORMAL";
+  return cfg;
+}
+
+static void InitDB(const DBConfig& cfg, bool fresh) {
+  if (fresh) {
+    std::error_code ec;
+    std::filesystem::remove(cfg.path, ec);
+  }
+  std::string err;
+  ASSERT_TRUE(MyDB::GetInstance().Init(cfg, &err)) << err;
+  ASSERT_TRUE(MyDB::GetInstance().Migrate(&err)) << err;
+}
+
+// ---- 批量提交；Close 前把队列写完 ----
+TEST(MyDB_Writer, BatchesAndFlushesOnClose) {
+  DBConfig cfg = WriterCfg();
+  cfg.writer_batch_size = 64;
+  cfg.writer_flush_interval_ms = 1000;
+  InitDB(cfg, true);
+
+  my_data::DeviceStatus ds;
+  ds.device_id = "uuv-1";
+  std::string err;
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(StatusRepository::GetInstance().InsertDeviceSnapshot("edge-w", ds, &err)) << err;
+  }
+  MyDB::GetInstance().Close();
+
+  const auto stats = MyDBWriter::GetInstance().GetStatsJson();
+  EXPECT_EQ(stats["failed"].get<std::uint64_t>(), 0u);
+  EXPECT_LE(stats["max_batch"].get<std::uint64_t>(), 64u);
+  EXPECT_GE(stats["batches"].get<std::uint64_t>(), 1000u / 64);
+
+  InitDB(cfg, false);
+  std::int64_t cnt = 0;
+  ASSERT_TRUE(StatusRepository::GetInstance().CountDeviceSnapshots("edge-w", "uuv-1", &cnt, &err)) << err;
+  EXPECT_EQ(cnt, 1000);
+  MyDB::GetInstance().Close();
+}
+
+// ---- 持有 DB 锁时快照写入也不阻塞调用方 ----
+TEST(MyDB_Writer, SnapshotsDoNotBlockOnDbLock) {
+  InitDB(WriterCfg(), true);
+
+  my_data::EdgeStatus es;
+  es.edge_id = "edge-nb";
+  std::string err;
+  {
+    // 同一线程持有 DB 锁：若写入路径仍同步拿锁会直接卡死，能全部返回说明已交给写线程
+    std::lock_guard<std::mutex> lk(MyDB::GetInstance().Mutex());
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_TRUE(StatusRepository::GetInstance().InsertEdgeSnapshot(es, &err)) << err;
+    }
+  }
+
+  std::int64_t cnt = 0;
+  ASSERT_TRUE(StatusRepository::GetInstance().CountEdgeSnapshots("edge-nb", &cnt, &err)) << err;
+  EXPECT_EQ(cnt, 100);
+  MyDB::GetInstance().Close();
+}
+
+// ---- 队列满：快照丢弃，任务写入等待超时后失败 ----
+TEST(MyDB_Writer, BackPressureWhenQueueFull) {
+  DBConfig cfg = WriterCfg();
+  cfg.writer_queue_capacity = 8;
+  cfg.writer_batch_size = 8;
+  cfg.writer_enqueue_timeout_ms = 50;
+  InitDB(cfg, true);
+
+  my_data::DeviceStatus ds;
+  ds.device_id = "uuv-bp";
+  std::string err;
+  int accepted = 0;
+  int rejected = 0;
+  {
+    // 持有 DB 锁让写线程卡在提交上，队列只进不出
+    std::lock_guard<std::mutex> lk(MyDB::GetInstance().Mutex());
+    for (int i = 0; i < 40; ++i) {
+      if (StatusRepository::GetInstance().InsertDeviceSnapshot("edge-bp", ds, &err)) {
+        ++accepted;
+      } else {
+        ++rejected;
+      }
+    }
+
+    my_data::Task t;
+    t.task_id = "task-bp";
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(TaskRepository::GetInstance().UpsertTask(t, &err));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(45));
+  }
+  EXPECT_GT(rejected, 0);
+  EXPECT_LE(accepted, 16);   // 队列容量 + 写线程已取走的一批
+  EXPECT_GT(MyDBWriter::GetInstance().GetStatsJson()["dropped"].get<std::uint64_t>(), 0u);
+
+  std::int64_t cnt = 0;
+  ASSERT_TRUE(StatusRepository::GetInstance().CountDeviceSnapshots("edge-bp", "uuv-bp", &cnt, &err)) << err;
+  EXPECT_EQ(cnt, accepted);
+  MyDB::GetInstance().Close();
+}
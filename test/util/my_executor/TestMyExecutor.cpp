@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MyExecutor.h"
+
+using my_executor::MyExecutor;
+using my_executor::TimerId;
+
+// =============================================================================
+// 共享执行器单元测试（独立实例，不影响进程级单例）
+// =============================================================================
+
+namespace {
+
+// 只用于等待完成条件，超时留足余量，避免 CI 负载高时误报
+bool WaitUntil(const std::function<bool()>& pred, int timeout_ms = 10000) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (pred()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return pred();
+}
+
+} // namespace
+
+// ---- 提交任务全部执行；Shutdown 后拒绝新任务 ----
+TEST(MyExecutorTest, SubmitRunsAllAndShutdownRejects) {
+    MyExecutor ex;
+    ASSERT_TRUE(ex.Init({{"threads", 4}}));
+    EXPECT_EQ(ex.WorkerCount(), 4u);
+
+    std::atomic<int> done{0};
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(ex.Submit("test", [&] { done.fetch_add(1); }));
+    }
+    ex.Shutdown();
+    EXPECT_EQ(done.load(), 1000);
+    EXPECT_FALSE(ex.IsRunning());
+    EXPECT_FALSE(ex.Submit("test", [] {}));
+    EXPECT_EQ(ex.ScheduleAfter("test", 1, [] {}), 0u);
+}
+
+// ---- worker 内部派生的任务可被其它空闲 worker 窃取 ----
+TEST(MyExecutorTest, NestedSubmitIsStolen) {
+    MyExecutor ex;
+    ASSERT_TRUE(ex.Init({{"threads", 4}}));
+
+    std::atomic<int> done{0};
+    ASSERT_TRUE(ex.Submit("test", [&] {
+        // 全部压入当前 worker 的本地队列，自己忙着时只能靠其它 worker 窃取
+        for (int i = 0; i < 64; ++i) {
+            ex.Submit("test", [&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                done.fetch_add(1);
+            });
+        }
+        // 当前 worker 一直占着，直到有子任务被其它 worker 窃取执行
+        WaitUntil([&] { return done.load() > 0; });
+    }));
+    ASSERT_TRUE(WaitUntil([&] { return ex.GetStatsJson()["executed_total"].get<uint64_t>() == 65u; }));
+    EXPECT_EQ(done.load(), 64);
+
+    const nlohmann::json stats = ex.GetStatsJson();
+    EXPECT_GT(stats["steals_total"].get<uint64_t>(), 0u);
+    EXPECT_EQ(stats["workers"].size(), 4u);
+    ex.Shutdown();
+}
+
+// ---- 子系统预算限制并发，其它子系统不受影响 ----
+TEST(MyExecutorTest, SubsystemBudgetLimitsConcurrency) {
+    MyExecutor ex;
+    ASSERT_TRUE(ex.Init({{"threads", 4}, {"subsystem_budgets", {{"slow", 1}}}}));
+
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    std::atomic<int> slow_started{0};
+    std::atomic<int> slow_done{0};
+    std::atomic<bool> release{false};
+    for (int i = 0; i < 8; ++i) {
+        ex.Submit("slow", [&] {
+            const int now = running.fetch_add(1) + 1;
+            int prev = max_running.load();
+            while (now > prev && !max_running.compare_exchange_weak(prev, now)) {
+            }
+            slow_started.fetch_add(1);
+            // 第一个 slow 任务占住预算直到放行，其余 slow 任务只能排队
+            while (!release.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            running.fetch_sub(1);
+            slow_done.fetch_add(1);
+        });
+    }
+    ASSERT_TRUE(WaitUntil([&] { return slow_started.load() == 1; }));
+
+    // slow 排队期间，其它子系统的任务仍能执行（不必等 slow 放行）
+    std::atomic<bool> fast_done{false};
+    ex.Submit("fast", [&] { fast_done.store(true); });
+    ASSERT_TRUE(WaitUntil([&] { return fast_done.load(); }));
+    EXPECT_EQ(slow_done.load(), 0);
+    EXPECT_EQ(slow_started.load(), 1);
+
+    const nlohmann::json stats = ex.GetStatsJson();
+    EXPECT_EQ(stats["subsystems"]["slow"]["budget"], 1);
+    EXPECT_LE(stats["subsystems"]["slow"]["running"].get<int>(), 1);
+
+    release.store(true);
+    ASSERT_TRUE(WaitUntil([&] { return slow_done.load() == 8; }));
+    EXPECT_EQ(max_running.load(), 1);
+    ex.Shutdown();
+}
+
+// ---- 一次性与周期定时器 ----
+TEST(MyExecutorTest, TimersFireAfterDelayAndPeriodically) {
+    MyExecutor ex;
+    ASSERT_TRUE(ex.Init({{"threads", 2}}));
+
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<int64_t> once_at_ms{-1};
+    ex.ScheduleAfter("timer", 50, [&] {
+        once_at_ms.store(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    });
+
+    std::atomic<int> ticks{0};
+    const TimerId every = ex.ScheduleEvery("timer", 10, [&] { ticks.fetch_add(1); }, 0);
+    ASSERT_NE(every, 0u);
+
+    ASSERT_TRUE(WaitUntil([&] { return once_at_ms.load() >= 0 && ticks.load() >= 5; }));
+    // 只检查下限：负载高只会让回调更晚执行，不会更早
+    EXPECT_GE(once_at_ms.load(), 45);
+
+    // CancelTimer 默认等待执行中的回调结束，返回后计数不再变化
+    EXPECT_TRUE(ex.CancelTimer(every));
+    const int after_cancel = ticks.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(ticks.load(), after_cancel);
+    EXPECT_FALSE(ex.CancelTimer(every));
+    ex.Shutdown();
+}
+
+// ---- CancelTimer 等待执行中的回调结束；回调内取消自身不死锁 ----
+TEST(MyExecutorTest, CancelWaitsForRunningCallback) {
+    MyExecutor ex;
+    ASSERT_TRUE(ex.Init({{"threads", 2}}));
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    const TimerId id = ex.ScheduleEvery("timer", 5, [&] {
+        entered.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        finished.store(true);
+    }, 0);
+    ASSERT_TRUE(WaitUntil([&] { return entered.load(); }));
+    EXPECT_TRUE(ex.CancelTimer(id, true));
+    EXPECT_TRUE(finished.load());
+
+    std::atomic<int> self_ticks{0};
+    TimerId self_id = 0;
+    std::mutex mu;
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        self_id = ex.ScheduleEvery("timer", 5, [&] {
+            std::lock_guard<std::mutex> lk2(mu);
+            if (self_ticks.fetch_add(1) + 1 == 3) {
+                ex.CancelTimer(self_id, true);
+            }
+        }, 0);
+    }
+    ASSERT_TRUE(WaitUntil([&] { return self_ticks.load() >= 3; }));
+    // 第 3 次回调内已取消自身，之后不会再触发
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(self_ticks.load(), 3);
+    ex.Shutdown();
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -371,3 +372,68 @@ TEST(FlyControlCodecTest, SetOriginReturnEncode) {
     int32_t lon = static_cast<int32_t>(MyLEHelper::read_uint32(pf.payload, off));
     EXPECT_EQ(lon, 1163000000);
 }
+
+// ---- 描述表：定长报文帧长与解析器期望长度一致 ----
+TEST(FlyControlCodecTest, LayoutFrameLenMatchesParser) {
+    EXPECT_EQ(kFrameLenOf<HeartbeatData>, HEARTBEAT_FRAME_LEN);
+    EXPECT_EQ(kFrameLenOf<SetSpeedData>, EncodeSetSpeed(0, SetSpeedData{}).size());
+    EXPECT_EQ(kFrameLenOf<GuidanceNewData>, EncodeGuidanceNew(0, GuidanceNewData{}).size());
+    EXPECT_EQ(layout::FrameLen(FRAME_TYPE_COMMAND, CMD_GIMBAL_ANGLE), kFrameLenOf<GimbalAngleData>);
+    EXPECT_EQ(layout::FrameLen(FRAME_TYPE_COMMAND, CMD_SET_ROUTE), 0u);
+    EXPECT_EQ(layout::FrameLen(0x7F, 0), 0u);
+}
+
+// ---- 描述表：栈上编码与 vector 编码结果一致，且可被解析器还原 ----
+TEST(FlyControlCodecTest, EncodeFrameArrayMatchesVectorEncode) {
+    GuidanceNewData data;
+    data.pitch_los_rate = -123;
+    data.target_lon     = 1163974000;
+    data.target_lat     = -399093000;
+    data.laser_range    = 5000;
+    data.status         = 1;
+
+    auto arr = EncodeFrameArray(0x21, data);
+    auto vec = EncodeGuidanceNew(0x21, data);
+    ASSERT_EQ(arr.size(), vec.size());
+    EXPECT_TRUE(std::equal(arr.begin(), arr.end(), vec.begin()));
+
+    // 容量不足时不写入
+    uint8_t small[8] = {0};
+    EXPECT_EQ(EncodeFrameInto(0x21, data, small, sizeof(small)), 0u);
+
+    FrameParser parser;
+    parser.FeedData(arr.data(), arr.size());
+    FrameView view;
+    ASSERT_TRUE(parser.PopFrameView(view));
+    EXPECT_TRUE(view.valid);
+
+    GuidanceNewData decoded;
+    ASSERT_TRUE(DecodePayload(view.payload, view.payload_len, decoded));
+    EXPECT_EQ(decoded.cmd_type, CMD_GUIDANCE_NEW);
+    EXPECT_EQ(decoded.pitch_los_rate, -123);
+    EXPECT_EQ(decoded.target_lon, 1163974000);
+    EXPECT_EQ(decoded.target_lat, -399093000);
+    EXPECT_EQ(decoded.laser_range, 5000);
+    EXPECT_EQ(decoded.status, 1);
+}
+
+// ---- 描述表：指针版心跳解码，载荷不足时失败 ----
+TEST(FlyControlCodecTest, DecodeHeartbeatFromPointer) {
+    HeartbeatData src;
+    src.aircraft_id   = 7;
+    src.longitude     = -1163974000;
+    src.utc_timestamp = 0x0102030405060708ULL;
+    src.reserved      = 0xDEADBEEF;
+
+    uint8_t payload[layout::MessageLayout<HeartbeatData>::kPayloadLen] = {0};
+    layout::MessageLayout<HeartbeatData>::FieldsT::Store(src, payload);
+
+    HeartbeatData hb;
+    ASSERT_TRUE(DecodeHeartbeat(payload, sizeof(payload), hb));
+    EXPECT_EQ(hb.aircraft_id, 7);
+    EXPECT_EQ(hb.longitude, -1163974000);
+    EXPECT_EQ(hb.utc_timestamp, 0x0102030405060708ULL);
+    EXPECT_EQ(hb.reserved, 0xDEADBEEFu);
+
+    EXPECT_FALSE(DecodeHeartbeat(payload, sizeof(payload) - 1, hb));
+}
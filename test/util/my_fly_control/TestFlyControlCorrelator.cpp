@@ -0,0 +1,267 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "FlyControlCorrelator.h"
+#include "FlyControlProtocol.h"
+#include "MyFlyControl.h"
+
+using namespace fly_control;
+
+// =============================================================================
+// 指令应答关联器单元测试
+//
+// 所有用例显式传入时间点，不依赖真实时钟，也不需要串口。
+// 异步发送的参数校验用例使用未启动的 MyFlyControl（串口未打开）。
+// =============================================================================
+
+namespace {
+
+using Clock = CommandCorrelator::Clock;
+
+CommandReplyData MakeReply(uint8_t cnt, uint8_t cmd, uint8_t result) {
+    CommandReplyData reply;
+    reply.cnt         = cnt;
+    reply.replied_cmd = cmd;
+    reply.result      = result;
+    return reply;
+}
+
+CommandRetryPolicy MakePolicy(uint32_t timeout_ms, uint32_t max_retries) {
+    CommandRetryPolicy policy;
+    policy.timeout_ms  = timeout_ms;
+    policy.max_retries = max_retries;
+    return policy;
+}
+
+bool IsReady(std::future<CommandResult>& f) {
+    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+} // namespace
+
+// ---- 按 (CNT, 指令类型) 精确匹配，多条指令同时在途 ----
+TEST(FlyControlCorrelatorTest, ExactMatchWithManyInFlight) {
+    CommandCorrelator corr;
+    const auto t0 = Clock::now();
+
+    auto f1 = corr.Register(1, CMD_SET_SPEED, {}, MakePolicy(2000, 0), nullptr, t0);
+    auto f2 = corr.Register(2, CMD_SET_SPEED, {}, MakePolicy(2000, 0), nullptr, t0);
+    auto f3 = corr.Register(3, CMD_GUIDANCE_NEW, {}, MakePolicy(2000, 0), nullptr, t0);
+    EXPECT_EQ(corr.PendingCount(), 3u);
+
+    // 乱序回复
+    EXPECT_TRUE(corr.OnReply(MakeReply(2, CMD_SET_SPEED, 0x00), t0 + std::chrono::milliseconds(15)));
+    EXPECT_TRUE(corr.OnReply(MakeReply(3, CMD_GUIDANCE_NEW, 0x01), t0 + std::chrono::milliseconds(30)));
+    ASSERT_TRUE(IsReady(f2));
+    ASSERT_TRUE(IsReady(f3));
+    EXPECT_FALSE(IsReady(f1));
+
+    const CommandResult r2 = f2.get();
+    EXPECT_TRUE(r2.success);
+    EXPECT_TRUE(r2.replied);
+    EXPECT_EQ(r2.cnt, 2);
+    EXPECT_NEAR(r2.rtt_ms, 15.0, 0.01);
+
+    const CommandResult r3 = f3.get();
+    EXPECT_FALSE(r3.success);
+    EXPECT_TRUE(r3.replied);
+    EXPECT_EQ(r3.result, 0x01);
+
+    EXPECT_EQ(corr.PendingCount(), 1u);
+}
+
+// ---- 回复 CNT 不匹配时，退化为同指令类型中最早发出的一条 ----
+TEST(FlyControlCorrelatorTest, FallbackMatchesOldestSameCommand) {
+    CommandCorrelator corr;
+    const auto t0 = Clock::now();
+
+    auto f_old = corr.Register(10, CMD_SET_ALTITUDE, {}, MakePolicy(2000, 0), nullptr, t0);
+    auto f_new = corr.Register(11, CMD_SET_ALTITUDE, {}, MakePolicy(2000, 0), nullptr,
+                               t0 + std::chrono::milliseconds(5));
+
+    EXPECT_TRUE(corr.OnReply(MakeReply(0, CMD_SET_ALTITUDE, 0x00), t0 + std::chrono::milliseconds(20)));
+    ASSERT_TRUE(IsReady(f_old));
+    EXPECT_FALSE(IsReady(f_new));
+    EXPECT_EQ(f_old.get().cnt, 10);
+
+    // 没有同类型在途指令时不匹配
+    EXPECT_FALSE(corr.OnReply(MakeReply(0, CMD_PARACHUTE, 0x00), t0));
+}
+
+// ---- 超时后按策略重发，重试耗尽后以超时完成 ----
+TEST(FlyControlCorrelatorTest, TimeoutRetriesThenFails) {
+    CommandCorrelator corr;
+    const auto t0 = Clock::now();
+    const std::vector<uint8_t> frame = {0xEB, 0x90, 0x01, 0x10, 0x02, 0x04, 0x00};
+
+    int callback_count = 0;
+    auto f = corr.Register(5, CMD_SET_SPEED, frame, MakePolicy(100, 2),
+                           [&](const CommandResult&) { ++callback_count; }, t0);
+
+    std::vector<CommandResend> resend;
+    corr.CollectTimeouts(t0 + std::chrono::milliseconds(50), resend);
+    EXPECT_TRUE(resend.empty());
+
+    corr.CollectTimeouts(t0 + std::chrono::milliseconds(100), resend);
+    ASSERT_EQ(resend.size(), 1u);
+    EXPECT_EQ(resend[0].attempt, 2u);
+    EXPECT_EQ(resend[0].frame, frame);
+
+    resend.clear();
+    corr.CollectTimeouts(t0 + std::chrono::milliseconds(200), resend);
+    ASSERT_EQ(resend.size(), 1u);
+    EXPECT_EQ(resend[0].attempt, 3u);
+
+    resend.clear();
+    corr.CollectTimeouts(t0 + std::chrono::milliseconds(300), resend);
+    EXPECT_TRUE(resend.empty());
+    ASSERT_TRUE(IsReady(f));
+
+    const CommandResult r = f.get();
+    EXPECT_TRUE(r.timed_out);
+    EXPECT_FALSE(r.success);
+    EXPECT_EQ(r.attempts, 3u);
+    EXPECT_EQ(callback_count, 1);
+    EXPECT_EQ(corr.PendingCount(), 0u);
+}
+
+// ---- 重发后收到回复，RTT 从最后一次发送算起 ----
+TEST(FlyControlCorrelatorTest, ReplyAfterRetryMeasuresFromLastSend) {
+    CommandCorrelator corr;
+    const auto t0 = Clock::now();
+
+    auto f = corr.Register(7, CMD_SWITCH_MODE, {0x01}, MakePolicy(100, 1), nullptr, t0);
+    std::vector<CommandResend> resend;
+    corr.CollectTimeouts(t0 + std::chrono::milliseconds(100), resend);
+    ASSERT_EQ(resend.size(), 1u);
+
+    EXPECT_TRUE(corr.OnReply(MakeReply(7, CMD_SWITCH_MODE, 0x00), t0 + std::chrono::milliseconds(140)));
+    const CommandResult r = f.get();
+    EXPECT_TRUE(r.success);
+    EXPECT_EQ(r.attempts, 2u);
+    EXPECT_NEAR(r.rtt_ms, 40.0, 0.01);
+}
+
+// ---- 撤销、同 key 顶替与模块停止 ----
+TEST(FlyControlCorrelatorTest, CancelSupersedeAndFailAll) {
+    CommandCorrelator corr;
+    const auto t0 = Clock::now();
+
+    auto f_cancel = corr.Register(1, CMD_BUTTON, {}, MakePolicy(2000, 0), nullptr, t0);
+    corr.Cancel(1, CMD_BUTTON, "serial write failed");
+    ASSERT_TRUE(IsReady(f_cancel));
+    EXPECT_EQ(f_cancel.get().error, "serial write failed");
+
+    // CNT 回绕：同 key 的旧指令被顶替
+    auto f_first  = corr.Register(2, CMD_BUTTON, {}, MakePolicy(2000, 0), nullptr, t0);
+    auto f_second = corr.Register(2, CMD_BUTTON, {}, MakePolicy(2000, 0), nullptr, t0);
+    ASSERT_TRUE(IsReady(f_first));
+    EXPECT_FALSE(f_first.get().success);
+    EXPECT_FALSE(IsReady(f_second));
+
+    corr.FailAll("stopped");
+    ASSERT_TRUE(IsReady(f_second));
+    EXPECT_EQ(f_second.get().error, "stopped");
+    EXPECT_EQ(corr.PendingCount(), 0u);
+}
+
+// ---- 统计与 RTT 直方图 ----
+TEST(FlyControlCorrelatorTest, StatsJsonCountsAndHistogram) {
+    CommandCorrelator corr;
+    const auto t0 = Clock::now();
+
+    corr.Register(1, CMD_SET_SPEED, {}, MakePolicy(2000, 0), nullptr, t0);
+    corr.Register(2, CMD_SET_SPEED, {}, MakePolicy(2000, 0), nullptr, t0);
+    corr.Register(3, CMD_SET_SPEED, {}, MakePolicy(100, 0), nullptr, t0);
+    corr.OnReply(MakeReply(1, CMD_SET_SPEED, 0x00), t0 + std::chrono::milliseconds(3));
+    corr.OnReply(MakeReply(2, CMD_SET_SPEED, 0x01), t0 + std::chrono::milliseconds(40));
+    std::vector<CommandResend> resend;
+    corr.CollectTimeouts(t0 + std::chrono::milliseconds(150), resend);
+
+    const nlohmann::json j = corr.GetStatsJson();
+    ASSERT_EQ(j["commands"].size(), 1u);
+    const auto& speed = j["commands"][0];
+    EXPECT_EQ(speed["cmd_type"].get<int>(), CMD_SET_SPEED);
+    EXPECT_EQ(speed["sent"].get<uint64_t>(), 3u);
+    EXPECT_EQ(speed["replied"].get<uint64_t>(), 2u);
+    EXPECT_EQ(speed["success"].get<uint64_t>(), 1u);
+    EXPECT_EQ(speed["failed"].get<uint64_t>(), 1u);
+    EXPECT_EQ(speed["timeouts"].get<uint64_t>(), 1u);
+    EXPECT_NEAR(speed["rtt_min_ms"].get<double>(), 3.0, 0.01);
+    EXPECT_NEAR(speed["rtt_max_ms"].get<double>(), 40.0, 0.01);
+
+    // 3ms 落入 <=5 桶，40ms 落入 <=50 桶
+    const auto& hist = speed["rtt_histogram"];
+    ASSERT_EQ(hist.size(), CommandCorrelator::kRttBucketsMs.size() + 1);
+    EXPECT_EQ(hist[2]["count"].get<uint64_t>(), 1u);
+    EXPECT_EQ(hist[5]["count"].get<uint64_t>(), 1u);
+    EXPECT_EQ(j["pending"].get<size_t>(), 0u);
+
+    corr.ResetStats();
+    EXPECT_TRUE(corr.GetStatsJson()["commands"].empty());
+}
+
+// ---- 异步航线 / 围栏：点数非法时不发送、不占用 CNT，返回已就绪的失败结果 ----
+TEST(FlyControlCorrelatorTest, AsyncRouteAndGeofenceRejectBadPointCount) {
+    MyFlyControl fc;
+    SetSpeedData speed;
+    speed.speed = 100;
+
+    // 未启动时定长指令也走"立即就绪"路径，结果中带有本次占用的 CNT
+    auto f_before = fc.SendCommandAsync(speed);
+    ASSERT_TRUE(IsReady(f_before));
+    const uint8_t cnt_before = f_before.get().cnt;
+
+    int callbacks = 0;
+    std::string cb_error;
+    auto on_result = [&](const CommandResult& r) {
+        ++callbacks;
+        cb_error = r.error;
+        EXPECT_FALSE(r.success);
+    };
+
+    std::vector<std::future<CommandResult>> rejected;
+    rejected.push_back(fc.SendSetRouteAsync({}, on_result));
+    rejected.push_back(fc.SendSetRouteAsync(std::vector<RoutePoint>(51), on_result));
+    rejected.push_back(fc.SendSetGeofenceAsync(std::vector<GeofencePoint>(2), on_result));
+    rejected.push_back(fc.SendSetGeofenceAsync(std::vector<GeofencePoint>(51), on_result));
+    EXPECT_EQ(callbacks, 4);
+    EXPECT_FALSE(cb_error.empty());
+
+    const uint8_t expected_cmd[] = {CMD_SET_ROUTE, CMD_SET_ROUTE, CMD_SET_GEOFENCE, CMD_SET_GEOFENCE};
+    for (size_t i = 0; i < rejected.size(); ++i) {
+        ASSERT_TRUE(IsReady(rejected[i]));
+        const CommandResult r = rejected[i].get();
+        EXPECT_FALSE(r.success);
+        EXPECT_FALSE(r.replied);
+        EXPECT_EQ(r.attempts, 0u);
+        EXPECT_EQ(r.cmd_type, expected_cmd[i]);
+        EXPECT_FALSE(r.error.empty());
+    }
+
+    // 被拒绝的指令没有消耗 CNT
+    auto f_after = fc.SendCommandAsync(speed);
+    ASSERT_TRUE(IsReady(f_after));
+    EXPECT_EQ(f_after.get().cnt, static_cast<uint8_t>(cnt_before + 1));
+    EXPECT_EQ(fc.GetCommandStatsJson()["pending"].get<size_t>(), 0u);
+}
+
+// ---- 点数在范围边界内的异步航线 / 围栏正常编码发送 ----
+TEST(FlyControlCorrelatorTest, AsyncRouteAndGeofenceAcceptBoundaryCounts) {
+    MyFlyControl fc;
+    auto route = fc.SendSetRouteAsync(std::vector<RoutePoint>(1));
+    auto fence = fc.SendSetGeofenceAsync(std::vector<GeofencePoint>(3));
+    ASSERT_TRUE(IsReady(route));
+    ASSERT_TRUE(IsReady(fence));
+    const CommandResult r_route = route.get();
+    const CommandResult r_fence = fence.get();
+    // 未启动：已尝试发送（attempts=1），并各自占用一个 CNT
+    EXPECT_EQ(r_route.attempts, 1u);
+    EXPECT_EQ(r_fence.attempts, 1u);
+    EXPECT_EQ(r_fence.cnt, static_cast<uint8_t>(r_route.cnt + 1));
+}
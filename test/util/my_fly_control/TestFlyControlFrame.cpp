@@ -202,3 +202,88 @@ TEST(FlyControlFrameTest, ResetClearsBuffer) {
     parser.Reset();
     EXPECT_EQ(parser.BufferSize(), 0u);
 }
+
+// ---- FrameParser 零拷贝视图 ----
+TEST(FlyControlFrameTest, PopFrameViewPointsIntoBuffer) {
+    std::vector<uint8_t> payload = {0x04, 0xE8, 0x03};
+    auto raw = BuildFrame(0x07, FRAME_TYPE_COMMAND, payload);
+
+    FrameParser parser;
+    parser.FeedData(raw);
+
+    FrameView view;
+    ASSERT_TRUE(parser.PopFrameView(view));
+    EXPECT_TRUE(view.valid);
+    EXPECT_EQ(view.cnt, 0x07);
+    EXPECT_EQ(view.frame_type, FRAME_TYPE_COMMAND);
+    ASSERT_EQ(view.payload_len, payload.size());
+    EXPECT_EQ(std::vector<uint8_t>(view.payload, view.payload + view.payload_len), payload);
+    EXPECT_EQ(parser.BufferSize(), 0u);
+    EXPECT_FALSE(parser.PopFrameView(view));
+}
+
+// ---- FrameParser 帧头被拆在两次喂入之间 ----
+TEST(FlyControlFrameTest, ParseHeaderSplitAcrossFeeds) {
+    std::vector<uint8_t> payload = {0x0C, 0x00};
+    auto raw = BuildFrame(0x09, FRAME_TYPE_COMMAND, payload);
+
+    FrameParser parser;
+    std::vector<uint8_t> first = {0x11, 0x22, raw[0]};
+    parser.FeedData(first);
+
+    ParsedFrame frame;
+    EXPECT_FALSE(parser.PopFrame(frame));
+    // 帧头首字节之前的脏数据已丢弃，首字节保留等待下一批
+    EXPECT_EQ(parser.BufferSize(), 1u);
+    EXPECT_EQ(parser.DroppedBytes(), 2u);
+
+    parser.FeedData(raw.data() + 1, raw.size() - 1);
+    EXPECT_TRUE(parser.PopFrame(frame));
+    EXPECT_TRUE(frame.valid);
+    EXPECT_EQ(frame.cnt, 0x09);
+}
+
+// ---- FrameParser 缓冲区溢出时丢弃最旧数据并继续工作 ----
+TEST(FlyControlFrameTest, OverflowDropsOldestBytes) {
+    FrameParser parser(64);
+    EXPECT_EQ(parser.Capacity(), 64u);
+
+    std::vector<uint8_t> garbage(60, 0xEB);
+    parser.FeedData(garbage);
+
+    std::vector<uint8_t> payload = {0x06, 0x01};
+    auto raw = BuildFrame(0x02, FRAME_TYPE_COMMAND, payload);
+    parser.FeedData(raw);
+    EXPECT_LE(parser.BufferSize(), parser.Capacity());
+    EXPECT_GT(parser.DroppedBytes(), 0u);
+
+    ParsedFrame frame;
+    EXPECT_TRUE(parser.PopFrame(frame));
+    EXPECT_TRUE(frame.valid);
+    EXPECT_EQ(frame.cnt, 0x02);
+}
+
+// ---- FrameParser 长时间连续喂入，缓冲区循环复用 ----
+TEST(FlyControlFrameTest, ContinuousStreamReusesBuffer) {
+    FrameParser parser(128);
+    std::vector<uint8_t> payload(82, 0x00);
+
+    size_t parsed = 0;
+    ParsedFrame frame;
+    for (int i = 0; i < 100; ++i) {
+        auto raw = BuildFrame(static_cast<uint8_t>(i), FRAME_TYPE_HEARTBEAT, payload);
+        // 分两次喂入，模拟串口读批次与帧边界不对齐
+        parser.FeedData(raw.data(), 50);
+        while (parser.PopFrame(frame)) {
+            ++parsed;
+        }
+        parser.FeedData(raw.data() + 50, raw.size() - 50);
+        while (parser.PopFrame(frame)) {
+            EXPECT_TRUE(frame.valid);
+            EXPECT_EQ(frame.cnt, static_cast<uint8_t>(i));
+            ++parsed;
+        }
+    }
+    EXPECT_EQ(parsed, 100u);
+    EXPECT_EQ(parser.DroppedBytes(), 0u);
+}
@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <vector>
+
+#include "FlyControlCodec.h"
+#include "FlyControlFrame.h"
+#include "FlyControlProtocol.h"
+
+using namespace fly_control;
+
+// =============================================================================
+// 帧解析器性能基准
+//
+// 将一段"录制数据"按串口读批次（256 字节）喂入 FrameParser，统计：
+//   - 每秒解析帧数
+//   - 每帧堆分配次数（通过替换全局 operator new 计数，只统计基准线程自身的分配，
+//     测试程序中其他用例遗留的后台线程不计入）
+//
+// 录制数据来源：
+//   - 设置环境变量 FLY_CONTROL_CAPTURE_FILE 指向一份串口原始抓包时使用该文件
+//   - 否则生成一段模拟数据：心跳帧 + 末制导帧 + 回复帧 + 随机脏数据
+// =============================================================================
+
+namespace {
+
+thread_local bool     g_count_alloc = false;
+thread_local uint64_t g_alloc_count = 0;
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (g_count_alloc) {
+        ++g_alloc_count;
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+std::vector<uint8_t> LoadCapture() {
+    const char* path = std::getenv("FLY_CONTROL_CAPTURE_FILE");
+    if (path != nullptr) {
+        std::ifstream ifs(path, std::ios::binary);
+        if (ifs) {
+            return std::vector<uint8_t>(std::istreambuf_iterator<char>(ifs),
+                                        std::istreambuf_iterator<char>());
+        }
+        std::cout << "[FrameParserBench] 无法打开抓包文件 " << path << "，使用模拟数据" << std::endl;
+    }
+
+    std::vector<uint8_t> capture;
+    std::vector<uint8_t> hb_payload(82, 0x00);
+    GuidanceNewData guidance;
+    uint32_t seed = 12345;
+
+    for (int i = 0; i < 2000; ++i) {
+        hb_payload[0] = 0x01;
+        hb_payload[2] = static_cast<uint8_t>(i & 0x1F);
+        auto hb = BuildFrame(static_cast<uint8_t>(i), FRAME_TYPE_HEARTBEAT, hb_payload);
+        capture.insert(capture.end(), hb.begin(), hb.end());
+
+        guidance.pitch_los_rate = static_cast<int16_t>(i);
+        auto g = EncodeGuidanceNew(static_cast<uint8_t>(i), guidance);
+        capture.insert(capture.end(), g.begin(), g.end());
+
+        auto reply = BuildFrame(static_cast<uint8_t>(i), FRAME_TYPE_REPLY, {CMD_GUIDANCE_NEW, 0x00});
+        capture.insert(capture.end(), reply.begin(), reply.end());
+
+        // 每隔几帧插入一段串口噪声
+        if (i % 7 == 0) {
+            for (int k = 0; k < 13; ++k) {
+                seed = seed * 1103515245u + 12345u;
+                capture.push_back(static_cast<uint8_t>((seed >> 16) & 0xFF));
+            }
+        }
+    }
+    return capture;
+}
+
+} // namespace
+
+TEST(FlyControlFrameBench, ParserFramesPerSecondAndAllocations) {
+    const std::vector<uint8_t> capture = LoadCapture();
+    ASSERT_FALSE(capture.empty());
+
+    constexpr size_t kReadBatch = 256;
+    constexpr int kRounds = 20;
+
+    FrameParser parser;
+    FrameView view;
+    ParsedFrame frame;
+
+    // 预热一轮，让 ParsedFrame 的载荷容量稳定下来
+    for (size_t off = 0; off < capture.size(); off += kReadBatch) {
+        parser.FeedData(capture.data() + off, std::min(kReadBatch, capture.size() - off));
+        while (parser.PopFrame(frame)) {
+        }
+    }
+    parser.Reset();
+
+    uint64_t frames = 0;
+    uint64_t valid_frames = 0;
+    g_alloc_count = 0;
+    g_count_alloc = true;
+    const auto begin = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < kRounds; ++round) {
+        for (size_t off = 0; off < capture.size(); off += kReadBatch) {
+            parser.FeedData(capture.data() + off, std::min(kReadBatch, capture.size() - off));
+            // 奇数轮走零拷贝视图，偶数轮走复制到 ParsedFrame 的兼容接口
+            if (round % 2 == 1) {
+                while (parser.PopFrameView(view)) {
+                    ++frames;
+                    valid_frames += view.valid ? 1 : 0;
+                }
+            } else {
+                while (parser.PopFrame(frame)) {
+                    ++frames;
+                    valid_frames += frame.valid ? 1 : 0;
+                }
+            }
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    g_count_alloc = false;
+
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+    const uint64_t allocs = g_alloc_count;
+    const double frames_per_sec = seconds > 0 ? static_cast<double>(frames) / seconds : 0.0;
+    const double allocs_per_frame = frames > 0 ? static_cast<double>(allocs) / frames : 0.0;
+    const double mb_per_sec = seconds > 0
+        ? static_cast<double>(capture.size()) * kRounds / seconds / (1024.0 * 1024.0) : 0.0;
+
+    std::cout << "[FrameParserBench] capture_bytes=" << capture.size()
+              << " rounds=" << kRounds
+              << " frames=" << frames
+              << " valid=" << valid_frames
+              << " frames/sec=" << static_cast<uint64_t>(frames_per_sec)
+              << " MB/s=" << mb_per_sec
+              << " allocs=" << allocs
+              << " allocs/frame=" << allocs_per_frame
+              << " dropped_bytes=" << parser.DroppedBytes()
+              << std::endl;
+
+    EXPECT_GT(frames, 0u);
+    EXPECT_EQ(allocs, 0u);
+}
@@ -0,0 +1,188 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "FlyControlReplay.h"
+#include "FlyControlTelemetry.h"
+
+namespace fs = std::filesystem;
+
+using namespace fly_control;
+
+// =============================================================================
+// 遥测记录与回放单元测试
+// =============================================================================
+
+namespace {
+
+constexpr uint64_t kBaseNs   = 1700000000000000000ULL;
+constexpr uint64_t kPeriodNs = 20000000ULL;   // 50Hz 心跳
+
+std::string TelemetryPath(const std::string& name) {
+    fs::create_directories("logs");
+    const std::string path = "logs/" + name;
+    fs::remove(path);
+    fs::remove(path + ".idx");
+    return path;
+}
+
+HeartbeatData MakeHeartbeat(uint32_t i) {
+    HeartbeatData hb;
+    hb.cnt             = static_cast<uint8_t>(i);
+    hb.aircraft_id     = 1;
+    hb.satellite_count = static_cast<uint8_t>(i % 20);
+    hb.longitude       = 1163456789 + static_cast<int32_t>(i);
+    hb.latitude        = 396789012 - static_cast<int32_t>(i);
+    hb.altitude        = static_cast<uint16_t>(1000 + i);
+    hb.yaw             = static_cast<uint16_t>(i * 7);
+    hb.fault_info      = static_cast<uint16_t>(i & 0x1FFF);
+    hb.flight_time     = i;
+    return hb;
+}
+
+void RecordHeartbeats(const std::string& path, uint32_t count, uint32_t chunk_records) {
+    TelemetryRecorder recorder;
+    std::string err;
+    ASSERT_TRUE(recorder.Open(path, chunk_records, &err)) << err;
+    for (uint32_t i = 0; i < count; ++i) {
+        ASSERT_TRUE(recorder.Append(kBaseNs + i * kPeriodNs, MakeHeartbeat(i)));
+    }
+    recorder.Close();
+}
+
+} // namespace
+
+// ---- 跨多个 chunk 写入后逐条读回 ----
+TEST(FlyControlTelemetryTest, RecordAndReadAcrossChunks) {
+    const std::string path = TelemetryPath("telemetry_basic.bin");
+    RecordHeartbeats(path, 1000, 64);
+
+    TelemetryReader reader;
+    std::string err;
+    ASSERT_TRUE(reader.Open(path, &err)) << err;
+    ASSERT_EQ(reader.Count(), 1000u);
+    EXPECT_EQ(reader.Chunks().size(), (1000u + 63u) / 64u);
+
+    for (uint32_t i = 0; i < 1000; i += 37) {
+        TelemetryRecord rec;
+        ASSERT_TRUE(reader.Read(i, rec));
+        const HeartbeatData expect = MakeHeartbeat(i);
+        EXPECT_EQ(rec.seq, i);
+        EXPECT_EQ(rec.timestamp_ns, kBaseNs + i * kPeriodNs);
+        EXPECT_EQ(rec.heartbeat.cnt, expect.cnt);
+        EXPECT_EQ(rec.heartbeat.longitude, expect.longitude);
+        EXPECT_EQ(rec.heartbeat.latitude, expect.latitude);
+        EXPECT_EQ(rec.heartbeat.yaw, expect.yaw);
+        EXPECT_EQ(rec.heartbeat.flight_time, expect.flight_time);
+    }
+    TelemetryRecord rec;
+    EXPECT_FALSE(reader.Read(1000, rec));
+}
+
+// ---- 按时间戳定位；索引文件缺失时由数据重建 ----
+TEST(FlyControlTelemetryTest, LowerBoundWithAndWithoutIndex) {
+    const std::string path = TelemetryPath("telemetry_index.bin");
+    RecordHeartbeats(path, 500, 32);
+
+    for (int pass = 0; pass < 2; ++pass) {
+        if (pass == 1) {
+            fs::remove(path + ".idx");
+        }
+        TelemetryReader reader;
+        ASSERT_TRUE(reader.Open(path));
+        EXPECT_EQ(reader.LowerBound(0), 0u);
+        EXPECT_EQ(reader.LowerBound(kBaseNs + 123 * kPeriodNs), 123u);
+        EXPECT_EQ(reader.LowerBound(kBaseNs + 123 * kPeriodNs + 1), 124u);
+        EXPECT_EQ(reader.LowerBound(kBaseNs + 499 * kPeriodNs), 499u);
+        EXPECT_EQ(reader.LowerBound(kBaseNs + 500 * kPeriodNs), 500u);
+        ASSERT_EQ(reader.Chunks().size(), 16u);
+        EXPECT_EQ(reader.Chunks().back().count, 500u - 15u * 32u);
+    }
+}
+
+// ---- 尽快回放：所有心跳经 FrameParser 解析后原样送达 ----
+TEST(FlyControlTelemetryTest, ReplayAsFastAsPossible) {
+    const std::string path = TelemetryPath("telemetry_replay.bin");
+    RecordHeartbeats(path, 2000, 256);
+
+    TelemetryReader reader;
+    ASSERT_TRUE(reader.Open(path));
+    TelemetryReplayer replayer(reader);
+
+    ReplayOptions opt;
+    opt.speed = 0.0;
+    std::vector<HeartbeatData> received;
+    const ReplayStats stats = replayer.Run(opt, [&](const HeartbeatData& hb) { received.push_back(hb); });
+
+    EXPECT_EQ(stats.records, 2000u);
+    EXPECT_EQ(stats.frames, 2000u);
+    EXPECT_EQ(stats.heartbeats, 2000u);
+    EXPECT_EQ(stats.bad_frames, 0u);
+    ASSERT_EQ(received.size(), 2000u);
+    EXPECT_EQ(received[1234].longitude, MakeHeartbeat(1234).longitude);
+    EXPECT_EQ(received[1234].cnt, MakeHeartbeat(1234).cnt);
+
+    std::cout << "[TelemetryReplay] records=" << stats.records
+              << " elapsed_ms=" << stats.elapsed_ms
+              << " heartbeats/sec="
+              << (stats.elapsed_ms > 0 ? static_cast<uint64_t>(stats.heartbeats * 1000.0 / stats.elapsed_ms) : 0)
+              << std::endl;
+}
+
+// ---- 时间窗口 + 倍速回放：耗时约为录制跨度 / 倍速 ----
+TEST(FlyControlTelemetryTest, ReplayWindowAtSpeed) {
+    const std::string path = TelemetryPath("telemetry_speed.bin");
+    RecordHeartbeats(path, 200, 64);
+
+    TelemetryReader reader;
+    ASSERT_TRUE(reader.Open(path));
+    TelemetryReplayer replayer(reader);
+
+    // 取 [50, 100) 共 50 条，录制跨度 49 × 20ms = 980ms，20 倍速约 49ms
+    ReplayOptions opt;
+    opt.speed    = 20.0;
+    opt.begin_ns = kBaseNs + 50 * kPeriodNs;
+    opt.end_ns   = kBaseNs + 100 * kPeriodNs;
+    uint32_t first_flight_time = 0;
+    bool got_first = false;
+    const ReplayStats stats = replayer.Run(opt, [&](const HeartbeatData& hb) {
+        if (!got_first) {
+            first_flight_time = hb.flight_time;
+            got_first = true;
+        }
+    });
+
+    EXPECT_EQ(stats.heartbeats, 50u);
+    EXPECT_EQ(first_flight_time, 50u);
+    EXPECT_NEAR(stats.recorded_span_ms, 980.0, 0.001);
+    EXPECT_GE(stats.elapsed_ms, 45.0);
+    EXPECT_LT(stats.elapsed_ms, 500.0);
+}
+
+// ---- 回放可被外部停止 ----
+TEST(FlyControlTelemetryTest, ReplayStopsOnFlag) {
+    const std::string path = TelemetryPath("telemetry_stop.bin");
+    RecordHeartbeats(path, 100, 32);
+
+    TelemetryReader reader;
+    ASSERT_TRUE(reader.Open(path));
+    TelemetryReplayer replayer(reader);
+
+    std::atomic<bool> stop{false};
+    ReplayOptions opt;
+    opt.speed      = 0.0;
+    opt.feed_batch = 1;   // 每条记录单独喂入，便于在回调中停止
+    uint32_t seen = 0;
+    replayer.Run(opt, [&](const HeartbeatData&) {
+        if (++seen == 10) {
+            stop.store(true);
+        }
+    }, &stop);
+    EXPECT_EQ(seen, 10u);
+}
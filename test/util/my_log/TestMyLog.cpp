@@ -41,3 +41,49 @@ TEST(MyLogTest, CustomInit) {
 
     ASSERT_TRUE(fs::exists(custom_file));
 }
+
+namespace {
+
+int g_eval_count = 0;
+
+int CountedArg() {
+    ++g_eval_count;
+    return g_eval_count;
+}
+
+}  // namespace
+
+// 模块级别未开启时，宏参数不应被求值
+TEST(MyLogTest, ModuleLevelSkipsArgumentEvaluation) {
+    LogModule& mod = GetModule("test_module_gate");
+    ASSERT_TRUE(SetModuleLevel("test_module_gate", "warn"));
+
+    g_eval_count = 0;
+    MYLOG_MODULE_DEBUG(mod, "value={}", CountedArg());
+    MYLOG_MODULE_INFO(mod, "value={}", CountedArg());
+    EXPECT_EQ(g_eval_count, 0);
+
+    MYLOG_MODULE_WARN(mod, "value={}", CountedArg());
+    EXPECT_EQ(g_eval_count, 1);
+
+    // 同名模块返回同一对象
+    EXPECT_EQ(&GetModule("test_module_gate"), &mod);
+    EXPECT_FALSE(SetModuleLevel("test_module_gate", "not_a_level"));
+    EXPECT_EQ(mod.level.load(), static_cast<int>(spdlog::level::warn));
+}
+
+// 全局级别未开启时，普通宏同样不求值参数
+TEST(MyLogTest, GlobalLevelSkipsArgumentEvaluation) {
+    const auto old_level = spdlog::get_level();
+    spdlog::set_level(spdlog::level::info);
+
+    g_eval_count = 0;
+    MYLOG_DEBUG("value={}", CountedArg());
+    MYLOG_TRACE("value={}", CountedArg());
+    EXPECT_EQ(g_eval_count, 0);
+
+    MYLOG_INFO("value={}", CountedArg());
+    EXPECT_EQ(g_eval_count, 1);
+
+    spdlog::set_level(old_level);
+}
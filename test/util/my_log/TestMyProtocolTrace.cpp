@@ -0,0 +1,146 @@
+#include "MyProtocolTrace.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using MyLog::ProtocolTrace;
+
+namespace {
+
+std::string TracePath(const std::string& name) {
+    fs::create_directories("logs");
+    return "logs/" + name;
+}
+
+std::vector<uint8_t> MakePayload(uint32_t seq, size_t len) {
+    std::vector<uint8_t> payload(len);
+    for (size_t i = 0; i < len; ++i) {
+        payload[i] = static_cast<uint8_t>(seq + i);
+    }
+    return payload;
+}
+
+std::vector<ProtocolTrace::RecordView> ReadRecords(const std::string& path,
+                                                   std::vector<std::vector<uint8_t>>* payloads) {
+    std::vector<ProtocolTrace::RecordView> records;
+    std::string err;
+    EXPECT_TRUE(ProtocolTrace::ReadAll(path, [&](const ProtocolTrace::RecordView& rec) {
+        records.push_back(rec);
+        if (payloads) {
+            payloads->emplace_back(rec.data, rec.data + rec.len);
+        }
+        return true;
+    }, &err)) << err;
+    return records;
+}
+
+}  // namespace
+
+// 未回绕时按写入顺序完整读出
+TEST(MyProtocolTraceTest, RecordAndReadBack) {
+    const std::string path = TracePath("trace_basic.bin");
+    ProtocolTrace trace;
+    ProtocolTrace::Options opt;
+    opt.file_path  = path;
+    opt.ring_bytes = 64 * 1024;
+    std::string err;
+    ASSERT_TRUE(trace.Open(opt, &err)) << err;
+
+    for (uint32_t i = 0; i < 10; ++i) {
+        const auto payload = MakePayload(i, 5 + i);
+        trace.Record(3, i % 2 == 0 ? ProtocolTrace::kDirRx : ProtocolTrace::kDirTx,
+                     payload.data(), payload.size());
+    }
+    trace.Close();
+
+    std::vector<std::vector<uint8_t>> payloads;
+    const auto records = ReadRecords(path, &payloads);
+    ASSERT_EQ(records.size(), 10u);
+    for (uint32_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(records[i].seq, i);
+        EXPECT_EQ(records[i].channel, 3);
+        EXPECT_EQ(records[i].direction, i % 2 == 0 ? ProtocolTrace::kDirRx : ProtocolTrace::kDirTx);
+        EXPECT_EQ(payloads[i], MakePayload(i, 5 + i));
+    }
+}
+
+// 写满后覆盖最旧记录，读出的是连续的最新一段
+TEST(MyProtocolTraceTest, RingWrapKeepsNewestContiguous) {
+    const std::string path = TracePath("trace_wrap.bin");
+    ProtocolTrace trace;
+    ProtocolTrace::Options opt;
+    opt.file_path  = path;
+    opt.ring_bytes = 4096;
+    ASSERT_TRUE(trace.Open(opt));
+
+    constexpr uint32_t kTotal = 500;
+    for (uint32_t i = 0; i < kTotal; ++i) {
+        const auto payload = MakePayload(i, 10 + (i % 37));
+        trace.Record(0, ProtocolTrace::kDirRx, payload.data(), payload.size());
+    }
+    const auto stats = trace.GetStats();
+    EXPECT_EQ(stats.records, kTotal);
+    EXPECT_GT(stats.wraps, 0u);
+
+    std::vector<std::vector<uint8_t>> payloads;
+    const auto records = ReadRecords(path, &payloads);
+    ASSERT_FALSE(records.empty());
+    EXPECT_LT(records.size(), kTotal);
+    EXPECT_EQ(records.back().seq, kTotal - 1);
+    for (size_t i = 0; i < records.size(); ++i) {
+        const uint32_t seq = static_cast<uint32_t>(records[i].seq);
+        if (i > 0) {
+            EXPECT_EQ(records[i].seq, records[i - 1].seq + 1);
+        }
+        EXPECT_EQ(payloads[i], MakePayload(seq, 10 + (seq % 37)));
+    }
+}
+
+// 采样、速率上限与超长截断
+TEST(MyProtocolTraceTest, SamplingRateLimitAndTruncation) {
+    const std::string path = TracePath("trace_limit.bin");
+    ProtocolTrace trace;
+    ProtocolTrace::Options opt;
+    opt.file_path           = path;
+    opt.ring_bytes          = 8192;
+    opt.sample_every        = 4;
+    opt.max_records_per_sec = 5;
+    ASSERT_TRUE(trace.Open(opt));
+
+    const auto small = MakePayload(0, 8);
+    for (int i = 0; i < 40; ++i) {
+        trace.Record(0, ProtocolTrace::kDirRx, small.data(), small.size());
+    }
+    auto stats = trace.GetStats();
+    EXPECT_EQ(stats.sampled_out, 30u);
+    EXPECT_EQ(stats.records, 5u);
+    EXPECT_EQ(stats.rate_limited, 5u);
+
+    // 单条超过记录区一半时截断，orig_len 保留原始长度
+    ProtocolTrace big_trace;
+    opt.file_path           = TracePath("trace_big.bin");
+    opt.sample_every        = 1;
+    opt.max_records_per_sec = 0;
+    ASSERT_TRUE(big_trace.Open(opt));
+    const auto big = MakePayload(0, 6000);
+    big_trace.Record(0, ProtocolTrace::kDirTx, big.data(), big.size());
+    EXPECT_EQ(big_trace.GetStats().truncated, 1u);
+
+    const auto records = ReadRecords(opt.file_path, nullptr);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].orig_len, 6000u);
+    EXPECT_LT(records[0].len, 6000u);
+}
+
+// 未开启时 Record 直接返回
+TEST(MyProtocolTraceTest, DisabledIsNoop) {
+    ProtocolTrace trace;
+    const auto payload = MakePayload(0, 16);
+    trace.Record(0, ProtocolTrace::kDirRx, payload.data(), payload.size());
+    EXPECT_FALSE(trace.IsEnabled());
+    EXPECT_EQ(trace.GetStats().records, 0u);
+}
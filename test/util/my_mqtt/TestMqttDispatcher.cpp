@@ -0,0 +1,327 @@
+/**
+ * @file TestMqttDispatcher.cpp
+ * @brief MQTT 消息分发器 MqttDispatcher 单元测试
+ *
+ * 测试覆盖：
+ *   - DispatchOptions 解析：默认值、非法取值不修改输出
+ *   - inline 模式：在调用线程执行回调，记录路由统计，异常计入 errors
+ *   - lanes 模式：同一主题保持顺序，慢回调不阻塞其他通道
+ *   - lane_key=route：同一消息的不同路由在不同通道并行执行
+ *   - 通道满时 drop_newest / drop_oldest 的丢弃计数与保留内容
+ *   - Stop 丢弃未执行消息并计数
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MqttDispatcher.hpp"
+
+using namespace my_mqtt;
+using namespace std::chrono_literals;
+
+namespace {
+
+DispatchOptions LaneOptions(int lanes, int capacity, OverflowPolicy overflow = OverflowPolicy::DropOldest,
+                            LaneKey key = LaneKey::Topic) {
+    DispatchOptions options;
+    options.mode = DispatchMode::Lanes;
+    options.lanes = lanes;
+    options.queue_capacity = capacity;
+    options.overflow = overflow;
+    options.lane_key = key;
+    return options;
+}
+
+/// 可手动放行的闸门，用于让通道线程阻塞在回调中
+class Gate {
+public:
+    void Wait() {
+        std::unique_lock<std::mutex> lk(mtx_);
+        ++waiting_;
+        cv_.notify_all();
+        cv_.wait(lk, [&] { return open_; });
+    }
+    bool WaitUntilBlocked(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lk(mtx_);
+        return cv_.wait_for(lk, timeout, [&] { return waiting_ > 0; });
+    }
+    void Open() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        open_ = true;
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    int waiting_ = 0;
+    bool open_ = false;
+};
+
+template <typename Pred>
+bool WaitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// DispatchOptions
+// ============================================================================
+
+TEST(MqttDispatchOptionsTest, ParseAndValidate) {
+    DispatchOptions options;
+    std::string err;
+    ASSERT_TRUE(DispatchOptions::FromJson({{"mode", "lanes"}, {"lanes", 4}, {"lane_key", "route"},
+                                           {"overflow", "drop_newest"}}, options, &err)) << err;
+    EXPECT_EQ(options.mode, DispatchMode::Lanes);
+    EXPECT_EQ(options.lanes, 4);
+    EXPECT_EQ(options.queue_capacity, 256);
+    EXPECT_EQ(options.lane_key, LaneKey::Route);
+    EXPECT_EQ(options.overflow, OverflowPolicy::DropNewest);
+
+    const DispatchOptions before = options;
+    EXPECT_FALSE(DispatchOptions::FromJson({{"mode", "async"}}, options, &err));
+    EXPECT_NE(err.find("mode"), std::string::npos);
+    EXPECT_FALSE(DispatchOptions::FromJson({{"lanes", 0}}, options, &err));
+    EXPECT_FALSE(DispatchOptions::FromJson({{"queue_capacity", "10"}}, options, &err));
+    EXPECT_FALSE(DispatchOptions::FromJson({{"mode", "inline"}, {"overflow", "block"}}, options, &err));
+    EXPECT_FALSE(DispatchOptions::FromJson(nlohmann::json::array(), options, &err));
+    EXPECT_EQ(options.mode, before.mode);   // 失败时不修改
+
+    EXPECT_EQ(options.ToJson()["overflow"], "drop_newest");
+}
+
+// ============================================================================
+// inline
+// ============================================================================
+
+TEST(MqttDispatcherTest, InlineRunsOnCallerThreadAndRecordsStats) {
+    std::thread::id handler_thread;
+    auto router = TopicRouter::Build({
+        Route{"a/+", [&](const std::string&, const std::string&) { handler_thread = std::this_thread::get_id(); }, 0},
+        Route{"a/#", [](const std::string&, const std::string&) { throw std::runtime_error("boom"); }, 0},
+    });
+
+    MqttDispatcher dispatcher(DispatchOptions{});
+    EXPECT_EQ(dispatcher.Dispatch(router, "a/b", "x"), 2u);
+    EXPECT_EQ(dispatcher.Dispatch(router, "none", "x"), 0u);
+    EXPECT_EQ(handler_thread, std::this_thread::get_id());
+
+    const auto& routes = router->Routes();
+    EXPECT_EQ(routes[0].stats->handled.load(), 1u);
+    EXPECT_EQ(routes[0].stats->errors.load(), 0u);
+    EXPECT_EQ(routes[1].stats->handled.load(), 1u);
+    EXPECT_EQ(routes[1].stats->errors.load(), 1u);
+    EXPECT_EQ(dispatcher.GetStatsJson()["dispatched"], 1);
+    EXPECT_TRUE(dispatcher.GetStatsJson()["lanes"].empty());
+}
+
+// ============================================================================
+// lanes
+// ============================================================================
+
+TEST(MqttDispatcherTest, LanesPreservePerTopicOrder) {
+    std::mutex mtx;
+    std::map<std::string, std::vector<int>> seen;
+    auto router = TopicRouter::Build({
+        Route{"t/+", [&](const std::string& topic, const std::string& payload) {
+            std::lock_guard<std::mutex> lk(mtx);
+            seen[topic].push_back(std::stoi(payload));
+        }, 0},
+    });
+
+    MqttDispatcher dispatcher(LaneOptions(4, 10000));
+    constexpr int kTopics = 8;
+    constexpr int kPerTopic = 500;
+    for (int i = 0; i < kPerTopic; ++i) {
+        for (int t = 0; t < kTopics; ++t) {
+            dispatcher.Dispatch(router, "t/" + std::to_string(t), std::to_string(i));
+        }
+    }
+    ASSERT_TRUE(WaitFor([&] { return router->Routes()[0].stats->handled.load() == kTopics * kPerTopic; }));
+
+    std::lock_guard<std::mutex> lk(mtx);
+    ASSERT_EQ(seen.size(), static_cast<std::size_t>(kTopics));
+    for (const auto& [topic, values] : seen) {
+        ASSERT_EQ(values.size(), static_cast<std::size_t>(kPerTopic)) << topic;
+        for (int i = 0; i < kPerTopic; ++i) {
+            ASSERT_EQ(values[i], i) << topic;
+        }
+    }
+    EXPECT_EQ(router->Routes()[0].stats->dropped.load(), 0u);
+}
+
+TEST(MqttDispatcherTest, SlowHandlerDoesNotBlockCallerOrOtherLanes) {
+    Gate gate;
+    std::atomic<int> fast{0};
+    auto router = TopicRouter::Build({
+        Route{"slow", [&](const std::string&, const std::string&) { gate.Wait(); }, 0},
+        Route{"fast/+", [&](const std::string&, const std::string&) { ++fast; }, 0},
+    });
+
+    // 找一个与 "slow" 不同通道的主题
+    constexpr int kLanes = 4;
+    std::string fast_topic;
+    for (int i = 0; fast_topic.empty(); ++i) {
+        std::string topic = "fast/" + std::to_string(i);
+        if (std::hash<std::string>{}(topic) % kLanes != std::hash<std::string>{}("slow") % kLanes) {
+            fast_topic = topic;
+        }
+    }
+
+    MqttDispatcher dispatcher(LaneOptions(kLanes, 64));
+    const auto start = std::chrono::steady_clock::now();
+    dispatcher.Dispatch(router, "slow", "");
+    ASSERT_TRUE(gate.WaitUntilBlocked(2000ms));
+    for (int i = 0; i < 10; ++i) {
+        dispatcher.Dispatch(router, fast_topic, "");
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);   // 调用方（网络线程）不被阻塞
+    EXPECT_TRUE(WaitFor([&] { return fast.load() == 10; }));
+
+    gate.Open();
+    EXPECT_TRUE(WaitFor([&] { return router->Routes()[0].stats->handled.load() == 1; }));
+
+    const auto slow_stats = router->Routes()[0].stats->ToJson();
+    EXPECT_EQ(slow_stats["handled"], 1);
+    EXPECT_GT(slow_stats["handler_us_max"].get<std::uint64_t>(), 0u);
+    EXPECT_EQ(router->Routes()[1].stats->ToJson()["handled"], 10);
+}
+
+TEST(MqttDispatcherTest, RouteKeyRunsRoutesOfOneMessageInParallel) {
+    Gate gate;
+    std::atomic<int> other{0};
+    // 选择两个落在不同通道、且都匹配 "x/y" 的过滤器
+    constexpr int kLanes = 4;
+    const std::string slow_filter = "x/#";
+    std::string other_filter;
+    for (const std::string candidate : {"x/+", "+/y", "x/y", "+/+", "#", "+/#"}) {
+        if (std::hash<std::string>{}(candidate) % kLanes != std::hash<std::string>{}(slow_filter) % kLanes) {
+            other_filter = candidate;
+            break;
+        }
+    }
+    if (other_filter.empty()) {
+        GTEST_SKIP() << "no filter pair on distinct lanes";
+    }
+    auto router = TopicRouter::Build({
+        Route{slow_filter, [&](const std::string&, const std::string&) { gate.Wait(); }, 0},
+        Route{other_filter, [&](const std::string&, const std::string&) { ++other; }, 0},
+    });
+
+    MqttDispatcher dispatcher(LaneOptions(kLanes, 64, OverflowPolicy::DropOldest, LaneKey::Route));
+    EXPECT_EQ(dispatcher.Dispatch(router, "x/y", ""), 2u);
+    ASSERT_TRUE(gate.WaitUntilBlocked(2000ms));
+    EXPECT_TRUE(WaitFor([&] { return other.load() == 1; }));
+    gate.Open();
+}
+
+// ============================================================================
+// 溢出策略
+// ============================================================================
+
+TEST(MqttDispatcherTest, DropNewestKeepsQueuedMessages) {
+    Gate gate;
+    std::mutex mtx;
+    std::vector<std::string> seen;
+    auto router = TopicRouter::Build({
+        Route{"t", [&](const std::string&, const std::string& payload) {
+            if (payload == "block") gate.Wait();
+            std::lock_guard<std::mutex> lk(mtx);
+            seen.push_back(payload);
+        }, 0},
+    });
+
+    MqttDispatcher dispatcher(LaneOptions(1, 2, OverflowPolicy::DropNewest));
+    dispatcher.Dispatch(router, "t", "block");
+    ASSERT_TRUE(gate.WaitUntilBlocked(2000ms));
+    for (int i = 0; i < 5; ++i) {
+        dispatcher.Dispatch(router, "t", std::to_string(i));
+    }
+    gate.Open();
+
+    const auto& stats = *router->Routes()[0].stats;
+    ASSERT_TRUE(WaitFor([&] { return stats.handled.load() == 3; }));
+    EXPECT_EQ(stats.dropped.load(), 3u);
+    std::lock_guard<std::mutex> lk(mtx);
+    EXPECT_EQ(seen, (std::vector<std::string>{"block", "0", "1"}));
+
+    auto lanes = dispatcher.GetStatsJson()["lanes"];
+    EXPECT_EQ(lanes[0]["dropped"], 3);
+    EXPECT_EQ(lanes[0]["max_depth"], 2);
+}
+
+TEST(MqttDispatcherTest, DropOldestKeepsLatestMessages) {
+    Gate gate;
+    std::mutex mtx;
+    std::vector<std::string> seen;
+    auto router = TopicRouter::Build({
+        Route{"t", [&](const std::string&, const std::string& payload) {
+            if (payload == "block") gate.Wait();
+            std::lock_guard<std::mutex> lk(mtx);
+            seen.push_back(payload);
+        }, 0},
+    });
+
+    MqttDispatcher dispatcher(LaneOptions(1, 2, OverflowPolicy::DropOldest));
+    dispatcher.Dispatch(router, "t", "block");
+    ASSERT_TRUE(gate.WaitUntilBlocked(2000ms));
+    for (int i = 0; i < 5; ++i) {
+        dispatcher.Dispatch(router, "t", std::to_string(i));
+    }
+    gate.Open();
+
+    const auto& stats = *router->Routes()[0].stats;
+    ASSERT_TRUE(WaitFor([&] { return stats.handled.load() == 3; }));
+    EXPECT_EQ(stats.dropped.load(), 3u);
+    std::lock_guard<std::mutex> lk(mtx);
+    EXPECT_EQ(seen, (std::vector<std::string>{"block", "3", "4"}));
+}
+
+TEST(MqttDispatcherTest, StopDiscardsPendingMessages) {
+    Gate gate;
+    auto router = TopicRouter::Build({
+        Route{"t", [&](const std::string&, const std::string& payload) {
+            if (payload == "block") gate.Wait();
+        }, 0},
+    });
+
+    MqttDispatcher dispatcher(LaneOptions(1, 16));
+    dispatcher.Dispatch(router, "t", "block");
+    ASSERT_TRUE(gate.WaitUntilBlocked(2000ms));
+    for (int i = 0; i < 4; ++i) {
+        dispatcher.Dispatch(router, "t", "x");
+    }
+
+    std::thread opener([&] {
+        std::this_thread::sleep_for(50ms);
+        gate.Open();
+    });
+    dispatcher.Stop();
+    opener.join();
+
+    const auto& stats = *router->Routes()[0].stats;
+    EXPECT_EQ(stats.handled.load(), 1u);
+    EXPECT_EQ(stats.dropped.load(), 4u);
+
+    // 停止后的消息直接丢弃
+    dispatcher.Dispatch(router, "t", "late");
+    EXPECT_EQ(stats.dropped.load(), 5u);
+    EXPECT_TRUE(dispatcher.GetStatsJson()["stopped"].get<bool>());
+}
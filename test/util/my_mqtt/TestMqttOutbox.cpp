@@ -0,0 +1,492 @@
+/**
+ * @file TestMqttOutbox.cpp
+ * @brief MQTT 发布出站队列 MqttOutbox 单元测试与吞吐基准
+ *
+ * 测试覆盖：
+ *   - OutboxOptions 解析与校验
+ *   - 在线时按批发送且保持顺序
+ *   - 离线时最新值主题合并、内存队列满时丢弃最早消息
+ *   - 离线时 QoS>=1 消息落盘，重连后按顺序回放并截断文件
+ *   - 停止后重启继续回放，截掉不完整的尾部记录
+ *   - 发送失败时未发送部分按顺序重试
+ *   - 基准：本地 socketpair 模拟 broker（每条消息加锁编码 PUBLISH 报文并写套接字），
+ *     对比直接发布与经出站队列发布的发布方吞吐
+ */
+
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MqttOutbox.hpp"
+
+using namespace my_mqtt;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// 记录发送内容的假发送端
+class RecordingSender {
+public:
+    OutboxBatchSender Sender() {
+        return [this](const std::vector<OutboxMessage>& batch) -> std::size_t {
+            std::lock_guard<std::mutex> lk(mtx_);
+            batch_sizes_.push_back(batch.size());
+            std::size_t n = batch.size();
+            if (fail_after_ >= 0) {
+                n = std::min<std::size_t>(n, static_cast<std::size_t>(fail_after_));
+                fail_after_ = -1;   // 只失败一次
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                messages_.push_back(batch[i]);
+            }
+            return n;
+        };
+    }
+
+    /// 下一次调用只发送前 n 条
+    void FailNextAfter(int n) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        fail_after_ = n;
+    }
+
+    std::vector<OutboxMessage> Messages() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return messages_;
+    }
+
+    std::vector<std::string> Payloads() {
+        std::vector<std::string> out;
+        for (const auto& m : Messages()) out.push_back(m.payload);
+        return out;
+    }
+
+    std::vector<std::size_t> BatchSizes() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return batch_sizes_;
+    }
+
+private:
+    std::mutex mtx_;
+    std::vector<OutboxMessage> messages_;
+    std::vector<std::size_t> batch_sizes_;
+    int fail_after_ = -1;
+};
+
+template <typename Pred>
+bool WaitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+std::string TempPath(const std::string& name) {
+    auto dir = std::filesystem::temp_directory_path() / "fast_cpp_server_test_outbox";
+    std::filesystem::create_directories(dir);
+    auto path = dir / (name + "_" + std::to_string(::getpid()) + ".bin");
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+OutboxOptions Options(int capacity = 1024, int batch_size = 16) {
+    OutboxOptions options;
+    options.enabled = true;
+    options.capacity = capacity;
+    options.batch_size = batch_size;
+    options.retry_interval_ms = 10;
+    return options;
+}
+
+} // namespace
+
+// ============================================================================
+// OutboxOptions
+// ============================================================================
+
+TEST(MqttOutboxOptionsTest, ParseAndValidate) {
+    OutboxOptions options;
+    std::string err;
+    ASSERT_TRUE(OutboxOptions::FromJson({{"enabled", true}, {"capacity", 100}, {"coalesce_topics", {"hb/+"}},
+                                         {"persist_path", "/tmp/x.bin"}}, options, &err)) << err;
+    EXPECT_TRUE(options.enabled);
+    EXPECT_EQ(options.capacity, 100);
+    EXPECT_EQ(options.batch_size, 64);
+    EXPECT_EQ(options.coalesce_topics, (std::vector<std::string>{"hb/+"}));
+    EXPECT_EQ(options.persist_path, "/tmp/x.bin");
+
+    EXPECT_FALSE(OutboxOptions::FromJson({{"enabled", 1}}, options, &err));
+    EXPECT_FALSE(OutboxOptions::FromJson({{"batch_size", 0}}, options, &err));
+    EXPECT_FALSE(OutboxOptions::FromJson({{"coalesce_topics", {"a/#/b"}}}, options, &err));
+    EXPECT_NE(err.find("coalesce_topics"), std::string::npos);
+    EXPECT_FALSE(OutboxOptions::FromJson({{"persist_max_bytes", 10}}, options, &err));
+    EXPECT_EQ(options.capacity, 100);   // 失败时不修改
+}
+
+// ============================================================================
+// 在线发送
+// ============================================================================
+
+TEST(MqttOutboxTest, SendsInOrderAndInBatches) {
+    RecordingSender sink;
+    MqttOutbox outbox(Options(1024, 16), sink.Sender());
+    outbox.SetConnected(true);
+
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(outbox.Enqueue({"t/" + std::to_string(i % 3), std::to_string(i), 0, false}));
+    }
+    ASSERT_TRUE(outbox.Flush(2000ms));
+
+    const auto payloads = sink.Payloads();
+    ASSERT_EQ(payloads.size(), 200u);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_EQ(payloads[i], std::to_string(i));
+    }
+    for (auto size : sink.BatchSizes()) {
+        EXPECT_LE(size, 16u);
+    }
+    EXPECT_EQ(outbox.GetStatsJson()["sent"], 200);
+}
+
+TEST(MqttOutboxTest, PartialFailureRetriesRemainingInOrder) {
+    RecordingSender sink;
+    sink.FailNextAfter(3);
+    MqttOutbox outbox(Options(1024, 8), sink.Sender());
+
+    for (int i = 0; i < 8; ++i) {
+        outbox.Enqueue({"t", std::to_string(i), 1, false});
+    }
+    outbox.SetConnected(true);
+    ASSERT_TRUE(outbox.Flush(2000ms));
+
+    EXPECT_EQ(sink.Payloads(), (std::vector<std::string>{"0", "1", "2", "3", "4", "5", "6", "7"}));
+    auto stats = outbox.GetStatsJson();
+    EXPECT_EQ(stats["send_failures"], 1);
+    EXPECT_EQ(stats["sent"], 8);
+}
+
+// ============================================================================
+// 离线：合并与溢出
+// ============================================================================
+
+TEST(MqttOutboxTest, CoalescesLatestValueTopicsWhileOffline) {
+    RecordingSender sink;
+    auto options = Options();
+    options.coalesce_topics = {"hb/+"};
+    MqttOutbox outbox(options, sink.Sender());
+
+    outbox.Enqueue({"event", "e0", 0, false});
+    for (int i = 1; i <= 100; ++i) {
+        outbox.Enqueue({"hb/a", "a" + std::to_string(i), 0, false});
+        outbox.Enqueue({"hb/b", "b" + std::to_string(i), 1, false});   // 合并主题不落盘
+    }
+    outbox.Enqueue({"event", "e1", 0, false});
+
+    auto stats = outbox.GetStatsJson();
+    EXPECT_EQ(stats["depth"], 4);
+    EXPECT_EQ(stats["coalesced"], 198);
+
+    outbox.SetConnected(true);
+    ASSERT_TRUE(outbox.Flush(2000ms));
+    // 合并后保持首次入队的位置，内容为最新值
+    EXPECT_EQ(sink.Payloads(), (std::vector<std::string>{"e0", "a100", "b100", "e1"}));
+}
+
+TEST(MqttOutboxTest, OverflowDropsOldest) {
+    RecordingSender sink;
+    MqttOutbox outbox(Options(3, 16), sink.Sender());
+
+    for (int i = 0; i < 5; ++i) {
+        outbox.Enqueue({"t", std::to_string(i), 0, false});
+    }
+    EXPECT_EQ(outbox.GetStatsJson()["dropped_overflow"], 2);
+
+    outbox.SetConnected(true);
+    ASSERT_TRUE(outbox.Flush(2000ms));
+    EXPECT_EQ(sink.Payloads(), (std::vector<std::string>{"2", "3", "4"}));
+}
+
+// ============================================================================
+// 离线持久化与回放
+// ============================================================================
+
+TEST(MqttOutboxTest, PersistsQos1OfflineAndReplaysInOrder) {
+    RecordingSender sink;
+    auto options = Options(1024, 8);
+    options.persist_path = TempPath("replay");
+    MqttOutbox outbox(options, sink.Sender());
+
+    for (int i = 0; i < 50; ++i) {
+        outbox.Enqueue({"cmd/ack", "q" + std::to_string(i), 1, false});
+        if (i % 10 == 0) {
+            outbox.Enqueue({"log", "l" + std::to_string(i), 0, false});
+        }
+    }
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStatsJson()["persisted"] == 50; }));
+    EXPECT_GT(std::filesystem::file_size(options.persist_path), 0u);
+    EXPECT_EQ(outbox.GetStatsJson()["depth"], 5);   // QoS0 留在内存
+
+    outbox.SetConnected(true);
+    ASSERT_TRUE(outbox.Flush(2000ms));
+
+    std::vector<std::string> qos1;
+    for (const auto& m : sink.Messages()) {
+        if (m.qos == 1) {
+            EXPECT_EQ(m.topic, "cmd/ack");
+            qos1.push_back(m.payload);
+        }
+    }
+    ASSERT_EQ(qos1.size(), 50u);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(qos1[i], "q" + std::to_string(i));
+    }
+    EXPECT_EQ(sink.Messages().size(), 55u);
+    EXPECT_EQ(outbox.GetStatsJson()["replayed"], 50);
+    EXPECT_EQ(std::filesystem::file_size(options.persist_path), 0u);
+}
+
+TEST(MqttOutboxTest, DisconnectDuringReplayKeepsOrder) {
+    RecordingSender sink;
+    auto options = Options(1024, 4);
+    options.persist_path = TempPath("reconnect");
+    MqttOutbox outbox(options, sink.Sender());
+
+    for (int i = 0; i < 20; ++i) {
+        outbox.Enqueue({"t", std::to_string(i), 1, false});
+    }
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStatsJson()["persisted"] == 20; }));
+
+    // 回放第一批时只成功 2 条，随后断开；断开期间又产生新消息
+    sink.FailNextAfter(2);
+    outbox.SetConnected(true);
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStatsJson()["send_failures"] == 1; }));
+    outbox.SetConnected(false);
+    for (int i = 20; i < 25; ++i) {
+        outbox.Enqueue({"t", std::to_string(i), 1, false});
+    }
+    ASSERT_TRUE(WaitFor([&] { return outbox.GetStatsJson()["persisted"] == 25; }));
+
+    outbox.SetConnected(true);
+    ASSERT_TRUE(outbox.Flush(2000ms));
+    const auto payloads = sink.Payloads();
+    ASSERT_EQ(payloads.size(), 25u);
+    for (int i = 0; i < 25; ++i) {
+        EXPECT_EQ(payloads[i], std::to_string(i));
+    }
+}
+
+TEST(MqttOutboxTest, ReplaysAfterRestartAndDropsTornTail) {
+    const std::string path = TempPath("restart");
+    {
+        RecordingSender sink;
+        auto options = Options();
+        options.persist_path = path;
+        MqttOutbox outbox(options, sink.Sender());
+        for (int i = 0; i < 10; ++i) {
+            outbox.Enqueue({"t", std::to_string(i), 2, i % 2 == 0});
+        }
+        outbox.Stop();   // 未连接：停止时写入文件
+        EXPECT_TRUE(sink.Messages().empty());
+    }
+    {
+        // 模拟写入中途掉电留下的半条记录
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("MQOB\x05\x00", 6);
+    }
+
+    RecordingSender sink;
+    auto options = Options();
+    options.persist_path = path;
+    MqttOutbox outbox(options, sink.Sender());
+    outbox.SetConnected(true);
+    ASSERT_TRUE(outbox.Flush(2000ms));
+
+    const auto messages = sink.Messages();
+    ASSERT_EQ(messages.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(messages[i].payload, std::to_string(i));
+        EXPECT_EQ(messages[i].qos, 2);
+        EXPECT_EQ(messages[i].retain, i % 2 == 0);
+    }
+}
+
+TEST(MqttOutboxTest, PersistLimitDropsNewMessages) {
+    RecordingSender sink;
+    auto options = Options();
+    options.persist_path = TempPath("limit");
+    options.persist_max_bytes = 1024;
+    MqttOutbox outbox(options, sink.Sender());
+
+    const std::string payload(100, 'x');
+    for (int i = 0; i < 20; ++i) {
+        outbox.Enqueue({"t", payload, 1, false});
+    }
+    ASSERT_TRUE(WaitFor([&] {
+        auto stats = outbox.GetStatsJson();
+        return stats["persisted"].get<int>() + stats["dropped_persist"].get<int>() == 20;
+    }));
+    EXPECT_LE(std::filesystem::file_size(options.persist_path), 1024u);
+    EXPECT_GT(outbox.GetStatsJson()["dropped_persist"].get<int>(), 0);
+}
+
+// ============================================================================
+// 基准：本地 broker 替身
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief broker 替身：与 mosquitto_publish 一样每条消息加锁、编码 PUBLISH 报文并写套接字，
+ * 对端线程读取并统计报文字节数
+ */
+class StandInBroker {
+public:
+    StandInBroker() {
+        ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds_);
+        reader_ = std::thread([this] {
+            char buf[65536];
+            for (;;) {
+                const auto n = ::read(fds_[1], buf, sizeof(buf));
+                if (n <= 0) break;
+                received_bytes_ += static_cast<std::uint64_t>(n);
+            }
+        });
+    }
+    ~StandInBroker() {
+        ::shutdown(fds_[0], SHUT_WR);
+        reader_.join();
+        ::close(fds_[0]);
+        ::close(fds_[1]);
+    }
+
+    bool Publish(const std::string& topic, const std::string& payload) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        frame_.clear();
+        frame_.push_back(static_cast<char>(0x30));
+        std::size_t remaining = 2 + topic.size() + payload.size();
+        do {
+            char byte = static_cast<char>(remaining % 128);
+            remaining /= 128;
+            if (remaining > 0) byte = static_cast<char>(byte | 0x80);
+            frame_.push_back(byte);
+        } while (remaining > 0);
+        frame_.push_back(static_cast<char>(topic.size() >> 8));
+        frame_.push_back(static_cast<char>(topic.size() & 0xff));
+        frame_ += topic;
+        frame_ += payload;
+        std::size_t off = 0;
+        while (off < frame_.size()) {
+            const auto n = ::write(fds_[0], frame_.data() + off, frame_.size() - off);
+            if (n <= 0) return false;
+            off += static_cast<std::size_t>(n);
+        }
+        ++frames_;
+        return true;
+    }
+
+    std::uint64_t Frames() const { return frames_.load(); }
+
+private:
+    int fds_[2] = {-1, -1};
+    std::thread reader_;
+    std::mutex mtx_;
+    std::string frame_;
+    std::atomic<std::uint64_t> frames_{0};
+    std::atomic<std::uint64_t> received_bytes_{0};
+};
+
+struct BenchResult {
+    double producer_sec;
+    double total_sec;
+    std::uint64_t frames;
+};
+
+template <typename PublishFn, typename DrainFn>
+BenchResult RunProducers(int producers, int per_producer, PublishFn publish, DrainFn drain) {
+    const std::string payload(200, 'p');
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < per_producer; ++i) {
+                publish("edge/e" + std::to_string(p) + "/status/" + std::to_string(i % 16), payload);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    const auto t1 = std::chrono::steady_clock::now();
+    const auto frames = drain();
+    const auto t2 = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double>(t1 - t0).count(),
+            std::chrono::duration<double>(t2 - t0).count(), frames};
+}
+
+} // namespace
+
+TEST(MqttOutboxBench, PublishThroughputAgainstStandInBroker) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+    constexpr double kTotal = kProducers * kPerProducer;
+
+    // 直接发布：发布线程各自加锁写套接字
+    BenchResult direct;
+    {
+        StandInBroker broker;
+        direct = RunProducers(kProducers, kPerProducer,
+                              [&](const std::string& t, const std::string& p) { broker.Publish(t, p); },
+                              [&] { return broker.Frames(); });
+    }
+
+    auto run_outbox = [&](const std::vector<std::string>& coalesce) {
+        StandInBroker broker;
+        auto options = Options(1 << 20, 64);
+        options.coalesce_topics = coalesce;
+        MqttOutbox outbox(options, [&](const std::vector<OutboxMessage>& batch) {
+            std::size_t n = 0;
+            for (const auto& m : batch) {
+                if (!broker.Publish(m.topic, m.payload)) break;
+                ++n;
+            }
+            return n;
+        });
+        outbox.SetConnected(true);
+        return RunProducers(kProducers, kPerProducer,
+                            [&](const std::string& t, const std::string& p) { outbox.Enqueue({t, p, 0, false}); },
+                            [&] {
+                                EXPECT_TRUE(outbox.Flush(30s));
+                                return broker.Frames();
+                            });
+    };
+    const BenchResult queued = run_outbox({});
+    const BenchResult coalesced = run_outbox({"edge/+/status/+"});
+
+    std::printf("[MqttOutboxBench] direct:    producer=%.0f msg/s end-to-end=%.0f msg/s frames=%llu\n",
+                kTotal / direct.producer_sec, kTotal / direct.total_sec,
+                static_cast<unsigned long long>(direct.frames));
+    std::printf("[MqttOutboxBench] outbox:    producer=%.0f msg/s end-to-end=%.0f msg/s frames=%llu\n",
+                kTotal / queued.producer_sec, kTotal / queued.total_sec,
+                static_cast<unsigned long long>(queued.frames));
+    std::printf("[MqttOutboxBench] coalesced: producer=%.0f msg/s end-to-end=%.0f msg/s frames=%llu\n",
+                kTotal / coalesced.producer_sec, kTotal / coalesced.total_sec,
+                static_cast<unsigned long long>(coalesced.frames));
+
+    EXPECT_EQ(direct.frames, static_cast<std::uint64_t>(kTotal));
+    EXPECT_EQ(queued.frames, static_cast<std::uint64_t>(kTotal));
+    EXPECT_LE(coalesced.frames, static_cast<std::uint64_t>(kTotal));
+    EXPECT_GE(coalesced.frames, static_cast<std::uint64_t>(kProducers * 16));
+}
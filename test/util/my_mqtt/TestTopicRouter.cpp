@@ -0,0 +1,251 @@
+/**
+ * @file TestTopicRouter.cpp
+ * @brief MQTT 主题路由树 TopicRouter 单元测试与分发基准
+ *
+ * 测试覆盖：
+ *   - 过滤器校验（'+' / '#' 位置）
+ *   - 单过滤器匹配：精确、'+'、'#'（含零层）、空层
+ *   - 路由树匹配：多条路由同时命中时按注册顺序返回，非法过滤器不参与匹配
+ *   - 随机过滤器 / 主题与逐条匹配结果一致
+ *   - 基准：1000 条路由下路由树与旧的"复制路由表 + 逐条切分匹配"的每秒分发消息数
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TopicRouter.hpp"
+
+using namespace my_mqtt;
+
+namespace {
+
+Route MakeRoute(const std::string& filter) {
+    return Route{filter, [](const std::string&, const std::string&) {}, 0};
+}
+
+std::vector<std::uint32_t> MatchAll(const TopicRouter& router, const std::string& topic) {
+    std::vector<std::uint32_t> out;
+    router.Match(topic, out);
+    return out;
+}
+
+// 旧实现：每次匹配都把过滤器和主题切分成字符串数组
+std::vector<std::string> LegacySplit(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, '/')) out.push_back(item);
+    return out;
+}
+
+bool LegacyMatch(const std::string& filter, const std::string& topic) {
+    const auto f = LegacySplit(filter);
+    const auto t = LegacySplit(topic);
+    size_t i = 0;
+    for (; i < f.size(); ++i) {
+        if (f[i] == "#") return true;
+        if (i >= t.size()) return false;
+        if (f[i] == "+") continue;
+        if (f[i] != t[i]) return false;
+    }
+    return i == t.size();
+}
+
+} // namespace
+
+// ============================================================================
+// 过滤器校验与单过滤器匹配
+// ============================================================================
+
+TEST(TopicRouterTest, ValidateFilter) {
+    EXPECT_TRUE(IsValidTopicFilter("a/b/c"));
+    EXPECT_TRUE(IsValidTopicFilter("a/+/c"));
+    EXPECT_TRUE(IsValidTopicFilter("a/#"));
+    EXPECT_TRUE(IsValidTopicFilter("#"));
+    EXPECT_TRUE(IsValidTopicFilter("+"));
+    EXPECT_TRUE(IsValidTopicFilter("/system/heartbeats/do_operation"));
+
+    EXPECT_FALSE(IsValidTopicFilter(""));
+    EXPECT_FALSE(IsValidTopicFilter("a/#/c"));
+    EXPECT_FALSE(IsValidTopicFilter("a/b#"));
+    EXPECT_FALSE(IsValidTopicFilter("a/b+/c"));
+}
+
+TEST(TopicRouterTest, SingleFilterMatch) {
+    EXPECT_TRUE(TopicFilterMatches("a/b", "a/b"));
+    EXPECT_FALSE(TopicFilterMatches("a/b", "a/b/c"));
+    EXPECT_FALSE(TopicFilterMatches("a/b/c", "a/b"));
+
+    EXPECT_TRUE(TopicFilterMatches("a/+/c", "a/x/c"));
+    EXPECT_FALSE(TopicFilterMatches("a/+", "a"));
+    EXPECT_TRUE(TopicFilterMatches("a/+", "a/"));      // '+' 匹配空层
+
+    EXPECT_TRUE(TopicFilterMatches("a/#", "a"));       // '#' 匹配零层
+    EXPECT_TRUE(TopicFilterMatches("a/#", "a/b/c"));
+    EXPECT_TRUE(TopicFilterMatches("#", "x/y"));
+    EXPECT_FALSE(TopicFilterMatches("a/#", "b/c"));
+
+    EXPECT_TRUE(TopicFilterMatches("/sys/+", "/sys/x"));
+    EXPECT_FALSE(TopicFilterMatches("sys/+", "/sys/x"));
+}
+
+// ============================================================================
+// 路由树
+// ============================================================================
+
+TEST(TopicRouterTest, MatchesInRegistrationOrder) {
+    auto router = TopicRouter::Build({
+        MakeRoute("edge/+/status"),     // 0
+        MakeRoute("#"),                 // 1
+        MakeRoute("edge/e1/status"),    // 2
+        MakeRoute("edge/#"),            // 3
+        MakeRoute("edge/e1/+"),         // 4
+        MakeRoute("other/topic"),       // 5
+    });
+
+    EXPECT_EQ(MatchAll(*router, "edge/e1/status"), (std::vector<std::uint32_t>{0, 1, 2, 3, 4}));
+    EXPECT_EQ(MatchAll(*router, "edge/e2/status"), (std::vector<std::uint32_t>{0, 1, 3}));
+    EXPECT_EQ(MatchAll(*router, "edge"), (std::vector<std::uint32_t>{1, 3}));
+    EXPECT_EQ(MatchAll(*router, "other/topic"), (std::vector<std::uint32_t>{1, 5}));
+    EXPECT_EQ(MatchAll(*router, "nothing/here/x"), (std::vector<std::uint32_t>{1}));
+}
+
+TEST(TopicRouterTest, DuplicateFiltersAndInvalidFilters) {
+    auto router = TopicRouter::Build({
+        MakeRoute("a/b"),
+        MakeRoute("a/#/b"),   // 非法，不参与匹配
+        MakeRoute("a/b"),
+    });
+    ASSERT_EQ(router->Routes().size(), 3u);
+    EXPECT_EQ(MatchAll(*router, "a/b"), (std::vector<std::uint32_t>{0, 2}));
+    EXPECT_TRUE(MatchAll(*router, "a/x/b").empty());
+}
+
+TEST(TopicRouterTest, EmptyRouter) {
+    auto router = TopicRouter::Empty();
+    EXPECT_TRUE(router->Routes().empty());
+    EXPECT_TRUE(MatchAll(*router, "a/b").empty());
+}
+
+TEST(TopicRouterTest, MatchReusesBuffer) {
+    auto router = TopicRouter::Build({MakeRoute("a/+"), MakeRoute("a/#")});
+    std::vector<std::uint32_t> out;
+    out.reserve(8);
+    const auto* data = out.data();
+    for (int i = 0; i < 100; ++i) {
+        out.clear();
+        router->Match("a/b", out);
+        ASSERT_EQ(out.size(), 2u);
+    }
+    EXPECT_EQ(out.data(), data);
+}
+
+TEST(TopicRouterTest, AgreesWithPerFilterMatch) {
+    std::mt19937 rng(42);
+    const std::vector<std::string> words = {"a", "b", "c", "", "edge"};
+    auto random_topic = [&](bool filter) {
+        std::string s;
+        const int depth = 1 + static_cast<int>(rng() % 4);
+        for (int i = 0; i < depth; ++i) {
+            if (i > 0) s += '/';
+            const auto r = rng() % 10;
+            if (filter && r == 0) {
+                s += '+';
+            } else if (filter && r == 1 && i == depth - 1) {
+                s += '#';
+            } else {
+                s += words[rng() % words.size()];
+            }
+        }
+        return s;
+    };
+
+    std::vector<Route> routes;
+    for (int i = 0; i < 200; ++i) {
+        routes.push_back(MakeRoute(random_topic(true)));
+    }
+    auto router = TopicRouter::Build(routes);
+
+    for (int n = 0; n < 2000; ++n) {
+        const std::string topic = random_topic(false);
+        std::vector<std::uint32_t> expected;
+        for (std::size_t i = 0; i < routes.size(); ++i) {
+            if (IsValidTopicFilter(routes[i].filter) && TopicFilterMatches(routes[i].filter, topic)) {
+                expected.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        ASSERT_EQ(MatchAll(*router, topic), expected) << "topic=" << topic;
+    }
+}
+
+// ============================================================================
+// 基准：1000 条路由
+// ============================================================================
+
+TEST(TopicRouterBench, ThousandRoutes) {
+    // 模拟 200 个边缘体 × 5 类主题，其中少量通配订阅
+    std::vector<Route> routes;
+    for (int e = 0; e < 200; ++e) {
+        const std::string base = "edge/e" + std::to_string(e);
+        routes.push_back(MakeRoute(base + "/status"));
+        routes.push_back(MakeRoute(base + "/task/+"));
+        routes.push_back(MakeRoute(base + "/device/+/data"));
+        routes.push_back(MakeRoute(base + "/event/#"));
+        routes.push_back(MakeRoute(base + "/cmd/ack"));
+    }
+    ASSERT_EQ(routes.size(), 1000u);
+
+    std::vector<std::string> topics;
+    for (int i = 0; i < 1000; ++i) {
+        const std::string base = "edge/e" + std::to_string(i % 200);
+        switch (i % 4) {
+            case 0: topics.push_back(base + "/status"); break;
+            case 1: topics.push_back(base + "/task/" + std::to_string(i)); break;
+            case 2: topics.push_back(base + "/device/d1/data"); break;
+            default: topics.push_back(base + "/event/alarm/high"); break;
+        }
+    }
+
+    auto router = TopicRouter::Build(routes);
+
+    constexpr int kTrieMessages = 100000;
+    std::uint64_t trie_hits = 0;
+    std::vector<std::uint32_t> matched;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTrieMessages; ++i) {
+        matched.clear();
+        router->Match(topics[static_cast<std::size_t>(i) % topics.size()], matched);
+        trie_hits += matched.size();
+    }
+    const double trie_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // 旧实现每条消息复制路由表并对每条路由切分匹配，消息数取少一些
+    constexpr int kLegacyMessages = 500;
+    std::uint64_t legacy_hits = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLegacyMessages; ++i) {
+        const std::vector<Route> copy = routes;
+        const auto& topic = topics[static_cast<std::size_t>(i) % topics.size()];
+        for (const auto& r : copy) {
+            if (LegacyMatch(r.filter, topic)) ++legacy_hits;
+        }
+    }
+    const double legacy_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    const double trie_rate = kTrieMessages / trie_sec;
+    const double legacy_rate = kLegacyMessages / legacy_sec;
+    std::printf("[MqttRouteBench] routes=%zu nodes=%zu trie=%.0f msg/s legacy=%.0f msg/s (x%.0f)\n",
+                routes.size(), router->NodeCount(), trie_rate, legacy_rate, trie_rate / legacy_rate);
+
+    // 每条消息恰好命中一条路由
+    EXPECT_EQ(trie_hits, static_cast<std::uint64_t>(kTrieMessages));
+    EXPECT_EQ(legacy_hits, static_cast<std::uint64_t>(kLegacyMessages));
+    EXPECT_GT(trie_rate, legacy_rate);
+}
@@ -0,0 +1,411 @@
+/**
+ * @file TestProcFsSampler.cpp
+ * @brief /proc 采样器 ProcFsSampler 与零分配解析 ProcFsParser 单元测试与基准
+ *
+ * 测试覆盖：
+ *   - stat / status / io / /proc/stat / loadavg 文本解析（含 comm 中的空格与括号）
+ *   - 采样本进程：进程字段、pid_tid_ticks、topN 线程、host 总 jiffies
+ *   - 第二轮采样复用 fd，不再逐线程 open
+ *   - 新线程 / 子进程出现与退出后被及时发现、回收
+ *   - target_name 解析、fd 预算为 0 时退化为 open/close
+ *   - 与旧 ProcessInfoCollector 的结果一致
+ *   - 基准：每个被采样线程的耗时（us），对比旧的 ifstream 采集路径
+ */
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ProcFsParser.h"
+#include "ProcFsSampler.h"
+#include "ProcessInfoCollector.h"
+#include "ThreadInfoCollector.h"
+
+using namespace MySoftHealthy;
+
+namespace {
+
+/// 启动 n 个阻塞等待的线程，析构时唤醒并回收
+class ParkedThreads {
+public:
+    explicit ParkedThreads(int n, const char* name = "parked") {
+        for (int i = 0; i < n; ++i) {
+            threads_.emplace_back([this]() {
+                std::unique_lock<std::mutex> lk(mtx_);
+                cv_.wait(lk, [this]() { return stop_; });
+            });
+            pthread_setname_np(threads_.back().native_handle(), name);
+        }
+    }
+
+    ~ParkedThreads() {
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+private:
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::vector<std::thread> threads_;
+};
+
+SoftHealthMonitorConfig SelfConfig() {
+    SoftHealthMonitorConfig cfg;
+    cfg.target_pid = static_cast<int>(getpid());
+    cfg.threads_topn = 5;
+    return cfg;
+}
+
+uint32_t CountSelfTasks() {
+    return static_cast<uint32_t>(ThreadInfoCollector().list_tids(getpid()).size());
+}
+
+std::string SelfComm() {
+    std::ifstream ifs("/proc/self/comm");
+    std::string comm;
+    std::getline(ifs, comm);
+    return comm;
+}
+
+} // namespace
+
+// ============================================================================
+// 解析
+// ============================================================================
+
+TEST(ProcFsParserTest, ParsesStatWithTrickyComm) {
+    const std::string line =
+        "1234 (a) (b c)) S 1 1234 1234 0 -1 4194560 100 0 0 0 "
+        "17 23 0 0 20 -5 7 0 98765 1000000 200 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 3 0 0 0 0 0\n";
+    ProcStatFields f;
+    ASSERT_TRUE(parse_proc_stat(line, f));
+    EXPECT_EQ(f.pid, 1234);
+    EXPECT_EQ(f.comm, "a) (b c)");
+    EXPECT_EQ(f.state, 'S');
+    EXPECT_EQ(f.ppid, 1);
+    EXPECT_EQ(f.utime, 17u);
+    EXPECT_EQ(f.stime, 23u);
+    EXPECT_EQ(f.priority, 20);
+    EXPECT_EQ(f.nice, -5);
+    EXPECT_EQ(f.num_threads, 7u);
+    EXPECT_EQ(f.start_time, 98765u);
+    EXPECT_EQ(f.processor, 3);
+
+    ProcStatFields bad;
+    EXPECT_FALSE(parse_proc_stat("1234 (x) S 1 2 3", bad));
+    EXPECT_FALSE(parse_proc_stat("garbage", bad));
+}
+
+TEST(ProcFsParserTest, ParsesStatusIoCpuAndLoadavg) {
+    const std::string status =
+        "Name:\tfoo\nState:\tS (sleeping)\nVmSize:\t  123456 kB\nVmRSS:\t    7890 kB\n"
+        "Threads:\t3\nvoluntary_ctxt_switches:\t42\nnonvoluntary_ctxt_switches:\t7\n";
+    ProcStatusFields s;
+    parse_proc_status(status, s);
+    EXPECT_TRUE(s.has_vm_size);
+    EXPECT_TRUE(s.has_vm_rss);
+    EXPECT_TRUE(s.has_ctx);
+    EXPECT_EQ(s.vm_size_kb, 123456u);
+    EXPECT_EQ(s.vm_rss_kb, 7890u);
+    EXPECT_EQ(s.voluntary_ctxt_switches, 42u);
+    EXPECT_EQ(s.nonvoluntary_ctxt_switches, 7u);
+
+    // 内核线程没有 VmRSS
+    ProcStatusFields k;
+    parse_proc_status("Name:\tkthreadd\nState:\tS\n", k);
+    EXPECT_FALSE(k.has_vm_rss);
+    EXPECT_FALSE(k.has_ctx);
+
+    ProcIoFields io;
+    ASSERT_TRUE(parse_proc_io("rchar: 1\nwchar: 2\nsyscr: 3\nsyscw: 4\nread_bytes: 5\nwrite_bytes: 6\n"
+                              "cancelled_write_bytes: 0\n", io));
+    EXPECT_EQ(io.rchar, 1u);
+    EXPECT_EQ(io.wchar, 2u);
+    EXPECT_EQ(io.read_bytes, 5u);
+    EXPECT_EQ(io.write_bytes, 6u);
+    EXPECT_FALSE(parse_proc_io("rchar: 1\n", io));
+
+    uint64_t total = 0;
+    ASSERT_TRUE(parse_host_cpu_total("cpu  10 20 30 40 5 0 1 0 0 0\ncpu0 1 2 3 4 0 0 0 0 0 0\n", total));
+    EXPECT_EQ(total, 106u);
+    EXPECT_FALSE(parse_host_cpu_total("cpu0 1 2 3\n", total));
+
+    int last_pid = 0;
+    ASSERT_TRUE(parse_loadavg_last_pid("0.52 0.58 0.59 2/1123 45678\n", last_pid));
+    EXPECT_EQ(last_pid, 45678);
+
+    EXPECT_EQ(parse_pid_name("4321"), 4321);
+    EXPECT_EQ(parse_pid_name("self"), -1);
+    EXPECT_EQ(parse_pid_name("12a"), -1);
+    EXPECT_EQ(parse_pid_name(""), -1);
+}
+
+// ============================================================================
+// 采样
+// ============================================================================
+
+TEST(ProcFsSamplerTest, SamplesSelfProcessAndThreads) {
+    ParkedThreads parked(8);
+    ProcFsSampler sampler;
+    auto cfg = SelfConfig();
+    const int self = static_cast<int>(getpid());
+
+    SoftHealthSnapshot snap;
+    sampler.sample(snap, cfg, nullptr);
+
+    EXPECT_GT(snap.host.total_cpu_jiffies, 0u);
+    ASSERT_EQ(snap.roots, std::vector<int>{self});
+    ASSERT_EQ(snap.processes.count(self), 1u);
+    const auto& ps = snap.processes.at(self);
+    EXPECT_EQ(ps.pid, self);
+    EXPECT_EQ(ps.ppid, static_cast<int>(getppid()));
+    EXPECT_EQ(ps.name, SelfComm());
+    EXPECT_FALSE(ps.cmdline.empty());
+    EXPECT_GT(ps.vm_rss_bytes, 0u);
+    EXPECT_GT(ps.start_time_ticks, 0u);
+    EXPECT_TRUE(ps.voluntary_ctxt_switches.has_value());
+    EXPECT_EQ(ps.threads_count, CountSelfTasks());
+    EXPECT_GE(ps.threads_count, 9u);
+
+    const auto& ticks = snap.pid_tid_ticks.at(self);
+    EXPECT_EQ(ticks.size(), ps.threads_count);
+    EXPECT_EQ(ticks.count(self), 1u);
+    ASSERT_EQ(ps.top_threads.size(), 5u);
+    for (const auto& t : ps.top_threads) {
+        EXPECT_EQ(ticks.count(t.tid), 1u);
+        EXPECT_FALSE(t.name.empty());
+        EXPECT_NE(t.policy, "UNKNOWN");
+        EXPECT_EQ(t.utime_ticks + t.stime_ticks, ticks.at(t.tid));
+    }
+
+    // 第二轮有 prev 与 host delta，topN 按 delta 排序
+    SoftHealthSnapshot snap2;
+    sampler.sample(snap2, cfg, &snap);
+    EXPECT_GE(snap2.host.total_cpu_jiffies, snap.host.total_cpu_jiffies);
+    ASSERT_EQ(snap2.processes.at(self).top_threads.size(), 5u);
+}
+
+TEST(ProcFsSamplerTest, SecondCycleReusesDescriptors) {
+    ParkedThreads parked(32);
+    ProcFsSampler sampler;
+    auto cfg = SelfConfig();
+    cfg.threads_topn = -1;
+
+    SoftHealthSnapshot s1;
+    sampler.sample(s1, cfg, nullptr);
+    auto st1 = sampler.stats();
+    EXPECT_GE(st1.sampled_threads, 33u);
+    // /proc、/proc/<pid>、task 目录 + stat/status/loadavg 等文件 + 每线程 stat/status
+    EXPECT_GE(st1.cached_fds, 2 * st1.sampled_threads);
+
+    SoftHealthSnapshot s2;
+    sampler.sample(s2, cfg, &s1);
+    auto st2 = sampler.stats();
+    EXPECT_EQ(st2.cached_fds, st1.cached_fds);
+    EXPECT_EQ(st2.task_rescans, st1.task_rescans);
+    // 系统其他进程创建任务时会触发增量扫描（只读新 pid），但不会再逐线程 open
+    EXPECT_LT(st2.opens - st1.opens, st1.sampled_threads / 2);
+    EXPECT_GE(st2.reads - st1.reads, 2u * st2.sampled_threads);
+}
+
+TEST(ProcFsSamplerTest, TracksThreadStartAndExit) {
+    ProcFsSampler sampler;
+    auto cfg = SelfConfig();
+    const int self = static_cast<int>(getpid());
+
+    SoftHealthSnapshot base;
+    sampler.sample(base, cfg, nullptr);
+    const size_t before = base.pid_tid_ticks.at(self).size();
+
+    {
+        ParkedThreads parked(3, "extra");
+        SoftHealthSnapshot with;
+        sampler.sample(with, cfg, &base);
+        EXPECT_EQ(with.pid_tid_ticks.at(self).size(), before + 3);
+        EXPECT_EQ(with.processes.at(self).threads_count, before + 3);
+    }
+
+    SoftHealthSnapshot after;
+    sampler.sample(after, cfg, &base);
+    EXPECT_EQ(after.pid_tid_ticks.at(self).size(), before);
+    EXPECT_EQ(sampler.stats().sampled_threads, before);
+}
+
+TEST(ProcFsSamplerTest, DetectsChildProcessAndReclaimsOnExit) {
+    ProcFsSampler sampler;
+    auto cfg = SelfConfig();
+    const int self = static_cast<int>(getpid());
+
+    SoftHealthSnapshot s0;
+    sampler.sample(s0, cfg, nullptr);
+    const uint32_t fds_before = sampler.stats().cached_fds;
+
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+
+    SoftHealthSnapshot s1;
+    sampler.sample(s1, cfg, &s0);
+    ASSERT_EQ(s1.processes.count(child), 1u);
+    EXPECT_EQ(s1.processes.at(child).ppid, self);
+    EXPECT_EQ(s1.processes.at(self).children, std::vector<int>{child});
+    EXPECT_GT(sampler.stats().cached_fds, fds_before);
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+
+    SoftHealthSnapshot s2;
+    sampler.sample(s2, cfg, &s1);
+    EXPECT_EQ(s2.processes.count(child), 0u);
+    EXPECT_TRUE(s2.processes.at(self).children.empty());
+    EXPECT_EQ(sampler.stats().cached_fds, fds_before);
+}
+
+TEST(ProcFsSamplerTest, ResolvesTargetByName) {
+    ProcFsSampler sampler;
+    SoftHealthMonitorConfig cfg;
+    cfg.target_name = SelfComm();
+
+    SoftHealthSnapshot snap;
+    sampler.sample(snap, cfg, nullptr);
+    const int self = static_cast<int>(getpid());
+    EXPECT_NE(std::find(snap.roots.begin(), snap.roots.end(), self), snap.roots.end());
+    EXPECT_EQ(snap.processes.count(self), 1u);
+
+    // 切换到不存在的名字后 root 清空，已缓存的进程条目被回收
+    cfg.target_name = "no-such-process-xyz";
+    SoftHealthSnapshot none;
+    sampler.sample(none, cfg, &snap);
+    EXPECT_TRUE(none.roots.empty());
+    EXPECT_TRUE(none.processes.empty());
+}
+
+TEST(ProcFsSamplerTest, ZeroFdBudgetFallsBackToOpenClose) {
+    ParkedThreads parked(4);
+    ProcFsSampler sampler;
+    auto cfg = SelfConfig();
+    cfg.max_cached_fds = 0;
+
+    SoftHealthSnapshot s1, s2;
+    sampler.sample(s1, cfg, nullptr);
+    sampler.sample(s2, cfg, &s1);
+    const int self = static_cast<int>(getpid());
+    EXPECT_EQ(s2.pid_tid_ticks.at(self).size(), s2.processes.at(self).threads_count);
+    // 只保留 /proc、/proc/<pid>、/proc/<pid>/task 三个目录 fd
+    EXPECT_EQ(sampler.stats().cached_fds, 3u);
+
+    sampler.reset();
+    EXPECT_EQ(sampler.stats().cached_fds, 0u);
+}
+
+TEST(ProcFsSamplerTest, MatchesLegacyCollector) {
+    ProcFsSampler sampler;
+    auto cfg = SelfConfig();
+    const int self = static_cast<int>(getpid());
+
+    SoftHealthSnapshot legacy;
+    ProcessInfoCollector().collect_processes_basic(legacy, cfg);
+    SoftHealthSnapshot fresh;
+    sampler.sample(fresh, cfg, nullptr);
+
+    const auto& a = legacy.processes.at(self);
+    const auto& b = fresh.processes.at(self);
+    EXPECT_EQ(a.name, b.name);
+    EXPECT_EQ(a.ppid, b.ppid);
+    EXPECT_EQ(a.start_time_ticks, b.start_time_ticks);
+    EXPECT_EQ(a.cmdline, b.cmdline);
+    EXPECT_EQ(a.threads_count, b.threads_count);
+    EXPECT_EQ(a.vm_size_bytes, b.vm_size_bytes);
+}
+
+// ============================================================================
+// 基准
+// ============================================================================
+
+TEST(ProcFsSamplerBench, MicrosecondsPerSampledThread) {
+    constexpr int kThreads = 64;
+    constexpr int kCycles = 50;
+    ParkedThreads parked(kThreads);
+    auto cfg = SelfConfig();
+    cfg.threads_topn = 20;
+    const int self = static_cast<int>(getpid());
+    const size_t nthreads = CountSelfTasks();
+
+    using clock = std::chrono::steady_clock;
+
+    // 旧路径：与改造前 SoftHealthMonitorManager::refresh_now 相同的调用序列
+    auto legacy_cycle = [&](SoftHealthSnapshot& snap, const SoftHealthSnapshot* prev) {
+        ProcessInfoCollector pcol;
+        pcol.collect_processes_basic(snap, cfg);
+        for (auto& kv : snap.processes) {
+            ThreadInfoCollector tcol;
+            for (int tid : tcol.list_tids(kv.first)) {
+                uint64_t ut = 0, st = 0;
+                char state = '?';
+                int prio = 0, nice = 0, processor = -1;
+                std::string comm;
+                if (tcol.read_task_stat(kv.first, tid, ut, st, state, prio, nice, processor, comm)) {
+                    snap.pid_tid_ticks[kv.first][tid] = ut + st;
+                }
+            }
+            const std::unordered_map<int, uint64_t>* prev_map = nullptr;
+            if (prev && prev->pid_tid_ticks.count(kv.first)) prev_map = &prev->pid_tid_ticks.at(kv.first);
+            kv.second.top_threads = tcol.collect_topn_threads(kv.first, prev_map, cfg, 0, 0, 1);
+        }
+    };
+
+    SoftHealthSnapshot prev_legacy;
+    legacy_cycle(prev_legacy, nullptr);
+    auto t0 = clock::now();
+    for (int i = 0; i < kCycles; ++i) {
+        SoftHealthSnapshot snap;
+        legacy_cycle(snap, &prev_legacy);
+        prev_legacy = std::move(snap);
+    }
+    double legacy_us = std::chrono::duration<double, std::micro>(clock::now() - t0).count();
+
+    ProcFsSampler sampler;
+    SoftHealthSnapshot prev_fresh;
+    sampler.sample(prev_fresh, cfg, nullptr);
+    t0 = clock::now();
+    for (int i = 0; i < kCycles; ++i) {
+        SoftHealthSnapshot snap;
+        sampler.sample(snap, cfg, &prev_fresh);
+        prev_fresh = std::move(snap);
+    }
+    double fresh_us = std::chrono::duration<double, std::micro>(clock::now() - t0).count();
+
+    ASSERT_EQ(prev_fresh.pid_tid_ticks.at(self).size(), nthreads);
+    ASSERT_EQ(prev_legacy.pid_tid_ticks.at(self).size(), nthreads);
+    const double per = static_cast<double>(kCycles) * static_cast<double>(nthreads);
+    std::printf("[bench] threads=%zu cycles=%d legacy=%.2f us/thread, ProcFsSampler=%.2f us/thread, speedup=%.1fx\n",
+                nthreads, kCycles, legacy_us / per, fresh_us / per, legacy_us / fresh_us);
+    auto st = sampler.stats();
+    std::printf("[bench] sampler: cycles=%llu pid_rescans=%llu task_rescans=%llu opens=%llu reads=%llu cached_fds=%u\n",
+                (unsigned long long)st.cycles, (unsigned long long)st.pid_rescans,
+                (unsigned long long)st.task_rescans, (unsigned long long)st.opens,
+                (unsigned long long)st.reads, st.cached_fds);
+    EXPECT_LT(fresh_us, legacy_us);
+}
@@ -0,0 +1,240 @@
+/**
+ * @file TestMetricsRingStore.cpp
+ * @brief 时序环形存储 MetricsRingStore 单元测试与写入基准
+ *
+ * 测试覆盖：
+ *   - 三档分辨率（1s / 10s / 1m）同时累加 min / max / avg / count
+ *   - 环回绕后旧桶被覆盖、过旧的点被丢弃并计数
+ *   - 序列容量由内存预算决定；满时淘汰空闲序列，否则拒绝新序列
+ *   - Query 按范围自动选择分辨率、前缀匹配、max_points / max_series 截断
+ *   - MetricsStoreOptions 解析
+ *   - 基准：RecordBatch 每个点的耗时
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "MetricsRingStore.h"
+
+using namespace MySystemHealthy;
+
+namespace {
+
+MetricsStoreOptions SmallOptions() {
+  MetricsStoreOptions o;
+  o.slots_1s = 60;
+  o.slots_10s = 30;
+  o.slots_1m = 20;
+  o.memory_budget_bytes = 1024 * 1024;
+  o.idle_evict_seconds = 30;
+  return o;
+}
+
+// 单条序列的字节数（与 MetricsRingStore::BytesPerSeries 一致）
+size_t BytesPerSeries(const MetricsStoreOptions& o) {
+  return static_cast<size_t>(o.slots_1s + o.slots_10s + o.slots_1m) * 28;
+}
+
+} // namespace
+
+TEST(MetricsRingStoreTest, RollsUpIntoAllTiers) {
+  MetricsRingStore store(SmallOptions());
+  const int64_t base = 1700000040;  // 60 的整数倍
+  for (int i = 0; i < 60; ++i) store.Record("host.cpu.usage_pct", base + i, i);
+
+  auto raw = store.Range("host.cpu.usage_pct", base, base + 59, 1);
+  ASSERT_EQ(raw.size(), 60u);
+  EXPECT_EQ(raw.front().ts, base);
+  EXPECT_EQ(raw.back().ts, base + 59);
+  EXPECT_EQ(raw[5].count, 1u);
+  EXPECT_DOUBLE_EQ(raw[5].avg, 5.0);
+
+  auto tens = store.Range("host.cpu.usage_pct", base, base + 59, 10);
+  ASSERT_EQ(tens.size(), 6u);
+  EXPECT_EQ(tens[1].ts, base + 10);
+  EXPECT_EQ(tens[1].count, 10u);
+  EXPECT_FLOAT_EQ(tens[1].min, 10.0f);
+  EXPECT_FLOAT_EQ(tens[1].max, 19.0f);
+  EXPECT_DOUBLE_EQ(tens[1].avg, 14.5);
+
+  auto minutes = store.Range("host.cpu.usage_pct", base, base + 59, 60);
+  ASSERT_EQ(minutes.size(), 1u);
+  EXPECT_EQ(minutes[0].count, 60u);
+  EXPECT_DOUBLE_EQ(minutes[0].avg, 29.5);
+
+  EXPECT_TRUE(store.Range("host.cpu.usage_pct", base, base + 59, 5).empty());
+  EXPECT_TRUE(store.Range("missing", base, base + 59, 1).empty());
+}
+
+TEST(MetricsRingStoreTest, RingWrapsAndDropsTooOldPoints) {
+  MetricsRingStore store(SmallOptions());
+  const int64_t base = 1700000000;
+  for (int i = 0; i < 150; ++i) store.Record("m", base + i, 1.0);
+
+  // 1s 档只保留最近 60 个桶
+  auto raw = store.Range("m", base, base + 149, 1);
+  ASSERT_EQ(raw.size(), 60u);
+  EXPECT_EQ(raw.front().ts, base + 90);
+
+  // 10s 档仍覆盖全部范围
+  auto tens = store.Range("m", base, base + 149, 10);
+  EXPECT_EQ(tens.size(), 15u);
+
+  // 比所有档都旧的点被丢弃
+  auto before = store.GetStatsJson();
+  store.Record("m", base - 100000, 5.0);
+  auto after = store.GetStatsJson();
+  EXPECT_EQ(after["points_too_old"].get<uint64_t>(), before["points_too_old"].get<uint64_t>() + 1);
+  EXPECT_EQ(after["points_written"].get<uint64_t>(), before["points_written"].get<uint64_t>());
+
+  // 1s 档已回绕的点仍可写入更粗的档
+  store.Record("m", base + 5, 100.0);
+  tens = store.Range("m", base, base + 9, 10);
+  ASSERT_EQ(tens.size(), 1u);
+  EXPECT_EQ(tens[0].count, 11u);
+  EXPECT_FLOAT_EQ(tens[0].max, 100.0f);
+}
+
+TEST(MetricsRingStoreTest, CapacityFollowsBudgetAndEvictsIdleSeries) {
+  auto o = SmallOptions();
+  o.memory_budget_bytes = static_cast<int64_t>(BytesPerSeries(o) * 3);
+  o.memory_budget_bytes = std::max<int64_t>(o.memory_budget_bytes, 64 * 1024);
+  MetricsRingStore store(o);
+  const size_t cap = store.SeriesCapacity();
+  EXPECT_EQ(cap, static_cast<size_t>(o.memory_budget_bytes) / BytesPerSeries(o));
+
+  const int64_t base = 1700000000;
+  for (size_t i = 0; i < cap; ++i) store.Record("thread." + std::to_string(i), base, 1.0);
+  EXPECT_EQ(store.SeriesCount(), cap);
+
+  // 全部序列都在活跃期内：新序列被拒绝
+  store.Record("thread.new", base + 10, 1.0);
+  EXPECT_EQ(store.SeriesCount(), cap);
+  EXPECT_TRUE(store.ListSeries("thread.new").empty());
+  EXPECT_EQ(store.GetStatsJson()["series_rejected"].get<uint64_t>(), 1u);
+
+  // 除 thread.0 外都继续写入，thread.0 空闲超过 idle_evict_seconds 后被淘汰
+  const int64_t later = base + o.idle_evict_seconds + 5;
+  for (size_t i = 1; i < cap; ++i) store.Record("thread." + std::to_string(i), later, 2.0);
+  store.Record("thread.new", later, 3.0);
+  EXPECT_EQ(store.SeriesCount(), cap);
+  EXPECT_TRUE(store.ListSeries("thread.0").empty());
+  ASSERT_EQ(store.ListSeries("thread.new").size(), 1u);
+  EXPECT_EQ(store.GetStatsJson()["series_evicted"].get<uint64_t>(), 1u);
+
+  // 复用的槽位不残留旧数据
+  auto pts = store.Range("thread.new", base, later, 1);
+  ASSERT_EQ(pts.size(), 1u);
+  EXPECT_DOUBLE_EQ(pts[0].avg, 3.0);
+}
+
+TEST(MetricsRingStoreTest, QueryAutoStepPrefixAndTruncation) {
+  MetricsRingStore store(SmallOptions());
+  const int64_t base = 1700000000;
+  for (int i = 0; i < 600; ++i) {
+    store.RecordBatch(base + i, {
+      {"host.cpu.core.0.usage_pct", 10.0},
+      {"host.cpu.core.1.usage_pct", 20.0},
+      {"proc.42.rss_bytes", 1024.0 * i, "worker"},
+    });
+  }
+  const int64_t newest = base + 599;
+
+  // 最近 60 秒：1s 档可覆盖
+  nlohmann::json out;
+  MetricsQuery q;
+  q.pattern = "host.cpu.*";
+  q.from = newest - 59;
+  ASSERT_TRUE(store.Query(q, out));
+  EXPECT_EQ(out["step_seconds"].get<int>(), 1);
+  EXPECT_EQ(out["to"].get<int64_t>(), newest);
+  ASSERT_EQ(out["series"].size(), 2u);
+  EXPECT_EQ(out["series"][0]["name"], "host.cpu.core.0.usage_pct");
+  EXPECT_EQ(out["series"][0]["points"].size(), 60u);
+  EXPECT_FALSE(out["truncated"].get<bool>());
+
+  // 最近 5 分钟超出 1s 档保留时长：退到 10s 档
+  q.from = newest - 299;
+  ASSERT_TRUE(store.Query(q, out));
+  EXPECT_EQ(out["step_seconds"].get<int>(), 10);
+  EXPECT_EQ(out["series"][0]["points"].size(), 30u);
+
+  // max_points 限制下选择更粗的一档
+  q.max_points = 20;
+  ASSERT_TRUE(store.Query(q, out));
+  EXPECT_EQ(out["step_seconds"].get<int>(), 60);
+  EXPECT_LE(out["series"][0]["points"].size(), 20u);
+
+  // 显式指定 step 且超过 max_points 时截断为最近的点
+  q.step_seconds = 1;
+  q.from = newest - 59;
+  q.max_points = 10;
+  ASSERT_TRUE(store.Query(q, out));
+  EXPECT_TRUE(out["truncated"].get<bool>());
+  ASSERT_EQ(out["series"][0]["points"].size(), 10u);
+  EXPECT_EQ(out["series"][0]["points"][9][0].get<int64_t>(), newest);
+
+  // max_series 截断与 label
+  MetricsQuery all;
+  all.pattern = "*";
+  all.max_series = 1;
+  ASSERT_TRUE(store.Query(all, out));
+  EXPECT_EQ(out["series"].size(), 1u);
+  EXPECT_TRUE(out["truncated"].get<bool>());
+  auto proc = store.ListSeries("proc.42.rss_bytes");
+  ASSERT_EQ(proc.size(), 1u);
+  EXPECT_EQ(proc[0]["label"], "worker");
+  EXPECT_DOUBLE_EQ(proc[0]["last_value"].get<double>(), 1024.0 * 599);
+
+  // 非法参数
+  std::string err;
+  MetricsQuery bad;
+  bad.pattern = "host.*";
+  bad.step_seconds = 5;
+  EXPECT_FALSE(store.Query(bad, out, &err));
+  EXPECT_FALSE(err.empty());
+  bad.step_seconds = 0;
+  bad.from = newest;
+  bad.to = newest - 10;
+  EXPECT_FALSE(store.Query(bad, out, &err));
+  bad.pattern.clear();
+  EXPECT_FALSE(store.Query(bad, out, &err));
+}
+
+TEST(MetricsRingStoreTest, OptionsFromJson) {
+  MetricsStoreOptions o;
+  std::string err;
+  ASSERT_TRUE(MetricsStoreOptions::FromJson({{"slots_1s", 120}, {"idle_evict_seconds", 60}}, o, &err));
+  EXPECT_EQ(o.slots_1s, 120);
+  EXPECT_EQ(o.slots_10s, 360);
+  EXPECT_EQ(o.idle_evict_seconds, 60);
+  EXPECT_EQ(o.ToJson()["slots_1s"].get<int>(), 120);
+
+  MetricsStoreOptions untouched;
+  EXPECT_FALSE(MetricsStoreOptions::FromJson({{"slots_1s", 120}, {"slots_1m", 0}}, untouched, &err));
+  EXPECT_EQ(untouched.slots_1s, 600);
+  EXPECT_FALSE(MetricsStoreOptions::FromJson({{"memory_budget_bytes", "16M"}}, untouched, &err));
+  EXPECT_FALSE(MetricsStoreOptions::FromJson(nlohmann::json::array(), untouched, &err));
+}
+
+TEST(MetricsRingStoreTest, BenchmarkRecordBatch) {
+  MetricsRingStore store;  // 默认配置
+  std::vector<MetricsRingStore::Sample> samples;
+  for (int i = 0; i < 200; ++i) samples.push_back({"thread." + std::to_string(i) + ".cpu_pct_core", 1.0 * i});
+
+  const int64_t base = 1700000000;
+  const int rounds = 3600;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) store.RecordBatch(base + r, samples);
+  auto us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+  const double points = static_cast<double>(rounds) * samples.size();
+  std::printf("[bench] MetricsRingStore: %zu 条序列, %.0f 个点, %.3f us/点, 序列容量 %zu\n",
+              samples.size(), points, us / points, store.SeriesCapacity());
+  EXPECT_EQ(store.SeriesCount(), samples.size());
+  EXPECT_EQ(store.GetStatsJson()["points_written"].get<uint64_t>(), static_cast<uint64_t>(points));
+}
@@ -0,0 +1,235 @@
+/**
+ * @file TestIcmpScanner.cpp
+ * @brief 单 socket + epoll 的 ICMP 批量探测器 IcmpScanner 单元测试与基准
+ *
+ * 测试覆盖：
+ *   - RFC 1071 校验和
+ *   - 回环网段（127.0.0.0/8 内地址均会应答）全部探测成功，非法地址被忽略
+ *   - 无应答目标按 retries 重发后超时结束
+ *   - rate_pps 限速、进度回调
+ *   - MyIPTools::ScanTargetSubnet 走新扫描器并更新 GetScanProgress
+ *   - 基准：/20 网段扫描耗时，对比旧的"每 IP 一个线程 + PingHost"模型
+ *
+ * 依赖 ICMP socket 权限的用例在无权限环境下跳过。
+ */
+
+#include "gtest/gtest.h"
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "IcmpScanner.h"
+#include "MyIPTools.h"
+
+namespace {
+
+bool HasIcmpSocket() {
+    int fd = ::socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+    if (fd < 0) fd = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_ICMP);
+    if (fd < 0) return false;
+    ::close(fd);
+    return true;
+}
+
+#define REQUIRE_ICMP()                                                    \
+    if (!HasIcmpSocket()) {                                               \
+        GTEST_SKIP() << "跳过：无法创建 ICMP socket（无 CAP_NET_RAW 权限）"; \
+    }
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// ============================================================
+//  测试：校验和
+// ============================================================
+
+TEST(IcmpScannerTest, Checksum_填入后整体校验为零) {
+    my_tools::ICMPHeader h{};
+    h.type = 8;
+    h.id = htons(0x1234);
+    h.sequence = htons(7);
+    h.checksum = my_tools::IcmpScanner::Checksum(&h, sizeof(h));
+    EXPECT_EQ(my_tools::IcmpScanner::Checksum(&h, sizeof(h)), 0);
+
+    // 奇数长度
+    const uint8_t odd[3] = {0x01, 0x02, 0x03};
+    EXPECT_NE(my_tools::IcmpScanner::Checksum(odd, 3), 0);
+}
+
+// ============================================================
+//  测试：参数校验
+// ============================================================
+
+TEST(IcmpScannerTest, Scan_非法参数返回错误) {
+    my_tools::IcmpScanOptions options;
+    options.rate_pps = 0;
+    auto report = my_tools::IcmpScanner::Scan({"127.0.0.1"}, options);
+    EXPECT_FALSE(report.error.empty());
+    EXPECT_TRUE(report.alive.empty());
+}
+
+// ============================================================
+//  测试：回环网段探测
+// ============================================================
+
+TEST(IcmpScannerTest, Scan_回环网段全部应答) {
+    REQUIRE_ICMP();
+    auto targets = my_tools::MyIPTools::GenerateSubnetIPs("127.0.0.1", 24);
+    targets.push_back("not_an_ip");
+
+    std::atomic<int> callbacks{0};
+    my_tools::IcmpScanOptions options;
+    options.timeout_ms = 500;
+    auto report = my_tools::IcmpScanner::Scan(targets, options, [&](const my_tools::IcmpScanProgress&) {
+        ++callbacks;
+    });
+
+    ASSERT_TRUE(report.error.empty()) << report.error;
+    EXPECT_EQ(report.alive.size(), 254u);
+    EXPECT_EQ(report.alive.front().ip, "127.0.0.1");
+    EXPECT_EQ(report.alive.back().ip, "127.0.0.254");
+    EXPECT_GE(report.alive.front().rtt_ms, 0.0);
+    EXPECT_EQ(report.progress.total, 255);
+    EXPECT_EQ(report.progress.probed, 254);
+    EXPECT_EQ(report.progress.replied, 254);
+    EXPECT_EQ(report.progress.packets_sent, 254u);  // 全部应答，不会重发
+    EXPECT_GE(callbacks.load(), 1);
+    // 全部应答后结束；上限留足余量，只防止退化为逐个等待超时
+    EXPECT_LT(report.progress.elapsed_ms, 4.0 * options.timeout_ms);
+}
+
+TEST(IcmpScannerTest, Scan_无应答目标重发后超时) {
+    REQUIRE_ICMP();
+    // 198.51.100.0/24 为 TEST-NET-2 文档地址，不会有应答（无路由时发送失败也视为已探测）
+    my_tools::IcmpScanOptions options;
+    options.timeout_ms = 150;
+    options.retries = 1;
+    auto start = std::chrono::steady_clock::now();
+    auto report = my_tools::IcmpScanner::Scan({"198.51.100.7", "127.0.0.1"}, options);
+
+    ASSERT_TRUE(report.error.empty()) << report.error;
+    ASSERT_EQ(report.alive.size(), 1u);
+    EXPECT_EQ(report.alive[0].ip, "127.0.0.1");
+    EXPECT_EQ(report.progress.probed, 2);
+    EXPECT_EQ(report.progress.pass, 1);
+    EXPECT_LE(report.progress.packets_sent, 3u);
+    EXPECT_GE(ElapsedMs(start), 2 * 150.0 - 5.0);
+}
+
+TEST(IcmpScannerTest, Scan_按速率发送) {
+    REQUIRE_ICMP();
+    auto targets = my_tools::MyIPTools::GenerateSubnetIPs("127.0.1.1", 24);  // 254 个
+    my_tools::IcmpScanOptions options;
+    options.rate_pps = 1000;
+    options.timeout_ms = 200;
+    auto report = my_tools::IcmpScanner::Scan(targets, options);
+
+    ASSERT_TRUE(report.error.empty()) << report.error;
+    EXPECT_EQ(report.alive.size(), 254u);
+    // 254 个包按 1000pps 发送至少需要约 253ms
+    EXPECT_GE(report.progress.elapsed_ms, 240.0);
+}
+
+// ============================================================
+//  测试：MyIPTools 接入与进度
+// ============================================================
+
+TEST(IcmpScannerTest, ScanTargetSubnet_更新扫描进度) {
+    if (!my_tools::MyIPTools::HasRawSocketPermission()) {
+        GTEST_SKIP() << "跳过：无 CAP_NET_RAW 权限或非 Root 用户";
+    }
+    my_tools::MyIPTools::InitScanner(64, 500, 20000, 1);
+    auto options = my_tools::MyIPTools::GetScanOptions();
+    EXPECT_EQ(options.rate_pps, 20000);
+    EXPECT_EQ(options.retries, 1);
+
+    auto result = my_tools::MyIPTools::ScanTargetSubnet("127.0.2.1/24");
+    ASSERT_TRUE(result.error.empty()) << result.error;
+    EXPECT_EQ(result.total_scanned, 254);
+    EXPECT_EQ(result.active_count, 254);
+
+    auto progress = my_tools::MyIPTools::GetScanProgress();
+    EXPECT_FALSE(progress.running);
+    EXPECT_EQ(progress.target, "127.0.2.1/24");
+    EXPECT_EQ(progress.detail.total, 254);
+    EXPECT_EQ(progress.detail.replied, 254);
+    EXPECT_TRUE(progress.error.empty());
+
+    my_tools::MyIPTools::InitScanner();
+}
+
+// ============================================================
+//  基准：/20 网段
+// ============================================================
+
+TEST(IcmpScannerTest, Benchmark_20位网段对比线程模型) {
+    if (!my_tools::MyIPTools::HasRawSocketPermission()) {
+        GTEST_SKIP() << "跳过：无 CAP_NET_RAW 权限或非 Root 用户";
+    }
+    const int timeout_ms = 300;
+
+    // 全部应答的 /20：全部应答后立即结束
+    my_tools::MyIPTools::InitScanner(64, timeout_ms, 20000, 1);
+    auto start = std::chrono::steady_clock::now();
+    auto result = my_tools::MyIPTools::ScanTargetSubnet("127.0.16.1/20");
+    const double alive_ms = ElapsedMs(start);
+    ASSERT_TRUE(result.error.empty()) << result.error;
+    EXPECT_EQ(result.total_scanned, 4094);
+    EXPECT_EQ(result.active_count, 4094);
+
+    // 无应答的 /24（198.18.0.0/15 为基准测试保留地址）：耗时由超时决定
+    start = std::chrono::steady_clock::now();
+    auto dead = my_tools::MyIPTools::ScanTargetSubnet("198.18.0.1/24");
+    const double dead_ms = ElapsedMs(start);
+    ASSERT_TRUE(dead.error.empty()) << dead.error;
+    EXPECT_EQ(dead.active_count, 0);
+    // 串行扫描需 254 x 2 轮 x 超时（约 150s）；并发扫描只由超时轮数决定，给 10 倍超时的余量
+    EXPECT_LT(dead_ms, 10.0 * timeout_ms);
+
+    // 旧模型：每个 IP 一个线程 + 独立 raw socket，信号量限制 64 并发，同一 /24
+    auto legacy_targets = my_tools::MyIPTools::GenerateSubnetIPs("198.18.0.1", 24);
+    std::mutex sem_mutex;
+    std::condition_variable sem_cv;
+    int sem_count = 64;
+    std::atomic<int> legacy_alive{0};
+    std::vector<std::thread> threads;
+    threads.reserve(legacy_targets.size());
+    start = std::chrono::steady_clock::now();
+    for (const auto& ip : legacy_targets) {
+        {
+            std::unique_lock<std::mutex> lock(sem_mutex);
+            sem_cv.wait(lock, [&]() { return sem_count > 0; });
+            --sem_count;
+        }
+        threads.emplace_back([&, ip]() {
+            if (my_tools::MyIPTools::PingHost(ip, timeout_ms)) ++legacy_alive;
+            {
+                std::lock_guard<std::mutex> lock(sem_mutex);
+                ++sem_count;
+            }
+            sem_cv.notify_one();
+        });
+    }
+    for (auto& t : threads) t.join();
+    const double legacy_ms = ElapsedMs(start);
+
+    std::printf("[bench] IcmpScanner /20 全应答: %.1f ms; /24 无应答(重发 1 轮): %.1f ms; "
+                "旧线程模型 /24 无应答(64 并发, 不重发): %.1f ms, 线程数 %zu\n",
+                alive_ms, dead_ms, legacy_ms, threads.size());
+    EXPECT_LT(alive_ms, 10.0 * timeout_ms);
+    EXPECT_EQ(legacy_alive.load(), 0);
+
+    my_tools::MyIPTools::InitScanner();
+}
@@ -0,0 +1,274 @@
+/**
+ * @file TestReachabilityProber.cpp
+ * @brief 进程内可达性探测服务 ReachabilityProber 单元测试与基准
+ *
+ * 测试覆盖：
+ *   - ProbeOnce：回环 ICMP、TCP 监听端口、TCP 端口拒绝（tcp_refused_ok）、无应答地址超时、非法 IP
+ *   - Watch：连续成功 / 失败去抖、窗口丢包率与 RTT 统计、状态变化回调、Unwatch
+ *   - PingFuncBySystem::PingIP 改为进程内探测
+ *   - 基准：单次探测延迟，对比 fork + exec 一个子进程的开销（旧实现 system("ping ...") 的下限）
+ *
+ * 依赖 ICMP socket 权限的用例在无权限环境下跳过。
+ */
+
+#include "gtest/gtest.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "PingTools.h"
+#include "ReachabilityProber.h"
+
+using my_tools::ProbeMethod;
+using my_tools::ReachabilityProber;
+
+namespace {
+
+#define REQUIRE_ICMP()                                                        \
+    if (!ReachabilityProber::GetInstance().IcmpAvailable()) {                 \
+        GTEST_SKIP() << "跳过：无法创建 ICMP socket（无 CAP_NET_RAW 权限）"; \
+    }
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// 在回环地址上监听一个随机端口
+class LocalListener {
+public:
+    LocalListener() {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        ::listen(fd_, 64);
+        socklen_t len = sizeof(addr);
+        ::getsockname(fd_, reinterpret_cast<struct sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+    }
+    ~LocalListener() { Close(); }
+
+    void Close() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+    int port() const { return port_; }
+
+private:
+    int fd_ = -1;
+    int port_ = 0;
+};
+
+/// 获取一个当前未被监听的回环端口
+int ClosedPort() {
+    LocalListener l;
+    int port = l.port();
+    l.Close();
+    return port;
+}
+
+template <typename Pred>
+bool WaitFor(Pred pred, int timeout_ms) {
+    auto start = std::chrono::steady_clock::now();
+    while (ElapsedMs(start) < timeout_ms) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return pred();
+}
+
+} // namespace
+
+// ============================================================
+//  测试：单次探测
+// ============================================================
+
+TEST(ReachabilityProberTest, ProbeOnce_回环ICMP) {
+    REQUIRE_ICMP();
+    auto& prober = ReachabilityProber::GetInstance();
+    double rtt = -1.0;
+    EXPECT_TRUE(prober.ProbeOnce("127.0.0.1", 500, ProbeMethod::kIcmp, 0, &rtt));
+    EXPECT_GE(rtt, 0.0);
+    EXPECT_LT(rtt, 500.0);
+    EXPECT_TRUE(prober.ProbeOnce("127.0.0.1", 500));  // kAuto 走 ICMP
+}
+
+TEST(ReachabilityProberTest, ProbeOnce_TCP监听与拒绝) {
+    auto& prober = ReachabilityProber::GetInstance();
+    LocalListener listener;
+    double rtt = -1.0;
+    EXPECT_TRUE(prober.ProbeOnce("127.0.0.1", 500, ProbeMethod::kTcp, listener.port(), &rtt));
+    EXPECT_GE(rtt, 0.0);
+
+    // 端口未监听：对端回 RST，说明主机在线
+    EXPECT_TRUE(prober.ProbeOnce("127.0.0.1", 500, ProbeMethod::kTcp, ClosedPort()));
+}
+
+TEST(ReachabilityProberTest, ProbeOnce_无应答超时与非法IP) {
+    auto& prober = ReachabilityProber::GetInstance();
+    // 198.51.100.0/24 为 TEST-NET-2 文档地址，不会有应答
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(prober.ProbeOnce("198.51.100.7", 150, ProbeMethod::kAuto));
+    EXPECT_LT(ElapsedMs(start), 150.0 + 500.0);
+
+    EXPECT_FALSE(prober.ProbeOnce("not_an_ip", 150));
+    EXPECT_EQ(prober.Watch({}), 0u);
+}
+
+TEST(ReachabilityProberTest, ProbeOnce_并发调用互不干扰) {
+    REQUIRE_ICMP();
+    auto& prober = ReachabilityProber::GetInstance();
+    std::atomic<int> ok{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 16; ++i) {
+        threads.emplace_back([&, i]() {
+            std::string ip = "127.0.3." + std::to_string(i + 1);
+            if (prober.ProbeOnce(ip, 500, ProbeMethod::kIcmp)) ++ok;
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(ok.load(), 16);
+}
+
+// ============================================================
+//  测试：持续探测与去抖
+// ============================================================
+
+TEST(ReachabilityProberTest, Watch_去抖与状态回调) {
+    auto& prober = ReachabilityProber::GetInstance();
+    auto listener = std::make_unique<LocalListener>();
+
+    std::mutex mtx;
+    std::vector<bool> changes;
+    my_tools::ProbeTargetOptions opts;
+    opts.ip = "127.0.0.1";
+    opts.name = "test-service";
+    opts.method = ProbeMethod::kTcp;
+    opts.tcp_port = listener->port();
+    opts.tcp_refused_ok = false;   // 检查服务本身，端口关闭即不可达
+    opts.interval_ms = 20;
+    opts.timeout_ms = 200;
+    opts.up_threshold = 2;
+    opts.down_threshold = 3;
+    opts.window = 10;
+    auto handle = prober.Watch(opts, [&](bool reachable, const my_tools::ReachabilityStats& stats) {
+        std::lock_guard<std::mutex> lock(mtx);
+        changes.push_back(reachable);
+        EXPECT_EQ(stats.reachable, reachable);
+    });
+    ASSERT_NE(handle, 0u);
+
+    ASSERT_TRUE(WaitFor([&]() { return prober.IsReachable(handle); }, 1000));
+    my_tools::ReachabilityStats stats;
+    ASSERT_TRUE(prober.GetStats(handle, stats));
+    EXPECT_GE(stats.consecutive_ok, 2);
+    EXPECT_EQ(stats.method, ProbeMethod::kTcp);
+    EXPECT_GT(stats.last_change_ms, 0);
+
+    // 关闭监听后连续失败 3 次才判定不可达
+    listener.reset();
+    ASSERT_TRUE(WaitFor([&]() { return !prober.IsReachable(handle); }, 1000));
+    ASSERT_TRUE(prober.GetStats(handle, stats));
+    EXPECT_GE(stats.consecutive_fail, 3);
+    EXPECT_GT(stats.loss_pct, 0.0);
+    EXPECT_LE(stats.loss_pct, 100.0);
+    EXPECT_GE(stats.rtt_max_ms, stats.rtt_min_ms);
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        ASSERT_EQ(changes.size(), 2u);
+        EXPECT_TRUE(changes[0]);
+        EXPECT_FALSE(changes[1]);
+    }
+
+    auto json = prober.GetStatsJson();
+    bool found = false;
+    for (const auto& t : json["targets"]) {
+        if (t["handle"].get<uint64_t>() == handle) {
+            found = true;
+            EXPECT_EQ(t["name"], "test-service");
+            EXPECT_EQ(t["method"], "tcp");
+        }
+    }
+    EXPECT_TRUE(found);
+
+    prober.Unwatch(handle);
+    EXPECT_FALSE(prober.GetStats(handle, stats));
+}
+
+TEST(ReachabilityProberTest, Watch_窗口统计) {
+    REQUIRE_ICMP();
+    auto& prober = ReachabilityProber::GetInstance();
+    my_tools::ProbeTargetOptions opts;
+    opts.ip = "127.0.0.1";
+    opts.interval_ms = 10;
+    opts.window = 5;
+    auto handle = prober.Watch(opts);
+    ASSERT_NE(handle, 0u);
+
+    my_tools::ReachabilityStats stats;
+    ASSERT_TRUE(WaitFor([&]() { return prober.GetStats(handle, stats) && stats.probes >= 8; }, 2000));
+    EXPECT_TRUE(stats.reachable);
+    EXPECT_EQ(stats.method, ProbeMethod::kIcmp);
+    EXPECT_EQ(stats.probes, stats.probes_ok);
+    EXPECT_DOUBLE_EQ(stats.loss_pct, 0.0);
+    EXPECT_GT(stats.rtt_avg_ms, 0.0);
+    EXPECT_LE(stats.rtt_min_ms, stats.rtt_avg_ms);
+    EXPECT_GE(stats.rtt_max_ms, stats.rtt_avg_ms);
+    prober.Unwatch(handle);
+}
+
+// ============================================================
+//  测试：PingIP 接入
+// ============================================================
+
+TEST(ReachabilityProberTest, PingIP_进程内探测) {
+    REQUIRE_ICMP();
+    my_tools::ping_tools::PingFuncBySystem ping;
+    EXPECT_TRUE(ping.PingIP("127.0.0.1", 2, 1));
+    EXPECT_FALSE(ping.PingIP("not_an_ip"));
+    EXPECT_FALSE(ping.PingIP("127.0.0.1; echo hacked"));
+}
+
+// ============================================================
+//  基准：单次探测延迟
+// ============================================================
+
+TEST(ReachabilityProberTest, Benchmark_单次探测对比子进程) {
+    REQUIRE_ICMP();
+    auto& prober = ReachabilityProber::GetInstance();
+    const int rounds = 200;
+
+    auto start = std::chrono::steady_clock::now();
+    int ok = 0;
+    for (int i = 0; i < rounds; ++i) {
+        if (prober.ProbeOnce("127.0.0.1", 500, ProbeMethod::kIcmp)) ++ok;
+    }
+    const double probe_us = ElapsedMs(start) * 1000.0 / rounds;
+    EXPECT_EQ(ok, rounds);
+
+    // 旧实现每次 system("ping ...")：至少一次 fork + exec /bin/sh 与 ping 本身
+    const int spawn_rounds = 50;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < spawn_rounds; ++i) {
+        int rc = std::system("true");
+        (void)rc;
+    }
+    const double spawn_us = ElapsedMs(start) * 1000.0 / spawn_rounds;
+
+    std::printf("[bench] ReachabilityProber 回环 ICMP: %.1f us/次; system(\"true\") 子进程开销: %.1f us/次\n",
+                probe_us, spawn_us);
+    EXPECT_LT(probe_us, spawn_us);
+}